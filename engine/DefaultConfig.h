@@ -19,4 +19,6 @@
 #define OUZEL_ENABLE_COREAUDIO 1
 #define OUZEL_ENABLE_ALSA 1
 
+#define OUZEL_LOG_LEVEL 4
+
 #endif // OUZEL_CONFIG_H
@@ -0,0 +1,80 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <stdexcept>
+#include "Atlas.hpp"
+#include "Bundle.hpp"
+#include "ImageLoader.hpp"
+#include "../core/Engine.hpp"
+#include "../scene/SpriteRenderer.hpp"
+
+namespace ouzel::assets
+{
+    Atlas::Atlas(Bundle& initBundle,
+                 const Size2U& pageSize,
+                 std::uint32_t padding,
+                 std::uint32_t extrusion,
+                 bool initMipmaps):
+        bundle(initBundle),
+        packer(pageSize, padding, extrusion),
+        mipmaps(initMipmaps)
+    {
+    }
+
+    void Atlas::add(const std::string& name, const graphics::Image& image, const Vector2F& pivot)
+    {
+        if (image.getPixelFormat() != graphics::PixelFormat::rgba8UnsignedNorm)
+            throw std::runtime_error("Unsupported pixel format");
+
+        const auto region = packer.pack(image.getSize());
+        const auto& pageSize = packer.getPageSize();
+
+        if (region.page == pages.size())
+        {
+            Page page;
+            page.data.resize(static_cast<std::size_t>(pageSize.v[0]) * pageSize.v[1] * 4);
+            page.texture = std::make_shared<graphics::Texture>(*engine->getGraphics(),
+                                                               page.data,
+                                                               pageSize,
+                                                               graphics::Flags::dynamic,
+                                                               mipmaps ? 0 : 1);
+            pages.push_back(std::move(page));
+        }
+
+        auto& page = pages[region.page];
+        graphics::copyToAtlasPage(page.data.data(), pageSize,
+                                  image.getData().data(), image.getSize(),
+                                  region.rectangle, packer.getExtrusion());
+        page.dirty = true;
+
+        const RectF frameRectangle(static_cast<float>(region.rectangle.position.v[0]),
+                                   static_cast<float>(region.rectangle.position.v[1]),
+                                   static_cast<float>(region.rectangle.size.v[0]),
+                                   static_cast<float>(region.rectangle.size.v[1]));
+
+        scene::SpriteData::Animation animation;
+        animation.frames.emplace_back(name,
+                                      Size2F(static_cast<float>(pageSize.v[0]), static_cast<float>(pageSize.v[1])),
+                                      frameRectangle, false, frameRectangle.size, Vector2F(), pivot);
+
+        scene::SpriteData spriteData;
+        spriteData.texture = page.texture;
+        spriteData.animations[""] = std::move(animation);
+
+        bundle.setSpriteData(name, spriteData);
+    }
+
+    void Atlas::load(const std::string& filename, const Vector2F& pivot)
+    {
+        add(filename, decodeImage(engine->getFileSystem().readFile(filename)), pivot);
+    }
+
+    void Atlas::upload()
+    {
+        for (auto& page : pages)
+            if (page.dirty)
+            {
+                page.texture->setData(page.data);
+                page.dirty = false;
+            }
+    }
+}
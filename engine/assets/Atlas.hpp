@@ -0,0 +1,64 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_ASSETS_ATLAS_HPP
+#define OUZEL_ASSETS_ATLAS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../graphics/AtlasPacker.hpp"
+#include "../graphics/Image.hpp"
+#include "../graphics/Texture.hpp"
+#include "../math/Size.hpp"
+#include "../math/Vector.hpp"
+
+namespace ouzel::assets
+{
+    class Bundle;
+
+    // Packs images that are loaded at runtime into dynamic textures
+    // Every image is registered in the bundle as a sprite named after the image, like the atlases of the ouzel tool
+    class Atlas final
+    {
+    public:
+        explicit Atlas(Bundle& initBundle,
+                       const Size2U& pageSize = Size2U{2048, 2048},
+                       std::uint32_t padding = 2,
+                       std::uint32_t extrusion = 2,
+                       bool initMipmaps = false);
+
+        Atlas(const Atlas&) = delete;
+        Atlas& operator=(const Atlas&) = delete;
+
+        Atlas(Atlas&&) = delete;
+        Atlas& operator=(Atlas&&) = delete;
+
+        // The image must be in the RGBA8 format, the page is uploaded on the next call to upload
+        void add(const std::string& name, const graphics::Image& image,
+                 const Vector2F& pivot = Vector2F{0.5F, 0.5F});
+        void load(const std::string& filename, const Vector2F& pivot = Vector2F{0.5F, 0.5F});
+
+        // Uploads the pages that changed since the last upload
+        void upload();
+
+        auto getPageCount() const noexcept { return pages.size(); }
+        auto& getPageTexture(std::size_t page) const { return pages[page].texture; }
+
+    private:
+        struct Page final
+        {
+            std::shared_ptr<graphics::Texture> texture;
+            std::vector<std::uint8_t> data;
+            bool dirty = false;
+        };
+
+        Bundle& bundle;
+        graphics::AtlasPacker packer;
+        bool mipmaps;
+        std::vector<Page> pages;
+    };
+}
+
+#endif // OUZEL_ASSETS_ATLAS_HPP
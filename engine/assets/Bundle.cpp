@@ -1,10 +1,12 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include <cctype>
 #include <stdexcept>
 #include "Bundle.hpp"
 #include "Cache.hpp"
 #include "Loader.hpp"
+#include "../formats/Cooked.hpp"
 #include "../formats/Json.hpp"
 
 namespace ouzel::assets
@@ -20,22 +22,90 @@ namespace ouzel::assets
         cache.removeBundle(this);
     }
 
+    namespace
+    {
+        std::size_t getTextureSize(const graphics::Texture* texture) noexcept
+        {
+            if (!texture) return 0;
+
+            const auto pixelSize = graphics::getPixelSize(texture->getPixelFormat());
+            auto width = texture->getSize().v[0];
+            auto height = texture->getSize().v[1];
+            std::size_t result = 0;
+
+            // zero mipmaps stands for the full chain
+            for (std::uint32_t level = 0; texture->getMipmaps() == 0 || level < texture->getMipmaps(); ++level)
+            {
+                result += static_cast<std::size_t>(width) * height * pixelSize * texture->getSampleCount();
+                if (width == 1 && height == 1) break;
+                width = std::max(width / 2U, 1U);
+                height = std::max(height / 2U, 1U);
+            }
+
+            return result;
+        }
+
+        std::size_t getBufferSize(const graphics::Buffer* buffer) noexcept
+        {
+            return buffer ? buffer->getSize() : 0;
+        }
+    }
+
     void Bundle::loadAsset(Loader::Type loaderType, const std::string& name,
                            const std::string& filename, bool mipmaps)
     {
-        const auto data = fileSystem.readFile(filename);
+        load(loaderType, name, filename, mipmaps);
+
+        // evict only after the whole file was loaded, so that the assets that it depends on stay
+        if (!loadingSource) cache.trim();
+    }
+
+    void Bundle::load(Loader::Type loaderType, const std::string& name,
+                      const std::string& filename, bool mipmaps)
+    {
+        // the assets that the loaders create (also in the nested loads) remember the file that they came from
+        auto previousSource = loadingSource;
+
+        try
+        {
+            const auto& loaders = cache.getLoaders();
+            bool loaded = false;
+
+            if (storage::Path(filename).getExtension() == cooked::fileExtension)
+            {
+                const auto file = fileSystem.mapFile(filename);
+                loadingSource = std::make_shared<const Source>(Source{loaderType, name, filename, mipmaps, file.getSize()});
 
-        const auto& loaders = cache.getLoaders();
+                for (auto i = loaders.rbegin(); i != loaders.rend() && !loaded; ++i)
+                {
+                    Loader* loader = i->get();
+                    loaded = loader->getType() == loaderType &&
+                        loader->loadMappedAsset(*this, name, file.getData(), file.getSize(), mipmaps);
+                }
+            }
+            else
+            {
+                const auto data = fileSystem.readFile(filename);
+                loadingSource = std::make_shared<const Source>(Source{loaderType, name, filename, mipmaps, data.size()});
 
-        for (auto i = loaders.rbegin(); i != loaders.rend(); ++i)
+                for (auto i = loaders.rbegin(); i != loaders.rend() && !loaded; ++i)
+                {
+                    Loader* loader = i->get();
+                    loaded = loader->getType() == loaderType &&
+                        loader->loadAsset(*this, name, data, mipmaps);
+                }
+            }
+
+            if (!loaded)
+                throw std::runtime_error("Failed to load asset " + filename);
+        }
+        catch (...)
         {
-            Loader* loader = i->get();
-            if (loader->getType() == loaderType &&
-                loader->loadAsset(*this, name, data, mipmaps))
-                return;
+            loadingSource = std::move(previousSource);
+            throw;
         }
 
-        throw std::runtime_error("Failed to load asset " + filename);
+        loadingSource = std::move(previousSource);
     }
 
     void Bundle::loadAssets(const std::string& filename)
@@ -57,9 +127,9 @@ namespace ouzel::assets
             loadAsset(asset.type, asset.name, asset.filename, asset.mipmaps);
     }
 
-    std::shared_ptr<graphics::Texture> Bundle::getTexture(const std::string& name) const
+    std::shared_ptr<graphics::Texture> Bundle::getTexture(TextureHandle handle) const
     {
-        const auto i = textures.find(name);
+        const auto i = textures.find(handle.getId());
 
         if (i != textures.end())
             return i->second;
@@ -67,19 +137,21 @@ namespace ouzel::assets
         return nullptr;
     }
 
-    void Bundle::setTexture(const std::string& name, const std::shared_ptr<graphics::Texture>& texture)
+    void Bundle::setTexture(TextureHandle handle, const std::shared_ptr<graphics::Texture>& texture)
     {
-        textures[name] = texture;
+        textures[handle.getId()] = texture;
+        track(AssetType::texture, handle.getId(), getTextureSize(texture.get()));
     }
 
     void Bundle::releaseTextures()
     {
         textures.clear();
+        untrack(AssetType::texture);
     }
 
-    const graphics::Shader* Bundle::getShader(const std::string& name) const
+    const graphics::Shader* Bundle::getShader(ShaderHandle handle) const
     {
-        const auto i = shaders.find(name);
+        const auto i = shaders.find(handle.getId());
 
         if (i != shaders.end())
             return i->second.get();
@@ -87,19 +159,21 @@ namespace ouzel::assets
         return nullptr;
     }
 
-    void Bundle::setShader(const std::string& name, std::unique_ptr<graphics::Shader> shader)
+    void Bundle::setShader(ShaderHandle handle, std::unique_ptr<graphics::Shader> shader)
     {
-        shaders[name] = std::move(shader);
+        shaders[handle.getId()] = std::move(shader);
+        track(AssetType::shader, handle.getId(), sizeof(graphics::Shader));
     }
 
     void Bundle::releaseShaders()
     {
         shaders.clear();
+        untrack(AssetType::shader);
     }
 
-    const graphics::BlendState* Bundle::getBlendState(const std::string& name) const
+    const graphics::BlendState* Bundle::getBlendState(BlendStateHandle handle) const
     {
-        const auto i = blendStates.find(name);
+        const auto i = blendStates.find(handle.getId());
 
         if (i != blendStates.end())
             return i->second.get();
@@ -107,19 +181,21 @@ namespace ouzel::assets
         return nullptr;
     }
 
-    void Bundle::setBlendState(const std::string& name, std::unique_ptr<graphics::BlendState> blendState)
+    void Bundle::setBlendState(BlendStateHandle handle, std::unique_ptr<graphics::BlendState> blendState)
     {
-        blendStates[name] = std::move(blendState);
+        blendStates[handle.getId()] = std::move(blendState);
+        track(AssetType::blendState, handle.getId(), sizeof(graphics::BlendState));
     }
 
     void Bundle::releaseBlendStates()
     {
         blendStates.clear();
+        untrack(AssetType::blendState);
     }
 
-    const graphics::DepthStencilState* Bundle::getDepthStencilState(const std::string& name) const
+    const graphics::DepthStencilState* Bundle::getDepthStencilState(DepthStencilStateHandle handle) const
     {
-        const auto i = depthStencilStates.find(name);
+        const auto i = depthStencilStates.find(handle.getId());
 
         if (i != depthStencilStates.end())
             return i->second.get();
@@ -127,14 +203,16 @@ namespace ouzel::assets
         return nullptr;
     }
 
-    void Bundle::setDepthStencilState(const std::string& name, std::unique_ptr<graphics::DepthStencilState> depthStencilState)
+    void Bundle::setDepthStencilState(DepthStencilStateHandle handle, std::unique_ptr<graphics::DepthStencilState> depthStencilState)
     {
-        depthStencilStates[name] = std::move(depthStencilState);
+        depthStencilStates[handle.getId()] = std::move(depthStencilState);
+        track(AssetType::depthStencilState, handle.getId(), sizeof(graphics::DepthStencilState));
     }
 
     void Bundle::releaseDepthStencilStates()
     {
         depthStencilStates.clear();
+        untrack(AssetType::depthStencilState);
     }
 
     void Bundle::preloadSpriteData(const std::string& filename, bool mipmaps,
@@ -148,69 +226,43 @@ namespace ouzel::assets
 
         if (std::find(imageExtensions.begin(), imageExtensions.end(), extension) != imageExtensions.end())
         {
-            scene::SpriteData newSpriteData;
-
-            if (spritesX == 0) spritesX = 1;
-            if (spritesY == 0) spritesY = 1;
-
-            newSpriteData.texture = getTexture(filename);
-
-            const Size2F textureSize(static_cast<float>(newSpriteData.texture->getSize().v[0]),
-                                     static_cast<float>(newSpriteData.texture->getSize().v[1]));
-
-            if (newSpriteData.texture)
-            {
-                const auto spriteSize = Size2F(textureSize.v[0] / spritesX,
-                                               textureSize.v[1] / spritesY);
-
-                scene::SpriteData::Animation animation;
-                animation.frames.reserve(spritesX * spritesY);
-
-                for (std::uint32_t x = 0; x < spritesX; ++x)
-                {
-                    for (std::uint32_t y = 0; y < spritesY; ++y)
-                    {
-                        RectF rectangle(spriteSize.v[0] * x,
-                                        spriteSize.v[1] * y,
-                                        spriteSize.v[0],
-                                        spriteSize.v[1]);
-
-                        animation.frames.emplace_back(filename, textureSize, rectangle, false, spriteSize, Vector2F(), pivot);
-                    }
-                }
-
-                newSpriteData.animations[""] = std::move(animation);
-
-                spriteData[filename] = newSpriteData;
-            }
+            if (const auto texture = getTexture(filename))
+                setSpriteData(filename, scene::SpriteData(texture, spritesX, spritesY, pivot, filename));
         }
         else
             loadAsset(Loader::Type::sprite, filename, filename, mipmaps);
     }
 
-    const scene::SpriteData* Bundle::getSpriteData(const std::string& name) const
+    std::shared_ptr<const scene::SpriteData> Bundle::getSpriteData(SpriteDataHandle handle) const
     {
-        const auto i = spriteData.find(name);
+        const auto i = spriteData.find(handle.getId());
 
         if (i != spriteData.end())
-            return &i->second;
+            return i->second;
 
         return nullptr;
     }
 
-    void Bundle::setSpriteData(const std::string& name, const scene::SpriteData& newSpriteData)
+    void Bundle::setSpriteData(SpriteDataHandle handle, const scene::SpriteData& newSpriteData)
     {
-        spriteData[name] = newSpriteData;
+        auto data = std::make_shared<scene::SpriteData>(newSpriteData);
+        data->createBuffers();
+        if (!data->material) data->material = data->createMaterial();
+
+        const auto size = getBufferSize(data->indexBuffer.get()) + getBufferSize(data->vertexBuffer.get());
+        spriteData[handle.getId()] = std::move(data);
+        track(AssetType::spriteData, handle.getId(), size);
     }
 
     void Bundle::releaseSpriteData()
     {
         spriteData.clear();
+        untrack(AssetType::spriteData);
     }
 
-    const scene::ParticleSystemData* Bundle::getParticleSystemData(const std::string& name) const
+    const scene::ParticleSystemData* Bundle::getParticleSystemData(ParticleSystemDataHandle handle) const
     {
-        const auto i = particleSystemData.find(name);
+        const auto i = particleSystemData.find(handle.getId());
 
         if (i != particleSystemData.end())
             return &i->second;
@@ -218,19 +270,21 @@ namespace ouzel::assets
         return nullptr;
     }
 
-    void Bundle::setParticleSystemData(const std::string& name, const scene::ParticleSystemData& newParticleSystemData)
+    void Bundle::setParticleSystemData(ParticleSystemDataHandle handle, const scene::ParticleSystemData& newParticleSystemData)
     {
-        particleSystemData[name] = newParticleSystemData;
+        particleSystemData[handle.getId()] = newParticleSystemData;
+        track(AssetType::particleSystemData, handle.getId(), sizeof(scene::ParticleSystemData));
     }
 
     void Bundle::releaseParticleSystemData()
     {
         particleSystemData.clear();
+        untrack(AssetType::particleSystemData);
     }
 
-    const gui::Font* Bundle::getFont(const std::string& name) const
+    const gui::Font* Bundle::getFont(FontHandle handle) const
     {
-        const auto i = fonts.find(name);
+        const auto i = fonts.find(handle.getId());
 
         if (i != fonts.end())
             return i->second.get();
@@ -238,19 +292,21 @@ namespace ouzel::assets
         return nullptr;
     }
 
-    void Bundle::setFont(const std::string& name, std::unique_ptr<gui::Font> font)
+    void Bundle::setFont(FontHandle handle, std::unique_ptr<gui::Font> font)
     {
-        fonts[name] = std::move(font);
+        fonts[handle.getId()] = std::move(font);
+        track(AssetType::font, handle.getId(), loadingSource ? loadingSource->size : sizeof(gui::Font));
     }
 
     void Bundle::releaseFonts()
     {
         fonts.clear();
+        untrack(AssetType::font);
     }
 
-    const audio::Cue* Bundle::getCue(const std::string& name) const
+    const audio::Cue* Bundle::getCue(CueHandle handle) const
     {
-        const auto i = cues.find(name);
+        const auto i = cues.find(handle.getId());
 
         if (i != cues.end())
             return i->second.get();
@@ -258,19 +314,21 @@ namespace ouzel::assets
         return nullptr;
     }
 
-    void Bundle::setCue(const std::string& name, std::unique_ptr<audio::Cue> cue)
+    void Bundle::setCue(CueHandle handle, std::unique_ptr<audio::Cue> cue)
     {
-        cues[name] = std::move(cue);
+        cues[handle.getId()] = std::move(cue);
+        track(AssetType::cue, handle.getId(), loadingSource ? loadingSource->size : sizeof(audio::Cue));
     }
 
     void Bundle::releaseCues()
     {
         cues.clear();
+        untrack(AssetType::cue);
     }
 
-    const audio::Sound* Bundle::getSound(const std::string& name) const
+    const audio::Sound* Bundle::getSound(SoundHandle handle) const
     {
-        const auto i = sounds.find(name);
+        const auto i = sounds.find(handle.getId());
 
         if (i != sounds.end())
             return i->second.get();
@@ -278,19 +336,21 @@ namespace ouzel::assets
         return nullptr;
     }
 
-    void Bundle::setSound(const std::string& name, std::unique_ptr<audio::Sound> sound)
+    void Bundle::setSound(SoundHandle handle, std::unique_ptr<audio::Sound> sound)
     {
-        sounds[name] = std::move(sound);
+        sounds[handle.getId()] = std::move(sound);
+        track(AssetType::sound, handle.getId(), loadingSource ? loadingSource->size : sizeof(audio::Sound));
     }
 
     void Bundle::releaseSounds()
     {
         sounds.clear();
+        untrack(AssetType::sound);
     }
 
-    const graphics::Material* Bundle::getMaterial(const std::string& name) const
+    const graphics::Material* Bundle::getMaterial(MaterialHandle handle) const
     {
-        const auto i = materials.find(name);
+        const auto i = materials.find(handle.getId());
 
         if (i != materials.end())
             return i->second.get();
@@ -298,19 +358,21 @@ namespace ouzel::assets
         return nullptr;
     }
 
-    void Bundle::setMaterial(const std::string& name, std::unique_ptr<graphics::Material> material)
+    void Bundle::setMaterial(MaterialHandle handle, std::unique_ptr<graphics::Material> material)
     {
-        materials[name] = std::move(material);
+        materials[handle.getId()] = std::move(material);
+        track(AssetType::material, handle.getId(), sizeof(graphics::Material));
     }
 
     void Bundle::releaseMaterials()
     {
         materials.clear();
+        untrack(AssetType::material);
     }
 
-    const scene::SkinnedMeshData* Bundle::getSkinnedMeshData(const std::string& name) const
+    const scene::SkinnedMeshData* Bundle::getSkinnedMeshData(SkinnedMeshDataHandle handle) const
     {
-        const auto i = skinnedMeshData.find(name);
+        const auto i = skinnedMeshData.find(handle.getId());
 
         if (i != skinnedMeshData.end())
             return &i->second;
@@ -318,19 +380,21 @@ namespace ouzel::assets
         return nullptr;
     }
 
-    void Bundle::setSkinnedMeshData(const std::string& name, scene::SkinnedMeshData&& newSkinnedMeshData)
+    void Bundle::setSkinnedMeshData(SkinnedMeshDataHandle handle, scene::SkinnedMeshData&& newSkinnedMeshData)
     {
-        skinnedMeshData[name] = std::move(newSkinnedMeshData);
+        const auto& data = skinnedMeshData[handle.getId()] = std::move(newSkinnedMeshData);
+        track(AssetType::skinnedMeshData, handle.getId(), data.indexBuffer.getSize() + data.vertexBuffer.getSize());
     }
 
     void Bundle::releaseSkinnedMeshData()
     {
         skinnedMeshData.clear();
+        untrack(AssetType::skinnedMeshData);
     }
 
-    const scene::StaticMeshData* Bundle::getStaticMeshData(const std::string& name) const
+    const scene::StaticMeshData* Bundle::getStaticMeshData(StaticMeshDataHandle handle) const
     {
-        const auto i = staticMeshData.find(name);
+        const auto i = staticMeshData.find(handle.getId());
 
         if (i != staticMeshData.end())
             return &i->second;
@@ -338,13 +402,116 @@ namespace ouzel::assets
         return nullptr;
     }
 
-    void Bundle::setStaticMeshData(const std::string& name, scene::StaticMeshData&& newStaticMeshData)
+    void Bundle::setStaticMeshData(StaticMeshDataHandle handle, scene::StaticMeshData&& newStaticMeshData)
     {
-        staticMeshData[name] = std::move(newStaticMeshData);
+        const auto& data = staticMeshData[handle.getId()] = std::move(newStaticMeshData);
+        track(AssetType::staticMeshData, handle.getId(), data.indexBuffer.getSize() + data.vertexBuffer.getSize());
     }
 
     void Bundle::releaseStaticMeshData()
     {
         staticMeshData.clear();
+        untrack(AssetType::staticMeshData);
+    }
+
+    void Bundle::track(AssetType type, AssetId id, std::size_t size)
+    {
+        auto& residency = residencies[static_cast<std::size_t>(type)];
+        auto& record = records[Key{type, id}];
+
+        if (record.lastUse != 0)
+        {
+            residency.size -= record.size;
+            --residency.count;
+        }
+
+        record = Record{size, cache.nextUse(), loadingSource};
+        residency.size += size;
+        ++residency.count;
+
+        evicted.erase(Key{type, id});
+        cache.invalidate();
+    }
+
+    void Bundle::untrack(AssetType type)
+    {
+        for (auto i = records.begin(); i != records.end();)
+            if (i->first.type == type)
+                i = records.erase(i);
+            else
+                ++i;
+
+        for (auto i = evicted.begin(); i != evicted.end();)
+            if (i->first.type == type)
+                i = evicted.erase(i);
+            else
+                ++i;
+
+        residencies[static_cast<std::size_t>(type)] = Residency{};
+        cache.invalidate();
+    }
+
+    std::uint64_t* Bundle::getLastUse(AssetType type, AssetId id) noexcept
+    {
+        const auto i = records.find(Key{type, id});
+        return i != records.end() ? &i->second.lastUse : nullptr;
+    }
+
+    bool Bundle::isEvictable(AssetType type, AssetId id) const
+    {
+        const auto record = records.find(Key{type, id});
+        if (record == records.end() || !record->second.source) return false;
+
+        switch (type)
+        {
+            case AssetType::texture:
+            {
+                const auto i = textures.find(id);
+                return i != textures.end() && i->second.use_count() == 1;
+            }
+            case AssetType::spriteData:
+            {
+                const auto i = spriteData.find(id);
+                return i != spriteData.end() && i->second.use_count() == 1;
+            }
+            default: // the other assets are referenced by raw pointers
+                return false;
+        }
+    }
+
+    void Bundle::evict(AssetType type, AssetId id)
+    {
+        const auto record = records.find(Key{type, id});
+        if (record == records.end()) return;
+
+        switch (type)
+        {
+            case AssetType::texture: textures.erase(id); break;
+            case AssetType::spriteData: spriteData.erase(id); break;
+            default: return;
+        }
+
+        auto& residency = residencies[static_cast<std::size_t>(type)];
+        residency.size -= record->second.size;
+        --residency.count;
+
+        evicted[record->first] = std::move(record->second.source);
+        records.erase(record);
+        cache.invalidate();
+    }
+
+    bool Bundle::reload(AssetType type, AssetId id)
+    {
+        const auto i = evicted.find(Key{type, id});
+        if (i == evicted.end()) return false;
+
+        // the source is kept until the file is loaded, so that a failed load can be retried on the next lookup
+        const auto source = i->second;
+
+        // not trimmed, because the asset would be the first to be evicted again before it is returned,
+        // the budget is enforced on the next load
+        load(source->loaderType, source->name, source->filename, source->mipmaps);
+        evicted.erase(Key{type, id});
+        return true;
     }
 }
@@ -3,9 +3,13 @@
 #ifndef OUZEL_ASSETS_BUNDLE_HPP
 #define OUZEL_ASSETS_BUNDLE_HPP
 
-#include <map>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include "Handle.hpp"
 #include "Loader.hpp"
 #include "../audio/Cue.hpp"
 #include "../audio/Sound.hpp"
@@ -45,6 +49,13 @@ namespace ouzel::assets
         bool mipmaps;
     };
 
+    // Number of assets of a type and the memory that they take (CPU and GPU)
+    struct Residency final
+    {
+        std::size_t count = 0;
+        std::size_t size = 0;
+    };
+
     class Bundle final
     {
         friend Cache;
@@ -63,73 +74,151 @@ namespace ouzel::assets
         void loadAssets(const std::string& filename);
         void loadAssets(const std::vector<Asset>& assets);
 
-        std::shared_ptr<graphics::Texture> getTexture(const std::string& name) const;
-        void setTexture(const std::string& name, const std::shared_ptr<graphics::Texture>& texture);
+        std::shared_ptr<graphics::Texture> getTexture(TextureHandle handle) const;
+        std::shared_ptr<graphics::Texture> getTexture(const std::string& name) const { return getTexture(TextureHandle{name}); }
+        void setTexture(TextureHandle handle, const std::shared_ptr<graphics::Texture>& texture);
+        void setTexture(const std::string& name, const std::shared_ptr<graphics::Texture>& texture) { setTexture(TextureHandle{name}, texture); }
         void releaseTextures();
 
-        const graphics::Shader* getShader(const std::string& shaderName) const;
-        void setShader(const std::string& name, std::unique_ptr<graphics::Shader> shader);
+        const graphics::Shader* getShader(ShaderHandle handle) const;
+        const graphics::Shader* getShader(const std::string& name) const { return getShader(ShaderHandle{name}); }
+        void setShader(ShaderHandle handle, std::unique_ptr<graphics::Shader> shader);
+        void setShader(const std::string& name, std::unique_ptr<graphics::Shader> shader) { setShader(ShaderHandle{name}, std::move(shader)); }
         void releaseShaders();
 
-        const graphics::BlendState* getBlendState(const std::string& name) const;
-        void setBlendState(const std::string& name, std::unique_ptr<graphics::BlendState> blendState);
+        const graphics::BlendState* getBlendState(BlendStateHandle handle) const;
+        const graphics::BlendState* getBlendState(const std::string& name) const { return getBlendState(BlendStateHandle{name}); }
+        void setBlendState(BlendStateHandle handle, std::unique_ptr<graphics::BlendState> blendState);
+        void setBlendState(const std::string& name, std::unique_ptr<graphics::BlendState> blendState) { setBlendState(BlendStateHandle{name}, std::move(blendState)); }
         void releaseBlendStates();
 
-        const graphics::DepthStencilState* getDepthStencilState(const std::string& name) const;
-        void setDepthStencilState(const std::string& name, std::unique_ptr<graphics::DepthStencilState> depthStencilState);
+        const graphics::DepthStencilState* getDepthStencilState(DepthStencilStateHandle handle) const;
+        const graphics::DepthStencilState* getDepthStencilState(const std::string& name) const { return getDepthStencilState(DepthStencilStateHandle{name}); }
+        void setDepthStencilState(DepthStencilStateHandle handle, std::unique_ptr<graphics::DepthStencilState> depthStencilState);
+        void setDepthStencilState(const std::string& name, std::unique_ptr<graphics::DepthStencilState> depthStencilState) { setDepthStencilState(DepthStencilStateHandle{name}, std::move(depthStencilState)); }
         void releaseDepthStencilStates();
 
         void preloadSpriteData(const std::string& filename, bool mipmaps = true,
                                std::uint32_t spritesX = 1, std::uint32_t spritesY = 1,
                                const Vector2F& pivot = Vector2F{0.5F, 0.5F});
-        const scene::SpriteData* getSpriteData(const std::string& name) const;
-        void setSpriteData(const std::string& name, const scene::SpriteData& newSpriteData);
+        std::shared_ptr<const scene::SpriteData> getSpriteData(SpriteDataHandle handle) const;
+        std::shared_ptr<const scene::SpriteData> getSpriteData(const std::string& name) const { return getSpriteData(SpriteDataHandle{name}); }
+        void setSpriteData(SpriteDataHandle handle, const scene::SpriteData& newSpriteData);
+        void setSpriteData(const std::string& name, const scene::SpriteData& newSpriteData) { setSpriteData(SpriteDataHandle{name}, newSpriteData); }
         void releaseSpriteData();
 
-        const scene::ParticleSystemData* getParticleSystemData(const std::string& name) const;
-        void setParticleSystemData(const std::string& name, const scene::ParticleSystemData& newParticleSystemData);
+        const scene::ParticleSystemData* getParticleSystemData(ParticleSystemDataHandle handle) const;
+        const scene::ParticleSystemData* getParticleSystemData(const std::string& name) const { return getParticleSystemData(ParticleSystemDataHandle{name}); }
+        void setParticleSystemData(ParticleSystemDataHandle handle, const scene::ParticleSystemData& newParticleSystemData);
+        void setParticleSystemData(const std::string& name, const scene::ParticleSystemData& newParticleSystemData) { setParticleSystemData(ParticleSystemDataHandle{name}, newParticleSystemData); }
         void releaseParticleSystemData();
 
-        const gui::Font* getFont(const std::string& name) const;
-        void setFont(const std::string& name, std::unique_ptr<gui::Font> font);
+        const gui::Font* getFont(FontHandle handle) const;
+        const gui::Font* getFont(const std::string& name) const { return getFont(FontHandle{name}); }
+        void setFont(FontHandle handle, std::unique_ptr<gui::Font> font);
+        void setFont(const std::string& name, std::unique_ptr<gui::Font> font) { setFont(FontHandle{name}, std::move(font)); }
         void releaseFonts();
 
-        const audio::Cue* getCue(const std::string& name) const;
-        void setCue(const std::string& name, std::unique_ptr<audio::Cue> cue);
+        const audio::Cue* getCue(CueHandle handle) const;
+        const audio::Cue* getCue(const std::string& name) const { return getCue(CueHandle{name}); }
+        void setCue(CueHandle handle, std::unique_ptr<audio::Cue> cue);
+        void setCue(const std::string& name, std::unique_ptr<audio::Cue> cue) { setCue(CueHandle{name}, std::move(cue)); }
         void releaseCues();
 
-        const audio::Sound* getSound(const std::string& name) const;
-        void setSound(const std::string& name, std::unique_ptr<audio::Sound> sound);
+        const audio::Sound* getSound(SoundHandle handle) const;
+        const audio::Sound* getSound(const std::string& name) const { return getSound(SoundHandle{name}); }
+        void setSound(SoundHandle handle, std::unique_ptr<audio::Sound> sound);
+        void setSound(const std::string& name, std::unique_ptr<audio::Sound> sound) { setSound(SoundHandle{name}, std::move(sound)); }
         void releaseSounds();
 
-        const graphics::Material* getMaterial(const std::string& name) const;
-        void setMaterial(const std::string& name, std::unique_ptr<graphics::Material> material);
+        const graphics::Material* getMaterial(MaterialHandle handle) const;
+        const graphics::Material* getMaterial(const std::string& name) const { return getMaterial(MaterialHandle{name}); }
+        void setMaterial(MaterialHandle handle, std::unique_ptr<graphics::Material> material);
+        void setMaterial(const std::string& name, std::unique_ptr<graphics::Material> material) { setMaterial(MaterialHandle{name}, std::move(material)); }
         void releaseMaterials();
 
-        const scene::SkinnedMeshData* getSkinnedMeshData(const std::string& name) const;
-        void setSkinnedMeshData(const std::string& name, scene::SkinnedMeshData&& newSkinnedMeshData);
+        const scene::SkinnedMeshData* getSkinnedMeshData(SkinnedMeshDataHandle handle) const;
+        const scene::SkinnedMeshData* getSkinnedMeshData(const std::string& name) const { return getSkinnedMeshData(SkinnedMeshDataHandle{name}); }
+        void setSkinnedMeshData(SkinnedMeshDataHandle handle, scene::SkinnedMeshData&& newSkinnedMeshData);
+        void setSkinnedMeshData(const std::string& name, scene::SkinnedMeshData&& newSkinnedMeshData) { setSkinnedMeshData(SkinnedMeshDataHandle{name}, std::move(newSkinnedMeshData)); }
         void releaseSkinnedMeshData();
 
-        const scene::StaticMeshData* getStaticMeshData(const std::string& name) const;
-        void setStaticMeshData(const std::string& name, scene::StaticMeshData&& newStaticMeshData);
+        const scene::StaticMeshData* getStaticMeshData(StaticMeshDataHandle handle) const;
+        const scene::StaticMeshData* getStaticMeshData(const std::string& name) const { return getStaticMeshData(StaticMeshDataHandle{name}); }
+        void setStaticMeshData(StaticMeshDataHandle handle, scene::StaticMeshData&& newStaticMeshData);
+        void setStaticMeshData(const std::string& name, scene::StaticMeshData&& newStaticMeshData) { setStaticMeshData(StaticMeshDataHandle{name}, std::move(newStaticMeshData)); }
         void releaseStaticMeshData();
 
+        auto& getResidency(AssetType type) const noexcept { return residencies[static_cast<std::size_t>(type)]; }
+        auto getEvictedCount() const noexcept { return evicted.size(); }
+
     private:
+        // File that the asset was loaded from, evicted assets are loaded from it again when they are accessed
+        struct Source final
+        {
+            Loader::Type loaderType;
+            std::string name;
+            std::string filename;
+            bool mipmaps;
+            std::size_t size;
+        };
+
+        struct Record final
+        {
+            std::size_t size = 0;
+            std::uint64_t lastUse = 0; // updated by the cache on every access
+            std::shared_ptr<const Source> source; // null for the assets that were not loaded from a file
+        };
+
+        struct Key final
+        {
+            AssetType type;
+            AssetId id;
+
+            bool operator==(const Key& other) const noexcept { return type == other.type && id == other.id; }
+        };
+
+        struct KeyHash final
+        {
+            std::size_t operator()(const Key& key) const noexcept
+            {
+                return static_cast<std::size_t>(key.id ^ (static_cast<AssetId>(key.type) * 0x9E3779B97F4A7C15ULL));
+            }
+        };
+
+        // Loads the file without trimming the cache
+        void load(Loader::Type loaderType, const std::string& name,
+                  const std::string& filename, bool mipmaps);
+
+        void track(AssetType type, AssetId id, std::size_t size);
+        void untrack(AssetType type);
+        std::uint64_t* getLastUse(AssetType type, AssetId id) noexcept;
+
+        // Only the assets that can be loaded again and are not referenced outside of the bundle can be evicted
+        bool isEvictable(AssetType type, AssetId id) const;
+        void evict(AssetType type, AssetId id);
+        bool reload(AssetType type, AssetId id);
+
         Cache& cache;
         storage::FileSystem& fileSystem;
 
-        std::map<std::string, std::shared_ptr<graphics::Texture>> textures;
-        std::map<std::string, std::unique_ptr<graphics::Shader>> shaders;
-        std::map<std::string, scene::ParticleSystemData> particleSystemData;
-        std::map<std::string, std::unique_ptr<graphics::BlendState>> blendStates;
-        std::map<std::string, std::unique_ptr<graphics::DepthStencilState>> depthStencilStates;
-        std::map<std::string, scene::SpriteData> spriteData;
-        std::map<std::string, std::unique_ptr<gui::Font>> fonts;
-        std::map<std::string, std::unique_ptr<audio::Cue>> cues;
-        std::map<std::string, std::unique_ptr<audio::Sound>> sounds;
-        std::map<std::string, std::unique_ptr<graphics::Material>> materials;
-        std::map<std::string, scene::SkinnedMeshData> skinnedMeshData;
-        std::map<std::string, scene::StaticMeshData> staticMeshData;
+        std::unordered_map<Key, Record, KeyHash> records;
+        std::unordered_map<Key, std::shared_ptr<const Source>, KeyHash> evicted;
+        std::array<Residency, assetTypeCount> residencies{};
+        std::shared_ptr<const Source> loadingSource; // source of the assets that are being loaded
+
+        std::unordered_map<AssetId, std::shared_ptr<graphics::Texture>> textures;
+        std::unordered_map<AssetId, std::unique_ptr<graphics::Shader>> shaders;
+        std::unordered_map<AssetId, scene::ParticleSystemData> particleSystemData;
+        std::unordered_map<AssetId, std::unique_ptr<graphics::BlendState>> blendStates;
+        std::unordered_map<AssetId, std::unique_ptr<graphics::DepthStencilState>> depthStencilStates;
+        std::unordered_map<AssetId, std::shared_ptr<const scene::SpriteData>> spriteData;
+        std::unordered_map<AssetId, std::unique_ptr<gui::Font>> fonts;
+        std::unordered_map<AssetId, std::unique_ptr<audio::Cue>> cues;
+        std::unordered_map<AssetId, std::unique_ptr<audio::Sound>> sounds;
+        std::unordered_map<AssetId, std::unique_ptr<graphics::Material>> materials;
+        std::unordered_map<AssetId, scene::SkinnedMeshData> skinnedMeshData;
+        std::unordered_map<AssetId, scene::StaticMeshData> staticMeshData;
     };
 }
 
@@ -1,9 +1,11 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
 #include <algorithm>
+#include <exception>
 #include "Cache.hpp"
 #include "BmfLoader.hpp"
 #include "ColladaLoader.hpp"
+#include "CookedLoader.hpp"
 #include "CueLoader.hpp"
 #include "GltfLoader.hpp"
 #include "ImageLoader.hpp"
@@ -17,9 +19,36 @@
 #include "../graphics/Graphics.hpp"
 #include "../gui/BMFont.hpp"
 #include "../gui/TTFont.hpp"
+#include "../utils/Log.hpp"
 
 namespace ouzel::assets
 {
+    namespace
+    {
+        constexpr std::size_t initialTableCapacity = 256;
+
+        constexpr const char* assetTypeNames[assetTypeCount] = {
+            "texture",
+            "shader",
+            "blend state",
+            "depth stencil state",
+            "sprite data",
+            "particle system data",
+            "font",
+            "cue",
+            "sound",
+            "material",
+            "skinned mesh data",
+            "static mesh data"
+        };
+
+        std::size_t getSlot(AssetId id, std::uint32_t type, std::size_t mask) noexcept
+        {
+            // the ids are FNV hashes already, the type only has to separate equally named assets
+            return static_cast<std::size_t>(id ^ (type * 0x9E3779B97F4A7C15ULL)) & mask;
+        }
+    }
+
     Cache::Cache()
     {
         addLoader(std::make_unique<BmfLoader>(*this));
@@ -34,20 +63,32 @@ namespace ouzel::assets
         addLoader(std::make_unique<TtfLoader>(*this));
         addLoader(std::make_unique<VorbisLoader>(*this));
         addLoader(std::make_unique<WaveLoader>(*this));
+
+        // cooked loaders are tried first, they reject anything that is not a cooked asset
+        addLoader(std::make_unique<CookedLoader>(*this, Loader::Type::font));
+        addLoader(std::make_unique<CookedLoader>(*this, Loader::Type::particleSystem));
+        addLoader(std::make_unique<CookedLoader>(*this, Loader::Type::sprite));
+        addLoader(std::make_unique<CookedLoader>(*this, Loader::Type::staticMesh));
     }
 
-    void Cache::addBundle(const Bundle* bundle)
+    void Cache::addBundle(Bundle* bundle)
     {
         const auto i = std::find(bundles.begin(), bundles.end(), bundle);
         if (i == bundles.end())
+        {
             bundles.push_back(bundle);
+            invalidate();
+        }
     }
 
     void Cache::removeBundle(const Bundle* bundle)
     {
         const auto i = std::find(bundles.begin(), bundles.end(), bundle);
         if (i != bundles.end())
+        {
             bundles.erase(i);
+            invalidate();
+        }
     }
 
     void Cache::addLoader(std::unique_ptr<Loader> loader)
@@ -66,111 +107,299 @@ namespace ouzel::assets
             loaders.erase(i);
     }
 
-    std::shared_ptr<graphics::Texture> Cache::getTexture(const std::string& name) const
+    const void* Cache::find(AssetType type, AssetId id, Resolver resolve) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto texture = bundle->getTexture(name))
-                return texture;
+        if (const auto asset = lookup(type, id, resolve)) return asset;
+
+        // loading changes the bundles, so it can't be done while the table is locked
+        for (Bundle* bundle : bundles)
+            if (bundle->getEvictedCount())
+            {
+                try
+                {
+                    if (bundle->reload(type, id))
+                        return lookup(type, id, resolve);
+                }
+                catch (const std::exception& e)
+                {
+                    // the getters report missing assets with null, the asset stays evicted and is retried later
+                    OUZEL_LOG(Log::Level::error) << "Failed to reload asset: " << e.what();
+                    return nullptr;
+                }
+            }
 
         return nullptr;
     }
 
-    const graphics::Shader* Cache::getShader(const std::string& name) const
+    const void* Cache::lookup(AssetType type, AssetId id, Resolver resolve) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto shader = bundle->getShader(name))
-                return shader;
+        std::lock_guard lock(tableMutex);
 
-        return nullptr;
+        if (!table.empty())
+        {
+            const auto mask = table.size() - 1;
+            for (auto slot = getSlot(id, static_cast<std::uint32_t>(type), mask); ; slot = (slot + 1) & mask)
+            {
+                const Entry& entry = table[slot];
+                if (entry.generation != generation) break;
+                if (entry.id == id && entry.type == type)
+                {
+                    if (entry.lastUse) *entry.lastUse = ++useClock;
+                    return entry.asset;
+                }
+            }
+        }
+
+        // the first bundle that has the asset wins, misses are cached too
+        const void* asset = nullptr;
+        std::uint64_t* lastUse = nullptr;
+        for (Bundle* bundle : bundles)
+        {
+            asset = resolve(*bundle, id);
+            if (asset)
+            {
+                lastUse = bundle->getLastUse(type, id);
+                if (lastUse) *lastUse = ++useClock;
+                break;
+            }
+        }
+
+        // keep the load factor under a half
+        if ((tableSize + 1) * 2 > table.size())
+        {
+            std::vector<Entry> newTable(table.empty() ? initialTableCapacity : table.size() * 2);
+            const auto mask = newTable.size() - 1;
+
+            for (const Entry& entry : table)
+                if (entry.generation == generation)
+                {
+                    auto slot = getSlot(entry.id, static_cast<std::uint32_t>(entry.type), mask);
+                    while (newTable[slot].generation == generation) slot = (slot + 1) & mask;
+                    newTable[slot] = entry;
+                }
+
+            table = std::move(newTable);
+        }
+
+        const auto mask = table.size() - 1;
+        auto slot = getSlot(id, static_cast<std::uint32_t>(type), mask);
+        while (table[slot].generation == generation) slot = (slot + 1) & mask;
+        table[slot] = Entry{id, type, generation, asset, lastUse};
+        ++tableSize;
+
+        return asset;
     }
 
-    const graphics::BlendState* Cache::getBlendState(const std::string& name) const
+    std::uint64_t Cache::nextUse() noexcept
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto blendState = bundle->getBlendState(name))
-                return blendState;
+        std::lock_guard lock(tableMutex);
+        return ++useClock;
+    }
 
-        return nullptr;
+    void Cache::setBudget(AssetType type, std::size_t budget)
+    {
+        budgets[static_cast<std::size_t>(type)] = budget;
+        trim();
     }
 
-    const graphics::DepthStencilState* Cache::getDepthStencilState(const std::string& name) const
+    Residency Cache::getResidency(AssetType type) const noexcept
     {
+        Residency result;
+
         for (const Bundle* bundle : bundles)
-            if (const auto depthStencilState = bundle->getDepthStencilState(name))
-                return depthStencilState;
+        {
+            const auto& residency = bundle->getResidency(type);
+            result.count += residency.count;
+            result.size += residency.size;
+        }
 
-        return nullptr;
+        return result;
     }
 
-    const scene::SpriteData* Cache::getSpriteData(const std::string& name) const
+    void Cache::trim()
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto spriteData = bundle->getSpriteData(name))
-                return spriteData;
+        struct Candidate final
+        {
+            std::uint64_t lastUse;
+            Bundle* bundle;
+            AssetId id;
+            std::size_t size;
+        };
 
-        return nullptr;
+        // sprites hold references to their textures, so evicting a sprite can make its texture evictable
+        for (const auto type : {AssetType::spriteData, AssetType::texture})
+        {
+            const auto budget = budgets[static_cast<std::size_t>(type)];
+            auto size = getResidency(type).size;
+            if (budget == 0 || size <= budget) continue;
+
+            std::vector<Candidate> candidates;
+            for (Bundle* bundle : bundles)
+                for (const auto& [key, record] : bundle->records)
+                    if (key.type == type && bundle->isEvictable(type, key.id))
+                        candidates.push_back(Candidate{record.lastUse, bundle, key.id, record.size});
+
+            std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) noexcept {
+                return a.lastUse < b.lastUse;
+            });
+
+            for (const auto& candidate : candidates)
+            {
+                if (size <= budget) break;
+                candidate.bundle->evict(type, candidate.id);
+                size -= candidate.size;
+            }
+        }
     }
 
-    const scene::ParticleSystemData* Cache::getParticleSystemData(const std::string& name) const
+    void Cache::logResidency() const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto particleSystemData = bundle->getParticleSystemData(name))
-                return particleSystemData;
+        for (std::size_t bundleIndex = 0; bundleIndex < bundles.size(); ++bundleIndex)
+        {
+            const Bundle* bundle = bundles[bundleIndex];
+            OUZEL_LOG(Log::Level::info) << "Bundle " << bundleIndex << ", " << bundle->getEvictedCount() << " evicted";
 
-        return nullptr;
+            for (std::size_t type = 0; type < assetTypeCount; ++type)
+                if (const auto& residency = bundle->getResidency(static_cast<AssetType>(type)); residency.count)
+                    OUZEL_LOG(Log::Level::info) << "  " << assetTypeNames[type] << ": " <<
+                        residency.count << " assets, " << residency.size << " bytes";
+        }
+
+        for (std::size_t type = 0; type < assetTypeCount; ++type)
+            if (const auto budget = budgets[type])
+                OUZEL_LOG(Log::Level::info) << "Budget of " << assetTypeNames[type] << ": " <<
+                    getResidency(static_cast<AssetType>(type)).size << " of " << budget << " bytes";
     }
 
-    const gui::Font* Cache::getFont(const std::string& name) const
+    void Cache::invalidate()
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto font = bundle->getFont(name))
-                return font;
+        std::lock_guard lock(tableMutex);
 
-        return nullptr;
+        tableSize = 0;
+        if (++generation == 0)
+        {
+            // the generation wrapped around, so the old entries could become valid again
+            std::fill(table.begin(), table.end(), Entry{});
+            generation = 1;
+        }
     }
 
-    const audio::Cue* Cache::getCue(const std::string& name) const
+    std::shared_ptr<graphics::Texture> Cache::getTexture(TextureHandle handle) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto cue = bundle->getCue(name))
-                return cue;
+        const auto texture = find(AssetType::texture, handle.getId(), [](const Bundle& bundle, AssetId id) -> const void* {
+            const auto i = bundle.textures.find(id);
+            return i != bundle.textures.end() ? &i->second : nullptr;
+        });
 
-        return nullptr;
+        return texture ? *static_cast<const std::shared_ptr<graphics::Texture>*>(texture) : nullptr;
     }
 
-    const audio::Sound* Cache::getSound(const std::string& name) const
+    const graphics::Shader* Cache::getShader(ShaderHandle handle) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto sound = bundle->getSound(name))
-                return sound;
+        return static_cast<const graphics::Shader*>(find(AssetType::shader, handle.getId(), [](const Bundle& bundle, AssetId id) -> const void* {
+            return bundle.getShader(ShaderHandle{id});
+        }));
+    }
 
-        return nullptr;
+    const graphics::BlendState* Cache::getBlendState(BlendStateHandle handle) const
+    {
+        return static_cast<const graphics::BlendState*>(find(AssetType::blendState, handle.getId(), [](const Bundle& bundle, AssetId id) -> const void* {
+            return bundle.getBlendState(BlendStateHandle{id});
+        }));
     }
 
-    const graphics::Material* Cache::getMaterial(const std::string& name) const
+    const graphics::DepthStencilState* Cache::getDepthStencilState(DepthStencilStateHandle handle) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto material = bundle->getMaterial(name))
-                return material;
+        return static_cast<const graphics::DepthStencilState*>(find(AssetType::depthStencilState, handle.getId(), [](const Bundle& bundle, AssetId id) -> const void* {
+            return bundle.getDepthStencilState(DepthStencilStateHandle{id});
+        }));
+    }
 
-        return nullptr;
+    std::shared_ptr<const scene::SpriteData> Cache::getSpriteData(SpriteDataHandle handle) const
+    {
+        const auto spriteData = find(AssetType::spriteData, handle.getId(), [](const Bundle& bundle, AssetId id) -> const void* {
+            const auto i = bundle.spriteData.find(id);
+            return i != bundle.spriteData.end() ? &i->second : nullptr;
+        });
+
+        return spriteData ? *static_cast<const std::shared_ptr<const scene::SpriteData>*>(spriteData) : nullptr;
     }
 
-    const scene::SkinnedMeshData* Cache::getSkinnedMeshData(const std::string& name) const
+    std::shared_ptr<const scene::SpriteData> Cache::getSpriteData(const std::shared_ptr<graphics::Texture>& texture,
+                                                                  std::uint32_t spritesX, std::uint32_t spritesY,
+                                                                  const Vector2F& pivot) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto meshData = bundle->getSkinnedMeshData(name))
-                return meshData;
+        if (!texture) return nullptr;
 
-        return nullptr;
+        std::lock_guard lock(gridSpriteDataMutex);
+
+        // the alive sprite data holds its texture, so the texture pointer of an alive entry can't be reused
+        for (const auto& entry : gridSpriteData)
+            if (entry.texture == texture.get() &&
+                entry.spritesX == spritesX &&
+                entry.spritesY == spritesY &&
+                entry.pivot == pivot)
+                if (auto spriteData = entry.spriteData.lock())
+                    return spriteData;
+
+        gridSpriteData.erase(std::remove_if(gridSpriteData.begin(), gridSpriteData.end(), [](const auto& entry) noexcept {
+            return entry.spriteData.expired();
+        }), gridSpriteData.end());
+
+        auto spriteData = std::make_shared<scene::SpriteData>(texture, spritesX, spritesY, pivot);
+        spriteData->createBuffers();
+        spriteData->material = spriteData->createMaterial();
+
+        gridSpriteData.push_back(GridSpriteData{texture.get(), spritesX, spritesY, pivot, spriteData});
+        return spriteData;
     }
 
-    const scene::StaticMeshData* Cache::getStaticMeshData(const std::string& name) const
+    const scene::ParticleSystemData* Cache::getParticleSystemData(ParticleSystemDataHandle handle) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto meshData = bundle->getStaticMeshData(name))
-                return meshData;
+        return static_cast<const scene::ParticleSystemData*>(find(AssetType::particleSystemData, handle.getId(), [](const Bundle& bundle, AssetId id) -> const void* {
+            return bundle.getParticleSystemData(ParticleSystemDataHandle{id});
+        }));
+    }
 
-        return nullptr;
+    const gui::Font* Cache::getFont(FontHandle handle) const
+    {
+        return static_cast<const gui::Font*>(find(AssetType::font, handle.getId(), [](const Bundle& bundle, AssetId id) -> const void* {
+            return bundle.getFont(FontHandle{id});
+        }));
+    }
+
+    const audio::Cue* Cache::getCue(CueHandle handle) const
+    {
+        return static_cast<const audio::Cue*>(find(AssetType::cue, handle.getId(), [](const Bundle& bundle, AssetId id) -> const void* {
+            return bundle.getCue(CueHandle{id});
+        }));
+    }
+
+    const audio::Sound* Cache::getSound(SoundHandle handle) const
+    {
+        return static_cast<const audio::Sound*>(find(AssetType::sound, handle.getId(), [](const Bundle& bundle, AssetId id) -> const void* {
+            return bundle.getSound(SoundHandle{id});
+        }));
+    }
+
+    const graphics::Material* Cache::getMaterial(MaterialHandle handle) const
+    {
+        return static_cast<const graphics::Material*>(find(AssetType::material, handle.getId(), [](const Bundle& bundle, AssetId id) -> const void* {
+            return bundle.getMaterial(MaterialHandle{id});
+        }));
+    }
+
+    const scene::SkinnedMeshData* Cache::getSkinnedMeshData(SkinnedMeshDataHandle handle) const
+    {
+        return static_cast<const scene::SkinnedMeshData*>(find(AssetType::skinnedMeshData, handle.getId(), [](const Bundle& bundle, AssetId id) -> const void* {
+            return bundle.getSkinnedMeshData(SkinnedMeshDataHandle{id});
+        }));
+    }
+
+    const scene::StaticMeshData* Cache::getStaticMeshData(StaticMeshDataHandle handle) const
+    {
+        return static_cast<const scene::StaticMeshData*>(find(AssetType::staticMeshData, handle.getId(), [](const Bundle& bundle, AssetId id) -> const void* {
+            return bundle.getStaticMeshData(StaticMeshDataHandle{id});
+        }));
     }
 }
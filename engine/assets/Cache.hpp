@@ -3,9 +3,15 @@
 #ifndef OUZEL_ASSETS_CACHE_HPP
 #define OUZEL_ASSETS_CACHE_HPP
 
+#include <cstddef>
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 #include "Bundle.hpp"
+#include "Handle.hpp"
 
 namespace ouzel::assets
 {
@@ -27,28 +33,102 @@ namespace ouzel::assets
         auto& getBundles() const noexcept { return bundles; }
         auto& getLoaders() const noexcept { return loaders; }
 
-        std::shared_ptr<graphics::Texture> getTexture(const std::string& name) const;
-        const graphics::Shader* getShader(const std::string& name) const;
-        const graphics::BlendState* getBlendState(const std::string& name) const;
-        const graphics::DepthStencilState* getDepthStencilState(const std::string& name) const;
-        const scene::SpriteData* getSpriteData(const std::string& name) const;
-        const scene::ParticleSystemData* getParticleSystemData(const std::string& name) const;
-        const gui::Font* getFont(const std::string& name) const;
-        const audio::Cue* getCue(const std::string& name) const;
-        const audio::Sound* getSound(const std::string& name) const;
-        const graphics::Material* getMaterial(const std::string& name) const;
-        const scene::SkinnedMeshData* getSkinnedMeshData(const std::string& name) const;
-        const scene::StaticMeshData* getStaticMeshData(const std::string& name) const;
+        std::shared_ptr<graphics::Texture> getTexture(TextureHandle handle) const;
+        std::shared_ptr<graphics::Texture> getTexture(const std::string& name) const { return getTexture(TextureHandle{name}); }
+        const graphics::Shader* getShader(ShaderHandle handle) const;
+        const graphics::Shader* getShader(const std::string& name) const { return getShader(ShaderHandle{name}); }
+        const graphics::BlendState* getBlendState(BlendStateHandle handle) const;
+        const graphics::BlendState* getBlendState(const std::string& name) const { return getBlendState(BlendStateHandle{name}); }
+        const graphics::DepthStencilState* getDepthStencilState(DepthStencilStateHandle handle) const;
+        const graphics::DepthStencilState* getDepthStencilState(const std::string& name) const { return getDepthStencilState(DepthStencilStateHandle{name}); }
+        std::shared_ptr<const scene::SpriteData> getSpriteData(SpriteDataHandle handle) const;
+        std::shared_ptr<const scene::SpriteData> getSpriteData(const std::string& name) const { return getSpriteData(SpriteDataHandle{name}); }
+        // Sprite data of the texture split into a grid, shared by all the sprites that split the texture the same way
+        std::shared_ptr<const scene::SpriteData> getSpriteData(const std::shared_ptr<graphics::Texture>& texture,
+                                                               std::uint32_t spritesX, std::uint32_t spritesY,
+                                                               const Vector2F& pivot) const;
+        const scene::ParticleSystemData* getParticleSystemData(ParticleSystemDataHandle handle) const;
+        const scene::ParticleSystemData* getParticleSystemData(const std::string& name) const { return getParticleSystemData(ParticleSystemDataHandle{name}); }
+        const gui::Font* getFont(FontHandle handle) const;
+        const gui::Font* getFont(const std::string& name) const { return getFont(FontHandle{name}); }
+        const audio::Cue* getCue(CueHandle handle) const;
+        const audio::Cue* getCue(const std::string& name) const { return getCue(CueHandle{name}); }
+        const audio::Sound* getSound(SoundHandle handle) const;
+        const audio::Sound* getSound(const std::string& name) const { return getSound(SoundHandle{name}); }
+        const graphics::Material* getMaterial(MaterialHandle handle) const;
+        const graphics::Material* getMaterial(const std::string& name) const { return getMaterial(MaterialHandle{name}); }
+        const scene::SkinnedMeshData* getSkinnedMeshData(SkinnedMeshDataHandle handle) const;
+        const scene::SkinnedMeshData* getSkinnedMeshData(const std::string& name) const { return getSkinnedMeshData(SkinnedMeshDataHandle{name}); }
+        const scene::StaticMeshData* getStaticMeshData(StaticMeshDataHandle handle) const;
+        const scene::StaticMeshData* getStaticMeshData(const std::string& name) const { return getStaticMeshData(StaticMeshDataHandle{name}); }
+
+        // Memory budget of the asset type in bytes, zero means unlimited
+        // The least recently used textures and sprites that are loaded from files and not referenced
+        // outside of the bundles are evicted when the budget is exceeded and loaded again on the next access
+        void setBudget(AssetType type, std::size_t budget);
+        auto getBudget(AssetType type) const noexcept { return budgets[static_cast<std::size_t>(type)]; }
+
+        // Residency of the asset type in all the bundles
+        Residency getResidency(AssetType type) const noexcept;
+
+        // Evicts the assets until all the types are within their budgets
+        void trim();
+
+        // Logs the residency of every bundle
+        void logResidency() const;
 
     private:
-        void addBundle(const Bundle* bundle);
+
+        // Slot of the open-addressing lookup table, slots of older generations are free
+        struct Entry final
+        {
+            AssetId id = 0;
+            AssetType type = AssetType::texture;
+            std::uint32_t generation = 0;
+            const void* asset = nullptr;
+            std::uint64_t* lastUse = nullptr; // LRU stamp of the asset in its bundle
+        };
+
+        using Resolver = const void*(*)(const Bundle& bundle, AssetId id);
+
+        // Evicted assets are loaded again on a miss
+        const void* find(AssetType type, AssetId id, Resolver resolve) const;
+        const void* lookup(AssetType type, AssetId id, Resolver resolve) const;
+
+        std::uint64_t nextUse() noexcept;
+
+        // Called after any change of the bundles, drops all the table entries at once
+        void invalidate();
+
+        void addBundle(Bundle* bundle);
         void removeBundle(const Bundle* bundle);
 
         void addLoader(std::unique_ptr<Loader> loader);
         void removeLoader(const Loader* loader);
 
-        std::vector<const Bundle*> bundles;
+        // The sprite data of a grid lives as long as the sprites that use it
+        struct GridSpriteData final
+        {
+            const graphics::Texture* texture;
+            std::uint32_t spritesX;
+            std::uint32_t spritesY;
+            Vector2F pivot;
+            std::weak_ptr<const scene::SpriteData> spriteData;
+        };
+
+        std::vector<Bundle*> bundles;
         std::vector<std::unique_ptr<Loader>> loaders;
+
+        mutable std::mutex tableMutex;
+        mutable std::vector<Entry> table;
+        mutable std::size_t tableSize = 0;
+        std::uint32_t generation = 1;
+        mutable std::uint64_t useClock = 0;
+
+        std::array<std::size_t, assetTypeCount> budgets{};
+
+        mutable std::mutex gridSpriteDataMutex;
+        mutable std::vector<GridSpriteData> gridSpriteData;
     };
 }
 
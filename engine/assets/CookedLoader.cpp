@@ -0,0 +1,266 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <stdexcept>
+#include <type_traits>
+#include "CookedLoader.hpp"
+#include "Bundle.hpp"
+#include "Cache.hpp"
+#include "../gui/BMFont.hpp"
+#include "../scene/ParticleSystem.hpp"
+#include "../scene/SpriteRenderer.hpp"
+#include "../scene/StaticMeshRenderer.hpp"
+
+namespace ouzel::assets
+{
+    namespace
+    {
+        static_assert(std::is_trivially_copyable_v<graphics::Vertex>);
+
+        constexpr cooked::AssetType getAssetType(Loader::Type type)
+        {
+            switch (type)
+            {
+                case Loader::Type::staticMesh: return cooked::AssetType::staticMesh;
+                case Loader::Type::sprite: return cooked::AssetType::sprite;
+                case Loader::Type::particleSystem: return cooked::AssetType::particleSystem;
+                case Loader::Type::font: return cooked::AssetType::font;
+                default: throw std::runtime_error("Asset type can't be cooked");
+            }
+        }
+    }
+
+    CookedLoader::CookedLoader(Cache& initCache, Type initType):
+        Loader(initCache, initType)
+    {
+        getAssetType(initType); // throws for unsupported types
+    }
+
+    bool CookedLoader::loadAsset(Bundle& bundle,
+                                 const std::string& name,
+                                 const std::vector<std::byte>& data,
+                                 bool mipmaps)
+    {
+        return loadMappedAsset(bundle, name, data.data(), data.size(), mipmaps);
+    }
+
+    bool CookedLoader::loadMappedAsset(Bundle& bundle,
+                                       const std::string& name,
+                                       const std::byte* data,
+                                       std::size_t size,
+                                       bool mipmaps)
+    {
+        if (!cooked::isCooked(data, size)) return false;
+
+        cooked::Reader reader(data, size);
+        if (reader.getAssetType() != getAssetType(type)) return false;
+
+        switch (type)
+        {
+            case Type::staticMesh: loadStaticMeshes(bundle, name, reader, mipmaps); break;
+            case Type::sprite: loadSprite(bundle, name, reader, mipmaps); break;
+            case Type::particleSystem: loadParticleSystem(bundle, name, reader, mipmaps); break;
+            case Type::font: loadFont(bundle, name, reader, mipmaps); break;
+            default: return false;
+        }
+
+        return true;
+    }
+
+    void CookedLoader::loadStaticMeshes(Bundle& bundle, const std::string& name,
+                                        cooked::Reader& reader, bool mipmaps)
+    {
+        while (reader.hasChunks() && reader.peek() == cooked::ChunkType::materialLibrary)
+        {
+            const std::string filename(reader.next().getString());
+            bundle.loadAsset(Type::material, filename, filename, mipmaps);
+        }
+
+        while (reader.hasChunks())
+        {
+            const auto objectName = reader.next(cooked::ChunkType::name).getString();
+            const auto& mesh = reader.next(cooked::ChunkType::mesh).get<cooked::Mesh>();
+
+            const graphics::Material* material = nullptr;
+            if (reader.peek() == cooked::ChunkType::material)
+                material = cache.getMaterial(std::string(reader.next().getString()));
+
+            const auto vertexChunk = reader.next(cooked::ChunkType::vertices);
+            const auto indexChunk = reader.next(cooked::ChunkType::indices);
+
+            const Box3F boundingBox(Vector3F(mesh.boundingBoxMin[0], mesh.boundingBoxMin[1], mesh.boundingBoxMin[2]),
+                                    Vector3F(mesh.boundingBoxMax[0], mesh.boundingBoxMax[1], mesh.boundingBoxMax[2]));
+
+            if (indexChunk.getSize() < static_cast<std::size_t>(mesh.indexSize) * mesh.indexCount)
+                throw cooked::FormatError("Invalid index data");
+
+            scene::StaticMeshData meshData(boundingBox,
+                                           indexChunk.getData(),
+                                           mesh.indexSize,
+                                           mesh.indexCount,
+                                           vertexChunk.getArray<graphics::Vertex>(mesh.vertexCount),
+                                           mesh.vertexCount,
+                                           material);
+
+            // objects without a name are named after the asset
+            bundle.setStaticMeshData(objectName.empty() ? name : std::string(objectName), std::move(meshData));
+        }
+    }
+
+    void CookedLoader::loadSprite(Bundle& bundle, const std::string& name,
+                                  cooked::Reader& reader, bool mipmaps)
+    {
+        const auto& sprite = reader.next(cooked::ChunkType::sprite).get<cooked::Sprite>();
+        const std::string textureFilename(reader.next(cooked::ChunkType::texture).getString());
+
+        scene::SpriteData spriteData;
+        spriteData.texture = getTexture(bundle, textureFilename, mipmaps);
+
+        const Size2F textureSize = sprite.textureWidth > 0.0F && sprite.textureHeight > 0.0F ?
+            Size2F(sprite.textureWidth, sprite.textureHeight) :
+            Size2F(static_cast<float>(spriteData.texture->getSize().v[0]),
+                   static_cast<float>(spriteData.texture->getSize().v[1]));
+
+        scene::SpriteData::Animation animation;
+        animation.frameInterval = sprite.frameInterval;
+        animation.frames.reserve(sprite.frameCount);
+
+        for (std::uint32_t i = 0; i < sprite.frameCount; ++i)
+        {
+            const std::string frameName(reader.next(cooked::ChunkType::name).getString());
+            const auto& frame = reader.next(cooked::ChunkType::frame).get<cooked::Frame>();
+
+            if (frame.polygon)
+            {
+                const auto vertexChunk = reader.next(cooked::ChunkType::vertices);
+                const auto indexChunk = reader.next(cooked::ChunkType::indices);
+
+                const auto vertexCount = static_cast<std::uint32_t>(vertexChunk.getSize() / sizeof(graphics::Vertex));
+                const auto indexCount = static_cast<std::uint32_t>(indexChunk.getSize() / sizeof(std::uint16_t));
+
+                animation.frames.emplace_back(frameName,
+                                              indexChunk.getArray<std::uint16_t>(indexCount), indexCount,
+                                              vertexChunk.getArray<graphics::Vertex>(vertexCount), vertexCount);
+            }
+            else
+                animation.frames.emplace_back(frameName, textureSize,
+                                              RectF(frame.x, frame.y, frame.width, frame.height),
+                                              frame.rotated != 0,
+                                              Size2F(frame.sourceWidth, frame.sourceHeight),
+                                              Vector2F(frame.offsetX, frame.offsetY),
+                                              Vector2F(frame.pivotX, frame.pivotY));
+        }
+
+        spriteData.animations[""] = std::move(animation);
+
+        bundle.setSpriteData(name, spriteData);
+    }
+
+    void CookedLoader::loadParticleSystem(Bundle& bundle, const std::string& name,
+                                          cooked::Reader& reader, bool mipmaps)
+    {
+        scene::ParticleSystemData particleSystemData;
+        particleSystemData.name = std::string(reader.next(cooked::ChunkType::name).getString());
+
+        const auto& p = reader.next(cooked::ChunkType::particleSystem).get<cooked::ParticleSystem>();
+
+        particleSystemData.blendFuncSource = p.blendFuncSource;
+        particleSystemData.blendFuncDestination = p.blendFuncDestination;
+
+        switch (p.emitterType)
+        {
+            case 0: particleSystemData.emitterType = scene::ParticleSystemData::EmitterType::gravity; break;
+            case 1: particleSystemData.emitterType = scene::ParticleSystemData::EmitterType::radius; break;
+            default: throw std::runtime_error("Unsupported emitter type");
+        }
+
+        particleSystemData.maxParticles = p.maxParticles;
+        particleSystemData.duration = p.duration;
+        particleSystemData.particleLifespan = p.particleLifespan;
+        particleSystemData.particleLifespanVariance = p.particleLifespanVariance;
+        particleSystemData.speed = p.speed;
+        particleSystemData.speedVariance = p.speedVariance;
+        particleSystemData.sourcePosition = Vector2F(p.sourcePosition[0], p.sourcePosition[1]);
+        particleSystemData.sourcePositionVariance = Vector2F(p.sourcePositionVariance[0], p.sourcePositionVariance[1]);
+        particleSystemData.startParticleSize = p.startParticleSize;
+        particleSystemData.startParticleSizeVariance = p.startParticleSizeVariance;
+        particleSystemData.finishParticleSize = p.finishParticleSize;
+        particleSystemData.finishParticleSizeVariance = p.finishParticleSizeVariance;
+        particleSystemData.angle = p.angle;
+        particleSystemData.angleVariance = p.angleVariance;
+        particleSystemData.startRotation = p.startRotation;
+        particleSystemData.startRotationVariance = p.startRotationVariance;
+        particleSystemData.finishRotation = p.finishRotation;
+        particleSystemData.finishRotationVariance = p.finishRotationVariance;
+        particleSystemData.rotatePerSecond = p.rotatePerSecond;
+        particleSystemData.rotatePerSecondVariance = p.rotatePerSecondVariance;
+        particleSystemData.minRadius = p.minRadius;
+        particleSystemData.minRadiusVariance = p.minRadiusVariance;
+        particleSystemData.maxRadius = p.maxRadius;
+        particleSystemData.maxRadiusVariance = p.maxRadiusVariance;
+        particleSystemData.radialAcceleration = p.radialAcceleration;
+        particleSystemData.radialAccelVariance = p.radialAccelVariance;
+        particleSystemData.tangentialAcceleration = p.tangentialAcceleration;
+        particleSystemData.tangentialAccelVariance = p.tangentialAccelVariance;
+        particleSystemData.absolutePosition = p.absolutePosition != 0;
+        particleSystemData.yCoordFlipped = p.yCoordFlipped != 0;
+        particleSystemData.rotationIsDir = p.rotationIsDir != 0;
+        particleSystemData.gravity = Vector2F(p.gravity[0], p.gravity[1]);
+
+        particleSystemData.startColorRed = p.startColor[0];
+        particleSystemData.startColorGreen = p.startColor[1];
+        particleSystemData.startColorBlue = p.startColor[2];
+        particleSystemData.startColorAlpha = p.startColor[3];
+        particleSystemData.startColorRedVariance = p.startColorVariance[0];
+        particleSystemData.startColorGreenVariance = p.startColorVariance[1];
+        particleSystemData.startColorBlueVariance = p.startColorVariance[2];
+        particleSystemData.startColorAlphaVariance = p.startColorVariance[3];
+        particleSystemData.finishColorRed = p.finishColor[0];
+        particleSystemData.finishColorGreen = p.finishColor[1];
+        particleSystemData.finishColorBlue = p.finishColor[2];
+        particleSystemData.finishColorAlpha = p.finishColor[3];
+        particleSystemData.finishColorRedVariance = p.finishColorVariance[0];
+        particleSystemData.finishColorGreenVariance = p.finishColorVariance[1];
+        particleSystemData.finishColorBlueVariance = p.finishColorVariance[2];
+        particleSystemData.finishColorAlphaVariance = p.finishColorVariance[3];
+
+        particleSystemData.texture = getTexture(bundle, std::string(reader.next(cooked::ChunkType::texture).getString()), mipmaps);
+
+        particleSystemData.emissionRate = static_cast<float>(particleSystemData.maxParticles) / particleSystemData.particleLifespan;
+
+        bundle.setParticleSystemData(name, particleSystemData);
+    }
+
+    void CookedLoader::loadFont(Bundle& bundle, const std::string& name,
+                                cooked::Reader& reader, bool mipmaps)
+    {
+        const auto& font = reader.next(cooked::ChunkType::font).get<cooked::Font>();
+        const auto texture = getTexture(bundle, std::string(reader.next(cooked::ChunkType::texture).getString()), mipmaps);
+
+        const auto glyphChunk = reader.next(cooked::ChunkType::glyphs);
+        const auto kerningChunk = reader.next(cooked::ChunkType::kernings);
+
+        const auto glyphCount = glyphChunk.getSize() / sizeof(cooked::Glyph);
+        const auto kerningCount = kerningChunk.getSize() / sizeof(cooked::Kerning);
+
+        bundle.setFont(name, std::make_unique<gui::BMFont>(font,
+                                                           glyphChunk.getArray<cooked::Glyph>(glyphCount), glyphCount,
+                                                           kerningChunk.getArray<cooked::Kerning>(kerningCount), kerningCount,
+                                                           texture));
+    }
+
+    std::shared_ptr<graphics::Texture> CookedLoader::getTexture(Bundle& bundle, const std::string& filename, bool mipmaps)
+    {
+        auto texture = cache.getTexture(filename);
+
+        if (!texture)
+        {
+            bundle.loadAsset(Type::image, filename, filename, mipmaps);
+            texture = cache.getTexture(filename);
+        }
+
+        if (!texture)
+            throw std::runtime_error("Failed to load texture " + filename);
+
+        return texture;
+    }
+}
@@ -0,0 +1,39 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_ASSETS_COOKEDLOADER_HPP
+#define OUZEL_ASSETS_COOKEDLOADER_HPP
+
+#include <memory>
+#include "Loader.hpp"
+#include "../formats/Cooked.hpp"
+#include "../graphics/Texture.hpp"
+
+namespace ouzel::assets
+{
+    // Loads the binary assets exported by the ouzel tool, one instance is registered per asset type
+    class CookedLoader final: public Loader
+    {
+    public:
+        CookedLoader(Cache& initCache, Type initType);
+        bool loadAsset(Bundle& bundle,
+                       const std::string& name,
+                       const std::vector<std::byte>& data,
+                       bool mipmaps = true) final;
+
+        bool loadMappedAsset(Bundle& bundle,
+                             const std::string& name,
+                             const std::byte* data,
+                             std::size_t size,
+                             bool mipmaps) final;
+
+    private:
+        void loadStaticMeshes(Bundle& bundle, const std::string& name, cooked::Reader& reader, bool mipmaps);
+        void loadSprite(Bundle& bundle, const std::string& name, cooked::Reader& reader, bool mipmaps);
+        void loadParticleSystem(Bundle& bundle, const std::string& name, cooked::Reader& reader, bool mipmaps);
+        void loadFont(Bundle& bundle, const std::string& name, cooked::Reader& reader, bool mipmaps);
+
+        std::shared_ptr<graphics::Texture> getTexture(Bundle& bundle, const std::string& filename, bool mipmaps);
+    };
+}
+
+#endif // OUZEL_ASSETS_COOKEDLOADER_HPP
@@ -1,12 +1,510 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <stdexcept>
 #include "GltfLoader.hpp"
 #include "Bundle.hpp"
-#include "../scene/SkinnedMeshRenderer.hpp"
+#include "Cache.hpp"
+#include "../core/Engine.hpp"
 #include "../formats/Json.hpp"
 
 namespace ouzel::assets
 {
+    namespace
+    {
+        constexpr std::uint32_t trianglesMode = 4;
+
+        bool isGltf(const std::vector<std::byte>& data) noexcept
+        {
+            if (data.size() >= 4 &&
+                static_cast<char>(data[0]) == 'g' &&
+                static_cast<char>(data[1]) == 'l' &&
+                static_cast<char>(data[2]) == 'T' &&
+                static_cast<char>(data[3]) == 'F')
+                return true;
+
+            // text glTF is a JSON object
+            for (const auto c : data)
+                if (static_cast<char>(c) == '{')
+                    return true;
+                else if (static_cast<char>(c) != ' ' &&
+                         static_cast<char>(c) != '\t' &&
+                         static_cast<char>(c) != '\r' &&
+                         static_cast<char>(c) != '\n' &&
+                         static_cast<std::uint8_t>(c) != 0xEF &&
+                         static_cast<std::uint8_t>(c) != 0xBB &&
+                         static_cast<std::uint8_t>(c) != 0xBF) // UTF-8 byte order mark
+                    return false;
+
+            return false;
+        }
+
+        template <std::size_t N, class Setter>
+        void readVectors(const gltf::Accessor& accessor, Setter setter)
+        {
+            if (accessor.componentCount < N)
+                throw std::runtime_error("Invalid accessor type");
+
+            Vector<N, float> value;
+
+            if (accessor.data && accessor.componentType == gltf::ComponentType::floatingPoint)
+            {
+                // floats are copied straight out of the buffer view
+                const std::byte* source = accessor.data;
+                for (std::size_t i = 0; i < accessor.count; ++i, source += accessor.stride)
+                {
+                    std::memcpy(value.v.data(), source, sizeof(float) * N);
+                    setter(i, value);
+                }
+            }
+            else
+                for (std::size_t i = 0; i < accessor.count; ++i)
+                {
+                    for (std::size_t c = 0; c < N; ++c)
+                        value.v[c] = accessor.getFloat(i, c);
+                    setter(i, value);
+                }
+        }
+
+        void convertPositions(const gltf::Accessor& accessor,
+                              graphics::Vertex* vertices,
+                              Box3F& boundingBox)
+        {
+            readVectors<3>(accessor, [vertices](std::size_t i, const Vector3F& position) noexcept {
+                vertices[i].position = position;
+            });
+
+            if (!accessor.count) return;
+
+#if defined(__SSE2__)
+            __m128 minimum = _mm_set_ps(0.0F, boundingBox.min.v[2], boundingBox.min.v[1], boundingBox.min.v[0]);
+            __m128 maximum = _mm_set_ps(0.0F, boundingBox.max.v[2], boundingBox.max.v[1], boundingBox.max.v[0]);
+
+            for (std::size_t i = 0; i < accessor.count; ++i)
+            {
+                const auto& position = vertices[i].position;
+                const __m128 p = _mm_set_ps(0.0F, position.v[2], position.v[1], position.v[0]);
+                minimum = _mm_min_ps(minimum, p);
+                maximum = _mm_max_ps(maximum, p);
+            }
+
+            alignas(16) float result[4];
+            _mm_store_ps(result, minimum);
+            boundingBox.min = Vector3F(result[0], result[1], result[2]);
+            _mm_store_ps(result, maximum);
+            boundingBox.max = Vector3F(result[0], result[1], result[2]);
+#else
+            for (std::size_t i = 0; i < accessor.count; ++i)
+                boundingBox.insertPoint(vertices[i].position);
+#endif
+        }
+
+        void convertColors(const gltf::Accessor& accessor,
+                           graphics::Vertex* vertices)
+        {
+            if (accessor.componentCount != 3 && accessor.componentCount != 4)
+                throw std::runtime_error("Invalid color accessor type");
+
+            const bool hasAlpha = accessor.componentCount == 4;
+
+            if (accessor.data &&
+                accessor.componentType == gltf::ComponentType::unsignedByte &&
+                hasAlpha)
+            {
+                const std::byte* source = accessor.data;
+                for (std::size_t i = 0; i < accessor.count; ++i, source += accessor.stride)
+                    std::memcpy(vertices[i].color.v.data(), source, 4);
+                return;
+            }
+
+#if defined(__SSE2__)
+            if (accessor.data && accessor.componentType == gltf::ComponentType::floatingPoint)
+            {
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 one = _mm_set1_ps(1.0F);
+                const __m128 scale = _mm_set1_ps(255.0F);
+
+                const std::byte* source = accessor.data;
+                for (std::size_t i = 0; i < accessor.count; ++i, source += accessor.stride)
+                {
+                    alignas(16) float components[4] = {0.0F, 0.0F, 0.0F, 1.0F};
+                    std::memcpy(components, source, sizeof(float) * accessor.componentCount);
+
+                    __m128 c = _mm_load_ps(components);
+                    c = _mm_mul_ps(_mm_min_ps(_mm_max_ps(c, zero), one), scale);
+                    __m128i packed = _mm_cvtps_epi32(c);
+                    packed = _mm_packs_epi32(packed, packed);
+                    packed = _mm_packus_epi16(packed, packed);
+
+                    const auto rgba = _mm_cvtsi128_si32(packed);
+                    std::memcpy(vertices[i].color.v.data(), &rgba, 4);
+                }
+                return;
+            }
+#endif
+
+            for (std::size_t i = 0; i < accessor.count; ++i)
+            {
+                const float color[4] = {
+                    std::clamp(accessor.getFloat(i, 0), 0.0F, 1.0F),
+                    std::clamp(accessor.getFloat(i, 1), 0.0F, 1.0F),
+                    std::clamp(accessor.getFloat(i, 2), 0.0F, 1.0F),
+                    hasAlpha ? std::clamp(accessor.getFloat(i, 3), 0.0F, 1.0F) : 1.0F
+                };
+                vertices[i].color = Color(color);
+            }
+        }
+
+        void convertIndices(const gltf::Accessor& accessor,
+                            std::uint32_t baseVertex,
+                            std::size_t vertexCount,
+                            std::vector<std::uint32_t>& indices)
+        {
+            if (accessor.componentCount != 1)
+                throw std::runtime_error("Invalid index accessor type");
+
+            const auto start = indices.size();
+            indices.resize(start + accessor.count);
+            std::uint32_t* destination = indices.data() + start;
+
+            if (accessor.data &&
+                accessor.componentType == gltf::ComponentType::unsignedInt &&
+                accessor.isTightlyPacked())
+                std::memcpy(destination, accessor.data, accessor.count * sizeof(std::uint32_t));
+            else if (accessor.data &&
+                     accessor.componentType == gltf::ComponentType::unsignedShort &&
+                     accessor.isTightlyPacked())
+            {
+                const std::byte* source = accessor.data;
+                for (std::size_t i = 0; i < accessor.count; ++i, source += sizeof(std::uint16_t))
+                {
+                    std::uint16_t index;
+                    std::memcpy(&index, source, sizeof(index));
+                    destination[i] = index;
+                }
+            }
+            else
+                for (std::size_t i = 0; i < accessor.count; ++i)
+                    destination[i] = accessor.getUInt(i, 0);
+
+            std::uint32_t maxIndex = 0;
+            for (std::size_t i = 0; i < accessor.count; ++i)
+            {
+                maxIndex = std::max(maxIndex, destination[i]);
+                destination[i] += baseVertex;
+            }
+
+            if (accessor.count && maxIndex >= vertexCount)
+                throw std::runtime_error("Index out of range");
+        }
+
+        void readNodeTransform(const json::Value& nodeValue,
+                               Vector3F& position,
+                               QuaternionF& rotation,
+                               Vector3F& scale)
+        {
+            if (nodeValue.hasMember("matrix"))
+            {
+                const auto& matrixValue = nodeValue["matrix"];
+                Matrix4F matrix;
+
+                // glTF matrices are stored in the same order as Matrix4F
+                for (std::size_t i = 0; i < 16; ++i)
+                    matrix.m[i] = matrixValue[i].as<float>();
+
+                position = matrix.getTranslation();
+                scale = matrix.getScale();
+                rotation = matrix.getRotation();
+                return;
+            }
+
+            if (nodeValue.hasMember("translation"))
+            {
+                const auto& translationValue = nodeValue["translation"];
+                position = Vector3F(translationValue[0].as<float>(),
+                                    translationValue[1].as<float>(),
+                                    translationValue[2].as<float>());
+            }
+
+            if (nodeValue.hasMember("rotation"))
+            {
+                const auto& rotationValue = nodeValue["rotation"];
+                rotation = QuaternionF(rotationValue[0].as<float>(),
+                                       rotationValue[1].as<float>(),
+                                       rotationValue[2].as<float>(),
+                                       rotationValue[3].as<float>());
+            }
+
+            if (nodeValue.hasMember("scale"))
+            {
+                const auto& scaleValue = nodeValue["scale"];
+                scale = Vector3F(scaleValue[0].as<float>(),
+                                 scaleValue[1].as<float>(),
+                                 scaleValue[2].as<float>());
+            }
+        }
+
+        void loadSkin(const gltf::Document& document,
+                      std::size_t skinIndex,
+                      const std::vector<std::size_t>& nodeParents,
+                      scene::SkinnedMeshData& meshData)
+        {
+            const auto& root = document.getRoot();
+            const auto& skinValue = root["skins"][skinIndex];
+            const auto& jointsValue = skinValue["joints"];
+
+            std::map<std::size_t, std::size_t> nodeBones;
+
+            for (std::size_t jointIndex = 0; jointIndex < jointsValue.getSize(); ++jointIndex)
+                nodeBones[jointsValue[jointIndex].as<std::size_t>()] = jointIndex;
+
+            meshData.bones.resize(jointsValue.getSize());
+
+            for (std::size_t jointIndex = 0; jointIndex < jointsValue.getSize(); ++jointIndex)
+            {
+                const auto node = jointsValue[jointIndex].as<std::size_t>();
+                const auto& nodeValue = root["nodes"][node];
+                auto& bone = meshData.bones[jointIndex];
+
+                if (nodeValue.hasMember("name"))
+                    bone.name = nodeValue["name"].as<std::string>();
+
+                readNodeTransform(nodeValue, bone.position, bone.rotation, bone.scale);
+
+                const auto parentBone = nodeBones.find(nodeParents[node]);
+                if (parentBone != nodeBones.end())
+                    bone.parent = parentBone->second;
+            }
+
+            if (skinValue.hasMember("inverseBindMatrices"))
+            {
+                const auto accessor = document.getAccessor(skinValue["inverseBindMatrices"].as<std::size_t>());
+
+                if (accessor.componentCount != 16 || accessor.count < meshData.bones.size())
+                    throw std::runtime_error("Invalid inverse bind matrices");
+
+                for (std::size_t i = 0; i < meshData.bones.size(); ++i)
+                    for (std::size_t c = 0; c < 16; ++c)
+                        meshData.bones[i].inverseBindMatrix.m[c] = accessor.getFloat(i, c);
+            }
+
+            if (!root.hasMember("animations")) return;
+
+            for (const json::Value& animationValue : root["animations"])
+            {
+                scene::SkinnedMeshData::Animation animation;
+                if (animationValue.hasMember("name"))
+                    animation.name = animationValue["name"].as<std::string>();
+
+                const auto& samplersValue = animationValue["samplers"];
+
+                for (const json::Value& channelValue : animationValue["channels"])
+                {
+                    const auto& targetValue = channelValue["target"];
+                    if (!targetValue.hasMember("node")) continue;
+
+                    const auto bone = nodeBones.find(targetValue["node"].as<std::size_t>());
+                    if (bone == nodeBones.end()) continue; // the channel doesn't animate this skin
+
+                    scene::SkinnedMeshData::Channel channel;
+                    channel.bone = bone->second;
+
+                    const auto& path = targetValue["path"].as<std::string>();
+                    if (path == "translation") channel.path = scene::SkinnedMeshData::Channel::Path::translation;
+                    else if (path == "rotation") channel.path = scene::SkinnedMeshData::Channel::Path::rotation;
+                    else if (path == "scale") channel.path = scene::SkinnedMeshData::Channel::Path::scale;
+                    else continue; // morph target weights are not supported
+
+                    const auto& samplerValue = samplersValue[channelValue["sampler"].as<std::size_t>()];
+
+                    const auto interpolation = samplerValue.hasMember("interpolation") ?
+                        samplerValue["interpolation"].as<std::string>() : std::string("LINEAR");
+                    const bool cubicSpline = interpolation == "CUBICSPLINE";
+
+                    // cubic splines are sampled at the keyframes and interpolated linearly
+                    channel.interpolation = interpolation == "STEP" ?
+                        scene::SkinnedMeshData::Channel::Interpolation::step :
+                        scene::SkinnedMeshData::Channel::Interpolation::linear;
+
+                    const auto input = document.getAccessor(samplerValue["input"].as<std::size_t>());
+                    const auto output = document.getAccessor(samplerValue["output"].as<std::size_t>());
+
+                    channel.times.resize(input.count);
+                    for (std::size_t i = 0; i < input.count; ++i)
+                    {
+                        channel.times[i] = input.getFloat(i, 0);
+                        animation.duration = std::max(animation.duration, channel.times[i]);
+                    }
+
+                    const std::size_t valuesPerKey = cubicSpline ? 3 : 1;
+                    const std::size_t valueOffset = cubicSpline ? 1 : 0; // skip the in-tangent
+
+                    if (output.count < input.count * valuesPerKey)
+                        throw std::runtime_error("Invalid animation sampler output");
+
+                    channel.values.resize(input.count);
+                    for (std::size_t i = 0; i < input.count; ++i)
+                        for (std::size_t c = 0; c < output.componentCount && c < 4; ++c)
+                            channel.values[i].v[c] = output.getFloat(i * valuesPerKey + valueOffset, c);
+
+                    animation.channels.push_back(std::move(channel));
+                }
+
+                if (!animation.channels.empty())
+                    meshData.animations.push_back(std::move(animation));
+            }
+        }
+
+        void loadPrimitive(const gltf::Document& document,
+                           const json::Value& primitiveValue,
+                           const std::vector<const graphics::Material*>& materials,
+                           scene::SkinnedMeshData& meshData)
+        {
+            const auto& attributesValue = primitiveValue["attributes"];
+            if (!attributesValue.hasMember("POSITION"))
+                throw std::runtime_error("Primitive has no positions");
+
+            const auto positions = document.getAccessor(attributesValue["POSITION"].as<std::size_t>());
+            const auto baseVertex = static_cast<std::uint32_t>(meshData.vertices.size());
+
+            meshData.vertices.resize(baseVertex + positions.count, graphics::Vertex(Vector3F(), Color::white(), Vector2F(), Vector3F()));
+            graphics::Vertex* vertices = meshData.vertices.data() + baseVertex;
+
+            convertPositions(positions, vertices, meshData.boundingBox);
+
+            const auto attribute = [&document, &attributesValue, &positions](const char* attributeName) {
+                auto accessor = document.getAccessor(attributesValue[attributeName].as<std::size_t>());
+                if (accessor.count != positions.count)
+                    throw std::runtime_error(std::string("Invalid attribute count ") + attributeName);
+                return accessor;
+            };
+
+            if (attributesValue.hasMember("NORMAL"))
+                readVectors<3>(attribute("NORMAL"), [vertices](std::size_t i, const Vector3F& normal) noexcept {
+                    vertices[i].normal = normal;
+                });
+
+            if (attributesValue.hasMember("TEXCOORD_0"))
+                readVectors<2>(attribute("TEXCOORD_0"), [vertices](std::size_t i, const Vector2F& texCoord) noexcept {
+                    vertices[i].texCoords[0] = texCoord;
+                });
+
+            if (attributesValue.hasMember("TEXCOORD_1"))
+                readVectors<2>(attribute("TEXCOORD_1"), [vertices](std::size_t i, const Vector2F& texCoord) noexcept {
+                    vertices[i].texCoords[1] = texCoord;
+                });
+
+            if (attributesValue.hasMember("COLOR_0"))
+                convertColors(attribute("COLOR_0"), vertices);
+
+            if (attributesValue.hasMember("JOINTS_0") && attributesValue.hasMember("WEIGHTS_0"))
+            {
+                const auto joints = attribute("JOINTS_0");
+                const auto weights = attribute("WEIGHTS_0");
+
+                if (joints.componentCount != 4 || weights.componentCount != 4)
+                    throw std::runtime_error("Invalid skin attributes");
+
+                meshData.boneIndices.resize(meshData.vertices.size());
+                meshData.boneWeights.resize(meshData.vertices.size());
+
+                for (std::size_t i = 0; i < positions.count; ++i)
+                {
+                    auto& boneIndices = meshData.boneIndices[baseVertex + i];
+                    auto& boneWeights = meshData.boneWeights[baseVertex + i];
+
+                    float sum = 0.0F;
+                    for (std::size_t c = 0; c < 4; ++c)
+                    {
+                        boneIndices[c] = static_cast<std::uint16_t>(joints.getUInt(i, c));
+                        boneWeights.v[c] = weights.getFloat(i, c);
+                        sum += boneWeights.v[c];
+                    }
+
+                    // quantized weights don't always add up to one
+                    if (sum > 0.0F)
+                        for (float& weight : boneWeights.v)
+                            weight /= sum;
+                }
+            }
+            else if (!meshData.boneIndices.empty())
+            {
+                meshData.boneIndices.resize(meshData.vertices.size());
+                meshData.boneWeights.resize(meshData.vertices.size());
+            }
+
+            scene::SkinnedMeshData::Primitive primitive;
+            primitive.startIndex = static_cast<std::uint32_t>(meshData.indices.size());
+
+            if (primitiveValue.hasMember("indices"))
+                convertIndices(document.getAccessor(primitiveValue["indices"].as<std::size_t>()), baseVertex, positions.count, meshData.indices);
+            else
+                for (std::uint32_t i = 0; i < positions.count; ++i)
+                    meshData.indices.push_back(baseVertex + i);
+
+            primitive.indexCount = static_cast<std::uint32_t>(meshData.indices.size()) - primitive.startIndex;
+
+            if (primitiveValue.hasMember("material"))
+            {
+                const auto material = primitiveValue["material"].as<std::size_t>();
+                if (material < materials.size())
+                    primitive.material = materials[material];
+            }
+
+            meshData.primitives.push_back(primitive);
+        }
+
+        std::shared_ptr<graphics::Texture> loadImage(Cache& cache,
+                                                     Bundle& bundle,
+                                                     const gltf::Document& document,
+                                                     const std::string& name,
+                                                     std::size_t imageIndex,
+                                                     bool mipmaps)
+        {
+            const auto& imageValue = document.getRoot()["images"][imageIndex];
+
+            if (imageValue.hasMember("uri"))
+            {
+                const auto& uri = imageValue["uri"].as<std::string>();
+
+                if (uri.compare(0, 5, "data:") != 0)
+                {
+                    if (auto texture = cache.getTexture(uri)) return texture;
+                    bundle.loadAsset(Loader::Type::image, uri, uri, mipmaps);
+                    return cache.getTexture(uri);
+                }
+            }
+
+            const auto textureName = name + "/image" + std::to_string(imageIndex);
+            if (auto texture = cache.getTexture(textureName)) return texture;
+
+            std::vector<std::byte> data;
+            if (imageValue.hasMember("bufferView"))
+            {
+                const auto bufferView = document.getBufferView(imageValue["bufferView"].as<std::size_t>());
+                data.assign(bufferView.first, bufferView.first + bufferView.second);
+            }
+            else
+            {
+                const auto& uri = imageValue["uri"].as<std::string>();
+                data = gltf::decodeBase64(uri.substr(uri.find(',') + 1));
+            }
+
+            const auto& loaders = cache.getLoaders();
+            for (auto i = loaders.rbegin(); i != loaders.rend(); ++i)
+                if ((*i)->getType() == Loader::Type::image &&
+                    (*i)->loadAsset(bundle, textureName, data, mipmaps))
+                    return cache.getTexture(textureName);
+
+            throw std::runtime_error("Failed to load image " + textureName);
+        }
+    }
+
     GltfLoader::GltfLoader(Cache& initCache):
         Loader(initCache, Type::skinnedMesh)
     {
@@ -17,18 +515,141 @@ namespace ouzel::assets
                                const std::vector<std::byte>& data,
                                bool mipmaps)
     {
-        const auto d = json::parse(data);
+        if (!isGltf(data)) return false;
+
+        const gltf::Document document(data, [](const std::string& filename) {
+            return engine->getFileSystem().readFile(filename);
+        });
 
-        const auto& nodesValue = d["nodes"];
-        const auto& meshesValue = d["meshes"];
+        const auto& root = document.getRoot();
 
-        (void)mipmaps;
-        (void)nodesValue;
-        (void)meshesValue;
+        std::vector<const graphics::Material*> materials;
 
-        scene::SkinnedMeshData skinnedMeshData;
-        bundle.setSkinnedMeshData(name, std::move(skinnedMeshData));
+        for (std::size_t materialIndex = 0; materialIndex < document.getCount("materials"); ++materialIndex)
+        {
+            const auto& materialValue = root["materials"][materialIndex];
+
+            auto material = std::make_unique<graphics::Material>();
+            material->cullMode = (materialValue.hasMember("doubleSided") && materialValue["doubleSided"].as<bool>()) ?
+                graphics::CullMode::none : graphics::CullMode::back;
+
+            const auto alphaMode = materialValue.hasMember("alphaMode") ?
+                materialValue["alphaMode"].as<std::string>() : std::string("OPAQUE");
+            material->blendState = cache.getBlendState(alphaMode == "BLEND" ? blendAlpha : blendNoBlend);
+
+            if (materialValue.hasMember("pbrMetallicRoughness"))
+            {
+                const auto& pbrValue = materialValue["pbrMetallicRoughness"];
+
+                if (pbrValue.hasMember("baseColorFactor"))
+                {
+                    const auto& factorValue = pbrValue["baseColorFactor"];
+                    const float color[4] = {
+                        factorValue[0].as<float>(),
+                        factorValue[1].as<float>(),
+                        factorValue[2].as<float>(),
+                        1.0F
+                    };
+                    material->diffuseColor = Color(color);
+                    material->opacity = factorValue[3].as<float>();
+                }
+
+                if (pbrValue.hasMember("baseColorTexture"))
+                {
+                    const auto textureIndex = pbrValue["baseColorTexture"]["index"].as<std::size_t>();
+                    const auto& textureValue = root["textures"][textureIndex];
+
+                    if (textureValue.hasMember("source"))
+                        material->textures[0] = loadImage(cache, bundle, document, name,
+                                                          textureValue["source"].as<std::size_t>(), mipmaps);
+                }
+            }
+
+            material->shader = material->textures[0] ? cache.getShader(shaderTexture) : cache.getShader(shaderColor);
+
+            materials.push_back(material.get());
+
+            const auto materialName = materialValue.hasMember("name") ?
+                name + "/" + materialValue["name"].as<std::string>() :
+                name + "/material" + std::to_string(materialIndex);
+            bundle.setMaterial(materialName, std::move(material));
+        }
+
+        auto meshes = loadMeshes(document, materials);
+
+        for (std::size_t meshIndex = 0; meshIndex < meshes.size(); ++meshIndex)
+        {
+            auto& mesh = meshes[meshIndex];
+
+            mesh.second.initBuffers();
+
+            // the first mesh is accessible by the name of the asset
+            bundle.setSkinnedMeshData(meshIndex == 0 ? name : name + "/" + mesh.first, std::move(mesh.second));
+        }
 
         return true;
     }
+
+    std::vector<std::pair<std::string, scene::SkinnedMeshData>> GltfLoader::loadMeshes(const gltf::Document& document,
+                                                                                        const std::vector<const graphics::Material*>& materials)
+    {
+        const auto& root = document.getRoot();
+
+        // parent of every node, used to build the bone hierarchy
+        std::vector<std::size_t> nodeParents(document.getCount("nodes"), scene::SkinnedMeshData::noParent);
+        std::vector<std::size_t> meshSkins(document.getCount("meshes"), scene::SkinnedMeshData::noParent);
+
+        for (std::size_t node = 0; node < nodeParents.size(); ++node)
+        {
+            const auto& nodeValue = root["nodes"][node];
+
+            if (nodeValue.hasMember("children"))
+                for (const json::Value& childValue : nodeValue["children"])
+                {
+                    const auto child = childValue.as<std::size_t>();
+                    if (child >= nodeParents.size())
+                        throw std::runtime_error("Invalid node index");
+                    nodeParents[child] = node;
+                }
+
+            if (nodeValue.hasMember("mesh") && nodeValue.hasMember("skin"))
+            {
+                const auto mesh = nodeValue["mesh"].as<std::size_t>();
+                if (mesh >= meshSkins.size())
+                    throw std::runtime_error("Invalid mesh index");
+                meshSkins[mesh] = nodeValue["skin"].as<std::size_t>();
+            }
+        }
+
+        std::vector<std::pair<std::string, scene::SkinnedMeshData>> result;
+        result.reserve(meshSkins.size());
+
+        for (std::size_t meshIndex = 0; meshIndex < meshSkins.size(); ++meshIndex)
+        {
+            const auto& meshValue = root["meshes"][meshIndex];
+
+            scene::SkinnedMeshData meshData;
+
+            for (const json::Value& primitiveValue : meshValue["primitives"])
+            {
+                // only triangle lists are supported
+                if (primitiveValue.hasMember("mode") &&
+                    primitiveValue["mode"].as<std::uint32_t>() != trianglesMode)
+                    continue;
+
+                loadPrimitive(document, primitiveValue, materials, meshData);
+            }
+
+            if (meshSkins[meshIndex] != scene::SkinnedMeshData::noParent)
+                loadSkin(document, meshSkins[meshIndex], nodeParents, meshData);
+
+            const auto meshName = meshValue.hasMember("name") ?
+                meshValue["name"].as<std::string>() :
+                "mesh" + std::to_string(meshIndex);
+
+            result.emplace_back(meshName, std::move(meshData));
+        }
+
+        return result;
+    }
 }
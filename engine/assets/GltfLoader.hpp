@@ -3,7 +3,12 @@
 #ifndef OUZEL_ASSETS_GLTFLOADER_HPP
 #define OUZEL_ASSETS_GLTFLOADER_HPP
 
+#include <string>
+#include <utility>
+#include <vector>
 #include "Loader.hpp"
+#include "../formats/Gltf.hpp"
+#include "../scene/SkinnedMeshRenderer.hpp"
 
 namespace ouzel::assets
 {
@@ -15,6 +20,10 @@ namespace ouzel::assets
                        const std::string& name,
                        const std::vector<std::byte>& data,
                        bool mipmaps = true) final;
+
+        // Converts all the meshes of the document to the CPU side mesh data (no buffers are created)
+        static std::vector<std::pair<std::string, scene::SkinnedMeshData>> loadMeshes(const gltf::Document& document,
+                                                                                      const std::vector<const graphics::Material*>& materials);
     };
 }
 
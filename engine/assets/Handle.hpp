@@ -0,0 +1,96 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_ASSETS_HANDLE_HPP
+#define OUZEL_ASSETS_HANDLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "../hash/Fnv1.hpp"
+
+namespace ouzel::audio
+{
+    class Cue;
+    class Sound;
+}
+
+namespace ouzel::graphics
+{
+    class BlendState;
+    class DepthStencilState;
+    class Material;
+    class Shader;
+    class Texture;
+}
+
+namespace ouzel::gui
+{
+    class Font;
+}
+
+namespace ouzel::scene
+{
+    struct ParticleSystemData;
+    class SkinnedMeshData;
+    class SpriteData;
+    class StaticMeshData;
+}
+
+namespace ouzel::assets
+{
+    using AssetId = std::uint64_t;
+
+    enum class AssetType: std::uint32_t
+    {
+        texture,
+        shader,
+        blendState,
+        depthStencilState,
+        spriteData,
+        particleSystemData,
+        font,
+        cue,
+        sound,
+        material,
+        skinnedMeshData,
+        staticMeshData
+    };
+
+    constexpr std::size_t assetTypeCount = static_cast<std::size_t>(AssetType::staticMeshData) + 1;
+
+    // Typed asset name hashed with FNV-1, the hash is computed at compile time for constexpr handles
+    template <class T>
+    class Handle final
+    {
+    public:
+        constexpr Handle() noexcept = default;
+        constexpr explicit Handle(AssetId initId) noexcept: id(initId) {}
+        constexpr explicit Handle(const std::string_view name) noexcept:
+            id(hash::fnv1::hash<AssetId>(name))
+        {
+        }
+
+        constexpr auto getId() const noexcept { return id; }
+
+        constexpr bool operator==(const Handle& other) const noexcept { return id == other.id; }
+        constexpr bool operator!=(const Handle& other) const noexcept { return id != other.id; }
+
+    private:
+        AssetId id = 0;
+    };
+
+    using TextureHandle = Handle<graphics::Texture>;
+    using ShaderHandle = Handle<graphics::Shader>;
+    using BlendStateHandle = Handle<graphics::BlendState>;
+    using DepthStencilStateHandle = Handle<graphics::DepthStencilState>;
+    using SpriteDataHandle = Handle<scene::SpriteData>;
+    using ParticleSystemDataHandle = Handle<scene::ParticleSystemData>;
+    using FontHandle = Handle<gui::Font>;
+    using CueHandle = Handle<audio::Cue>;
+    using SoundHandle = Handle<audio::Sound>;
+    using MaterialHandle = Handle<graphics::Material>;
+    using SkinnedMeshDataHandle = Handle<scene::SkinnedMeshData>;
+    using StaticMeshDataHandle = Handle<scene::StaticMeshData>;
+}
+
+#endif // OUZEL_ASSETS_HANDLE_HPP
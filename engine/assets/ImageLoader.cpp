@@ -5,7 +5,6 @@
 #include "ImageLoader.hpp"
 #include "Bundle.hpp"
 #include "../core/Engine.hpp"
-#include "../graphics/Image.hpp"
 #include "../graphics/Texture.hpp"
 
 #if defined(_MSC_VER)
@@ -44,15 +43,7 @@
 
 namespace ouzel::assets
 {
-    ImageLoader::ImageLoader(Cache& initCache):
-        Loader(initCache, Type::image)
-    {
-    }
-
-    bool ImageLoader::loadAsset(Bundle& bundle,
-                                const std::string& name,
-                                const std::vector<std::byte>& data,
-                                bool mipmaps)
+    graphics::Image decodeImage(const std::vector<std::byte>& data)
     {
         int width;
         int height;
@@ -147,10 +138,23 @@ namespace ouzel::assets
                 throw std::runtime_error("Unsupported pixel format");
         }
 
-        graphics::Image image(pixelFormat,
-                              Size2U(static_cast<std::uint32_t>(width),
-                                     static_cast<std::uint32_t>(height)),
-                              imageData);
+        return graphics::Image(pixelFormat,
+                               Size2U(static_cast<std::uint32_t>(width),
+                                      static_cast<std::uint32_t>(height)),
+                               imageData);
+    }
+
+    ImageLoader::ImageLoader(Cache& initCache):
+        Loader(initCache, Type::image)
+    {
+    }
+
+    bool ImageLoader::loadAsset(Bundle& bundle,
+                                const std::string& name,
+                                const std::vector<std::byte>& data,
+                                bool mipmaps)
+    {
+        const auto image = decodeImage(data);
 
         auto texture = std::make_shared<graphics::Texture>(*engine->getGraphics(),
                                                            image.getData(),
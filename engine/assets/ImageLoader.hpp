@@ -3,10 +3,16 @@
 #ifndef OUZEL_ASSETS_IMAGELOADER_HPP
 #define OUZEL_ASSETS_IMAGELOADER_HPP
 
+#include <cstddef>
+#include <vector>
 #include "Loader.hpp"
+#include "../graphics/Image.hpp"
 
 namespace ouzel::assets
 {
+    // Decodes a PNG, JPEG, BMP or TGA image to the RGBA8 format
+    graphics::Image decodeImage(const std::vector<std::byte>& data);
+
     class ImageLoader final: public Loader
     {
     public:
@@ -49,6 +49,17 @@ namespace ouzel::assets
                                const std::vector<std::byte>& data,
                                bool mipmaps = true) = 0;
 
+        // Loaders that can use the data in place override this, it is called for memory mapped
+        // (cooked) files and the data is valid only during the call
+        virtual bool loadMappedAsset(Bundle&,
+                                     const std::string&,
+                                     const std::byte*,
+                                     std::size_t,
+                                     bool)
+        {
+            return false;
+        }
+
     protected:
         Cache& cache;
         Type type;
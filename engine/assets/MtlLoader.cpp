@@ -1,149 +1,14 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
-#include <iterator>
-#include <stdexcept>
 #include <string>
 #include "MtlLoader.hpp"
 #include "Bundle.hpp"
 #include "Cache.hpp"
 #include "../core/Engine.hpp"
+#include "../formats/TextParser.hpp"
 
 namespace ouzel::assets
 {
-    namespace
-    {
-        constexpr auto isWhitespace(std::byte c)
-        {
-            return static_cast<char>(c) == ' ' ||
-                static_cast<char>(c) == '\t';
-        }
-
-        constexpr auto isNewline(std::byte c)
-        {
-            return static_cast<char>(c) == '\r' ||
-                static_cast<char>(c) == '\n';
-        }
-
-        constexpr auto isControlChar(std::byte c)
-        {
-            return static_cast<std::uint8_t>(c) <= 0x1F;
-        }
-
-        void skipWhitespaces(std::vector<std::byte>::const_iterator& iterator,
-                             std::vector<std::byte>::const_iterator end)
-        {
-            while (iterator != end)
-                if (isWhitespace(*iterator))
-                    ++iterator;
-                else
-                    break;
-        }
-
-        void skipLine(std::vector<std::byte>::const_iterator& iterator,
-                      std::vector<std::byte>::const_iterator end)
-        {
-            while (iterator != end)
-            {
-                if (isNewline(*iterator))
-                {
-                    ++iterator;
-                    break;
-                }
-
-                ++iterator;
-            }
-        }
-
-        std::string parseString(std::vector<std::byte>::const_iterator& iterator,
-                                std::vector<std::byte>::const_iterator end)
-        {
-            std::string result;
-
-            while (iterator != end && !isControlChar(*iterator) && !isWhitespace(*iterator))
-            {
-                result.push_back(static_cast<char>(*iterator));
-                ++iterator;
-            }
-
-            if (result.empty())
-                throw std::runtime_error("Invalid string");
-
-            return result;
-        }
-
-        float parseFloat(std::vector<std::byte>::const_iterator& iterator,
-                         std::vector<std::byte>::const_iterator end)
-        {
-            std::string value;
-            std::uint32_t length = 1;
-
-            if (iterator != end &&
-                static_cast<char>(*iterator) == '-')
-            {
-                value.push_back(static_cast<char>(*iterator));
-                ++length;
-                ++iterator;
-            }
-
-            while (iterator != end &&
-                   static_cast<char>(*iterator) >= '0' &&
-                   static_cast<char>(*iterator) <= '9')
-            {
-                value.push_back(static_cast<char>(*iterator));
-
-                ++iterator;
-            }
-
-            if (iterator != end &&
-                static_cast<char>(*iterator) == '.')
-            {
-                value.push_back(static_cast<char>(*iterator));
-                ++length;
-                ++iterator;
-
-                while (iterator != end &&
-                       static_cast<char>(*iterator) >= '0' &&
-                       static_cast<char>(*iterator) <= '9')
-                {
-                    value.push_back(static_cast<char>(*iterator));
-
-                    ++iterator;
-                }
-            }
-
-            // parse exponent
-            if (iterator != end &&
-                (static_cast<char>(*iterator) == 'e' ||
-                 static_cast<char>(*iterator) == 'E'))
-            {
-                value.push_back(static_cast<char>(*iterator));
-                if (++iterator == end)
-                    throw std::runtime_error("Invalid exponent");
-
-                if (static_cast<char>(*iterator) == '+' ||
-                    static_cast<char>(*iterator) == '-')
-                    value.push_back(static_cast<char>(*iterator++));
-
-                if (iterator == end ||
-                    static_cast<char>(*iterator) < '0' ||
-                    static_cast<char>(*iterator) > '9')
-                    throw std::runtime_error("Invalid exponent");
-
-                while (iterator != end &&
-                       static_cast<char>(*iterator) >= '0' &&
-                       static_cast<char>(*iterator) <= '9')
-                {
-                    value.push_back(static_cast<char>(*iterator));
-                    ++iterator;
-                }
-            }
-
-            if (value.length() < length) return false;
-
-            return std::stof(value);
-        }
-    }
-
     MtlLoader::MtlLoader(Cache& initCache):
         Loader(initCache, Type::material)
     {
@@ -162,24 +27,28 @@ namespace ouzel::assets
 
         std::uint32_t materialCount = 0;
 
-        auto iterator = data.cbegin();
+        const char* iterator = reinterpret_cast<const char*>(data.data());
+        const char* end = iterator + data.size();
 
-        while (iterator != data.end())
+        while (iterator != end)
         {
-            if (isNewline(*iterator))
+            if (text::isNewline(*iterator))
             {
                 // skip empty lines
                 ++iterator;
             }
-            else if (static_cast<char>(*iterator) == '#')
+            else if (*iterator == '#')
             {
                 // skip the comment
-                skipLine(iterator, data.end());
+                text::skipLine(iterator, end);
             }
             else
             {
-                skipWhitespaces(iterator, data.end());
-                const auto keyword = parseString(iterator, data.end());
+                text::skipWhitespaces(iterator, end);
+                if (iterator == end) break;
+                if (text::isNewline(*iterator)) continue;
+
+                const auto keyword = text::parseString(iterator, end);
 
                 if (keyword == "newmtl")
                 {
@@ -197,10 +66,10 @@ namespace ouzel::assets
                         bundle.setMaterial(materialName, std::move(material));
                     }
 
-                    skipWhitespaces(iterator, data.end());
-                    materialName = parseString(iterator, data.end());
+                    text::skipWhitespaces(iterator, end);
+                    materialName = text::parseString(iterator, end);
 
-                    skipLine(iterator, data.end());
+                    text::skipLine(iterator, end);
 
                     diffuseTexture.reset();
                     ambientTexture.reset();
@@ -210,10 +79,10 @@ namespace ouzel::assets
                 else if (keyword == "map_Ka") // ambient texture map
                 {
                     // TODO: parse options
-                    skipWhitespaces(iterator, data.end());
-                    const auto filename = parseString(iterator, data.end());
+                    text::skipWhitespaces(iterator, end);
+                    const std::string filename(text::parseString(iterator, end));
 
-                    skipLine(iterator, data.end());
+                    text::skipLine(iterator, end);
 
                     ambientTexture = cache.getTexture(filename);
 
@@ -226,10 +95,10 @@ namespace ouzel::assets
                 else if (keyword == "map_Kd") // diffuse texture map
                 {
                     // TODO: parse options
-                    skipWhitespaces(iterator, data.end());
-                    const auto filename = parseString(iterator, data.end());
+                    text::skipWhitespaces(iterator, end);
+                    const std::string filename(text::parseString(iterator, end));
 
-                    skipLine(iterator, data.end());
+                    text::skipLine(iterator, end);
 
                     diffuseTexture = cache.getTexture(filename);
 
@@ -240,37 +109,37 @@ namespace ouzel::assets
                     }
                 }
                 else if (keyword == "Ka") // ambient color
-                    skipLine(iterator, data.end());
+                    text::skipLine(iterator, end);
                 else if (keyword == "Kd") // diffuse color
                 {
-                    skipWhitespaces(iterator, data.end());
-                    const auto red = parseFloat(iterator, data.end());
-                    skipWhitespaces(iterator, data.end());
-                    const auto green = parseFloat(iterator, data.end());
-                    skipWhitespaces(iterator, data.end());
-                    const auto blue = parseFloat(iterator, data.end());
+                    text::skipWhitespaces(iterator, end);
+                    const auto red = text::parseFloat(iterator, end);
+                    text::skipWhitespaces(iterator, end);
+                    const auto green = text::parseFloat(iterator, end);
+                    text::skipWhitespaces(iterator, end);
+                    const auto blue = text::parseFloat(iterator, end);
 
-                    skipLine(iterator, data.end());
+                    text::skipLine(iterator, end);
 
                     diffuseColor = Color(red, green, blue, 1.0F);
                 }
                 else if (keyword == "Ks") // specular color
-                    skipLine(iterator, data.end());
+                    text::skipLine(iterator, end);
                 else if (keyword == "Ke") // emissive color
-                    skipLine(iterator, data.end());
+                    text::skipLine(iterator, end);
                 else if (keyword == "d") // opacity
                 {
-                    skipWhitespaces(iterator, data.end());
-                    opacity = parseFloat(iterator, data.end());
+                    text::skipWhitespaces(iterator, end);
+                    opacity = text::parseFloat(iterator, end);
 
-                    skipLine(iterator, data.end());
+                    text::skipLine(iterator, end);
                 }
                 else if (keyword == "Tr") // transparency
                 {
-                    skipWhitespaces(iterator, data.end());
-                    const auto transparency = parseFloat(iterator, data.end());
+                    text::skipWhitespaces(iterator, end);
+                    const auto transparency = text::parseFloat(iterator, end);
 
-                    skipLine(iterator, data.end());
+                    text::skipLine(iterator, end);
 
                     // d = 1 - Tr
                     opacity = 1.0F - transparency;
@@ -278,7 +147,7 @@ namespace ouzel::assets
                 else
                 {
                     // skip all unknown commands
-                    skipLine(iterator, data.end());
+                    text::skipLine(iterator, end);
                 }
 
                 if (!materialCount) ++materialCount; // if we got at least one attribute, we have an material
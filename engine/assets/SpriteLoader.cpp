@@ -1,6 +1,7 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
 #include <algorithm>
+#include <stdexcept>
 #include "SpriteLoader.hpp"
 #include "Bundle.hpp"
 #include "Cache.hpp"
@@ -19,8 +20,6 @@ namespace ouzel::assets
                                  const std::vector<std::byte>& data,
                                  bool mipmaps)
     {
-        scene::SpriteData spriteData;
-
         const json::Value d = json::parse(data);
 
         if (!d.hasMember("meta") ||
@@ -29,6 +28,63 @@ namespace ouzel::assets
 
         const json::Value& metaObject = d["meta"];
 
+        // frame table of an atlas written by the ouzel tool, every frame becomes a sprite that is named
+        // after the image that was packed, so that the loose image filenames resolve to the atlas regions
+        if (metaObject.hasMember("atlas") && metaObject["atlas"].as<bool>())
+        {
+            std::vector<std::shared_ptr<graphics::Texture>> pages;
+
+            for (const json::Value& pageObject : metaObject["pages"])
+            {
+                const auto pageFilename = pageObject.as<std::string>();
+                auto texture = cache.getTexture(pageFilename);
+                if (!texture)
+                {
+                    bundle.loadAsset(Type::image, pageFilename, pageFilename, mipmaps);
+                    texture = cache.getTexture(pageFilename);
+                }
+
+                if (!texture)
+                    return false;
+
+                pages.push_back(texture);
+            }
+
+            for (const json::Value& frameObject : d["frames"])
+            {
+                const auto page = frameObject["page"].as<std::size_t>();
+                if (page >= pages.size())
+                    throw std::runtime_error("Invalid atlas page");
+
+                const auto& texture = pages[page];
+                const Size2F textureSize(static_cast<float>(texture->getSize().v[0]),
+                                         static_cast<float>(texture->getSize().v[1]));
+
+                const auto filename = frameObject["filename"].as<std::string>();
+                const json::Value& frameRectangleObject = frameObject["frame"];
+                const json::Value& pivotObject = frameObject["pivot"];
+
+                const RectF frameRectangle(static_cast<float>(frameRectangleObject["x"].as<std::int32_t>()),
+                                           static_cast<float>(frameRectangleObject["y"].as<std::int32_t>()),
+                                           static_cast<float>(frameRectangleObject["w"].as<std::int32_t>()),
+                                           static_cast<float>(frameRectangleObject["h"].as<std::int32_t>()));
+
+                scene::SpriteData::Animation animation;
+                animation.frames.emplace_back(filename, textureSize, frameRectangle, false, frameRectangle.size,
+                                              Vector2F(), Vector2F(pivotObject["x"].as<float>(), pivotObject["y"].as<float>()));
+
+                scene::SpriteData spriteData;
+                spriteData.texture = texture;
+                spriteData.animations[""] = std::move(animation);
+
+                bundle.setSpriteData(filename, spriteData);
+            }
+
+            return true;
+        }
+
+        scene::SpriteData spriteData;
+
         const auto imageFilename = metaObject["image"].as<std::string>();
         spriteData.texture = cache.getTexture(imageFilename);
         if (!spriteData.texture)
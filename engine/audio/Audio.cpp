@@ -8,6 +8,7 @@
 #include "alsa/ALSAAudioDevice.hpp"
 #include "coreaudio/CAAudioDevice.hpp"
 #include "empty/EmptyAudioDevice.hpp"
+#include "offline/OfflineAudioDevice.hpp"
 #include "openal/OALAudioDevice.hpp"
 #include "opensl/OSLAudioDevice.hpp"
 #include "xaudio2/XA2AudioDevice.hpp"
@@ -40,6 +41,8 @@ namespace ouzel::audio
         }
         else if (driver == "empty")
             return Driver::empty;
+        else if (driver == "offline")
+            return Driver::offline;
         else if (driver == "openal")
             return Driver::openAL;
         else if (driver == "xaudio2")
@@ -63,6 +66,7 @@ namespace ouzel::audio
         if (availableDrivers.empty())
         {
             availableDrivers.insert(Driver::empty);
+            availableDrivers.insert(Driver::offline);
 
 #if OUZEL_COMPILE_OPENAL
             availableDrivers.insert(Driver::openAL);
@@ -97,36 +101,39 @@ namespace ouzel::audio
             {
 #if OUZEL_COMPILE_OPENAL
                 case Driver::openAL:
-                    logger.log(Log::Level::info) << "Using OpenAL audio driver";
+                    OUZEL_LOG(Log::Level::info) << "Using OpenAL audio driver";
                     return std::make_unique<openal::AudioDevice>(settings, dataGetter);
 #endif
 #if OUZEL_COMPILE_XAUDIO2
                 case Driver::xAudio2:
-                    logger.log(Log::Level::info) << "Using XAudio 2 audio driver";
+                    OUZEL_LOG(Log::Level::info) << "Using XAudio 2 audio driver";
                     return std::make_unique<xaudio2::AudioDevice>(settings, dataGetter);
 #endif
 #if OUZEL_COMPILE_OPENSL
                 case Driver::openSL:
-                    logger.log(Log::Level::info) << "Using OpenSL ES audio driver";
+                    OUZEL_LOG(Log::Level::info) << "Using OpenSL ES audio driver";
                     return std::make_unique<opensl::AudioDevice>(settings, dataGetter);
 #endif
 #if OUZEL_COMPILE_COREAUDIO
                 case Driver::coreAudio:
-                    logger.log(Log::Level::info) << "Using CoreAudio audio driver";
+                    OUZEL_LOG(Log::Level::info) << "Using CoreAudio audio driver";
                     return std::make_unique<coreaudio::AudioDevice>(settings, dataGetter);
 #endif
 #if OUZEL_COMPILE_ALSA
                 case Driver::alsa:
-                    logger.log(Log::Level::info) << "Using ALSA audio driver";
+                    OUZEL_LOG(Log::Level::info) << "Using ALSA audio driver";
                     return std::make_unique<alsa::AudioDevice>(settings, dataGetter);
 #endif
 #if OUZEL_COMPILE_WASAPI
                 case Driver::wasapi:
-                    logger.log(Log::Level::info) << "Using WASAPI audio driver";
+                    OUZEL_LOG(Log::Level::info) << "Using WASAPI audio driver";
                     return std::make_unique<wasapi::AudioDevice>(settings, dataGetter);
 #endif
+                case Driver::offline:
+                    OUZEL_LOG(Log::Level::info) << "Using offline audio driver";
+                    return std::make_unique<offline::AudioDevice>(settings, dataGetter);
                 default:
-                    logger.log(Log::Level::info) << "Not using audio driver";
+                    OUZEL_LOG(Log::Level::info) << "Not using audio driver";
                     return std::make_unique<empty::AudioDevice>(settings, dataGetter);
             }
         }
@@ -142,6 +149,11 @@ namespace ouzel::audio
         rootNode(*this) // mixer.getRootObjectId()
     {
         addCommand(std::make_unique<mixer::SetMasterBusCommand>(masterMix.getBusId()));
+
+        // the offline device mixes on the calling thread, so it submits the commands itself
+        if (device->getDriver() == Driver::offline)
+            static_cast<offline::AudioDevice*>(device.get())->setUpdateCallback([this]() { update(); });
+
         device->start();
     }
 
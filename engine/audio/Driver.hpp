@@ -8,6 +8,7 @@ namespace ouzel::audio
     enum class Driver
     {
         empty,
+        offline,
         openAL,
         xAudio2,
         openSL,
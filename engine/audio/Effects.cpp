@@ -136,36 +136,61 @@ namespace ouzel::audio
         {
         }
 
-        void process(std::uint32_t, std::uint32_t, std::uint32_t,
-                     std::vector<float>&) final
+        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
+                     std::vector<float>& samples) final
         {
+            // the bus is downmixed to mono and panned from the panner's position
+            buffer.resize(frames);
+            std::fill(buffer.begin(), buffer.end(), 0.0F);
+
+            const float channelGain = 1.0F / static_cast<float>(channels);
+
+            for (std::uint32_t channel = 0; channel < channels; ++channel)
+            {
+                const float* inputChannel = &samples[channel * frames];
+
+                for (std::uint32_t frame = 0; frame < frames; ++frame)
+                    buffer[frame] += inputChannel[frame] * channelGain;
+            }
+
+            std::fill(samples.begin(), samples.end(), 0.0F);
+            spatializer.process(frames, channels, sampleRate, listener, buffer.data(), samples);
+        }
+
+        void setListener(const mixer::ListenerState& newListener) final
+        {
+            listener = newListener;
         }
 
         void setPosition(const Vector3F& newPosition)
         {
-            position = newPosition;
+            spatializer.setPosition(newPosition);
+        }
+
+        void setDistanceModel(mixer::DistanceModel newDistanceModel)
+        {
+            spatializer.getParameters().distanceModel = newDistanceModel;
         }
 
         void setRolloffFactor(float newRolloffFactor)
         {
-            rolloffFactor = newRolloffFactor;
+            spatializer.getParameters().rolloffFactor = newRolloffFactor;
         }
 
         void setMinDistance(float newMinDistance)
         {
-            minDistance = newMinDistance;
+            spatializer.getParameters().minDistance = newMinDistance;
         }
 
         void setMaxDistance(float newMaxDistance)
         {
-            maxDistance = newMaxDistance;
+            spatializer.getParameters().maxDistance = newMaxDistance;
         }
 
     private:
-        Vector3F position;
-        float rolloffFactor = 1.0F;
-        float minDistance = 1.0F;
-        float maxDistance = FLT_MAX;
+        mixer::Spatializer spatializer;
+        mixer::ListenerState listener;
+        std::vector<float> buffer;
     };
 
     Panner::Panner(Audio& initAudio):
@@ -184,6 +209,16 @@ namespace ouzel::audio
         });
     }
 
+    void Panner::setDistanceModel(mixer::DistanceModel newDistanceModel)
+    {
+        distanceModel = newDistanceModel;
+
+        audio.updateProcessor(processorId, [newDistanceModel](mixer::Object* node) {
+            auto pannerProcessor = static_cast<PannerProcessor*>(node);
+            pannerProcessor->setDistanceModel(newDistanceModel);
+        });
+    }
+
     void Panner::setRolloffFactor(float newRolloffFactor)
     {
         rolloffFactor = newRolloffFactor;
@@ -6,6 +6,7 @@
 #include <cfloat>
 #include <utility>
 #include "Effect.hpp"
+#include "mixer/Spatializer.hpp"
 #include "../math/Vector.hpp"
 #include "../scene/Component.hpp"
 
@@ -66,6 +67,9 @@ namespace ouzel::audio
         auto& getPosition() const noexcept { return position; }
         void setPosition(const Vector3F& newPosition);
 
+        auto getDistanceModel() const noexcept { return distanceModel; }
+        void setDistanceModel(mixer::DistanceModel newDistanceModel);
+
         auto getRolloffFactor() const noexcept { return rolloffFactor; }
         void setRolloffFactor(float newRolloffFactor);
 
@@ -79,6 +83,7 @@ namespace ouzel::audio
         void updateTransform() final;
 
         Vector3F position;
+        mixer::DistanceModel distanceModel = mixer::DistanceModel::inverse;
         float rolloffFactor = 1.0F;
         float minDistance = 1.0F;
         float maxDistance = FLT_MAX;
@@ -5,6 +5,7 @@
 #include "AudioDevice.hpp"
 #include "Submix.hpp"
 #include "../scene/Actor.hpp"
+#include "../math/Matrix.hpp"
 #include "../math/MathUtils.hpp"
 
 namespace ouzel::audio
@@ -16,18 +17,93 @@ namespace ouzel::audio
 
     Listener::~Listener()
     {
-        if (mix) mix->removeListener(this);
+        if (mix) removeFromMix();
     }
 
     void Listener::setMix(Mix* newMix)
     {
-        if (mix) mix->removeListener(this);
+        if (mix) removeFromMix();
+
         mix = newMix;
-        if (mix) mix->addListener(this);
+
+        if (mix)
+        {
+            mix->addListener(this);
+            updateListener();
+        }
+    }
+
+    void Listener::setPosition(const Vector3F& newPosition)
+    {
+        position = newPosition;
+        updateListener();
+    }
+
+    void Listener::setVelocity(const Vector3F& newVelocity)
+    {
+        velocity = newVelocity;
+        updateListener();
+    }
+
+    void Listener::setRotation(const QuaternionF& newRotation)
+    {
+        rotation = newRotation;
+
+        Matrix4F rotationMatrix;
+        rotationMatrix.setRotation(rotation);
+        rotationMatrix.transformVector(Vector3F{1.0F, 0.0F, 0.0F}, right);
+        rotationMatrix.transformVector(Vector3F{0.0F, 1.0F, 0.0F}, up);
+        rotationMatrix.transformVector(Vector3F{0.0F, 0.0F, 1.0F}, forward);
+
+        updateListener();
+    }
+
+    void Listener::setHeadphones(bool newHeadphones)
+    {
+        headphones = newHeadphones;
+        updateListener();
     }
 
     void Listener::updateTransform()
     {
-        transformDirty = true;
+        // the listener follows the actor's world transform, the scale is removed from the axes
+        const auto& transform = actor->getTransform();
+        transform.transformPoint(Vector3F{}, position);
+        transform.transformVector(Vector3F{1.0F, 0.0F, 0.0F}, right);
+        transform.transformVector(Vector3F{0.0F, 1.0F, 0.0F}, up);
+        transform.transformVector(Vector3F{0.0F, 0.0F, 1.0F}, forward);
+        right.normalize();
+        up.normalize();
+        forward.normalize();
+
+        updateListener();
+    }
+
+    void Listener::removeFromMix()
+    {
+        Mix* oldMix = mix;
+        oldMix->removeListener(this);
+
+        // the bus has a single listener, so it is cleared only when the last listener leaves,
+        // otherwise one of the remaining listeners takes over
+        if (oldMix->listeners.empty())
+            audio.addCommand(std::make_unique<mixer::RemoveBusListenerCommand>(oldMix->getBusId()));
+        else
+            oldMix->listeners.back()->updateListener();
+    }
+
+    void Listener::updateListener()
+    {
+        if (!mix) return;
+
+        mixer::ListenerState state;
+        state.position = position;
+        state.velocity = velocity;
+        state.right = right;
+        state.up = up;
+        state.forward = forward;
+        state.headphones = headphones;
+
+        audio.addCommand(std::make_unique<mixer::SetBusListenerCommand>(mix->getBusId(), state));
     }
 }
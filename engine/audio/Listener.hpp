@@ -29,24 +29,33 @@ namespace ouzel::audio
         void setMix(Mix* newMix);
 
         auto& getPosition() const noexcept { return position; }
-        void setPosition(const Vector3F& newPosition) { position = newPosition; }
+        void setPosition(const Vector3F& newPosition);
 
         auto& getVelocity() const noexcept { return velocity; }
-        void setVelocity(const Vector3F& newVelocity) { velocity = newVelocity; }
+        void setVelocity(const Vector3F& newVelocity);
 
         auto& getRotation() const noexcept { return rotation; }
-        void setRotation(const QuaternionF& newRotation) { rotation = newRotation; }
+        void setRotation(const QuaternionF& newRotation);
+
+        // Renders the spatialized sounds binaurally for stereo output
+        auto getHeadphones() const noexcept { return headphones; }
+        void setHeadphones(bool newHeadphones);
 
     private:
         void updateTransform() final;
+        void removeFromMix();
+        void updateListener();
 
         Audio& audio;
 
         Mix* mix = nullptr;
         Vector3F position;
         Vector3F velocity;
-        QuaternionF rotation;
-        bool transformDirty = true;
+        QuaternionF rotation = QuaternionF::identity();
+        Vector3F right{1.0F, 0.0F, 0.0F};
+        Vector3F up{0.0F, 1.0F, 0.0F};
+        Vector3F forward{0.0F, 0.0F, 1.0F};
+        bool headphones = false;
     };
 }
 
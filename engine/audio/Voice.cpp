@@ -139,15 +139,31 @@ namespace ouzel::audio
             audio.deleteObject(streamId);
     }
 
+    void Voice::setPosition(const Vector3F& newPosition)
+    {
+        position = newPosition;
+
+        if (streamId)
+            audio.addCommand(std::make_unique<mixer::SetStreamSpatializationCommand>(streamId, position, velocity));
+    }
+
+    void Voice::setVelocity(const Vector3F& newVelocity)
+    {
+        velocity = newVelocity;
+
+        if (streamId)
+            audio.addCommand(std::make_unique<mixer::SetStreamSpatializationCommand>(streamId, position, velocity));
+    }
+
     void Voice::play()
     {
         audio.addCommand(std::make_unique<mixer::PlayStreamCommand>(streamId));
 
         playing = true;
 
-        auto startEvent = std::make_unique<SoundEvent>();
-        startEvent->type = Event::Type::soundStart;
-        startEvent->voice = this;
+        SoundEvent startEvent;
+        startEvent.type = Event::Type::soundStart;
+        startEvent.voice = this;
         engine->getEventDispatcher().postEvent(std::move(startEvent));
 
         // TODO: send PlayCommand
@@ -174,9 +190,9 @@ namespace ouzel::audio
     // executed on audio thread
     /*void Voice::onReset()
     {
-        auto event = std::make_unique<SoundEvent>();
-        event->type = Event::Type::soundReset;
-        event->voice = this;
+        SoundEvent event;
+        event.type = Event::Type::soundReset;
+        event.voice = this;
         engine->getEventDispatcher().postEvent(std::move(event));
     }
 
@@ -185,9 +201,9 @@ namespace ouzel::audio
     {
         playing = false;
 
-        auto event = std::make_unique<SoundEvent>();
-        event->type = Event::Type::soundFinish;
-        event->voice = this;
+        SoundEvent event;
+        event.type = Event::Type::soundFinish;
+        event.voice = this;
         engine->getEventDispatcher().postEvent(std::move(event));
     }*/
 
@@ -40,11 +40,12 @@ namespace ouzel::audio
 
         auto& getSound() const noexcept { return sound; }
 
+        // Setting the position or velocity makes the voice spatialized by the listener of its mix
         auto& getPosition() const noexcept { return position; }
-        void setPosition(const Vector3F& newPosition) { position = newPosition; }
+        void setPosition(const Vector3F& newPosition);
 
         auto& getVelocity() const noexcept { return velocity; }
-        void setVelocity(const Vector3F& newVelocity) { velocity = newVelocity; }
+        void setVelocity(const Vector3F& newVelocity);
 
         void play();
         void pause();
@@ -56,7 +57,7 @@ namespace ouzel::audio
 
     private:
         Audio& audio;
-        std::size_t streamId;
+        std::size_t streamId = 0;
 
         const Sound* sound = nullptr;
         Vector3F position;
@@ -23,7 +23,7 @@ namespace ouzel::audio::alsa
         if (const auto result = snd_pcm_open(&playbackHandle, device, SND_PCM_STREAM_PLAYBACK, 0); result < 0)
             throw std::system_error(-result, std::system_category(), "Failed to connect to audio interface");
 
-        logger.log(Log::Level::info) << "Using " << snd_pcm_name(playbackHandle) << " for audio";
+        OUZEL_LOG(Log::Level::info) << "Using " << snd_pcm_name(playbackHandle) << " for audio";
 
         if (const auto result = snd_pcm_hw_params_malloc(&hwParams); result < 0)
             throw std::system_error(-result, std::system_category(), "Failed to allocate memory for hardware parameters");
@@ -137,7 +137,7 @@ namespace ouzel::audio::alsa
                 {
                     if (frames == -EPIPE)
                     {
-                        logger.log(Log::Level::warning) << "Buffer underrun occurred";
+                        OUZEL_LOG(Log::Level::warning) << "Buffer underrun occurred";
 
                         if (const auto result = snd_pcm_prepare(playbackHandle); result < 0)
                             throw std::system_error(-result, std::system_category(), "Failed to prepare audio interface");
@@ -150,7 +150,7 @@ namespace ouzel::audio::alsa
 
                 if (static_cast<snd_pcm_uframes_t>(frames) > periods * periodSize)
                 {
-                    logger.log(Log::Level::warning) << "Buffer size exceeded, error: " << frames;
+                    OUZEL_LOG(Log::Level::warning) << "Buffer size exceeded, error: " << frames;
                     snd_pcm_reset(playbackHandle);
                     continue;
                 }
@@ -164,7 +164,7 @@ namespace ouzel::audio::alsa
                 {
                     if (result == -EPIPE)
                     {
-                        logger.log(Log::Level::warning) << "Buffer underrun occurred";
+                        OUZEL_LOG(Log::Level::warning) << "Buffer underrun occurred";
 
                         if (const auto prepareResult = snd_pcm_prepare(playbackHandle); prepareResult < 0)
                             throw std::system_error(-prepareResult, std::system_category(), "Failed to prepare audio interface");
@@ -175,7 +175,7 @@ namespace ouzel::audio::alsa
             }
             catch (const std::exception& e)
             {
-                logger.log(Log::Level::error) << e.what();
+                OUZEL_LOG(Log::Level::error) << e.what();
             }
         }
     }
@@ -83,7 +83,7 @@ namespace ouzel::audio::coreaudio
             }
             catch (const std::exception& e)
             {
-                ouzel::logger.log(ouzel::Log::Level::error) << e.what();
+                OUZEL_LOG(ouzel::Log::Level::error) << e.what();
                 return -1;
             }
 
@@ -223,7 +223,7 @@ namespace ouzel::audio::coreaudio
             }
             CFRelease(tempStringRef);
 
-            logger.log(Log::Level::info) << "Using " << name << " for audio";
+            OUZEL_LOG(Log::Level::info) << "Using " << name << " for audio";
         }
 #endif
 
@@ -290,7 +290,7 @@ namespace ouzel::audio::coreaudio
                                                      &streamDescription,
                                                      sizeof(streamDescription)); result != noErr)
         {
-            logger.log(Log::Level::warning) << "Failed to set CoreAudio unit stream format to float, error: " << result;
+            OUZEL_LOG(Log::Level::warning) << "Failed to set CoreAudio unit stream format to float, error: " << result;
 
             streamDescription.mFormatFlags = kLinearPCMFormatFlagIsPacked | kAudioFormatFlagIsSignedInteger;
             streamDescription.mBitsPerChannel = sizeof(std::int16_t) * 8;
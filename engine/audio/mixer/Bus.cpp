@@ -1,6 +1,7 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
 #include <algorithm>
+#include <cmath>
 #include "Bus.hpp"
 #include "Data.hpp"
 #include "Processor.hpp"
@@ -224,16 +225,29 @@ namespace ouzel::audio::mixer
             samples = sourceSamples;
     }
 
+    void Bus::setListener(const ListenerState& newListener)
+    {
+        listener = newListener;
+        hasListener = true;
+    }
+
+    void Bus::removeListener()
+    {
+        hasListener = false;
+    }
+
     void Bus::getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
-                         const Vector3F& listenerPosition, const QuaternionF& listenerRotation,
+                         const ListenerState& outputListener,
                          std::vector<float>& samples)
     {
+        const ListenerState& currentListener = hasListener ? listener : outputListener;
+
         samples.resize(frames * channels);
         std::fill(samples.begin(), samples.end(), 0.0F);
 
         for (Bus* bus : inputBuses)
         {
-            bus->getSamples(frames, channels, sampleRate, listenerPosition, listenerRotation, buffer);
+            bus->getSamples(frames, channels, sampleRate, currentListener, buffer);
 
             for (std::size_t s = 0; s < samples.size(); ++s)
                 samples[s] += buffer[s];
@@ -246,7 +260,16 @@ namespace ouzel::audio::mixer
                 const std::uint32_t sourceSampleRate = stream->getData().getSampleRate();
                 const std::uint32_t sourceChannels = stream->getData().getChannels();
 
-                if (sourceSampleRate != sampleRate)
+                // doppler shift is applied by the resampler
+                const float pitch = stream->spatialized ? stream->spatializer.getPitch(currentListener) : 1.0F;
+
+                if (pitch != 1.0F)
+                {
+                    const auto sourceFrames = std::max(static_cast<std::uint32_t>(std::ceil(static_cast<float>(frames) * static_cast<float>(sourceSampleRate) * pitch / static_cast<float>(sampleRate))), 2U);
+                    stream->getSamples(sourceFrames, resampleBuffer);
+                    resample(sourceChannels, sourceFrames, resampleBuffer, frames, mixBuffer);
+                }
+                else if (sourceSampleRate != sampleRate)
                 {
                     std::uint32_t sourceFrames = (frames * sourceSampleRate + sampleRate - 1) / sampleRate; // round up
                     stream->getSamples(sourceFrames, resampleBuffer);
@@ -255,6 +278,18 @@ namespace ouzel::audio::mixer
                 else
                     stream->getSamples(frames, mixBuffer);
 
+                if (stream->spatialized)
+                {
+                    // spatialized streams are downmixed to mono and panned by the listener
+                    if (sourceChannels != 1)
+                        convert(frames, sourceChannels, mixBuffer, 1, buffer);
+                    else
+                        buffer = mixBuffer;
+
+                    stream->spatializer.process(frames, channels, sampleRate, currentListener, buffer.data(), samples);
+                    continue;
+                }
+
                 if (sourceChannels != channels)
                     convert(frames, sourceChannels, mixBuffer, channels, buffer);
                 else
@@ -267,7 +302,10 @@ namespace ouzel::audio::mixer
 
         for (Processor* processor : processors)
             if (processor->isEnabled())
+            {
+                processor->setListener(currentListener);
                 processor->process(frames, channels, sampleRate, samples);
+            }
     }
 
     void Bus::addProcessor(Processor* processor)
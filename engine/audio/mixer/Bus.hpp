@@ -5,6 +5,7 @@
 
 #include <vector>
 #include "Object.hpp"
+#include "Spatializer.hpp"
 
 namespace ouzel::audio::mixer
 {
@@ -26,8 +27,12 @@ namespace ouzel::audio::mixer
 
         void setOutput(Bus* newOutput);
 
+        // Listener overrides the listener passed by the output bus for all of the bus's inputs
+        void setListener(const ListenerState& newListener);
+        void removeListener();
+
         void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
-                        const Vector3F& listenerPosition, const QuaternionF& listenerRotation,
+                        const ListenerState& outputListener,
                         std::vector<float>& samples);
 
         void addProcessor(Processor* processor);
@@ -44,6 +49,9 @@ namespace ouzel::audio::mixer
         std::vector<Stream*> inputStreams;
         std::vector<Processor*> processors;
 
+        ListenerState listener;
+        bool hasListener = false;
+
         std::vector<float> resampleBuffer;
         std::vector<float> mixBuffer;
         std::vector<float> buffer;
@@ -6,9 +6,11 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <queue>
 
 #include "Processor.hpp"
 #include "Source.hpp"
+#include "Spatializer.hpp"
 #include "Stream.hpp"
 #include "Data.hpp"
 
@@ -36,6 +38,9 @@ namespace ouzel::audio::mixer
             playStream,
             stopStream,
             setStreamOutput,
+            setStreamSpatialization,
+            setBusListener,
+            removeBusListener,
             initData,
             initProcessor,
             updateProcessor
@@ -247,6 +252,48 @@ namespace ouzel::audio::mixer
         const ObjectId busId;
     };
 
+    class SetStreamSpatializationCommand final: public Command
+    {
+    public:
+        SetStreamSpatializationCommand(ObjectId initStreamId,
+                                       const Vector3F& initPosition,
+                                       const Vector3F& initVelocity) noexcept:
+            Command(Command::Type::setStreamSpatialization),
+            streamId(initStreamId),
+            position(initPosition),
+            velocity(initVelocity)
+        {}
+
+        const ObjectId streamId;
+        const Vector3F position;
+        const Vector3F velocity;
+    };
+
+    class SetBusListenerCommand final: public Command
+    {
+    public:
+        SetBusListenerCommand(ObjectId initBusId,
+                              const ListenerState& initListener) noexcept:
+            Command(Command::Type::setBusListener),
+            busId(initBusId),
+            listener(initListener)
+        {}
+
+        const ObjectId busId;
+        const ListenerState listener;
+    };
+
+    class RemoveBusListenerCommand final: public Command
+    {
+    public:
+        explicit constexpr RemoveBusListenerCommand(ObjectId initBusId) noexcept:
+            Command(Command::Type::removeBusListener),
+            busId(initBusId)
+        {}
+
+        const ObjectId busId;
+    };
+
     class InitDataCommand final: public Command
     {
     public:
@@ -172,6 +172,31 @@ namespace ouzel::audio::mixer
                         stream->setOutput(setStreamOutputCommand->busId ? static_cast<Bus*>(objects[setStreamOutputCommand->busId - 1].get()) : nullptr);
                         break;
                     }
+                    case Command::Type::setStreamSpatialization:
+                    {
+                        auto setStreamSpatializationCommand = static_cast<const SetStreamSpatializationCommand*>(command.get());
+
+                        auto stream = static_cast<Stream*>(objects[setStreamSpatializationCommand->streamId - 1].get());
+                        stream->setSpatialization(setStreamSpatializationCommand->position,
+                                                  setStreamSpatializationCommand->velocity);
+                        break;
+                    }
+                    case Command::Type::setBusListener:
+                    {
+                        auto setBusListenerCommand = static_cast<const SetBusListenerCommand*>(command.get());
+
+                        auto bus = static_cast<Bus*>(objects[setBusListenerCommand->busId - 1].get());
+                        bus->setListener(setBusListenerCommand->listener);
+                        break;
+                    }
+                    case Command::Type::removeBusListener:
+                    {
+                        auto removeBusListenerCommand = static_cast<const RemoveBusListenerCommand*>(command.get());
+
+                        auto bus = static_cast<Bus*>(objects[removeBusListenerCommand->busId - 1].get());
+                        bus->removeListener();
+                        break;
+                    }
                     case Command::Type::initData:
                     {
                         auto initDataCommand = static_cast<InitDataCommand*>(command.get());
@@ -215,10 +240,10 @@ namespace ouzel::audio::mixer
 
         if (masterBus)
         {
-            Vector3F listenerPosition;
-            QuaternionF listenerRotation;
+            // used when no bus has a listener
+            const ListenerState defaultListener;
 
-            masterBus->getSamples(frames, channelCount, sampleRate, listenerPosition, listenerRotation, samples);
+            masterBus->getSamples(frames, channelCount, sampleRate, defaultListener, samples);
         }
 
         for (float& sample : samples)
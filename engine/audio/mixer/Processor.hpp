@@ -27,6 +27,9 @@ namespace ouzel::audio::mixer
         virtual void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
                              std::vector<float>& samples) = 0;
 
+        // Called before every process with the listener of the bus
+        virtual void setListener(const ListenerState&) {}
+
         auto isEnabled() const noexcept { return enabled; }
         void setEnabled(bool newEnabled) { enabled = newEnabled; }
 
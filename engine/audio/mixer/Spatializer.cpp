@@ -0,0 +1,374 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#if defined(__SSE__)
+#  include <xmmintrin.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include "Spatializer.hpp"
+#include "../../core/Engine.hpp"
+#include "../../math/Constants.hpp"
+#include "../../math/MathUtils.hpp"
+
+namespace ouzel::audio::mixer
+{
+    namespace
+    {
+        constexpr float speedOfSound = 343.3F; // m/s
+        constexpr float headRadius = 0.0875F; // m
+        constexpr float minPitch = 0.5F;
+        constexpr float maxPitch = 2.0F;
+        constexpr float lateralThreshold = 0.01F; // radians
+
+        struct Speaker final
+        {
+            std::uint32_t channel;
+            float azimuth; // degrees, clockwise from the front
+        };
+
+        // speakers are sorted by the azimuth, the LFE channel is not panned to
+        constexpr std::array<Speaker, 4> quadSpeakers{{
+            {2, -135.0F}, // SL
+            {0, -45.0F}, // L
+            {1, 45.0F}, // R
+            {3, 135.0F} // SR
+        }};
+
+        constexpr std::array<Speaker, 5> surroundSpeakers{{
+            {4, -110.0F}, // SL
+            {0, -30.0F}, // L
+            {2, 0.0F}, // C
+            {1, 30.0F}, // R
+            {5, 110.0F} // SR
+        }};
+
+        template <std::size_t N>
+        void getVbapGains(const std::array<Speaker, N>& speakers, float azimuth, float* gains) noexcept
+        {
+            const float x = std::sin(azimuth);
+            const float z = std::cos(azimuth);
+
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                const Speaker& first = speakers[i];
+                const Speaker& second = speakers[(i + 1) % N];
+
+                // solve the source direction as a combination of the speaker pair's directions
+                const float x1 = std::sin(degToRad(first.azimuth));
+                const float z1 = std::cos(degToRad(first.azimuth));
+                const float x2 = std::sin(degToRad(second.azimuth));
+                const float z2 = std::cos(degToRad(second.azimuth));
+
+                const float determinant = x1 * z2 - x2 * z1;
+                const float gain1 = (x * z2 - x2 * z) / determinant;
+                const float gain2 = (x1 * z - x * z1) / determinant;
+
+                if (gain1 >= -0.0001F && gain2 >= -0.0001F)
+                {
+                    // normalize to constant power
+                    const float power = std::sqrt(gain1 * gain1 + gain2 * gain2);
+                    gains[first.channel] = std::max(gain1, 0.0F) / power;
+                    gains[second.channel] = std::max(gain2, 0.0F) / power;
+                    return;
+                }
+            }
+        }
+    }
+
+    float getDistanceGain(const Spatializer::Parameters& parameters, float distance) noexcept
+    {
+        const float clampedDistance = std::clamp(distance, parameters.minDistance, parameters.maxDistance);
+
+        switch (parameters.distanceModel)
+        {
+            case DistanceModel::inverse:
+                return parameters.minDistance / (parameters.minDistance + parameters.rolloffFactor * (clampedDistance - parameters.minDistance));
+            case DistanceModel::linear:
+                if (parameters.maxDistance <= parameters.minDistance) return 1.0F;
+                return std::max(1.0F - parameters.rolloffFactor * (clampedDistance - parameters.minDistance) /
+                                (parameters.maxDistance - parameters.minDistance), 0.0F);
+            case DistanceModel::exponential:
+                return std::pow(clampedDistance / parameters.minDistance, -parameters.rolloffFactor);
+            case DistanceModel::none:
+            default:
+                return 1.0F;
+        }
+    }
+
+    void getPanningGains(std::uint32_t channels, const Vector3F& direction, float* gains) noexcept
+    {
+        std::fill(gains, gains + channels, 0.0F);
+
+        const float horizontalLength = std::sqrt(direction.v[0] * direction.v[0] + direction.v[2] * direction.v[2]);
+        const float length = direction.length();
+
+        // a source at the listener or straight above or below it is heard from all of the speakers
+        const float spread = (length > std::numeric_limits<float>::min()) ? 1.0F - horizontalLength / length : 1.0F;
+
+        if (spread < 1.0F)
+        {
+            const float azimuth = std::atan2(direction.v[0], direction.v[2]);
+
+            switch (channels)
+            {
+                case 1:
+                    gains[0] = 1.0F;
+                    break;
+                case 2:
+                {
+                    // equal-power panning, the sources behind the listener are mirrored to the front
+                    const float pan = (direction.v[0] / horizontalLength + 1.0F) * pi<float> / 4.0F;
+                    gains[0] = std::cos(pan);
+                    gains[1] = std::sin(pan);
+                    break;
+                }
+                case 4:
+                    getVbapGains(quadSpeakers, azimuth, gains);
+                    break;
+                case 6:
+                    getVbapGains(surroundSpeakers, azimuth, gains);
+                    break;
+                default:
+                    for (std::uint32_t channel = 0; channel < channels; ++channel)
+                        gains[channel] = 1.0F;
+                    return;
+            }
+        }
+
+        if (spread > 0.0F)
+        {
+            const std::uint32_t speakerCount = (channels == 6) ? 5 : channels;
+            const float spreadGain = spread / std::sqrt(static_cast<float>(speakerCount));
+            float power = 0.0F;
+
+            for (std::uint32_t channel = 0; channel < channels; ++channel)
+                if (channels != 6 || channel != 3) // skip LFE
+                {
+                    gains[channel] = gains[channel] * (1.0F - spread) + spreadGain;
+                    power += gains[channel] * gains[channel];
+                }
+
+            const float normalization = 1.0F / std::sqrt(power);
+            for (std::uint32_t channel = 0; channel < channels; ++channel)
+                gains[channel] *= normalization;
+        }
+    }
+
+    void mixWithGain(const float* source, std::uint32_t frames, float startGain, float endGain,
+                     float* destination) noexcept
+    {
+        if (frames == 0) return;
+
+        const float step = (endGain - startGain) / static_cast<float>(frames);
+        std::uint32_t frame = 0;
+
+#if defined(__SSE__)
+        if (core::isSimdAvailable)
+        {
+            __m128 gain = _mm_setr_ps(startGain, startGain + step, startGain + 2.0F * step, startGain + 3.0F * step);
+            const __m128 gainStep = _mm_set1_ps(4.0F * step);
+
+            for (; frame + 4 <= frames; frame += 4)
+            {
+                const __m128 result = _mm_add_ps(_mm_loadu_ps(destination + frame),
+                                                 _mm_mul_ps(_mm_loadu_ps(source + frame), gain));
+                _mm_storeu_ps(destination + frame, result);
+                gain = _mm_add_ps(gain, gainStep);
+            }
+        }
+#endif
+
+        for (; frame < frames; ++frame)
+            destination[frame] += source[frame] * (startGain + step * static_cast<float>(frame));
+    }
+
+    void Hrtf::generate(std::uint32_t sampleRate, float lateral, Response& left, Response& right)
+    {
+        Response nearResponse{};
+        Response farResponse{};
+
+        const float sinLateral = std::sin(std::abs(lateral));
+
+        // Woodworth's interaural time difference for a spherical head
+        const float delay = std::min(headRadius / speedOfSound * (std::abs(lateral) + sinLateral) * static_cast<float>(sampleRate),
+                                     static_cast<float>(length - 2));
+
+        // the head shadow is a one-pole low pass on the far ear
+        const float pole = 0.7F * sinLateral;
+        const float farGain = 1.0F - 0.3F * sinLateral;
+
+        nearResponse[0] = 1.0F;
+
+        const auto delayFrames = static_cast<std::size_t>(delay);
+        const float fraction = delay - static_cast<float>(delayFrames);
+        float tap = (1.0F - pole) * farGain;
+
+        for (std::size_t i = delayFrames; i < length - 1; ++i)
+        {
+            farResponse[i] += tap * (1.0F - fraction);
+            farResponse[i + 1] += tap * fraction;
+            tap *= pole;
+        }
+
+        // the responses are stored reversed, so that the convolution is a dot product with the history
+        std::reverse(nearResponse.begin(), nearResponse.end());
+        std::reverse(farResponse.begin(), farResponse.end());
+
+        if (lateral >= 0.0F)
+        {
+            left = farResponse;
+            right = nearResponse;
+        }
+        else
+        {
+            left = nearResponse;
+            right = farResponse;
+        }
+    }
+
+    void Hrtf::convolve(const Response& response, std::uint32_t frames, float* output) const
+    {
+        const float* input = history.data();
+
+#if defined(__SSE__)
+        if (core::isSimdAvailable)
+        {
+            alignas(16) float sums[4];
+
+            for (std::uint32_t frame = 0; frame < frames; ++frame)
+            {
+                __m128 sum = _mm_setzero_ps();
+                for (std::size_t i = 0; i < length; i += 4)
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(input + frame + i),
+                                                     _mm_load_ps(response.data() + i)));
+
+                _mm_store_ps(sums, sum);
+                output[frame] = sums[0] + sums[1] + sums[2] + sums[3];
+            }
+
+            return;
+        }
+#endif
+
+        for (std::uint32_t frame = 0; frame < frames; ++frame)
+        {
+            float sum = 0.0F;
+            for (std::size_t i = 0; i < length; ++i)
+                sum += input[frame + i] * response[i];
+            output[frame] = sum;
+        }
+    }
+
+    void Hrtf::process(std::uint32_t frames, std::uint32_t sampleRate, const Vector3F& direction,
+                       const float* source, float* left, float* right)
+    {
+        const float directionLength = direction.length();
+        const float lateral = (directionLength > std::numeric_limits<float>::min()) ?
+            std::asin(std::clamp(direction.v[0] / directionLength, -1.0F, 1.0F)) : 0.0F;
+
+        // the history holds the last length - 1 frames of the previous block followed by the current block
+        history.resize(length - 1 + frames);
+        std::copy(source, source + frames, history.begin() + length - 1);
+
+        if (sampleRate != currentSampleRate)
+        {
+            generate(sampleRate, lateral, currentLeft, currentRight);
+            currentSampleRate = sampleRate;
+            currentLateral = lateral;
+        }
+
+        convolve(currentLeft, frames, left);
+        convolve(currentRight, frames, right);
+
+        if (std::abs(lateral - currentLateral) > lateralThreshold)
+        {
+            generate(sampleRate, lateral, nextLeft, nextRight);
+
+            fadeBuffer.resize(frames * 2);
+            convolve(nextLeft, frames, fadeBuffer.data());
+            convolve(nextRight, frames, fadeBuffer.data() + frames);
+
+            const float step = 1.0F / static_cast<float>(frames);
+            for (std::uint32_t frame = 0; frame < frames; ++frame)
+            {
+                const float t = step * static_cast<float>(frame);
+                left[frame] = lerp(left[frame], fadeBuffer[frame], t);
+                right[frame] = lerp(right[frame], fadeBuffer[frames + frame], t);
+            }
+
+            currentLeft = nextLeft;
+            currentRight = nextRight;
+            currentLateral = lateral;
+        }
+
+        std::copy(history.end() - (length - 1), history.end(), history.begin());
+    }
+
+    float Spatializer::getPitch(const ListenerState& listener) const noexcept
+    {
+        Vector3F direction = position - listener.position;
+        if (direction.lengthSquared() <= std::numeric_limits<float>::min() ||
+            parameters.dopplerFactor == 0.0F)
+            return 1.0F;
+
+        direction.normalize();
+
+        // positive speeds move towards the other party, they are clamped below the speed of sound
+        const float maxSpeed = speedOfSound * 0.99F;
+        const float listenerSpeed = std::clamp(listener.velocity.dot(direction) * parameters.dopplerFactor, -maxSpeed, maxSpeed);
+        const float sourceSpeed = std::clamp(-velocity.dot(direction) * parameters.dopplerFactor, -maxSpeed, maxSpeed);
+
+        return std::clamp((speedOfSound + listenerSpeed) / (speedOfSound - sourceSpeed), minPitch, maxPitch);
+    }
+
+    void Spatializer::process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
+                              const ListenerState& listener, const float* source,
+                              std::vector<float>& samples)
+    {
+        channels = std::min(channels, maxChannels);
+
+        const Vector3F offset = position - listener.position;
+        const Vector3F direction{
+            offset.dot(listener.right),
+            offset.dot(listener.up),
+            offset.dot(listener.forward)
+        };
+
+        const float distanceGain = getDistanceGain(parameters, offset.length());
+        std::array<float, maxChannels> targetGains{};
+
+        if (listener.headphones && channels == 2)
+        {
+            binauralBuffer.resize(frames * 2);
+            hrtf.process(frames, sampleRate, direction,
+                         source, binauralBuffer.data(), binauralBuffer.data() + frames);
+
+            targetGains[0] = distanceGain;
+            targetGains[1] = distanceGain;
+        }
+        else
+        {
+            getPanningGains(channels, direction, targetGains.data());
+
+            for (std::uint32_t channel = 0; channel < channels; ++channel)
+                targetGains[channel] *= distanceGain;
+        }
+
+        // the first block starts at the target gains
+        if (!started)
+        {
+            gains = targetGains;
+            started = true;
+        }
+
+        const bool binaural = listener.headphones && channels == 2;
+
+        for (std::uint32_t channel = 0; channel < channels; ++channel)
+            if (gains[channel] != 0.0F || targetGains[channel] != 0.0F)
+                mixWithGain(binaural ? &binauralBuffer[channel * frames] : source,
+                            frames, gains[channel], targetGains[channel],
+                            &samples[channel * frames]);
+
+        gains = targetGains;
+    }
+}
@@ -0,0 +1,115 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_SPATIALIZER_HPP
+#define OUZEL_AUDIO_MIXER_SPATIALIZER_HPP
+
+#include <array>
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+#include "../../math/Vector.hpp"
+
+namespace ouzel::audio::mixer
+{
+    enum class DistanceModel
+    {
+        none,
+        inverse,
+        linear,
+        exponential
+    };
+
+    // The listener as seen by the mixer, the axes are the listener's orientation in world space
+    struct ListenerState final
+    {
+        Vector3F position;
+        Vector3F velocity;
+        Vector3F right{1.0F, 0.0F, 0.0F};
+        Vector3F up{0.0F, 1.0F, 0.0F};
+        Vector3F forward{0.0F, 0.0F, 1.0F};
+        bool headphones = false;
+    };
+
+    // Binaural rendering of a mono signal for headphones
+    // The head related impulse responses are generated from a spherical head model (interaural time delay
+    // and head shadow) and are cross-faded when the direction changes
+    class Hrtf final
+    {
+    public:
+        static constexpr std::size_t length = 64;
+
+        void process(std::uint32_t frames, std::uint32_t sampleRate, const Vector3F& direction,
+                     const float* source, float* left, float* right);
+
+    private:
+        using Response = std::array<float, length>;
+
+        static void generate(std::uint32_t sampleRate, float lateral, Response& left, Response& right);
+        void convolve(const Response& response, std::uint32_t frames, float* output) const;
+
+        std::vector<float> history;
+        alignas(16) Response currentLeft{};
+        alignas(16) Response currentRight{};
+        alignas(16) Response nextLeft{};
+        alignas(16) Response nextRight{};
+        std::vector<float> fadeBuffer;
+        float currentLateral = 0.0F;
+        std::uint32_t currentSampleRate = 0;
+    };
+
+    // Spatializes a mono signal into the output channel layout once per block, the channel gains
+    // are interpolated over the block to avoid zipper noise
+    class Spatializer final
+    {
+    public:
+        static constexpr std::uint32_t maxChannels = 6;
+
+        struct Parameters final
+        {
+            DistanceModel distanceModel = DistanceModel::inverse;
+            float rolloffFactor = 1.0F;
+            float minDistance = 1.0F;
+            float maxDistance = FLT_MAX;
+            float dopplerFactor = 1.0F;
+        };
+
+        auto& getPosition() const noexcept { return position; }
+        void setPosition(const Vector3F& newPosition) { position = newPosition; }
+
+        auto& getVelocity() const noexcept { return velocity; }
+        void setVelocity(const Vector3F& newVelocity) { velocity = newVelocity; }
+
+        auto& getParameters() const noexcept { return parameters; }
+        auto& getParameters() noexcept { return parameters; }
+
+        // Returns the pitch change caused by the doppler effect
+        float getPitch(const ListenerState& listener) const noexcept;
+
+        // Pans the mono source and adds it to the samples
+        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
+                     const ListenerState& listener, const float* source,
+                     std::vector<float>& samples);
+
+    private:
+        Vector3F position;
+        Vector3F velocity;
+        Parameters parameters;
+
+        std::array<float, maxChannels> gains{};
+        bool started = false;
+        Hrtf hrtf;
+        std::vector<float> binauralBuffer;
+    };
+
+    float getDistanceGain(const Spatializer::Parameters& parameters, float distance) noexcept;
+
+    // Equal-power panning for stereo and vector base amplitude panning for the 4 and 6 channel layouts,
+    // the direction is in the listener's space
+    void getPanningGains(std::uint32_t channels, const Vector3F& direction, float* gains) noexcept;
+
+    // Adds the source multiplied by a gain that changes linearly from startGain to endGain
+    void mixWithGain(const float* source, std::uint32_t frames, float startGain, float endGain,
+                     float* destination) noexcept;
+}
+
+#endif // OUZEL_AUDIO_MIXER_SPATIALIZER_HPP
@@ -6,6 +6,7 @@
 #include "Object.hpp"
 #include "Bus.hpp"
 #include "Data.hpp"
+#include "Spatializer.hpp"
 
 namespace ouzel::audio::mixer
 {
@@ -50,6 +51,16 @@ namespace ouzel::audio::mixer
             if (shouldReset) reset();
         }
 
+        auto isSpatialized() const noexcept { return spatialized; }
+        auto& getSpatializer() noexcept { return spatializer; }
+
+        void setSpatialization(const Vector3F& position, const Vector3F& velocity)
+        {
+            spatializer.setPosition(position);
+            spatializer.setVelocity(velocity);
+            spatialized = true;
+        }
+
         virtual void reset() = 0;
 
         virtual void getSamples(std::uint32_t frames, std::vector<float>& samples) = 0;
@@ -58,6 +69,8 @@ namespace ouzel::audio::mixer
         Data& data;
         Bus* output = nullptr;
         bool playing = false;
+        bool spatialized = false;
+        Spatializer spatializer;
     };
 }
 
@@ -0,0 +1,171 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include "OfflineAudioDevice.hpp"
+
+namespace ouzel::audio::offline
+{
+    namespace
+    {
+        constexpr std::uint16_t WAVE_FORMAT_PCM = 1;
+        constexpr std::uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+        constexpr std::size_t waveHeaderSize = 44;
+
+        void writeUInt16(std::ofstream& file, std::uint16_t value)
+        {
+            const char bytes[2] = {
+                static_cast<char>(value & 0xFF),
+                static_cast<char>((value >> 8) & 0xFF)
+            };
+            file.write(bytes, sizeof(bytes));
+        }
+
+        void writeUInt32(std::ofstream& file, std::uint32_t value)
+        {
+            const char bytes[4] = {
+                static_cast<char>(value & 0xFF),
+                static_cast<char>((value >> 8) & 0xFF),
+                static_cast<char>((value >> 16) & 0xFF),
+                static_cast<char>((value >> 24) & 0xFF)
+            };
+            file.write(bytes, sizeof(bytes));
+        }
+    }
+
+    AudioDevice::AudioDevice(const Settings& settings,
+                             const std::function<void(std::uint32_t frames,
+                                                      std::uint32_t channels,
+                                                      std::uint32_t sampleRate,
+                                                      std::vector<float>& samples)>& initDataGetter):
+        audio::AudioDevice(Driver::offline, settings, initDataGetter)
+    {
+        sampleFormat = settings.sampleFormat;
+    }
+
+    AudioDevice::~AudioDevice()
+    {
+        if (file.is_open())
+        {
+            try
+            {
+                closeOutputFile();
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+
+    void AudioDevice::openOutputFile(const std::string& filename)
+    {
+        if (file.is_open()) closeOutputFile();
+
+        file.open(filename, std::ios::binary | std::ios::trunc);
+        if (!file)
+            throw std::runtime_error("Failed to open file " + filename);
+
+        const std::uint16_t bitsPerSample = (sampleFormat == SampleFormat::float32) ? 32 : 16;
+        const auto blockAlign = static_cast<std::uint16_t>(channels * bitsPerSample / 8);
+
+        // the sizes are written when the file is closed
+        file.write("RIFF", 4);
+        writeUInt32(file, 0);
+        file.write("WAVE", 4);
+
+        file.write("fmt ", 4);
+        writeUInt32(file, 16);
+        writeUInt16(file, (sampleFormat == SampleFormat::float32) ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM);
+        writeUInt16(file, static_cast<std::uint16_t>(channels));
+        writeUInt32(file, sampleRate);
+        writeUInt32(file, sampleRate * blockAlign);
+        writeUInt16(file, blockAlign);
+        writeUInt16(file, bitsPerSample);
+
+        file.write("data", 4);
+        writeUInt32(file, 0);
+
+        fileDataSize = 0;
+    }
+
+    void AudioDevice::closeOutputFile()
+    {
+        if (!file.is_open()) return;
+
+        file.seekp(4);
+        writeUInt32(file, static_cast<std::uint32_t>(waveHeaderSize - 8 + fileDataSize));
+        file.seekp(waveHeaderSize - 4);
+        writeUInt32(file, fileDataSize);
+
+        const bool failed = !file;
+        file.close();
+
+        if (failed)
+            throw std::runtime_error("Failed to write wave file");
+    }
+
+    void AudioDevice::schedule(double time, const std::function<void()>& callback)
+    {
+        const auto cueFrame = static_cast<std::uint64_t>(std::llround(std::max(time, 0.0) * sampleRate));
+        cues.emplace(cueFrame, callback);
+    }
+
+    AudioDevice::Statistics AudioDevice::render(double duration)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+        const auto startFrame = frame;
+        const auto endFrame = frame + static_cast<std::uint64_t>(std::llround(std::max(duration, 0.0) * sampleRate));
+
+        if (updateCallback) updateCallback();
+
+        while (frame < endFrame)
+        {
+            bool cueCalled = false;
+
+            while (!cues.empty() && cues.begin()->first <= frame)
+            {
+                const auto callback = std::move(cues.begin()->second);
+                cues.erase(cues.begin());
+                callback();
+                cueCalled = true;
+            }
+
+            if (cueCalled && updateCallback) updateCallback();
+
+            // the block is split at the next cue, so that it starts at the exact frame
+            auto blockEndFrame = std::min(frame + bufferSize, endFrame);
+            if (!cues.empty()) blockEndFrame = std::min(blockEndFrame, cues.begin()->first);
+
+            const auto frames = static_cast<std::uint32_t>(blockEndFrame - frame);
+            getData(frames, buffer);
+            write(buffer);
+
+            frame = blockEndFrame;
+        }
+
+        const std::chrono::duration<double> renderDuration = std::chrono::steady_clock::now() - startTime;
+
+        Statistics statistics;
+        statistics.frames = frame - startFrame;
+        statistics.audioTime = static_cast<double>(statistics.frames) / sampleRate;
+        statistics.renderTime = renderDuration.count();
+        statistics.realTimeFactor = (statistics.renderTime > 0.0) ? statistics.audioTime / statistics.renderTime : 0.0;
+        return statistics;
+    }
+
+    void AudioDevice::write(const std::vector<std::uint8_t>& data)
+    {
+        if (file.is_open())
+        {
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!file)
+                throw std::runtime_error("Failed to write wave file");
+
+            fileDataSize += static_cast<std::uint32_t>(data.size());
+        }
+        else
+            renderedData.insert(renderedData.end(), data.begin(), data.end());
+    }
+}
@@ -0,0 +1,76 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_OFFLINEAUDIODEVICE_HPP
+#define OUZEL_AUDIO_OFFLINEAUDIODEVICE_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "../AudioDevice.hpp"
+
+namespace ouzel::audio::offline
+{
+    // Mixes as fast as the CPU allows instead of following a hardware clock
+    // Nothing is mixed until render is called, the rendered data goes to memory or to a wave file
+    class AudioDevice final: public audio::AudioDevice
+    {
+    public:
+        struct Statistics final
+        {
+            std::uint64_t frames = 0;
+            double audioTime = 0.0; // seconds
+            double renderTime = 0.0; // seconds
+            double realTimeFactor = 0.0; // audio time divided by render time
+        };
+
+        AudioDevice(const Settings& settings,
+                    const std::function<void(std::uint32_t frames,
+                                             std::uint32_t channels,
+                                             std::uint32_t sampleRate,
+                                             std::vector<float>& samples)>& initDataGetter);
+        ~AudioDevice() override;
+
+        void start() final {}
+        void stop() final {}
+
+        // Called before mixing to submit the commands added since the last mix
+        void setUpdateCallback(const std::function<void()>& newUpdateCallback)
+        {
+            updateCallback = newUpdateCallback;
+        }
+
+        // Writes the rendered data to the wave file instead of the memory
+        void openOutputFile(const std::string& filename);
+        void closeOutputFile();
+
+        // Interleaved data in the device's sample format
+        auto& getRenderedData() const noexcept { return renderedData; }
+        void clearRenderedData() { renderedData.clear(); }
+
+        // The clock only advances by the rendered frames, so the results are deterministic
+        auto getFrame() const noexcept { return frame; }
+        auto getTime() const noexcept { return static_cast<double>(frame) / sampleRate; }
+
+        // Calls the callback before mixing the frame at the given time, cues in the past are called by the next render
+        void schedule(double time, const std::function<void()>& callback);
+
+        Statistics render(double duration);
+
+    private:
+        void write(const std::vector<std::uint8_t>& data);
+
+        std::function<void()> updateCallback;
+        std::multimap<std::uint64_t, std::function<void()>> cues;
+        std::uint64_t frame = 0;
+
+        std::vector<std::uint8_t> buffer;
+        std::vector<std::uint8_t> renderedData;
+        std::ofstream file;
+        std::uint32_t fileDataSize = 0;
+    };
+}
+
+#endif // OUZEL_AUDIO_OFFLINEAUDIODEVICE_HPP
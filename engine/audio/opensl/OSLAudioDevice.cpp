@@ -32,7 +32,7 @@ namespace ouzel::audio::opensl
             }
             catch (const std::exception& e)
             {
-                logger.log(Log::Level::error) << e.what();
+                OUZEL_LOG(Log::Level::error) << e.what();
             }
         }
 
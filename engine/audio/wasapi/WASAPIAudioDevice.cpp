@@ -152,7 +152,7 @@ namespace ouzel::audio::wasapi
             {
                 auto name = std::make_unique<char[]>(bufferSize);
                 if (WideCharToMultiByte(CP_UTF8, 0, nameVariant.pwszVal, -1, name.get(), bufferSize, nullptr, nullptr) != 0)
-                    ouzel::logger.log(ouzel::Log::Level::info) << "Using " << name.get() << " for audio";
+                    OUZEL_LOG(ouzel::Log::Level::info) << "Using " << name.get() << " for audio";
             }
         }
 
@@ -321,7 +321,7 @@ namespace ouzel::audio::wasapi
             }
             catch (const std::exception& e)
             {
-                logger.log(Log::Level::error) << e.what();
+                OUZEL_LOG(Log::Level::error) << e.what();
             }
         }
     }
@@ -22,6 +22,8 @@
 #    include "opengl/ColorVSGLES3.h"
 #    include "opengl/TexturePSGLES3.h"
 #    include "opengl/TextureVSGLES3.h"
+#    include "opengl/SkinnedTextureVSGLES3.h"
+#    include "opengl/InstancedTextureVSGLES3.h"
 #  else
 #    include "opengl/ColorPSGL2.h"
 #    include "opengl/ColorVSGL2.h"
@@ -31,10 +33,14 @@
 #    include "opengl/ColorVSGL3.h"
 #    include "opengl/TexturePSGL3.h"
 #    include "opengl/TextureVSGL3.h"
+#    include "opengl/SkinnedTextureVSGL3.h"
+#    include "opengl/InstancedTextureVSGL3.h"
 #    include "opengl/ColorPSGL4.h"
 #    include "opengl/ColorVSGL4.h"
 #    include "opengl/TexturePSGL4.h"
 #    include "opengl/TextureVSGL4.h"
+#    include "opengl/SkinnedTextureVSGL4.h"
+#    include "opengl/InstancedTextureVSGL4.h"
 #  endif
 #endif
 
@@ -99,6 +105,9 @@ namespace ouzel::core
             bool highDpi = true; // should high DPI resolution be used
             audio::Driver audioDriver;
             audio::Settings audioSettings;
+            bool programCache = true;
+            bool asyncLog = false;
+            Logger::OverflowPolicy logOverflowPolicy = Logger::OverflowPolicy::count;
         };
 
         Settings parseSettings(const ini::Data& defaultSettings,
@@ -160,6 +169,11 @@ namespace ouzel::core
             const auto& debugRendererValue = userEngineSection.getValue("debugRenderer", defaultEngineSection.getValue("debugRenderer"));
             if (!debugRendererValue.empty()) settings.graphicsSettings.debugRenderer = (debugRendererValue == "true" || debugRendererValue == "1" || debugRendererValue == "yes");
 
+            settings.graphicsSettings.captureFile = userEngineSection.getValue("graphicsCapture", defaultEngineSection.getValue("graphicsCapture"));
+
+            const auto& programCacheValue = userEngineSection.getValue("programCache", defaultEngineSection.getValue("programCache"));
+            if (!programCacheValue.empty()) settings.programCache = (programCacheValue == "true" || programCacheValue == "1" || programCacheValue == "yes");
+
             const auto& highDpiValue = userEngineSection.getValue("highDpi", defaultEngineSection.getValue("highDpi"));
             if (!highDpiValue.empty()) settings.highDpi = (highDpiValue == "true" || highDpiValue == "1" || highDpiValue == "yes");
 
@@ -171,12 +185,26 @@ namespace ouzel::core
 
             settings.audioSettings.audioDevice = userEngineSection.getValue("audioDevice", defaultEngineSection.getValue("audioDevice"));
 
+            const auto& asyncLogValue = userEngineSection.getValue("asyncLog", defaultEngineSection.getValue("asyncLog"));
+            if (!asyncLogValue.empty()) settings.asyncLog = (asyncLogValue == "true" || asyncLogValue == "1" || asyncLogValue == "yes");
+
+            const auto& logOverflowValue = userEngineSection.getValue("logOverflow", defaultEngineSection.getValue("logOverflow"));
+            if (logOverflowValue == "drop")
+                settings.logOverflowPolicy = Logger::OverflowPolicy::drop;
+            else if (logOverflowValue == "block")
+                settings.logOverflowPolicy = Logger::OverflowPolicy::block;
+            else if (logOverflowValue == "count" || logOverflowValue.empty())
+                settings.logOverflowPolicy = Logger::OverflowPolicy::count;
+            else
+                throw std::runtime_error("Invalid log overflow policy");
+
             return settings;
         }
     }
 
     Engine::Engine(const std::vector<std::string>& initArgs):
         fileSystem(*this),
+        localization(fileSystem),
         assetBundle(cache, fileSystem),
         args{initArgs}
     {
@@ -187,8 +215,8 @@ namespace ouzel::core
     {
         if (active)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::engineStop;
+            SystemEvent event;
+            event.type = Event::Type::engineStop;
             eventDispatcher.postEvent(std::move(event));
         }
 
@@ -203,6 +231,8 @@ namespace ouzel::core
             lock.unlock();
             updateThread.join();
         }
+
+        logger.stopAsync();
 #endif
     }
 
@@ -211,8 +241,23 @@ namespace ouzel::core
         thread::setCurrentThreadName("Main");
 
         const auto settingsPath = fileSystem.getStorageDirectory() / "settings.ini";
-        const auto settings = parseSettings(fileSystem.resourceFileExists("settings.ini") ? ini::parse(fileSystem.readFile("settings.ini")) : ini::Data{},
-                                            fileSystem.fileExists(settingsPath) ? ini::parse(fileSystem.readFile(settingsPath)) : ini::Data{});
+        auto settings = parseSettings(fileSystem.resourceFileExists("settings.ini") ? ini::parse(fileSystem.readFile("settings.ini")) : ini::Data{},
+                                      fileSystem.fileExists(settingsPath) ? ini::parse(fileSystem.readFile(settingsPath)) : ini::Data{});
+
+#if !defined(__EMSCRIPTEN__)
+        if (settings.programCache)
+        {
+            const auto programCacheDirectory = fileSystem.getStorageDirectory() / "ProgramCache";
+            if (!fileSystem.directoryExists(programCacheDirectory))
+                storage::FileSystem::createDirectory(programCacheDirectory);
+
+            settings.graphicsSettings.programCacheDirectory = std::string(programCacheDirectory);
+        }
+#endif
+
+#if !defined(__EMSCRIPTEN__)
+        if (settings.asyncLog) logger.startAsync(settings.logOverflowPolicy);
+#endif
 
         const Window::Flags windowFlags =
             (settings.resizable ? Window::Flags::resizable : Window::Flags::none) |
@@ -440,6 +485,157 @@ namespace ouzel::core
                 }
 
                 assetBundle.setShader(shaderColor, std::move(colorShader));
+
+                // the bone palette doesn't fit into the uniforms that OpenGL ES 2 guarantees,
+                // so skinned meshes are skinned on the CPU on OpenGL 2
+                std::unique_ptr<graphics::Shader> skinnedTextureShader;
+
+                switch (graphics->getDevice()->getAPIMajorVersion())
+                {
+#  if OUZEL_OPENGLES
+                    case 3:
+                        skinnedTextureShader = std::make_unique<graphics::Shader>(*graphics,
+                                                                                  std::vector<std::uint8_t>(std::begin(TexturePSGLES3_glsl),
+                                                                                                            std::end(TexturePSGLES3_glsl)),
+                                                                                  std::vector<std::uint8_t>(std::begin(SkinnedTextureVSGLES3_glsl),
+                                                                                                            std::end(SkinnedTextureVSGLES3_glsl)),
+                                                                                  std::set<graphics::Vertex::Attribute::Usage>{
+                                                                                      graphics::Vertex::Attribute::Usage::position,
+                                                                                      graphics::Vertex::Attribute::Usage::color,
+                                                                                      graphics::Vertex::Attribute::Usage::textureCoordinates0,
+                                                                                      graphics::Vertex::Attribute::Usage::blendIndices,
+                                                                                      graphics::Vertex::Attribute::Usage::blendWeight
+                                                                                  },
+                                                                                  std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                      {"color", graphics::DataType::float32Vector4}
+                                                                                  },
+                                                                                  std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                      {"modelViewProj", graphics::DataType::float32Matrix4},
+                                                                                      {"bones", graphics::DataType::float32Matrix4}
+                                                                                  });
+                        break;
+#  else
+                    case 3:
+                        skinnedTextureShader = std::make_unique<graphics::Shader>(*graphics,
+                                                                                  std::vector<std::uint8_t>(std::begin(TexturePSGL3_glsl),
+                                                                                                            std::end(TexturePSGL3_glsl)),
+                                                                                  std::vector<std::uint8_t>(std::begin(SkinnedTextureVSGL3_glsl),
+                                                                                                            std::end(SkinnedTextureVSGL3_glsl)),
+                                                                                  std::set<graphics::Vertex::Attribute::Usage>{
+                                                                                      graphics::Vertex::Attribute::Usage::position,
+                                                                                      graphics::Vertex::Attribute::Usage::color,
+                                                                                      graphics::Vertex::Attribute::Usage::textureCoordinates0,
+                                                                                      graphics::Vertex::Attribute::Usage::blendIndices,
+                                                                                      graphics::Vertex::Attribute::Usage::blendWeight
+                                                                                  },
+                                                                                  std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                      {"color", graphics::DataType::float32Vector4}
+                                                                                  },
+                                                                                  std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                      {"modelViewProj", graphics::DataType::float32Matrix4},
+                                                                                      {"bones", graphics::DataType::float32Matrix4}
+                                                                                  });
+                        break;
+                    case 4:
+                        skinnedTextureShader = std::make_unique<graphics::Shader>(*graphics,
+                                                                                  std::vector<std::uint8_t>(std::begin(TexturePSGL4_glsl),
+                                                                                                            std::end(TexturePSGL4_glsl)),
+                                                                                  std::vector<std::uint8_t>(std::begin(SkinnedTextureVSGL4_glsl),
+                                                                                                            std::end(SkinnedTextureVSGL4_glsl)),
+                                                                                  std::set<graphics::Vertex::Attribute::Usage>{
+                                                                                      graphics::Vertex::Attribute::Usage::position,
+                                                                                      graphics::Vertex::Attribute::Usage::color,
+                                                                                      graphics::Vertex::Attribute::Usage::textureCoordinates0,
+                                                                                      graphics::Vertex::Attribute::Usage::blendIndices,
+                                                                                      graphics::Vertex::Attribute::Usage::blendWeight
+                                                                                  },
+                                                                                  std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                      {"color", graphics::DataType::float32Vector4}
+                                                                                  },
+                                                                                  std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                      {"modelViewProj", graphics::DataType::float32Matrix4},
+                                                                                      {"bones", graphics::DataType::float32Matrix4}
+                                                                                  });
+                        break;
+#  endif
+                    default:
+                        break;
+                }
+
+                if (skinnedTextureShader)
+                    assetBundle.setShader(shaderSkinnedTexture, std::move(skinnedTextureShader));
+
+                // the per-instance matrices are attributes, which OpenGL 2 shaders can't declare
+                std::unique_ptr<graphics::Shader> instancedTextureShader;
+
+                if (graphics->getDevice()->isInstancingSupported())
+                {
+                    switch (graphics->getDevice()->getAPIMajorVersion())
+                    {
+#  if OUZEL_OPENGLES
+                        case 3:
+                            instancedTextureShader = std::make_unique<graphics::Shader>(*graphics,
+                                                                                        std::vector<std::uint8_t>(std::begin(TexturePSGLES3_glsl),
+                                                                                                                  std::end(TexturePSGLES3_glsl)),
+                                                                                        std::vector<std::uint8_t>(std::begin(InstancedTextureVSGLES3_glsl),
+                                                                                                                  std::end(InstancedTextureVSGLES3_glsl)),
+                                                                                        std::set<graphics::Vertex::Attribute::Usage>{
+                                                                                            graphics::Vertex::Attribute::Usage::position,
+                                                                                            graphics::Vertex::Attribute::Usage::color,
+                                                                                            graphics::Vertex::Attribute::Usage::textureCoordinates0,
+                                                                                            graphics::Vertex::Attribute::Usage::instanceTransform,
+                                                                                            graphics::Vertex::Attribute::Usage::instanceColor
+                                                                                        },
+                                                                                        std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                            {"color", graphics::DataType::float32Vector4}
+                                                                                        },
+                                                                                        std::vector<std::pair<std::string, graphics::DataType>>{});
+                            break;
+#  else
+                        case 3:
+                            instancedTextureShader = std::make_unique<graphics::Shader>(*graphics,
+                                                                                        std::vector<std::uint8_t>(std::begin(TexturePSGL3_glsl),
+                                                                                                                  std::end(TexturePSGL3_glsl)),
+                                                                                        std::vector<std::uint8_t>(std::begin(InstancedTextureVSGL3_glsl),
+                                                                                                                  std::end(InstancedTextureVSGL3_glsl)),
+                                                                                        std::set<graphics::Vertex::Attribute::Usage>{
+                                                                                            graphics::Vertex::Attribute::Usage::position,
+                                                                                            graphics::Vertex::Attribute::Usage::color,
+                                                                                            graphics::Vertex::Attribute::Usage::textureCoordinates0,
+                                                                                            graphics::Vertex::Attribute::Usage::instanceTransform,
+                                                                                            graphics::Vertex::Attribute::Usage::instanceColor
+                                                                                        },
+                                                                                        std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                            {"color", graphics::DataType::float32Vector4}
+                                                                                        },
+                                                                                        std::vector<std::pair<std::string, graphics::DataType>>{});
+                            break;
+                        case 4:
+                            instancedTextureShader = std::make_unique<graphics::Shader>(*graphics,
+                                                                                        std::vector<std::uint8_t>(std::begin(TexturePSGL4_glsl),
+                                                                                                                  std::end(TexturePSGL4_glsl)),
+                                                                                        std::vector<std::uint8_t>(std::begin(InstancedTextureVSGL4_glsl),
+                                                                                                                  std::end(InstancedTextureVSGL4_glsl)),
+                                                                                        std::set<graphics::Vertex::Attribute::Usage>{
+                                                                                            graphics::Vertex::Attribute::Usage::position,
+                                                                                            graphics::Vertex::Attribute::Usage::color,
+                                                                                            graphics::Vertex::Attribute::Usage::textureCoordinates0,
+                                                                                            graphics::Vertex::Attribute::Usage::instanceTransform,
+                                                                                            graphics::Vertex::Attribute::Usage::instanceColor
+                                                                                        },
+                                                                                        std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                            {"color", graphics::DataType::float32Vector4}
+                                                                                        },
+                                                                                        std::vector<std::pair<std::string, graphics::DataType>>{});
+                            break;
+#  endif
+                        default:
+                                break;
+                    }
+                }
+
+                if (instancedTextureShader)
+                    assetBundle.setShader(shaderInstancedTexture, std::move(instancedTextureShader));
                 break;
             }
 #endif
@@ -636,8 +832,8 @@ namespace ouzel::core
     {
         if (!active)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::engineStart;
+            SystemEvent event;
+            event.type = Event::Type::engineStart;
             eventDispatcher.postEvent(std::move(event));
 
             active = true;
@@ -655,8 +851,8 @@ namespace ouzel::core
     {
         if (active && !paused)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::enginePause;
+            SystemEvent event;
+            event.type = Event::Type::enginePause;
             eventDispatcher.postEvent(std::move(event));
 
             paused = true;
@@ -667,8 +863,8 @@ namespace ouzel::core
     {
         if (active && paused)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::engineResume;
+            SystemEvent event;
+            event.type = Event::Type::engineResume;
             eventDispatcher.postEvent(std::move(event));
 
             paused = false;
@@ -685,8 +881,8 @@ namespace ouzel::core
 
         if (active)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::engineStop;
+            SystemEvent event;
+            event.type = Event::Type::engineStop;
             eventDispatcher.postEvent(std::move(event));
 
             active = false;
@@ -707,29 +903,36 @@ namespace ouzel::core
     void Engine::update()
     {
         eventDispatcher.dispatchEvents();
+        jobSystem.runMainThreadJobs();
 
-        const auto currentTime = std::chrono::steady_clock::now();
-        auto diff = currentTime - previousUpdateTime;
+        const auto frame = frameScheduler.beginFrame(std::chrono::steady_clock::now());
+        const auto fixedStep = frameScheduler.getMode() == FrameScheduler::Mode::fixedStep;
+        auto& transformInterpolator = sceneManager.getTransformInterpolator();
 
-        if (diff > std::chrono::milliseconds(1)) // at least one millisecond has passed
+        for (std::uint32_t i = 0; i < frame.updateCount; ++i)
         {
-            if (diff > std::chrono::seconds(1000 / 20)) diff = std::chrono::milliseconds(1000 / 20); // limit the update rate to a minimum 20 FPS
-
-            previousUpdateTime = currentTime;
-            const float delta = static_cast<float>(std::chrono::duration_cast<std::chrono::microseconds>(diff).count()) / 1000000.0F;
+            if (fixedStep) transformInterpolator.storePreviousTransforms();
 
-            auto updateEvent = std::make_unique<UpdateEvent>();
-            updateEvent->type = Event::Type::update;
-            updateEvent->delta = delta;
-            eventDispatcher.dispatchEvent(std::move(updateEvent));
+            UpdateEvent updateEvent;
+            updateEvent.type = Event::Type::update;
+            updateEvent.delta = frame.delta;
+            eventDispatcher.dispatchEvent(updateEvent);
         }
 
+        transformInterpolator.setInterpolation(fixedStep ? frame.interpolation : 1.0F);
+
         inputManager->update();
         window->update();
         audio->update();
 
         if (graphics->getRefillQueue())
+        {
+            // the input events queued during the update are handled right before drawing instead of in the next frame
+            if (frameScheduler.isInputLateLatched())
+                eventDispatcher.dispatchEvents();
+
             sceneManager.draw();
+        }
 
         if (oneUpdatePerFrame) graphics->waitForNextFrame();
     }
@@ -757,6 +960,9 @@ namespace ouzel::core
                     std::unique_lock lock(updateMutex);
                     while (active && paused)
                         updateCondition.wait(lock);
+
+                    // the paused time is not simulated
+                    frameScheduler.reset();
                 }
             }
 
@@ -765,7 +971,7 @@ namespace ouzel::core
         }
         catch (const std::exception& e)
         {
-            logger.log(Log::Level::error) << e.what();
+            OUZEL_LOG(Log::Level::error) << e.what();
             exit();
         }
     }
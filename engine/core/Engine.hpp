@@ -11,6 +11,7 @@
 #include <thread>
 #include <vector>
 #include "Application.hpp"
+#include "FrameScheduler.hpp"
 #include "Timer.hpp"
 #include "Window.hpp"
 #include "../graphics/Graphics.hpp"
@@ -27,6 +28,7 @@
 #include "../network/Network.hpp"
 #include "../formats/Ini.hpp"
 #include "../utils/Log.hpp"
+#include "../thread/JobSystem.hpp"
 #include "../thread/Thread.hpp"
 
 namespace ouzel::core
@@ -66,6 +68,9 @@ namespace ouzel::core
         auto& getEventDispatcher() { return eventDispatcher; }
         auto& getEventDispatcher() const { return eventDispatcher; }
 
+        auto& getJobSystem() { return jobSystem; }
+        auto& getJobSystem() const { return jobSystem; }
+
         auto& getCache() { return cache; }
         auto& getCache() const { return cache; }
 
@@ -105,6 +110,9 @@ namespace ouzel::core
         bool isOneUpdatePerFrame() const noexcept { return oneUpdatePerFrame; }
         void setOneUpdatePerFrame(bool value) { oneUpdatePerFrame = value; }
 
+        auto& getFrameScheduler() noexcept { return frameScheduler; }
+        auto& getFrameScheduler() const noexcept { return frameScheduler; }
+
     protected:
         class Command final
         {
@@ -126,6 +134,7 @@ namespace ouzel::core
 
         storage::FileSystem fileSystem;
         EventDispatcher eventDispatcher;
+        thread::JobSystem jobSystem;
         std::unique_ptr<Window> window;
         std::unique_ptr<graphics::Graphics> graphics;
         std::unique_ptr<audio::Audio> audio;
@@ -141,7 +150,7 @@ namespace ouzel::core
         std::mutex updateMutex;
         std::condition_variable updateCondition;
 #endif
-        std::chrono::steady_clock::time_point previousUpdateTime;
+        FrameScheduler frameScheduler;
 
         std::atomic_bool active{false};
         std::atomic_bool paused{false};
@@ -156,16 +165,18 @@ namespace ouzel::core
 
 namespace ouzel
 {
-    const std::string shaderTexture = "shaderTexture";
-    const std::string shaderColor = "shaderColor";
-
-    const std::string blendNoBlend = "blendNoBlend";
-    const std::string blendAdd = "blendAdd";
-    const std::string blendMultiply = "blendMultiply";
-    const std::string blendAlpha = "blendAlpha";
-    const std::string blendScreen = "blendScreen";
-
-    const std::string textureWhitePixel = "textureWhitePixel";
+    constexpr assets::ShaderHandle shaderTexture{"shaderTexture"};
+    constexpr assets::ShaderHandle shaderColor{"shaderColor"};
+    constexpr assets::ShaderHandle shaderSkinnedTexture{"shaderSkinnedTexture"};
+    constexpr assets::ShaderHandle shaderInstancedTexture{"shaderInstancedTexture"};
+
+    constexpr assets::BlendStateHandle blendNoBlend{"blendNoBlend"};
+    constexpr assets::BlendStateHandle blendAdd{"blendAdd"};
+    constexpr assets::BlendStateHandle blendMultiply{"blendMultiply"};
+    constexpr assets::BlendStateHandle blendAlpha{"blendAlpha"};
+    constexpr assets::BlendStateHandle blendScreen{"blendScreen"};
+
+    constexpr assets::TextureHandle textureWhitePixel{"textureWhitePixel"};
 
     std::unique_ptr<Application> main(const std::vector<std::string>& args);
     inline core::Engine* engine = nullptr;
@@ -0,0 +1,148 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <stdexcept>
+#include "FrameScheduler.hpp"
+
+namespace ouzel::core
+{
+    void FrameScheduler::Histogram::add(std::chrono::steady_clock::duration frameTime) noexcept
+    {
+        const auto time = std::chrono::duration_cast<std::chrono::microseconds>(frameTime);
+        const auto bucket = std::min(static_cast<std::size_t>(time.count() / 1000), bucketCount - 1);
+
+        ++buckets[bucket];
+        total += time;
+        minimum = count ? std::min(minimum, time) : time;
+        maximum = std::max(maximum, time);
+        ++count;
+    }
+
+    void FrameScheduler::Histogram::reset() noexcept
+    {
+        buckets.fill(0);
+        count = 0;
+        total = std::chrono::microseconds{0};
+        minimum = std::chrono::microseconds{0};
+        maximum = std::chrono::microseconds{0};
+    }
+
+    std::chrono::microseconds FrameScheduler::Histogram::getAverage() const noexcept
+    {
+        return count ? total / static_cast<std::int64_t>(count) : std::chrono::microseconds{0};
+    }
+
+    std::chrono::microseconds FrameScheduler::Histogram::getPercentile(float percentile) const noexcept
+    {
+        if (!count) return std::chrono::microseconds{0};
+
+        const auto target = static_cast<std::uint64_t>(static_cast<double>(count) * static_cast<double>(std::clamp(percentile, 0.0F, 100.0F)) / 100.0);
+
+        std::uint64_t sum = 0;
+        for (std::size_t bucket = 0; bucket < bucketCount - 1; ++bucket)
+        {
+            sum += buckets[bucket];
+            if (sum >= target && sum > 0)
+                return std::chrono::milliseconds(bucket + 1);
+        }
+
+        return maximum;
+    }
+
+    void FrameScheduler::setMode(Mode newMode)
+    {
+        mode = newMode;
+        accumulator = std::chrono::steady_clock::duration{0};
+    }
+
+    void FrameScheduler::setTickRate(float newTickRate)
+    {
+        if (newTickRate <= 0.0F)
+            throw std::runtime_error("Invalid tick rate");
+
+        tickRate = newTickRate;
+        tickDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / static_cast<double>(tickRate)));
+        if (tickDuration.count() <= 0) tickDuration = std::chrono::steady_clock::duration{1};
+    }
+
+    void FrameScheduler::setMaxTicksPerFrame(std::uint32_t newMaxTicksPerFrame)
+    {
+        if (newMaxTicksPerFrame == 0)
+            throw std::runtime_error("At least one tick per frame must be allowed");
+
+        maxTicksPerFrame = newMaxTicksPerFrame;
+    }
+
+    void FrameScheduler::setMaxFrameTime(std::chrono::steady_clock::duration newMaxFrameTime)
+    {
+        if (newMaxFrameTime.count() <= 0)
+            throw std::runtime_error("Invalid maximum frame time");
+
+        maxFrameTime = newMaxFrameTime;
+    }
+
+    FrameScheduler::Frame FrameScheduler::beginFrame(std::chrono::steady_clock::time_point currentTime)
+    {
+        Frame frame;
+
+        if (!started)
+        {
+            started = true;
+            previousTime = currentTime;
+            accumulator = std::chrono::steady_clock::duration{0};
+            return frame;
+        }
+
+        auto elapsed = currentTime - previousTime;
+
+        if (mode == Mode::variableStep)
+        {
+            // the frames that are shorter than a millisecond are merged with the next one
+            if (elapsed <= std::chrono::milliseconds(1))
+                return frame;
+
+            previousTime = currentTime;
+            frameTimeHistogram.add(elapsed);
+
+            if (elapsed > maxFrameTime)
+            {
+                droppedTime += elapsed - maxFrameTime;
+                elapsed = maxFrameTime;
+            }
+
+            frame.updateCount = 1;
+            frame.delta = std::chrono::duration<float>(elapsed).count();
+            return frame;
+        }
+
+        previousTime = currentTime;
+        frameTimeHistogram.add(elapsed);
+
+        if (elapsed > maxFrameTime)
+        {
+            droppedTime += elapsed - maxFrameTime;
+            elapsed = maxFrameTime;
+        }
+
+        accumulator += elapsed;
+
+        while (accumulator >= tickDuration && frame.updateCount < maxTicksPerFrame)
+        {
+            accumulator -= tickDuration;
+            ++frame.updateCount;
+        }
+
+        // the whole ticks that did not fit in the budget are skipped instead of delaying the next frames
+        if (accumulator >= tickDuration)
+        {
+            const auto remainder = accumulator % tickDuration;
+            droppedTime += accumulator - remainder;
+            accumulator = remainder;
+        }
+
+        frame.delta = std::chrono::duration<float>(tickDuration).count();
+        frame.interpolation = static_cast<float>(static_cast<double>(accumulator.count()) /
+                                                 static_cast<double>(tickDuration.count()));
+        return frame;
+    }
+}
@@ -0,0 +1,106 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_CORE_FRAMESCHEDULER_HPP
+#define OUZEL_CORE_FRAMESCHEDULER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace ouzel::core
+{
+    // Decides how many updates are dispatched every frame
+    // In the variable step mode every frame is one update with the measured delta,
+    // in the fixed step mode the updates run at a constant rate and the rendering interpolates between them
+    class FrameScheduler final
+    {
+    public:
+        enum class Mode
+        {
+            variableStep,
+            fixedStep
+        };
+
+        class Histogram final
+        {
+        public:
+            // one millisecond per bucket, the last bucket collects all of the longer frames
+            static constexpr std::size_t bucketCount = 100;
+
+            void add(std::chrono::steady_clock::duration frameTime) noexcept;
+            void reset() noexcept;
+
+            auto& getBuckets() const noexcept { return buckets; }
+            auto getCount() const noexcept { return count; }
+            auto getMinimum() const noexcept { return count ? minimum : std::chrono::microseconds{0}; }
+            auto getMaximum() const noexcept { return maximum; }
+            std::chrono::microseconds getAverage() const noexcept;
+
+            // Returns the upper bound of the bucket that contains the given percentile (0-100) of the frames
+            std::chrono::microseconds getPercentile(float percentile) const noexcept;
+
+        private:
+            std::array<std::uint32_t, bucketCount> buckets{};
+            std::uint64_t count = 0;
+            std::chrono::microseconds total{0};
+            std::chrono::microseconds minimum{0};
+            std::chrono::microseconds maximum{0};
+        };
+
+        struct Frame final
+        {
+            std::uint32_t updateCount = 0;
+            float delta = 0.0F; // seconds per update
+            float interpolation = 1.0F; // position of the frame between the previous and the last update
+        };
+
+        FrameScheduler() = default;
+
+        auto getMode() const noexcept { return mode; }
+        void setMode(Mode newMode);
+
+        auto getTickRate() const noexcept { return tickRate; }
+        void setTickRate(float newTickRate);
+
+        // The most fixed steps that are run to catch up in a single frame
+        auto getMaxTicksPerFrame() const noexcept { return maxTicksPerFrame; }
+        void setMaxTicksPerFrame(std::uint32_t newMaxTicksPerFrame);
+
+        // Longer frames are shortened to this, so that a slow frame can't cause even more updates in the next one
+        auto getMaxFrameTime() const noexcept { return maxFrameTime; }
+        void setMaxFrameTime(std::chrono::steady_clock::duration newMaxFrameTime);
+
+        // Handles the input that arrived during the update right before the scene is drawn
+        auto isInputLateLatched() const noexcept { return inputLateLatched; }
+        void setInputLateLatched(bool newInputLateLatched) noexcept { inputLateLatched = newInputLateLatched; }
+
+        Frame beginFrame(std::chrono::steady_clock::time_point currentTime);
+
+        // The next frame starts measuring from zero, used after pausing
+        void reset() noexcept { started = false; }
+
+        auto& getFrameTimeHistogram() const noexcept { return frameTimeHistogram; }
+        void resetFrameTimeHistogram() noexcept { frameTimeHistogram.reset(); }
+
+        // Simulation time that was skipped because the updates could not keep up
+        auto getDroppedTime() const noexcept { return droppedTime; }
+
+    private:
+        Mode mode = Mode::variableStep;
+        float tickRate = 60.0F;
+        std::chrono::steady_clock::duration tickDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(16666667));
+        std::uint32_t maxTicksPerFrame = 5;
+        std::chrono::steady_clock::duration maxFrameTime = std::chrono::milliseconds(1000 / 20); // 20 FPS minimum
+        bool inputLateLatched = false;
+
+        bool started = false;
+        std::chrono::steady_clock::time_point previousTime;
+        std::chrono::steady_clock::duration accumulator{0};
+        std::chrono::steady_clock::duration droppedTime{0};
+
+        Histogram frameTimeHistogram;
+    };
+}
+
+#endif // OUZEL_CORE_FRAMESCHEDULER_HPP
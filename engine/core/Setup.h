@@ -86,4 +86,9 @@
 #  define OUZEL_COMPILE_WASAPI 1
 #endif
 
+// Log calls above this level are compiled out (0 - off, 1 - error, 2 - warning, 3 - info, 4 - all)
+#ifndef OUZEL_LOG_LEVEL
+#  define OUZEL_LOG_LEVEL 4
+#endif
+
 #endif // OUZEL_SETUP_H
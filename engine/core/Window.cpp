@@ -96,6 +96,21 @@ namespace ouzel::core
         static_cast<void>(graphicsDriver);
     }
 
+    Window::Window(Engine& initEngine, const Size2U& newSize):
+        engine(initEngine),
+        nativeWindow(std::make_unique<NativeWindow>(std::bind(&Window::eventCallback, this, std::placeholders::_1),
+                                                    newSize,
+                                                    false,
+                                                    false,
+                                                    false,
+                                                    std::string(),
+                                                    false)),
+        size(newSize),
+        resolution(newSize),
+        highDpi(false)
+    {
+    }
+
     void Window::update()
     {
         NativeWindow::Event event;
@@ -136,11 +151,11 @@ namespace ouzel::core
             {
                 size = event.size;
 
-                auto sizeChangeEvent = std::make_unique<WindowEvent>();
-                sizeChangeEvent->type = Event::Type::windowSizeChange;
-                sizeChangeEvent->window = this;
-                sizeChangeEvent->size = event.size;
-                engine.getEventDispatcher().dispatchEvent(std::move(sizeChangeEvent));
+                WindowEvent sizeChangeEvent;
+                sizeChangeEvent.type = Event::Type::windowSizeChange;
+                sizeChangeEvent.window = this;
+                sizeChangeEvent.size = event.size;
+                engine.getEventDispatcher().dispatchEvent(sizeChangeEvent);
                 break;
             }
             case NativeWindow::Event::Type::resolutionChange:
@@ -149,33 +164,33 @@ namespace ouzel::core
 
                 engine.getGraphics()->setSize(resolution);
 
-                auto resolutionChangeEvent = std::make_unique<WindowEvent>();
-                resolutionChangeEvent->type = Event::Type::resolutionChange;
-                resolutionChangeEvent->window = this;
-                resolutionChangeEvent->size = event.size;
-                engine.getEventDispatcher().dispatchEvent(std::move(resolutionChangeEvent));
+                WindowEvent resolutionChangeEvent;
+                resolutionChangeEvent.type = Event::Type::resolutionChange;
+                resolutionChangeEvent.window = this;
+                resolutionChangeEvent.size = event.size;
+                engine.getEventDispatcher().dispatchEvent(resolutionChangeEvent);
                 break;
             }
             case NativeWindow::Event::Type::fullscreenChange:
             {
                 fullscreen = event.fullscreen;
 
-                auto fullscreenChangeEvent = std::make_unique<WindowEvent>();
-                fullscreenChangeEvent->type = Event::Type::fullscreenChange;
-                fullscreenChangeEvent->window = this;
-                fullscreenChangeEvent->fullscreen = event.fullscreen;
-                engine.getEventDispatcher().dispatchEvent(std::move(fullscreenChangeEvent));
+                WindowEvent fullscreenChangeEvent;
+                fullscreenChangeEvent.type = Event::Type::fullscreenChange;
+                fullscreenChangeEvent.window = this;
+                fullscreenChangeEvent.fullscreen = event.fullscreen;
+                engine.getEventDispatcher().dispatchEvent(fullscreenChangeEvent);
                 break;
             }
             case NativeWindow::Event::Type::screenChange:
             {
                 displayId = event.displayId;
 
-                auto screenChangeEvent = std::make_unique<WindowEvent>();
-                screenChangeEvent->type = Event::Type::screenChange;
-                screenChangeEvent->window = this;
-                screenChangeEvent->screenId = event.displayId;
-                engine.getEventDispatcher().dispatchEvent(std::move(screenChangeEvent));
+                WindowEvent screenChangeEvent;
+                screenChangeEvent.type = Event::Type::screenChange;
+                screenChangeEvent.window = this;
+                screenChangeEvent.screenId = event.displayId;
+                engine.getEventDispatcher().dispatchEvent(screenChangeEvent);
                 break;
             }
             case NativeWindow::Event::Type::close:
@@ -217,13 +232,13 @@ namespace ouzel::core
             command.size = newSize;
             nativeWindow->addCommand(command);
 
-            auto event = std::make_unique<WindowEvent>();
-            event->type = Event::Type::windowSizeChange;
-            event->window = this;
-            event->size = size;
-            event->title = title;
-            event->fullscreen = fullscreen;
-            engine.getEventDispatcher().dispatchEvent(std::move(event));
+            WindowEvent event;
+            event.type = Event::Type::windowSizeChange;
+            event.window = this;
+            event.size = size;
+            event.title = title;
+            event.fullscreen = fullscreen;
+            engine.getEventDispatcher().dispatchEvent(event);
         }
     }
 
@@ -237,13 +252,13 @@ namespace ouzel::core
             command.fullscreen = newFullscreen;
             nativeWindow->addCommand(command);
 
-            auto event = std::make_unique<WindowEvent>();
-            event->type = Event::Type::fullscreenChange;
-            event->window = this;
-            event->size = size;
-            event->title = title;
-            event->fullscreen = fullscreen;
-            engine.getEventDispatcher().dispatchEvent(std::move(event));
+            WindowEvent event;
+            event.type = Event::Type::fullscreenChange;
+            event.window = this;
+            event.size = size;
+            event.title = title;
+            event.fullscreen = fullscreen;
+            engine.getEventDispatcher().dispatchEvent(event);
         }
     }
 
@@ -257,13 +272,13 @@ namespace ouzel::core
             command.title = newTitle;
             nativeWindow->addCommand(command);
 
-            auto event = std::make_unique<WindowEvent>();
-            event->type = Event::Type::windowTitleChange;
-            event->window = this;
-            event->size = size;
-            event->title = title;
-            event->fullscreen = fullscreen;
-            engine.getEventDispatcher().dispatchEvent(std::move(event));
+            WindowEvent event;
+            event.type = Event::Type::windowTitleChange;
+            event.window = this;
+            event.size = size;
+            event.title = title;
+            event.fullscreen = fullscreen;
+            engine.getEventDispatcher().dispatchEvent(event);
         }
     }
 
@@ -37,6 +37,9 @@ namespace ouzel::core
                Flags flags,
                const std::string& newTitle,
                graphics::Driver graphicsDriver);
+        // Window without a platform window, used to render offscreen with the empty render driver (e.g. in tests)
+        Window(Engine& initEngine, const Size2U& newSize);
+
         Window(const Window&) = delete;
         Window& operator=(const Window&) = delete;
 
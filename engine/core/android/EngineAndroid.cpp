@@ -201,8 +201,8 @@ namespace ouzel::core::android
         {
             orientation = newOrientation;
 
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::orientationChange;
+            SystemEvent event;
+            event.type = Event::Type::orientationChange;
 
             static constexpr jint ORIENTATION_PORTRAIT = 0x00000001;
             static constexpr jint ORIENTATION_LANDSCAPE = 0x00000002;
@@ -210,13 +210,13 @@ namespace ouzel::core::android
             switch (orientation)
             {
                 case ORIENTATION_PORTRAIT:
-                    event->orientation = SystemEvent::Orientation::portrait;
+                    event.orientation = SystemEvent::Orientation::portrait;
                     break;
                 case ORIENTATION_LANDSCAPE:
-                    event->orientation = SystemEvent::Orientation::landscape;
+                    event.orientation = SystemEvent::Orientation::landscape;
                     break;
                 default: // unsupported orientation, assume portrait
-                    event->orientation = SystemEvent::Orientation::portrait;
+                    event.orientation = SystemEvent::Orientation::portrait;
                     break;
             }
 
@@ -204,7 +204,7 @@ extern "C" JNIEXPORT void JNICALL Java_org_ouzel_OuzelLibJNIWrapper_onSurfaceCre
     }
     catch (const std::exception& e)
     {
-        ouzel::logger.log(ouzel::Log::Level::error) << e.what();
+        OUZEL_LOG(ouzel::Log::Level::error) << e.what();
     }
 }
 
@@ -65,7 +65,7 @@ namespace ouzel::core::emscripten
             }
             catch (const std::exception& e)
             {
-                logger.log(Log::Level::error) << e.what();
+                OUZEL_LOG(Log::Level::error) << e.what();
                 exit();
             }
 
@@ -75,7 +75,7 @@ namespace ouzel::core::emscripten
             }
             catch (const std::exception& e)
             {
-                logger.log(Log::Level::error) << e.what();
+                OUZEL_LOG(Log::Level::error) << e.what();
             }
 
             try
@@ -84,7 +84,7 @@ namespace ouzel::core::emscripten
             }
             catch (const std::exception& e)
             {
-                logger.log(Log::Level::error) << e.what();
+                OUZEL_LOG(Log::Level::error) << e.what();
             }
 
             if (audio->getDevice()->getDriver() == audio::Driver::openAL)
@@ -96,7 +96,7 @@ namespace ouzel::core::emscripten
                 }
                 catch (const std::exception& e)
                 {
-                    logger.log(Log::Level::error) << e.what();
+                    OUZEL_LOG(Log::Level::error) << e.what();
                 }
             }
 
@@ -106,7 +106,7 @@ namespace ouzel::core::emscripten
             }
             catch (const std::exception& e)
             {
-                logger.log(Log::Level::error) << e.what();
+                OUZEL_LOG(Log::Level::error) << e.what();
             }
         }
         else
@@ -115,25 +115,25 @@ namespace ouzel::core::emscripten
 
     void Engine::handleOrientationChange(int orientation)
     {
-        auto event = std::make_unique<SystemEvent>();
-        event->type = Event::Type::orientationChange;
+        SystemEvent event;
+        event.type = Event::Type::orientationChange;
 
         switch (orientation)
         {
             case EMSCRIPTEN_ORIENTATION_PORTRAIT_PRIMARY:
-                event->orientation = SystemEvent::Orientation::portrait;
+                event.orientation = SystemEvent::Orientation::portrait;
                 break;
             case EMSCRIPTEN_ORIENTATION_PORTRAIT_SECONDARY:
-                event->orientation = SystemEvent::Orientation::portraitReverse;
+                event.orientation = SystemEvent::Orientation::portraitReverse;
                 break;
             case EMSCRIPTEN_ORIENTATION_LANDSCAPE_PRIMARY:
-                event->orientation = SystemEvent::Orientation::landscape;
+                event.orientation = SystemEvent::Orientation::landscape;
                 break;
             case EMSCRIPTEN_ORIENTATION_LANDSCAPE_SECONDARY:
-                event->orientation = SystemEvent::Orientation::landscapeReverse;
+                event.orientation = SystemEvent::Orientation::landscapeReverse;
                 break;
             default: // unsupported orientation, assume portrait
-                event->orientation = SystemEvent::Orientation::portrait;
+                event.orientation = SystemEvent::Orientation::portrait;
                 break;
         }
 
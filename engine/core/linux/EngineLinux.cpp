@@ -31,7 +31,7 @@ namespace
         error = errorEvent->error_code;
         char text[256];
         XGetErrorText(nullptr, errorEvent->error_code, text, sizeof(text));
-        ouzel::logger.log(ouzel::Log::Level::error) << "X11 error: " << text;
+        OUZEL_LOG(ouzel::Log::Level::error) << "X11 error: " << text;
         return 0;
     }
 
@@ -356,10 +356,10 @@ namespace ouzel::core::linux
                 XISelectEvents(display, windowLinux->getNativeWindow(), &eventMask, 1);
             }
             else
-                logger.log(Log::Level::warning) << "XInput2 not supported";
+                OUZEL_LOG(Log::Level::warning) << "XInput2 not supported";
         }
         else
-            logger.log(Log::Level::warning) << "XInput not supported";
+            OUZEL_LOG(Log::Level::warning) << "XInput not supported";
 
         executeAtom = XInternAtom(display, "OUZEL_EXECUTE", False);
 
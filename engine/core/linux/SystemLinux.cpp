@@ -17,7 +17,7 @@ int main(int argc, char* argv[])
     }
     catch (const std::exception& e)
     {
-        ouzel::logger.log(ouzel::Log::Level::error) << e.what();
+        OUZEL_LOG(ouzel::Log::Level::error) << e.what();
         return EXIT_FAILURE;
     }
 }
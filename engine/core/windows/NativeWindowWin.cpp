@@ -484,7 +484,7 @@ namespace ouzel::core::windows
         resolution = size;
 
         if (!RegisterTouchWindow(window, 0))
-            logger.log(Log::Level::warning) << "Failed to enable touch for window";
+            OUZEL_LOG(Log::Level::warning) << "Failed to enable touch for window";
 
         ShowWindow(window, SW_SHOW);
 
@@ -1,219 +1,248 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
 #include <algorithm>
+#include <cassert>
 #include "EventDispatcher.hpp"
 #include "EventHandler.hpp"
-#include "../utils/Utils.hpp"
 
 namespace ouzel
 {
     EventDispatcher::~EventDispatcher()
     {
-        for (EventHandler* eventHandler : eventHandlerAddSet)
-            eventHandler->eventDispatcher = nullptr;
-
-        for (EventHandler* eventHandler : eventHandlers)
-        {
-            const auto i = std::find(eventHandlerDeleteSet.begin(),
-                                     eventHandlerDeleteSet.end(),
-                                     eventHandler);
-            if (i == eventHandlerDeleteSet.end()) eventHandler->eventDispatcher = nullptr;
-        }
+        for (const auto& slot : slots)
+            if (slot.eventHandler)
+                slot.eventHandler->eventDispatcher = nullptr;
     }
 
     void EventDispatcher::dispatchEvents()
     {
-        for (EventHandler* eventHandler : eventHandlerDeleteSet)
+        for (std::size_t category = 0; category < registries.size(); ++category)
         {
-            const auto i = std::find(eventHandlers.begin(),
-                                     eventHandlers.end(),
-                                     eventHandler);
-
-            if (i != eventHandlers.end())
-                eventHandlers.erase(i);
+            // compact the registry when enough of its entries are tombstones
+            auto& registry = registries[category];
+            if (tombstones[category] * 4 > registry.size())
+            {
+                registry.erase(std::remove_if(registry.begin(), registry.end(),
+                                              [this](const Entry& entry) noexcept {
+                                                  return !isAlive(entry);
+                                              }), registry.end());
+                tombstones[category] = 0;
+            }
         }
 
-        eventHandlerDeleteSet.clear();
+        for (const auto& entry : pendingEntries)
+            if (isAlive(entry))
+                registerEventHandler(entry);
 
-        for (EventHandler* eventHandler : eventHandlerAddSet)
-        {
-            const auto i = std::find(eventHandlers.begin(),
-                                     eventHandlers.end(),
-                                     eventHandler);
+        pendingEntries.clear();
 
-            if (i == eventHandlers.end())
-            {
-                const auto upperBound = std::upper_bound(eventHandlers.begin(), eventHandlers.end(), eventHandler,
-                                                         [](const auto a, const auto b) noexcept {
-                                                                return a->priority > b->priority;
-                                                            });
-
-                eventHandlers.insert(upperBound, eventHandler);
-            }
-        }
+#ifdef DEBUG
+        // a callback set after the handler was added would never be called
+        for (const auto& slot : slots)
+            assert(!slot.eventHandler || (getCategories(*slot.eventHandler) & ~slot.categories) == 0);
+#endif
 
-        eventHandlerAddSet.clear();
+        eventQueue.drain([this](QueuedEvent& queuedEvent) {
+            const bool handled = std::visit([this](const auto& event) {
+                return dispatchEvent(event);
+            }, queuedEvent.event);
+            if (queuedEvent.promise) queuedEvent.promise->set_value(handled);
+            queuedEvent.promise.reset();
+        });
+    }
 
-        std::pair<std::promise<bool>, std::unique_ptr<Event>> event;
+    template <class T>
+    bool EventDispatcher::dispatch(Category category,
+                                   std::function<bool(const T&)> EventHandler::* callback,
+                                   const T& event) const
+    {
+        // handlers added during the dispatch are registered on the next dispatchEvents call,
+        // so the registry does not change while it is being iterated
+        const auto& registry = registries[static_cast<std::size_t>(category)];
 
-        for (;;)
-        {
-            std::unique_lock lock(eventQueueMutex);
-            if (eventQueue.empty()) break;
+        for (const auto& entry : registry)
+            if (isAlive(entry))
+            {
+                const auto& function = slots[entry.slot].eventHandler->*callback;
+                if (function && function(event))
+                    return true;
+            }
 
-            event = std::move(eventQueue.front());
-            eventQueue.pop();
-            lock.unlock();
+        return false;
+    }
 
-            event.first.set_value(dispatchEvent(std::move(event.second)));
+    bool EventDispatcher::dispatchEvent(const Event& event)
+    {
+        switch (event.type)
+        {
+            case Event::Type::keyboardConnect:
+            case Event::Type::keyboardDisconnect:
+            case Event::Type::keyboardKeyPress:
+            case Event::Type::keyboardKeyRelease:
+                return dispatch(Category::keyboard, &EventHandler::keyboardHandler, static_cast<const KeyboardEvent&>(event));
+            case Event::Type::mouseConnect:
+            case Event::Type::mouseDisconnect:
+            case Event::Type::mousePress:
+            case Event::Type::mouseRelease:
+            case Event::Type::mouseScroll:
+            case Event::Type::mouseMove:
+            case Event::Type::mouseCursorLockChange:
+                return dispatch(Category::mouse, &EventHandler::mouseHandler, static_cast<const MouseEvent&>(event));
+            case Event::Type::touchpadConnect:
+            case Event::Type::touchpadDisconnect:
+            case Event::Type::touchBegin:
+            case Event::Type::touchMove:
+            case Event::Type::touchEnd:
+            case Event::Type::touchCancel:
+                return dispatch(Category::touch, &EventHandler::touchHandler, static_cast<const TouchEvent&>(event));
+            case Event::Type::gamepadConnect:
+            case Event::Type::gamepadDisconnect:
+            case Event::Type::gamepadButtonChange:
+                return dispatch(Category::gamepad, &EventHandler::gamepadHandler, static_cast<const GamepadEvent&>(event));
+            case Event::Type::windowSizeChange:
+            case Event::Type::windowTitleChange:
+            case Event::Type::fullscreenChange:
+            case Event::Type::screenChange:
+            case Event::Type::resolutionChange:
+                return dispatch(Category::window, &EventHandler::windowHandler, static_cast<const WindowEvent&>(event));
+            case Event::Type::engineStart:
+            case Event::Type::engineStop:
+            case Event::Type::engineResume:
+            case Event::Type::enginePause:
+            case Event::Type::orientationChange:
+            case Event::Type::lowMemory:
+            case Event::Type::openFile:
+                return dispatch(Category::system, &EventHandler::systemHandler, static_cast<const SystemEvent&>(event));
+            case Event::Type::actorEnter:
+            case Event::Type::actorLeave:
+            case Event::Type::actorPress:
+            case Event::Type::actorRelease:
+            case Event::Type::actorClick:
+            case Event::Type::actorDrag:
+            case Event::Type::widgetChange:
+                return dispatch(Category::ui, &EventHandler::uiHandler, static_cast<const UIEvent&>(event));
+            case Event::Type::animationStart:
+            case Event::Type::animationReset:
+            case Event::Type::animationFinish:
+                return dispatch(Category::animation, &EventHandler::animationHandler, static_cast<const AnimationEvent&>(event));
+            case Event::Type::soundStart:
+            case Event::Type::soundReset:
+            case Event::Type::soundFinish:
+                return dispatch(Category::sound, &EventHandler::soundHandler, static_cast<const SoundEvent&>(event));
+            case Event::Type::update:
+                return dispatch(Category::update, &EventHandler::updateHandler, static_cast<const UpdateEvent&>(event));
+            case Event::Type::user:
+                return dispatch(Category::user, &EventHandler::userHandler, static_cast<const UserEvent&>(event));
+            default:
+                return false; // custom event should not be sent
         }
     }
 
-    bool EventDispatcher::dispatchEvent(std::unique_ptr<Event> event)
+    std::uint32_t EventDispatcher::getCategories(const EventHandler& eventHandler) noexcept
     {
-        if (!event) return false;
-
-        bool handled = false;
+        const auto bit = [](Category category) noexcept {
+            return 1U << static_cast<std::uint32_t>(category);
+        };
+
+        std::uint32_t result = 0;
+        if (eventHandler.keyboardHandler) result |= bit(Category::keyboard);
+        if (eventHandler.mouseHandler) result |= bit(Category::mouse);
+        if (eventHandler.touchHandler) result |= bit(Category::touch);
+        if (eventHandler.gamepadHandler) result |= bit(Category::gamepad);
+        if (eventHandler.windowHandler) result |= bit(Category::window);
+        if (eventHandler.systemHandler) result |= bit(Category::system);
+        if (eventHandler.uiHandler) result |= bit(Category::ui);
+        if (eventHandler.animationHandler) result |= bit(Category::animation);
+        if (eventHandler.soundHandler) result |= bit(Category::sound);
+        if (eventHandler.updateHandler) result |= bit(Category::update);
+        if (eventHandler.userHandler) result |= bit(Category::user);
+        return result;
+    }
 
-        for (const auto eventHandler : eventHandlers)
-        {
-            const auto i = std::find(eventHandlerDeleteSet.begin(),
-                                     eventHandlerDeleteSet.end(),
-                                     eventHandler);
+    void EventDispatcher::registerEventHandler(const Entry& entry)
+    {
+        auto& slot = slots[entry.slot];
+        slot.categories = getCategories(*slot.eventHandler);
 
-            if (i == eventHandlerDeleteSet.end())
+        for (std::size_t category = 0; category < registries.size(); ++category)
+            if (slot.categories & (1U << category))
             {
-                switch (event->type)
-                {
-                    case Event::Type::keyboardConnect:
-                    case Event::Type::keyboardDisconnect:
-                    case Event::Type::keyboardKeyPress:
-                    case Event::Type::keyboardKeyRelease:
-                        if (eventHandler->keyboardHandler)
-                            handled = eventHandler->keyboardHandler(*static_cast<KeyboardEvent*>(event.get()));
-                        break;
-                    case Event::Type::mouseConnect:
-                    case Event::Type::mouseDisconnect:
-                    case Event::Type::mousePress:
-                    case Event::Type::mouseRelease:
-                    case Event::Type::mouseScroll:
-                    case Event::Type::mouseMove:
-                    case Event::Type::mouseCursorLockChange:
-                        if (eventHandler->mouseHandler)
-                            handled = eventHandler->mouseHandler(*static_cast<MouseEvent*>(event.get()));
-                        break;
-                    case Event::Type::touchpadConnect:
-                    case Event::Type::touchpadDisconnect:
-                    case Event::Type::touchBegin:
-                    case Event::Type::touchMove:
-                    case Event::Type::touchEnd:
-                    case Event::Type::touchCancel:
-                        if (eventHandler->touchHandler)
-                            handled = eventHandler->touchHandler(*static_cast<TouchEvent*>(event.get()));
-                        break;
-                    case Event::Type::gamepadConnect:
-                    case Event::Type::gamepadDisconnect:
-                    case Event::Type::gamepadButtonChange:
-                        if (eventHandler->gamepadHandler)
-                            handled = eventHandler->gamepadHandler(*static_cast<GamepadEvent*>(event.get()));
-                        break;
-                    case Event::Type::windowSizeChange:
-                    case Event::Type::windowTitleChange:
-                    case Event::Type::fullscreenChange:
-                    case Event::Type::screenChange:
-                    case Event::Type::resolutionChange:
-                        if (eventHandler->windowHandler)
-                            handled = eventHandler->windowHandler(*static_cast<WindowEvent*>(event.get()));
-                        break;
-                    case Event::Type::engineStart:
-                    case Event::Type::engineStop:
-                    case Event::Type::engineResume:
-                    case Event::Type::enginePause:
-                    case Event::Type::orientationChange:
-                    case Event::Type::lowMemory:
-                    case Event::Type::openFile:
-                        if (eventHandler->systemHandler)
-                            handled = eventHandler->systemHandler(*static_cast<SystemEvent*>(event.get()));
-                        break;
-                    case Event::Type::actorEnter:
-                    case Event::Type::actorLeave:
-                    case Event::Type::actorPress:
-                    case Event::Type::actorRelease:
-                    case Event::Type::actorClick:
-                    case Event::Type::actorDrag:
-                    case Event::Type::widgetChange:
-                        if (eventHandler->uiHandler)
-                            handled = eventHandler->uiHandler(*static_cast<UIEvent*>(event.get()));
-                        break;
-                    case Event::Type::animationStart:
-                    case Event::Type::animationReset:
-                    case Event::Type::animationFinish:
-                        if (eventHandler->animationHandler)
-                            handled = eventHandler->animationHandler(*static_cast<AnimationEvent*>(event.get()));
-                        break;
-                    case Event::Type::soundStart:
-                    case Event::Type::soundReset:
-                    case Event::Type::soundFinish:
-                        if (eventHandler->soundHandler)
-                            handled = eventHandler->soundHandler(*static_cast<SoundEvent*>(event.get()));
-                        break;
-                    case Event::Type::update:
-                        if (eventHandler->updateHandler)
-                            handled = eventHandler->updateHandler(*static_cast<UpdateEvent*>(event.get()));
-                        break;
-                    case Event::Type::user:
-                        if (eventHandler->userHandler)
-                            handled = eventHandler->userHandler(*static_cast<UserEvent*>(event.get()));
-                        break;
-                    default:
-                        return false; // custom event should not be sent
-                }
+                auto& registry = registries[category];
+                const auto upperBound = std::upper_bound(registry.begin(), registry.end(), entry,
+                                                         [](const Entry& a, const Entry& b) noexcept {
+                                                             return a.priority > b.priority;
+                                                         });
+                registry.insert(upperBound, entry);
             }
-
-            if (handled) break;
-        }
-
-        return handled;
     }
 
     void EventDispatcher::addEventHandler(EventHandler& eventHandler)
     {
+        // already added (or waiting to be added) to this dispatcher
+        if (eventHandler.eventDispatcher == this) return;
+
         if (eventHandler.eventDispatcher)
             eventHandler.eventDispatcher->removeEventHandler(eventHandler);
 
         eventHandler.eventDispatcher = this;
 
-        eventHandlerAddSet.insert(&eventHandler);
+        std::uint32_t slotIndex;
+        if (!freeSlots.empty())
+        {
+            slotIndex = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            slotIndex = static_cast<std::uint32_t>(slots.size());
+            slots.emplace_back();
+        }
 
-        const auto setIterator = eventHandlerDeleteSet.find(&eventHandler);
+        auto& slot = slots[slotIndex];
+        slot.eventHandler = &eventHandler;
+        slot.categories = 0;
+        eventHandler.slot = slotIndex;
 
-        if (setIterator != eventHandlerDeleteSet.end())
-            eventHandlerDeleteSet.erase(setIterator);
+        // the handler is registered on the next dispatchEvents call
+        pendingEntries.push_back(Entry{slotIndex, slot.generation, eventHandler.priority});
     }
 
     void EventDispatcher::removeEventHandler(EventHandler& eventHandler)
     {
-        if (eventHandler.eventDispatcher == this)
-            eventHandler.eventDispatcher = nullptr;
+        if (eventHandler.eventDispatcher != this) return;
+
+        eventHandler.eventDispatcher = nullptr;
 
-        eventHandlerDeleteSet.insert(&eventHandler);
+        auto& slot = slots[eventHandler.slot];
+        ++slot.generation;
+        slot.eventHandler = nullptr;
 
-        const auto setIterator = eventHandlerAddSet.find(&eventHandler);
+        for (std::size_t category = 0; category < tombstones.size(); ++category)
+            if (slot.categories & (1U << category))
+                ++tombstones[category];
+
+        slot.categories = 0;
+        freeSlots.push_back(eventHandler.slot);
+    }
 
-        if (setIterator != eventHandlerAddSet.end())
-            eventHandlerAddSet.erase(setIterator);
+    void EventDispatcher::postEvent(PostedEvent event)
+    {
+#if defined(__EMSCRIPTEN__)
+        std::visit([this](const auto& postedEvent) { dispatchEvent(postedEvent); }, event);
+#else
+        eventQueue.push(QueuedEvent{std::move(event), std::nullopt});
+#endif
     }
 
-    std::future<bool> EventDispatcher::postEvent(std::unique_ptr<Event> event)
+    std::future<bool> EventDispatcher::postEventWithResult(PostedEvent event)
     {
         std::promise<bool> promise;
         std::future<bool> future = promise.get_future();
 
 #if defined(__EMSCRIPTEN__)
-        promise.set_value(dispatchEvent(std::move(event)));
+        promise.set_value(std::visit([this](const auto& postedEvent) { return dispatchEvent(postedEvent); }, event));
 #else
-        std::lock_guard lock(eventQueueMutex);
-        eventQueue.push(std::pair<std::promise<bool>, std::unique_ptr<Event>>(std::move(promise), std::move(event)));
+        eventQueue.push(QueuedEvent{std::move(event), std::move(promise)});
 #endif
 
         return future;
@@ -3,13 +3,16 @@
 #ifndef OUZEL_EVENTS_EVENTDISPATCHER_HPP
 #define OUZEL_EVENTS_EVENTDISPATCHER_HPP
 
+#include <array>
 #include <cstdint>
+#include <functional>
 #include <future>
 #include <memory>
-#include <queue>
-#include <set>
+#include <optional>
+#include <variant>
 #include <vector>
 #include "Event.hpp"
+#include "../thread/RingQueue.hpp"
 
 namespace ouzel
 {
@@ -29,22 +32,91 @@ namespace ouzel
         void addEventHandler(EventHandler& eventHandler);
         void removeEventHandler(EventHandler& eventHandler);
 
+        // any of the engine events, the posted events are queued by value
+        using PostedEvent = std::variant<KeyboardEvent,
+            MouseEvent,
+            TouchEvent,
+            GamepadEvent,
+            WindowEvent,
+            SystemEvent,
+            UIEvent,
+            AnimationEvent,
+            SoundEvent,
+            UpdateEvent,
+            UserEvent>;
+
         // dispatches the event immediately
-        bool dispatchEvent(std::unique_ptr<Event> event);
+        bool dispatchEvent(const Event& event);
 
         // posts the event for dispatching on the game thread
-        std::future<bool> postEvent(std::unique_ptr<Event> event);
+        void postEvent(PostedEvent event);
+
+        // posts the event and returns a future that tells if it was handled
+        std::future<bool> postEventWithResult(PostedEvent event);
 
         // dispatches all queued events on the game thread
         void dispatchEvents();
 
     private:
-        std::vector<EventHandler*> eventHandlers;
-        std::set<EventHandler*> eventHandlerAddSet;
-        std::set<EventHandler*> eventHandlerDeleteSet;
+        // Handlers are indexed by the callback they have set
+        enum class Category
+        {
+            keyboard,
+            mouse,
+            touch,
+            gamepad,
+            window,
+            system,
+            ui,
+            animation,
+            sound,
+            update,
+            user,
+            count
+        };
+
+        // Removing a handler bumps the generation of its slot, which turns all
+        // of the registry entries that point to the slot into tombstones
+        struct Slot final
+        {
+            EventHandler* eventHandler = nullptr;
+            std::uint32_t generation = 0;
+            std::uint32_t categories = 0; // bit mask of the registries that hold the slot
+        };
+
+        struct Entry final
+        {
+            std::uint32_t slot;
+            std::uint32_t generation;
+            std::int32_t priority;
+        };
+
+        bool isAlive(const Entry& entry) const noexcept
+        {
+            return slots[entry.slot].generation == entry.generation;
+        }
+
+        template <class T>
+        bool dispatch(Category category,
+                      std::function<bool(const T&)> EventHandler::* callback,
+                      const T& event) const;
+
+        static std::uint32_t getCategories(const EventHandler& eventHandler) noexcept;
+        void registerEventHandler(const Entry& entry);
+
+        std::vector<Slot> slots;
+        std::vector<std::uint32_t> freeSlots;
+        std::vector<Entry> pendingEntries;
+        std::array<std::vector<Entry>, static_cast<std::size_t>(Category::count)> registries;
+        std::array<std::size_t, static_cast<std::size_t>(Category::count)> tombstones{};
+
+        struct QueuedEvent final
+        {
+            PostedEvent event;
+            std::optional<std::promise<bool>> promise;
+        };
 
-        std::mutex eventQueueMutex;
-        std::queue<std::pair<std::promise<bool>, std::unique_ptr<Event>>> eventQueue;
+        thread::RingQueue<QueuedEvent> eventQueue{256};
     };
 }
 
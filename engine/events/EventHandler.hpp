@@ -10,6 +10,10 @@
 
 namespace ouzel
 {
+    // The callbacks must be set before the handler is added to the dispatcher,
+    // the dispatcher indexes the handler by its callbacks when it registers it,
+    // so a callback set later is never called (asserted in debug builds)
+    // Callbacks can be reset or replaced by other callbacks of the same type at any time
     class EventHandler final
     {
         friend EventDispatcher;
@@ -30,11 +34,7 @@ namespace ouzel
 
         void remove()
         {
-            if (eventDispatcher)
-            {
-                eventDispatcher->removeEventHandler(*this);
-                eventDispatcher = nullptr;
-            }
+            if (eventDispatcher) eventDispatcher->removeEventHandler(*this);
         }
 
         std::function<bool(const KeyboardEvent&)> keyboardHandler;
@@ -52,6 +52,7 @@ namespace ouzel
     private:
         Priority priority;
         EventDispatcher* eventDispatcher = nullptr;
+        std::uint32_t slot = 0;
     };
 }
 
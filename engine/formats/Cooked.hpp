@@ -0,0 +1,488 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_FORMATS_COOKED_HPP
+#define OUZEL_FORMATS_COOKED_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../hash/Fnv1.hpp"
+
+// Binary asset format written by the ouzel tool (--export-assets)
+// The file starts with a header followed by a list of chunks, every chunk payload
+// starts at an offset aligned to 16 bytes, so the vertex and index blobs can be
+// handed to the graphics buffers straight from a memory mapped file.
+// Values are stored in the native (little-endian) byte order of the target.
+namespace ouzel::cooked
+{
+    class FormatError final: public std::runtime_error
+    {
+    public:
+        explicit FormatError(const std::string& str): std::runtime_error(str) {}
+        explicit FormatError(const char* str): std::runtime_error(str) {}
+    };
+
+    constexpr auto fileExtension = "oasset";
+    constexpr std::uint32_t version = 3;
+    constexpr std::size_t alignment = 16;
+
+    enum class AssetType: std::uint32_t
+    {
+        staticMesh = 1,
+        sprite = 2,
+        particleSystem = 3,
+        font = 4,
+        stringTable = 5,
+        programBinary = 6
+    };
+
+    constexpr std::uint32_t makeChunkType(char a, char b, char c, char d) noexcept
+    {
+        return static_cast<std::uint32_t>(static_cast<std::uint8_t>(a)) |
+            (static_cast<std::uint32_t>(static_cast<std::uint8_t>(b)) << 8) |
+            (static_cast<std::uint32_t>(static_cast<std::uint8_t>(c)) << 16) |
+            (static_cast<std::uint32_t>(static_cast<std::uint8_t>(d)) << 24);
+    }
+
+    enum class ChunkType: std::uint32_t
+    {
+        name = makeChunkType('N', 'A', 'M', 'E'), // string
+        materialLibrary = makeChunkType('M', 'L', 'I', 'B'), // string
+        material = makeChunkType('M', 'T', 'R', 'L'), // string
+        texture = makeChunkType('T', 'X', 'T', 'R'), // string
+        mesh = makeChunkType('M', 'E', 'S', 'H'), // Mesh
+        vertices = makeChunkType('V', 'E', 'R', 'T'), // graphics::Vertex array
+        indices = makeChunkType('I', 'N', 'D', 'X'), // 16-bit or 32-bit index array
+        sprite = makeChunkType('S', 'P', 'R', 'T'), // Sprite
+        frame = makeChunkType('F', 'R', 'A', 'M'), // Frame
+        particleSystem = makeChunkType('P', 'A', 'R', 'T'), // ParticleSystem
+        font = makeChunkType('F', 'O', 'N', 'T'), // Font
+        glyphs = makeChunkType('G', 'L', 'Y', 'P'), // Glyph array
+        kernings = makeChunkType('K', 'E', 'R', 'N'), // Kerning array
+        stringKeys = makeChunkType('S', 'K', 'E', 'Y'), // sorted 64-bit key array
+        stringEntries = makeChunkType('S', 'E', 'N', 'T'), // StringEntry array
+        strings = makeChunkType('S', 'T', 'R', 'S'), // string data
+        programBinary = makeChunkType('P', 'R', 'O', 'G'), // ProgramBinary
+        programData = makeChunkType('P', 'D', 'A', 'T'), // driver specific program binary
+        uniformLocations = makeChunkType('U', 'L', 'O', 'C') // 32-bit uniform location array
+    };
+
+    struct Header final
+    {
+        char magic[4];
+        std::uint32_t version;
+        AssetType assetType;
+        std::uint32_t chunkCount;
+    };
+
+    struct ChunkHeader final
+    {
+        ChunkType type;
+        std::uint32_t reserved;
+        std::uint64_t size;
+    };
+
+    static_assert(sizeof(Header) % alignment == 0);
+    static_assert(sizeof(ChunkHeader) % alignment == 0);
+
+    // Followed by optional material, vertices and indices chunks
+    struct Mesh final
+    {
+        float boundingBoxMin[3];
+        float boundingBoxMax[3];
+        std::uint32_t indexSize;
+        std::uint32_t indexCount;
+        std::uint32_t vertexCount;
+        std::uint32_t reserved;
+    };
+
+    // Followed by the texture chunk and the frames (name, frame, optional vertices and 16-bit indices)
+    struct Sprite final
+    {
+        float textureWidth;
+        float textureHeight;
+        float frameInterval;
+        std::uint32_t frameCount;
+    };
+
+    struct Frame final
+    {
+        float x;
+        float y;
+        float width;
+        float height;
+        float sourceWidth;
+        float sourceHeight;
+        float offsetX;
+        float offsetY;
+        float pivotX;
+        float pivotY;
+        std::uint32_t rotated;
+        std::uint32_t polygon; // has vertices and indices chunks
+    };
+
+    struct ParticleSystem final
+    {
+        std::uint32_t blendFuncSource;
+        std::uint32_t blendFuncDestination;
+        std::uint32_t emitterType;
+        std::uint32_t maxParticles;
+        float duration;
+        float particleLifespan;
+        float particleLifespanVariance;
+        float speed;
+        float speedVariance;
+        float sourcePosition[2];
+        float sourcePositionVariance[2];
+        float startParticleSize;
+        float startParticleSizeVariance;
+        float finishParticleSize;
+        float finishParticleSizeVariance;
+        float angle;
+        float angleVariance;
+        float startRotation;
+        float startRotationVariance;
+        float finishRotation;
+        float finishRotationVariance;
+        float rotatePerSecond;
+        float rotatePerSecondVariance;
+        float minRadius;
+        float minRadiusVariance;
+        float maxRadius;
+        float maxRadiusVariance;
+        float radialAcceleration;
+        float radialAccelVariance;
+        float tangentialAcceleration;
+        float tangentialAccelVariance;
+        std::uint32_t absolutePosition;
+        std::uint32_t yCoordFlipped;
+        std::uint32_t rotationIsDir;
+        float gravity[2];
+        float startColor[4];
+        float startColorVariance[4];
+        float finishColor[4];
+        float finishColorVariance[4];
+    };
+
+    // Followed by the texture, glyphs and kernings chunks
+    struct Font final
+    {
+        std::uint16_t lineHeight;
+        std::uint16_t base;
+        std::uint16_t width;
+        std::uint16_t height;
+        std::uint16_t pages;
+        std::uint16_t outline;
+        std::uint16_t reserved[2];
+    };
+
+    struct Glyph final
+    {
+        std::uint32_t id;
+        std::int16_t x;
+        std::int16_t y;
+        std::int16_t width;
+        std::int16_t height;
+        std::int16_t xOffset;
+        std::int16_t yOffset;
+        std::int16_t xAdvance;
+        std::int16_t page;
+    };
+
+    struct Kerning final
+    {
+        std::uint32_t first;
+        std::uint32_t second;
+        std::int16_t amount;
+        std::uint16_t reserved;
+    };
+
+    // Followed by the string data, the entry at index i belongs to the key at index i
+    struct StringEntry final
+    {
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    // Written by the OpenGL render device at runtime, followed by the program data and uniform locations chunks
+    struct ProgramBinary final
+    {
+        std::uint64_t key;
+        std::uint64_t checksum; // FNV-1 hash of the program data
+        std::uint32_t binaryFormat;
+        std::uint32_t uniformCount;
+    };
+
+    inline bool isCooked(const std::byte* data, std::size_t size) noexcept
+    {
+        return size >= sizeof(Header) &&
+            static_cast<char>(data[0]) == 'O' &&
+            static_cast<char>(data[1]) == 'U' &&
+            static_cast<char>(data[2]) == 'Z' &&
+            static_cast<char>(data[3]) == 'C';
+    }
+
+    class Writer final
+    {
+    public:
+        explicit Writer(AssetType assetType)
+        {
+            const Header header{{'O', 'U', 'Z', 'C'}, version, assetType, 0};
+            append(&header, sizeof(header));
+        }
+
+        void addChunk(ChunkType type, const void* chunkData, std::size_t size)
+        {
+            const ChunkHeader chunkHeader{type, 0, size};
+            append(&chunkHeader, sizeof(chunkHeader));
+            append(chunkData, size);
+            data.resize((data.size() + alignment - 1) / alignment * alignment);
+
+            Header header;
+            std::memcpy(&header, data.data(), sizeof(header));
+            ++header.chunkCount;
+            std::memcpy(data.data(), &header, sizeof(header));
+        }
+
+        void addString(ChunkType type, const std::string& str)
+        {
+            addChunk(type, str.data(), str.size());
+        }
+
+        template <class T>
+        void addValue(ChunkType type, const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            addChunk(type, &value, sizeof(value));
+        }
+
+        template <class T>
+        void addArray(ChunkType type, const std::vector<T>& values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            addChunk(type, values.data(), values.size() * sizeof(T));
+        }
+
+        auto& getData() const noexcept { return data; }
+
+    private:
+        void append(const void* source, std::size_t size)
+        {
+            const auto offset = data.size();
+            data.resize(offset + size);
+            if (size) std::memcpy(data.data() + offset, source, size);
+        }
+
+        std::vector<std::byte> data;
+    };
+
+    // The keys are sorted, so that the table can be searched straight from a memory mapped file
+    inline std::vector<std::byte> writeStringTable(std::vector<std::pair<std::uint64_t, std::string_view>> strings)
+    {
+        std::sort(strings.begin(), strings.end(), [](const auto& a, const auto& b) noexcept {
+            return a.first < b.first;
+        });
+
+        std::vector<std::uint64_t> keys;
+        std::vector<StringEntry> entries;
+        std::string stringData;
+
+        keys.reserve(strings.size());
+        entries.reserve(strings.size());
+
+        for (const auto& [key, str] : strings)
+        {
+            if (!keys.empty() && keys.back() == key)
+                throw FormatError("Duplicate string key " + std::to_string(key));
+
+            keys.push_back(key);
+            entries.push_back(StringEntry{
+                static_cast<std::uint32_t>(stringData.size()),
+                static_cast<std::uint32_t>(str.size())
+            });
+            stringData += str;
+        }
+
+        Writer writer(AssetType::stringTable);
+        writer.addArray(ChunkType::stringKeys, keys);
+        writer.addArray(ChunkType::stringEntries, entries);
+        writer.addString(ChunkType::strings, stringData);
+        return writer.getData();
+    }
+
+    inline std::vector<std::byte> writeProgramBinary(std::uint64_t key, std::uint32_t binaryFormat,
+                                                     const std::vector<std::uint8_t>& programData,
+                                                     const std::vector<std::int32_t>& uniformLocations)
+    {
+        const std::string_view programString(reinterpret_cast<const char*>(programData.data()), programData.size());
+
+        const ProgramBinary header{
+            key,
+            hash::fnv1::hash<std::uint64_t>(programString),
+            binaryFormat,
+            static_cast<std::uint32_t>(uniformLocations.size())
+        };
+
+        Writer writer(AssetType::programBinary);
+        writer.addValue(ChunkType::programBinary, header);
+        writer.addArray(ChunkType::programData, programData);
+        writer.addArray(ChunkType::uniformLocations, uniformLocations);
+        return writer.getData();
+    }
+
+    // Payload of a chunk, valid as long as the data passed to the Reader
+    class Chunk final
+    {
+    public:
+        Chunk(ChunkType initType, const std::byte* initData, std::size_t initSize) noexcept:
+            type(initType), data(initData), size(initSize)
+        {
+        }
+
+        auto getType() const noexcept { return type; }
+        auto getData() const noexcept { return data; }
+        auto getSize() const noexcept { return size; }
+
+        template <class T>
+        const T& get() const
+        {
+            return *getArray<T>(1);
+        }
+
+        template <class T>
+        const T* getArray(std::size_t count) const
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            if (size < count * sizeof(T))
+                throw FormatError("Chunk is too small");
+
+            if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) != 0)
+                throw FormatError("Chunk is not aligned");
+
+            return reinterpret_cast<const T*>(data);
+        }
+
+        std::string_view getString() const noexcept
+        {
+            return std::string_view(reinterpret_cast<const char*>(data), size);
+        }
+
+    private:
+        ChunkType type;
+        const std::byte* data;
+        std::size_t size;
+    };
+
+    class Reader final
+    {
+    public:
+        Reader(const std::byte* initData, std::size_t initSize):
+            data(initData), size(initSize), offset(sizeof(Header))
+        {
+            if (!isCooked(data, size))
+                throw FormatError("Not a cooked asset");
+
+            Header header;
+            std::memcpy(&header, data, sizeof(header));
+
+            if (header.version != version)
+                throw FormatError("Unsupported cooked asset version");
+
+            assetType = header.assetType;
+            chunkCount = header.chunkCount;
+        }
+
+        auto getAssetType() const noexcept { return assetType; }
+
+        bool hasChunks() const noexcept { return chunkIndex < chunkCount; }
+
+        ChunkType peek() const
+        {
+            return readChunkHeader().type;
+        }
+
+        Chunk next()
+        {
+            const auto chunkHeader = readChunkHeader();
+
+            const auto payload = offset + sizeof(ChunkHeader);
+            if (chunkHeader.size > size - payload)
+                throw FormatError("Chunk is out of bounds");
+
+            const auto chunkSize = static_cast<std::size_t>(chunkHeader.size);
+            offset = (payload + chunkSize + alignment - 1) / alignment * alignment;
+            ++chunkIndex;
+
+            return Chunk(chunkHeader.type, data + payload, chunkSize);
+        }
+
+        Chunk next(ChunkType type)
+        {
+            auto chunk = next();
+            if (chunk.getType() != type)
+                throw FormatError("Unexpected chunk");
+            return chunk;
+        }
+
+    private:
+        ChunkHeader readChunkHeader() const
+        {
+            if (!hasChunks() || offset > size || size - offset < sizeof(ChunkHeader))
+                throw FormatError("Unexpected end of data");
+
+            ChunkHeader chunkHeader;
+            std::memcpy(&chunkHeader, data + offset, sizeof(chunkHeader));
+            return chunkHeader;
+        }
+
+        const std::byte* data;
+        std::size_t size;
+        std::size_t offset;
+        AssetType assetType;
+        std::uint32_t chunkCount = 0;
+        std::uint32_t chunkIndex = 0;
+    };
+
+    // The program data and the uniform locations point to the data passed to readProgramBinary
+    struct ProgramBinaryData final
+    {
+        std::uint32_t binaryFormat;
+        Chunk programData;
+        const std::int32_t* uniformLocations;
+    };
+
+    // Throws if the entry is not the one of the key, has a different number of uniforms or is corrupted
+    inline ProgramBinaryData readProgramBinary(const std::byte* data, std::size_t size,
+                                               std::uint64_t key, std::size_t uniformCount)
+    {
+        Reader reader(data, size);
+
+        if (reader.getAssetType() != AssetType::programBinary)
+            throw FormatError("Not a program binary");
+
+        const auto header = reader.next(ChunkType::programBinary).get<ProgramBinary>();
+        const auto programData = reader.next(ChunkType::programData);
+        const auto locationChunk = reader.next(ChunkType::uniformLocations);
+
+        if (header.key != key)
+            throw FormatError("Program key mismatch");
+
+        if (header.checksum != hash::fnv1::hash<std::uint64_t>(programData.getString()))
+            throw FormatError("Program data is corrupted");
+
+        if (header.uniformCount != uniformCount)
+            throw FormatError("Uniform count mismatch");
+
+        return ProgramBinaryData{header.binaryFormat, programData, locationChunk.getArray<std::int32_t>(uniformCount)};
+    }
+}
+
+#endif // OUZEL_FORMATS_COOKED_HPP
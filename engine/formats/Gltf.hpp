@@ -0,0 +1,397 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_FORMATS_GLTF_HPP
+#define OUZEL_FORMATS_GLTF_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Json.hpp"
+
+namespace ouzel::gltf
+{
+    class ParseError final: public std::logic_error
+    {
+    public:
+        explicit ParseError(const std::string& str): std::logic_error(str) {}
+        explicit ParseError(const char* str): std::logic_error(str) {}
+    };
+
+    enum class ComponentType: std::uint32_t
+    {
+        signedByte = 5120,
+        unsignedByte = 5121,
+        signedShort = 5122,
+        unsignedShort = 5123,
+        unsignedInt = 5125,
+        floatingPoint = 5126
+    };
+
+    inline namespace detail
+    {
+        constexpr std::uint32_t binaryMagic = 0x46546C67; // "glTF"
+        constexpr std::uint32_t jsonChunkType = 0x4E4F534A; // "JSON"
+        constexpr std::uint32_t binaryChunkType = 0x004E4942; // "BIN\0"
+
+        inline std::uint32_t readUInt32(const std::byte* data) noexcept
+        {
+            return static_cast<std::uint32_t>(data[0]) |
+                (static_cast<std::uint32_t>(data[1]) << 8) |
+                (static_cast<std::uint32_t>(data[2]) << 16) |
+                (static_cast<std::uint32_t>(data[3]) << 24);
+        }
+
+        constexpr std::size_t getComponentSize(ComponentType componentType)
+        {
+            switch (componentType)
+            {
+                case ComponentType::signedByte:
+                case ComponentType::unsignedByte: return 1;
+                case ComponentType::signedShort:
+                case ComponentType::unsignedShort: return 2;
+                case ComponentType::unsignedInt:
+                case ComponentType::floatingPoint: return 4;
+                default: throw ParseError("Invalid component type");
+            }
+        }
+
+        inline std::size_t getComponentCount(const std::string& type)
+        {
+            if (type == "SCALAR") return 1;
+            else if (type == "VEC2") return 2;
+            else if (type == "VEC3") return 3;
+            else if (type == "VEC4") return 4;
+            else if (type == "MAT2") return 4;
+            else if (type == "MAT3") return 9;
+            else if (type == "MAT4") return 16;
+            else throw ParseError("Invalid accessor type");
+        }
+    }
+
+    inline std::vector<std::byte> decodeBase64(const std::string& str)
+    {
+        constexpr auto decodeChar = [](char c) -> std::uint32_t {
+            if (c >= 'A' && c <= 'Z') return static_cast<std::uint32_t>(c - 'A');
+            else if (c >= 'a' && c <= 'z') return static_cast<std::uint32_t>(c - 'a' + 26);
+            else if (c >= '0' && c <= '9') return static_cast<std::uint32_t>(c - '0' + 52);
+            else if (c == '+' || c == '-') return 62;
+            else if (c == '/' || c == '_') return 63;
+            else throw ParseError("Invalid base64 character");
+        };
+
+        std::vector<std::byte> result;
+        result.reserve(str.size() * 3 / 4);
+
+        std::uint32_t accumulator = 0;
+        std::uint32_t bits = 0;
+
+        for (const char c : str)
+        {
+            if (c == '=') break;
+
+            accumulator = (accumulator << 6) | decodeChar(c);
+            bits += 6;
+
+            if (bits >= 8)
+            {
+                bits -= 8;
+                result.push_back(static_cast<std::byte>((accumulator >> bits) & 0xFF));
+            }
+        }
+
+        return result;
+    }
+
+    class Accessor final
+    {
+    public:
+        const std::byte* data = nullptr; // nullptr if the accessor has no buffer view (all zeros)
+        std::size_t count = 0;
+        std::size_t stride = 0;
+        ComponentType componentType = ComponentType::floatingPoint;
+        std::size_t componentCount = 0;
+        bool normalized = false;
+
+        bool isTightlyPacked() const noexcept
+        {
+            return stride == getComponentSize(componentType) * componentCount;
+        }
+
+        // Returns the component converted to float, normalized integers are mapped to [0, 1] or [-1, 1]
+        float getFloat(std::size_t element, std::size_t component) const noexcept
+        {
+            if (!data) return 0.0F;
+
+            const std::byte* p = data + element * stride + component * getComponentSize(componentType);
+
+            switch (componentType)
+            {
+                case ComponentType::signedByte:
+                {
+                    const auto value = static_cast<std::int8_t>(p[0]);
+                    return normalized ? std::max(static_cast<float>(value) / 127.0F, -1.0F) : static_cast<float>(value);
+                }
+                case ComponentType::unsignedByte:
+                {
+                    const auto value = static_cast<std::uint8_t>(p[0]);
+                    return normalized ? static_cast<float>(value) / 255.0F : static_cast<float>(value);
+                }
+                case ComponentType::signedShort:
+                {
+                    std::int16_t value;
+                    std::memcpy(&value, p, sizeof(value));
+                    return normalized ? std::max(static_cast<float>(value) / 32767.0F, -1.0F) : static_cast<float>(value);
+                }
+                case ComponentType::unsignedShort:
+                {
+                    std::uint16_t value;
+                    std::memcpy(&value, p, sizeof(value));
+                    return normalized ? static_cast<float>(value) / 65535.0F : static_cast<float>(value);
+                }
+                case ComponentType::unsignedInt:
+                {
+                    std::uint32_t value;
+                    std::memcpy(&value, p, sizeof(value));
+                    return static_cast<float>(value);
+                }
+                case ComponentType::floatingPoint:
+                {
+                    float value;
+                    std::memcpy(&value, p, sizeof(value));
+                    return value;
+                }
+                default:
+                    return 0.0F;
+            }
+        }
+
+        std::uint32_t getUInt(std::size_t element, std::size_t component) const noexcept
+        {
+            if (!data) return 0;
+
+            const std::byte* p = data + element * stride + component * getComponentSize(componentType);
+
+            switch (componentType)
+            {
+                case ComponentType::signedByte:
+                case ComponentType::unsignedByte:
+                    return static_cast<std::uint8_t>(p[0]);
+                case ComponentType::signedShort:
+                case ComponentType::unsignedShort:
+                {
+                    std::uint16_t value;
+                    std::memcpy(&value, p, sizeof(value));
+                    return value;
+                }
+                case ComponentType::unsignedInt:
+                {
+                    std::uint32_t value;
+                    std::memcpy(&value, p, sizeof(value));
+                    return value;
+                }
+                case ComponentType::floatingPoint:
+                {
+                    float value;
+                    std::memcpy(&value, p, sizeof(value));
+                    return static_cast<std::uint32_t>(value);
+                }
+                default:
+                    return 0;
+            }
+        }
+    };
+
+    // glTF 2.0 document
+    // The binary chunk of a .glb file is referenced in place, so the data passed to the
+    // constructor must outlive the document and all the accessors returned by it
+    // The document can't be copied, because the buffers point to the data owned by it
+    class Document final
+    {
+    public:
+        using FileLoader = std::function<std::vector<std::byte>(const std::string&)>;
+
+        explicit Document(const std::vector<std::byte>& data,
+                          const FileLoader& loadFile = nullptr):
+            Document(data.data(), data.size(), loadFile)
+        {
+        }
+
+        Document(const std::byte* data, std::size_t size,
+                 const FileLoader& loadFile = nullptr)
+        {
+            const std::byte* binaryChunk = nullptr;
+            std::size_t binaryChunkSize = 0;
+
+            if (size >= 12 && readUInt32(data) == binaryMagic)
+            {
+                binary = true;
+
+                if (readUInt32(data + 4) != 2)
+                    throw ParseError("Unsupported glTF version");
+
+                const std::size_t length = readUInt32(data + 8);
+                if (length > size)
+                    throw ParseError("Invalid glTF length");
+
+                std::size_t offset = 12;
+                bool jsonFound = false;
+
+                while (offset + 8 <= length)
+                {
+                    const std::size_t chunkLength = readUInt32(data + offset);
+                    const std::uint32_t chunkType = readUInt32(data + offset + 4);
+                    offset += 8;
+
+                    if (offset + chunkLength > length)
+                        throw ParseError("Invalid chunk length");
+
+                    if (chunkType == jsonChunkType && !jsonFound)
+                    {
+                        root = json::parse(data + offset, data + offset + chunkLength);
+                        jsonFound = true;
+                    }
+                    else if (chunkType == binaryChunkType && !binaryChunk)
+                    {
+                        binaryChunk = data + offset;
+                        binaryChunkSize = chunkLength;
+                    }
+
+                    // chunks are aligned to 4 bytes
+                    offset += (chunkLength + 3) & ~std::size_t(3);
+                }
+
+                if (!jsonFound)
+                    throw ParseError("JSON chunk not found");
+            }
+            else
+                root = json::parse(data, data + size);
+
+            if (!root.hasMember("asset") ||
+                root["asset"]["version"].as<std::string>().compare(0, 2, "2.") != 0)
+                throw ParseError("Unsupported glTF version");
+
+            if (root.hasMember("buffers"))
+            {
+                const auto& buffersValue = root["buffers"];
+                buffers.reserve(buffersValue.getSize());
+
+                for (const json::Value& bufferValue : buffersValue)
+                {
+                    const auto byteLength = bufferValue["byteLength"].as<std::size_t>();
+
+                    if (!bufferValue.hasMember("uri"))
+                    {
+                        // the first buffer without an URI is the binary chunk
+                        if (!binaryChunk || buffers.size() != 0 || byteLength > binaryChunkSize)
+                            throw ParseError("Invalid binary buffer");
+
+                        buffers.emplace_back(binaryChunk, byteLength);
+                        continue;
+                    }
+
+                    const auto& uri = bufferValue["uri"].as<std::string>();
+                    std::vector<std::byte> bufferData;
+
+                    if (uri.compare(0, 5, "data:") == 0)
+                    {
+                        const auto comma = uri.find(',');
+                        if (comma == std::string::npos || uri.rfind(";base64", comma) == std::string::npos)
+                            throw ParseError("Unsupported data URI");
+
+                        bufferData = decodeBase64(uri.substr(comma + 1));
+                    }
+                    else if (loadFile)
+                        bufferData = loadFile(uri);
+                    else
+                        throw ParseError("External buffers are not supported");
+
+                    if (bufferData.size() < byteLength)
+                        throw ParseError("Buffer is too short");
+
+                    ownedBuffers.push_back(std::move(bufferData));
+                    buffers.emplace_back(ownedBuffers.back().data(), byteLength);
+                }
+            }
+        }
+
+        Document(const Document&) = delete;
+        Document& operator=(const Document&) = delete;
+
+        // moving the vectors keeps the data of the owned buffers in place
+        Document(Document&&) = default;
+        Document& operator=(Document&&) = default;
+
+        auto isBinary() const noexcept { return binary; }
+        auto& getRoot() const noexcept { return root; }
+
+        std::size_t getCount(const std::string& member) const
+        {
+            return root.hasMember(member) ? root[member].getSize() : 0;
+        }
+
+        std::pair<const std::byte*, std::size_t> getBufferView(std::size_t index) const
+        {
+            const auto& bufferViewValue = root["bufferViews"][index];
+            const auto buffer = bufferViewValue["buffer"].as<std::size_t>();
+            const auto byteOffset = bufferViewValue.hasMember("byteOffset") ? bufferViewValue["byteOffset"].as<std::size_t>() : 0;
+            const auto byteLength = bufferViewValue["byteLength"].as<std::size_t>();
+
+            if (buffer >= buffers.size())
+                throw ParseError("Invalid buffer index");
+
+            if (byteOffset + byteLength > buffers[buffer].second)
+                throw ParseError("Buffer view out of range");
+
+            return std::pair(buffers[buffer].first + byteOffset, byteLength);
+        }
+
+        Accessor getAccessor(std::size_t index) const
+        {
+            const auto& accessorValue = root["accessors"][index];
+
+            if (accessorValue.hasMember("sparse"))
+                throw ParseError("Sparse accessors are not supported");
+
+            Accessor accessor;
+            accessor.count = accessorValue["count"].as<std::size_t>();
+            accessor.componentType = static_cast<ComponentType>(accessorValue["componentType"].as<std::uint32_t>());
+            accessor.componentCount = getComponentCount(accessorValue["type"].as<std::string>());
+            accessor.normalized = accessorValue.hasMember("normalized") && accessorValue["normalized"].as<bool>();
+
+            const auto elementSize = getComponentSize(accessor.componentType) * accessor.componentCount;
+            accessor.stride = elementSize;
+
+            if (accessorValue.hasMember("bufferView"))
+            {
+                const auto bufferViewIndex = accessorValue["bufferView"].as<std::size_t>();
+                const auto& bufferViewValue = root["bufferViews"][bufferViewIndex];
+                const auto bufferView = getBufferView(bufferViewIndex);
+                const auto byteOffset = accessorValue.hasMember("byteOffset") ? accessorValue["byteOffset"].as<std::size_t>() : 0;
+
+                if (bufferViewValue.hasMember("byteStride"))
+                    accessor.stride = bufferViewValue["byteStride"].as<std::size_t>();
+
+                if (accessor.count &&
+                    byteOffset + (accessor.count - 1) * accessor.stride + elementSize > bufferView.second)
+                    throw ParseError("Accessor out of range");
+
+                accessor.data = bufferView.first + byteOffset;
+            }
+
+            return accessor;
+        }
+
+    private:
+        bool binary = false;
+        json::Value root;
+        std::vector<std::pair<const std::byte*, std::size_t>> buffers;
+        std::vector<std::vector<std::byte>> ownedBuffers;
+    };
+}
+
+#endif // OUZEL_FORMATS_GLTF_HPP
@@ -0,0 +1,109 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_FORMATS_MO_HPP
+#define OUZEL_FORMATS_MO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// GNU gettext machine object (.mo) files
+namespace ouzel::mo
+{
+    class ParseError final: public std::runtime_error
+    {
+    public:
+        explicit ParseError(const std::string& str): std::runtime_error(str) {}
+        explicit ParseError(const char* str): std::runtime_error(str) {}
+    };
+
+    class Document final
+    {
+    public:
+        struct Translation final
+        {
+            std::string original;
+            std::string translation;
+        };
+
+        Document(const std::byte* data, std::size_t size)
+        {
+            constexpr std::uint32_t magicBig = 0xDE120495U;
+            constexpr std::uint32_t magicLittle = 0x950412DEU;
+
+            if (size < 5 * sizeof(std::uint32_t))
+                throw ParseError("Not enough data");
+
+            const auto magic = decodeUInt32(data, false);
+
+            bool bigEndian;
+            if (magic == magicBig)
+                bigEndian = true;
+            else if (magic == magicLittle)
+                bigEndian = false;
+            else
+                throw ParseError("Wrong magic " + std::to_string(magic));
+
+            const std::size_t revisionOffset = sizeof(magic);
+            const std::uint32_t revision = decodeUInt32(data + revisionOffset, bigEndian);
+
+            if (revision != 0)
+                throw ParseError("Unsupported revision " + std::to_string(revision));
+
+            const std::size_t stringCountOffset = revisionOffset + sizeof(revision);
+            const std::uint32_t stringCount = decodeUInt32(data + stringCountOffset, bigEndian);
+
+            const std::size_t stringsOffsetOffset = stringCountOffset + sizeof(stringCount);
+            const std::size_t stringsOffset = decodeUInt32(data + stringsOffsetOffset, bigEndian);
+
+            const std::size_t translationsOffsetOffset = stringsOffsetOffset + sizeof(std::uint32_t);
+            const std::size_t translationsOffset = decodeUInt32(data + translationsOffsetOffset, bigEndian);
+
+            const std::size_t tableSize = 2 * sizeof(std::uint32_t) * stringCount;
+
+            if (size < stringsOffset + tableSize || size < translationsOffset + tableSize)
+                throw ParseError("Not enough data");
+
+            const auto readString = [data, size, bigEndian](std::size_t descriptorOffset) {
+                const std::size_t length = decodeUInt32(data + descriptorOffset, bigEndian);
+                const std::size_t offset = decodeUInt32(data + descriptorOffset + sizeof(std::uint32_t), bigEndian);
+
+                if (size < offset + length)
+                    throw ParseError("Not enough data");
+
+                return std::string(reinterpret_cast<const char*>(data + offset), length);
+            };
+
+            translations.reserve(stringCount);
+
+            for (std::size_t i = 0; i < stringCount; ++i)
+                translations.push_back(Translation{
+                    readString(stringsOffset + 2 * sizeof(std::uint32_t) * i),
+                    readString(translationsOffset + 2 * sizeof(std::uint32_t) * i)
+                });
+        }
+
+        auto& getTranslations() const noexcept { return translations; }
+
+    private:
+        static std::uint32_t decodeUInt32(const std::byte* bytes, bool bigEndian) noexcept
+        {
+            if (bigEndian)
+                return static_cast<std::uint32_t>(bytes[3]) |
+                    (static_cast<std::uint32_t>(bytes[2]) << 8) |
+                    (static_cast<std::uint32_t>(bytes[1]) << 16) |
+                    (static_cast<std::uint32_t>(bytes[0]) << 24);
+            else
+                return static_cast<std::uint32_t>(bytes[0]) |
+                    (static_cast<std::uint32_t>(bytes[1]) << 8) |
+                    (static_cast<std::uint32_t>(bytes[2]) << 16) |
+                    (static_cast<std::uint32_t>(bytes[3]) << 24);
+        }
+
+        std::vector<Translation> translations;
+    };
+}
+
+#endif // OUZEL_FORMATS_MO_HPP
@@ -0,0 +1,411 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_FORMATS_OBJ_HPP
+#define OUZEL_FORMATS_OBJ_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "TextParser.hpp"
+#include "../graphics/Vertex.hpp"
+#include "../math/Box.hpp"
+#include "../thread/Thread.hpp"
+
+namespace ouzel::obj
+{
+    using ParseError = text::ParseError;
+
+    namespace detail
+    {
+        // files smaller than this are parsed on the calling thread
+        constexpr std::size_t minChunkSize = 1024U * 1024U;
+
+        template <std::size_t N>
+        Vector<N, float> parseVector(const char*& iterator, const char* end)
+        {
+            Vector<N, float> result;
+
+            for (float& component : result.v)
+            {
+                text::skipWhitespaces(iterator, end);
+                component = text::parseFloat(iterator, end);
+            }
+
+            text::skipLine(iterator, end);
+
+            return result;
+        }
+
+        struct Attributes final
+        {
+            std::vector<Vector3F> positions;
+            std::vector<Vector2F> texCoords;
+            std::vector<Vector3F> normals;
+        };
+
+        // Parses only the v, vt and vn records, which don't depend on each other,
+        // so the file can be split into line aligned chunks and parsed in parallel
+        inline void parseAttributes(const char* iterator, const char* end, Attributes& attributes)
+        {
+            while (iterator != end)
+            {
+                if (text::isNewline(*iterator))
+                    ++iterator;
+                else if (*iterator == '#')
+                    text::skipLine(iterator, end);
+                else
+                {
+                    text::skipWhitespaces(iterator, end);
+                    if (iterator == end) break;
+                    if (text::isNewline(*iterator)) continue;
+
+                    const auto keyword = text::parseString(iterator, end);
+
+                    if (keyword == "v")
+                        attributes.positions.push_back(parseVector<3>(iterator, end));
+                    else if (keyword == "vt")
+                        attributes.texCoords.push_back(parseVector<2>(iterator, end));
+                    else if (keyword == "vn")
+                        attributes.normals.push_back(parseVector<3>(iterator, end));
+                    else
+                        text::skipLine(iterator, end);
+                }
+            }
+        }
+
+        inline Attributes parseAllAttributes(const char* begin, const char* end,
+                                             std::size_t threadCount = std::max(std::thread::hardware_concurrency(), 1U))
+        {
+            const auto size = static_cast<std::size_t>(end - begin);
+            const std::size_t chunkCount = std::clamp(size / minChunkSize, std::size_t(1), threadCount);
+
+            std::vector<Attributes> chunks(chunkCount);
+            std::vector<std::exception_ptr> exceptions(chunkCount);
+
+            {
+                std::vector<const char*> boundaries{begin};
+                for (std::size_t i = 1; i < chunkCount; ++i)
+                {
+                    const char* boundary = std::max(begin + size * i / chunkCount, boundaries.back());
+                    text::skipLine(boundary, end);
+                    boundaries.push_back(boundary);
+                }
+                boundaries.push_back(end);
+
+                const auto parseChunk = [&chunks, &exceptions, &boundaries](std::size_t chunk) noexcept {
+                    try
+                    {
+                        parseAttributes(boundaries[chunk], boundaries[chunk + 1], chunks[chunk]);
+                    }
+                    catch (...)
+                    {
+                        exceptions[chunk] = std::current_exception();
+                    }
+                };
+
+                std::vector<thread::Thread> threads;
+                for (std::size_t chunk = 1; chunk < chunkCount; ++chunk)
+                    threads.emplace_back(parseChunk, chunk);
+
+                parseChunk(0);
+                // the threads are joined when they go out of scope
+            }
+
+            for (const auto& exception : exceptions)
+                if (exception) std::rethrow_exception(exception);
+
+            if (chunkCount == 1) return std::move(chunks.front());
+
+            Attributes result;
+            std::size_t positionCount = 0;
+            std::size_t texCoordCount = 0;
+            std::size_t normalCount = 0;
+
+            for (const auto& chunk : chunks)
+            {
+                positionCount += chunk.positions.size();
+                texCoordCount += chunk.texCoords.size();
+                normalCount += chunk.normals.size();
+            }
+
+            result.positions.reserve(positionCount);
+            result.texCoords.reserve(texCoordCount);
+            result.normals.reserve(normalCount);
+
+            for (const auto& chunk : chunks)
+            {
+                result.positions.insert(result.positions.end(), chunk.positions.begin(), chunk.positions.end());
+                result.texCoords.insert(result.texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+                result.normals.insert(result.normals.end(), chunk.normals.begin(), chunk.normals.end());
+            }
+
+            return result;
+        }
+
+        // Open addressing hash table that maps (position, texture coordinate, normal) index triplets to vertex indices
+        class VertexMap final
+        {
+        public:
+            VertexMap(): entries(initialCapacity) {}
+
+            // Returns the existing vertex index or inserts the new one
+            std::pair<std::uint32_t, bool> insert(std::uint32_t position,
+                                                  std::uint32_t texCoord,
+                                                  std::uint32_t normal,
+                                                  std::uint32_t index)
+            {
+                if ((size + 1) * 2 > entries.size()) grow();
+
+                Entry& entry = find(position, texCoord, normal);
+                if (entry.position) return std::pair(entry.index, false);
+
+                entry = Entry{position, texCoord, normal, index};
+                ++size;
+                return std::pair(index, true);
+            }
+
+            void clear() noexcept
+            {
+                std::fill(entries.begin(), entries.end(), Entry{});
+                size = 0;
+            }
+
+        private:
+            static constexpr std::size_t initialCapacity = 1024U;
+
+            struct Entry final
+            {
+                std::uint32_t position = 0; // zero marks an empty slot, OBJ indices start at one
+                std::uint32_t texCoord = 0;
+                std::uint32_t normal = 0;
+                std::uint32_t index = 0;
+            };
+
+            static constexpr std::size_t hash(std::uint32_t position,
+                                              std::uint32_t texCoord,
+                                              std::uint32_t normal) noexcept
+            {
+                std::uint64_t result = position * 0x9E3779B97F4A7C15ULL;
+                result ^= (texCoord + 0x632BE59BD9B4E019ULL) * 0xBF58476D1CE4E5B9ULL;
+                result ^= (normal + 0x85EBCA77C2B2AE63ULL) * 0x94D049BB133111EBULL;
+                return static_cast<std::size_t>(result ^ (result >> 31));
+            }
+
+            Entry& find(std::uint32_t position,
+                        std::uint32_t texCoord,
+                        std::uint32_t normal) noexcept
+            {
+                const std::size_t mask = entries.size() - 1;
+
+                for (std::size_t i = hash(position, texCoord, normal) & mask;; i = (i + 1) & mask)
+                {
+                    Entry& entry = entries[i];
+                    if (!entry.position ||
+                        (entry.position == position && entry.texCoord == texCoord && entry.normal == normal))
+                        return entry;
+                }
+            }
+
+            void grow()
+            {
+                std::vector<Entry> oldEntries(entries.size() * 2);
+                oldEntries.swap(entries);
+
+                for (const auto& oldEntry : oldEntries)
+                    if (oldEntry.position)
+                        find(oldEntry.position, oldEntry.texCoord, oldEntry.normal) = oldEntry;
+            }
+
+            std::vector<Entry> entries;
+            std::size_t size = 0;
+        };
+
+        inline std::uint32_t resolveIndex(std::int32_t index, std::size_t count, const char* error)
+        {
+            // negative indices are relative to the end of the list
+            if (index < 0) index = static_cast<std::int32_t>(count) + index + 1;
+
+            if (index < 1 || index > static_cast<std::int32_t>(count))
+                throw ParseError(error);
+
+            return static_cast<std::uint32_t>(index);
+        }
+    }
+
+    struct Object final
+    {
+        std::string name; // empty for the geometry before the first "o" record
+        std::string material;
+        Box3F boundingBox;
+        std::vector<graphics::Vertex> vertices;
+        std::vector<std::uint32_t> indices;
+    };
+
+    class Document final
+    {
+    public:
+        Document(const std::byte* data, std::size_t size)
+        {
+            const char* begin = reinterpret_cast<const char*>(data);
+            const char* end = begin + size;
+
+            const auto attributes = detail::parseAllAttributes(begin, end);
+
+            Object object;
+            detail::VertexMap vertexMap;
+            std::vector<std::uint32_t> vertexIndices;
+
+            // number of attributes declared so far, faces can only reference these
+            std::size_t positionCount = 0;
+            std::size_t texCoordCount = 0;
+            std::size_t normalCount = 0;
+
+            std::uint32_t objectCount = 0;
+
+            auto iterator = begin;
+
+            while (iterator != end)
+            {
+                if (text::isNewline(*iterator))
+                {
+                    // skip empty lines
+                    ++iterator;
+                }
+                else if (*iterator == '#')
+                {
+                    // skip the comment
+                    text::skipLine(iterator, end);
+                }
+                else
+                {
+                    text::skipWhitespaces(iterator, end);
+                    if (iterator == end) break;
+                    if (text::isNewline(*iterator)) continue;
+
+                    const auto keyword = text::parseString(iterator, end);
+
+                    if (keyword == "v")
+                    {
+                        ++positionCount;
+                        text::skipLine(iterator, end);
+                    }
+                    else if (keyword == "vt")
+                    {
+                        ++texCoordCount;
+                        text::skipLine(iterator, end);
+                    }
+                    else if (keyword == "vn")
+                    {
+                        ++normalCount;
+                        text::skipLine(iterator, end);
+                    }
+                    else if (keyword == "f")
+                    {
+                        vertexIndices.clear();
+
+                        for (;;)
+                        {
+                            text::skipWhitespaces(iterator, end);
+                            if (iterator == end || text::isNewline(*iterator)) break;
+
+                            const auto positionIndex = detail::resolveIndex(text::parseInt32(iterator, end), positionCount,
+                                                                            "Invalid position index");
+                            std::uint32_t texCoordIndex = 0;
+                            std::uint32_t normalIndex = 0;
+
+                            // has texture coordinates
+                            if (text::parseToken(iterator, end, '/'))
+                            {
+                                // two slashes in a row indicates no texture coordinates
+                                if (iterator != end && *iterator != '/')
+                                    texCoordIndex = detail::resolveIndex(text::parseInt32(iterator, end), texCoordCount,
+                                                                         "Invalid texture coordinate index");
+
+                                // has normal
+                                if (text::parseToken(iterator, end, '/'))
+                                    normalIndex = detail::resolveIndex(text::parseInt32(iterator, end), normalCount,
+                                                                       "Invalid normal index");
+                            }
+
+                            const auto [index, inserted] = vertexMap.insert(positionIndex, texCoordIndex, normalIndex,
+                                                                            static_cast<std::uint32_t>(object.vertices.size()));
+
+                            if (inserted)
+                            {
+                                graphics::Vertex vertex;
+                                vertex.position = attributes.positions[positionIndex - 1];
+                                if (texCoordIndex) vertex.texCoords[0] = attributes.texCoords[texCoordIndex - 1];
+                                vertex.color = Color::white();
+                                if (normalIndex) vertex.normal = attributes.normals[normalIndex - 1];
+                                object.vertices.push_back(vertex);
+                                object.boundingBox.insertPoint(vertex.position);
+                            }
+
+                            vertexIndices.push_back(index);
+                        }
+
+                        if (vertexIndices.size() < 3)
+                            throw ParseError("Invalid face count");
+
+                        // triangulate polygons as a fan
+                        for (std::size_t index = 0; index < vertexIndices.size() - 2; ++index)
+                        {
+                            object.indices.push_back(vertexIndices[0]);
+                            object.indices.push_back(vertexIndices[index + 1]);
+                            object.indices.push_back(vertexIndices[index + 2]);
+                        }
+                    }
+                    else if (keyword == "mtllib")
+                    {
+                        text::skipWhitespaces(iterator, end);
+                        materialLibraries.emplace_back(text::parseString(iterator, end));
+
+                        text::skipLine(iterator, end);
+                    }
+                    else if (keyword == "usemtl")
+                    {
+                        text::skipWhitespaces(iterator, end);
+                        object.material = std::string(text::parseString(iterator, end));
+
+                        text::skipLine(iterator, end);
+                    }
+                    else if (keyword == "o")
+                    {
+                        if (objectCount)
+                            objects.push_back(std::move(object));
+
+                        object = Object();
+
+                        text::skipWhitespaces(iterator, end);
+                        object.name = std::string(text::parseString(iterator, end));
+
+                        text::skipLine(iterator, end);
+
+                        vertexMap.clear();
+                        ++objectCount;
+                    }
+                    else
+                    {
+                        // skip all unknown commands
+                        text::skipLine(iterator, end);
+                    }
+
+                    if (!objectCount) ++objectCount; // if we got at least one attribute, we have an object
+                }
+            }
+
+            if (objectCount)
+                objects.push_back(std::move(object));
+        }
+
+        std::vector<std::string> materialLibraries;
+        std::vector<Object> objects;
+    };
+}
+
+#endif // OUZEL_FORMATS_OBJ_HPP
@@ -0,0 +1,98 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_FORMATS_TEXTPARSER_HPP
+#define OUZEL_FORMATS_TEXTPARSER_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Helpers for the line based text formats (OBJ, MTL), all of them advance the iterator past the parsed data
+namespace ouzel::text
+{
+    class ParseError final: public std::logic_error
+    {
+    public:
+        explicit ParseError(const std::string& str): std::logic_error(str) {}
+        explicit ParseError(const char* str): std::logic_error(str) {}
+    };
+
+    constexpr auto isWhitespace(char c)
+    {
+        return c == ' ' || c == '\t';
+    }
+
+    constexpr auto isNewline(char c)
+    {
+        return c == '\r' || c == '\n';
+    }
+
+    constexpr auto isControlChar(char c)
+    {
+        return static_cast<std::uint8_t>(c) <= 0x1F;
+    }
+
+    inline void skipWhitespaces(const char*& iterator, const char* end) noexcept
+    {
+        while (iterator != end && isWhitespace(*iterator))
+            ++iterator;
+    }
+
+    inline void skipLine(const char*& iterator, const char* end) noexcept
+    {
+        while (iterator != end)
+            if (isNewline(*iterator++))
+                break;
+    }
+
+    inline std::string_view parseString(const char*& iterator, const char* end)
+    {
+        const char* start = iterator;
+
+        while (iterator != end && !isControlChar(*iterator) && !isWhitespace(*iterator))
+            ++iterator;
+
+        if (iterator == start)
+            throw ParseError("Invalid string");
+
+        return std::string_view(start, static_cast<std::size_t>(iterator - start));
+    }
+
+    inline std::int32_t parseInt32(const char*& iterator, const char* end)
+    {
+        std::int32_t result;
+        const auto [pointer, error] = std::from_chars(iterator, end, result);
+        if (error != std::errc())
+            throw ParseError("Invalid integer");
+
+        iterator = pointer;
+        return result;
+    }
+
+    inline float parseFloat(const char*& iterator, const char* end)
+    {
+        if (iterator != end && *iterator == '+') ++iterator; // from_chars doesn't accept the plus sign
+
+        float result;
+        const auto [pointer, error] = std::from_chars(iterator, end, result);
+        if (error != std::errc())
+            throw ParseError("Invalid float");
+
+        iterator = pointer;
+        return result;
+    }
+
+    inline bool parseToken(const char*& iterator, const char* end, char token) noexcept
+    {
+        if (iterator == end || *iterator != token) return false;
+
+        ++iterator;
+
+        return true;
+    }
+}
+
+#endif // OUZEL_FORMATS_TEXTPARSER_HPP
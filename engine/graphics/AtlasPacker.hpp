@@ -0,0 +1,192 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_ATLASPACKER_HPP
+#define OUZEL_GRAPHICS_ATLASPACKER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "../math/Rect.hpp"
+#include "../math/Size.hpp"
+
+namespace ouzel::graphics
+{
+    // MaxRects bin packer (best short side fit), opens a new page when an image does not fit on the existing ones
+    // Every image is surrounded by its extruded edge pixels and separated from its neighbours by the padding,
+    // so that the filtering and the smaller mip levels don't sample the neighbouring images
+    class AtlasPacker final
+    {
+    public:
+        struct Region final
+        {
+            std::size_t page;
+            Rect<std::uint32_t> rectangle; // position and size of the image, without the extrusion
+        };
+
+        AtlasPacker(const Size2U& initPageSize,
+                    std::uint32_t initPadding = 2,
+                    std::uint32_t initExtrusion = 2):
+            pageSize(initPageSize), padding(initPadding), extrusion(initExtrusion)
+        {
+            if (pageSize.v[0] == 0 || pageSize.v[1] == 0)
+                throw std::runtime_error("Invalid atlas page size");
+        }
+
+        Region pack(const Size2U& size)
+        {
+            // the padding after the images on the last row and column of the page is outside of it
+            const std::uint32_t width = size.v[0] + 2 * extrusion + padding;
+            const std::uint32_t height = size.v[1] + 2 * extrusion + padding;
+
+            if (size.v[0] == 0 || size.v[1] == 0 ||
+                width > pageSize.v[0] + padding || height > pageSize.v[1] + padding)
+                throw std::runtime_error("Image does not fit in an atlas page");
+
+            for (std::size_t page = 0; page < pages.size(); ++page)
+                if (const auto rectangle = place(pages[page], width, height); rectangle.size.v[0] != 0)
+                    return Region{page, imageRectangle(rectangle, size)};
+
+            pages.push_back({Rect<std::uint32_t>(pageSize.v[0] + padding, pageSize.v[1] + padding)});
+            const auto rectangle = place(pages.back(), width, height);
+            return Region{pages.size() - 1, imageRectangle(rectangle, size)};
+        }
+
+        auto& getPageSize() const noexcept { return pageSize; }
+        auto getPageCount() const noexcept { return pages.size(); }
+        auto getPadding() const noexcept { return padding; }
+        auto getExtrusion() const noexcept { return extrusion; }
+
+    private:
+        using FreeRectangles = std::vector<Rect<std::uint32_t>>;
+
+        Rect<std::uint32_t> imageRectangle(const Rect<std::uint32_t>& rectangle, const Size2U& size) const noexcept
+        {
+            return Rect<std::uint32_t>(rectangle.position.v[0] + extrusion,
+                                       rectangle.position.v[1] + extrusion,
+                                       size.v[0], size.v[1]);
+        }
+
+        // Returns an empty rectangle if there is no space left
+        static Rect<std::uint32_t> place(FreeRectangles& freeRectangles, std::uint32_t width, std::uint32_t height)
+        {
+            auto bestShortSide = std::numeric_limits<std::uint32_t>::max();
+            auto bestLongSide = std::numeric_limits<std::uint32_t>::max();
+            Rect<std::uint32_t> result;
+
+            for (const auto& freeRectangle : freeRectangles)
+                if (freeRectangle.size.v[0] >= width && freeRectangle.size.v[1] >= height)
+                {
+                    const auto leftoverX = freeRectangle.size.v[0] - width;
+                    const auto leftoverY = freeRectangle.size.v[1] - height;
+                    const auto shortSide = std::min(leftoverX, leftoverY);
+                    const auto longSide = std::max(leftoverX, leftoverY);
+
+                    if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide))
+                    {
+                        bestShortSide = shortSide;
+                        bestLongSide = longSide;
+                        result = Rect<std::uint32_t>(freeRectangle.position, Size2U(width, height));
+                    }
+                }
+
+            if (result.size.v[0] == 0) return result;
+
+            // split all the free rectangles that overlap the placed one
+            FreeRectangles newRectangles;
+            for (auto i = freeRectangles.begin(); i != freeRectangles.end();)
+                if (split(*i, result, newRectangles))
+                    i = freeRectangles.erase(i);
+                else
+                    ++i;
+
+            freeRectangles.insert(freeRectangles.end(), newRectangles.begin(), newRectangles.end());
+            prune(freeRectangles);
+
+            return result;
+        }
+
+        static bool split(const Rect<std::uint32_t>& freeRectangle, const Rect<std::uint32_t>& used,
+                          FreeRectangles& newRectangles)
+        {
+            const auto freeLeft = freeRectangle.position.v[0];
+            const auto freeTop = freeRectangle.position.v[1];
+            const auto freeRight = freeLeft + freeRectangle.size.v[0];
+            const auto freeBottom = freeTop + freeRectangle.size.v[1];
+            const auto usedLeft = used.position.v[0];
+            const auto usedTop = used.position.v[1];
+            const auto usedRight = usedLeft + used.size.v[0];
+            const auto usedBottom = usedTop + used.size.v[1];
+
+            if (usedLeft >= freeRight || usedRight <= freeLeft ||
+                usedTop >= freeBottom || usedBottom <= freeTop)
+                return false;
+
+            if (usedLeft > freeLeft)
+                newRectangles.emplace_back(freeLeft, freeTop, usedLeft - freeLeft, freeRectangle.size.v[1]);
+            if (usedRight < freeRight)
+                newRectangles.emplace_back(usedRight, freeTop, freeRight - usedRight, freeRectangle.size.v[1]);
+            if (usedTop > freeTop)
+                newRectangles.emplace_back(freeLeft, freeTop, freeRectangle.size.v[0], usedTop - freeTop);
+            if (usedBottom < freeBottom)
+                newRectangles.emplace_back(freeLeft, usedBottom, freeRectangle.size.v[0], freeBottom - usedBottom);
+
+            return true;
+        }
+
+        // Removes the free rectangles that are contained in other free rectangles
+        static void prune(FreeRectangles& freeRectangles)
+        {
+            for (std::size_t i = 0; i < freeRectangles.size(); ++i)
+                for (std::size_t j = i + 1; j < freeRectangles.size();)
+                    if (freeRectangles[i].contains(freeRectangles[j]))
+                        freeRectangles.erase(freeRectangles.begin() + static_cast<std::ptrdiff_t>(j));
+                    else if (freeRectangles[j].contains(freeRectangles[i]))
+                    {
+                        freeRectangles.erase(freeRectangles.begin() + static_cast<std::ptrdiff_t>(i));
+                        j = i + 1;
+                    }
+                    else
+                        ++j;
+        }
+
+        Size2U pageSize;
+        std::uint32_t padding;
+        std::uint32_t extrusion;
+        std::vector<FreeRectangles> pages;
+    };
+
+    // Copies a 32-bit per pixel image to the page and repeats its edge pixels extrusion times around it
+    inline void copyToAtlasPage(std::uint8_t* page, const Size2U& pageSize,
+                                const std::uint8_t* image, const Size2U& imageSize,
+                                const Rect<std::uint32_t>& rectangle, std::uint32_t extrusion) noexcept
+    {
+        constexpr std::size_t pixelSize = 4;
+
+        const auto left = rectangle.position.v[0] - extrusion;
+        const auto top = rectangle.position.v[1] - extrusion;
+        const auto right = std::min(rectangle.position.v[0] + imageSize.v[0] + extrusion, pageSize.v[0]);
+        const auto bottom = std::min(rectangle.position.v[1] + imageSize.v[1] + extrusion, pageSize.v[1]);
+
+        for (auto y = top; y < bottom; ++y)
+        {
+            const auto sourceY = std::min(y - std::min(y, rectangle.position.v[1]), imageSize.v[1] - 1);
+            const std::uint8_t* sourceRow = image + sourceY * imageSize.v[0] * pixelSize;
+            std::uint8_t* row = page + y * pageSize.v[0] * pixelSize;
+
+            for (auto x = left; x < rectangle.position.v[0]; ++x)
+                std::memcpy(row + x * pixelSize, sourceRow, pixelSize);
+
+            std::memcpy(row + rectangle.position.v[0] * pixelSize, sourceRow,
+                        std::min(imageSize.v[0], pageSize.v[0] - rectangle.position.v[0]) * pixelSize);
+
+            for (auto x = rectangle.position.v[0] + imageSize.v[0]; x < right; ++x)
+                std::memcpy(row + x * pixelSize, sourceRow + (imageSize.v[0] - 1) * pixelSize, pixelSize);
+        }
+    }
+}
+
+#endif // OUZEL_GRAPHICS_ATLASPACKER_HPP
@@ -0,0 +1,902 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include "CommandCapture.hpp"
+#include "RenderDevice.hpp"
+
+namespace ouzel::graphics
+{
+    namespace
+    {
+        constexpr char captureMagic[4] = {'O', 'U', 'Z', 'R'}; // the cooked assets use OUZC
+        constexpr std::uint64_t captureVersion = 3;
+
+        class Encoder final
+        {
+        public:
+            explicit Encoder(std::vector<std::uint8_t>& initData) noexcept:
+                data(initData)
+            {
+            }
+
+            void writeUInt(std::uint64_t value)
+            {
+                do
+                {
+                    auto byte = static_cast<std::uint8_t>(value & 0x7F);
+                    value >>= 7;
+                    if (value) byte |= 0x80;
+                    data.push_back(byte);
+                }
+                while (value);
+            }
+
+            template <class T>
+            void writeEnum(T value)
+            {
+                writeUInt(static_cast<std::uint64_t>(value));
+            }
+
+            void writeBool(bool value)
+            {
+                data.push_back(value ? 1 : 0);
+            }
+
+            void writeFloat(float value)
+            {
+                std::uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+
+                data.push_back(static_cast<std::uint8_t>(bits & 0xFF));
+                data.push_back(static_cast<std::uint8_t>((bits >> 8) & 0xFF));
+                data.push_back(static_cast<std::uint8_t>((bits >> 16) & 0xFF));
+                data.push_back(static_cast<std::uint8_t>((bits >> 24) & 0xFF));
+            }
+
+            void writeBytes(const std::vector<std::uint8_t>& bytes)
+            {
+                writeUInt(bytes.size());
+                data.insert(data.end(), bytes.begin(), bytes.end());
+            }
+
+            void writeString(const std::string& str)
+            {
+                writeUInt(str.size());
+                data.insert(data.end(), str.begin(), str.end());
+            }
+
+            void writeColor(Color color)
+            {
+                data.insert(data.end(), color.v.begin(), color.v.end());
+            }
+
+            void writeSize(const Size2U& size)
+            {
+                writeUInt(size.v[0]);
+                writeUInt(size.v[1]);
+            }
+
+            void writeRect(const RectF& rect)
+            {
+                writeFloat(rect.position.v[0]);
+                writeFloat(rect.position.v[1]);
+                writeFloat(rect.size.v[0]);
+                writeFloat(rect.size.v[1]);
+            }
+
+            void writeLevels(const std::vector<std::pair<Size2U, std::vector<std::uint8_t>>>& levels)
+            {
+                writeUInt(levels.size());
+                for (const auto& level : levels)
+                {
+                    writeSize(level.first);
+                    writeBytes(level.second);
+                }
+            }
+
+            void writeConstantInfo(const std::vector<std::pair<std::string, DataType>>& constantInfo)
+            {
+                writeUInt(constantInfo.size());
+                for (const auto& constant : constantInfo)
+                {
+                    writeString(constant.first);
+                    writeEnum(constant.second);
+                }
+            }
+
+            void writeConstants(const std::vector<std::vector<float>>& constants)
+            {
+                writeUInt(constants.size());
+                for (const auto& constant : constants)
+                {
+                    writeUInt(constant.size());
+                    for (const float value : constant)
+                        writeFloat(value);
+                }
+            }
+
+        private:
+            std::vector<std::uint8_t>& data;
+        };
+
+        class Decoder final
+        {
+        public:
+            Decoder(std::istream& initStream, std::uint64_t initMaxLength) noexcept:
+                stream(initStream), maxLength(initMaxLength)
+            {
+            }
+
+            std::uint8_t readByte()
+            {
+                const auto c = stream.get();
+                if (c == std::char_traits<char>::eof())
+                    throw std::runtime_error("Unexpected end of capture file");
+
+                return static_cast<std::uint8_t>(c);
+            }
+
+            std::uint64_t readUInt()
+            {
+                std::uint64_t result = 0;
+
+                for (std::uint32_t shift = 0; shift < 64; shift += 7)
+                {
+                    const auto byte = readByte();
+                    result |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                    if (!(byte & 0x80)) return result;
+                }
+
+                throw std::runtime_error("Invalid capture file");
+            }
+
+            std::uint32_t readUInt32()
+            {
+                const auto value = readUInt();
+                if (value > 0xFFFFFFFFU)
+                    throw std::runtime_error("Invalid capture file");
+
+                return static_cast<std::uint32_t>(value);
+            }
+
+            std::size_t readLength()
+            {
+                const auto length = readUInt();
+                if (length > maxLength)
+                    throw std::runtime_error("Invalid capture file");
+
+                return static_cast<std::size_t>(length);
+            }
+
+            template <class T>
+            T readEnum()
+            {
+                return static_cast<T>(readUInt());
+            }
+
+            bool readBool()
+            {
+                return readByte() != 0;
+            }
+
+            float readFloat()
+            {
+                std::uint32_t bits = readByte();
+                bits |= static_cast<std::uint32_t>(readByte()) << 8;
+                bits |= static_cast<std::uint32_t>(readByte()) << 16;
+                bits |= static_cast<std::uint32_t>(readByte()) << 24;
+
+                float result;
+                std::memcpy(&result, &bits, sizeof(result));
+                return result;
+            }
+
+            std::vector<std::uint8_t> readBytes()
+            {
+                std::vector<std::uint8_t> result(readLength());
+                if (!result.empty() &&
+                    !stream.read(reinterpret_cast<char*>(result.data()), static_cast<std::streamsize>(result.size())))
+                    throw std::runtime_error("Unexpected end of capture file");
+
+                return result;
+            }
+
+            std::string readString()
+            {
+                std::string result(readLength(), '\0');
+                if (!result.empty() &&
+                    !stream.read(result.data(), static_cast<std::streamsize>(result.size())))
+                    throw std::runtime_error("Unexpected end of capture file");
+
+                return result;
+            }
+
+            Color readColor()
+            {
+                Color result;
+                for (auto& component : result.v)
+                    component = readByte();
+                return result;
+            }
+
+            Size2U readSize()
+            {
+                const auto width = readUInt32();
+                const auto height = readUInt32();
+                return Size2U{width, height};
+            }
+
+            RectF readRect()
+            {
+                const auto x = readFloat();
+                const auto y = readFloat();
+                const auto width = readFloat();
+                const auto height = readFloat();
+                return RectF{x, y, width, height};
+            }
+
+            std::vector<std::pair<Size2U, std::vector<std::uint8_t>>> readLevels()
+            {
+                std::vector<std::pair<Size2U, std::vector<std::uint8_t>>> result(readLength());
+                for (auto& level : result)
+                {
+                    level.first = readSize();
+                    level.second = readBytes();
+                }
+                return result;
+            }
+
+            std::vector<std::pair<std::string, DataType>> readConstantInfo()
+            {
+                std::vector<std::pair<std::string, DataType>> result(readLength());
+                for (auto& constant : result)
+                {
+                    constant.first = readString();
+                    constant.second = readEnum<DataType>();
+                }
+                return result;
+            }
+
+            std::vector<std::vector<float>> readConstants()
+            {
+                std::vector<std::vector<float>> result(readLength());
+                for (auto& constant : result)
+                {
+                    constant.resize(readLength());
+                    for (float& value : constant)
+                        value = readFloat();
+                }
+                return result;
+            }
+
+        private:
+            std::istream& stream;
+            std::uint64_t maxLength;
+        };
+
+        void writeCommand(Encoder& encoder, const Command& command)
+        {
+            encoder.writeEnum(command.type);
+
+            switch (command.type)
+            {
+                case Command::Type::resize:
+                {
+                    auto& resizeCommand = static_cast<const ResizeCommand&>(command);
+                    encoder.writeSize(resizeCommand.size);
+                    break;
+                }
+
+                case Command::Type::present:
+                    break;
+
+                case Command::Type::deleteResource:
+                {
+                    auto& deleteResourceCommand = static_cast<const DeleteResourceCommand&>(command);
+                    encoder.writeUInt(deleteResourceCommand.resource);
+                    break;
+                }
+
+                case Command::Type::initRenderTarget:
+                {
+                    auto& initRenderTargetCommand = static_cast<const InitRenderTargetCommand&>(command);
+                    encoder.writeUInt(initRenderTargetCommand.renderTarget);
+                    encoder.writeUInt(initRenderTargetCommand.colorTextures.size());
+                    for (const auto colorTexture : initRenderTargetCommand.colorTextures)
+                        encoder.writeUInt(colorTexture);
+                    encoder.writeUInt(initRenderTargetCommand.depthTexture);
+                    break;
+                }
+
+                case Command::Type::setRenderTarget:
+                {
+                    auto& setRenderTargetCommand = static_cast<const SetRenderTargetCommand&>(command);
+                    encoder.writeUInt(setRenderTargetCommand.renderTarget);
+                    break;
+                }
+
+                case Command::Type::clearRenderTarget:
+                {
+                    auto& clearCommand = static_cast<const ClearRenderTargetCommand&>(command);
+                    encoder.writeBool(clearCommand.clearColorBuffer);
+                    encoder.writeBool(clearCommand.clearDepthBuffer);
+                    encoder.writeBool(clearCommand.clearStencilBuffer);
+                    encoder.writeColor(clearCommand.clearColor);
+                    encoder.writeFloat(clearCommand.clearDepth);
+                    encoder.writeUInt(clearCommand.clearStencil);
+                    break;
+                }
+
+                case Command::Type::setScissorTest:
+                {
+                    auto& setScissorTestCommand = static_cast<const SetScissorTestCommand&>(command);
+                    encoder.writeBool(setScissorTestCommand.enabled);
+                    encoder.writeRect(setScissorTestCommand.rectangle);
+                    break;
+                }
+
+                case Command::Type::setViewport:
+                {
+                    auto& setViewportCommand = static_cast<const SetViewportCommand&>(command);
+                    encoder.writeRect(setViewportCommand.viewport);
+                    break;
+                }
+
+                case Command::Type::initDepthStencilState:
+                {
+                    auto& initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand&>(command);
+                    encoder.writeUInt(initDepthStencilStateCommand.depthStencilState);
+                    encoder.writeBool(initDepthStencilStateCommand.depthTest);
+                    encoder.writeBool(initDepthStencilStateCommand.depthWrite);
+                    encoder.writeEnum(initDepthStencilStateCommand.compareFunction);
+                    encoder.writeBool(initDepthStencilStateCommand.stencilEnabled);
+                    encoder.writeUInt(initDepthStencilStateCommand.stencilReadMask);
+                    encoder.writeUInt(initDepthStencilStateCommand.stencilWriteMask);
+                    encoder.writeEnum(initDepthStencilStateCommand.frontFaceStencilFailureOperation);
+                    encoder.writeEnum(initDepthStencilStateCommand.frontFaceStencilDepthFailureOperation);
+                    encoder.writeEnum(initDepthStencilStateCommand.frontFaceStencilPassOperation);
+                    encoder.writeEnum(initDepthStencilStateCommand.frontFaceStencilCompareFunction);
+                    encoder.writeEnum(initDepthStencilStateCommand.backFaceStencilFailureOperation);
+                    encoder.writeEnum(initDepthStencilStateCommand.backFaceStencilDepthFailureOperation);
+                    encoder.writeEnum(initDepthStencilStateCommand.backFaceStencilPassOperation);
+                    encoder.writeEnum(initDepthStencilStateCommand.backFaceStencilCompareFunction);
+                    break;
+                }
+
+                case Command::Type::setDepthStencilState:
+                {
+                    auto& setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand&>(command);
+                    encoder.writeUInt(setDepthStencilStateCommand.depthStencilState);
+                    encoder.writeUInt(setDepthStencilStateCommand.stencilReferenceValue);
+                    break;
+                }
+
+                case Command::Type::setPipelineState:
+                {
+                    auto& setPipelineStateCommand = static_cast<const SetPipelineStateCommand&>(command);
+                    encoder.writeUInt(setPipelineStateCommand.blendState);
+                    encoder.writeUInt(setPipelineStateCommand.shader);
+                    encoder.writeEnum(setPipelineStateCommand.cullMode);
+                    encoder.writeEnum(setPipelineStateCommand.fillMode);
+                    break;
+                }
+
+                case Command::Type::draw:
+                {
+                    auto& drawCommand = static_cast<const DrawCommand&>(command);
+                    encoder.writeUInt(drawCommand.indexBuffer);
+                    encoder.writeUInt(drawCommand.indexCount);
+                    encoder.writeUInt(drawCommand.indexSize);
+                    encoder.writeUInt(drawCommand.vertexBuffer);
+                    encoder.writeEnum(drawCommand.drawMode);
+                    encoder.writeUInt(drawCommand.startIndex);
+                    encoder.writeUInt(drawCommand.baseVertex);
+                    encoder.writeUInt(drawCommand.instanceBuffer);
+                    encoder.writeUInt(drawCommand.instanceCount);
+                    encoder.writeUInt(drawCommand.skinBuffer);
+                    break;
+                }
+
+                case Command::Type::initBlendState:
+                {
+                    auto& initBlendStateCommand = static_cast<const InitBlendStateCommand&>(command);
+                    encoder.writeUInt(initBlendStateCommand.blendState);
+                    encoder.writeBool(initBlendStateCommand.enableBlending);
+                    encoder.writeEnum(initBlendStateCommand.colorBlendSource);
+                    encoder.writeEnum(initBlendStateCommand.colorBlendDest);
+                    encoder.writeEnum(initBlendStateCommand.colorOperation);
+                    encoder.writeEnum(initBlendStateCommand.alphaBlendSource);
+                    encoder.writeEnum(initBlendStateCommand.alphaBlendDest);
+                    encoder.writeEnum(initBlendStateCommand.alphaOperation);
+                    encoder.writeEnum(initBlendStateCommand.colorMask);
+                    break;
+                }
+
+                case Command::Type::initBuffer:
+                {
+                    auto& initBufferCommand = static_cast<const InitBufferCommand&>(command);
+                    encoder.writeUInt(initBufferCommand.buffer);
+                    encoder.writeEnum(initBufferCommand.bufferType);
+                    encoder.writeEnum(initBufferCommand.flags);
+                    encoder.writeBytes(initBufferCommand.data);
+                    encoder.writeUInt(initBufferCommand.size);
+                    break;
+                }
+
+                case Command::Type::setBufferData:
+                {
+                    auto& setBufferDataCommand = static_cast<const SetBufferDataCommand&>(command);
+                    encoder.writeUInt(setBufferDataCommand.buffer);
+                    encoder.writeBytes(setBufferDataCommand.data);
+                    break;
+                }
+
+                case Command::Type::initShader:
+                {
+                    auto& initShaderCommand = static_cast<const InitShaderCommand&>(command);
+                    encoder.writeUInt(initShaderCommand.shader);
+                    encoder.writeBytes(initShaderCommand.fragmentShader);
+                    encoder.writeBytes(initShaderCommand.vertexShader);
+                    encoder.writeUInt(initShaderCommand.vertexAttributes.size());
+                    for (const auto usage : initShaderCommand.vertexAttributes)
+                        encoder.writeEnum(usage);
+                    encoder.writeConstantInfo(initShaderCommand.fragmentShaderConstantInfo);
+                    encoder.writeConstantInfo(initShaderCommand.vertexShaderConstantInfo);
+                    encoder.writeString(initShaderCommand.fragmentShaderFunction);
+                    encoder.writeString(initShaderCommand.vertexShaderFunction);
+                    break;
+                }
+
+                case Command::Type::setShaderConstants:
+                {
+                    auto& setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand&>(command);
+                    encoder.writeConstants(setShaderConstantsCommand.fragmentShaderConstants);
+                    encoder.writeConstants(setShaderConstantsCommand.vertexShaderConstants);
+                    break;
+                }
+
+                case Command::Type::initTexture:
+                {
+                    auto& initTextureCommand = static_cast<const InitTextureCommand&>(command);
+                    encoder.writeUInt(initTextureCommand.texture);
+                    encoder.writeLevels(initTextureCommand.levels);
+                    encoder.writeEnum(initTextureCommand.textureType);
+                    encoder.writeEnum(initTextureCommand.flags);
+                    encoder.writeUInt(initTextureCommand.sampleCount);
+                    encoder.writeEnum(initTextureCommand.pixelFormat);
+                    encoder.writeEnum(initTextureCommand.filter);
+                    encoder.writeUInt(initTextureCommand.maxAnisotropy);
+                    break;
+                }
+
+                case Command::Type::setTextureData:
+                {
+                    auto& setTextureDataCommand = static_cast<const SetTextureDataCommand&>(command);
+                    encoder.writeUInt(setTextureDataCommand.texture);
+                    encoder.writeLevels(setTextureDataCommand.levels);
+                    encoder.writeEnum(setTextureDataCommand.face);
+                    break;
+                }
+
+                case Command::Type::setTextureParameters:
+                {
+                    auto& setTextureParametersCommand = static_cast<const SetTextureParametersCommand&>(command);
+                    encoder.writeUInt(setTextureParametersCommand.texture);
+                    encoder.writeEnum(setTextureParametersCommand.filter);
+                    encoder.writeEnum(setTextureParametersCommand.addressX);
+                    encoder.writeEnum(setTextureParametersCommand.addressY);
+                    encoder.writeEnum(setTextureParametersCommand.addressZ);
+                    encoder.writeColor(setTextureParametersCommand.borderColor);
+                    encoder.writeUInt(setTextureParametersCommand.maxAnisotropy);
+                    break;
+                }
+
+                case Command::Type::setTextures:
+                {
+                    auto& setTexturesCommand = static_cast<const SetTexturesCommand&>(command);
+                    encoder.writeUInt(setTexturesCommand.textures.size());
+                    for (const auto texture : setTexturesCommand.textures)
+                        encoder.writeUInt(texture);
+                    break;
+                }
+
+                default:
+                    throw std::runtime_error("Unsupported command");
+            }
+        }
+
+        std::unique_ptr<Command> readCommand(Decoder& decoder)
+        {
+            switch (decoder.readEnum<Command::Type>())
+            {
+                case Command::Type::resize:
+                    return std::make_unique<ResizeCommand>(decoder.readSize());
+
+                case Command::Type::present:
+                    return std::make_unique<PresentCommand>();
+
+                case Command::Type::deleteResource:
+                    return std::make_unique<DeleteResourceCommand>(decoder.readUInt());
+
+                case Command::Type::initRenderTarget:
+                {
+                    const auto renderTarget = decoder.readUInt();
+                    std::set<std::size_t> colorTextures;
+                    for (auto count = decoder.readLength(); count > 0; --count)
+                        colorTextures.insert(decoder.readUInt());
+                    const auto depthTexture = decoder.readUInt();
+                    return std::make_unique<InitRenderTargetCommand>(renderTarget, colorTextures, depthTexture);
+                }
+
+                case Command::Type::setRenderTarget:
+                    return std::make_unique<SetRenderTargetCommand>(decoder.readUInt());
+
+                case Command::Type::clearRenderTarget:
+                {
+                    const auto clearColorBuffer = decoder.readBool();
+                    const auto clearDepthBuffer = decoder.readBool();
+                    const auto clearStencilBuffer = decoder.readBool();
+                    const auto clearColor = decoder.readColor();
+                    const auto clearDepth = decoder.readFloat();
+                    const auto clearStencil = decoder.readUInt32();
+                    return std::make_unique<ClearRenderTargetCommand>(clearColorBuffer,
+                                                                      clearDepthBuffer,
+                                                                      clearStencilBuffer,
+                                                                      clearColor,
+                                                                      clearDepth,
+                                                                      clearStencil);
+                }
+
+                case Command::Type::setScissorTest:
+                {
+                    const auto enabled = decoder.readBool();
+                    const auto rectangle = decoder.readRect();
+                    return std::make_unique<SetScissorTestCommand>(enabled, rectangle);
+                }
+
+                case Command::Type::setViewport:
+                    return std::make_unique<SetViewportCommand>(decoder.readRect());
+
+                case Command::Type::initDepthStencilState:
+                {
+                    const auto depthStencilState = decoder.readUInt();
+                    const auto depthTest = decoder.readBool();
+                    const auto depthWrite = decoder.readBool();
+                    const auto compareFunction = decoder.readEnum<CompareFunction>();
+                    const auto stencilEnabled = decoder.readBool();
+                    const auto stencilReadMask = decoder.readUInt32();
+                    const auto stencilWriteMask = decoder.readUInt32();
+                    const auto frontFaceStencilFailureOperation = decoder.readEnum<StencilOperation>();
+                    const auto frontFaceStencilDepthFailureOperation = decoder.readEnum<StencilOperation>();
+                    const auto frontFaceStencilPassOperation = decoder.readEnum<StencilOperation>();
+                    const auto frontFaceStencilCompareFunction = decoder.readEnum<CompareFunction>();
+                    const auto backFaceStencilFailureOperation = decoder.readEnum<StencilOperation>();
+                    const auto backFaceStencilDepthFailureOperation = decoder.readEnum<StencilOperation>();
+                    const auto backFaceStencilPassOperation = decoder.readEnum<StencilOperation>();
+                    const auto backFaceStencilCompareFunction = decoder.readEnum<CompareFunction>();
+                    return std::make_unique<InitDepthStencilStateCommand>(depthStencilState,
+                                                                          depthTest,
+                                                                          depthWrite,
+                                                                          compareFunction,
+                                                                          stencilEnabled,
+                                                                          stencilReadMask,
+                                                                          stencilWriteMask,
+                                                                          frontFaceStencilFailureOperation,
+                                                                          frontFaceStencilDepthFailureOperation,
+                                                                          frontFaceStencilPassOperation,
+                                                                          frontFaceStencilCompareFunction,
+                                                                          backFaceStencilFailureOperation,
+                                                                          backFaceStencilDepthFailureOperation,
+                                                                          backFaceStencilPassOperation,
+                                                                          backFaceStencilCompareFunction);
+                }
+
+                case Command::Type::setDepthStencilState:
+                {
+                    const auto depthStencilState = decoder.readUInt();
+                    const auto stencilReferenceValue = decoder.readUInt32();
+                    return std::make_unique<SetDepthStencilStateCommand>(depthStencilState, stencilReferenceValue);
+                }
+
+                case Command::Type::setPipelineState:
+                {
+                    const auto blendState = decoder.readUInt();
+                    const auto shader = decoder.readUInt();
+                    const auto cullMode = decoder.readEnum<CullMode>();
+                    const auto fillMode = decoder.readEnum<FillMode>();
+                    return std::make_unique<SetPipelineStateCommand>(blendState, shader, cullMode, fillMode);
+                }
+
+                case Command::Type::draw:
+                {
+                    const auto indexBuffer = decoder.readUInt();
+                    const auto indexCount = decoder.readUInt32();
+                    const auto indexSize = decoder.readUInt32();
+                    const auto vertexBuffer = decoder.readUInt();
+                    const auto drawMode = decoder.readEnum<DrawMode>();
+                    const auto startIndex = decoder.readUInt32();
+                    const auto baseVertex = decoder.readUInt32();
+                    const auto instanceBuffer = decoder.readUInt();
+                    const auto instanceCount = decoder.readUInt32();
+                    const auto skinBuffer = decoder.readUInt();
+                    return std::make_unique<DrawCommand>(indexBuffer,
+                                                         indexCount,
+                                                         indexSize,
+                                                         vertexBuffer,
+                                                         drawMode,
+                                                         startIndex,
+                                                         baseVertex,
+                                                         instanceBuffer,
+                                                         instanceCount,
+                                                         skinBuffer);
+                }
+
+                case Command::Type::initBlendState:
+                {
+                    const auto blendState = decoder.readUInt();
+                    const auto enableBlending = decoder.readBool();
+                    const auto colorBlendSource = decoder.readEnum<BlendFactor>();
+                    const auto colorBlendDest = decoder.readEnum<BlendFactor>();
+                    const auto colorOperation = decoder.readEnum<BlendOperation>();
+                    const auto alphaBlendSource = decoder.readEnum<BlendFactor>();
+                    const auto alphaBlendDest = decoder.readEnum<BlendFactor>();
+                    const auto alphaOperation = decoder.readEnum<BlendOperation>();
+                    const auto colorMask = decoder.readEnum<ColorMask>();
+                    return std::make_unique<InitBlendStateCommand>(blendState,
+                                                                   enableBlending,
+                                                                   colorBlendSource,
+                                                                   colorBlendDest,
+                                                                   colorOperation,
+                                                                   alphaBlendSource,
+                                                                   alphaBlendDest,
+                                                                   alphaOperation,
+                                                                   colorMask);
+                }
+
+                case Command::Type::initBuffer:
+                {
+                    const auto buffer = decoder.readUInt();
+                    const auto bufferType = decoder.readEnum<BufferType>();
+                    const auto flags = decoder.readEnum<Flags>();
+                    const auto data = decoder.readBytes();
+                    const auto size = decoder.readUInt32();
+                    return std::make_unique<InitBufferCommand>(buffer, bufferType, flags, data, size);
+                }
+
+                case Command::Type::setBufferData:
+                {
+                    const auto buffer = decoder.readUInt();
+                    const auto data = decoder.readBytes();
+                    return std::make_unique<SetBufferDataCommand>(buffer, data);
+                }
+
+                case Command::Type::initShader:
+                {
+                    const auto shader = decoder.readUInt();
+                    const auto fragmentShader = decoder.readBytes();
+                    const auto vertexShader = decoder.readBytes();
+                    std::set<Vertex::Attribute::Usage> vertexAttributes;
+                    for (auto count = decoder.readLength(); count > 0; --count)
+                        vertexAttributes.insert(decoder.readEnum<Vertex::Attribute::Usage>());
+                    const auto fragmentShaderConstantInfo = decoder.readConstantInfo();
+                    const auto vertexShaderConstantInfo = decoder.readConstantInfo();
+                    const auto fragmentShaderFunction = decoder.readString();
+                    const auto vertexShaderFunction = decoder.readString();
+                    return std::make_unique<InitShaderCommand>(shader,
+                                                               fragmentShader,
+                                                               vertexShader,
+                                                               vertexAttributes,
+                                                               fragmentShaderConstantInfo,
+                                                               vertexShaderConstantInfo,
+                                                               fragmentShaderFunction,
+                                                               vertexShaderFunction);
+                }
+
+                case Command::Type::setShaderConstants:
+                {
+                    auto fragmentShaderConstants = decoder.readConstants();
+                    auto vertexShaderConstants = decoder.readConstants();
+                    return std::make_unique<SetShaderConstantsCommand>(std::move(fragmentShaderConstants),
+                                                                       std::move(vertexShaderConstants));
+                }
+
+                case Command::Type::initTexture:
+                {
+                    const auto texture = decoder.readUInt();
+                    const auto levels = decoder.readLevels();
+                    const auto textureType = decoder.readEnum<TextureType>();
+                    const auto flags = decoder.readEnum<Flags>();
+                    const auto sampleCount = decoder.readUInt32();
+                    const auto pixelFormat = decoder.readEnum<PixelFormat>();
+                    const auto filter = decoder.readEnum<SamplerFilter>();
+                    const auto maxAnisotropy = decoder.readUInt32();
+                    return std::make_unique<InitTextureCommand>(texture,
+                                                                levels,
+                                                                textureType,
+                                                                flags,
+                                                                sampleCount,
+                                                                pixelFormat,
+                                                                filter,
+                                                                maxAnisotropy);
+                }
+
+                case Command::Type::setTextureData:
+                {
+                    const auto texture = decoder.readUInt();
+                    const auto levels = decoder.readLevels();
+                    const auto face = decoder.readEnum<CubeFace>();
+                    return std::make_unique<SetTextureDataCommand>(texture, levels, face);
+                }
+
+                case Command::Type::setTextureParameters:
+                {
+                    const auto texture = decoder.readUInt();
+                    const auto filter = decoder.readEnum<SamplerFilter>();
+                    const auto addressX = decoder.readEnum<SamplerAddressMode>();
+                    const auto addressY = decoder.readEnum<SamplerAddressMode>();
+                    const auto addressZ = decoder.readEnum<SamplerAddressMode>();
+                    const auto borderColor = decoder.readColor();
+                    const auto maxAnisotropy = decoder.readUInt32();
+                    return std::make_unique<SetTextureParametersCommand>(texture,
+                                                                         filter,
+                                                                         addressX,
+                                                                         addressY,
+                                                                         addressZ,
+                                                                         borderColor,
+                                                                         maxAnisotropy);
+                }
+
+                case Command::Type::setTextures:
+                {
+                    std::vector<ResourceId> textures(decoder.readLength());
+                    for (auto& texture : textures)
+                        texture = decoder.readUInt();
+                    return std::make_unique<SetTexturesCommand>(textures);
+                }
+
+                default:
+                    throw std::runtime_error("Unsupported command in capture file");
+            }
+        }
+    }
+
+    CaptureWriter::CaptureWriter(const std::string& filename):
+        file(filename, std::ios::binary | std::ios::trunc),
+        previousTime(std::chrono::steady_clock::now())
+    {
+        if (!file)
+            throw std::runtime_error("Failed to open file " + filename);
+
+        Encoder encoder(data);
+        data.insert(data.end(), std::begin(captureMagic), std::end(captureMagic));
+        encoder.writeUInt(captureVersion);
+
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file)
+            throw std::runtime_error("Failed to write capture file");
+    }
+
+    void CaptureWriter::write(const CommandBuffer& commandBuffer)
+    {
+        const auto currentTime = std::chrono::steady_clock::now();
+        const auto delay = std::chrono::duration_cast<std::chrono::nanoseconds>(currentTime - previousTime);
+        previousTime = currentTime;
+
+        data.clear();
+        Encoder encoder(data);
+        encoder.writeUInt(static_cast<std::uint64_t>(delay.count()));
+
+        const auto& commands = commandBuffer.getCommands();
+        encoder.writeUInt(commands.size());
+        for (const auto& command : commands)
+            writeCommand(encoder, *command);
+
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        file.flush();
+        if (!file)
+            throw std::runtime_error("Failed to write capture file");
+    }
+
+    CaptureReader::CaptureReader(const std::string& filename):
+        file(filename, std::ios::binary)
+    {
+        if (!file)
+            throw std::runtime_error("Failed to open file " + filename);
+
+        char magic[sizeof(captureMagic)];
+        if (!file.read(magic, sizeof(magic)) ||
+            std::memcmp(magic, captureMagic, sizeof(captureMagic)) != 0)
+            throw std::runtime_error("Invalid capture file " + filename);
+
+        Decoder decoder(file, 0);
+        if (decoder.readUInt() != captureVersion)
+            throw std::runtime_error("Unsupported capture file version");
+
+        firstBuffer = file.tellg();
+
+        file.seekg(0, std::ios::end);
+        fileSize = static_cast<std::uint64_t>(file.tellg());
+        file.seekg(firstBuffer);
+    }
+
+    bool CaptureReader::read(CommandBuffer& commandBuffer, std::chrono::nanoseconds& delay)
+    {
+        if (file.peek() == std::char_traits<char>::eof())
+            return false;
+
+        // none of the lengths can be larger than the file
+        Decoder decoder(file, fileSize);
+        delay = std::chrono::nanoseconds(static_cast<std::int64_t>(decoder.readUInt()));
+
+        for (auto count = decoder.readLength(); count > 0; --count)
+            commandBuffer.pushCommand(readCommand(decoder));
+
+        return true;
+    }
+
+    void CaptureReader::rewind()
+    {
+        file.clear();
+        file.seekg(firstBuffer);
+    }
+
+    CaptureReplayer::CaptureReplayer(const std::string& filename):
+        reader(filename)
+    {
+    }
+
+    CaptureReplayer::Statistics CaptureReplayer::replay(RenderDevice& renderDevice)
+    {
+        Statistics statistics;
+
+        renderDevice.resetCommandStatistics();
+        renderDevice.setCommandTimingEnabled(true);
+
+        // the empty render device has no render thread
+        const bool renderThread = renderDevice.getDriver() != Driver::empty;
+        const auto presentIndex = static_cast<std::size_t>(Command::Type::present);
+
+        reader.rewind();
+
+        auto frameStart = std::chrono::steady_clock::now();
+
+        for (;;)
+        {
+            CommandBuffer commandBuffer;
+            std::chrono::nanoseconds delay;
+
+            const auto readStart = std::chrono::steady_clock::now();
+            if (!reader.read(commandBuffer, delay)) break;
+            const auto processStart = std::chrono::steady_clock::now();
+            statistics.readTime += processStart - readStart;
+
+            const auto& commands = commandBuffer.getCommands();
+            const bool frameEnd = !commands.empty() && commands.back()->type == Command::Type::present;
+            statistics.commandCount += commands.size();
+
+            renderDevice.submitCommandBuffer(std::move(commandBuffer));
+
+            if (!renderThread)
+                renderDevice.process();
+            else if (frameEnd)
+                while (renderDevice.getCommandStatistics()[presentIndex].count < statistics.frameCount + 1)
+                    std::this_thread::yield();
+
+            const auto processEnd = std::chrono::steady_clock::now();
+            statistics.processTime += processEnd - processStart;
+
+            if (frameEnd)
+            {
+                ++statistics.frameCount;
+                statistics.frameTimes.push_back(processEnd - frameStart);
+                frameStart = processEnd;
+            }
+        }
+
+        renderDevice.setCommandTimingEnabled(false);
+
+        return statistics;
+    }
+}
@@ -0,0 +1,73 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_COMMANDCAPTURE_HPP
+#define OUZEL_GRAPHICS_COMMANDCAPTURE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Commands.hpp"
+
+namespace ouzel::graphics
+{
+    class RenderDevice;
+
+    // Capture file layout (little endian, integers are stored as LEB128):
+    // "OUZR", version, then for every submitted command buffer the nanoseconds since the previous one,
+    // the command count and the commands, each of them as its type followed by its fields
+    // Frames end with the present command
+    class CaptureWriter final
+    {
+    public:
+        explicit CaptureWriter(const std::string& filename);
+
+        void write(const CommandBuffer& commandBuffer);
+
+    private:
+        std::ofstream file;
+        std::vector<std::uint8_t> data;
+        std::chrono::steady_clock::time_point previousTime;
+    };
+
+    class CaptureReader final
+    {
+    public:
+        explicit CaptureReader(const std::string& filename);
+
+        // Returns false at the end of the file
+        bool read(CommandBuffer& commandBuffer, std::chrono::nanoseconds& delay);
+
+        void rewind();
+
+    private:
+        std::ifstream file;
+        std::uint64_t fileSize = 0;
+        std::streampos firstBuffer;
+    };
+
+    // Feeds a capture to a render device, e.g. to the empty render device on a machine without a GPU
+    class CaptureReplayer final
+    {
+    public:
+        struct Statistics final
+        {
+            std::uint64_t frameCount = 0;
+            std::uint64_t commandCount = 0;
+            std::chrono::nanoseconds readTime{0}; // time spent on decoding the capture
+            std::chrono::nanoseconds processTime{0}; // time spent by the render device
+            std::vector<std::chrono::nanoseconds> frameTimes;
+        };
+
+        explicit CaptureReplayer(const std::string& filename);
+
+        // Replays the whole capture, the render device's command statistics hold the time of every command type
+        Statistics replay(RenderDevice& renderDevice);
+
+    private:
+        CaptureReader reader;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_COMMANDCAPTURE_HPP
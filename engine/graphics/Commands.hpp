@@ -3,8 +3,11 @@
 #ifndef OUZEL_GRAPHICS_COMMANDS_HPP
 #define OUZEL_GRAPHICS_COMMANDS_HPP
 
-#include <queue>
+#include <deque>
+#include <iterator>
+#include <set>
 #include <string>
+#include <utility>
 #include "BlendFactor.hpp"
 #include "BlendOperation.hpp"
 #include "BufferType.hpp"
@@ -288,14 +291,22 @@ namespace ouzel::graphics
                               std::uint32_t initIndexSize,
                               ResourceId initVertexBuffer,
                               DrawMode initDrawMode,
-                              std::uint32_t initStartIndex) noexcept:
+                              std::uint32_t initStartIndex,
+                              std::uint32_t initBaseVertex,
+                              ResourceId initInstanceBuffer,
+                              std::uint32_t initInstanceCount,
+                              ResourceId initSkinBuffer) noexcept:
             Command(Command::Type::draw),
             indexBuffer(initIndexBuffer),
             indexCount(initIndexCount),
             indexSize(initIndexSize),
             vertexBuffer(initVertexBuffer),
             drawMode(initDrawMode),
-            startIndex(initStartIndex)
+            startIndex(initStartIndex),
+            baseVertex(initBaseVertex),
+            instanceBuffer(initInstanceBuffer),
+            instanceCount(initInstanceCount),
+            skinBuffer(initSkinBuffer)
         {
         }
 
@@ -305,6 +316,10 @@ namespace ouzel::graphics
         const ResourceId vertexBuffer;
         const DrawMode drawMode;
         const std::uint32_t startIndex;
+        const std::uint32_t baseVertex; // added to every index
+        const ResourceId instanceBuffer; // 0 for draws that are not instanced
+        const std::uint32_t instanceCount;
+        const ResourceId skinBuffer; // 0 for draws that are not skinned on the GPU
     };
 
     class InitBlendStateCommand final: public Command
@@ -378,6 +393,14 @@ namespace ouzel::graphics
         {
         }
 
+        SetBufferDataCommand(ResourceId initBuffer,
+                             std::vector<std::uint8_t>&& initData) noexcept:
+            Command(Command::Type::setBufferData),
+            buffer(initBuffer),
+            data(std::move(initData))
+        {
+        }
+
         const ResourceId buffer;
         const std::vector<std::uint8_t> data;
     };
@@ -547,13 +570,21 @@ namespace ouzel::graphics
 
         void pushCommand(std::unique_ptr<Command> command)
         {
-            commands.push(std::move(command));
+            commands.push_back(std::move(command));
+        }
+
+        void append(CommandBuffer&& other)
+        {
+            commands.insert(commands.end(),
+                            std::make_move_iterator(other.commands.begin()),
+                            std::make_move_iterator(other.commands.end()));
+            other.commands.clear();
         }
 
         std::unique_ptr<Command> popCommand()
         {
             auto result = std::move(commands.front());
-            commands.pop();
+            commands.pop_front();
             return result;
         }
 
@@ -564,7 +595,7 @@ namespace ouzel::graphics
 
     private:
         std::string name;
-        std::queue<std::unique_ptr<Command>> commands;
+        std::deque<std::unique_ptr<Command>> commands;
     };
 }
 
@@ -11,7 +11,8 @@ namespace ouzel::graphics
         dynamic = 0x01,
         bindRenderTarget = 0x02,
         bindShader = 0x04,
-        bindShaderMsaa = 0x08
+        bindShaderMsaa = 0x08,
+        transient = 0x10 // buffer contents are replaced every frame
     };
 
     inline constexpr Flags operator&(const Flags a, const Flags b) noexcept
@@ -101,7 +101,7 @@ namespace ouzel::graphics
             {
 #if OUZEL_COMPILE_OPENGL
                 case Driver::openGL:
-                    logger.log(Log::Level::info) << "Using OpenGL render driver";
+                    OUZEL_LOG(Log::Level::info) << "Using OpenGL render driver";
 #  if TARGET_OS_IOS
                     return std::make_unique<opengl::ios::RenderDevice>(settings, window, callback);
 #  elif TARGET_OS_TV
@@ -122,12 +122,12 @@ namespace ouzel::graphics
 #endif
 #if OUZEL_COMPILE_DIRECT3D11
                 case Driver::direct3D11:
-                    logger.log(Log::Level::info) << "Using Direct3D 11 render driver";
+                    OUZEL_LOG(Log::Level::info) << "Using Direct3D 11 render driver";
                     return std::make_unique<d3d11::RenderDevice>(settings, window, callback);
 #endif
 #if OUZEL_COMPILE_METAL
                 case Driver::metal:
-                    logger.log(Log::Level::info) << "Using Metal render driver";
+                    OUZEL_LOG(Log::Level::info) << "Using Metal render driver";
 #  if TARGET_OS_IOS
                     return std::make_unique<metal::ios::RenderDevice>(settings, window, callback);
 #  elif TARGET_OS_TV
@@ -137,7 +137,7 @@ namespace ouzel::graphics
 #  endif
 #endif
                 default:
-                    logger.log(Log::Level::info) << "Not using render driver";
+                    OUZEL_LOG(Log::Level::info) << "Not using render driver";
                     return std::make_unique<empty::RenderDevice>(settings, window, callback);
             }
         }
@@ -150,8 +150,12 @@ namespace ouzel::graphics
         maxAnisotropy(settings.maxAnisotropy),
         size(initWindow.getResolution()),
         device(createRenderDevice(driver, initWindow, settings, std::bind(&Graphics::handleEvent, this, std::placeholders::_1))),
-        renderer(*device)
+        renderer(*device),
+        transientGeometry(*this)
     {
+        // the transient buffers have to exist before the geometry of the first frame is uploaded
+        device->submitCommandBuffer(std::move(commandBuffer));
+        commandBuffer = CommandBuffer();
     }
 
     void Graphics::handleEvent(const RenderDevice::Event& event)
@@ -231,17 +235,77 @@ namespace ouzel::graphics
                         std::uint32_t indexSize,
                         std::size_t vertexBuffer,
                         DrawMode drawMode,
-                        std::uint32_t startIndex)
+                        std::uint32_t startIndex,
+                        std::uint32_t baseVertex)
+    {
+        if (!indexBuffer || !vertexBuffer)
+            throw std::runtime_error("Invalid mesh buffer passed to render queue");
+
+        addCommand(std::make_unique<DrawCommand>(indexBuffer,
+                                                 indexCount,
+                                                 indexSize,
+                                                 vertexBuffer,
+                                                 drawMode,
+                                                 startIndex,
+                                                 baseVertex,
+                                                 0,
+                                                 1,
+                                                 0));
+    }
+
+    void Graphics::drawInstanced(std::size_t indexBuffer,
+                                 std::uint32_t indexCount,
+                                 std::uint32_t indexSize,
+                                 std::size_t vertexBuffer,
+                                 std::size_t instanceBuffer,
+                                 std::uint32_t instanceCount,
+                                 DrawMode drawMode,
+                                 std::uint32_t startIndex,
+                                 std::uint32_t baseVertex)
+    {
+        if (!indexBuffer || !vertexBuffer)
+            throw std::runtime_error("Invalid mesh buffer passed to render queue");
+
+        if (!instanceBuffer)
+            throw std::runtime_error("Invalid instance buffer passed to render queue");
+
+        addCommand(std::make_unique<DrawCommand>(indexBuffer,
+                                                 indexCount,
+                                                 indexSize,
+                                                 vertexBuffer,
+                                                 drawMode,
+                                                 startIndex,
+                                                 baseVertex,
+                                                 instanceBuffer,
+                                                 instanceCount,
+                                                 0));
+    }
+
+    void Graphics::drawSkinned(std::size_t indexBuffer,
+                               std::uint32_t indexCount,
+                               std::uint32_t indexSize,
+                               std::size_t vertexBuffer,
+                               std::size_t skinBuffer,
+                               DrawMode drawMode,
+                               std::uint32_t startIndex,
+                               std::uint32_t baseVertex)
     {
         if (!indexBuffer || !vertexBuffer)
             throw std::runtime_error("Invalid mesh buffer passed to render queue");
 
+        if (!skinBuffer)
+            throw std::runtime_error("Invalid skin buffer passed to render queue");
+
         addCommand(std::make_unique<DrawCommand>(indexBuffer,
                                                  indexCount,
                                                  indexSize,
                                                  vertexBuffer,
                                                  drawMode,
-                                                 startIndex));
+                                                 startIndex,
+                                                 baseVertex,
+                                                 0,
+                                                 1,
+                                                 skinBuffer));
     }
 
     void Graphics::setShaderConstants(const std::vector<std::vector<float>>& fragmentShaderConstants,
@@ -256,12 +320,39 @@ namespace ouzel::graphics
         addCommand(std::make_unique<SetTexturesCommand>(textures));
     }
 
+    CommandList& Graphics::getCommandList(std::size_t index)
+    {
+        while (commandLists.size() <= index)
+            commandLists.push_back(std::make_unique<CommandList>(*this));
+
+        // a list is left with commands only if its recording failed
+        CommandList& commandList = *commandLists[index];
+        commandList.commandBuffer = CommandBuffer();
+        commandList.transientGeometry.discard();
+        return commandList;
+    }
+
+    void Graphics::appendCommandList(CommandList& commandList)
+    {
+        commandBuffer.append(commandList.transientGeometry.flush());
+        commandBuffer.append(std::move(commandList.commandBuffer));
+        commandList.commandBuffer = CommandBuffer();
+    }
+
     void Graphics::present()
     {
         refillQueue = false;
         addCommand(std::make_unique<PresentCommand>());
+
+        // the geometry of the frame is uploaded before the commands that draw it
+        if (auto upload = transientGeometry.flush(); !upload.isEmpty())
+            device->submitCommandBuffer(std::move(upload));
+
         device->submitCommandBuffer(std::move(commandBuffer));
         commandBuffer = CommandBuffer();
+
+        // the empty render device has no render thread
+        if (device->getDriver() == Driver::empty) device->process();
     }
 
     void Graphics::waitForNextFrame()
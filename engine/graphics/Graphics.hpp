@@ -15,6 +15,7 @@
 #include "Driver.hpp"
 #include "RenderDevice.hpp"
 #include "Settings.hpp"
+#include "TransientGeometry.hpp"
 #include "renderer/Renderer.hpp"
 #include "../math/Rect.hpp"
 #include "../math/Matrix.hpp"
@@ -23,6 +24,23 @@
 
 namespace ouzel::graphics
 {
+    class Graphics;
+
+    // Commands and transient geometry recorded by one thread, appended to the frame by Graphics::appendCommandList
+    class CommandList final
+    {
+        friend Graphics;
+    public:
+        explicit CommandList(Graphics& graphics):
+            transientGeometry(graphics)
+        {
+        }
+
+    private:
+        CommandBuffer commandBuffer;
+        TransientGeometry transientGeometry;
+    };
+
     class Graphics final
     {
         friend core::Window;
@@ -38,6 +56,11 @@ namespace ouzel::graphics
 
         auto& getSize() const noexcept { return size; }
 
+        auto& getTransientGeometry() noexcept
+        {
+            return currentCommandList ? currentCommandList->transientGeometry : transientGeometry;
+        }
+
         auto getTextureFilter() const noexcept { return textureFilter; }
         auto getMaxAnisotropy() const noexcept { return maxAnisotropy; }
 
@@ -63,15 +86,46 @@ namespace ouzel::graphics
                   std::uint32_t indexSize,
                   std::size_t vertexBuffer,
                   DrawMode drawMode,
-                  std::uint32_t startIndex);
+                  std::uint32_t startIndex,
+                  std::uint32_t baseVertex = 0);
+        // Draws the mesh once for every Instance in the instance buffer
+        void drawInstanced(std::size_t indexBuffer,
+                           std::uint32_t indexCount,
+                           std::uint32_t indexSize,
+                           std::size_t vertexBuffer,
+                           std::size_t instanceBuffer,
+                           std::uint32_t instanceCount,
+                           DrawMode drawMode,
+                           std::uint32_t startIndex,
+                           std::uint32_t baseVertex = 0);
+        // Draws the mesh with the SkinVertex stream of the skin buffer bound for the GPU skinning shaders
+        void drawSkinned(std::size_t indexBuffer,
+                         std::uint32_t indexCount,
+                         std::uint32_t indexSize,
+                         std::size_t vertexBuffer,
+                         std::size_t skinBuffer,
+                         DrawMode drawMode,
+                         std::uint32_t startIndex,
+                         std::uint32_t baseVertex = 0);
         void setShaderConstants(const std::vector<std::vector<float>>& fragmentShaderConstants,
                                 const std::vector<std::vector<float>>& vertexShaderConstants);
         void setTextures(const std::vector<std::size_t>& textures);
 
         void addCommand(std::unique_ptr<Command> command)
         {
-            commandBuffer.pushCommand(std::move(command));
+            if (currentCommandList)
+                currentCommandList->commandBuffer.pushCommand(std::move(command));
+            else
+                commandBuffer.pushCommand(std::move(command));
         }
+
+        // Returns an empty command list, the lists and their transient buffers are reused every frame
+        // Must not be called while the calling thread is recording to a command list
+        CommandList& getCommandList(std::size_t index);
+        // The commands issued on the calling thread are recorded to the command list until it is set to null
+        void setCommandList(CommandList* commandList) noexcept { currentCommandList = commandList; }
+        // Appends the recorded commands to the frame after the upload of the list's transient geometry
+        void appendCommandList(CommandList& commandList);
         void present();
 
         void waitForNextFrame();
@@ -106,6 +160,10 @@ namespace ouzel::graphics
 
         std::unique_ptr<RenderDevice> device;
         renderer::Renderer renderer;
+        TransientGeometry transientGeometry;
+        std::vector<std::unique_ptr<CommandList>> commandLists;
+
+        static inline thread_local CommandList* currentCommandList = nullptr;
     };
 }
 
@@ -0,0 +1,19 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_INSTANCE_HPP
+#define OUZEL_GRAPHICS_INSTANCE_HPP
+
+#include <array>
+
+namespace ouzel::graphics
+{
+    // Per-instance data of instanced draws, laid out as RenderDevice::instanceAttributes
+    class Instance final
+    {
+    public:
+        std::array<float, 16> transform{}; // model view projection matrix
+        std::array<float, 4> color{}; // multiplied with the vertex color
+    };
+}
+
+#endif // OUZEL_GRAPHICS_INSTANCE_HPP
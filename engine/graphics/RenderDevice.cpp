@@ -1,6 +1,7 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
 #include <algorithm>
+#include <exception>
 #include "RenderDevice.hpp"
 
 namespace ouzel::graphics
@@ -24,8 +25,11 @@ namespace ouzel::graphics
         clampToBorderSupported(false),
         multisamplingSupported(false),
         uintIndicesSupported(false),
+        instancingSupported(false),
         previousFrameTime(std::chrono::steady_clock::now())
     {
+        if (!settings.captureFile.empty())
+            captureWriter = std::make_unique<CaptureWriter>(settings.captureFile);
     }
 
     void RenderDevice::process()
@@ -34,6 +38,10 @@ namespace ouzel::graphics
         event.type = Event::Type::frame;
         callback(event);
 
+        // process is called at the start of every frame
+        drawCallCount.store(currentDrawCallCount, std::memory_order_relaxed);
+        currentDrawCallCount = 0;
+
         const auto currentTime = std::chrono::steady_clock::now();
         const auto diff = std::chrono::duration_cast<std::chrono::nanoseconds>(currentTime - previousFrameTime);
         previousFrameTime = currentTime;
@@ -54,6 +62,79 @@ namespace ouzel::graphics
         }
     }
 
+    void RenderDevice::submitCommandBuffer(CommandBuffer&& commandBuffer)
+    {
+        // the capture is written outside of the queue lock, so that the render thread doesn't wait for the file,
+        // the capture lock keeps the command buffers in the capture in the order of the queue
+        std::unique_lock captureLock(captureMutex);
+
+        std::exception_ptr captureException;
+        if (captureWriter)
+        {
+            try
+            {
+                captureWriter->write(commandBuffer);
+            }
+            catch (...)
+            {
+                // the commands are still rendered, only the capture is stopped
+                captureWriter.reset();
+                captureException = std::current_exception();
+            }
+        }
+
+        std::unique_lock lock(commandQueueMutex);
+        commandQueue.push(std::move(commandBuffer));
+        lock.unlock();
+        captureLock.unlock();
+        commandQueueCondition.notify_all();
+
+        if (captureException)
+            std::rethrow_exception(captureException);
+    }
+
+    void RenderDevice::startCapture(const std::string& filename)
+    {
+        auto newCaptureWriter = std::make_unique<CaptureWriter>(filename);
+
+        std::lock_guard lock(captureMutex);
+        captureWriter = std::move(newCaptureWriter);
+    }
+
+    void RenderDevice::stopCapture()
+    {
+        std::lock_guard lock(captureMutex);
+        captureWriter.reset();
+    }
+
+    bool RenderDevice::isCapturing()
+    {
+        std::lock_guard lock(captureMutex);
+        return captureWriter != nullptr;
+    }
+
+    std::array<RenderDevice::CommandStatistics, RenderDevice::commandTypeCount> RenderDevice::getCommandStatistics() const noexcept
+    {
+        std::array<CommandStatistics, commandTypeCount> result;
+
+        for (std::size_t i = 0; i < commandTypeCount; ++i)
+        {
+            result[i].count = commandCounts[i].load(std::memory_order_relaxed);
+            result[i].time = std::chrono::nanoseconds(commandTimes[i].load(std::memory_order_relaxed));
+        }
+
+        return result;
+    }
+
+    void RenderDevice::resetCommandStatistics() noexcept
+    {
+        for (std::size_t i = 0; i < commandTypeCount; ++i)
+        {
+            commandCounts[i].store(0, std::memory_order_relaxed);
+            commandTimes[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
     std::vector<Size2U> RenderDevice::getSupportedResolutions() const
     {
         return std::vector<Size2U>();
@@ -5,11 +5,16 @@
 
 #include <array>
 #include <atomic>
+#include <cassert>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <set>
+#include <string>
+#include "CommandCapture.hpp"
 #include "Commands.hpp"
 #include "Driver.hpp"
 #include "SamplerFilter.hpp"
@@ -63,6 +68,18 @@ namespace ouzel::graphics
             Vertex::Attribute{Vertex::Attribute::Usage::normal, DataType::float32Vector3}
         };
 
+        // Layout of the per-instance stream of instanced draws (see Instance)
+        static constexpr std::array<Vertex::Attribute, 2> instanceAttributes{
+            Vertex::Attribute{Vertex::Attribute::Usage::instanceTransform, DataType::float32Matrix4},
+            Vertex::Attribute{Vertex::Attribute::Usage::instanceColor, DataType::float32Vector4}
+        };
+
+        // Layout of the skin stream of skinned draws (see SkinVertex)
+        static constexpr std::array<Vertex::Attribute, 2> skinAttributes{
+            Vertex::Attribute{Vertex::Attribute::Usage::blendIndices, DataType::unsignedByteVector4},
+            Vertex::Attribute{Vertex::Attribute::Usage::blendWeight, DataType::unsignedByteVector4Norm}
+        };
+
         struct Event
         {
             enum class Type
@@ -73,6 +90,14 @@ namespace ouzel::graphics
             Type type;
         };
 
+        static constexpr std::size_t commandTypeCount = static_cast<std::size_t>(Command::Type::setLightParameters) + 1;
+
+        struct CommandStatistics final
+        {
+            std::uint64_t count = 0;
+            std::chrono::nanoseconds time{0};
+        };
+
         RenderDevice(Driver initDriver,
                      const Settings& settings,
                      core::Window& initWindow,
@@ -93,15 +118,22 @@ namespace ouzel::graphics
 
         virtual std::vector<Size2U> getSupportedResolutions() const;
 
-        void submitCommandBuffer(CommandBuffer&& commandBuffer)
-        {
-            std::unique_lock lock(commandQueueMutex);
-            commandQueue.push(std::move(commandBuffer));
-            lock.unlock();
-            commandQueueCondition.notify_all();
-        }
+        void submitCommandBuffer(CommandBuffer&& commandBuffer);
 
-        auto getDrawCallCount() const noexcept { return drawCallCount; }
+        // Writes all of the submitted command buffers to the file until the capture is stopped
+        // The resources created before the capture is started are missing from it
+        void startCapture(const std::string& filename);
+        void stopCapture();
+        bool isCapturing();
+
+        // Measures the time that the render device spends on every command type
+        auto isCommandTimingEnabled() const noexcept { return commandTimingEnabled.load(std::memory_order_relaxed); }
+        void setCommandTimingEnabled(bool newCommandTimingEnabled) noexcept { commandTimingEnabled.store(newCommandTimingEnabled, std::memory_order_relaxed); }
+        std::array<CommandStatistics, commandTypeCount> getCommandStatistics() const noexcept;
+        void resetCommandStatistics() noexcept;
+
+        // Returns the number of draw calls in the previous frame, an instanced draw counts as one
+        auto getDrawCallCount() const noexcept { return drawCallCount.load(std::memory_order_relaxed); }
 
         auto getAPIMajorVersion() const noexcept { return apiVersion.v[0]; }
         auto getAPIMinorVersion() const noexcept { return apiVersion.v[1]; }
@@ -109,6 +141,7 @@ namespace ouzel::graphics
         auto isNPOTTexturesSupported() const noexcept { return npotTexturesSupported; }
         auto isAnisotropicFilteringSupported() const noexcept { return anisotropicFilteringSupported; }
         auto isRenderTargetsSupported() const noexcept { return renderTargetsSupported; }
+        auto isInstancingSupported() const noexcept { return instancingSupported; }
 
         auto& getProjectionTransform(bool renderTarget) const noexcept
         {
@@ -120,6 +153,10 @@ namespace ouzel::graphics
 
         void executeOnRenderThread(const std::function<void()>& func);
 
+        // Resources must not be created or destroyed while command lists are recorded on several threads,
+        // because their IDs and the order of their commands would depend on the scheduling of the threads
+        void setParallelRecording(bool newParallelRecording) noexcept { parallelRecording = newParallelRecording; }
+
         using ResourceId = std::size_t;
         class Resource final
         {
@@ -170,6 +207,14 @@ namespace ouzel::graphics
 
         virtual void generateScreenshot(const std::string& filename);
 
+        void addCommandTime(Command::Type type, std::chrono::steady_clock::duration time) noexcept
+        {
+            const auto index = static_cast<std::size_t>(type);
+            commandCounts[index].fetch_add(1, std::memory_order_relaxed);
+            commandTimes[index].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(),
+                                          std::memory_order_relaxed);
+        }
+
         Driver driver;
         core::Window& window;
         std::function<void(const Event&)> callback;
@@ -191,15 +236,23 @@ namespace ouzel::graphics
         bool clampToBorderSupported:1;
         bool multisamplingSupported:1;
         bool uintIndicesSupported:1;
+        bool instancingSupported:1;
 
         Matrix4F projectionTransform = Matrix4F::identity();
         Matrix4F renderTargetProjectionTransform = Matrix4F::identity();
 
-        std::uint32_t drawCallCount = 0;
+        std::uint32_t currentDrawCallCount = 0;
+        std::atomic<std::uint32_t> drawCallCount{0};
 
         std::queue<CommandBuffer> commandQueue;
         std::mutex commandQueueMutex;
         std::condition_variable commandQueueCondition;
+        std::mutex captureMutex;
+        std::unique_ptr<CaptureWriter> captureWriter;
+
+        std::atomic_bool commandTimingEnabled{false};
+        std::array<std::atomic<std::uint64_t>, commandTypeCount> commandCounts{};
+        std::array<std::atomic<std::int64_t>, commandTypeCount> commandTimes{}; // nanoseconds
 
         std::atomic<float> currentFPS{0.0F};
         std::chrono::steady_clock::time_point previousFrameTime;
@@ -214,6 +267,8 @@ namespace ouzel::graphics
     private:
         ResourceId createResourceId()
         {
+            assert(!parallelRecording);
+
             const auto i = deletedResourceIds.begin();
 
             if (i == deletedResourceIds.end())
@@ -228,9 +283,12 @@ namespace ouzel::graphics
 
         void deleteResourceId(ResourceId id)
         {
+            assert(!parallelRecording);
+
             deletedResourceIds.insert(id);
         }
 
+        std::atomic_bool parallelRecording{false};
         ResourceId lastResourceId = 0;
         std::set<ResourceId> deletedResourceIds;
     };
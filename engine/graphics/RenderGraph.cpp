@@ -0,0 +1,391 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include "RenderGraph.hpp"
+#include "Graphics.hpp"
+#include "RenderTarget.hpp"
+#include "Texture.hpp"
+#include "../thread/JobSystem.hpp"
+
+namespace ouzel::graphics
+{
+    RenderGraph::RenderGraph() = default;
+    RenderGraph::~RenderGraph() = default;
+
+    RenderGraph::Handle RenderGraph::importRenderTarget(RenderTarget* renderTarget)
+    {
+        for (Handle handle = 0; handle < resources.size(); ++handle)
+            if (!resources[handle].transient && resources[handle].imported == renderTarget)
+                return handle;
+
+        Resource resource;
+        resource.imported = renderTarget;
+        resources.push_back(resource);
+        compiled = false;
+
+        return resources.size() - 1;
+    }
+
+    RenderGraph::Handle RenderGraph::createRenderTarget(const TargetDescription& description)
+    {
+        if (description.size.v[0] == 0 || description.size.v[1] == 0)
+            throw std::runtime_error("Invalid render target size");
+
+        Resource resource;
+        resource.description = description;
+        resource.transient = true;
+        resources.push_back(resource);
+        compiled = false;
+
+        return resources.size() - 1;
+    }
+
+    RenderGraph::PassId RenderGraph::addPass(const std::string& name,
+                                             const std::vector<Handle>& reads,
+                                             Handle write,
+                                             const Clear& clear,
+                                             const std::function<void()>& execute)
+    {
+        for (const Handle read : reads)
+            if (read >= resources.size())
+                throw std::runtime_error("Invalid render graph resource");
+
+        if (write != invalidHandle && write >= resources.size())
+            throw std::runtime_error("Invalid render graph resource");
+
+        Pass pass;
+        pass.name = name;
+        pass.reads = reads;
+        pass.write = write;
+        pass.clear = clear;
+        pass.execute = execute;
+        passes.push_back(std::move(pass));
+        compiled = false;
+
+        return passes.size() - 1;
+    }
+
+    void RenderGraph::setSideEffects(PassId pass, bool sideEffects)
+    {
+        passes[pass].sideEffects = sideEffects;
+        compiled = false;
+    }
+
+    void RenderGraph::setRecordingGroup(PassId pass, std::size_t group)
+    {
+        passes[pass].recordingGroup = group;
+    }
+
+    void RenderGraph::compile()
+    {
+        cullPasses();
+
+        // passes are executed in the order they were declared, which is always a valid
+        // topological order because a pass can only read resources that already exist
+        executionOrder.clear();
+        for (PassId passId = 0; passId < passes.size(); ++passId)
+            if (!passes[passId].culled)
+                executionOrder.push_back(passId);
+
+        for (auto& resource : resources)
+        {
+            resource.used = false;
+            resource.cleared = false;
+        }
+
+        for (PassId position = 0; position < executionOrder.size(); ++position)
+        {
+            auto& pass = passes[executionOrder[position]];
+
+            const auto use = [this, position](Handle handle) {
+                auto& resource = resources[handle];
+                if (!resource.used)
+                {
+                    resource.used = true;
+                    resource.firstUse = position;
+                }
+                resource.lastUse = position;
+            };
+
+            for (const Handle read : pass.reads) use(read);
+
+            pass.mergedClear = false;
+
+            if (pass.write != invalidHandle)
+            {
+                use(pass.write);
+
+                // only the first clear of a resource in the frame is kept and it is
+                // performed as a part of the pass begin
+                auto& resource = resources[pass.write];
+                if (pass.clear.isEnabled() && !resource.cleared)
+                {
+                    resource.cleared = true;
+                    pass.mergedClear = true;
+                }
+            }
+        }
+
+        assignPhysicalTargets();
+
+        compiled = true;
+    }
+
+    void RenderGraph::cullPasses()
+    {
+        for (auto& resource : resources)
+            resource.referenceCount = resource.transient ? 0 : 1; // imported resources are always needed
+
+        for (auto& pass : passes)
+        {
+            pass.culled = false;
+            pass.referenceCount = (pass.write != invalidHandle) ? 1 : 0;
+            if (pass.sideEffects) ++pass.referenceCount;
+
+            for (const Handle read : pass.reads)
+                ++resources[read].referenceCount;
+        }
+
+        std::vector<Handle> unreferenced;
+        for (Handle handle = 0; handle < resources.size(); ++handle)
+            if (resources[handle].referenceCount == 0)
+                unreferenced.push_back(handle);
+
+        for (PassId passId = 0; passId < passes.size(); ++passId)
+        {
+            auto& pass = passes[passId];
+            if (pass.referenceCount == 0)
+            {
+                pass.culled = true;
+                for (const Handle read : pass.reads)
+                    if (--resources[read].referenceCount == 0)
+                        unreferenced.push_back(read);
+            }
+        }
+
+        while (!unreferenced.empty())
+        {
+            const Handle handle = unreferenced.back();
+            unreferenced.pop_back();
+
+            for (auto& pass : passes)
+            {
+                if (pass.culled || pass.write != handle) continue;
+
+                if (--pass.referenceCount == 0)
+                {
+                    pass.culled = true;
+                    for (const Handle read : pass.reads)
+                        if (--resources[read].referenceCount == 0)
+                            unreferenced.push_back(read);
+                }
+            }
+        }
+    }
+
+    void RenderGraph::assignPhysicalTargets()
+    {
+        for (auto& physicalTarget : physicalTargets)
+            physicalTarget.assigned = false;
+
+        std::vector<Handle> transientResources;
+        for (Handle handle = 0; handle < resources.size(); ++handle)
+            if (resources[handle].transient && resources[handle].used)
+                transientResources.push_back(handle);
+
+        std::stable_sort(transientResources.begin(), transientResources.end(),
+                         [this](const Handle a, const Handle b) noexcept {
+                             return resources[a].firstUse < resources[b].firstUse;
+                         });
+
+        physicalTargetCount = 0;
+
+        for (const Handle handle : transientResources)
+        {
+            auto& resource = resources[handle];
+
+            // reuse a physical target with the same description whose lifetime ended before this resource's begins
+            auto i = std::find_if(physicalTargets.begin(), physicalTargets.end(),
+                                  [&resource](const PhysicalTarget& physicalTarget) noexcept {
+                                      return physicalTarget.description == resource.description &&
+                                          (!physicalTarget.assigned || physicalTarget.lastUse < resource.firstUse);
+                                  });
+
+            if (i == physicalTargets.end())
+            {
+                PhysicalTarget physicalTarget;
+                physicalTarget.description = resource.description;
+                physicalTargets.push_back(std::move(physicalTarget));
+                i = physicalTargets.end() - 1;
+                ++allocationCount;
+            }
+
+            if (!i->assigned) ++physicalTargetCount;
+
+            i->assigned = true;
+            i->lastUse = resource.lastUse;
+            resource.physicalIndex = static_cast<std::size_t>(i - physicalTargets.begin());
+        }
+    }
+
+    void RenderGraph::execute(Graphics& graphics, thread::JobSystem* jobSystem)
+    {
+        if (!compiled) compile();
+
+        for (auto& physicalTarget : physicalTargets)
+        {
+            if (!physicalTarget.assigned || physicalTarget.renderTarget) continue;
+
+            const auto& description = physicalTarget.description;
+
+            physicalTarget.colorTexture = std::make_shared<Texture>(graphics,
+                                                                    description.size,
+                                                                    Flags::bindRenderTarget | Flags::bindShader,
+                                                                    1, description.sampleCount,
+                                                                    description.pixelFormat);
+
+            if (description.depth)
+                physicalTarget.depthTexture = std::make_unique<Texture>(graphics,
+                                                                        description.size,
+                                                                        Flags::bindRenderTarget,
+                                                                        1, description.sampleCount,
+                                                                        PixelFormat::depth);
+
+            physicalTarget.renderTarget = std::make_unique<RenderTarget>(graphics,
+                                                                         std::vector<Texture*>{physicalTarget.colorTexture.get()},
+                                                                         physicalTarget.depthTexture.get());
+        }
+
+        // positions in the execution order of the passes of every recording group
+        std::vector<std::vector<std::size_t>> groups;
+        std::map<std::size_t, std::size_t> groupIndices;
+
+        for (std::size_t i = 0; i < executionOrder.size(); ++i)
+        {
+            const auto [groupIndex, inserted] = groupIndices.insert(std::pair(passes[executionOrder[i]].recordingGroup, groups.size()));
+            if (inserted) groups.emplace_back();
+            groups[groupIndex->second].push_back(i);
+        }
+
+        // every pass records into its own command list, also when the passes are recorded on the calling thread,
+        // so the commands of the frame are the same with and without the job system
+        // the command lists and their buffers are created before the recording starts,
+        // so their creation commands are before the recorded ones
+        std::vector<CommandList*> commandLists(executionOrder.size());
+        for (std::size_t i = 0; i < executionOrder.size(); ++i)
+            commandLists[i] = &graphics.getCommandList(i);
+
+        const auto record = [this, &graphics, &commandLists](const std::vector<std::size_t>& positions) {
+            try
+            {
+                for (const std::size_t i : positions)
+                {
+                    graphics.setCommandList(commandLists[i]);
+                    executePass(graphics, passes[executionOrder[i]]);
+                }
+            }
+            catch (...)
+            {
+                graphics.setCommandList(nullptr);
+                throw;
+            }
+
+            graphics.setCommandList(nullptr);
+        };
+
+        if (!jobSystem || groups.size() < 2)
+        {
+            std::vector<std::size_t> positions(executionOrder.size());
+            std::iota(positions.begin(), positions.end(), std::size_t(0));
+            record(positions);
+        }
+        else
+        {
+            RenderDevice& device = *graphics.getDevice();
+            device.setParallelRecording(true);
+
+            try
+            {
+                std::vector<thread::JobHandle> jobs;
+                jobs.reserve(groups.size());
+
+                for (const auto& group : groups)
+                    jobs.push_back(jobSystem->schedule([&record, &group]() { record(group); }));
+
+                jobSystem->wait(jobs);
+            }
+            catch (...)
+            {
+                device.setParallelRecording(false);
+                throw;
+            }
+
+            device.setParallelRecording(false);
+        }
+
+        for (CommandList* commandList : commandLists)
+            graphics.appendCommandList(*commandList);
+    }
+
+    void RenderGraph::executePass(Graphics& graphics, const Pass& pass) const
+    {
+        if (pass.write != invalidHandle)
+        {
+            const RenderTarget* renderTarget = getRenderTarget(pass.write);
+            graphics.setRenderTarget(renderTarget ? renderTarget->getResource() : 0);
+
+            if (pass.mergedClear)
+                graphics.clearRenderTarget(pass.clear.colorBuffer,
+                                           pass.clear.depthBuffer,
+                                           pass.clear.stencilBuffer,
+                                           pass.clear.color,
+                                           pass.clear.depth,
+                                           pass.clear.stencil);
+        }
+
+        if (pass.execute) pass.execute();
+    }
+
+    void RenderGraph::reset()
+    {
+        resources.clear();
+        passes.clear();
+        executionOrder.clear();
+        compiled = false;
+    }
+
+    void RenderGraph::releaseRenderTargets()
+    {
+        physicalTargets.clear();
+        physicalTargetCount = 0;
+        compiled = false;
+    }
+
+    RenderTarget* RenderGraph::getRenderTarget(Handle handle) const
+    {
+        const auto& resource = resources[handle];
+
+        if (!resource.transient) return resource.imported;
+        if (!resource.used || resource.physicalIndex >= physicalTargets.size()) return nullptr;
+
+        return physicalTargets[resource.physicalIndex].renderTarget.get();
+    }
+
+    Texture* RenderGraph::getColorTexture(Handle handle) const
+    {
+        const auto& resource = resources[handle];
+
+        if (!resource.transient)
+        {
+            if (!resource.imported || resource.imported->getColorTextures().empty()) return nullptr;
+            return resource.imported->getColorTextures().front();
+        }
+
+        if (!resource.used || resource.physicalIndex >= physicalTargets.size()) return nullptr;
+
+        return physicalTargets[resource.physicalIndex].colorTexture.get();
+    }
+}
@@ -0,0 +1,180 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_RENDERGRAPH_HPP
+#define OUZEL_GRAPHICS_RENDERGRAPH_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "PixelFormat.hpp"
+#include "../math/Color.hpp"
+#include "../math/Size.hpp"
+
+namespace ouzel::thread
+{
+    class JobSystem;
+}
+
+namespace ouzel::graphics
+{
+    class Graphics;
+    class RenderTarget;
+    class Texture;
+
+    // Frame graph for render target passes
+    // Passes declare the targets they read and write, passes that don't contribute to
+    // an imported target are culled and transient targets with non-overlapping lifetimes
+    // share the same physical render target
+    class RenderGraph final
+    {
+    public:
+        using Handle = std::size_t;
+        using PassId = std::size_t;
+
+        static constexpr Handle invalidHandle = static_cast<Handle>(-1);
+
+        struct TargetDescription final
+        {
+            Size2U size;
+            PixelFormat pixelFormat = PixelFormat::rgba8UnsignedNorm;
+            std::uint32_t sampleCount = 1;
+            bool depth = false;
+
+            bool operator==(const TargetDescription& other) const noexcept
+            {
+                return size == other.size &&
+                    pixelFormat == other.pixelFormat &&
+                    sampleCount == other.sampleCount &&
+                    depth == other.depth;
+            }
+
+            bool operator!=(const TargetDescription& other) const noexcept
+            {
+                return !(*this == other);
+            }
+        };
+
+        struct Clear final
+        {
+            bool colorBuffer = false;
+            bool depthBuffer = false;
+            bool stencilBuffer = false;
+            Color color;
+            float depth = 1.0F;
+            std::uint32_t stencil = 0;
+
+            bool isEnabled() const noexcept { return colorBuffer || depthBuffer || stencilBuffer; }
+        };
+
+        RenderGraph();
+        ~RenderGraph();
+
+        RenderGraph(const RenderGraph&) = delete;
+        RenderGraph& operator=(const RenderGraph&) = delete;
+
+        RenderGraph(RenderGraph&&) = delete;
+        RenderGraph& operator=(RenderGraph&&) = delete;
+
+        // Imported targets (nullptr is the back buffer) live outside of the graph,
+        // so passes writing them are never culled
+        Handle importRenderTarget(RenderTarget* renderTarget);
+        Handle createRenderTarget(const TargetDescription& description);
+
+        PassId addPass(const std::string& name,
+                       const std::vector<Handle>& reads,
+                       Handle write,
+                       const Clear& clear,
+                       const std::function<void()>& execute);
+
+        // Keeps the pass even if nothing reads its output
+        void setSideEffects(PassId pass, bool sideEffects = true);
+
+        // Passes of different recording groups are recorded in parallel by execute, the passes of
+        // a group are recorded one after another on the same thread, all passes are in group 0 by default
+        void setRecordingGroup(PassId pass, std::size_t group);
+
+        void compile();
+
+        // Every pass records into its own command list and the lists are appended in the execution order,
+        // so the commands are the same as when the passes are recorded on the calling thread (without the job system)
+        // The passes must not create or destroy graphics resources while they are recorded in parallel
+        void execute(Graphics& graphics, thread::JobSystem* jobSystem = nullptr);
+
+        // Removes all passes and resources, physical render targets are kept for the next frame
+        void reset();
+
+        // Releases all the physical render targets
+        void releaseRenderTargets();
+
+        RenderTarget* getRenderTarget(Handle handle) const;
+        Texture* getColorTexture(Handle handle) const;
+
+        auto& getExecutionOrder() const noexcept { return executionOrder; }
+        auto getPassCount() const noexcept { return passes.size(); }
+        const std::string& getPassName(PassId pass) const { return passes[pass].name; }
+        bool isPassCulled(PassId pass) const { return passes[pass].culled; }
+        bool isPassClearing(PassId pass) const { return passes[pass].mergedClear; }
+
+        // Number of physical render targets needed by the compiled frame
+        auto getPhysicalTargetCount() const noexcept { return physicalTargetCount; }
+        // Number of physical render targets created since the graph was created
+        auto getAllocationCount() const noexcept { return allocationCount; }
+
+    private:
+        struct Resource final
+        {
+            TargetDescription description;
+            RenderTarget* imported = nullptr;
+            bool transient = false;
+
+            PassId firstUse = 0;
+            PassId lastUse = 0;
+            bool used = false;
+            bool cleared = false;
+            std::size_t referenceCount = 0;
+            std::size_t physicalIndex = 0;
+        };
+
+        struct Pass final
+        {
+            std::string name;
+            std::vector<Handle> reads;
+            Handle write = invalidHandle;
+            Clear clear;
+            std::function<void()> execute;
+            bool sideEffects = false;
+            std::size_t recordingGroup = 0;
+
+            std::size_t referenceCount = 0;
+            bool culled = false;
+            bool mergedClear = false;
+        };
+
+        struct PhysicalTarget final
+        {
+            TargetDescription description;
+            std::shared_ptr<Texture> colorTexture;
+            std::unique_ptr<Texture> depthTexture;
+            std::unique_ptr<RenderTarget> renderTarget;
+            PassId lastUse = 0;
+            bool assigned = false;
+        };
+
+        void cullPasses();
+        void assignPhysicalTargets();
+        void executePass(Graphics& graphics, const Pass& pass) const;
+
+        std::vector<Resource> resources;
+        std::vector<Pass> passes;
+        std::vector<PassId> executionOrder;
+        std::vector<PhysicalTarget> physicalTargets;
+
+        std::size_t physicalTargetCount = 0;
+        std::size_t allocationCount = 0;
+        bool compiled = false;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_RENDERGRAPH_HPP
@@ -4,6 +4,7 @@
 #define OUZEL_GRAPHICS_SETTINGS_HPP
 
 #include <cstdint>
+#include <string>
 #include "SamplerFilter.hpp"
 
 namespace ouzel::graphics
@@ -18,6 +19,8 @@ namespace ouzel::graphics
         bool depth = false;
         bool stencil = false;
         bool debugRenderer = false;
+        std::string captureFile; // see RenderDevice::startCapture
+        std::string programCacheDirectory; // OpenGL program binaries are cached in it if not empty
     };
 }
 
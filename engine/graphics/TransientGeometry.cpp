@@ -0,0 +1,86 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "TransientGeometry.hpp"
+#include "Graphics.hpp"
+
+namespace ouzel::graphics
+{
+    namespace
+    {
+        constexpr std::uint32_t initialIndexCapacity = 32768 * sizeof(std::uint16_t);
+        constexpr std::uint32_t initialVertexCapacity = 16384 * sizeof(Vertex);
+
+        void upload(CommandBuffer& commandBuffer, const Buffer& buffer,
+                    std::vector<std::uint8_t>& data, std::uint32_t& capacity)
+        {
+            if (data.empty()) return;
+
+            const auto size = static_cast<std::uint32_t>(data.size());
+
+            // the backends reallocate the buffer only when the data does not fit in it, so it is grown geometrically
+            if (size > capacity)
+            {
+                capacity = std::max(size, capacity * 2);
+                data.resize(capacity);
+            }
+
+            commandBuffer.pushCommand(std::make_unique<SetBufferDataCommand>(buffer.getResource(), std::move(data)));
+
+            data = std::vector<std::uint8_t>();
+            data.reserve(size);
+        }
+    }
+
+    TransientGeometry::TransientGeometry(Graphics& graphics):
+        indexBuffer(graphics,
+                    BufferType::index,
+                    Flags::dynamic | Flags::transient,
+                    initialIndexCapacity),
+        vertexBuffer(graphics,
+                     BufferType::vertex,
+                     Flags::dynamic | Flags::transient,
+                     initialVertexCapacity),
+        indexCapacity(initialIndexCapacity),
+        vertexCapacity(initialVertexCapacity)
+    {
+    }
+
+    std::uint32_t TransientGeometry::addVertices(const Vertex* vertices, std::uint32_t count)
+    {
+        std::lock_guard lock(dataMutex);
+
+        const auto baseVertex = static_cast<std::uint32_t>(vertexData.size() / sizeof(Vertex));
+        const auto data = reinterpret_cast<const std::uint8_t*>(vertices);
+        vertexData.insert(vertexData.end(), data, data + count * sizeof(Vertex));
+        return baseVertex;
+    }
+
+    std::uint32_t TransientGeometry::addIndices(const std::uint16_t* indices, std::uint32_t count)
+    {
+        std::lock_guard lock(dataMutex);
+
+        const auto startIndex = static_cast<std::uint32_t>(indexData.size() / sizeof(std::uint16_t));
+        const auto data = reinterpret_cast<const std::uint8_t*>(indices);
+        indexData.insert(indexData.end(), data, data + count * sizeof(std::uint16_t));
+        return startIndex;
+    }
+
+    CommandBuffer TransientGeometry::flush()
+    {
+        std::lock_guard lock(dataMutex);
+
+        CommandBuffer commandBuffer;
+        upload(commandBuffer, indexBuffer, indexData, indexCapacity);
+        upload(commandBuffer, vertexBuffer, vertexData, vertexCapacity);
+        return commandBuffer;
+    }
+
+    void TransientGeometry::discard()
+    {
+        std::lock_guard lock(dataMutex);
+
+        indexData.clear();
+        vertexData.clear();
+    }
+}
@@ -0,0 +1,57 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_TRANSIENTGEOMETRY_HPP
+#define OUZEL_GRAPHICS_TRANSIENTGEOMETRY_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "Buffer.hpp"
+#include "Commands.hpp"
+#include "Vertex.hpp"
+
+namespace ouzel::graphics
+{
+    class Graphics;
+
+    // Vertices and indices that are drawn only in the current frame
+    // The geometry of the whole frame is uploaded with one command per buffer before the frame's draws,
+    // which refer to it by the returned start index and base vertex
+    class TransientGeometry final
+    {
+        friend Graphics;
+    public:
+        explicit TransientGeometry(Graphics& graphics);
+
+        TransientGeometry(const TransientGeometry&) = delete;
+        TransientGeometry& operator=(const TransientGeometry&) = delete;
+
+        TransientGeometry(TransientGeometry&&) = delete;
+        TransientGeometry& operator=(TransientGeometry&&) = delete;
+
+        // Returns the base vertex of the vertices in the vertex buffer
+        std::uint32_t addVertices(const Vertex* vertices, std::uint32_t count);
+        // Returns the start index of the 16-bit indices in the index buffer
+        std::uint32_t addIndices(const std::uint16_t* indices, std::uint32_t count);
+
+        auto& getIndexBuffer() const noexcept { return indexBuffer; }
+        auto& getVertexBuffer() const noexcept { return vertexBuffer; }
+
+    private:
+        // Returns the upload commands of the frame and starts the next one
+        CommandBuffer flush();
+        // Drops the geometry of the frame
+        void discard();
+
+        Buffer indexBuffer;
+        Buffer vertexBuffer;
+
+        std::mutex dataMutex;
+        std::vector<std::uint8_t> indexData;
+        std::vector<std::uint8_t> vertexData;
+        std::uint32_t indexCapacity;
+        std::uint32_t vertexCapacity;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_TRANSIENTGEOMETRY_HPP
@@ -4,6 +4,7 @@
 #define OUZEL_GRAPHICS_VERTEX_HPP
 
 #include <array>
+#include <cstdint>
 #include "DataType.hpp"
 #include "../math/Vector.hpp"
 #include "../math/Color.hpp"
@@ -28,7 +29,9 @@ namespace ouzel::graphics
                 pointSize,
                 tangent,
                 textureCoordinates0,
-                textureCoordinates1
+                textureCoordinates1,
+                instanceTransform,
+                instanceColor
             };
 
             constexpr Attribute(Usage initUsage, DataType initDataType) noexcept:
@@ -50,6 +53,14 @@ namespace ouzel::graphics
         std::array<Vector2F, 2> texCoords;
         Vector3F normal;
     };
+
+    // Bone influences of a vertex, kept in a separate stream that only the skinned meshes bind
+    class SkinVertex final
+    {
+    public:
+        std::array<std::uint8_t, 4> blendIndices{};
+        std::array<std::uint8_t, 4> blendWeights{};
+    };
 }
 
 #endif // OUZEL_GRAPHICS_VERTEX_HPP
@@ -13,6 +13,7 @@
 #include "D3D11RenderTarget.hpp"
 #include "D3D11Shader.hpp"
 #include "D3D11Texture.hpp"
+#include "../Instance.hpp"
 #include "../../core/Engine.hpp"
 #include "../../core/Window.hpp"
 #include "../../core/windows/NativeWindowWin.hpp"
@@ -83,6 +84,7 @@ namespace ouzel::graphics::d3d11
         clampToBorderSupported = true;
         multisamplingSupported = true;
         uintIndicesSupported = true;
+        instancingSupported = true;
 
         UINT deviceCreationFlags = 0;
 
@@ -139,7 +141,7 @@ namespace ouzel::graphics::d3d11
             {
                 auto buffer = std::make_unique<char[]>(bufferSize);
                 if (WideCharToMultiByte(CP_UTF8, 0, adapterDesc.Description, -1, buffer.get(), bufferSize, nullptr, nullptr) != 0)
-                    logger.log(Log::Level::info) << "Using " << buffer.get() << " for rendering";
+                    OUZEL_LOG(Log::Level::info) << "Using " << buffer.get() << " for rendering";
             }
         }
 
@@ -161,7 +163,7 @@ namespace ouzel::graphics::d3d11
         if (supportedSampleCount != sampleCount)
         {
             sampleCount = supportedSampleCount;
-            logger.log(Log::Level::warning) << "Chosen sample count not supported, using: " << sampleCount;
+            OUZEL_LOG(Log::Level::warning) << "Chosen sample count not supported, using: " << sampleCount;
         }
 
         DXGI_SWAP_CHAIN_DESC swapChainDesc;
@@ -332,6 +334,8 @@ namespace ouzel::graphics::d3d11
         std::vector<ID3D11ShaderResourceView*> currentResourceViews;
         std::vector<ID3D11SamplerState*> currentSamplerStates;
 
+        const bool commandTiming = isCommandTimingEnabled();
+
         CommandBuffer commandBuffer;
         std::unique_ptr<Command> command;
 
@@ -347,6 +351,8 @@ namespace ouzel::graphics::d3d11
             {
                 command = commandBuffer.popCommand();
 
+                const auto commandStart = commandTiming ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
                 switch (command->type)
                 {
                     case Command::Type::resize:
@@ -607,7 +613,26 @@ namespace ouzel::graphics::d3d11
                         assert(indexBuffer->getSize());
                         assert(vertexBuffer->getSize());
 
-                        context->DrawIndexed(drawCommand->indexCount, drawCommand->startIndex, 0);
+                        if (drawCommand->instanceBuffer)
+                        {
+                            auto instanceBuffer = getResource<Buffer>(drawCommand->instanceBuffer);
+
+                            assert(instanceBuffer);
+                            assert(instanceBuffer->getBuffer());
+
+                            ID3D11Buffer* instanceBuffers[] = {instanceBuffer->getBuffer().get()};
+                            UINT instanceStrides[] = {sizeof(Instance)};
+                            context->IASetVertexBuffers(1, 1, instanceBuffers, instanceStrides, offsets);
+
+                            context->DrawIndexedInstanced(drawCommand->indexCount, drawCommand->instanceCount,
+                                                          drawCommand->startIndex,
+                                                          static_cast<INT>(drawCommand->baseVertex), 0);
+                        }
+                        else
+                            context->DrawIndexed(drawCommand->indexCount, drawCommand->startIndex,
+                                                 static_cast<INT>(drawCommand->baseVertex));
+
+                        ++currentDrawCallCount;
 
                         break;
                     }
@@ -810,6 +835,8 @@ namespace ouzel::graphics::d3d11
                         throw std::runtime_error("Invalid command");
                 }
 
+                if (commandTiming) addCommandTime(command->type, std::chrono::steady_clock::now() - commandStart);
+
                 if (command->type == Command::Type::present) return;
             }
         }
@@ -1077,7 +1104,7 @@ namespace ouzel::graphics::d3d11
             }
             catch (const std::exception& e)
             {
-                logger.log(Log::Level::error) << e.what();
+                OUZEL_LOG(Log::Level::error) << e.what();
             }
         }
     }
@@ -171,6 +171,40 @@ namespace ouzel::graphics::d3d11
             offset += getDataTypeSize(vertexAttribute.dataType);
         }
 
+        // the instance attributes are read from the second slot, matrices take an element per row
+        UINT instanceOffset = 0;
+
+        for (const auto& instanceAttribute : RenderDevice::instanceAttributes)
+        {
+            const UINT rows = (instanceAttribute.dataType == DataType::float32Matrix4) ? 4 : 1;
+
+            if (vertexAttributes.find(instanceAttribute.usage) != vertexAttributes.end())
+            {
+                const char* semantic;
+
+                switch (instanceAttribute.usage)
+                {
+                    case Vertex::Attribute::Usage::instanceTransform:
+                        semantic = "INSTANCETRANSFORM";
+                        break;
+                    case Vertex::Attribute::Usage::instanceColor:
+                        semantic = "INSTANCECOLOR";
+                        break;
+                    default:
+                        throw std::runtime_error("Invalid instance attribute usage");
+                }
+
+                for (UINT row = 0; row < rows; ++row)
+                    vertexInputElements.push_back({
+                        semantic, row,
+                        DXGI_FORMAT_R32G32B32A32_FLOAT,
+                        1, static_cast<UINT>(instanceOffset + row * sizeof(float) * 4), D3D11_INPUT_PER_INSTANCE_DATA, 1
+                    });
+            }
+
+            instanceOffset += getDataTypeSize(instanceAttribute.dataType);
+        }
+
         ID3D11InputLayout* newInputLayout;
 
         if (const auto hr = renderDevice.getDevice()->CreateInputLayout(vertexInputElements.data(),
@@ -15,10 +15,38 @@ namespace ouzel::graphics::empty
                      const std::function<void(const Event&)>& initCallback):
             graphics::RenderDevice(Driver::empty, settings, initWindow, initCallback)
         {
+            instancingSupported = true;
         }
 
-    private:
-        void process() final {}
+        // Discards the submitted commands and only counts the draw calls
+        // There is no render thread, so this is called by Graphics after every submit
+        void process() final
+        {
+            graphics::RenderDevice::process();
+            executeAll();
+
+            const bool commandTiming = isCommandTimingEnabled();
+
+            for (;;)
+            {
+                std::unique_lock lock(commandQueueMutex);
+                if (commandQueue.empty()) break;
+                CommandBuffer commandBuffer = std::move(commandQueue.front());
+                commandQueue.pop();
+                lock.unlock();
+
+                while (!commandBuffer.isEmpty())
+                {
+                    const auto commandStart = commandTiming ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
+                    const auto command = commandBuffer.popCommand();
+                    if (command->type == Command::Type::draw)
+                        ++currentDrawCallCount;
+
+                    if (commandTiming) addCommandTime(command->type, std::chrono::steady_clock::now() - commandStart);
+                }
+            }
+        }
     };
 }
 
@@ -3,6 +3,7 @@
 #ifndef OUZEL_GRAPHICS_METALBUFFER_HPP
 #define OUZEL_GRAPHICS_METALBUFFER_HPP
 
+#include <cstddef>
 #include "../../core/Setup.h"
 
 #if OUZEL_COMPILE_METAL
@@ -49,6 +50,11 @@ namespace ouzel::graphics::metal
 
         Pointer<MTLBufferPtr> buffer;
         NSUInteger size = 0;
+
+        // transient buffers rotate through a buffer for every frame that can be in flight
+        static constexpr std::size_t frameBufferCount = 3;
+        Pointer<MTLBufferPtr> frameBuffers[frameBufferCount];
+        std::size_t frameBufferIndex = 0;
     };
 }
 
@@ -22,6 +22,9 @@ namespace ouzel::graphics::metal
     {
         createBuffer(initSize);
 
+        if ((flags & Flags::transient) == Flags::transient)
+            frameBuffers[0] = buffer;
+
         if (!data.empty())
             std::copy(data.begin(), data.end(), static_cast<std::uint8_t*>([buffer.get() contents]));
     }
@@ -34,7 +37,21 @@ namespace ouzel::graphics::metal
         if (data.empty())
             throw Error("Data is empty");
 
-        if (!buffer || data.size() > size)
+        if ((flags & Flags::transient) == Flags::transient)
+        {
+            // the GPU may still be reading the buffers of the previous frames
+            static_assert(frameBufferCount == RenderDevice::bufferCount);
+            if (++frameBufferIndex >= frameBufferCount) frameBufferIndex = 0;
+            buffer = frameBuffers[frameBufferIndex];
+            size = buffer ? [buffer.get() length] : 0;
+
+            if (!buffer || data.size() > size)
+            {
+                createBuffer(static_cast<std::uint32_t>(data.size()));
+                frameBuffers[frameBufferIndex] = buffer;
+            }
+        }
+        else if (!buffer || data.size() > size)
             createBuffer(static_cast<std::uint32_t>(data.size()));
 
         std::copy(data.begin(), data.end(), static_cast<std::uint8_t*>([buffer.get() contents]));
@@ -15,6 +15,7 @@
 #include "MetalRenderTarget.hpp"
 #include "MetalShader.hpp"
 #include "MetalTexture.hpp"
+#include "../Instance.hpp"
 #include "../../core/Engine.hpp"
 #include "../../events/EventDispatcher.hpp"
 #include "../../utils/Log.hpp"
@@ -112,6 +113,7 @@ namespace ouzel::graphics::metal
         renderTargetsSupported = true;
         multisamplingSupported = true;
         uintIndicesSupported = true;
+        instancingSupported = true;
 
         device = MTLCreateSystemDefaultDevice();
 
@@ -119,7 +121,7 @@ namespace ouzel::graphics::metal
             throw Error("Failed to create Metal device");
 
         if (device.get().name)
-            logger.log(Log::Level::info) << "Using " << [device.get().name cStringUsingEncoding:NSUTF8StringEncoding] << " for rendering";
+            OUZEL_LOG(Log::Level::info) << "Using " << [device.get().name cStringUsingEncoding:NSUTF8StringEncoding] << " for rendering";
 
 #if defined(__MAC_10_12) && __MAC_OS_X_VERSION_MAX_ALLOWED >= __MAC_10_12
         // MTLFeatureSet_macOS_GPUFamily1_v2 is not defined in macOS SDK older than 10.12
@@ -258,6 +260,8 @@ namespace ouzel::graphics::metal
         const RenderTarget* currentRenderTarget = nullptr;
         const Shader* currentShader = nullptr;
 
+        const bool commandTiming = isCommandTimingEnabled();
+
         CommandBuffer commandBuffer;
         std::unique_ptr<Command> command;
 
@@ -273,6 +277,8 @@ namespace ouzel::graphics::metal
             {
                 command = commandBuffer.popCommand();
 
+                const auto commandStart = commandTiming ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
                 switch (command->type)
                 {
                     case Command::Type::resize:
@@ -532,18 +538,41 @@ namespace ouzel::graphics::metal
                         assert(vertexBuffer);
                         assert(vertexBuffer->getBuffer());
 
-                        [currentRenderCommandEncoder setVertexBuffer:vertexBuffer->getBuffer().get() offset:0 atIndex:0];
+                        // the buffer is offset because the base vertex draw calls are not supported by all the iOS GPUs
+                        [currentRenderCommandEncoder setVertexBuffer:vertexBuffer->getBuffer().get()
+                                                              offset:drawCommand->baseVertex * sizeof(Vertex)
+                                                             atIndex:0];
 
                         // draw
                         assert(drawCommand->indexCount);
                         assert(indexBuffer->getSize());
                         assert(vertexBuffer->getSize());
 
-                        [currentRenderCommandEncoder drawIndexedPrimitives:getPrimitiveType(drawCommand->drawMode)
-                                                                indexCount:drawCommand->indexCount
-                                                                 indexType:getIndexType(drawCommand->indexSize)
-                                                               indexBuffer:indexBuffer->getBuffer().get()
-                                                         indexBufferOffset:drawCommand->startIndex * drawCommand->indexSize];
+                        if (drawCommand->instanceBuffer)
+                        {
+                            auto instanceBuffer = getResource<Buffer>(drawCommand->instanceBuffer);
+
+                            assert(instanceBuffer);
+                            assert(instanceBuffer->getBuffer());
+
+                            // index 1 is used by the shader constants
+                            [currentRenderCommandEncoder setVertexBuffer:instanceBuffer->getBuffer().get() offset:0 atIndex:2];
+
+                            [currentRenderCommandEncoder drawIndexedPrimitives:getPrimitiveType(drawCommand->drawMode)
+                                                                    indexCount:drawCommand->indexCount
+                                                                     indexType:getIndexType(drawCommand->indexSize)
+                                                                   indexBuffer:indexBuffer->getBuffer().get()
+                                                             indexBufferOffset:drawCommand->startIndex * drawCommand->indexSize
+                                                                 instanceCount:drawCommand->instanceCount];
+                        }
+                        else
+                            [currentRenderCommandEncoder drawIndexedPrimitives:getPrimitiveType(drawCommand->drawMode)
+                                                                    indexCount:drawCommand->indexCount
+                                                                     indexType:getIndexType(drawCommand->indexSize)
+                                                                   indexBuffer:indexBuffer->getBuffer().get()
+                                                             indexBufferOffset:drawCommand->startIndex * drawCommand->indexSize];
+
+                        ++currentDrawCallCount;
 
                         break;
                     }
@@ -797,6 +826,8 @@ namespace ouzel::graphics::metal
                     default: throw Error("Invalid command");
                 }
 
+                if (commandTiming) addCommandTime(command->type, std::chrono::steady_clock::now() - commandStart);
+
                 if (command->type == Command::Type::present) return;
             }
         }
@@ -122,6 +122,37 @@ namespace ouzel::graphics::metal
         vertexDescriptor.get().layouts[0].stepRate = 1;
         vertexDescriptor.get().layouts[0].stepFunction = MTLVertexStepFunctionPerVertex;
 
+        // the instance attributes are read from the buffer at index 2, matrices take an attribute per column
+        NSUInteger instanceOffset = 0;
+        bool instanced = false;
+
+        for (const auto& instanceAttribute : RenderDevice::instanceAttributes)
+        {
+            const NSUInteger columns = (instanceAttribute.dataType == DataType::float32Matrix4) ? 4 : 1;
+
+            if (vertexAttributes.find(instanceAttribute.usage) != vertexAttributes.end())
+            {
+                for (NSUInteger column = 0; column < columns; ++column)
+                {
+                    vertexDescriptor.get().attributes[index].format = MTLVertexFormatFloat4;
+                    vertexDescriptor.get().attributes[index].offset = instanceOffset + column * sizeof(float) * 4;
+                    vertexDescriptor.get().attributes[index].bufferIndex = 2;
+                    ++index;
+                }
+
+                instanced = true;
+            }
+
+            instanceOffset += getDataTypeSize(instanceAttribute.dataType);
+        }
+
+        if (instanced)
+        {
+            vertexDescriptor.get().layouts[2].stride = instanceOffset;
+            vertexDescriptor.get().layouts[2].stepRate = 1;
+            vertexDescriptor.get().layouts[2].stepFunction = MTLVertexStepFunctionPerInstance;
+        }
+
         NSError* err;
 
         dispatch_data_t fragmentShaderDispatchData = dispatch_data_create(fragmentShaderData.data(), fragmentShaderData.size(), nullptr, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
@@ -28,7 +28,7 @@ namespace ouzel::graphics::metal::ios
             }
             catch (const std::exception& e)
             {
-                logger.log(Log::Level::error) << e.what();
+                OUZEL_LOG(Log::Level::error) << e.what();
             }
         }
     }
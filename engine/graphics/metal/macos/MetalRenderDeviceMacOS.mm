@@ -37,7 +37,7 @@ namespace ouzel::graphics::metal::macos
             }
             catch (const std::exception& e)
             {
-                logger.log(Log::Level::error) << e.what();
+                OUZEL_LOG(Log::Level::error) << e.what();
                 return kCVReturnError;
             }
 
@@ -24,7 +24,7 @@ namespace ouzel::graphics::metal::tvos
             }
             catch (const std::exception& e)
             {
-                logger.log(Log::Level::error) << e.what();
+                OUZEL_LOG(Log::Level::error) << e.what();
             }
         }
     }
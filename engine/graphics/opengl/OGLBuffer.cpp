@@ -75,11 +75,29 @@ namespace ouzel::graphics::opengl
         if (newData.empty())
             throw std::invalid_argument("Data is empty");
 
-        data = newData;
-
         if (!bufferId)
             throw Error("Buffer not initialized");
 
+        if ((flags & Flags::transient) == Flags::transient)
+        {
+            // orphan the storage that the previous frames may still be drawing from instead of waiting for them,
+            // the data is not kept for reloading, because it is replaced in the next frame
+            renderDevice.bindBuffer(bufferType, bufferId);
+
+            if (static_cast<GLsizeiptr>(newData.size()) > size)
+                size = static_cast<GLsizeiptr>(newData.size());
+
+            renderDevice.glBufferDataProc(bufferType, size, nullptr, GL_STREAM_DRAW);
+            renderDevice.glBufferSubDataProc(bufferType, 0, static_cast<GLsizeiptr>(newData.size()), newData.data());
+
+            if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
+                throw std::system_error(makeErrorCode(error), "Failed to upload buffer");
+
+            return;
+        }
+
+        data = newData;
+
         renderDevice.bindBuffer(bufferType, bufferId);
 
         if (static_cast<GLsizeiptr>(data.size()) > size)
@@ -0,0 +1,239 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include "../../core/Setup.h"
+
+#if OUZEL_COMPILE_OPENGL
+
+#include <cstdio>
+#include <fstream>
+#include "OGLProgramCache.hpp"
+#include "OGLError.hpp"
+#include "OGLRenderDevice.hpp"
+#include "../../formats/Cooked.hpp"
+#include "../../hash/Fnv1.hpp"
+#include "../../utils/Log.hpp"
+
+namespace ouzel::graphics::opengl
+{
+    namespace
+    {
+        static_assert(sizeof(GLint) == sizeof(std::int32_t));
+
+        // the size is hashed too, so that the boundaries of the values are part of the key
+        std::uint64_t hashString(std::string_view str, std::uint64_t result) noexcept
+        {
+            return hash::fnv1::hash<std::uint64_t>(str, hash::fnv1::hash<std::uint64_t>(static_cast<std::uint64_t>(str.size()), 0, result));
+        }
+
+        std::uint64_t hashValue(std::uint32_t value, std::uint64_t result) noexcept
+        {
+            return hash::fnv1::hash<std::uint64_t>(value, 0, result);
+        }
+
+        // every call of glGetError returns and clears only one of the recorded errors
+        void clearErrors(RenderDevice& renderDevice)
+        {
+            while (renderDevice.glGetErrorProc() != GL_NO_ERROR)
+                continue;
+        }
+
+        double toMilliseconds(std::chrono::nanoseconds time) noexcept
+        {
+            return std::chrono::duration<double, std::milli>(time).count();
+        }
+    }
+
+    ProgramCache::ProgramCache(RenderDevice& initRenderDevice, const std::string& initDirectory):
+        renderDevice(initRenderDevice),
+        directory(initDirectory)
+    {
+    }
+
+    void ProgramCache::init(std::string_view vendorName, std::string_view rendererName, std::string_view versionName)
+    {
+        if (directory.isEmpty()) return;
+
+        driverKey = hashString(versionName, hashString(rendererName, hashString(vendorName, hash::fnv1::Constants<std::uint64_t>::offsetBasis)));
+    }
+
+    std::uint64_t ProgramCache::getKey(const std::vector<std::uint8_t>& fragmentShader,
+                                       const std::vector<std::uint8_t>& vertexShader,
+                                       const std::set<Vertex::Attribute::Usage>& vertexAttributes,
+                                       const std::vector<std::pair<std::string, DataType>>& fragmentShaderConstantInfo,
+                                       const std::vector<std::pair<std::string, DataType>>& vertexShaderConstantInfo) const noexcept
+    {
+        auto result = driverKey;
+
+        result = hashString(std::string_view(reinterpret_cast<const char*>(fragmentShader.data()), fragmentShader.size()), result);
+        result = hashString(std::string_view(reinterpret_cast<const char*>(vertexShader.data()), vertexShader.size()), result);
+
+        result = hashValue(static_cast<std::uint32_t>(vertexAttributes.size()), result);
+        for (const auto usage : vertexAttributes)
+            result = hashValue(static_cast<std::uint32_t>(usage), result);
+
+        for (const auto constantInfo : {&fragmentShaderConstantInfo, &vertexShaderConstantInfo})
+        {
+            result = hashValue(static_cast<std::uint32_t>(constantInfo->size()), result);
+            for (const auto& [name, dataType] : *constantInfo)
+                result = hashValue(static_cast<std::uint32_t>(dataType), hashString(name, result));
+        }
+
+        return result;
+    }
+
+    bool ProgramCache::load(std::uint64_t key, GLuint programId, std::size_t uniformCount,
+                            std::vector<GLint>& uniformLocations)
+    {
+        const auto loadStart = std::chrono::steady_clock::now();
+
+        std::ifstream file(getEntryPath(key), std::ios::binary);
+        if (!file)
+        {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        std::vector<std::byte> data;
+        std::byte buffer[4096];
+
+        while (!file.eof())
+        {
+            file.read(reinterpret_cast<char*>(buffer), sizeof(buffer));
+            data.insert(data.end(), buffer, buffer + file.gcount());
+        }
+
+        bool loaded = false;
+
+        try
+        {
+            const auto entry = cooked::readProgramBinary(data.data(), data.size(), key, uniformCount);
+
+            // the driver rejects binaries from other driver versions or hardware by failing the link,
+            // so the result is the link status, the errors of the previous calls are cleared first
+            clearErrors(renderDevice);
+            renderDevice.glProgramBinaryProc(programId, entry.binaryFormat,
+                                             entry.programData.getData(),
+                                             static_cast<GLsizei>(entry.programData.getSize()));
+
+            GLint status = GL_FALSE;
+            renderDevice.glGetProgramivProc(programId, GL_LINK_STATUS, &status);
+
+            if (status == GL_FALSE)
+            {
+                // an unknown binary format is reported as an error, which must not fail the next checks
+                clearErrors(renderDevice);
+                throw Error("Driver rejected the program binary");
+            }
+
+            uniformLocations.assign(entry.uniformLocations, entry.uniformLocations + uniformCount);
+            loaded = true;
+        }
+        catch (const std::exception& e)
+        {
+            OUZEL_LOG(Log::Level::warning) << "Failed to load cached program " << std::string(getEntryPath(key)) << ", " << e.what();
+        }
+
+        loadTime.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - loadStart).count(),
+                           std::memory_order_relaxed);
+
+        if (loaded)
+            hits.fetch_add(1, std::memory_order_relaxed);
+        else
+            rejections.fetch_add(1, std::memory_order_relaxed);
+
+        return loaded;
+    }
+
+    void ProgramCache::store(std::uint64_t key, GLuint programId, const std::vector<GLint>& uniformLocations)
+    {
+        const auto storeStart = std::chrono::steady_clock::now();
+
+        clearErrors(renderDevice);
+
+        GLint length = 0;
+        renderDevice.glGetProgramivProc(programId, GL_PROGRAM_BINARY_LENGTH, &length);
+
+        if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR || length <= 0)
+        {
+            OUZEL_LOG(Log::Level::warning) << "Failed to get program binary length";
+            return;
+        }
+
+        std::vector<std::uint8_t> programData(static_cast<std::size_t>(length));
+        GLsizei programDataSize = 0;
+        GLenum binaryFormat = GL_NONE;
+        renderDevice.glGetProgramBinaryProc(programId, length, &programDataSize, &binaryFormat, programData.data());
+
+        if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
+        {
+            OUZEL_LOG(Log::Level::warning) << "Failed to get program binary, error: " + std::to_string(error);
+            return;
+        }
+
+        programData.resize(static_cast<std::size_t>(programDataSize));
+
+        const auto entry = cooked::writeProgramBinary(key, binaryFormat, programData, uniformLocations);
+
+        // the entry is written to a temporary file first, so that a partially written entry is never loaded
+        const auto path = std::string(getEntryPath(key));
+        const auto temporaryPath = path + ".tmp";
+
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(entry.data()),
+                   static_cast<std::streamsize>(entry.size()));
+        file.close();
+
+        std::remove(path.c_str());
+        if (!file || std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+        {
+            std::remove(temporaryPath.c_str());
+            OUZEL_LOG(Log::Level::warning) << "Failed to write cached program " << path;
+        }
+
+        storeTime.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - storeStart).count(),
+                            std::memory_order_relaxed);
+    }
+
+    ProgramCache::Statistics ProgramCache::getStatistics() const noexcept
+    {
+        Statistics statistics;
+        statistics.hits = hits.load(std::memory_order_relaxed);
+        statistics.misses = misses.load(std::memory_order_relaxed);
+        statistics.rejections = rejections.load(std::memory_order_relaxed);
+        statistics.compileTime = std::chrono::nanoseconds(compileTime.load(std::memory_order_relaxed));
+        statistics.uniformTime = std::chrono::nanoseconds(uniformTime.load(std::memory_order_relaxed));
+        statistics.loadTime = std::chrono::nanoseconds(loadTime.load(std::memory_order_relaxed));
+        statistics.storeTime = std::chrono::nanoseconds(storeTime.load(std::memory_order_relaxed));
+        return statistics;
+    }
+
+    void ProgramCache::logStatistics() const
+    {
+        const auto statistics = getStatistics();
+
+        if (isEnabled())
+            OUZEL_LOG(Log::Level::info) << "Program cache: " << statistics.hits << " hits, " <<
+                statistics.misses << " misses, " << statistics.rejections << " rejected";
+        else
+            OUZEL_LOG(Log::Level::info) << "Program cache disabled";
+
+        OUZEL_LOG(Log::Level::info) << "Program times: " <<
+            toMilliseconds(statistics.compileTime) << " ms compiling, " <<
+            toMilliseconds(statistics.uniformTime) << " ms looking up uniforms, " <<
+            toMilliseconds(statistics.loadTime) << " ms loading, " <<
+            toMilliseconds(statistics.storeTime) << " ms storing";
+    }
+
+    storage::Path ProgramCache::getEntryPath(std::uint64_t key) const
+    {
+        constexpr char digits[] = "0123456789abcdef";
+
+        std::string filename(16, '0');
+        for (std::size_t i = 0; i < filename.size(); ++i)
+            filename[filename.size() - i - 1] = digits[(key >> (i * 4)) & 0x0F];
+
+        return directory / (filename + '.' + cooked::fileExtension);
+    }
+}
+
+#endif
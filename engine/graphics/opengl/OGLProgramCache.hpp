@@ -0,0 +1,112 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_OGLPROGRAMCACHE_HPP
+#define OUZEL_GRAPHICS_OGLPROGRAMCACHE_HPP
+
+#include "../../core/Setup.h"
+
+#if OUZEL_COMPILE_OPENGL
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "OGL.h"
+
+#if OUZEL_OPENGLES
+#  include "GLES/gl.h"
+#  include "GLES2/gl2.h"
+#  include "GLES2/gl2ext.h"
+#  include "GLES3/gl3.h"
+#else
+#  include "GL/glcorearb.h"
+#  include "GL/glext.h"
+#endif
+
+#include "../DataType.hpp"
+#include "../Vertex.hpp"
+#include "../../storage/Path.hpp"
+
+namespace ouzel::graphics::opengl
+{
+    class RenderDevice;
+
+    // Stores the linked program binaries and their uniform locations in the cache directory (<key>.oasset),
+    // the key is the hash of the shader sources, vertex attributes, uniforms and the driver,
+    // so the programs are compiled again when any of them changes
+    class ProgramCache final
+    {
+    public:
+        struct Statistics final
+        {
+            std::uint32_t hits = 0;
+            std::uint32_t misses = 0;
+            std::uint32_t rejections = 0; // entries that were invalid or that the driver did not accept
+            std::chrono::nanoseconds compileTime{0}; // compiling and linking the sources
+            std::chrono::nanoseconds uniformTime{0}; // looking up the uniform locations
+            std::chrono::nanoseconds loadTime{0}; // reading the entries and loading the binaries
+            std::chrono::nanoseconds storeTime{0}; // getting the binaries and writing the entries
+        };
+
+        ProgramCache(RenderDevice& initRenderDevice, const std::string& initDirectory);
+
+        ProgramCache(const ProgramCache&) = delete;
+        ProgramCache& operator=(const ProgramCache&) = delete;
+
+        ProgramCache(ProgramCache&&) = delete;
+        ProgramCache& operator=(ProgramCache&&) = delete;
+
+        // Enables the cache if there is a cache directory and the driver can retrieve program binaries
+        void init(std::string_view vendorName, std::string_view rendererName, std::string_view versionName);
+
+        auto isEnabled() const noexcept { return driverKey != 0; }
+
+        std::uint64_t getKey(const std::vector<std::uint8_t>& fragmentShader,
+                             const std::vector<std::uint8_t>& vertexShader,
+                             const std::set<Vertex::Attribute::Usage>& vertexAttributes,
+                             const std::vector<std::pair<std::string, DataType>>& fragmentShaderConstantInfo,
+                             const std::vector<std::pair<std::string, DataType>>& vertexShaderConstantInfo) const noexcept;
+
+        // Loads the binary into the program and returns its uniform locations,
+        // returns false if there is no valid entry for the key
+        bool load(std::uint64_t key, GLuint programId, std::size_t uniformCount,
+                  std::vector<GLint>& uniformLocations);
+        void store(std::uint64_t key, GLuint programId, const std::vector<GLint>& uniformLocations);
+
+        void addCompileTime(std::chrono::steady_clock::duration time) noexcept
+        {
+            compileTime.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(), std::memory_order_relaxed);
+        }
+
+        void addUniformTime(std::chrono::steady_clock::duration time) noexcept
+        {
+            uniformTime.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(), std::memory_order_relaxed);
+        }
+
+        Statistics getStatistics() const noexcept;
+        void logStatistics() const;
+
+    private:
+        storage::Path getEntryPath(std::uint64_t key) const;
+
+        RenderDevice& renderDevice;
+        storage::Path directory;
+        std::uint64_t driverKey = 0;
+
+        std::atomic<std::uint32_t> hits{0};
+        std::atomic<std::uint32_t> misses{0};
+        std::atomic<std::uint32_t> rejections{0};
+        std::atomic<std::int64_t> compileTime{0};
+        std::atomic<std::int64_t> uniformTime{0};
+        std::atomic<std::int64_t> loadTime{0};
+        std::atomic<std::int64_t> storeTime{0};
+    };
+}
+#endif
+
+#endif // OUZEL_GRAPHICS_OGLPROGRAMCACHE_HPP
@@ -39,6 +39,7 @@
 #include "OGLRenderTarget.hpp"
 #include "OGLShader.hpp"
 #include "OGLTexture.hpp"
+#include "../Instance.hpp"
 #include "../../core/Engine.hpp"
 #include "../../core/Window.hpp"
 #include "../../utils/Log.hpp"
@@ -270,7 +271,8 @@ namespace ouzel::graphics::opengl
                                const std::function<void(const Event&)>& initCallback):
         graphics::RenderDevice(Driver::openGL, settings, newWindow, initCallback),
         textureBaseLevelSupported(false),
-        textureMaxLevelSupported(false)
+        textureMaxLevelSupported(false),
+        programCache(*this, settings.programCacheDirectory)
     {
         projectionTransform = Matrix4F(1.0F, 0.0F, 0.0F, 0.0F,
                                        0.0F, 1.0F, 0.0F, 0.0F,
@@ -305,9 +307,9 @@ namespace ouzel::graphics::opengl
         std::string rendererName;
         const auto rendererNamePointer = glGetStringProc(GL_RENDERER);
         if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
-            logger.log(Log::Level::warning) << "Failed to get OpenGL renderer, error: " + std::to_string(error);
+            OUZEL_LOG(Log::Level::warning) << "Failed to get OpenGL renderer, error: " + std::to_string(error);
         else if (!rendererNamePointer)
-            logger.log(Log::Level::warning) << "Failed to get OpenGL renderer";
+            OUZEL_LOG(Log::Level::warning) << "Failed to get OpenGL renderer";
         else
             rendererName = reinterpret_cast<const char*>(rendererNamePointer);
 
@@ -315,13 +317,23 @@ namespace ouzel::graphics::opengl
         const auto vendorNamePointer = glGetStringProc(GL_VENDOR);
 
         if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
-            logger.log(Log::Level::warning) << "Failed to get OpenGL renderer's vendor, error: " + std::to_string(error);
+            OUZEL_LOG(Log::Level::warning) << "Failed to get OpenGL renderer's vendor, error: " + std::to_string(error);
         else if (!vendorNamePointer)
-            logger.log(Log::Level::warning) << "Failed to get OpenGL renderer's vendor";
+            OUZEL_LOG(Log::Level::warning) << "Failed to get OpenGL renderer's vendor";
         else
             vendorName = reinterpret_cast<const char*>(vendorNamePointer);
 
-        logger.log(Log::Level::info) << "Using " << rendererName << " by " << vendorName << " for rendering";
+        std::string versionName;
+        const auto versionNamePointer = glGetStringProc(GL_VERSION);
+
+        if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+            OUZEL_LOG(Log::Level::warning) << "Failed to get OpenGL version, error: " + std::to_string(error);
+        else if (!versionNamePointer)
+            OUZEL_LOG(Log::Level::warning) << "Failed to get OpenGL version";
+        else
+            versionName = reinterpret_cast<const char*>(versionNamePointer);
+
+        OUZEL_LOG(Log::Level::info) << "Using " << rendererName << " by " << vendorName << " for rendering";
 
 #if OUZEL_OPENGLES
         npotTexturesSupported = apiVersion >= ApiVersion(3, 0) || getter.hasExtension("GL_OES_texture_npot");
@@ -398,6 +410,11 @@ namespace ouzel::graphics::opengl
         glGetProgramivProc = getter.get<PFNGLGETPROGRAMIVPROC>("glGetProgramiv", ApiVersion(2, 0));
         glGetProgramInfoLogProc = getter.get<PFNGLGETPROGRAMINFOLOGPROC>("glGetProgramInfoLog", ApiVersion(2, 0));
         glGetUniformLocationProc = getter.get<PFNGLGETUNIFORMLOCATIONPROC>("glGetUniformLocation", ApiVersion(2, 0));
+        glGetProgramBinaryProc = getter.get<PFNGLGETPROGRAMBINARYPROC>("glGetProgramBinary", ApiVersion(3, 0),
+                                                                       {{"glGetProgramBinaryOES", "GL_OES_get_program_binary"}});
+        glProgramBinaryProc = getter.get<PFNGLPROGRAMBINARYPROC>("glProgramBinary", ApiVersion(3, 0),
+                                                                 {{"glProgramBinaryOES", "GL_OES_get_program_binary"}});
+        glProgramParameteriProc = getter.get<PFNGLPROGRAMPARAMETERIPROC>("glProgramParameteri", ApiVersion(3, 0));
 
         glBindBufferProc = getter.get<PFNGLBINDBUFFERPROC>("glBindBuffer", ApiVersion(1, 1));
         glDeleteBuffersProc = getter.get<PFNGLDELETEBUFFERSPROC>("glDeleteBuffers", ApiVersion(1, 1));
@@ -436,6 +453,13 @@ namespace ouzel::graphics::opengl
         glUnmapBufferProc = getter.get<PFNGLUNMAPBUFFERPROC>("glUnmapBuffer", ApiVersion(3, 0),
                                                              {{"glUnmapBufferOES", "GL_OES_mapbuffer"}});
 
+        glVertexAttribDivisorProc = getter.get<PFNGLVERTEXATTRIBDIVISORPROC>("glVertexAttribDivisor", ApiVersion(3, 0),
+                                                                             {{"glVertexAttribDivisorEXT", "GL_EXT_instanced_arrays"},
+                                                                              {"glVertexAttribDivisorANGLE", "GL_ANGLE_instanced_arrays"}});
+        glDrawElementsInstancedProc = getter.get<PFNGLDRAWELEMENTSINSTANCEDPROC>("glDrawElementsInstanced", ApiVersion(3, 0),
+                                                                                 {{"glDrawElementsInstancedEXT", "GL_EXT_instanced_arrays"},
+                                                                                  {"glDrawElementsInstancedANGLE", "GL_ANGLE_instanced_arrays"}});
+
         glGenVertexArraysProc = getter.get<PFNGLGENVERTEXARRAYSPROC>("glGenVertexArrays", ApiVersion(3, 0),
                                                                      {{"glGenVertexArraysOES", "GL_OES_vertex_array_object"}});
         glBindVertexArrayProc = getter.get<PFNGLBINDVERTEXARRAYPROC>("glBindVertexArray", ApiVersion(3, 0),
@@ -547,6 +571,12 @@ namespace ouzel::graphics::opengl
         glGetProgramivProc = getter.get<PFNGLGETPROGRAMIVPROC>("glGetProgramiv", ApiVersion(2, 0));
         glGetProgramInfoLogProc = getter.get<PFNGLGETPROGRAMINFOLOGPROC>("glGetProgramInfoLog", ApiVersion(2, 0));
         glGetUniformLocationProc = getter.get<PFNGLGETUNIFORMLOCATIONPROC>("glGetUniformLocation", ApiVersion(2, 0));
+        glGetProgramBinaryProc = getter.get<PFNGLGETPROGRAMBINARYPROC>("glGetProgramBinary", ApiVersion(4, 1),
+                                                                       {{"glGetProgramBinary", "GL_ARB_get_program_binary"}});
+        glProgramBinaryProc = getter.get<PFNGLPROGRAMBINARYPROC>("glProgramBinary", ApiVersion(4, 1),
+                                                                 {{"glProgramBinary", "GL_ARB_get_program_binary"}});
+        glProgramParameteriProc = getter.get<PFNGLPROGRAMPARAMETERIPROC>("glProgramParameteri", ApiVersion(4, 1),
+                                                                         {{"glProgramParameteri", "GL_ARB_get_program_binary"}});
 
         glBindBufferProc = getter.get<PFNGLBINDBUFFERPROC>("glBindBuffer", ApiVersion(2, 0));
         glDeleteBuffersProc = getter.get<PFNGLDELETEBUFFERSPROC>("glDeleteBuffers", ApiVersion(2, 0));
@@ -569,6 +599,11 @@ namespace ouzel::graphics::opengl
         glMapBufferRangeProc = getter.get<PFNGLMAPBUFFERRANGEPROC>("glMapBufferRange", ApiVersion(3, 0),
                                                                    {{"glMapBufferRange", "GL_ARB_map_buffer_range"}});
 
+        glVertexAttribDivisorProc = getter.get<PFNGLVERTEXATTRIBDIVISORPROC>("glVertexAttribDivisor", ApiVersion(3, 3),
+                                                                             {{"glVertexAttribDivisorARB", "GL_ARB_instanced_arrays"}});
+        glDrawElementsInstancedProc = getter.get<PFNGLDRAWELEMENTSINSTANCEDPROC>("glDrawElementsInstanced", ApiVersion(3, 1),
+                                                                                 {{"glDrawElementsInstancedARB", "GL_ARB_draw_instanced"}});
+
         glGenVertexArraysProc = getter.get<PFNGLGENVERTEXARRAYSPROC>("glGenVertexArrays", ApiVersion(3, 0),
                                                                      {{"glGenVertexArrays", "GL_ARB_vertex_array_object"}});
         glBindVertexArrayProc = getter.get<PFNGLBINDVERTEXARRAYPROC>("glBindVertexArray", ApiVersion(3, 0),
@@ -630,6 +665,20 @@ namespace ouzel::graphics::opengl
         glPopGroupMarkerEXTProc = getter.get<PFNGLPOPGROUPMARKEREXTPROC>("glPopGroupMarkerEXT", "GL_EXT_debug_marker");
 #endif
 
+        instancingSupported = glVertexAttribDivisorProc && glDrawElementsInstancedProc;
+
+        // some drivers expose the functions but don't support any binary formats
+        if (glGetProgramBinaryProc && glProgramBinaryProc)
+        {
+            GLint binaryFormatCount = 0;
+            glGetIntegervProc(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+
+            if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                OUZEL_LOG(Log::Level::warning) << "Failed to get program binary format count, error: " + std::to_string(error);
+            else if (binaryFormatCount > 0)
+                programCache.init(vendorName, rendererName, versionName);
+        }
+
         if (!multisamplingSupported) sampleCount = 1;
 
         glDisableProc(GL_DITHER);
@@ -666,55 +715,55 @@ namespace ouzel::graphics::opengl
         setFrontFace(GL_CW);
     }
 
-    void RenderDevice::setUniform(GLint location, DataType dataType, const void* data)
+    void RenderDevice::setUniform(GLint location, DataType dataType, const void* data, GLsizei count)
     {
         switch (dataType)
         {
             case DataType::integer32:
-                glUniform1ivProc(location, 1, static_cast<const GLint*>(data));
+                glUniform1ivProc(location, count, static_cast<const GLint*>(data));
                 break;
             case DataType::unsignedInteger32:
                 if (!glUniform1uivProc) throw Error("Unsupported uniform size");
-                glUniform1uivProc(location, 1, static_cast<const GLuint*>(data));
+                glUniform1uivProc(location, count, static_cast<const GLuint*>(data));
                 break;
             case DataType::integer32Vector2:
-                glUniform2ivProc(location, 1, static_cast<const GLint*>(data));
+                glUniform2ivProc(location, count, static_cast<const GLint*>(data));
                 break;
             case DataType::unsignedInteger32Vector2:
                 if (!glUniform2uivProc) throw Error("Unsupported uniform size");
-                glUniform2uivProc(location, 1, static_cast<const GLuint*>(data));
+                glUniform2uivProc(location, count, static_cast<const GLuint*>(data));
                 break;
             case DataType::integer32Vector3:
-                glUniform3ivProc(location, 1, static_cast<const GLint*>(data));
+                glUniform3ivProc(location, count, static_cast<const GLint*>(data));
                 break;
             case DataType::unsignedInteger32Vector3:
                 if (!glUniform3uivProc) throw Error("Unsupported uniform size");
-                glUniform3uivProc(location, 1, static_cast<const GLuint*>(data));
+                glUniform3uivProc(location, count, static_cast<const GLuint*>(data));
                 break;
             case DataType::integer32Vector4:
-                glUniform4ivProc(location, 1, static_cast<const GLint*>(data));
+                glUniform4ivProc(location, count, static_cast<const GLint*>(data));
                 break;
             case DataType::unsignedInteger32Vector4:
                 if (!glUniform4uivProc) throw Error("Unsupported uniform size");
-                glUniform4uivProc(location, 1, static_cast<const GLuint*>(data));
+                glUniform4uivProc(location, count, static_cast<const GLuint*>(data));
                 break;
             case DataType::float32:
-                glUniform1fvProc(location, 1, static_cast<const GLfloat*>(data));
+                glUniform1fvProc(location, count, static_cast<const GLfloat*>(data));
                 break;
             case DataType::float32Vector2:
-                glUniform2fvProc(location, 1, static_cast<const GLfloat*>(data));
+                glUniform2fvProc(location, count, static_cast<const GLfloat*>(data));
                 break;
             case DataType::float32Vector3:
-                glUniform3fvProc(location, 1, static_cast<const GLfloat*>(data));
+                glUniform3fvProc(location, count, static_cast<const GLfloat*>(data));
                 break;
             case DataType::float32Vector4:
-                glUniform4fvProc(location, 1, static_cast<const GLfloat*>(data));
+                glUniform4fvProc(location, count, static_cast<const GLfloat*>(data));
                 break;
             case DataType::float32Matrix3:
-                glUniformMatrix3fvProc(location, 1, GL_FALSE, static_cast<const GLfloat*>(data));
+                glUniformMatrix3fvProc(location, count, GL_FALSE, static_cast<const GLfloat*>(data));
                 break;
             case DataType::float32Matrix4:
-                glUniformMatrix4fvProc(location, 1, GL_FALSE, static_cast<const GLfloat*>(data));
+                glUniformMatrix4fvProc(location, count, GL_FALSE, static_cast<const GLfloat*>(data));
                 break;
             default:
                 throw Error("Unsupported uniform size");
@@ -729,6 +778,8 @@ namespace ouzel::graphics::opengl
         const RenderTarget* currentRenderTarget = nullptr;
         const Shader* currentShader = nullptr;
 
+        const bool commandTiming = isCommandTimingEnabled();
+
         CommandBuffer commandBuffer;
         std::unique_ptr<Command> command;
 
@@ -744,6 +795,8 @@ namespace ouzel::graphics::opengl
             {
                 command = commandBuffer.popCommand();
 
+                const auto commandStart = commandTiming ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
                 switch (command->type)
                 {
                     case Command::Type::resize:
@@ -758,6 +811,13 @@ namespace ouzel::graphics::opengl
                     case Command::Type::present:
                     {
                         present();
+
+                        // the programs that are created before the first frame are the startup ones
+                        if (!programStatisticsLogged)
+                        {
+                            programCache.logStatistics();
+                            programStatisticsLogged = true;
+                        }
                         break;
                     }
 
@@ -998,7 +1058,7 @@ namespace ouzel::graphics::opengl
 
 #if OUZEL_OPENGLES
                         if (setPipelineStateCommand->fillMode != FillMode::solid)
-                            logger.log(Log::Level::warning) << "Unsupported fill mode";
+                            OUZEL_LOG(Log::Level::warning) << "Unsupported fill mode";
 #else
                         setPolygonFillMode(getFillMode(setPipelineStateCommand->fillMode));
 #endif
@@ -1023,7 +1083,9 @@ namespace ouzel::graphics::opengl
                         bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer->getBufferId());
                         bindBuffer(GL_ARRAY_BUFFER, vertexBuffer->getBufferId());
 
+                        // the attributes are offset instead of using glDrawElementsBaseVertex, which is missing in OpenGL ES 2 and 3
                         const std::byte* vertexOffset = nullptr;
+                        vertexOffset += drawCommand->baseVertex * sizeof(Vertex);
 
                         for (GLuint index = 0; index < RenderDevice::vertexAttributes.size(); ++index)
                         {
@@ -1043,6 +1105,42 @@ namespace ouzel::graphics::opengl
                         if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
                             throw std::system_error(makeErrorCode(error), "Failed to update vertex attributes");
 
+                        // the skin attributes follow the instance attributes (see Shader::linkProgram)
+                        auto skinLocation = static_cast<GLuint>(RenderDevice::vertexAttributes.size());
+                        for (const auto& instanceAttribute : RenderDevice::instanceAttributes)
+                            skinLocation += (instanceAttribute.dataType == DataType::float32Matrix4) ? 4 : 1;
+
+                        if (drawCommand->skinBuffer)
+                        {
+                            auto skinBuffer = getResource<Buffer>(drawCommand->skinBuffer);
+
+                            assert(skinBuffer);
+                            assert(skinBuffer->getBufferId());
+
+                            bindBuffer(GL_ARRAY_BUFFER, skinBuffer->getBufferId());
+
+                            const std::byte* skinOffset = nullptr;
+                            skinOffset += drawCommand->baseVertex * sizeof(SkinVertex);
+
+                            for (GLuint index = 0; index < RenderDevice::skinAttributes.size(); ++index)
+                            {
+                                const auto& skinAttribute = RenderDevice::skinAttributes[index];
+
+                                glEnableVertexAttribArrayProc(skinLocation + index);
+                                glVertexAttribPointerProc(skinLocation + index,
+                                                          getArraySize(skinAttribute.dataType),
+                                                          getVertexType(skinAttribute.dataType),
+                                                          isNormalized(skinAttribute.dataType),
+                                                          static_cast<GLsizei>(sizeof(SkinVertex)),
+                                                          skinOffset);
+
+                                skinOffset += getDataTypeSize(skinAttribute.dataType);
+                            }
+
+                            if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                                throw std::system_error(makeErrorCode(error), "Failed to update skin attributes");
+                        }
+
                         assert(drawCommand->indexCount);
                         assert(indexBuffer->getSize());
                         assert(vertexBuffer->getSize());
@@ -1050,13 +1148,79 @@ namespace ouzel::graphics::opengl
                         const std::byte* indexOffset = nullptr;
                         indexOffset += drawCommand->startIndex * drawCommand->indexSize;
 
-                        glDrawElementsProc(getDrawMode(drawCommand->drawMode),
-                                           static_cast<GLsizei>(drawCommand->indexCount),
-                                           getIndexType(drawCommand->indexSize),
-                                           indexOffset);
+                        if (drawCommand->instanceBuffer)
+                        {
+                            if (!instancingSupported)
+                                throw Error("Instancing not supported");
 
-                        if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
-                            throw std::system_error(makeErrorCode(error), "Failed to draw elements");
+                            auto instanceBuffer = getResource<Buffer>(drawCommand->instanceBuffer);
+
+                            assert(instanceBuffer);
+                            assert(instanceBuffer->getBufferId());
+
+                            bindBuffer(GL_ARRAY_BUFFER, instanceBuffer->getBufferId());
+
+                            // the instance attributes follow the vertex attributes, matrices take a location per column
+                            auto instanceLocation = static_cast<GLuint>(RenderDevice::vertexAttributes.size());
+                            const std::byte* instanceOffset = nullptr;
+
+                            for (const auto& instanceAttribute : RenderDevice::instanceAttributes)
+                            {
+                                const GLuint columns = (instanceAttribute.dataType == DataType::float32Matrix4) ? 4 : 1;
+                                const auto columnSize = getDataTypeSize(instanceAttribute.dataType) / columns;
+
+                                for (GLuint column = 0; column < columns; ++column)
+                                {
+                                    glEnableVertexAttribArrayProc(instanceLocation);
+                                    glVertexAttribPointerProc(instanceLocation,
+                                                              columns == 1 ? getArraySize(instanceAttribute.dataType) : 4,
+                                                              GL_FLOAT,
+                                                              GL_FALSE,
+                                                              static_cast<GLsizei>(sizeof(Instance)),
+                                                              instanceOffset);
+                                    glVertexAttribDivisorProc(instanceLocation, 1);
+
+                                    ++instanceLocation;
+                                    instanceOffset += columnSize;
+                                }
+                            }
+
+                            if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                                throw std::system_error(makeErrorCode(error), "Failed to update instance attributes");
+
+                            glDrawElementsInstancedProc(getDrawMode(drawCommand->drawMode),
+                                                        static_cast<GLsizei>(drawCommand->indexCount),
+                                                        getIndexType(drawCommand->indexSize),
+                                                        indexOffset,
+                                                        static_cast<GLsizei>(drawCommand->instanceCount));
+
+                            if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                                throw std::system_error(makeErrorCode(error), "Failed to draw instanced elements");
+
+                            // the draws that are not instanced don't read the instance attributes
+                            for (auto location = static_cast<GLuint>(RenderDevice::vertexAttributes.size()); location < instanceLocation; ++location)
+                            {
+                                glVertexAttribDivisorProc(location, 0);
+                                glDisableVertexAttribArrayProc(location);
+                            }
+                        }
+                        else
+                        {
+                            glDrawElementsProc(getDrawMode(drawCommand->drawMode),
+                                               static_cast<GLsizei>(drawCommand->indexCount),
+                                               getIndexType(drawCommand->indexSize),
+                                               indexOffset);
+
+                            if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                                throw std::system_error(makeErrorCode(error), "Failed to draw elements");
+                        }
+
+                        // the draws that are not skinned don't read the skin attributes
+                        if (drawCommand->skinBuffer)
+                            for (GLuint index = 0; index < RenderDevice::skinAttributes.size(); ++index)
+                                glDisableVertexAttribArrayProc(skinLocation + index);
+
+                        ++currentDrawCallCount;
 
                         break;
                     }
@@ -1143,9 +1307,14 @@ namespace ouzel::graphics::opengl
                             const auto& fragmentShaderConstantLocation = fragmentShaderConstantLocations[i];
                             const auto& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
 
+                            // arrays are uploaded with a single call
+                            const auto count = static_cast<GLsizei>(sizeof(float) * fragmentShaderConstant.size() /
+                                                                    getDataTypeSize(fragmentShaderConstantLocation.dataType));
+
                             setUniform(fragmentShaderConstantLocation.location,
                                        fragmentShaderConstantLocation.dataType,
-                                       fragmentShaderConstant.data());
+                                       fragmentShaderConstant.data(),
+                                       count);
                         }
 
                         // vertex shader constants
@@ -1159,9 +1328,14 @@ namespace ouzel::graphics::opengl
                             const auto& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
                             const auto& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
 
+                            // arrays are uploaded with a single call
+                            const auto count = static_cast<GLsizei>(sizeof(float) * vertexShaderConstant.size() /
+                                                                    getDataTypeSize(vertexShaderConstantLocation.dataType));
+
                             setUniform(vertexShaderConstantLocation.location,
                                        vertexShaderConstantLocation.dataType,
-                                       vertexShaderConstant.data());
+                                       vertexShaderConstant.data(),
+                                       count);
                         }
 
                         break;
@@ -1228,6 +1402,8 @@ namespace ouzel::graphics::opengl
                         throw Error("Invalid command");
                 }
 
+                if (commandTiming) addCommandTime(command->type, std::chrono::steady_clock::now() - commandStart);
+
                 if (command->type == Command::Type::present) return;
             }
         }
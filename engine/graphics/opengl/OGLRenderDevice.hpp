@@ -31,6 +31,7 @@
 #endif
 
 #include "../RenderDevice.hpp"
+#include "OGLProgramCache.hpp"
 #include "OGLShader.hpp"
 #include "OGLStateCache.hpp"
 
@@ -148,6 +149,9 @@ namespace ouzel::graphics::opengl
         PFNGLGETPROGRAMIVPROC glGetProgramivProc = nullptr;
         PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLogProc = nullptr;
         PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocationProc = nullptr;
+        PFNGLGETPROGRAMBINARYPROC glGetProgramBinaryProc = nullptr;
+        PFNGLPROGRAMBINARYPROC glProgramBinaryProc = nullptr;
+        PFNGLPROGRAMPARAMETERIPROC glProgramParameteriProc = nullptr;
 
         PFNGLBINDBUFFERPROC glBindBufferProc = nullptr;
         PFNGLDELETEBUFFERSPROC glDeleteBuffersProc = nullptr;
@@ -161,6 +165,8 @@ namespace ouzel::graphics::opengl
         PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArrayProc = nullptr;
         PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArrayProc = nullptr;
         PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointerProc = nullptr;
+        PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisorProc = nullptr;
+        PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstancedProc = nullptr;
 
         PFNGLGETSTRINGIPROC glGetStringiProc = nullptr;
         PFNGLPUSHGROUPMARKEREXTPROC glPushGroupMarkerEXTProc = nullptr;
@@ -174,6 +180,9 @@ namespace ouzel::graphics::opengl
         auto isTextureBaseLevelSupported() const noexcept { return textureBaseLevelSupported; }
         auto isTextureMaxLevelSupported() const noexcept { return textureMaxLevelSupported; }
 
+        auto& getProgramCache() noexcept { return programCache; }
+        auto& getProgramCache() const noexcept { return programCache; }
+
         void setFrontFace(GLenum mode)
         {
             if (stateCache.frontFace != mode)
@@ -576,7 +585,7 @@ namespace ouzel::graphics::opengl
         void process() override;
         virtual void present();
         void generateScreenshot(const std::string& filename) override;
-        void setUniform(GLint location, DataType dataType, const void* data);
+        void setUniform(GLint location, DataType dataType, const void* data, GLsizei count);
 
         bool embedded = false;
 
@@ -589,6 +598,8 @@ namespace ouzel::graphics::opengl
         bool textureMaxLevelSupported:1;
 
         StateCache stateCache;
+        ProgramCache programCache;
+        bool programStatisticsLogged = false;
 
         std::vector<std::unique_ptr<RenderResource>> resources;
     };
@@ -4,6 +4,7 @@
 
 #if OUZEL_COMPILE_OPENGL
 
+#include <chrono>
 #include "OGLShader.hpp"
 #include "OGLError.hpp"
 #include "OGLRenderDevice.hpp"
@@ -93,6 +94,8 @@ namespace ouzel::graphics::opengl
                 case Vertex::Attribute::Usage::tangent: return "tangent0";
                 case Vertex::Attribute::Usage::textureCoordinates0: return "texCoord0";
                 case Vertex::Attribute::Usage::textureCoordinates1: return "texCoord1";
+                case Vertex::Attribute::Usage::instanceTransform: return "instanceTransform0";
+                case Vertex::Attribute::Usage::instanceColor: return "instanceColor0";
                 default:
                     throw Error("Invalid vertex attribute usage");
             }
@@ -100,6 +103,54 @@ namespace ouzel::graphics::opengl
     }
 
     void Shader::compileShader()
+    {
+        auto& programCache = renderDevice.getProgramCache();
+        const auto cacheKey = programCache.isEnabled() ?
+            programCache.getKey(fragmentShaderData, vertexShaderData, vertexAttributes,
+                                fragmentShaderConstantInfo, vertexShaderConstantInfo) : 0;
+
+        // texture0 and texture1 followed by the fragment and vertex shader constants
+        const auto uniformCount = 2 + fragmentShaderConstantInfo.size() + vertexShaderConstantInfo.size();
+        std::vector<GLint> uniformLocations;
+
+        programId = renderDevice.glCreateProgramProc();
+
+        // a program that failed to load a binary can still be linked from the sources
+        if (!cacheKey || !programCache.load(cacheKey, programId, uniformCount, uniformLocations))
+        {
+            const auto compileStart = std::chrono::steady_clock::now();
+            linkProgram(cacheKey != 0);
+            programCache.addCompileTime(std::chrono::steady_clock::now() - compileStart);
+
+            const auto uniformStart = std::chrono::steady_clock::now();
+            uniformLocations = getUniformLocations();
+            programCache.addUniformTime(std::chrono::steady_clock::now() - uniformStart);
+
+            if (cacheKey) programCache.store(cacheKey, programId, uniformLocations);
+        }
+
+        renderDevice.useProgram(programId);
+
+        if (uniformLocations[0] != -1) renderDevice.glUniform1iProc(uniformLocations[0], 0);
+        if (uniformLocations[1] != -1) renderDevice.glUniform1iProc(uniformLocations[1], 1);
+
+        if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
+            throw std::system_error(makeErrorCode(error), "Failed to set texture units");
+
+        auto location = uniformLocations.begin() + 2;
+
+        fragmentShaderConstantLocations.clear();
+        fragmentShaderConstantLocations.reserve(fragmentShaderConstantInfo.size());
+        for (const auto& info : fragmentShaderConstantInfo)
+            fragmentShaderConstantLocations.emplace_back(*location++, info.second);
+
+        vertexShaderConstantLocations.clear();
+        vertexShaderConstantLocations.reserve(vertexShaderConstantInfo.size());
+        for (const auto& info : vertexShaderConstantInfo)
+            vertexShaderConstantLocations.emplace_back(*location++, info.second);
+    }
+
+    void Shader::linkProgram(bool retrievable)
     {
         fragmentShaderId = renderDevice.glCreateShaderProc(GL_FRAGMENT_SHADER);
 
@@ -129,19 +180,40 @@ namespace ouzel::graphics::opengl
         if (status == GL_FALSE)
             throw Error("Failed to compile vertex shader, error: " + getShaderMessage(vertexShaderId));
 
-        programId = renderDevice.glCreateProgramProc();
-
         renderDevice.glAttachShaderProc(programId, vertexShaderId);
         renderDevice.glAttachShaderProc(programId, fragmentShaderId);
 
-        GLuint index = 0;
+        // the locations must match the attribute indices that are used when drawing
+        for (GLuint index = 0; index < RenderDevice::vertexAttributes.size(); ++index)
+        {
+            const auto& vertexAttribute = RenderDevice::vertexAttributes[index];
 
-        for (const auto& vertexAttribute : RenderDevice::vertexAttributes)
             if (vertexAttributes.find(vertexAttribute.usage) != vertexAttributes.end())
-            {
                 renderDevice.glBindAttribLocationProc(programId, index, usageToString(vertexAttribute.usage));
-                ++index;
-            }
+        }
+
+        // matrices take a location per column
+        auto instanceLocation = static_cast<GLuint>(RenderDevice::vertexAttributes.size());
+        for (const auto& instanceAttribute : RenderDevice::instanceAttributes)
+        {
+            if (vertexAttributes.find(instanceAttribute.usage) != vertexAttributes.end())
+                renderDevice.glBindAttribLocationProc(programId, instanceLocation, usageToString(instanceAttribute.usage));
+
+            instanceLocation += (instanceAttribute.dataType == DataType::float32Matrix4) ? 4 : 1;
+        }
+
+        // the skin attributes follow the instance attributes
+        auto skinLocation = instanceLocation;
+        for (const auto& skinAttribute : RenderDevice::skinAttributes)
+        {
+            if (vertexAttributes.find(skinAttribute.usage) != vertexAttributes.end())
+                renderDevice.glBindAttribLocationProc(programId, skinLocation, usageToString(skinAttribute.usage));
+
+            ++skinLocation;
+        }
+
+        if (retrievable && renderDevice.glProgramParameteriProc)
+            renderDevice.glProgramParameteriProc(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
         renderDevice.glLinkProgramProc(programId);
 
@@ -162,24 +234,21 @@ namespace ouzel::graphics::opengl
 
         if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
             throw std::system_error(makeErrorCode(error), "Failed to detach shader");
+    }
 
-        renderDevice.useProgram(programId);
-
-        const auto texture0Location = renderDevice.glGetUniformLocationProc(programId, "texture0");
-        if (texture0Location != -1) renderDevice.glUniform1iProc(texture0Location, 0);
+    std::vector<GLint> Shader::getUniformLocations() const
+    {
+        std::vector<GLint> uniformLocations;
+        uniformLocations.reserve(2 + fragmentShaderConstantInfo.size() + vertexShaderConstantInfo.size());
 
-        const auto texture1Location = renderDevice.glGetUniformLocationProc(programId, "texture1");
-        if (texture1Location != -1) renderDevice.glUniform1iProc(texture1Location, 1);
+        uniformLocations.push_back(renderDevice.glGetUniformLocationProc(programId, "texture0"));
+        uniformLocations.push_back(renderDevice.glGetUniformLocationProc(programId, "texture1"));
 
         if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
             throw std::system_error(makeErrorCode(error), "Failed to get uniform location");
 
-        if (!fragmentShaderConstantInfo.empty())
-        {
-            fragmentShaderConstantLocations.clear();
-            fragmentShaderConstantLocations.reserve(fragmentShaderConstantInfo.size());
-
-            for (const auto& info : fragmentShaderConstantInfo)
+        for (const auto constantInfo : {&fragmentShaderConstantInfo, &vertexShaderConstantInfo})
+            for (const auto& info : *constantInfo)
             {
                 const auto location = renderDevice.glGetUniformLocationProc(programId, info.first.c_str());
 
@@ -189,28 +258,10 @@ namespace ouzel::graphics::opengl
                 if (location == -1)
                     throw Error("Failed to get OpenGL uniform location");
 
-                fragmentShaderConstantLocations.emplace_back(location, info.second);
+                uniformLocations.push_back(location);
             }
-        }
 
-        if (!vertexShaderConstantInfo.empty())
-        {
-            vertexShaderConstantLocations.clear();
-            vertexShaderConstantLocations.reserve(vertexShaderConstantInfo.size());
-
-            for (const auto& info : vertexShaderConstantInfo)
-            {
-                const auto location = renderDevice.glGetUniformLocationProc(programId, info.first.c_str());
-
-                if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
-                    throw std::system_error(makeErrorCode(error), "Failed to get OpenGL uniform location");
-
-                if (location == -1)
-                    throw Error("Failed to get OpenGL uniform location");
-
-                vertexShaderConstantLocations.emplace_back(location, info.second);
-            }
-        }
+        return uniformLocations;
     }
 }
 
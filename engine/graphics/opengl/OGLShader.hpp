@@ -64,6 +64,8 @@ namespace ouzel::graphics::opengl
 
     private:
         void compileShader();
+        void linkProgram(bool retrievable);
+        std::vector<GLint> getUniformLocations() const;
         std::string getShaderMessage(GLuint shaderId) const;
         std::string getProgramMessage() const;
 
@@ -65,7 +65,7 @@ namespace ouzel::graphics::opengl::emscripten
             if (webGLContext)
             {
                 apiVersion = openGLVersion.second;
-                logger.log(Log::Level::info) << "WebGL " << openGLVersion.first << " context created";
+                OUZEL_LOG(Log::Level::info) << "WebGL " << openGLVersion.first << " context created";
                 break;
             }
         }
@@ -120,7 +120,7 @@ namespace ouzel::graphics::opengl::emscripten
             if (webGLContext)
             {
                 apiVersion = openGLVersion.second;
-                logger.log(Log::Level::info) << "WebGL " << openGLVersion.first << " context created";
+                OUZEL_LOG(Log::Level::info) << "WebGL " << openGLVersion.first << " context created";
                 break;
             }
         }
@@ -38,7 +38,7 @@ namespace ouzel::graphics::opengl::macos
             }
             catch (const std::exception& e)
             {
-                logger.log(Log::Level::error) << e.what();
+                OUZEL_LOG(Log::Level::error) << e.what();
                 return kCVReturnError;
             }
 
@@ -89,7 +89,7 @@ namespace ouzel::graphics::opengl::macos
             if (pixelFormat)
             {
                 apiVersion = openGLVersion.second;
-                logger.log(Log::Level::info) << "OpenGL " << apiVersion.v[0] << '.' << apiVersion.v[1] << " pixel format created";
+                OUZEL_LOG(Log::Level::info) << "OpenGL " << apiVersion.v[0] << '.' << apiVersion.v[1] << " pixel format created";
                 break;
             }
         }
@@ -29,7 +29,7 @@ namespace ouzel::graphics::opengl::tvos
             }
             catch (const std::exception& e)
             {
-                logger.log(Log::Level::error) << e.what();
+                OUZEL_LOG(Log::Level::error) << e.what();
             }
         }
     }
@@ -65,7 +65,7 @@ namespace ouzel::graphics::opengl::tvos
             if (context)
             {
                 apiVersion = openGLVersion.second;
-                logger.log(Log::Level::info) << "EAGL OpenGL ES " << apiVersion.v[0] << " context created";
+                OUZEL_LOG(Log::Level::info) << "EAGL OpenGL ES " << apiVersion.v[0] << " context created";
                 break;
             }
         }
@@ -187,7 +187,7 @@ namespace ouzel::graphics::opengl::windows
             if (const char* extensionsPtr = wglGetExtensionsStringProc(deviceContext))
                 extensions = explodeString(std::string(extensionsPtr), ' ');
 
-            logger.log(Log::Level::all) << "Supported WGL extensions: " << extensions;
+            OUZEL_LOG(Log::Level::all) << "Supported WGL extensions: " << extensions;
         }
 
         PFNWGLCHOOSEPIXELFORMATARBPROC wglChoosePixelFormatProc = nullptr;
@@ -279,7 +279,7 @@ namespace ouzel::graphics::opengl::windows
 
                 if (renderContext)
                 {
-                    logger.log(Log::Level::info) << "OpenGL " << openGLVersion << " context created";
+                    OUZEL_LOG(Log::Level::info) << "OpenGL " << openGLVersion << " context created";
                     break;
                 }
             }
@@ -352,7 +352,7 @@ namespace ouzel::graphics::opengl::windows
             }
             catch (const std::exception& e)
             {
-                logger.log(Log::Level::error) << e.what();
+                OUZEL_LOG(Log::Level::error) << e.what();
             }
         }
 
@@ -352,6 +352,44 @@ namespace ouzel::gui
         }
     }
 
+    BMFont::BMFont(const cooked::Font& font,
+                   const cooked::Glyph* glyphs,
+                   std::size_t glyphCount,
+                   const cooked::Kerning* kernings,
+                   std::size_t kerningCount,
+                   const std::shared_ptr<graphics::Texture>& texture):
+        lineHeight(font.lineHeight),
+        base(font.base),
+        width(font.width),
+        height(font.height),
+        pages(font.pages),
+        outline(font.outline),
+        kernCount(static_cast<std::uint16_t>(kerningCount)),
+        fontTexture(texture)
+    {
+        chars.reserve(glyphCount);
+
+        for (std::size_t i = 0; i < glyphCount; ++i)
+        {
+            const auto& glyph = glyphs[i];
+
+            CharDescriptor c;
+            c.x = glyph.x;
+            c.y = glyph.y;
+            c.width = glyph.width;
+            c.height = glyph.height;
+            c.xOffset = glyph.xOffset;
+            c.yOffset = glyph.yOffset;
+            c.xAdvance = glyph.xAdvance;
+            c.page = glyph.page;
+            chars[static_cast<char32_t>(glyph.id)] = c;
+        }
+
+        for (std::size_t i = 0; i < kerningCount; ++i)
+            kern[std::pair(static_cast<char32_t>(kernings[i].first),
+                           static_cast<char32_t>(kernings[i].second))] = kernings[i].amount;
+    }
+
     Font::RenderData BMFont::getRenderData(const std::string& text,
                                            Color color,
                                            float fontSize,
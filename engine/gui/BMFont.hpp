@@ -4,6 +4,7 @@
 #define OUZEL_GUI_BMFONT_HPP
 
 #include "Font.hpp"
+#include "../formats/Cooked.hpp"
 
 namespace ouzel::gui
 {
@@ -12,6 +13,12 @@ namespace ouzel::gui
     public:
         BMFont() = default;
         explicit BMFont(const std::vector<std::byte>& data);
+        BMFont(const cooked::Font& font,
+               const cooked::Glyph* glyphs,
+               std::size_t glyphCount,
+               const cooked::Kerning* kernings,
+               std::size_t kerningCount,
+               const std::shared_ptr<graphics::Texture>& texture);
 
         RenderData getRenderData(const std::string& text,
                                  Color color,
@@ -294,10 +294,10 @@ namespace ouzel::gui
                     checked = !checked;
                     updateSprite();
 
-                    auto changeEvent = std::make_unique<UIEvent>();
-                    changeEvent->type = Event::Type::widgetChange;
-                    changeEvent->actor = event.actor;
-                    engine->getEventDispatcher().dispatchEvent(std::move(changeEvent));
+                    UIEvent changeEvent;
+                    changeEvent.type = Event::Type::widgetChange;
+                    changeEvent.actor = event.actor;
+                    engine->getEventDispatcher().dispatchEvent(changeEvent);
                     break;
                 }
                 default:
@@ -527,11 +527,11 @@ namespace ouzel::gui
                 {
                     if (selectedWidget)
                     {
-                        auto clickEvent = std::make_unique<UIEvent>();
-                        clickEvent->type = Event::Type::actorClick;
-                        clickEvent->actor = selectedWidget;
-                        clickEvent->position = Vector2F(selectedWidget->getPosition());
-                        engine->getEventDispatcher().dispatchEvent(std::move(clickEvent));
+                        UIEvent clickEvent;
+                        clickEvent.type = Event::Type::actorClick;
+                        clickEvent.actor = selectedWidget;
+                        clickEvent.position = Vector2F(selectedWidget->getPosition());
+                        engine->getEventDispatcher().dispatchEvent(clickEvent);
                     }
                     break;
                 }
@@ -574,11 +574,11 @@ namespace ouzel::gui
             {
                 if (!event.previousPressed && event.pressed && selectedWidget)
                 {
-                    auto clickEvent = std::make_unique<UIEvent>();
-                    clickEvent->type = Event::Type::actorClick;
-                    clickEvent->actor = selectedWidget;
-                    clickEvent->position = Vector2F(selectedWidget->getPosition());
-                    engine->getEventDispatcher().dispatchEvent(std::move(clickEvent));
+                    UIEvent clickEvent;
+                    clickEvent.type = Event::Type::actorClick;
+                    clickEvent.actor = selectedWidget;
+                    clickEvent.position = Vector2F(selectedWidget->getPosition());
+                    engine->getEventDispatcher().dispatchEvent(clickEvent);
                 }
             }
 #endif
@@ -4,6 +4,8 @@
 #define OUZEL_HASH_FNV1_HPP
 
 #include <cstdint>
+#include <string_view>
+#include <type_traits>
 
 namespace ouzel::hash::fnv1
 {
@@ -24,12 +26,21 @@ namespace ouzel::hash::fnv1
         };
     }
 
-    template <typename Result, typename Value>
+    template <typename Result, typename Value, std::enable_if_t<std::is_integral_v<Value>>* = nullptr>
     constexpr Result hash(const Value value, const std::size_t i = 0,
                           const Result result = Constants<Result>::offsetBasis) noexcept
     {
         return (i < sizeof(Value)) ? hash<Result>(value, i + 1, (result * Constants<Result>::prime) ^ ((value >> (i * 8)) & 0xFF)) : result;
     }
+
+    template <typename Result>
+    constexpr Result hash(const std::string_view value,
+                          Result result = Constants<Result>::offsetBasis) noexcept
+    {
+        for (const char c : value)
+            result = (result * Constants<Result>::prime) ^ static_cast<std::uint8_t>(c);
+        return result;
+    }
 }
 
 #endif // OUZEL_HASH_FNV1_HPP
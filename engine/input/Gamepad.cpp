@@ -34,19 +34,19 @@ namespace ouzel::input
 
     bool Gamepad::handleButtonValueChange(Gamepad::Button button, bool pressed, float value)
     {
-        auto event = std::make_unique<GamepadEvent>();
-        event->type = Event::Type::gamepadButtonChange;
-        event->gamepad = this;
-        event->button = button;
-        event->previousPressed = buttonStates[static_cast<std::uint32_t>(button)].pressed;
-        event->pressed = pressed;
-        event->value = value;
-        event->previousValue = buttonStates[static_cast<std::uint32_t>(button)].value;
+        GamepadEvent event;
+        event.type = Event::Type::gamepadButtonChange;
+        event.gamepad = this;
+        event.button = button;
+        event.previousPressed = buttonStates[static_cast<std::uint32_t>(button)].pressed;
+        event.pressed = pressed;
+        event.value = value;
+        event.previousValue = buttonStates[static_cast<std::uint32_t>(button)].value;
 
         buttonStates[static_cast<std::uint32_t>(button)].pressed = pressed;
         buttonStates[static_cast<std::uint32_t>(button)].value = value;
 
-        return engine->getEventDispatcher().dispatchEvent(std::move(event));
+        return engine->getEventDispatcher().dispatchEvent(event);
     }
 
     void Gamepad::setVibration(Motor motor, float speed)
@@ -22,14 +22,17 @@ namespace ouzel::input
         inputSystem.sendEvent(deviceDisconnectEvent);
     }
 
-    std::future<bool> GamepadDevice::handleButtonValueChange(Gamepad::Button button, bool pressed, float value)
+    void GamepadDevice::handleButtonValueChange(Gamepad::Button button, bool pressed, float value)
     {
         InputSystem::Event event(InputSystem::Event::Type::gamepadButtonChange);
         event.deviceId = id;
         event.gamepadButton = button;
+        event.previousPressed = pressedButtons[static_cast<std::size_t>(button)];
         event.pressed = pressed;
         event.value = value;
 
-        return inputSystem.sendEvent(event);
+        pressedButtons[static_cast<std::size_t>(button)] = pressed;
+
+        inputSystem.sendEvent(event);
     }
 }
@@ -3,7 +3,7 @@
 #ifndef OUZEL_INPUT_GAMEPADDEVICE_HPP
 #define OUZEL_INPUT_GAMEPADDEVICE_HPP
 
-#include <future>
+#include <array>
 #include "InputDevice.hpp"
 #include "Gamepad.hpp"
 
@@ -15,7 +15,11 @@ namespace ouzel::input
         GamepadDevice(InputSystem& initInputSystem, DeviceId initId);
         ~GamepadDevice() override;
 
-        std::future<bool> handleButtonValueChange(Gamepad::Button button, bool pressed, float value);
+        void handleButtonValueChange(Gamepad::Button button, bool pressed, float value);
+
+    private:
+        // lets the input manager tell the presses and releases apart from the value changes
+        std::array<bool, static_cast<std::size_t>(Gamepad::Button::count)> pressedButtons{};
     };
 }
 
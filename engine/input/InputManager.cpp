@@ -32,53 +32,188 @@
 
 namespace ouzel::input
 {
-    InputManager::InputManager():
+    namespace
+    {
+        std::unique_ptr<InputSystem> createPlatformInputSystem(const InputSystem::EventCallback& callback)
+        {
 #if TARGET_OS_IOS
-        inputSystem(std::make_unique<ios::InputSystem>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            return std::make_unique<ios::InputSystem>(callback);
 #elif TARGET_OS_TV
-        inputSystem(std::make_unique<tvos::InputSystem>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            return std::make_unique<tvos::InputSystem>(callback);
 #elif TARGET_OS_MAC
-        inputSystem(std::make_unique<macos::InputSystem>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            return std::make_unique<macos::InputSystem>(callback);
 #elif defined(__ANDROID__)
-        inputSystem(std::make_unique<android::InputSystem>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            return std::make_unique<android::InputSystem>(callback);
 #elif defined(__linux__)
-        inputSystem(std::make_unique<linux::InputSystem>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            return std::make_unique<linux::InputSystem>(callback);
 #elif defined(_WIN32)
-        inputSystem(std::make_unique<windows::InputSystem>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            return std::make_unique<windows::InputSystem>(callback);
 #elif defined(__EMSCRIPTEN__)
-        inputSystem(std::make_unique<emscripten::InputSystem>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            return std::make_unique<emscripten::InputSystem>(callback);
 #else
-        inputSystem(std::make_unique<InputSystem>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            return std::make_unique<InputSystem>(callback);
 #endif
+        }
+    }
+
+    InputManager::InputManager():
+        InputManager(createPlatformInputSystem)
     {
     }
 
+    InputManager::InputManager(const std::function<std::unique_ptr<InputSystem>(const InputSystem::EventCallback&)>& createInputSystem):
+        inputSystem(createInputSystem(std::bind(&InputManager::eventCallback, this, std::placeholders::_1, std::placeholders::_2)))
+    {
+    }
+
+    namespace
+    {
+        // The presses and releases of the gamepad buttons are never merged, only their value changes are
+        bool isCoalescable(const InputSystem::Event& event) noexcept
+        {
+            return event.type == InputSystem::Event::Type::mouseMove ||
+                event.type == InputSystem::Event::Type::mouseRelativeMove ||
+                (event.type == InputSystem::Event::Type::gamepadButtonChange && event.pressed == event.previousPressed);
+        }
+
+        // Returns true if the events update the same position, delta or button value
+        bool isSameSource(const InputSystem::Event& a, const InputSystem::Event& b) noexcept
+        {
+            return a.type == b.type && a.deviceId == b.deviceId &&
+                (a.type != InputSystem::Event::Type::gamepadButtonChange || a.gamepadButton == b.gamepadButton);
+        }
+
+        // Merges the event into the previous one if it only updates the position or the axis value
+        bool coalesce(InputSystem::Event& previous, const InputSystem::Event& event) noexcept
+        {
+            if (!isCoalescable(event) || !isSameSource(previous, event))
+                return false;
+
+            switch (event.type)
+            {
+                case InputSystem::Event::Type::mouseMove:
+                    previous.position = event.position;
+                    return true;
+                case InputSystem::Event::Type::mouseRelativeMove:
+                    previous.position += event.position;
+                    return true;
+                case InputSystem::Event::Type::gamepadButtonChange:
+                    if (previous.pressed != event.pressed)
+                        return false;
+
+                    previous.value = event.value;
+                    return true;
+                default:
+                    return false;
+            }
+        }
+    }
+
     void InputManager::update()
     {
-        std::pair<std::promise<bool>, InputSystem::Event> p;
+        // coalescable events are held back until an event that can't be merged with them arrives
+        std::optional<QueuedEvent> pending;
+
+        eventQueue.drain([this, &pending](QueuedEvent& queuedEvent) {
+            if (pending)
+            {
+                if (!queuedEvent.promise && coalesce(pending->event, queuedEvent.event))
+                {
+                    ++coalescedEventCount;
+                    return;
+                }
+
+                handleQueuedEvent(*pending);
+                pending.reset();
+            }
+
+            if (!queuedEvent.promise && isCoalescable(queuedEvent.event))
+                pending = std::move(queuedEvent);
+            else
+                handleQueuedEvent(queuedEvent);
+        });
+
+        if (pending) handleQueuedEvent(*pending);
+
+        // the deferred events are newer than the queued events of the same device
+        if (hasDeferredEvents.load(std::memory_order_acquire))
+        {
+            {
+                std::scoped_lock lock(deferredEventMutex);
+                std::swap(deferredEvents, flushedEvents);
+                hasDeferredEvents.store(false, std::memory_order_release);
+            }
+
+            for (const auto& event : flushedEvents)
+                handleEvent(event);
+
+            flushedEvents.clear();
+        }
+    }
+
+    void InputManager::eventCallback(const InputSystem::Event& event, std::promise<bool>* promise)
+    {
+        QueuedEvent queuedEvent{event, std::nullopt};
+        if (promise) queuedEvent.promise.emplace(std::move(*promise));
 
-        for (;;)
+        if (!promise && isCoalescable(event))
         {
-            std::unique_lock lock(eventQueueMutex);
-            if (eventQueue.empty()) break;
+            // once an event was deferred, the following ones of the same source are merged with it,
+            // so that the deferred event stays the newest one
+            if (hasDeferredEvents.load(std::memory_order_acquire))
+            {
+                std::scoped_lock lock(deferredEventMutex);
 
-            p = std::move(eventQueue.front());
-            eventQueue.pop();
-            lock.unlock();
+                if (std::any_of(deferredEvents.begin(), deferredEvents.end(), [&event](const auto& deferredEvent) noexcept {
+                    return isSameSource(deferredEvent, event);
+                }))
+                {
+                    deferEvent(event);
+                    return;
+                }
+            }
+
+            // moves and axis changes are merged instead of being put in the overflow list when the queue is full
+            if (!eventQueue.tryPush(std::move(queuedEvent)))
+            {
+                std::scoped_lock lock(deferredEventMutex);
+                deferEvent(event);
+            }
+        }
+        else
+        {
+            // a press or a release carries the newest value of the button
+            if (event.type == InputSystem::Event::Type::gamepadButtonChange &&
+                hasDeferredEvents.load(std::memory_order_acquire))
+            {
+                std::scoped_lock lock(deferredEventMutex);
+
+                deferredEvents.erase(std::remove_if(deferredEvents.begin(), deferredEvents.end(), [&event](const auto& deferredEvent) noexcept {
+                    return isSameSource(deferredEvent, event);
+                }), deferredEvents.end());
+            }
 
-            p.first.set_value(handleEvent(p.second));
+            eventQueue.push(std::move(queuedEvent));
         }
     }
 
-    std::future<bool> InputManager::eventCallback(const InputSystem::Event& event)
+    void InputManager::deferEvent(const InputSystem::Event& event)
     {
-        std::pair<std::promise<bool>, InputSystem::Event> p(std::promise<bool>(), event);
-        std::future<bool> f = p.first.get_future();
+        const auto i = std::find_if(deferredEvents.begin(), deferredEvents.end(), [&event](auto& deferredEvent) noexcept {
+            return isSameSource(deferredEvent, event);
+        });
 
-        std::lock_guard lock(eventQueueMutex);
-        eventQueue.push(std::move(p));
+        if (i == deferredEvents.end() || !coalesce(*i, event))
+            deferredEvents.push_back(event);
 
-        return f;
+        deferredEventCount.fetch_add(1, std::memory_order_relaxed);
+        hasDeferredEvents.store(true, std::memory_order_release);
+    }
+
+    void InputManager::handleQueuedEvent(QueuedEvent& queuedEvent)
+    {
+        const bool handled = handleEvent(queuedEvent.event);
+        if (queuedEvent.promise) queuedEvent.promise->set_value(handled);
     }
 
     bool InputManager::handleEvent(const InputSystem::Event& event)
@@ -94,12 +229,12 @@ namespace ouzel::input
                         auto controller = std::make_unique<Gamepad>(*this, event.deviceId);
                         controllers.push_back(controller.get());
 
-                        auto connectEvent = std::make_unique<GamepadEvent>();
-                        connectEvent->type = Event::Type::gamepadConnect;
-                        connectEvent->gamepad = controller.get();
+                        GamepadEvent connectEvent;
+                        connectEvent.type = Event::Type::gamepadConnect;
+                        connectEvent.gamepad = controller.get();
 
                         controllerMap.insert(std::make_pair(event.deviceId, std::move(controller)));
-                        return engine->getEventDispatcher().dispatchEvent(std::move(connectEvent));
+                        return engine->getEventDispatcher().dispatchEvent(connectEvent);
                     }
                     case Controller::Type::keyboard:
                     {
@@ -107,12 +242,12 @@ namespace ouzel::input
                         controllers.push_back(controller.get());
                         if (!keyboard) keyboard = controller.get();
 
-                        auto connectEvent = std::make_unique<KeyboardEvent>();
-                        connectEvent->type = Event::Type::keyboardConnect;
-                        connectEvent->keyboard = controller.get();
+                        KeyboardEvent connectEvent;
+                        connectEvent.type = Event::Type::keyboardConnect;
+                        connectEvent.keyboard = controller.get();
 
                         controllerMap.insert(std::make_pair(event.deviceId, std::move(controller)));
-                        return engine->getEventDispatcher().dispatchEvent(std::move(connectEvent));
+                        return engine->getEventDispatcher().dispatchEvent(connectEvent);
                     }
                     case Controller::Type::mouse:
                     {
@@ -120,12 +255,12 @@ namespace ouzel::input
                         controllers.push_back(controller.get());
                         if (!mouse) mouse = controller.get();
 
-                        auto connectEvent = std::make_unique<MouseEvent>();
-                        connectEvent->type = Event::Type::mouseConnect;
-                        connectEvent->mouse = controller.get();
+                        MouseEvent connectEvent;
+                        connectEvent.type = Event::Type::mouseConnect;
+                        connectEvent.mouse = controller.get();
 
                         controllerMap.insert(std::make_pair(event.deviceId, std::move(controller)));
-                        return engine->getEventDispatcher().dispatchEvent(std::move(connectEvent));
+                        return engine->getEventDispatcher().dispatchEvent(connectEvent);
                     }
                     case Controller::Type::touchpad:
                     {
@@ -133,12 +268,12 @@ namespace ouzel::input
                         controllers.push_back(controller.get());
                         if (!touchpad) touchpad = controller.get();
 
-                        auto connectEvent = std::make_unique<TouchEvent>();
-                        connectEvent->type = Event::Type::touchpadConnect;
-                        connectEvent->touchpad = controller.get();
+                        TouchEvent connectEvent;
+                        connectEvent.type = Event::Type::touchpadConnect;
+                        connectEvent.touchpad = controller.get();
 
                         controllerMap.insert(std::make_pair(event.deviceId, std::move(controller)));
-                        return engine->getEventDispatcher().dispatchEvent(std::move(connectEvent));
+                        return engine->getEventDispatcher().dispatchEvent(connectEvent);
                     }
                     default: throw std::runtime_error("Invalid controller type");
                 }
@@ -159,46 +294,46 @@ namespace ouzel::input
                     {
                         case Controller::Type::gamepad:
                         {
-                            auto disconnectEvent = std::make_unique<GamepadEvent>();
-                            disconnectEvent->type = Event::Type::gamepadDisconnect;
-                            disconnectEvent->gamepad = static_cast<Gamepad*>(i->second.get());
-                            handled = engine->getEventDispatcher().dispatchEvent(std::move(disconnectEvent));
+                            GamepadEvent disconnectEvent;
+                            disconnectEvent.type = Event::Type::gamepadDisconnect;
+                            disconnectEvent.gamepad = static_cast<Gamepad*>(i->second.get());
+                            handled = engine->getEventDispatcher().dispatchEvent(disconnectEvent);
                             break;
                         }
                         case Controller::Type::keyboard:
                         {
-                            auto disconnectEvent = std::make_unique<KeyboardEvent>();
-                            disconnectEvent->type = Event::Type::keyboardDisconnect;
-                            disconnectEvent->keyboard = static_cast<Keyboard*>(i->second.get());
+                            KeyboardEvent disconnectEvent;
+                            disconnectEvent.type = Event::Type::keyboardDisconnect;
+                            disconnectEvent.keyboard = static_cast<Keyboard*>(i->second.get());
                             keyboard = nullptr;
                             for (Controller* controller : controllers)
                                 if (controller->getType() == Controller::Type::keyboard)
                                     keyboard = static_cast<Keyboard*>(controller);
-                            handled = engine->getEventDispatcher().dispatchEvent(std::move(disconnectEvent));
+                            handled = engine->getEventDispatcher().dispatchEvent(disconnectEvent);
                             break;
                         }
                         case Controller::Type::mouse:
                         {
-                            auto disconnectEvent = std::make_unique<MouseEvent>();
-                            disconnectEvent->type = Event::Type::mouseDisconnect;
-                            disconnectEvent->mouse = static_cast<Mouse*>(i->second.get());
+                            MouseEvent disconnectEvent;
+                            disconnectEvent.type = Event::Type::mouseDisconnect;
+                            disconnectEvent.mouse = static_cast<Mouse*>(i->second.get());
                             mouse = nullptr;
                             for (Controller* controller : controllers)
                                 if (controller->getType() == Controller::Type::mouse)
                                     mouse = static_cast<Mouse*>(controller);
-                            handled = engine->getEventDispatcher().dispatchEvent(std::move(disconnectEvent));
+                            handled = engine->getEventDispatcher().dispatchEvent(disconnectEvent);
                             break;
                         }
                         case Controller::Type::touchpad:
                         {
-                            auto disconnectEvent = std::make_unique<TouchEvent>();
-                            disconnectEvent->type = Event::Type::touchpadDisconnect;
-                            disconnectEvent->touchpad = static_cast<Touchpad*>(i->second.get());
+                            TouchEvent disconnectEvent;
+                            disconnectEvent.type = Event::Type::touchpadDisconnect;
+                            disconnectEvent.touchpad = static_cast<Touchpad*>(i->second.get());
                             touchpad = nullptr;
                             for (Controller* controller : controllers)
                                 if (controller->getType() == Controller::Type::touchpad)
                                     touchpad = static_cast<Touchpad*>(controller);
-                            handled = engine->getEventDispatcher().dispatchEvent(std::move(disconnectEvent));
+                            handled = engine->getEventDispatcher().dispatchEvent(disconnectEvent);
                             break;
                         }
                         default: throw std::runtime_error("Invalid controller type");
@@ -3,13 +3,17 @@
 #ifndef OUZEL_INPUT_INPUTMANAGER_HPP
 #define OUZEL_INPUT_INPUTMANAGER_HPP
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <optional>
 #include <vector>
 #include <unordered_map>
 #include "InputSystem.hpp"
 #include "../math/Vector.hpp"
+#include "../thread/RingQueue.hpp"
 
 namespace ouzel::input
 {
@@ -23,6 +27,8 @@ namespace ouzel::input
     {
     public:
         InputManager();
+        // Uses the input system created by the function instead of the one of the platform
+        explicit InputManager(const std::function<std::unique_ptr<InputSystem>(const InputSystem::EventCallback&)>& createInputSystem);
 
         InputManager(const InputManager&) = delete;
         InputManager& operator=(const InputManager&) = delete;
@@ -43,12 +49,35 @@ namespace ouzel::input
         void showVirtualKeyboard();
         void hideVirtualKeyboard();
 
+        // Number of move and axis events that didn't fit in the event queue, they are merged with
+        // the other deferred events of their device and handled at the end of the next update
+        auto getDeferredEventCount() const noexcept { return deferredEventCount.load(std::memory_order_relaxed); }
+
+        // Number of move and axis events that were merged with the following event of the same kind
+        auto getCoalescedEventCount() const noexcept { return coalescedEventCount; }
+
     private:
-        std::future<bool> eventCallback(const InputSystem::Event& event);
+        struct QueuedEvent final
+        {
+            InputSystem::Event event;
+            std::optional<std::promise<bool>> promise;
+        };
+
+        void eventCallback(const InputSystem::Event& event, std::promise<bool>* promise);
+        void deferEvent(const InputSystem::Event& event);
+        void handleQueuedEvent(QueuedEvent& queuedEvent);
         bool handleEvent(const InputSystem::Event& event);
 
-        std::mutex eventQueueMutex;
-        std::queue<std::pair<std::promise<bool>, InputSystem::Event>> eventQueue;
+        thread::RingQueue<QueuedEvent> eventQueue{1024};
+        std::atomic<std::uint64_t> deferredEventCount{0};
+        std::uint64_t coalescedEventCount = 0;
+
+        // the latest absolute move, the sum of the relative moves and the latest value of every button
+        // whose events didn't fit in the queue, guarded by the mutex because they are written by the producers
+        std::mutex deferredEventMutex;
+        std::vector<InputSystem::Event> deferredEvents;
+        std::vector<InputSystem::Event> flushedEvents;
+        std::atomic<bool> hasDeferredEvents{false};
 
         std::unique_ptr<InputSystem> inputSystem;
         Keyboard* keyboard = nullptr;
@@ -6,7 +6,7 @@
 
 namespace ouzel::input
 {
-    InputSystem::InputSystem(const std::function<std::future<bool>(const Event&)>& initCallback):
+    InputSystem::InputSystem(const EventCallback& initCallback):
         callback(initCallback)
     {
     }
@@ -16,9 +16,17 @@ namespace ouzel::input
         engine->executeOnMainThread(std::bind(&InputSystem::executeCommand, this, command));
     }
 
-    std::future<bool> InputSystem::sendEvent(const Event& event)
+    void InputSystem::sendEvent(const Event& event)
     {
-        return callback(event);
+        callback(event, nullptr);
+    }
+
+    std::future<bool> InputSystem::sendEventWithResult(const Event& event)
+    {
+        std::promise<bool> promise;
+        auto future = promise.get_future();
+        callback(event, &promise);
+        return future;
     }
 
     void InputSystem::addInputDevice(InputDevice& inputDevice)
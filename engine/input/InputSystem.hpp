@@ -126,7 +126,10 @@ namespace ouzel::input
             float force = 1.0F;
         };
 
-        explicit InputSystem(const std::function<std::future<bool>(const Event&)>& initCallback);
+        // The promise is null unless the sender asked for the result, otherwise the callback takes it over
+        using EventCallback = std::function<void(const Event&, std::promise<bool>*)>;
+
+        explicit InputSystem(const EventCallback& initCallback);
         virtual ~InputSystem() = default;
 
         void addCommand(const Command& command);
@@ -151,7 +154,8 @@ namespace ouzel::input
         }
 
     protected:
-        std::future<bool> sendEvent(const Event& event);
+        void sendEvent(const Event& event);
+        std::future<bool> sendEventWithResult(const Event& event);
         void addInputDevice(InputDevice& inputDevice);
         void removeInputDevice(const InputDevice& inputDevice);
         InputDevice* getInputDevice(DeviceId id);
@@ -159,7 +163,7 @@ namespace ouzel::input
     private:
         virtual void executeCommand(const Command&) {}
 
-        std::function<std::future<bool>(const Event&)> callback;
+        EventCallback callback;
         std::unordered_map<DeviceId, InputDevice*> inputDevices;
 
         std::size_t lastResourceId = 0;
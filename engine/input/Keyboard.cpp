@@ -14,16 +14,16 @@ namespace ouzel::input
 
     bool Keyboard::handleKeyPress(Keyboard::Key key)
     {
-        auto event = std::make_unique<KeyboardEvent>();
-        event->keyboard = this;
-        event->key = key;
+        KeyboardEvent event;
+        event.keyboard = this;
+        event.key = key;
 
         if (!keyStates[static_cast<std::uint32_t>(key)])
         {
             keyStates[static_cast<std::uint32_t>(key)] = true;
 
-            event->type = Event::Type::keyboardKeyPress;
-            return engine->getEventDispatcher().dispatchEvent(std::move(event));
+            event.type = Event::Type::keyboardKeyPress;
+            return engine->getEventDispatcher().dispatchEvent(event);
         }
 
         return false;
@@ -33,11 +33,11 @@ namespace ouzel::input
     {
         keyStates[static_cast<std::uint32_t>(key)] = false;
 
-        auto event = std::make_unique<KeyboardEvent>();
-        event->type = Event::Type::keyboardKeyRelease;
-        event->keyboard = this;
-        event->key = key;
+        KeyboardEvent event;
+        event.type = Event::Type::keyboardKeyRelease;
+        event.keyboard = this;
+        event.key = key;
 
-        return engine->getEventDispatcher().dispatchEvent(std::move(event));
+        return engine->getEventDispatcher().dispatchEvent(event);
     }
 }
@@ -27,7 +27,7 @@ namespace ouzel::input
         InputSystem::Event event(InputSystem::Event::Type::keyboardKeyPress);
         event.deviceId = id;
         event.keyboardKey = key;
-        return inputSystem.sendEvent(event);
+        return inputSystem.sendEventWithResult(event);
     }
 
     std::future<bool> KeyboardDevice::handleKeyRelease(Keyboard::Key key)
@@ -35,6 +35,6 @@ namespace ouzel::input
         InputSystem::Event event(InputSystem::Event::Type::keyboardKeyRelease);
         event.deviceId = id;
         event.keyboardKey = key;
-        return inputSystem.sendEvent(event);
+        return inputSystem.sendEventWithResult(event);
     }
 }
@@ -59,39 +59,39 @@ namespace ouzel::input
     {
         buttonStates[static_cast<std::uint32_t>(button)] = true;
 
-        auto event = std::make_unique<MouseEvent>();
-        event->type = Event::Type::mousePress;
-        event->mouse = this;
-        event->button = button;
-        event->position = pos;
+        MouseEvent event;
+        event.type = Event::Type::mousePress;
+        event.mouse = this;
+        event.button = button;
+        event.position = pos;
 
-        return engine->getEventDispatcher().dispatchEvent(std::move(event));
+        return engine->getEventDispatcher().dispatchEvent(event);
     }
 
     bool Mouse::handleButtonRelease(Mouse::Button button, const Vector2F& pos)
     {
         buttonStates[static_cast<std::uint32_t>(button)] = false;
 
-        auto event = std::make_unique<MouseEvent>();
-        event->type = Event::Type::mouseRelease;
-        event->mouse = this;
-        event->button = button;
-        event->position = pos;
+        MouseEvent event;
+        event.type = Event::Type::mouseRelease;
+        event.mouse = this;
+        event.button = button;
+        event.position = pos;
 
-        return engine->getEventDispatcher().dispatchEvent(std::move(event));
+        return engine->getEventDispatcher().dispatchEvent(event);
     }
 
     bool Mouse::handleMove(const Vector2F& pos)
     {
-        auto event = std::make_unique<MouseEvent>();
-        event->type = Event::Type::mouseMove;
-        event->mouse = this;
-        event->difference = pos - position;
-        event->position = pos;
+        MouseEvent event;
+        event.type = Event::Type::mouseMove;
+        event.mouse = this;
+        event.difference = pos - position;
+        event.position = pos;
 
         position = pos;
 
-        return engine->getEventDispatcher().dispatchEvent(std::move(event));
+        return engine->getEventDispatcher().dispatchEvent(event);
     }
 
     bool Mouse::handleRelativeMove(const Vector2F& pos)
@@ -106,24 +106,24 @@ namespace ouzel::input
 
     bool Mouse::handleScroll(const Vector2F& scroll, const Vector2F& pos)
     {
-        auto event = std::make_unique<MouseEvent>();
-        event->type = Event::Type::mouseScroll;
-        event->mouse = this;
-        event->position = pos;
-        event->scroll = scroll;
+        MouseEvent event;
+        event.type = Event::Type::mouseScroll;
+        event.mouse = this;
+        event.position = pos;
+        event.scroll = scroll;
 
-        return engine->getEventDispatcher().dispatchEvent(std::move(event));
+        return engine->getEventDispatcher().dispatchEvent(event);
     }
 
     bool Mouse::handleCursorLockChange(bool locked)
     {
         cursorLocked = locked;
 
-        auto event = std::make_unique<MouseEvent>();
-        event->type = Event::Type::mouseCursorLockChange;
-        event->mouse = this;
-        event->locked = cursorLocked;
+        MouseEvent event;
+        event.type = Event::Type::mouseCursorLockChange;
+        event.mouse = this;
+        event.locked = cursorLocked;
 
-        return engine->getEventDispatcher().dispatchEvent(std::move(event));
+        return engine->getEventDispatcher().dispatchEvent(event);
     }
 }
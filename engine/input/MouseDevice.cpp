@@ -22,54 +22,54 @@ namespace ouzel::input
         inputSystem.sendEvent(deviceDisconnectEvent);
     }
 
-    std::future<bool> MouseDevice::handleButtonPress(Mouse::Button button, const Vector2F& position)
+    void MouseDevice::handleButtonPress(Mouse::Button button, const Vector2F& position)
     {
         InputSystem::Event event(InputSystem::Event::Type::mousePress);
         event.deviceId = id;
         event.mouseButton = button;
         event.position = position;
-        return inputSystem.sendEvent(event);
+        inputSystem.sendEvent(event);
     }
 
-    std::future<bool> MouseDevice::handleButtonRelease(Mouse::Button button, const Vector2F& position)
+    void MouseDevice::handleButtonRelease(Mouse::Button button, const Vector2F& position)
     {
         InputSystem::Event event(InputSystem::Event::Type::mouseRelease);
         event.deviceId = id;
         event.mouseButton = button;
         event.position = position;
-        return inputSystem.sendEvent(event);
+        inputSystem.sendEvent(event);
     }
 
-    std::future<bool> MouseDevice::handleMove(const Vector2F& position)
+    void MouseDevice::handleMove(const Vector2F& position)
     {
         InputSystem::Event event(InputSystem::Event::Type::mouseMove);
         event.deviceId = id;
         event.position = position;
-        return inputSystem.sendEvent(event);
+        inputSystem.sendEvent(event);
     }
 
-    std::future<bool> MouseDevice::handleRelativeMove(const Vector2F& position)
+    void MouseDevice::handleRelativeMove(const Vector2F& position)
     {
         InputSystem::Event event(InputSystem::Event::Type::mouseRelativeMove);
         event.deviceId = id;
         event.position = position;
-        return inputSystem.sendEvent(event);
+        inputSystem.sendEvent(event);
     }
 
-    std::future<bool> MouseDevice::handleScroll(const Vector2F& scroll, const Vector2F& position)
+    void MouseDevice::handleScroll(const Vector2F& scroll, const Vector2F& position)
     {
         InputSystem::Event event(InputSystem::Event::Type::mouseScroll);
         event.deviceId = id;
         event.position = position;
         event.scroll = scroll;
-        return inputSystem.sendEvent(event);
+        inputSystem.sendEvent(event);
     }
 
-    std::future<bool> MouseDevice::handleCursorLockChange(bool locked)
+    void MouseDevice::handleCursorLockChange(bool locked)
     {
         InputSystem::Event event(InputSystem::Event::Type::mouseLockChanged);
         event.deviceId = id;
         event.locked = locked;
-        return inputSystem.sendEvent(event);
+        inputSystem.sendEvent(event);
     }
 }
@@ -14,64 +14,64 @@ namespace ouzel::input
 
     bool Touchpad::handleTouchBegin(std::uint64_t touchId, const Vector2F& position, float force)
     {
-        auto event = std::make_unique<TouchEvent>();
-        event->type = Event::Type::touchBegin;
-        event->touchpad = this;
-        event->touchId = touchId;
-        event->position = position;
-        event->force = force;
+        TouchEvent event;
+        event.type = Event::Type::touchBegin;
+        event.touchpad = this;
+        event.touchId = touchId;
+        event.position = position;
+        event.force = force;
 
         touchPositions[touchId] = position;
 
-        return engine->getEventDispatcher().dispatchEvent(std::move(event));
+        return engine->getEventDispatcher().dispatchEvent(event);
     }
 
     bool Touchpad::handleTouchEnd(std::uint64_t touchId, const Vector2F& position, float force)
     {
-        auto event = std::make_unique<TouchEvent>();
-        event->type = Event::Type::touchEnd;
-        event->touchpad = this;
-        event->touchId = touchId;
-        event->position = position;
-        event->force = force;
+        TouchEvent event;
+        event.type = Event::Type::touchEnd;
+        event.touchpad = this;
+        event.touchId = touchId;
+        event.position = position;
+        event.force = force;
 
         const auto i = touchPositions.find(touchId);
 
         if (i != touchPositions.end())
             touchPositions.erase(i);
 
-        return engine->getEventDispatcher().dispatchEvent(std::move(event));
+        return engine->getEventDispatcher().dispatchEvent(event);
     }
 
     bool Touchpad::handleTouchMove(std::uint64_t touchId, const Vector2F& position, float force)
     {
-        auto event = std::make_unique<TouchEvent>();
-        event->type = Event::Type::touchMove;
-        event->touchpad = this;
-        event->touchId = touchId;
-        event->difference = position - touchPositions[touchId];
-        event->position = position;
-        event->force = force;
+        TouchEvent event;
+        event.type = Event::Type::touchMove;
+        event.touchpad = this;
+        event.touchId = touchId;
+        event.difference = position - touchPositions[touchId];
+        event.position = position;
+        event.force = force;
 
         touchPositions[touchId] = position;
 
-        return engine->getEventDispatcher().dispatchEvent(std::move(event));
+        return engine->getEventDispatcher().dispatchEvent(event);
     }
 
     bool Touchpad::handleTouchCancel(std::uint64_t touchId, const Vector2F& position, float force)
     {
-        auto event = std::make_unique<TouchEvent>();
-        event->type = Event::Type::touchCancel;
-        event->touchpad = this;
-        event->touchId = touchId;
-        event->position = position;
-        event->force = force;
+        TouchEvent event;
+        event.type = Event::Type::touchCancel;
+        event.touchpad = this;
+        event.touchId = touchId;
+        event.position = position;
+        event.force = force;
 
         const auto i = touchPositions.find(touchId);
 
         if (i != touchPositions.end())
             touchPositions.erase(i);
 
-        return engine->getEventDispatcher().dispatchEvent(std::move(event));
+        return engine->getEventDispatcher().dispatchEvent(event);
     }
 }
@@ -23,43 +23,43 @@ namespace ouzel::input
         inputSystem.sendEvent(deviceDisconnectEvent);
     }
 
-    std::future<bool> TouchpadDevice::handleTouchBegin(std::uint64_t touchId, const Vector2F& position, float force)
+    void TouchpadDevice::handleTouchBegin(std::uint64_t touchId, const Vector2F& position, float force)
     {
         InputSystem::Event event(InputSystem::Event::Type::touchBegin);
         event.deviceId = id;
         event.touchId = touchId;
         event.position = position;
         event.force = force;
-        return inputSystem.sendEvent(event);
+        inputSystem.sendEvent(event);
     }
 
-    std::future<bool> TouchpadDevice::handleTouchEnd(std::uint64_t touchId, const Vector2F& position, float force)
+    void TouchpadDevice::handleTouchEnd(std::uint64_t touchId, const Vector2F& position, float force)
     {
         InputSystem::Event event(InputSystem::Event::Type::touchEnd);
         event.deviceId = id;
         event.touchId = touchId;
         event.position = position;
         event.force = force;
-        return inputSystem.sendEvent(event);
+        inputSystem.sendEvent(event);
     }
 
-    std::future<bool> TouchpadDevice::handleTouchMove(std::uint64_t touchId, const Vector2F& position, float force)
+    void TouchpadDevice::handleTouchMove(std::uint64_t touchId, const Vector2F& position, float force)
     {
         InputSystem::Event event(InputSystem::Event::Type::touchMove);
         event.deviceId = id;
         event.touchId = touchId;
         event.position = position;
         event.force = force;
-        return inputSystem.sendEvent(event);
+        inputSystem.sendEvent(event);
     }
 
-    std::future<bool> TouchpadDevice::handleTouchCancel(std::uint64_t touchId, const Vector2F& position, float force)
+    void TouchpadDevice::handleTouchCancel(std::uint64_t touchId, const Vector2F& position, float force)
     {
         InputSystem::Event event(InputSystem::Event::Type::touchCancel);
         event.deviceId = id;
         event.touchId = touchId;
         event.position = position;
         event.force = force;
-        return inputSystem.sendEvent(event);
+        inputSystem.sendEvent(event);
     }
 }
@@ -298,7 +298,7 @@ namespace ouzel::input::emscripten
         }
     }
 
-    InputSystem::InputSystem(const std::function<std::future<bool>(const Event&)>& initCallback):
+    InputSystem::InputSystem(const EventCallback& initCallback):
         input::InputSystem(initCallback),
         keyboardDevice(std::make_unique<KeyboardDevice>(*this, getNextDeviceId())),
         mouseDevice(std::make_unique<MouseDevice>(*this, getNextDeviceId())),
@@ -325,7 +325,7 @@ namespace ouzel::input::emscripten
         const int result = emscripten_get_num_gamepads();
 
         if (result == EMSCRIPTEN_RESULT_NOT_SUPPORTED)
-            logger.log(Log::Level::info) << "Gamepads not supported";
+            OUZEL_LOG(Log::Level::info) << "Gamepads not supported";
         else
         {
             for (long index = 0; index < result; ++index)
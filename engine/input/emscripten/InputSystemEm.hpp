@@ -15,7 +15,7 @@ namespace ouzel::input::emscripten
     class InputSystem final: public input::InputSystem
     {
     public:
-        InputSystem(const std::function<std::future<bool>(const Event&)>& initCallback);
+        InputSystem(const EventCallback& initCallback);
 
         auto getKeyboardDevice() const noexcept { return keyboardDevice.get(); }
         auto getMouseDevice() const noexcept { return mouseDevice.get(); }
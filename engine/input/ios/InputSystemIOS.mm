@@ -36,7 +36,7 @@
 
 namespace ouzel::input::ios
 {
-    InputSystem::InputSystem(const std::function<std::future<bool>(const Event&)>& initCallback):
+    InputSystem::InputSystem(const EventCallback& initCallback):
         input::InputSystem(initCallback),
         keyboardDevice(std::make_unique<KeyboardDevice>(*this, getNextDeviceId())),
         touchpadDevice(std::make_unique<TouchpadDevice>(*this, getNextDeviceId(), true))
@@ -19,7 +19,7 @@
 
 namespace ouzel::input::linux
 {
-    InputSystem::InputSystem(const std::function<std::future<bool>(const Event&)>& initCallback):
+    InputSystem::InputSystem(const EventCallback& initCallback):
 #if OUZEL_SUPPORTS_X11
         input::InputSystem(initCallback),
         keyboardDevice(std::make_unique<KeyboardDevice>(*this, getNextDeviceId())),
@@ -66,7 +66,7 @@ namespace ouzel::input::macos
         return errorCategory;
     }
 
-    InputSystem::InputSystem(const std::function<std::future<bool>(const Event&)>& initCallback):
+    InputSystem::InputSystem(const EventCallback& initCallback):
         input::InputSystem(initCallback),
         keyboardDevice(std::make_unique<KeyboardDevice>(*this, getNextDeviceId())),
         mouseDevice(std::make_unique<MouseDevice>(*this, getNextDeviceId())),
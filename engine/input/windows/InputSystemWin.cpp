@@ -43,7 +43,7 @@ namespace ouzel::input::windows
         return errorCategory;
     }
 
-    InputSystem::InputSystem(const std::function<std::future<bool>(const Event&)>& initCallback):
+    InputSystem::InputSystem(const EventCallback& initCallback):
                              input::InputSystem(initCallback),
                              keyboardDevice(std::make_unique<KeyboardDevice>(*this, getNextDeviceId())),
                              mouseDevice(std::make_unique<MouseDevice>(*this, getNextDeviceId())),
@@ -36,7 +36,7 @@ namespace ouzel::input::windows
     class InputSystem final: public input::InputSystem
     {
     public:
-        explicit InputSystem(const std::function<std::future<bool>(const Event&)>& initCallback);
+        explicit InputSystem(const EventCallback& initCallback);
         ~InputSystem() override;
 
         auto getKeyboardDevice() const noexcept { return keyboardDevice.get(); }
@@ -18,10 +18,12 @@ LOCAL_C_INCLUDES += $(LOCAL_PATH)/.. \
     $(LOCAL_PATH)/../../external/smbPitchShift \
     $(LOCAL_PATH)/../../external/stb
 
-LOCAL_SRC_FILES := ../assets/BmfLoader.cpp \
+LOCAL_SRC_FILES := ../assets/Atlas.cpp \
+    ../assets/BmfLoader.cpp \
     ../assets/Bundle.cpp \
     ../assets/Cache.cpp \
     ../assets/ColladaLoader.cpp \
+    ../assets/CookedLoader.cpp \
     ../assets/CueLoader.cpp \
     ../assets/GltfLoader.cpp \
     ../assets/ImageLoader.cpp \
@@ -34,6 +36,7 @@ LOCAL_SRC_FILES := ../assets/BmfLoader.cpp \
     ../assets/WaveLoader.cpp \
     ../audio/mixer/Bus.cpp \
     ../audio/mixer/Mixer.cpp \
+    ../audio/mixer/Spatializer.cpp \
     ../audio/opensl/OSLAudioDevice.cpp \
     ../audio/Audio.cpp \
     ../audio/AudioDevice.cpp \
@@ -45,6 +48,7 @@ LOCAL_SRC_FILES := ../assets/BmfLoader.cpp \
     ../audio/Mix.cpp \
     ../audio/Node.cpp \
     ../audio/Oscillator.cpp \
+    ../audio/offline/OfflineAudioDevice.cpp \
     ../audio/PcmClip.cpp \
     ../audio/SilenceSound.cpp \
     ../audio/Sound.cpp \
@@ -55,6 +59,7 @@ LOCAL_SRC_FILES := ../assets/BmfLoader.cpp \
     ../core/android/NativeWindowAndroid.cpp \
     ../core/android/SystemAndroid.cpp \
     ../core/Engine.cpp \
+    ../core/FrameScheduler.cpp \
     ../core/NativeWindow.cpp \
     ../core/System.cpp \
     ../core/Window.cpp \
@@ -63,6 +68,7 @@ LOCAL_SRC_FILES := ../assets/BmfLoader.cpp \
     ../graphics/opengl/OGLBlendState.cpp \
     ../graphics/opengl/OGLBuffer.cpp \
     ../graphics/opengl/OGLDepthStencilState.cpp \
+    ../graphics/opengl/OGLProgramCache.cpp \
     ../graphics/opengl/OGLRenderDevice.cpp \
     ../graphics/opengl/OGLRenderTarget.cpp \
     ../graphics/opengl/OGLShader.cpp \
@@ -70,12 +76,15 @@ LOCAL_SRC_FILES := ../assets/BmfLoader.cpp \
     ../graphics/renderer/Renderer.cpp \
     ../graphics/BlendState.cpp \
     ../graphics/Buffer.cpp \
+    ../graphics/CommandCapture.cpp \
     ../graphics/DepthStencilState.cpp \
     ../graphics/Graphics.cpp \
     ../graphics/RenderDevice.cpp \
+    ../graphics/RenderGraph.cpp \
     ../graphics/RenderTarget.cpp \
     ../graphics/Shader.cpp \
     ../graphics/Texture.cpp \
+    ../graphics/TransientGeometry.cpp \
     ../gui/BMFont.cpp \
     ../gui/TTFont.cpp \
     ../gui/Widget.cpp \
@@ -100,21 +109,28 @@ LOCAL_SRC_FILES := ../assets/BmfLoader.cpp \
     ../network/Network.cpp \
     ../network/Server.cpp \
     ../scene/Actor.cpp \
+    ../scene/AnimationSystem.cpp \
     ../scene/Animator.cpp \
     ../scene/Animators.cpp \
     ../scene/Camera.cpp \
     ../scene/Component.cpp \
+    ../scene/Easing.cpp \
     ../scene/Layer.cpp \
+    ../scene/InstanceBatcher.cpp \
     ../scene/Light.cpp \
     ../scene/ParticleSystem.cpp \
+    ../scene/Prefab.cpp \
     ../scene/Scene.cpp \
     ../scene/SceneManager.cpp \
+    ../scene/SkinningSystem.cpp \
     ../scene/ShapeRenderer.cpp \
     ../scene/SkinnedMeshRenderer.cpp \
     ../scene/SpriteRenderer.cpp \
     ../scene/StaticMeshRenderer.cpp \
     ../scene/TextRenderer.cpp \
+    ../scene/TransformInterpolator.cpp \
     ../storage/FileSystem.cpp \
+    ../thread/JobSystem.cpp \
     ../utils/Log.cpp
 
 include $(BUILD_STATIC_LIBRARY)
@@ -1,158 +1,114 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include <stdexcept>
-#include <string>
-#include <string_view>
+#include <utility>
 #include "Localization.hpp"
+#include "../formats/Mo.hpp"
+#include "../storage/FileSystem.hpp"
 
 namespace ouzel
 {
-    Language::Language(const std::vector<std::byte>& data)
+    namespace
     {
-        if (data.size() < 5 * sizeof(std::uint32_t))
-            throw std::runtime_error("Not enough data");
-
-        const auto magic = static_cast<std::uint32_t>(data[0]) |
-            (static_cast<std::uint32_t>(data[1]) << 8) |
-            (static_cast<std::uint32_t>(data[2]) << 16) |
-            (static_cast<std::uint32_t>(data[3]) << 24);
-
-        const auto decodeUInt32 = [magic]() -> std::function<std::uint32_t(const std::byte*)> {
-            constexpr std::uint32_t magicBig = 0xDE120495U;
-            constexpr std::uint32_t magicLittle = 0x950412DEU;
-
-            if (magic == magicBig)
-                return [](const std::byte* bytes) noexcept {
-                    return static_cast<std::uint32_t>(bytes[3]) |
-                        (static_cast<std::uint32_t>(bytes[2]) << 8) |
-                        (static_cast<std::uint32_t>(bytes[1]) << 16) |
-                        (static_cast<std::uint32_t>(bytes[0]) << 24);
-                };
-            else if (magic == magicLittle)
-                return [](const std::byte* bytes) noexcept {
-                    return static_cast<std::uint32_t>(bytes[0]) |
-                        (static_cast<std::uint32_t>(bytes[1]) << 8) |
-                        (static_cast<std::uint32_t>(bytes[2]) << 16) |
-                        (static_cast<std::uint32_t>(bytes[3]) << 24);
-                };
-            else
-                throw std::runtime_error("Wrong magic " + std::to_string(magic));
-        }();
-
-        const std::uint32_t revisionOffset = sizeof(magic);
-        const std::uint32_t revision = decodeUInt32(data.data() + revisionOffset);
-
-        if (revision != 0)
-            throw std::runtime_error("Unsupported revision " + std::to_string(revision));
-
-        const std::uint32_t stringCountOffset = revisionOffset + sizeof(revision);
-        const std::uint32_t stringCount = decodeUInt32(data.data() + stringCountOffset);
-
-        struct TranslationInfo final
+        std::vector<std::byte> compileStringTable(const std::vector<std::byte>& data)
         {
-            std::uint32_t stringLength = 0;
-            std::uint32_t stringOffset = 0;
+            if (cooked::isCooked(data.data(), data.size()))
+                return data;
 
-            std::uint32_t translationLength = 0;
-            std::uint32_t translationOffset = 0;
-        };
-        std::vector<TranslationInfo> translations(stringCount);
+            const mo::Document document(data.data(), data.size());
 
-        const std::uint32_t stringsOffsetOffset = stringCountOffset + sizeof(stringCount);
-        const std::uint32_t stringsOffset = decodeUInt32(data.data() + stringsOffsetOffset);
+            std::vector<std::pair<std::uint64_t, std::string_view>> strings;
+            strings.reserve(document.getTranslations().size());
 
-        const std::uint32_t translationsOffsetOffset = stringsOffsetOffset + sizeof(stringsOffset);
-        const std::uint32_t translationsOffset = decodeUInt32(data.data() + translationsOffsetOffset);
+            for (const auto& translation : document.getTranslations())
+                if (!translation.original.empty()) // skip the header entry
+                    strings.emplace_back(stringKey(translation.original), translation.translation);
 
-        if (data.size() < stringsOffset + 2 * sizeof(std::uint32_t) * stringCount)
-            throw std::runtime_error("Not enough data");
-
-        std::uint32_t stringOffset = stringsOffset;
-        for (std::uint32_t i = 0; i < stringCount; ++i)
-        {
-            translations[i].stringLength = decodeUInt32(data.data() + stringOffset);
-            stringOffset += sizeof(translations[i].stringLength);
-
-            translations[i].stringOffset = decodeUInt32(data.data() + stringOffset);
-            stringOffset += sizeof(translations[i].stringOffset);
+            return cooked::writeStringTable(std::move(strings));
         }
+    }
 
-        if (data.size() < translationsOffset + 2 * sizeof(std::uint32_t) * stringCount)
-            throw std::runtime_error("Not enough data");
+    Language::Language(const std::vector<std::byte>& data):
+        Language(storage::MappedFile(compileStringTable(data)))
+    {
+    }
 
-        std::uint32_t translationOffset = translationsOffset;
-        for (std::uint32_t i = 0; i < stringCount; ++i)
-        {
-            translations[i].translationLength = decodeUInt32(data.data() + translationOffset);
-            translationOffset += sizeof(translations[i].translationLength);
+    Language::Language(storage::MappedFile&& initFile):
+        file(std::move(initFile))
+    {
+        cooked::Reader reader(file.getData(), file.getSize());
 
-            translations[i].translationOffset = decodeUInt32(data.data() + translationOffset);
-            translationOffset += sizeof(translations[i].translationOffset);
-        }
+        if (reader.getAssetType() != cooked::AssetType::stringTable)
+            throw std::runtime_error("Not a string table");
 
-        for (std::uint32_t i = 0; i < stringCount; ++i)
-        {
-            if (data.size() < translations[i].stringOffset + translations[i].stringLength ||
-                data.size() < translations[i].translationOffset + translations[i].translationLength)
-                throw std::runtime_error("Not enough data");
+        const auto keyChunk = reader.next(cooked::ChunkType::stringKeys);
+        count = keyChunk.getSize() / sizeof(std::uint64_t);
+        keys = keyChunk.getArray<std::uint64_t>(count);
 
-            const std::string str(reinterpret_cast<const char*>(data.data() + translations[i].stringOffset),
-                                  translations[i].stringLength);
-            const std::string_view translation(reinterpret_cast<const char*>(data.data() + translations[i].translationOffset),
-                                               translations[i].translationLength);
+        const auto entryChunk = reader.next(cooked::ChunkType::stringEntries);
+        entries = entryChunk.getArray<cooked::StringEntry>(count);
 
-            strings[str] = translation;
-        }
+        strings = reader.next(cooked::ChunkType::strings).getString();
     }
 
-    std::string Language::getString(const std::string& str) const
+    std::string_view Language::getString(std::uint64_t key, std::string_view fallback) const noexcept
     {
-        const auto i = strings.find(str);
+        const auto end = keys + count;
+        const auto i = std::lower_bound(keys, end, key);
 
-        if (i != strings.end())
-            return i->second;
-        else
-            return str;
+        if (i == end || *i != key)
+            return fallback;
+
+        const auto& entry = entries[i - keys];
+        if (entry.offset > strings.size() || entry.length > strings.size() - entry.offset)
+            return fallback;
+
+        return strings.substr(entry.offset, entry.length);
     }
 
     void Localization::addLanguage(const std::string& name, const std::vector<std::byte>& data)
     {
-        const auto i = languages.find(name);
+        removeLanguage(name);
+        languages.insert(std::pair(name, Language(data)));
+    }
 
-        if (i != languages.end())
-            i->second = Language(data);
-        else
-            languages.insert(std::pair(name, Language(data)));
+    void Localization::addLanguage(const std::string& name, const storage::Path& filename)
+    {
+        removeLanguage(name);
+        languageFiles.insert(std::pair(name, filename));
     }
 
     void Localization::removeLanguage(const std::string& name)
     {
-        const auto i = languages.find(name);
-
-        if (i != languages.end())
+        if (name == currentName)
         {
-            if (currentLanguage == i)
-                currentLanguage = languages.end();
-
-            languages.erase(i);
+            currentName.clear();
+            currentLanguage = nullptr;
+            mappedLanguage = Language();
         }
+
+        languages.erase(name);
+        languageFiles.erase(name);
     }
 
     void Localization::setLanguage(const std::string& name)
     {
-        const auto i = languages.find(name);
-
-        if (i != languages.end())
-            currentLanguage = i;
+        // unmap the previous language before mapping the next one
+        currentName.clear();
+        currentLanguage = nullptr;
+        mappedLanguage = Language();
+
+        if (const auto i = languages.find(name); i != languages.end())
+            currentLanguage = &i->second;
+        else if (const auto file = languageFiles.find(name); file != languageFiles.end())
+        {
+            mappedLanguage = Language(fileSystem.mapFile(file->second));
+            currentLanguage = &mappedLanguage;
+        }
         else
-            currentLanguage = languages.end();
-    }
+            return;
 
-    std::string Localization::getString(const std::string& str) const
-    {
-        if (currentLanguage != languages.end())
-            return currentLanguage->second.getString(str);
-        else
-            return str;
+        currentName = name;
     }
 }
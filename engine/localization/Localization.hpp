@@ -3,36 +3,89 @@
 #ifndef OUZEL_LOCALIZATION_LOCALIZATION_HPP
 #define OUZEL_LOCALIZATION_LOCALIZATION_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "../formats/Cooked.hpp"
+#include "../hash/Fnv1.hpp"
+#include "../storage/MappedFile.hpp"
+#include "../storage/Path.hpp"
+
+namespace ouzel::storage
+{
+    class FileSystem;
+}
 
 namespace ouzel
 {
+    // Strings are looked up by the 64-bit FNV-1 hash of the original string
+    constexpr std::uint64_t stringKey(const std::string_view str) noexcept
+    {
+        return hash::fnv1::hash<std::uint64_t>(str);
+    }
+
+    // String table compiled by the ouzel tool, gettext .mo files are compiled when loaded
     class Language final
     {
     public:
         Language() = default;
         explicit Language(const std::vector<std::byte>& data);
+        explicit Language(storage::MappedFile&& initFile);
 
-        std::string getString(const std::string& str) const;
+        // Returns the fallback itself if there is no translation, so then the result is valid only as long as the argument
+        // A translation points into the string table and stays valid until the language is destroyed or assigned to
+        std::string_view getString(std::uint64_t key, std::string_view fallback) const noexcept;
+        std::string_view getString(std::string_view str) const noexcept
+        {
+            return getString(stringKey(str), str);
+        }
+
+        auto getStringCount() const noexcept { return count; }
 
     private:
-        std::map<std::string, std::string> strings;
+        storage::MappedFile file;
+        const std::uint64_t* keys = nullptr;
+        const cooked::StringEntry* entries = nullptr;
+        std::string_view strings;
+        std::size_t count = 0;
     };
 
     class Localization final
     {
     public:
+        explicit Localization(storage::FileSystem& initFileSystem) noexcept:
+            fileSystem(initFileSystem)
+        {
+        }
+
         void addLanguage(const std::string& name, const std::vector<std::byte>& data);
+        // The file is mapped only while the language is the current one
+        void addLanguage(const std::string& name, const storage::Path& filename);
         void removeLanguage(const std::string& name);
         void setLanguage(const std::string& name);
-        std::string getString(const std::string& str) const;
+
+        // A translation stays valid until the next setLanguage call or until its language is removed or added again,
+        // the fallback is returned if there is no translation or language, so then the result lives as long as the argument
+        std::string_view getString(std::uint64_t key, std::string_view fallback) const noexcept
+        {
+            return currentLanguage ? currentLanguage->getString(key, fallback) : fallback;
+        }
+
+        std::string_view getString(std::string_view str) const noexcept
+        {
+            return getString(stringKey(str), str);
+        }
 
     private:
+        storage::FileSystem& fileSystem;
         std::map<std::string, Language> languages;
-        std::map<std::string, Language>::const_iterator currentLanguage = languages.end();
+        std::map<std::string, storage::Path> languageFiles;
+        std::string currentName;
+        Language mappedLanguage;
+        const Language* currentLanguage = nullptr;
     };
 }
 
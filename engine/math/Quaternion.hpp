@@ -170,7 +170,7 @@ namespace ouzel
 
         constexpr void invert() noexcept
         {
-            constexpr T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3]; // norm squared
+            const T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3]; // norm squared
             if (squared <= std::numeric_limits<T>::min())
                 return;
 
@@ -184,7 +184,7 @@ namespace ouzel
 
         auto getNorm() const noexcept
         {
-            constexpr T n = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
+            const T n = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
             if (n == T(1)) // already normalized
                 return T(1);
 
@@ -193,7 +193,7 @@ namespace ouzel
 
         void normalize() noexcept
         {
-            constexpr T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
+            const T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
             if (squared == T(1)) // already normalized
                 return;
 
@@ -210,7 +210,7 @@ namespace ouzel
 
         Quaternion normalized() const noexcept
         {
-            constexpr T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
+            const T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
             if (squared == T(1)) // already normalized
                 return *this;
 
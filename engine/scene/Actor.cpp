@@ -7,6 +7,8 @@
 #include "Layer.hpp"
 #include "Camera.hpp"
 #include "Component.hpp"
+#include "TransformInterpolator.hpp"
+#include "../core/Engine.hpp"
 #include "../math/MathUtils.hpp"
 
 namespace ouzel::scene
@@ -243,6 +245,8 @@ namespace ouzel::scene
 
         for (const auto component : components)
             component->setActor(nullptr);
+
+        if (transformInterpolator) transformInterpolator->removeActor(*this);
     }
 
     void Actor::visit(std::vector<Actor*>& drawQueue,
@@ -284,9 +288,11 @@ namespace ouzel::scene
         if (transformDirty)
             calculateTransform();
 
+        const auto& drawTransform = transformInterpolator ? transformInterpolator->getTransform(*this) : transform;
+
         for (const auto component : components)
             if (!component->isHidden())
-                component->draw(transform,
+                component->draw(drawTransform,
                                 opacity,
                                 camera->getRenderViewProjection(),
                                 wireframe);
@@ -299,6 +305,14 @@ namespace ouzel::scene
         actor.updateTransform(getTransform());
     }
 
+    void Actor::setInterpolated(bool newInterpolated)
+    {
+        if (newInterpolated)
+            engine->getSceneManager().getTransformInterpolator().addActor(*this);
+        else if (transformInterpolator)
+            transformInterpolator->removeActor(*this);
+    }
+
     void Actor::setPosition(const Vector2F& newPosition)
     {
         position.v[0] = newPosition.v[0];
@@ -356,6 +370,15 @@ namespace ouzel::scene
         updateLocalTransform();
     }
 
+    void Actor::setTransform(const Vector3F& newPosition, const QuaternionF& newRotation, const Vector3F& newScale)
+    {
+        position = newPosition;
+        rotation = newRotation;
+        scale = newScale;
+
+        updateLocalTransform();
+    }
+
     void Actor::setOpacity(float newOpacity)
     {
         opacity = std::clamp(newOpacity, 0.0F, 1.0F);
@@ -434,11 +457,12 @@ namespace ouzel::scene
 
     Vector3F Actor::getWorldPosition() const
     {
-        auto result = position;
+        // the transform already contains the actor's own position
+        Vector3F result;
         const auto& currentTransform = getTransform();
         currentTransform.transformPoint(result);
 
-        return position;
+        return result;
     }
 
     Vector3F Actor::convertWorldToLocal(const Vector3F& worldPosition) const
@@ -18,6 +18,7 @@ namespace ouzel::scene
     class Camera;
     class Component;
     class Layer;
+    class TransformInterpolator;
 
     class ActorContainer
     {
@@ -64,6 +65,7 @@ namespace ouzel::scene
     {
         friend ActorContainer;
         friend Layer;
+        friend TransformInterpolator;
     public:
         using Order = std::int32_t;
 
@@ -94,6 +96,9 @@ namespace ouzel::scene
         virtual void setScale(const Vector2F& newScale);
         virtual void setScale(const Vector3F& newScale);
 
+        // Sets the position, rotation and scale with a single update of the local transform
+        virtual void setTransform(const Vector3F& newPosition, const QuaternionF& newRotation, const Vector3F& newScale);
+
         virtual float getOpacity() const noexcept { return opacity; }
         virtual void setOpacity(float newOpacity);
 
@@ -157,6 +162,13 @@ namespace ouzel::scene
 
         Box3F getBoundingBox() const;
 
+        // Draws the actor between its transforms of the last two fixed updates
+        auto isInterpolated() const noexcept { return transformInterpolator != nullptr; }
+        void setInterpolated(bool newInterpolated);
+
+        // Draws the actor at its current transform until the next fixed update, e.g. after teleporting it
+        void resetInterpolation() noexcept { previousTransformStored = false; }
+
     protected:
         void setLayer(Layer* newLayer) override;
 
@@ -199,6 +211,12 @@ namespace ouzel::scene
         std::vector<std::unique_ptr<Component>> ownedComponents;
 
         EventHandler animationUpdateHandler;
+
+        TransformInterpolator* transformInterpolator = nullptr;
+        std::size_t interpolatorIndex = 0;
+        Matrix4F previousTransform;
+        bool previousTransformStored = false;
+        mutable Matrix4F interpolatedTransform;
     };
 }
 
@@ -0,0 +1,296 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include "AnimationSystem.hpp"
+#include "Actor.hpp"
+#include "Animator.hpp"
+#include "../core/Engine.hpp"
+#include "../hash/Fnv1.hpp"
+#include "../math/MathUtils.hpp"
+
+namespace ouzel::scene
+{
+    namespace
+    {
+        float shakeNoise(std::uint32_t seed, std::uint64_t x, float distance)
+        {
+            return (2.0F * (static_cast<float>(hash::fnv1::hash<std::uint32_t>(seed | (x << 32))) / std::numeric_limits<std::uint32_t>::max()) - 1.0F) * distance;
+        }
+
+        Vector3F getShakeOffset(const AnimationSystem::Track& track,
+                                const AnimationSystem::ShakeParameters& parameters)
+        {
+            const float x = parameters.length * track.progress * parameters.timeScale;
+
+            const auto x1 = static_cast<std::uint64_t>(x);
+            const auto x2 = x1 + 1;
+            const auto t = x - static_cast<float>(x1);
+
+            Vector3F result;
+
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                const float previous = (x1 != 0) ? shakeNoise(parameters.seeds[i], x1, track.diff.v[i]) : 0.0F;
+                const float next = (x2 != static_cast<std::uint32_t>(parameters.timeScale)) ? shakeNoise(parameters.seeds[i], x2, track.diff.v[i]) : 0.0F;
+
+                result.v[i] = smoothStep(previous, next, t);
+            }
+
+            return result;
+        }
+    }
+
+    AnimationSystem::AnimationSystem()
+    {
+        updateHandler.updateHandler = [this](const UpdateEvent& event) {
+            update(event.delta);
+            return false;
+        };
+    }
+
+    AnimationSystem::~AnimationSystem()
+    {
+        for (Animator* animator : animators)
+            if (animator)
+            {
+                animator->updateIndex = invalidIndex;
+                animator->animationSystem = nullptr;
+            }
+
+        for (const auto& typeTracks : tracks)
+            for (const auto& track : typeTracks)
+                if (track.owner) track.owner->animationSystem = nullptr;
+    }
+
+    void AnimationSystem::addAnimator(Animator& animator)
+    {
+        if (animator.updateIndex != invalidIndex) return;
+
+        // does nothing if the handler is already added
+        engine->getEventDispatcher().addEventHandler(updateHandler);
+
+        animator.animationSystem = this;
+        animator.updateIndex = static_cast<std::uint32_t>(animators.size());
+        animators.push_back(&animator);
+    }
+
+    void AnimationSystem::removeAnimator(Animator& animator)
+    {
+        if (animator.updateIndex == invalidIndex) return;
+
+        // the slot is reused after the update, because this can be called while iterating the animators
+        animators[animator.updateIndex] = nullptr;
+        animator.updateIndex = invalidIndex;
+        ++removedAnimatorCount;
+    }
+
+    std::uint32_t AnimationSystem::addTrack(TrackType type, Animator& owner)
+    {
+        const auto typeIndex = static_cast<std::size_t>(type);
+        auto& typeTracks = tracks[typeIndex];
+        auto& typeFreeTracks = freeTracks[typeIndex];
+
+        std::uint32_t index;
+
+        if (typeFreeTracks.empty())
+        {
+            index = static_cast<std::uint32_t>(typeTracks.size());
+            typeTracks.emplace_back();
+            if (type == TrackType::shake) shakeParameters.emplace_back();
+        }
+        else
+        {
+            index = typeFreeTracks.back();
+            typeFreeTracks.pop_back();
+            typeTracks[index] = Track{};
+            if (type == TrackType::shake) shakeParameters[index] = ShakeParameters{};
+        }
+
+        typeTracks[index].owner = &owner;
+        owner.animationSystem = this;
+
+        return index;
+    }
+
+    void AnimationSystem::removeTrack(TrackType type, std::uint32_t index)
+    {
+        const auto typeIndex = static_cast<std::size_t>(type);
+        auto& track = tracks[typeIndex][index];
+
+        // the track can still be in the dirty list, it is skipped there because it has no actor
+        track.owner = nullptr;
+        track.actor = nullptr;
+        freeTracks[typeIndex].push_back(index);
+    }
+
+    void AnimationSystem::setProgress(TrackType type, std::uint32_t index, float progress)
+    {
+        auto& track = getTrack(type, index);
+        track.progress = progress;
+        track.eased = false;
+        markDirty(type, index, track);
+    }
+
+    void AnimationSystem::setProgress(TrackType type, std::uint32_t index, float progress,
+                                      EaseMode easeMode, EaseFunc easeFunc)
+    {
+        auto& track = getTrack(type, index);
+        track.progress = progress;
+        track.easeMode = easeMode;
+        track.easeFunc = easeFunc;
+        track.eased = true;
+        markDirty(type, index, track);
+    }
+
+    void AnimationSystem::flush()
+    {
+        if (dirtyTrackCount == 0) return;
+
+        // group the eased tracks by the curve, so that every curve is evaluated in one batch
+        for (std::size_t type = 0; type < trackTypeCount; ++type)
+            for (const auto index : dirtyTracks[type])
+            {
+                auto& track = tracks[type][index];
+                if (track.dirty && track.eased && track.actor)
+                {
+                    auto& batch = easeBatches[static_cast<std::size_t>(track.easeMode) * easeFuncCount +
+                                              static_cast<std::size_t>(track.easeFunc)];
+                    batch.values.push_back(track.progress);
+                    batch.targets.push_back(&track.progress);
+                }
+            }
+
+        for (std::size_t i = 0; i < easeBatches.size(); ++i)
+        {
+            auto& batch = easeBatches[i];
+            if (batch.values.empty()) continue;
+
+            ease(static_cast<EaseMode>(i / easeFuncCount),
+                 static_cast<EaseFunc>(i % easeFuncCount),
+                 batch.values.data(), batch.values.size());
+
+            for (std::size_t j = 0; j < batch.values.size(); ++j)
+                *batch.targets[j] = batch.values[j];
+
+            batch.values.clear();
+            batch.targets.clear();
+        }
+
+        // shake tracks are evaluated after the position tracks, so that they override them
+        for (std::size_t type = 0; type < trackTypeCount; ++type)
+        {
+            for (const auto index : dirtyTracks[type])
+            {
+                auto& track = tracks[type][index];
+                if (!track.dirty) continue; // listed more than once
+                track.dirty = false;
+
+                if (!track.actor) continue;
+
+                auto& state = getActorState(*track.actor);
+
+                switch (static_cast<TrackType>(type))
+                {
+                    case TrackType::opacity:
+                        state.opacity = track.start.v[0] + track.diff.v[0] * track.progress;
+                        state.opacityChanged = true;
+                        break;
+                    case TrackType::position:
+                        state.position = track.start + track.diff * track.progress;
+                        state.transformChanged = true;
+                        break;
+                    case TrackType::rotation:
+                        state.rotation.setEulerAngles(track.start + track.diff * track.progress);
+                        state.transformChanged = true;
+                        break;
+                    case TrackType::scale:
+                        state.scale = track.start + track.diff * track.progress;
+                        state.transformChanged = true;
+                        break;
+                    case TrackType::shake:
+                        state.position = track.start + getShakeOffset(track, shakeParameters[index]);
+                        state.transformChanged = true;
+                        break;
+                    default:
+                        throw std::runtime_error("Invalid track type");
+                }
+            }
+
+            dirtyTracks[type].clear();
+        }
+
+        dirtyTrackCount = 0;
+
+        for (const auto& state : actorStates)
+        {
+            if (state.transformChanged)
+                state.actor->setTransform(state.position, state.rotation, state.scale);
+
+            if (state.opacityChanged)
+                state.actor->setOpacity(state.opacity);
+        }
+
+        actorStates.clear();
+        actorStateIndices.clear();
+    }
+
+    void AnimationSystem::update(float delta)
+    {
+        // the animators that are started during the update are updated from the next frame
+        const auto count = animators.size();
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Animator* animator = animators[i];
+            if (!animator) continue;
+
+            if (animator->isRunning())
+                animator->update(delta);
+            else
+                removeAnimator(*animator);
+        }
+
+        if (removedAnimatorCount)
+        {
+            std::size_t size = 0;
+
+            for (Animator* animator : animators)
+                if (animator)
+                {
+                    animator->updateIndex = static_cast<std::uint32_t>(size);
+                    animators[size++] = animator;
+                }
+
+            animators.resize(size);
+            removedAnimatorCount = 0;
+        }
+
+        flush();
+    }
+
+    void AnimationSystem::markDirty(TrackType type, std::uint32_t index, Track& track)
+    {
+        if (track.dirty) return;
+
+        track.dirty = true;
+        dirtyTracks[static_cast<std::size_t>(type)].push_back(index);
+        ++dirtyTrackCount;
+    }
+
+    AnimationSystem::ActorState& AnimationSystem::getActorState(Actor& actor)
+    {
+        const auto [iterator, inserted] = actorStateIndices.try_emplace(&actor, actorStates.size());
+
+        if (inserted)
+        {
+            ActorState state;
+            state.actor = &actor;
+            state.position = actor.getPosition();
+            state.rotation = actor.getRotation();
+            state.scale = actor.getScale();
+            state.opacity = actor.getOpacity();
+            actorStates.push_back(state);
+        }
+
+        return actorStates[iterator->second];
+    }
+}
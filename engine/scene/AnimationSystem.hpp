@@ -0,0 +1,133 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_ANIMATIONSYSTEM_HPP
+#define OUZEL_SCENE_ANIMATIONSYSTEM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include "Easing.hpp"
+#include "../events/EventHandler.hpp"
+#include "../math/Quaternion.hpp"
+#include "../math/Vector.hpp"
+
+namespace ouzel::scene
+{
+    class Actor;
+    class Animator;
+
+    // Updates all of the started animators with a single update handler
+    // Tweens keep their state in contiguous per-type track arrays, the tracks that changed
+    // are evaluated in batches and every actor's transform is updated once per flush
+    class AnimationSystem final
+    {
+    public:
+        enum class TrackType
+        {
+            opacity,
+            position,
+            rotation,
+            scale,
+            shake,
+            count
+        };
+
+        struct Track final
+        {
+            Animator* owner = nullptr;
+            Actor* actor = nullptr;
+            Vector3F start;
+            Vector3F diff; // the distance for shake tracks
+            float progress = 0.0F;
+            EaseMode easeMode = EaseMode::easeIn;
+            EaseFunc easeFunc = EaseFunc::sine;
+            bool eased = false;
+            bool dirty = false;
+        };
+
+        struct ShakeParameters final
+        {
+            std::array<std::uint32_t, 3> seeds{};
+            float length = 0.0F;
+            float timeScale = 0.0F;
+        };
+
+        static constexpr std::uint32_t invalidIndex = std::numeric_limits<std::uint32_t>::max();
+
+        AnimationSystem();
+        ~AnimationSystem();
+
+        AnimationSystem(const AnimationSystem&) = delete;
+        AnimationSystem& operator=(const AnimationSystem&) = delete;
+
+        AnimationSystem(AnimationSystem&&) = delete;
+        AnimationSystem& operator=(AnimationSystem&&) = delete;
+
+        void addAnimator(Animator& animator);
+        void removeAnimator(Animator& animator);
+
+        std::uint32_t addTrack(TrackType type, Animator& owner);
+        void removeTrack(TrackType type, std::uint32_t index);
+
+        auto& getTrack(TrackType type, std::uint32_t index) noexcept
+        {
+            return tracks[static_cast<std::size_t>(type)][index];
+        }
+
+        auto& getShakeParameters(std::uint32_t index) noexcept
+        {
+            return shakeParameters[index];
+        }
+
+        void setProgress(TrackType type, std::uint32_t index, float progress);
+        void setProgress(TrackType type, std::uint32_t index, float progress,
+                         EaseMode easeMode, EaseFunc easeFunc);
+
+        // Writes the values of all of the changed tracks to their actors
+        void flush();
+
+    private:
+        static constexpr auto trackTypeCount = static_cast<std::size_t>(TrackType::count);
+
+        struct ActorState final
+        {
+            Actor* actor = nullptr;
+            Vector3F position;
+            QuaternionF rotation;
+            Vector3F scale;
+            float opacity = 0.0F;
+            bool transformChanged = false;
+            bool opacityChanged = false;
+        };
+
+        struct EaseBatch final
+        {
+            std::vector<float> values;
+            std::vector<float*> targets;
+        };
+
+        void update(float delta);
+        void markDirty(TrackType type, std::uint32_t index, Track& track);
+        ActorState& getActorState(Actor& actor);
+
+        EventHandler updateHandler;
+
+        std::vector<Animator*> animators;
+        std::size_t removedAnimatorCount = 0;
+
+        std::array<std::vector<Track>, trackTypeCount> tracks;
+        std::array<std::vector<std::uint32_t>, trackTypeCount> freeTracks;
+        std::array<std::vector<std::uint32_t>, trackTypeCount> dirtyTracks;
+        std::size_t dirtyTrackCount = 0;
+        std::vector<ShakeParameters> shakeParameters;
+
+        std::array<EaseBatch, easeModeCount * easeFuncCount> easeBatches;
+        std::vector<ActorState> actorStates;
+        std::unordered_map<Actor*, std::size_t> actorStateIndices;
+    };
+}
+
+#endif // OUZEL_SCENE_ANIMATIONSYSTEM_HPP
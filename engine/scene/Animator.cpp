@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <stdexcept>
+#include <typeinfo>
 #include "Animator.hpp"
 #include "Actor.hpp"
 #include "../core/Engine.hpp"
@@ -11,14 +13,12 @@ namespace ouzel::scene
     Animator::Animator(float initLength):
         length(initLength)
     {
-        updateHandler.updateHandler = [this](const UpdateEvent& event) {
-            update(event.delta);
-            return false;
-        };
     }
 
     Animator::~Animator()
     {
+        if (animationSystem) animationSystem->removeAnimator(*this);
+
         if (parent) parent->removeAnimator(*this);
 
         for (const auto& animator : animators)
@@ -41,10 +41,10 @@ namespace ouzel::scene
                 progress = 1.0F;
                 currentTime = length;
 
-                auto finishEvent = std::make_unique<AnimationEvent>();
-                finishEvent->type = Event::Type::animationFinish;
-                finishEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                AnimationEvent finishEvent;
+                finishEvent.type = Event::Type::animationFinish;
+                finishEvent.component = this;
+                engine->getEventDispatcher().dispatchEvent(finishEvent);
             }
             else
             {
@@ -54,19 +54,17 @@ namespace ouzel::scene
 
             updateProgress();
         }
-        else
-            updateHandler.remove();
     }
 
     void Animator::start()
     {
-        engine->getEventDispatcher().addEventHandler(updateHandler);
+        getAnimationSystem().addAnimator(*this);
         play();
 
-        auto startEvent = std::make_unique<AnimationEvent>();
-        startEvent->type = Event::Type::animationStart;
-        startEvent->component = this;
-        engine->getEventDispatcher().dispatchEvent(std::move(startEvent));
+        AnimationEvent startEvent;
+        startEvent.type = Event::Type::animationStart;
+        startEvent.component = this;
+        engine->getEventDispatcher().dispatchEvent(startEvent);
     }
 
     void Animator::play()
@@ -110,6 +108,42 @@ namespace ouzel::scene
         }
     }
 
+    std::unique_ptr<Animator> Animator::clone() const
+    {
+        if (typeid(*this) != typeid(Animator))
+            throw std::runtime_error("Animator does not support cloning");
+
+        auto result = std::make_unique<Animator>(length);
+        for (auto& animator : cloneAnimators())
+            result->addAnimator(std::move(animator));
+        return result;
+    }
+
+    void Animator::recycle()
+    {
+        if (animationSystem) animationSystem->removeAnimator(*this);
+
+        done = false;
+        running = false;
+        progress = 0.0F;
+        currentTime = 0.0F;
+        targetActor = nullptr;
+
+        for (const auto& animator : animators)
+            animator->recycle();
+    }
+
+    std::vector<std::unique_ptr<Animator>> Animator::cloneAnimators() const
+    {
+        std::vector<std::unique_ptr<Animator>> result;
+        result.reserve(animators.size());
+
+        for (const auto& animator : animators)
+            result.push_back(animator->clone());
+
+        return result;
+    }
+
     void Animator::setProgress(float newProgress)
     {
         progress = newProgress;
@@ -118,6 +152,14 @@ namespace ouzel::scene
         updateProgress();
     }
 
+    AnimationSystem& Animator::getAnimationSystem()
+    {
+        if (!animationSystem)
+            animationSystem = &engine->getSceneManager().getAnimationSystem();
+
+        return *animationSystem;
+    }
+
     void Animator::addAnimator(std::unique_ptr<Animator> animator)
     {
         addAnimator(*animator);
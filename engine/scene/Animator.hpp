@@ -3,16 +3,18 @@
 #ifndef OUZEL_SCENE_ANIMATOR_HPP
 #define OUZEL_SCENE_ANIMATOR_HPP
 
+#include <cstdint>
 #include <memory>
 #include <vector>
+#include "AnimationSystem.hpp"
 #include "Component.hpp"
-#include "../events/EventHandler.hpp"
 
 namespace ouzel::scene
 {
     class Animator: public Component
     {
         friend Actor;
+        friend AnimationSystem;
     public:
         explicit Animator(float initLength);
         ~Animator() override;
@@ -26,6 +28,13 @@ namespace ouzel::scene
         virtual void stop(bool resetAnimation = false);
         virtual void reset();
 
+        // Creates an animator with the same parameters and clones of the child animators
+        // Throws an exception for the subclasses that don't override it
+        virtual std::unique_ptr<Animator> clone() const;
+
+        // Stops the animator and returns it to the state after construction without touching the target actor
+        virtual void recycle();
+
         auto isRunning() const noexcept { return running; }
         auto isDone() const noexcept { return done; }
 
@@ -35,6 +44,9 @@ namespace ouzel::scene
         auto getProgress() const noexcept { return progress; }
         virtual void setProgress(float newProgress);
 
+        // Lets the animator apply the easing curve itself, returns false if it can't
+        virtual bool setEasedProgress(float, EaseMode, EaseFunc) { return false; }
+
         auto getTargetActor() const noexcept { return targetActor; }
 
         void addAnimator(std::unique_ptr<Animator> animator);
@@ -48,6 +60,10 @@ namespace ouzel::scene
     protected:
         virtual void updateProgress() {}
 
+        std::vector<std::unique_ptr<Animator>> cloneAnimators() const;
+
+        AnimationSystem& getAnimationSystem();
+
         float length = 0.0F;
         float currentTime = 0.0F;
         float progress = 0.0F;
@@ -57,7 +73,8 @@ namespace ouzel::scene
         Animator* parent = nullptr;
         Actor* targetActor = nullptr;
 
-        EventHandler updateHandler;
+        AnimationSystem* animationSystem = nullptr;
+        std::uint32_t updateIndex = AnimationSystem::invalidIndex;
 
         std::vector<Animator*> animators;
         std::vector<std::unique_ptr<Animator>> ownedAnimators;
@@ -5,336 +5,150 @@
 #include "Animators.hpp"
 #include "Actor.hpp"
 #include "../core/Engine.hpp"
-#include "../hash/Fnv1.hpp"
 #include "../utils/Utils.hpp"
 
 namespace ouzel::scene
 {
-    namespace
+    Ease::Ease(Animator& animator, Mode initMode, Func initFunc):
+        Animator(animator.getLength()), mode(initMode), func(initFunc)
     {
-        float sineIn(const float t)
-        {
-            return 1.0F - std::cos(t * pi<float> / 2.0F);
-        }
-
-        float sineOut(const float t)
-        {
-            return std::sin(t * pi<float> / 2.0F);
-        }
-
-        float sineInOut(const float t)
-        {
-            return -0.5F * (std::cos(pi<float> * t) - 1.0F);
-        }
-
-        constexpr float quadIn(const float t)
-        {
-            return t * t;
-        }
-
-        constexpr float quadOut(const float t)
-        {
-            return t * (2.0F - t);
-        }
-
-        constexpr float quadInOut(const float t)
-        {
-            return (t < 0.5F) ?
-                2.0F * t * t :
-                -1.0F + (4.0F - 2.0F * t) * t;
-        }
-
-        constexpr float cubicIn(const float t)
-        {
-            return t * t * t;
-        }
-
-        constexpr float cubicOut(const float t)
-        {
-            return (t - 1.0F) * (t - 1.0F) * (t - 1.0F) + 1.0F;
-        }
-
-        constexpr float cubicInOut(const float t)
-        {
-            return (t < 0.5F) ?
-                4.0F * t * t * t :
-                (t - 1.0F) * (2.0F * t - 2.0F) * (2.0F * t - 2.0F) + 1.0F;
-        }
-
-        constexpr float quartIn(const float t)
-        {
-            return t * t * t * t;
-        }
-
-        constexpr float quartOut(const float t)
-        {
-            return 1.0F - (t - 1.0F) * (t - 1.0F) * (t - 1.0F);
-        }
-
-        constexpr float quartInOut(const float t)
-        {
-            return (t < 0.5F) ?
-                8.0F * t * t * t * t :
-                1.0F - 8.0F * (t - 1.0F) * (t - 1.0F) * (t - 1.0F) * (t - 1.0F);
-        }
-
-        constexpr float quintIn(const float t)
-        {
-            return t * t * t * t * t;
-        }
-
-        constexpr float quintOut(const float t)
-        {
-            return 1.0F + (t - 1.0F) * (t - 1.0F) * (t - 1.0F) * (t - 1.0F) * (t - 1.0F);
-        }
-
-        constexpr float quintInOut(const float t)
-        {
-            return (t < 0.5F) ?
-                16.0F * t * t * t * t * t :
-                1.0F + 16.0F * (t - 1.0F) * (t - 1.0F) * (t - 1.0F) * (t - 1.0F) * (t - 1.0F);
-        }
-
-        float expoIn(const float t)
-        {
-            return std::pow(2.0F, 10.0F * (t - 1.0F));
-        }
-
-        float expoOut(const float t)
-        {
-            return 1.0F - std::pow(2.0F, -10.0F * t);
-        }
-
-        float expoInOut(const float t)
-        {
-            return (t < 0.5F) ?
-                0.5F * std::pow(2.0F, 10.0F * (2.0F * t - 1.0F)) :
-                0.5F * (std::pow(2.0F, -10.0F * (t * 2.0F - 1.0F)) - 2.0F);
-        }
-
-        float circIn(const float t)
-        {
-            return 1.0F - std::sqrt(1.0F - t * t);
-        }
-
-        float circOut(const float t)
-        {
-            return std::sqrt(1.0F - (t - 1.0F) * (t - 1.0F));
-        }
-
-        float circInOut(const float t)
-        {
-            return (t < 0.5F) ?
-                0.5F * (-std::sqrt(1.0F - (t * 2.0F) * (t * 2.0F)) + 1.0F) :
-                0.5F * (std::sqrt(1.0F - (t * 2.0F - 2.0F) * (t * 2.0F - 2.0F)) + 1.0F);
-        }
-
-        float backIn(const float t)
-        {
-            static constexpr float s = 1.70158F;
-            return t * t * ((s + 1.0F) * t - s);
-        }
-
-        float backOut(const float t)
-        {
-            static constexpr float s = 1.70158F;
-            return (t - 1.0F) * (t - 1.0F) * ((s + 1.0F) * (t - 1.0F) + s) + 1.0F;
-        }
-
-        float backInOut(const float t)
-        {
-            static constexpr float s = 1.70158F * 1.525F;
-            return (t < 0.5F) ?
-                0.5F * ((t * 2.0F) * (t * 2.0F) * ((s + 1.0F) * (t * 2.0F) - s)):
-                0.5F * ((t * 2.0F - 2.0F) * (t * 2.0F - 2.0F) * ((s + 1.0F) * (t * 2.0F - 2.0F) + s) + 2.0F);
-        }
-
-        float elasticIn(const float t)
-        {
-            if (t == 0.0F) return 0.0F;
-            if (t == 1.0F) return 1.0F;
+        addAnimator(animator);
+    }
 
-            static constexpr float p = 0.3F;
+    std::unique_ptr<Animator> Ease::clone() const
+    {
+        assert(!animators.empty());
 
-            return -std::pow(2.0F, 10.0F * (t - 1.0F)) * std::sin(((t - 1.0F) - p / 4.0F) * (2.0F * pi<float>) / p);
-        }
+        auto animator = animators.front()->clone();
+        auto result = std::make_unique<Ease>(*animator, mode, func);
+        result->ownedAnimators.push_back(std::move(animator));
+        return result;
+    }
 
-        float elasticOut(const float t)
-        {
-            if (t == 0.0F) return 0.0F;
-            if (t == 1.0F) return 1.0F;
+    void Ease::updateProgress()
+    {
+        Animator::updateProgress();
 
-            static constexpr float p = 0.3F;
+        if (animators.empty()) return;
 
-            return std::pow(2.0F, -10.0F * t) * std::sin((t - p / 4.0F) * (2.0F * pi<float>) / p) + 1.0F;
-        }
+        // tweens evaluate the curve in a batch together with the other tweens
+        if (!animators.front()->setEasedProgress(progress, mode, func))
+            animators.front()->setProgress(ease(mode, func, progress));
+    }
 
-        float elasticInOut(const float t)
-        {
-            if (t == 0.0F) return 0.0F;
-            if (t == 1.0F) return 1.0F;
+    Tween::Tween(float initLength, AnimationSystem::TrackType initTrackType):
+        Animator(initLength), trackType(initTrackType)
+    {
+    }
 
-            static constexpr float p = 0.3F * 1.5F;
+    Tween::~Tween()
+    {
+        if (animationSystem && track != AnimationSystem::invalidIndex)
+            animationSystem->removeTrack(trackType, track);
+    }
 
-            return (t < 0.5F) ?
-                -0.5F * std::pow(2.0F, 10.0F * (t * 2.0F - 1.0F)) * std::sin(((t * 2.0F - 1.0F) - p / 4.0F) * (2.0F * pi<float>) / p) :
-                0.5F * std::pow(2.0F, -10.0F * (t * 2.0F - 1.0F)) * std::sin(((t * 2.0F - 1.0F) - p / 4.0F) * (2.0F * pi<float>) / p) + 1.0F;
-        }
+    bool Tween::setEasedProgress(float newProgress, EaseMode easeMode, EaseFunc easeFunc)
+    {
+        progress = newProgress;
+        currentTime = progress * length;
 
-        float bounceOut(const float t)
-        {
-            if (t < 1.0F / 2.75F)
-                return 7.5625F * t * t;
-            else if (t < 2.0F / 2.75F)
-                return 7.5625F * (t - 1.5F / 2.75F) * (t - 1.5F / 2.75F) + 0.75F;
-            else if (t < 2.5F / 2.75F)
-                return 7.5625F * (t - 2.25F / 2.75F) * (t - 2.25F / 2.75F) + 0.9375F;
-            else
-                return 7.5625F * (t - 2.625F / 2.75F) * (t - 2.625F / 2.75F) + 0.984375F;
-        }
+        if (animationSystem && track != AnimationSystem::invalidIndex)
+            animationSystem->setProgress(trackType, track, progress, easeMode, easeFunc);
 
-        float bounceIn(const float t)
-        {
-            return 1.0F - bounceOut(1.0F - t);
-        }
-
-        float bounceInOut(const float t)
-        {
-            return (t < 0.5F) ?
-                bounceOut(t * 2.0F) * 0.5F :
-                bounceOut(t * 2.0F - 1.0F) * 0.5F + 0.5F;
-        }
+        return true;
     }
 
-    Ease::Ease(Animator& animator, Mode initMode, Func initFunc):
-        Animator(animator.getLength()), mode(initMode), func(initFunc)
+    void Tween::recycle()
     {
-        addAnimator(animator);
+        // a new track is bound on the next play, so the stale values are never written to the actor
+        if (animationSystem && track != AnimationSystem::invalidIndex)
+            animationSystem->removeTrack(trackType, track);
+        track = AnimationSystem::invalidIndex;
+
+        Animator::recycle();
     }
 
-    void Ease::updateProgress()
+    void Tween::updateProgress()
     {
         Animator::updateProgress();
 
-        if (animators.empty()) return;
+        if (animationSystem && track != AnimationSystem::invalidIndex)
+            animationSystem->setProgress(trackType, track, progress);
+    }
 
-        switch (mode)
-        {
-            case Mode::easeIn:
-            {
-                switch (func)
-                {
-                    case Func::sine: progress = sineIn(progress); break;
-                    case Func::quad: progress = quadIn(progress); break;
-                    case Func::cubic: progress = cubicIn(progress); break;
-                    case Func::quart: progress = quartIn(progress); break;
-                    case Func::quint: progress = quintIn(progress); break;
-                    case Func::expo: progress = expoIn(progress); break;
-                    case Func::circ: progress = circIn(progress); break;
-                    case Func::back: progress = backIn(progress); break;
-                    case Func::elastic: progress = elasticIn(progress); break;
-                    case Func::bounce: progress = bounceIn(progress); break;
-                    default: throw std::runtime_error("Invalid function");
-                }
-                break;
-            }
+    AnimationSystem::Track& Tween::bindTrack()
+    {
+        auto& system = getAnimationSystem();
 
-            case Mode::easeOut:
-            {
-                switch (func)
-                {
-                    case Func::sine: progress = sineOut(progress); break;
-                    case Func::quad: progress = quadOut(progress); break;
-                    case Func::cubic: progress = cubicOut(progress); break;
-                    case Func::quart: progress = quartOut(progress); break;
-                    case Func::quint: progress = quintOut(progress); break;
-                    case Func::expo: progress = expoOut(progress); break;
-                    case Func::circ: progress = circOut(progress); break;
-                    case Func::back: progress = backOut(progress); break;
-                    case Func::elastic: progress = elasticOut(progress); break;
-                    case Func::bounce: progress = bounceOut(progress); break;
-                    default: throw std::runtime_error("Invalid function");
-                }
-                break;
-            }
+        // the start values must include the values of the tweens that were updated before
+        system.flush();
 
-            case Mode::easeInOut:
-            {
-                switch (func)
-                {
-                    case Func::sine: progress = sineInOut(progress); break;
-                    case Func::quad: progress = quadInOut(progress); break;
-                    case Func::cubic: progress = cubicInOut(progress); break;
-                    case Func::quart: progress = quartInOut(progress); break;
-                    case Func::quint: progress = quintInOut(progress); break;
-                    case Func::expo: progress = expoInOut(progress); break;
-                    case Func::circ: progress = circInOut(progress); break;
-                    case Func::back: progress = backInOut(progress); break;
-                    case Func::elastic: progress = elasticInOut(progress); break;
-                    case Func::bounce: progress = bounceInOut(progress); break;
-                    default: throw std::runtime_error("Invalid function");
-                }
-                break;
-            }
+        if (track == AnimationSystem::invalidIndex)
+            track = system.addTrack(trackType, *this);
 
-            default: throw std::runtime_error("Invalid mode");
-        }
-
-        animators.front()->setProgress(progress);
+        auto& result = system.getTrack(trackType, track);
+        result.actor = targetActor;
+        return result;
     }
 
     Fade::Fade(float initLength, float initOpacity, bool initRelative):
-        Animator(initLength), opacity(initOpacity), relative(initRelative)
+        Tween(initLength, AnimationSystem::TrackType::opacity), opacity(initOpacity), relative(initRelative)
+    {
+    }
+
+    std::unique_ptr<Animator> Fade::clone() const
     {
+        auto result = std::make_unique<Fade>(length, opacity, relative);
+        for (auto& animator : cloneAnimators())
+            result->addAnimator(std::move(animator));
+        return result;
     }
 
     void Fade::play()
     {
         Animator::play();
 
+        auto& fadeTrack = bindTrack();
+
         if (targetActor)
         {
-            startOpacity = targetActor->getOpacity();
-            targetOpacity = relative ? startOpacity + opacity : opacity;
+            const float startOpacity = targetActor->getOpacity();
+            const float targetOpacity = relative ? startOpacity + opacity : opacity;
 
-            diff = targetOpacity - startOpacity;
+            fadeTrack.start.v[0] = startOpacity;
+            fadeTrack.diff.v[0] = targetOpacity - startOpacity;
         }
     }
 
-    void Fade::updateProgress()
+    Move::Move(float initLength, const Vector3F& initPosition, bool initRelative):
+        Tween(initLength, AnimationSystem::TrackType::position), position(initPosition), relative(initRelative)
     {
-        Animator::updateProgress();
-
-        if (targetActor)
-            targetActor->setOpacity(startOpacity + (diff * progress));
     }
 
-    Move::Move(float initLength, const Vector3F& initPosition, bool initRelative):
-        Animator(initLength), position(initPosition), relative(initRelative)
+    std::unique_ptr<Animator> Move::clone() const
     {
+        auto result = std::make_unique<Move>(length, position, relative);
+        for (auto& animator : cloneAnimators())
+            result->addAnimator(std::move(animator));
+        return result;
     }
 
     void Move::play()
     {
         Animator::play();
 
+        auto& moveTrack = bindTrack();
+
         if (targetActor)
         {
-            startPosition = targetActor->getPosition();
-            targetPosition = relative ? startPosition + position : position;
+            const auto startPosition = targetActor->getPosition();
+            const auto targetPosition = relative ? startPosition + position : position;
 
-            diff = targetPosition - startPosition;
+            moveTrack.start = startPosition;
+            moveTrack.diff = targetPosition - startPosition;
         }
     }
 
-    void Move::updateProgress()
-    {
-        Animator::updateProgress();
-
-        if (targetActor)
-            targetActor->setPosition(startPosition + (diff * progress));
-    }
-
     Parallel::Parallel(const std::vector<Animator*>& initAnimators):
         Animator(0.0F)
     {
@@ -363,6 +177,15 @@ namespace ouzel::scene
         }
     }
 
+    std::unique_ptr<Animator> Parallel::clone() const
+    {
+        auto clones = cloneAnimators();
+        auto result = std::make_unique<Parallel>(clones);
+        for (auto& animator : clones)
+            result->ownedAnimators.push_back(std::move(animator));
+        return result;
+    }
+
     void Parallel::updateProgress()
     {
         Animator::updateProgress();
@@ -384,6 +207,16 @@ namespace ouzel::scene
         addAnimator(animator);
     }
 
+    std::unique_ptr<Animator> Repeat::clone() const
+    {
+        assert(!animators.empty());
+
+        auto animator = animators.front()->clone();
+        auto result = std::make_unique<Repeat>(*animator, count);
+        result->ownedAnimators.push_back(std::move(animator));
+        return result;
+    }
+
     void Repeat::reset()
     {
         Animator::reset();
@@ -391,6 +224,13 @@ namespace ouzel::scene
         currentCount = 0;
     }
 
+    void Repeat::recycle()
+    {
+        Animator::recycle();
+
+        currentCount = 0;
+    }
+
     void Repeat::updateProgress()
     {
         if (animators.empty()) return;
@@ -407,10 +247,10 @@ namespace ouzel::scene
                 const float remainingTime = currentTime - animators.front()->getLength() * static_cast<float>(currentCount);
                 animators.front()->setProgress(remainingTime / animators.front()->getLength());
 
-                auto resetEvent = std::make_unique<AnimationEvent>();
-                resetEvent->type = Event::Type::animationReset;
-                resetEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(resetEvent));
+                AnimationEvent resetEvent;
+                resetEvent.type = Event::Type::animationReset;
+                resetEvent.component = this;
+                engine->getEventDispatcher().dispatchEvent(resetEvent);
             }
             else
             {
@@ -419,67 +259,72 @@ namespace ouzel::scene
                 currentTime = length;
                 progress = 1.0F;
 
-                auto finishEvent = std::make_unique<AnimationEvent>();
-                finishEvent->type = Event::Type::animationFinish;
-                finishEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                AnimationEvent finishEvent;
+                finishEvent.type = Event::Type::animationFinish;
+                finishEvent.component = this;
+                engine->getEventDispatcher().dispatchEvent(finishEvent);
             }
         }
     }
 
     Rotate::Rotate(float initLength, const Vector3F& initRotation, bool initRelative):
-        Animator(initLength), rotation(initRotation), relative(initRelative)
+        Tween(initLength, AnimationSystem::TrackType::rotation), rotation(initRotation), relative(initRelative)
     {
     }
 
+    std::unique_ptr<Animator> Rotate::clone() const
+    {
+        auto result = std::make_unique<Rotate>(length, rotation, relative);
+        for (auto& animator : cloneAnimators())
+            result->addAnimator(std::move(animator));
+        return result;
+    }
+
     void Rotate::play()
     {
         Animator::play();
 
+        auto& rotateTrack = bindTrack();
+
         if (targetActor)
         {
-            startRotation = targetActor->getRotation().getEulerAngles();
-
-            targetRotation = relative ? startRotation + rotation : rotation;
+            const auto startRotation = targetActor->getRotation().getEulerAngles();
+            const auto targetRotation = relative ? startRotation + rotation : rotation;
 
-            diff = targetRotation - startRotation;
+            rotateTrack.start = startRotation;
+            rotateTrack.diff = targetRotation - startRotation;
         }
     }
 
-    void Rotate::updateProgress()
+    Scale::Scale(float initLength, const Vector3F& initScale, bool initRelative):
+        Tween(initLength, AnimationSystem::TrackType::scale), scale(initScale), relative(initRelative)
     {
-        Animator::updateProgress();
-
-        if (targetActor)
-            targetActor->setRotation(startRotation + diff * progress);
     }
 
-    Scale::Scale(float initLength, const Vector3F& initScale, bool initRelative):
-        Animator(initLength), scale(initScale), relative(initRelative)
+    std::unique_ptr<Animator> Scale::clone() const
     {
+        auto result = std::make_unique<Scale>(length, scale, relative);
+        for (auto& animator : cloneAnimators())
+            result->addAnimator(std::move(animator));
+        return result;
     }
 
     void Scale::play()
     {
         Animator::play();
 
+        auto& scaleTrack = bindTrack();
+
         if (targetActor)
         {
-            startScale = targetActor->getScale();
-            targetScale = relative ? startScale + scale : scale;
+            const auto startScale = targetActor->getScale();
+            const auto targetScale = relative ? startScale + scale : scale;
 
-            diff = targetScale - startScale;
+            scaleTrack.start = startScale;
+            scaleTrack.diff = targetScale - startScale;
         }
     }
 
-    void Scale::updateProgress()
-    {
-        Animator::updateProgress();
-
-        if (targetActor)
-            targetActor->setScale(startScale + (diff * progress));
-    }
-
     Sequence::Sequence(const std::vector<Animator*>& initAnimators):
         Animator(std::accumulate(initAnimators.begin(), initAnimators.end(), 0.0F, [](float a, Animator* b) noexcept { return a + b->getLength(); }))
     {
@@ -502,6 +347,15 @@ namespace ouzel::scene
         }
     }
 
+    std::unique_ptr<Animator> Sequence::clone() const
+    {
+        auto clones = cloneAnimators();
+        auto result = std::make_unique<Sequence>(clones);
+        for (auto& animator : clones)
+            result->ownedAnimators.push_back(std::move(animator));
+        return result;
+    }
+
     void Sequence::play()
     {
         setProgress(0.0F);
@@ -522,6 +376,13 @@ namespace ouzel::scene
             currentAnimator = nullptr;
     }
 
+    void Sequence::recycle()
+    {
+        Animator::recycle();
+
+        currentAnimator = nullptr;
+    }
+
     void Sequence::updateProgress()
     {
         Animator::updateProgress();
@@ -554,55 +415,38 @@ namespace ouzel::scene
     }
 
     Shake::Shake(float initLength, const Vector3F& initDistance, float initTimeScale):
-        Animator(initLength), distance(initDistance), timeScale(initTimeScale)
+        Tween(initLength, AnimationSystem::TrackType::shake), distance(initDistance), timeScale(initTimeScale)
     {
         seedX = std::uniform_int_distribution<std::uint32_t>{0, std::numeric_limits<std::uint32_t>::max()}(core::randomEngine);
         seedY = std::uniform_int_distribution<std::uint32_t>{0, std::numeric_limits<std::uint32_t>::max()}(core::randomEngine);
         seedZ = std::uniform_int_distribution<std::uint32_t>{0, std::numeric_limits<std::uint32_t>::max()}(core::randomEngine);
     }
 
-    void Shake::play()
+    std::unique_ptr<Animator> Shake::clone() const
     {
-        Animator::play();
-
-        if (targetActor)
-            startPosition = targetActor->getPosition();
+        auto result = std::make_unique<Shake>(length, distance, timeScale);
+        result->seedX = seedX;
+        result->seedY = seedY;
+        result->seedZ = seedZ;
+        for (auto& animator : cloneAnimators())
+            result->addAnimator(std::move(animator));
+        return result;
     }
 
-    void Shake::updateProgress()
+    void Shake::play()
     {
-        Animator::updateProgress();
-
-        if (targetActor)
-        {
-            const float x = length * progress * timeScale;
-
-            const auto x1 = static_cast<std::uint64_t>(x);
-            const auto x2 = x1 + 1;
-            const auto t = x - static_cast<float>(x1);
-
-            Vector3F previousPosition;
-            Vector3F nextPosition;
+        Animator::play();
 
-            if (x1 != 0)
-            {
-                previousPosition.v[0] = (2.0F * (static_cast<float>(hash::fnv1::hash<std::uint32_t>(seedX | (x1 << 32))) / std::numeric_limits<std::uint32_t>::max()) - 1.0F) * distance.v[0];
-                previousPosition.v[1] = (2.0F * (static_cast<float>(hash::fnv1::hash<std::uint32_t>(seedY | (x1 << 32))) / std::numeric_limits<std::uint32_t>::max()) - 1.0F) * distance.v[1];
-                previousPosition.v[2] = (2.0F * (static_cast<float>(hash::fnv1::hash<std::uint32_t>(seedZ | (x1 << 32))) / std::numeric_limits<std::uint32_t>::max()) - 1.0F) * distance.v[2];
-            }
+        auto& shakeTrack = bindTrack();
 
-            if (x2 != static_cast<std::uint32_t>(timeScale))
-            {
-                nextPosition.v[0] = (2.0F * (static_cast<float>(hash::fnv1::hash<std::uint32_t>(seedX | (x2 << 32))) / std::numeric_limits<std::uint32_t>::max()) - 1.0F) * distance.v[0];
-                nextPosition.v[1] = (2.0F * (static_cast<float>(hash::fnv1::hash<std::uint32_t>(seedY | (x2 << 32))) / std::numeric_limits<std::uint32_t>::max()) - 1.0F) * distance.v[1];
-                nextPosition.v[2] = (2.0F * (static_cast<float>(hash::fnv1::hash<std::uint32_t>(seedZ | (x2 << 32))) / std::numeric_limits<std::uint32_t>::max()) - 1.0F) * distance.v[2];
-            }
+        auto& parameters = getAnimationSystem().getShakeParameters(track);
+        parameters.seeds = {seedX, seedY, seedZ};
+        parameters.length = length;
+        parameters.timeScale = timeScale;
 
-            const Vector3F noise(smoothStep(previousPosition.v[0], nextPosition.v[0], t),
-                                 smoothStep(previousPosition.v[1], nextPosition.v[1], t),
-                                 smoothStep(previousPosition.v[2], nextPosition.v[2], t));
+        if (targetActor)
+            shakeTrack.start = targetActor->getPosition();
 
-            targetActor->setPosition(startPosition + noise);
-        }
+        shakeTrack.diff = distance;
     }
 }
@@ -7,6 +7,7 @@
 #include <functional>
 #include <memory>
 #include <vector>
+#include "AnimationSystem.hpp"
 #include "Animator.hpp"
 #include "Component.hpp"
 #include "../events/EventHandler.hpp"
@@ -18,29 +19,13 @@ namespace ouzel::scene
     class Ease final: public Animator
     {
     public:
-        enum class Mode
-        {
-            easeIn,
-            easeOut,
-            easeInOut
-        };
-
-        enum class Func
-        {
-            sine,
-            quad,
-            cubic,
-            quart,
-            quint,
-            expo,
-            circ,
-            back,
-            elastic,
-            bounce
-        };
+        using Mode = EaseMode;
+        using Func = EaseFunc;
 
         Ease(Animator& animator, Mode initModee, Func initFunc);
 
+        std::unique_ptr<Animator> clone() const final;
+
     protected:
         void updateProgress() final;
 
@@ -49,39 +34,54 @@ namespace ouzel::scene
         Func func;
     };
 
-    class Fade final: public Animator
+    // Animator that interpolates a property of the target actor
+    // The state is kept in a track of the animation system, which writes the values to the actors
+    class Tween: public Animator
     {
     public:
-        Fade(float initLength, float initOpacity, bool initRelative = false);
+        ~Tween() override;
 
-        void play() final;
+        bool setEasedProgress(float newProgress, EaseMode easeMode, EaseFunc easeFunc) final;
+
+        void recycle() final;
 
     protected:
+        Tween(float initLength, AnimationSystem::TrackType initTrackType);
+
         void updateProgress() final;
 
+        // Writes the pending values to the actors and returns the track
+        AnimationSystem::Track& bindTrack();
+
+        AnimationSystem::TrackType trackType;
+        std::uint32_t track = AnimationSystem::invalidIndex;
+    };
+
+    class Fade final: public Tween
+    {
+    public:
+        Fade(float initLength, float initOpacity, bool initRelative = false);
+
+        std::unique_ptr<Animator> clone() const final;
+
+        void play() final;
+
     private:
         float opacity;
-        float startOpacity = 0.0F;
-        float targetOpacity = 0.0F;
-        float diff = 0.0F;
         bool relative;
     };
 
-    class Move final: public Animator
+    class Move final: public Tween
     {
     public:
         Move(float initLength, const Vector3F& initPosition, bool initRelative = false);
 
-        void play() final;
+        std::unique_ptr<Animator> clone() const final;
 
-    protected:
-        void updateProgress() final;
+        void play() final;
 
     private:
         Vector3F position;
-        Vector3F startPosition;
-        Vector3F targetPosition;
-        Vector3F diff;
         bool relative;
     };
 
@@ -91,6 +91,8 @@ namespace ouzel::scene
         explicit Parallel(const std::vector<Animator*>& initAnimators);
         explicit Parallel(const std::vector<std::unique_ptr<Animator>>& initAnimators);
 
+        std::unique_ptr<Animator> clone() const final;
+
     protected:
         void updateProgress() final;
     };
@@ -100,7 +102,10 @@ namespace ouzel::scene
     public:
         explicit Repeat(Animator& animator, std::uint32_t initCount = 0);
 
+        std::unique_ptr<Animator> clone() const final;
+
         void reset() final;
+        void recycle() final;
 
     protected:
         void updateProgress() final;
@@ -110,39 +115,31 @@ namespace ouzel::scene
         std::uint32_t currentCount = 0;
     };
 
-    class Rotate final: public Animator
+    class Rotate final: public Tween
     {
     public:
         Rotate(float initLength, const Vector3F& initRotation, bool initRelative = false);
 
-        void play() final;
+        std::unique_ptr<Animator> clone() const final;
 
-    protected:
-        void updateProgress() final;
+        void play() final;
 
     private:
         Vector3F rotation;
-        Vector3F startRotation;
-        Vector3F targetRotation;
-        Vector3F diff;
         bool relative;
     };
 
-    class Scale final: public Animator
+    class Scale final: public Tween
     {
     public:
         Scale(float initLength, const Vector3F& initScale, bool initRelative = false);
 
-        void play() final;
+        std::unique_ptr<Animator> clone() const final;
 
-    protected:
-        void updateProgress() final;
+        void play() final;
 
     private:
         Vector3F scale;
-        Vector3F startScale;
-        Vector3F targetScale;
-        Vector3F diff;
         bool relative;
     };
 
@@ -152,7 +149,10 @@ namespace ouzel::scene
         explicit Sequence(const std::vector<Animator*>& initAnimators);
         explicit Sequence(const std::vector<std::unique_ptr<Animator>>& initAnimators);
 
+        std::unique_ptr<Animator> clone() const final;
+
         void play() final;
+        void recycle() final;
 
     protected:
         void updateProgress() final;
@@ -161,15 +161,14 @@ namespace ouzel::scene
         Animator* currentAnimator = nullptr;
     };
 
-    class Shake final: public Animator
+    class Shake final: public Tween
     {
     public:
         Shake(float initLength, const Vector3F& initDistance, float initTimeScale);
 
-        void play() final;
+        std::unique_ptr<Animator> clone() const final;
 
-    protected:
-        void updateProgress() final;
+        void play() final;
 
     private:
         std::uint32_t seedX;
@@ -177,7 +176,6 @@ namespace ouzel::scene
         std::uint32_t seedZ;
         Vector3F distance;
         float timeScale;
-        Vector3F startPosition;
     };
 }
 
@@ -2,6 +2,7 @@
 
 #include "Component.hpp"
 #include "Actor.hpp"
+#include "Layer.hpp"
 #include "../math/MathUtils.hpp"
 
 namespace ouzel::scene
@@ -16,6 +17,8 @@ namespace ouzel::scene
                          const Matrix4F&,
                          bool)
     {
+        // the merged draws must come before the draws of this component
+        if (layer) layer->getInstanceBatcher().flush();
     }
 
     bool Component::pointOn(const Vector2F& position) const
@@ -0,0 +1,326 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#if defined(__SSE__)
+#  include <xmmintrin.h>
+#endif
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include "Easing.hpp"
+#include "../core/Engine.hpp"
+#include "../math/Constants.hpp"
+
+namespace ouzel::scene
+{
+    namespace
+    {
+        float sineIn(const float t)
+        {
+            return 1.0F - std::cos(t * pi<float> / 2.0F);
+        }
+
+        float sineOut(const float t)
+        {
+            return std::sin(t * pi<float> / 2.0F);
+        }
+
+        float sineInOut(const float t)
+        {
+            return -0.5F * (std::cos(pi<float> * t) - 1.0F);
+        }
+
+        constexpr float quadIn(const float t)
+        {
+            return t * t;
+        }
+
+        constexpr float quadOut(const float t)
+        {
+            return t * (2.0F - t);
+        }
+
+        constexpr float quadInOut(const float t)
+        {
+            return (t < 0.5F) ?
+                2.0F * t * t :
+                -1.0F + (4.0F - 2.0F * t) * t;
+        }
+
+        constexpr float cubicIn(const float t)
+        {
+            return t * t * t;
+        }
+
+        constexpr float cubicOut(const float t)
+        {
+            return (t - 1.0F) * (t - 1.0F) * (t - 1.0F) + 1.0F;
+        }
+
+        constexpr float cubicInOut(const float t)
+        {
+            return (t < 0.5F) ?
+                4.0F * t * t * t :
+                (t - 1.0F) * (2.0F * t - 2.0F) * (2.0F * t - 2.0F) + 1.0F;
+        }
+
+        constexpr float quartIn(const float t)
+        {
+            return t * t * t * t;
+        }
+
+        constexpr float quartOut(const float t)
+        {
+            return 1.0F - (t - 1.0F) * (t - 1.0F) * (t - 1.0F) * (t - 1.0F);
+        }
+
+        constexpr float quartInOut(const float t)
+        {
+            return (t < 0.5F) ?
+                8.0F * t * t * t * t :
+                1.0F - 8.0F * (t - 1.0F) * (t - 1.0F) * (t - 1.0F) * (t - 1.0F);
+        }
+
+        constexpr float quintIn(const float t)
+        {
+            return t * t * t * t * t;
+        }
+
+        constexpr float quintOut(const float t)
+        {
+            return 1.0F + (t - 1.0F) * (t - 1.0F) * (t - 1.0F) * (t - 1.0F) * (t - 1.0F);
+        }
+
+        constexpr float quintInOut(const float t)
+        {
+            return (t < 0.5F) ?
+                16.0F * t * t * t * t * t :
+                1.0F + 16.0F * (t - 1.0F) * (t - 1.0F) * (t - 1.0F) * (t - 1.0F) * (t - 1.0F);
+        }
+
+        float expoIn(const float t)
+        {
+            return std::pow(2.0F, 10.0F * (t - 1.0F));
+        }
+
+        float expoOut(const float t)
+        {
+            return 1.0F - std::pow(2.0F, -10.0F * t);
+        }
+
+        float expoInOut(const float t)
+        {
+            return (t < 0.5F) ?
+                0.5F * std::pow(2.0F, 10.0F * (2.0F * t - 1.0F)) :
+                0.5F * (std::pow(2.0F, -10.0F * (t * 2.0F - 1.0F)) - 2.0F);
+        }
+
+        float circIn(const float t)
+        {
+            return 1.0F - std::sqrt(1.0F - t * t);
+        }
+
+        float circOut(const float t)
+        {
+            return std::sqrt(1.0F - (t - 1.0F) * (t - 1.0F));
+        }
+
+        float circInOut(const float t)
+        {
+            return (t < 0.5F) ?
+                0.5F * (-std::sqrt(1.0F - (t * 2.0F) * (t * 2.0F)) + 1.0F) :
+                0.5F * (std::sqrt(1.0F - (t * 2.0F - 2.0F) * (t * 2.0F - 2.0F)) + 1.0F);
+        }
+
+        float backIn(const float t)
+        {
+            static constexpr float s = 1.70158F;
+            return t * t * ((s + 1.0F) * t - s);
+        }
+
+        float backOut(const float t)
+        {
+            static constexpr float s = 1.70158F;
+            return (t - 1.0F) * (t - 1.0F) * ((s + 1.0F) * (t - 1.0F) + s) + 1.0F;
+        }
+
+        float backInOut(const float t)
+        {
+            static constexpr float s = 1.70158F * 1.525F;
+            return (t < 0.5F) ?
+                0.5F * ((t * 2.0F) * (t * 2.0F) * ((s + 1.0F) * (t * 2.0F) - s)):
+                0.5F * ((t * 2.0F - 2.0F) * (t * 2.0F - 2.0F) * ((s + 1.0F) * (t * 2.0F - 2.0F) + s) + 2.0F);
+        }
+
+        float elasticIn(const float t)
+        {
+            if (t == 0.0F) return 0.0F;
+            if (t == 1.0F) return 1.0F;
+
+            static constexpr float p = 0.3F;
+
+            return -std::pow(2.0F, 10.0F * (t - 1.0F)) * std::sin(((t - 1.0F) - p / 4.0F) * (2.0F * pi<float>) / p);
+        }
+
+        float elasticOut(const float t)
+        {
+            if (t == 0.0F) return 0.0F;
+            if (t == 1.0F) return 1.0F;
+
+            static constexpr float p = 0.3F;
+
+            return std::pow(2.0F, -10.0F * t) * std::sin((t - p / 4.0F) * (2.0F * pi<float>) / p) + 1.0F;
+        }
+
+        float elasticInOut(const float t)
+        {
+            if (t == 0.0F) return 0.0F;
+            if (t == 1.0F) return 1.0F;
+
+            static constexpr float p = 0.3F * 1.5F;
+
+            return (t < 0.5F) ?
+                -0.5F * std::pow(2.0F, 10.0F * (t * 2.0F - 1.0F)) * std::sin(((t * 2.0F - 1.0F) - p / 4.0F) * (2.0F * pi<float>) / p) :
+                0.5F * std::pow(2.0F, -10.0F * (t * 2.0F - 1.0F)) * std::sin(((t * 2.0F - 1.0F) - p / 4.0F) * (2.0F * pi<float>) / p) + 1.0F;
+        }
+
+        float bounceOut(const float t)
+        {
+            if (t < 1.0F / 2.75F)
+                return 7.5625F * t * t;
+            else if (t < 2.0F / 2.75F)
+                return 7.5625F * (t - 1.5F / 2.75F) * (t - 1.5F / 2.75F) + 0.75F;
+            else if (t < 2.5F / 2.75F)
+                return 7.5625F * (t - 2.25F / 2.75F) * (t - 2.25F / 2.75F) + 0.9375F;
+            else
+                return 7.5625F * (t - 2.625F / 2.75F) * (t - 2.625F / 2.75F) + 0.984375F;
+        }
+
+        float bounceIn(const float t)
+        {
+            return 1.0F - bounceOut(1.0F - t);
+        }
+
+        float bounceInOut(const float t)
+        {
+            return (t < 0.5F) ?
+                bounceOut(t * 2.0F) * 0.5F :
+                bounceOut(t * 2.0F - 1.0F) * 0.5F + 0.5F;
+        }
+
+        using Function = float(*)(float);
+
+        constexpr Function functions[easeModeCount][easeFuncCount] = {
+            {sineIn, quadIn, cubicIn, quartIn, quintIn, expoIn, circIn, backIn, elasticIn, bounceIn},
+            {sineOut, quadOut, cubicOut, quartOut, quintOut, expoOut, circOut, backOut, elasticOut, bounceOut},
+            {sineInOut, quadInOut, cubicInOut, quartInOut, quintInOut, expoInOut, circInOut, backInOut, elasticInOut, bounceInOut}
+        };
+
+        Function getFunction(EaseMode mode, EaseFunc func)
+        {
+            const auto modeIndex = static_cast<std::size_t>(mode);
+            const auto funcIndex = static_cast<std::size_t>(func);
+
+            if (modeIndex >= easeModeCount) throw std::runtime_error("Invalid mode");
+            if (funcIndex >= easeFuncCount) throw std::runtime_error("Invalid function");
+
+            return functions[modeIndex][funcIndex];
+        }
+
+#if defined(__SSE__)
+        template <std::uint32_t n>
+        struct Power final
+        {
+            __m128 operator()(__m128 t) const noexcept
+            {
+                auto result = t;
+                for (std::uint32_t i = 1; i < n; ++i)
+                    result = _mm_mul_ps(result, t);
+                return result;
+            }
+        };
+
+        struct Back final
+        {
+            float s;
+
+            __m128 operator()(__m128 t) const noexcept
+            {
+                // t * t * ((s + 1) * t - s)
+                const auto a = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(s + 1.0F), t), _mm_set1_ps(s));
+                return _mm_mul_ps(_mm_mul_ps(t, t), a);
+            }
+        };
+
+        // Evaluates the out and in-out variants from the in curve:
+        // out(t) = 1 - in(1 - t), inOut(t) = t < 0.5 ? in(2t) / 2 : 1 - in(2 - 2t) / 2
+        // Returns the number of values processed
+        template <class F>
+        std::size_t easeVectorized(EaseMode mode, F in, float* values, std::size_t count) noexcept
+        {
+            const auto one = _mm_set1_ps(1.0F);
+            const auto two = _mm_set1_ps(2.0F);
+            const auto half = _mm_set1_ps(0.5F);
+
+            std::size_t i = 0;
+
+            switch (mode)
+            {
+                case EaseMode::easeIn:
+                    for (; i + 4 <= count; i += 4)
+                        _mm_storeu_ps(values + i, in(_mm_loadu_ps(values + i)));
+                    break;
+                case EaseMode::easeOut:
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const auto t = _mm_loadu_ps(values + i);
+                        _mm_storeu_ps(values + i, _mm_sub_ps(one, in(_mm_sub_ps(one, t))));
+                    }
+                    break;
+                case EaseMode::easeInOut:
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const auto t = _mm_loadu_ps(values + i);
+                        const auto doubled = _mm_mul_ps(two, t);
+                        const auto first = _mm_mul_ps(half, in(doubled));
+                        const auto second = _mm_sub_ps(one, _mm_mul_ps(half, in(_mm_sub_ps(two, doubled))));
+                        const auto mask = _mm_cmplt_ps(t, half);
+                        _mm_storeu_ps(values + i, _mm_or_ps(_mm_and_ps(mask, first), _mm_andnot_ps(mask, second)));
+                    }
+                    break;
+            }
+
+            return i;
+        }
+#endif
+    }
+
+    float ease(EaseMode mode, EaseFunc func, float t)
+    {
+        return getFunction(mode, func)(t);
+    }
+
+    void ease(EaseMode mode, EaseFunc func, float* values, std::size_t count)
+    {
+        const auto function = getFunction(mode, func);
+
+        std::size_t i = 0;
+
+#if defined(__SSE__)
+        if (core::isSimdAvailable)
+        {
+            switch (func)
+            {
+                case EaseFunc::quad: i = easeVectorized(mode, Power<2>{}, values, count); break;
+                case EaseFunc::cubic: i = easeVectorized(mode, Power<3>{}, values, count); break;
+                case EaseFunc::quart: i = easeVectorized(mode, Power<4>{}, values, count); break;
+                case EaseFunc::quint: i = easeVectorized(mode, Power<5>{}, values, count); break;
+                case EaseFunc::back: i = easeVectorized(mode, Back{mode == EaseMode::easeInOut ? 1.70158F * 1.525F : 1.70158F}, values, count); break;
+                default: break; // the rest of the curves need transcendental functions
+            }
+        }
+#endif
+
+        for (; i < count; ++i)
+            values[i] = function(values[i]);
+    }
+}
@@ -0,0 +1,40 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_EASING_HPP
+#define OUZEL_SCENE_EASING_HPP
+
+#include <cstddef>
+
+namespace ouzel::scene
+{
+    enum class EaseMode
+    {
+        easeIn,
+        easeOut,
+        easeInOut
+    };
+
+    enum class EaseFunc
+    {
+        sine,
+        quad,
+        cubic,
+        quart,
+        quint,
+        expo,
+        circ,
+        back,
+        elastic,
+        bounce
+    };
+
+    constexpr std::size_t easeModeCount = 3;
+    constexpr std::size_t easeFuncCount = 10;
+
+    float ease(EaseMode mode, EaseFunc func, float t);
+
+    // Replaces every value with the eased value, the polynomial curves are evaluated with SIMD
+    void ease(EaseMode mode, EaseFunc func, float* values, std::size_t count);
+}
+
+#endif // OUZEL_SCENE_EASING_HPP
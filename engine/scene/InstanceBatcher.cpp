@@ -0,0 +1,138 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "InstanceBatcher.hpp"
+#include "../core/Engine.hpp"
+#include "../utils/Utils.hpp"
+
+namespace ouzel::scene
+{
+    void InstanceBatcher::draw(const graphics::Material& newMaterial,
+                               std::size_t newIndexBuffer,
+                               std::uint32_t newIndexCount,
+                               std::uint32_t newIndexSize,
+                               std::size_t newVertexBuffer,
+                               const Matrix4F& modelViewProjection,
+                               float opacity,
+                               bool newWireframe)
+    {
+        if (!instances.empty() &&
+            (material != &newMaterial ||
+             indexBuffer != newIndexBuffer ||
+             indexCount != newIndexCount ||
+             indexSize != newIndexSize ||
+             vertexBuffer != newVertexBuffer ||
+             wireframe != newWireframe))
+            flush();
+
+        material = &newMaterial;
+        indexBuffer = newIndexBuffer;
+        indexCount = newIndexCount;
+        indexSize = newIndexSize;
+        vertexBuffer = newVertexBuffer;
+        wireframe = newWireframe;
+
+        graphics::Instance instance;
+        std::copy(std::begin(modelViewProjection.m), std::end(modelViewProjection.m), instance.transform.begin());
+        instance.color = {
+            material->diffuseColor.normR(),
+            material->diffuseColor.normG(),
+            material->diffuseColor.normB(),
+            material->diffuseColor.normA() * opacity * material->opacity
+        };
+
+        instances.push_back(instance);
+    }
+
+    void InstanceBatcher::flush()
+    {
+        if (instances.empty()) return;
+
+        const auto instancedShader = engine->getCache().getShader(shaderInstancedTexture);
+
+        // the instanced shader replaces only the built-in shaders
+        const bool instanced = instances.size() > 1 && instancedShader &&
+            (material->shader == engine->getCache().getShader(shaderTexture) ||
+             material->shader == engine->getCache().getShader(shaderColor));
+
+        // the buffers are not created while recording, the missing ones are created by the next reset
+        if (instanced && usedInstanceBuffers == instanceBuffers.size())
+            ++missingInstanceBuffers;
+
+        if (instanced && usedInstanceBuffers < instanceBuffers.size())
+            drawInstanced();
+        else
+            for (const auto& instance : instances)
+            {
+                std::vector<std::vector<float>> fragmentShaderConstants(1);
+                fragmentShaderConstants[0] = {instance.color.begin(), instance.color.end()};
+
+                std::vector<std::vector<float>> vertexShaderConstants(1);
+                vertexShaderConstants[0] = {instance.transform.begin(), instance.transform.end()};
+
+                std::vector<std::size_t> textures;
+                for (const std::shared_ptr<graphics::Texture>& texture : material->textures)
+                    textures.push_back(texture ? texture->getResource() : 0);
+
+                engine->getGraphics()->setPipelineState(material->blendState->getResource(),
+                                                        material->shader->getResource(),
+                                                        material->cullMode,
+                                                        wireframe ? graphics::FillMode::wireframe : graphics::FillMode::solid);
+                engine->getGraphics()->setShaderConstants(fragmentShaderConstants,
+                                                          vertexShaderConstants);
+                engine->getGraphics()->setTextures(textures);
+                engine->getGraphics()->draw(indexBuffer,
+                                            indexCount,
+                                            indexSize,
+                                            vertexBuffer,
+                                            graphics::DrawMode::triangleList,
+                                            0);
+            }
+
+        instances.clear();
+    }
+
+    void InstanceBatcher::reset()
+    {
+        for (; missingInstanceBuffers > 0; --missingInstanceBuffers)
+            instanceBuffers.emplace_back(*engine->getGraphics(),
+                                         graphics::BufferType::vertex,
+                                         graphics::Flags::dynamic);
+
+        usedInstanceBuffers = 0;
+    }
+
+    void InstanceBatcher::drawInstanced()
+    {
+        auto& instanceBuffer = instanceBuffers[usedInstanceBuffers++];
+        instanceBuffer.setData(instances.data(), static_cast<std::uint32_t>(getVectorSize(instances)));
+
+        // the instance colors already contain the material color
+        std::vector<std::vector<float>> fragmentShaderConstants(1);
+        fragmentShaderConstants[0] = {1.0F, 1.0F, 1.0F, 1.0F};
+
+        std::vector<std::size_t> textures;
+        for (const std::shared_ptr<graphics::Texture>& texture : material->textures)
+            textures.push_back(texture ? texture->getResource() : 0);
+
+        // the instanced shader samples a texture, so the color materials use a white pixel
+        if (!textures[0])
+            if (const auto whitePixelTexture = engine->getCache().getTexture(textureWhitePixel))
+                textures[0] = whitePixelTexture->getResource();
+
+        engine->getGraphics()->setPipelineState(material->blendState->getResource(),
+                                                engine->getCache().getShader(shaderInstancedTexture)->getResource(),
+                                                material->cullMode,
+                                                wireframe ? graphics::FillMode::wireframe : graphics::FillMode::solid);
+        engine->getGraphics()->setShaderConstants(fragmentShaderConstants, {});
+        engine->getGraphics()->setTextures(textures);
+        engine->getGraphics()->drawInstanced(indexBuffer,
+                                             indexCount,
+                                             indexSize,
+                                             vertexBuffer,
+                                             instanceBuffer.getResource(),
+                                             static_cast<std::uint32_t>(instances.size()),
+                                             graphics::DrawMode::triangleList,
+                                             0);
+    }
+}
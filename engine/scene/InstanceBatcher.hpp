@@ -0,0 +1,64 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_INSTANCEBATCHER_HPP
+#define OUZEL_SCENE_INSTANCEBATCHER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../graphics/Buffer.hpp"
+#include "../graphics/Instance.hpp"
+#include "../graphics/Material.hpp"
+#include "../math/Matrix.hpp"
+
+namespace ouzel::scene
+{
+    // Merges consecutive draws of the same mesh with the same material into a single instanced draw
+    // Only consecutive draws are merged, so the drawing order doesn't change
+    class InstanceBatcher final
+    {
+    public:
+        InstanceBatcher() = default;
+
+        InstanceBatcher(const InstanceBatcher&) = delete;
+        InstanceBatcher& operator=(const InstanceBatcher&) = delete;
+
+        InstanceBatcher(InstanceBatcher&&) = delete;
+        InstanceBatcher& operator=(InstanceBatcher&&) = delete;
+
+        // Flushes the pending draws if the draw can't be merged with them
+        void draw(const graphics::Material& material,
+                  std::size_t indexBuffer,
+                  std::uint32_t indexCount,
+                  std::uint32_t indexSize,
+                  std::size_t vertexBuffer,
+                  const Matrix4F& modelViewProjection,
+                  float opacity,
+                  bool wireframe);
+
+        void flush();
+
+        // Lets the instance buffers of the previous frame be reused and creates the ones that were missing in it,
+        // called by the scene once per frame before the layers are recorded, which must not create resources
+        void reset();
+
+    private:
+        void drawInstanced();
+
+        const graphics::Material* material = nullptr;
+        std::size_t indexBuffer = 0;
+        std::uint32_t indexCount = 0;
+        std::uint32_t indexSize = 0;
+        std::size_t vertexBuffer = 0;
+        bool wireframe = false;
+
+        std::vector<graphics::Instance> instances;
+
+        // every instanced draw of a frame gets its own buffer, the draws without one are not merged
+        std::vector<graphics::Buffer> instanceBuffers;
+        std::size_t usedInstanceBuffers = 0;
+        std::size_t missingInstanceBuffers = 0;
+    };
+}
+
+#endif // OUZEL_SCENE_INSTANCEBATCHER_HPP
@@ -26,20 +26,24 @@ namespace ouzel::scene
     void Layer::draw()
     {
         for (const auto camera : cameras)
-        {
-            std::vector<Actor*> drawQueue;
+            draw(*camera);
+    }
+
+    void Layer::draw(Camera& camera)
+    {
+        std::vector<Actor*> drawQueue;
 
-            for (const auto actor : children)
-                actor->visit(drawQueue, Matrix4F::identity(), false, camera, 0, false);
+        for (const auto actor : children)
+            actor->visit(drawQueue, Matrix4F::identity(), false, &camera, 0, false);
 
-            engine->getGraphics()->setRenderTarget(camera->getRenderTarget() ? camera->getRenderTarget()->getResource() : 0);
-            engine->getGraphics()->setViewport(camera->getRenderViewport());
-            engine->getGraphics()->setDepthStencilState(camera->getDepthStencilState() ? camera->getDepthStencilState()->getResource() : 0,
-                                                        camera->getStencilReferenceValue());
+        engine->getGraphics()->setViewport(camera.getRenderViewport());
+        engine->getGraphics()->setDepthStencilState(camera.getDepthStencilState() ? camera.getDepthStencilState()->getResource() : 0,
+                                                    camera.getStencilReferenceValue());
 
-            for (const auto actor : drawQueue)
-                actor->draw(camera, camera->getWireframe());
-        }
+        for (const auto actor : drawQueue)
+            actor->draw(&camera, camera.getWireframe());
+
+        instanceBatcher.flush();
     }
 
     void Layer::addChild(Actor& actor)
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <vector>
 #include "../scene/Actor.hpp"
+#include "../scene/InstanceBatcher.hpp"
 #include "../math/Vector.hpp"
 
 namespace ouzel::scene
@@ -25,7 +26,11 @@ namespace ouzel::scene
         Layer();
         ~Layer() override;
 
+        // The scene no longer calls this, it draws every camera through draw(Camera&),
+        // so the layers that customize drawing must override that instead
+        [[deprecated("Override draw(Camera&) instead")]]
         virtual void draw();
+        virtual void draw(Camera& camera);
 
         void addChild(Actor& actor) override;
 
@@ -41,6 +46,8 @@ namespace ouzel::scene
         auto getScene() const noexcept { return scene; }
         void removeFromScene();
 
+        auto& getInstanceBatcher() noexcept { return instanceBatcher; }
+
     protected:
         void addCamera(Camera& camera);
         void removeCamera(Camera& camera);
@@ -57,6 +64,8 @@ namespace ouzel::scene
         std::vector<Light*> lights;
 
         Order order = 0;
+
+        InstanceBatcher instanceBatcher;
     };
 }
 
@@ -57,6 +57,9 @@ namespace ouzel::scene
                 needsMeshUpdate = false;
             }
 
+            // only the vertices of the live particles are uploaded, the index buffer is shared by all the frames
+            const auto baseVertex = engine->getGraphics()->getTransientGeometry().addVertices(vertices.data(), particleCount * 4);
+
             const Matrix4F transform =
                 (particleSystemData.positionType == ParticleSystemData::PositionType::free ||
                  particleSystemData.positionType == ParticleSystemData::PositionType::parent) ?
@@ -83,9 +86,10 @@ namespace ouzel::scene
             engine->getGraphics()->draw(indexBuffer->getResource(),
                                         particleCount * 6,
                                         sizeof(std::uint16_t),
-                                        vertexBuffer->getResource(),
+                                        engine->getGraphics()->getTransientGeometry().getVertexBuffer().getResource(),
                                         graphics::DrawMode::triangleList,
-                                        0);
+                                        0,
+                                        baseVertex);
         }
     }
 
@@ -128,10 +132,10 @@ namespace ouzel::scene
                 active = false;
                 updateHandler.remove();
 
-                auto finishEvent = std::make_unique<AnimationEvent>();
-                finishEvent->type = Event::Type::animationFinish;
-                finishEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                AnimationEvent finishEvent;
+                finishEvent.type = Event::Type::animationFinish;
+                finishEvent.component = this;
+                engine->getEventDispatcher().dispatchEvent(finishEvent);
 
                 return;
             }
@@ -265,10 +269,10 @@ namespace ouzel::scene
 
             if (particleCount == 0)
             {
-                auto startEvent = std::make_unique<AnimationEvent>();
-                startEvent->type = Event::Type::animationStart;
-                startEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(startEvent));
+                AnimationEvent startEvent;
+                startEvent.type = Event::Type::animationStart;
+                startEvent.component = this;
+                engine->getEventDispatcher().dispatchEvent(startEvent);
             }
         }
     }
@@ -317,12 +321,6 @@ namespace ouzel::scene
                                                          indices.data(),
                                                          static_cast<std::uint32_t>(getVectorSize(indices)));
 
-        vertexBuffer = std::make_unique<graphics::Buffer>(*engine->getGraphics(),
-                                                          graphics::BufferType::vertex,
-                                                          graphics::Flags::dynamic,
-                                                          vertices.data(),
-                                                          static_cast<std::uint32_t>(getVectorSize(vertices)));
-
         particles.resize(particleSystemData.maxParticles);
     }
 
@@ -372,8 +370,6 @@ namespace ouzel::scene
                 vertices[i * 4 + 3].position = Vector3F(c + position);
                 vertices[i * 4 + 3].color = color;
             }
-
-            vertexBuffer->setData(vertices.data(), static_cast<std::uint32_t>(getVectorSize(vertices)));
         }
     }
 
@@ -195,7 +195,6 @@ namespace ouzel::scene
         std::vector<Particle> particles;
 
         std::unique_ptr<graphics::Buffer> indexBuffer;
-        std::unique_ptr<graphics::Buffer> vertexBuffer;
 
         std::vector<std::uint16_t> indices;
         std::vector<graphics::Vertex> vertices;
@@ -0,0 +1,163 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <stdexcept>
+#include "Prefab.hpp"
+#include "Component.hpp"
+
+namespace ouzel::scene
+{
+    Prefab::Prefab(const Actor& actor, std::size_t chunkSize):
+        actorPool(chunkSize),
+        spriteRendererPool(chunkSize),
+        instancePool(chunkSize)
+    {
+        capture(actor, 0);
+    }
+
+    void Prefab::capture(const Actor& actor, std::size_t parent)
+    {
+        const auto index = nodes.size();
+
+        nodes.push_back({
+            parent,
+            actor.getPosition(),
+            actor.getRotation(),
+            actor.getScale(),
+            actor.getOpacity(),
+            actor.getOrder(),
+            actor.getFlipX(),
+            actor.getFlipY(),
+            actor.isPickable(),
+            actor.isCullDisabled(),
+            actor.isHidden()
+        });
+
+        for (const Component* component : actor.getComponents())
+        {
+            if (const auto animator = dynamic_cast<const Animator*>(component))
+            {
+                animations.push_back({index, animator->clone(), animator->isRunning()});
+                continue;
+            }
+
+            const auto spriteRenderer = dynamic_cast<const SpriteRenderer*>(component);
+            if (!spriteRenderer)
+                throw std::runtime_error("Prefabs support only sprite renderer and animator components");
+
+            sprites.push_back({
+                index,
+                spriteRenderer->getSpriteData(),
+                spriteRenderer->getMaterial(),
+                spriteRenderer->getOffset(),
+                spriteRenderer->getAnimationName(),
+                spriteRenderer->isHidden(),
+                spriteRenderer->isPlaying()
+            });
+        }
+
+        for (const Actor* child : actor.getChildren())
+            capture(*child, index);
+    }
+
+    Actor& Prefab::spawn(ActorContainer& parent)
+    {
+        Instance* instance = instancePool.acquire();
+        if (!instance) instance = &createInstance();
+
+        resetInstance(*instance);
+        instance->spawned = true;
+
+        Actor& root = *instance->actors.front();
+        parent.addChild(root);
+        return root;
+    }
+
+    void Prefab::despawn(Actor& actor)
+    {
+        const auto i = instances.find(&actor);
+        if (i == instances.end() || !i->second->spawned)
+            throw std::runtime_error("Actor is not a spawned instance of this prefab");
+
+        actor.removeFromParent();
+        i->second->spawned = false;
+
+        // the update handlers of the sprites stay constructed, only the playing ones are removed from the dispatcher
+        for (SpriteRenderer* spriteRenderer : i->second->spriteRenderers)
+            spriteRenderer->stop(false);
+
+        // the animators leave the animation system and release their tracks until they are started again
+        for (const auto& animator : i->second->animators)
+            animator->recycle();
+
+        instancePool.release(*i->second);
+    }
+
+    Prefab::Instance& Prefab::createInstance()
+    {
+        Instance& instance = instancePool.create();
+        instance.actors.reserve(nodes.size());
+        instance.spriteRenderers.reserve(sprites.size());
+        instance.animators.reserve(animations.size());
+
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+            Actor& actor = actorPool.create();
+            if (i != 0) instance.actors[nodes[i].parent]->addChild(actor);
+            instance.actors.push_back(&actor);
+        }
+
+        for (const Sprite& sprite : sprites)
+        {
+            SpriteRenderer& spriteRenderer = spriteRendererPool.create(sprite.spriteData);
+            instance.actors[sprite.node]->addComponent(spriteRenderer);
+            instance.spriteRenderers.push_back(&spriteRenderer);
+        }
+
+        for (const Animation& animation : animations)
+        {
+            auto& animator = instance.animators.emplace_back(animation.animator->clone());
+            instance.actors[animation.node]->addComponent(*animator);
+        }
+
+        instances[instance.actors.front()] = &instance;
+
+        return instance;
+    }
+
+    void Prefab::resetInstance(const Instance& instance)
+    {
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+            const Node& node = nodes[i];
+            Actor& actor = *instance.actors[i];
+
+            actor.setTransform(node.position, node.rotation, node.scale);
+            actor.setOpacity(node.opacity);
+            actor.setOrder(node.order);
+            actor.setFlipX(node.flipX);
+            actor.setFlipY(node.flipY);
+            actor.setPickable(node.pickable);
+            actor.setCullDisabled(node.cullDisabled);
+            actor.setHidden(node.hidden);
+        }
+
+        for (std::size_t i = 0; i < sprites.size(); ++i)
+        {
+            const Sprite& sprite = sprites[i];
+            SpriteRenderer& spriteRenderer = *instance.spriteRenderers[i];
+
+            if (spriteRenderer.getMaterial() != sprite.material)
+                spriteRenderer.setMaterial(sprite.material);
+
+            spriteRenderer.setOffset(sprite.offset);
+            spriteRenderer.setHidden(sprite.hidden);
+            spriteRenderer.setAnimation(sprite.animation);
+            spriteRenderer.reset();
+            if (sprite.playing) spriteRenderer.play();
+        }
+
+        // started after the actors are reset, because the tweens start from the current values of the actors
+        for (std::size_t i = 0; i < animations.size(); ++i)
+            if (animations[i].running) instance.animators[i]->start();
+    }
+}
@@ -0,0 +1,99 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_PREFAB_HPP
+#define OUZEL_SCENE_PREFAB_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Actor.hpp"
+#include "Animator.hpp"
+#include "SpriteRenderer.hpp"
+#include "../utils/Pool.hpp"
+
+namespace ouzel::scene
+{
+    // Template of an actor subtree, the instances are recycled instead of destroyed
+    // Only sprite renderers and animators can be captured, the constructor throws an exception
+    // for any other component, animators are cloned, so the custom ones must override Animator::clone
+    class Prefab final
+    {
+    public:
+        explicit Prefab(const Actor& actor, std::size_t chunkSize = 64);
+
+        Prefab(const Prefab&) = delete;
+        Prefab& operator=(const Prefab&) = delete;
+
+        Prefab(Prefab&&) = delete;
+        Prefab& operator=(Prefab&&) = delete;
+
+        // Returns the root actor of an instance in the captured state, the prefab keeps owning it
+        Actor& spawn(ActorContainer& parent);
+        // Removes the instance from its parent and returns it to the pool
+        void despawn(Actor& actor);
+
+        auto getNodeCount() const noexcept { return nodes.size(); }
+        auto getInstanceCount() const noexcept { return instancePool.getSize(); }
+        auto getSpawnedCount() const noexcept { return instancePool.getSize() - instancePool.getFreeCount(); }
+
+    private:
+        struct Node final
+        {
+            std::size_t parent; // index of the parent node, the root's parent is itself
+            Vector3F position;
+            QuaternionF rotation;
+            Vector3F scale;
+            float opacity;
+            Actor::Order order;
+            bool flipX;
+            bool flipY;
+            bool pickable;
+            bool cullDisabled;
+            bool hidden;
+        };
+
+        struct Sprite final
+        {
+            std::size_t node;
+            std::shared_ptr<const SpriteData> spriteData;
+            std::shared_ptr<const graphics::Material> material;
+            Vector2F offset;
+            std::string animation;
+            bool hidden;
+            bool playing;
+        };
+
+        struct Animation final
+        {
+            std::size_t node;
+            std::unique_ptr<Animator> animator; // cloned for every instance
+            bool running;
+        };
+
+        struct Instance final
+        {
+            std::vector<Actor*> actors; // in the order of the nodes
+            std::vector<SpriteRenderer*> spriteRenderers; // in the order of the sprites
+            std::vector<std::unique_ptr<Animator>> animators; // in the order of the animations, recycled with the instance
+            bool spawned = false;
+        };
+
+        void capture(const Actor& actor, std::size_t parent);
+        Instance& createInstance();
+        void resetInstance(const Instance& instance);
+
+        std::vector<Node> nodes;
+        std::vector<Sprite> sprites;
+        std::vector<Animation> animations;
+
+        Pool<Actor> actorPool;
+        Pool<SpriteRenderer> spriteRendererPool; // destroyed before the actors that they belong to
+
+        Pool<Instance> instancePool;
+        std::unordered_map<const Actor*, Instance*> instances; // by the root actor
+    };
+}
+
+#endif // OUZEL_SCENE_PREFAB_HPP
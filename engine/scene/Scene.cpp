@@ -36,30 +36,65 @@ namespace ouzel::scene
             return a->getOrder() > b->getOrder();
         });
 
-        std::set<graphics::RenderTarget*> clearedRenderTargets;
+        renderGraph.reset();
+        buildRenderGraph(renderGraph);
+        renderGraph.compile();
+        renderGraph.execute(*engine->getGraphics(), &engine->getJobSystem());
 
-        for (Layer* layer : layers)
+        engine->getGraphics()->present();
+    }
+
+    void Scene::buildRenderGraph(graphics::RenderGraph& graph)
+    {
+        for (std::size_t layerIndex = 0; layerIndex < layers.size(); ++layerIndex)
         {
-            // clear all the render targets
-            for (Camera* camera : layer->getCameras())
+            Layer* layer = layers[layerIndex];
+            const auto& cameras = layer->getCameras();
+
+            // the instance buffers of the previous frame are reused by all the cameras of the layer
+            layer->getInstanceBatcher().reset();
+
+            std::vector<graphics::RenderGraph::Clear> clears(cameras.size());
+
+            // all the render targets of the layer are cleared before the layer is drawn,
+            // so the clear is attached to the first camera that renders to the target
+            for (std::size_t i = 0; i < cameras.size(); ++i)
             {
-                if ((camera->getClearColorBuffer() || camera->getClearDepthBuffer() || camera->getClearStencilBuffer()) &&
-                    clearedRenderTargets.insert(camera->getRenderTarget()).second)
+                const Camera* camera = cameras[i];
+
+                if (camera->getClearColorBuffer() || camera->getClearDepthBuffer() || camera->getClearStencilBuffer())
                 {
-                    engine->getGraphics()->setRenderTarget(camera->getRenderTarget() ? camera->getRenderTarget()->getResource() : 0);
-                    engine->getGraphics()->clearRenderTarget(camera->getClearColorBuffer(),
-                                                             camera->getClearDepthBuffer(),
-                                                             camera->getClearStencilBuffer(),
-                                                             camera->getClearColor(),
-                                                             camera->getClearDepth(),
-                                                             camera->getClearStencil());
+                    const auto first = std::find_if(cameras.begin(), cameras.end(), [camera](const Camera* other) noexcept {
+                        return other->getRenderTarget() == camera->getRenderTarget();
+                    });
+
+                    auto& clear = clears[static_cast<std::size_t>(first - cameras.begin())];
+
+                    if (!clear.isEnabled())
+                    {
+                        clear.colorBuffer = camera->getClearColorBuffer();
+                        clear.depthBuffer = camera->getClearDepthBuffer();
+                        clear.stencilBuffer = camera->getClearStencilBuffer();
+                        clear.color = camera->getClearColor();
+                        clear.depth = camera->getClearDepth();
+                        clear.stencil = camera->getClearStencil();
+                    }
                 }
             }
 
-            layer->draw();
-        }
+            for (std::size_t i = 0; i < cameras.size(); ++i)
+            {
+                Camera* camera = cameras[i];
 
-        engine->getGraphics()->present();
+                const auto pass = graph.addPass("Layer", {},
+                                                graph.importRenderTarget(camera->getRenderTarget()),
+                                                clears[i],
+                                                [layer, camera]() { layer->draw(*camera); });
+
+                // the cameras of a layer visit the same actors, so only the layers are recorded in parallel
+                graph.setRecordingGroup(pass, layerIndex);
+            }
+        }
     }
 
     void Scene::addLayer(Layer& layer)
@@ -286,12 +321,12 @@ namespace ouzel::scene
     {
         if (actor)
         {
-            auto event = std::make_unique<UIEvent>();
-            event->type = Event::Type::actorEnter;
-            event->actor = actor;
-            event->touchId = pointerId;
-            event->position = position;
-            engine->getEventDispatcher().dispatchEvent(std::move(event));
+            UIEvent event;
+            event.type = Event::Type::actorEnter;
+            event.actor = actor;
+            event.touchId = pointerId;
+            event.position = position;
+            engine->getEventDispatcher().dispatchEvent(event);
         }
     }
 
@@ -299,12 +334,12 @@ namespace ouzel::scene
     {
         if (actor)
         {
-            auto event = std::make_unique<UIEvent>();
-            event->type = Event::Type::actorLeave;
-            event->actor = actor;
-            event->touchId = pointerId;
-            event->position = position;
-            engine->getEventDispatcher().dispatchEvent(std::move(event));
+            UIEvent event;
+            event.type = Event::Type::actorLeave;
+            event.actor = actor;
+            event.touchId = pointerId;
+            event.position = position;
+            engine->getEventDispatcher().dispatchEvent(event);
         }
     }
 
@@ -314,13 +349,13 @@ namespace ouzel::scene
         {
             pointerDownOnActors[pointerId] = std::pair(actor, localPosition);
 
-            auto event = std::make_unique<UIEvent>();
-            event->type = Event::Type::actorPress;
-            event->actor = actor;
-            event->touchId = pointerId;
-            event->position = position;
-            event->localPosition = localPosition;
-            engine->getEventDispatcher().dispatchEvent(std::move(event));
+            UIEvent event;
+            event.type = Event::Type::actorPress;
+            event.actor = actor;
+            event.touchId = pointerId;
+            event.position = position;
+            event.localPosition = localPosition;
+            engine->getEventDispatcher().dispatchEvent(event);
         }
     }
 
@@ -334,24 +369,24 @@ namespace ouzel::scene
 
             if (pointerDownOnActor.first)
             {
-                auto releaseEvent = std::make_unique<UIEvent>();
-                releaseEvent->type = Event::Type::actorRelease;
-                releaseEvent->actor = pointerDownOnActor.first;
-                releaseEvent->touchId = pointerId;
-                releaseEvent->position = position;
-                releaseEvent->localPosition = pointerDownOnActor.second;
+                UIEvent releaseEvent;
+                releaseEvent.type = Event::Type::actorRelease;
+                releaseEvent.actor = pointerDownOnActor.first;
+                releaseEvent.touchId = pointerId;
+                releaseEvent.position = position;
+                releaseEvent.localPosition = pointerDownOnActor.second;
 
-                engine->getEventDispatcher().dispatchEvent(std::move(releaseEvent));
+                engine->getEventDispatcher().dispatchEvent(releaseEvent);
 
                 if (pointerDownOnActor.first == actor)
                 {
-                    auto clickEvent = std::make_unique<UIEvent>();
-                    clickEvent->type = Event::Type::actorClick;
-                    clickEvent->actor = actor;
-                    clickEvent->touchId = pointerId;
-                    clickEvent->position = position;
+                    UIEvent clickEvent;
+                    clickEvent.type = Event::Type::actorClick;
+                    clickEvent.actor = actor;
+                    clickEvent.touchId = pointerId;
+                    clickEvent.position = position;
 
-                    engine->getEventDispatcher().dispatchEvent(std::move(clickEvent));
+                    engine->getEventDispatcher().dispatchEvent(clickEvent);
                 }
             }
         }
@@ -364,14 +399,14 @@ namespace ouzel::scene
     {
         if (actor)
         {
-            auto event = std::make_unique<UIEvent>();
-            event->type = Event::Type::actorDrag;
-            event->actor = actor;
-            event->touchId = pointerId;
-            event->difference = difference;
-            event->position = position;
-            event->localPosition = localPosition;
-            engine->getEventDispatcher().dispatchEvent(std::move(event));
+            UIEvent event;
+            event.type = Event::Type::actorDrag;
+            event.actor = actor;
+            event.touchId = pointerId;
+            event.difference = difference;
+            event.position = position;
+            event.localPosition = localPosition;
+            engine->getEventDispatcher().dispatchEvent(event);
         }
     }
 }
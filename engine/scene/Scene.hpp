@@ -8,6 +8,7 @@
 #include <cstdint>
 #include "../math/Vector.hpp"
 #include "../events/EventHandler.hpp"
+#include "../graphics/RenderGraph.hpp"
 
 namespace ouzel::scene
 {
@@ -43,6 +44,9 @@ namespace ouzel::scene
         bool hasLayer(const Layer& layer) const;
         auto& getLayers() const noexcept { return layers; }
 
+        auto& getRenderGraph() noexcept { return renderGraph; }
+        auto& getRenderGraph() const noexcept { return renderGraph; }
+
         virtual void recalculateProjection();
 
         std::pair<Actor*, Vector3F> pickActor(const Vector2F& position, bool renderTargets = false) const;
@@ -53,6 +57,9 @@ namespace ouzel::scene
         virtual void enter();
         virtual void leave();
 
+        // Adds a pass for every layer and camera pair, override to add custom passes (e.g. post-processing)
+        virtual void buildRenderGraph(graphics::RenderGraph& graph);
+
         bool handleWindow(const WindowEvent& event);
         bool handleMouse(const MouseEvent& event);
         bool handleTouch(const TouchEvent& event);
@@ -70,6 +77,8 @@ namespace ouzel::scene
         std::vector<std::unique_ptr<Layer>> ownedLayers;
         EventHandler eventHandler;
 
+        graphics::RenderGraph renderGraph;
+
         std::unordered_map<std::uint64_t, std::pair<Actor*, Vector3F>> pointerDownOnActors;
 
         bool entered = false;
@@ -9,6 +9,9 @@
 #include <queue>
 #include <set>
 #include <vector>
+#include "AnimationSystem.hpp"
+#include "SkinningSystem.hpp"
+#include "TransformInterpolator.hpp"
 
 namespace ouzel::scene
 {
@@ -40,7 +43,20 @@ namespace ouzel::scene
 
         auto getScene() const noexcept { return scenes.empty() ? nullptr : scenes.back(); }
 
+        auto& getAnimationSystem() noexcept { return animationSystem; }
+        auto& getAnimationSystem() const noexcept { return animationSystem; }
+
+        auto& getSkinningSystem() noexcept { return skinningSystem; }
+        auto& getSkinningSystem() const noexcept { return skinningSystem; }
+
+        auto& getTransformInterpolator() noexcept { return transformInterpolator; }
+        auto& getTransformInterpolator() const noexcept { return transformInterpolator; }
+
     private:
+        // declared first, so that they outlive the animators, the renderers and the actors of the owned scenes
+        AnimationSystem animationSystem;
+        SkinningSystem skinningSystem;
+        TransformInterpolator transformInterpolator;
         std::vector<Scene*> scenes;
         std::vector<std::unique_ptr<Scene>> ownedScenes;
     };
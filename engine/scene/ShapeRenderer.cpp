@@ -6,19 +6,12 @@
 #include "Camera.hpp"
 #include "../core/Engine.hpp"
 #include "../graphics/Graphics.hpp"
-#include "../utils/Utils.hpp"
 
 namespace ouzel::scene
 {
     ShapeRenderer::ShapeRenderer():
         shader(engine->getCache().getShader(shaderColor)),
-        blendState(engine->getCache().getBlendState(blendAlpha)),
-        indexBuffer(*engine->getGraphics(),
-                    graphics::BufferType::index,
-                    graphics::Flags::dynamic),
-        vertexBuffer(*engine->getGraphics(),
-                     graphics::BufferType::vertex,
-                     graphics::Flags::dynamic)
+        blendState(engine->getCache().getBlendState(blendAlpha))
     {
     }
 
@@ -32,12 +25,11 @@ namespace ouzel::scene
                         renderViewProjection,
                         wireframe);
 
-        if (dirty)
-        {
-            if (!indices.empty()) indexBuffer.setData(indices.data(), static_cast<std::uint32_t>(getVectorSize(indices)));
-            if (!vertices.empty()) vertexBuffer.setData(vertices.data(), static_cast<std::uint32_t>(getVectorSize(vertices)));
-            dirty = false;
-        }
+        if (drawCommands.empty()) return;
+
+        auto& transientGeometry = engine->getGraphics()->getTransientGeometry();
+        const auto startIndex = transientGeometry.addIndices(indices.data(), static_cast<std::uint32_t>(indices.size()));
+        const auto baseVertex = transientGeometry.addVertices(vertices.data(), static_cast<std::uint32_t>(vertices.size()));
 
         const auto modelViewProj = renderViewProjection * transformMatrix;
         const float colorVector[] = {1.0F, 1.0F, 1.0F, opacity};
@@ -56,12 +48,13 @@ namespace ouzel::scene
                                                     wireframe ? graphics::FillMode::wireframe : graphics::FillMode::solid);
             engine->getGraphics()->setShaderConstants(fragmentShaderConstants,
                                                       vertexShaderConstants);
-            engine->getGraphics()->draw(indexBuffer.getResource(),
+            engine->getGraphics()->draw(transientGeometry.getIndexBuffer().getResource(),
                                         drawCommand.indexCount,
                                         sizeof(std::uint16_t),
-                                        vertexBuffer.getResource(),
+                                        transientGeometry.getVertexBuffer().getResource(),
                                         drawCommand.mode,
-                                        drawCommand.startIndex);
+                                        startIndex + drawCommand.startIndex,
+                                        baseVertex);
         }
     }
 
@@ -72,8 +65,6 @@ namespace ouzel::scene
         drawCommands.clear();
         indices.clear();
         vertices.clear();
-
-        dirty = true;
     }
 
     void ShapeRenderer::line(const Vector2F& start, const Vector2F& finish, Color color, float thickness)
@@ -135,8 +126,6 @@ namespace ouzel::scene
         }
 
         drawCommands.push_back(command);
-
-        dirty = true;
     }
 
     void ShapeRenderer::circle(const Vector2F& position,
@@ -247,8 +236,6 @@ namespace ouzel::scene
         }
 
         drawCommands.push_back(command);
-
-        dirty = true;
     }
 
     void ShapeRenderer::rectangle(const RectF& rectangle,
@@ -394,8 +381,6 @@ namespace ouzel::scene
         }
 
         drawCommands.push_back(command);
-
-        dirty = true;
     }
 
     void ShapeRenderer::polygon(const std::vector<Vector2F>& edges,
@@ -456,8 +441,6 @@ namespace ouzel::scene
         }
 
         drawCommands.push_back(command);
-
-        dirty = true;
     }
 
     namespace
@@ -531,7 +514,5 @@ namespace ouzel::scene
         }
 
         drawCommands.push_back(command);
-
-        dirty = true;
     }
 }
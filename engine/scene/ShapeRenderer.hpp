@@ -7,7 +7,6 @@
 #include "Component.hpp"
 #include "../graphics/Graphics.hpp"
 #include "../graphics/BlendState.hpp"
-#include "../graphics/Buffer.hpp"
 #include "../graphics/Shader.hpp"
 #include "../math/Color.hpp"
 
@@ -74,14 +73,11 @@ namespace ouzel::scene
 
         const graphics::Shader* shader = nullptr;
         const graphics::BlendState* blendState = nullptr;
-        graphics::Buffer indexBuffer;
-        graphics::Buffer vertexBuffer;
 
         std::vector<DrawCommand> drawCommands;
 
         std::vector<std::uint16_t> indices;
         std::vector<graphics::Vertex> vertices;
-        bool dirty = false;
     };
 }
 
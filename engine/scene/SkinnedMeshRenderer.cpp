@@ -1,24 +1,501 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#if defined(__SSE__)
+#  include <xmmintrin.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 #include "SkinnedMeshRenderer.hpp"
+#include "Actor.hpp"
+#include "SkinningSystem.hpp"
 #include "../core/Engine.hpp"
+#include "../math/MathUtils.hpp"
+#include "../utils/Utils.hpp"
 
 namespace ouzel::scene
 {
+    namespace
+    {
+        // Translation * rotation * scale
+        void composeTransform(const SkinnedMeshData::BonePose& pose, Matrix4F& result) noexcept
+        {
+            const auto& q = pose.rotation.v;
+
+            const float wx = q[3] * q[0];
+            const float wy = q[3] * q[1];
+            const float wz = q[3] * q[2];
+            const float xx = q[0] * q[0];
+            const float xy = q[0] * q[1];
+            const float xz = q[0] * q[2];
+            const float yy = q[1] * q[1];
+            const float yz = q[1] * q[2];
+            const float zz = q[2] * q[2];
+
+            result.m[0] = (1.0F - 2.0F * (yy + zz)) * pose.scale.v[0];
+            result.m[1] = 2.0F * (xy + wz) * pose.scale.v[0];
+            result.m[2] = 2.0F * (xz - wy) * pose.scale.v[0];
+            result.m[3] = 0.0F;
+
+            result.m[4] = 2.0F * (xy - wz) * pose.scale.v[1];
+            result.m[5] = (1.0F - 2.0F * (xx + zz)) * pose.scale.v[1];
+            result.m[6] = 2.0F * (yz + wx) * pose.scale.v[1];
+            result.m[7] = 0.0F;
+
+            result.m[8] = 2.0F * (xz + wy) * pose.scale.v[2];
+            result.m[9] = 2.0F * (yz - wx) * pose.scale.v[2];
+            result.m[10] = (1.0F - 2.0F * (xx + yy)) * pose.scale.v[2];
+            result.m[11] = 0.0F;
+
+            result.m[12] = pose.position.v[0];
+            result.m[13] = pose.position.v[1];
+            result.m[14] = pose.position.v[2];
+            result.m[15] = 1.0F;
+        }
+
+        // Normalized linear interpolation along the shortest path
+        QuaternionF interpolateRotation(const Vector4F& a, const Vector4F& b, float t) noexcept
+        {
+            const float dot = a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2] + a.v[3] * b.v[3];
+            const float sign = dot < 0.0F ? -1.0F : 1.0F;
+
+            QuaternionF result(a.v[0] + (b.v[0] * sign - a.v[0]) * t,
+                               a.v[1] + (b.v[1] * sign - a.v[1]) * t,
+                               a.v[2] + (b.v[2] * sign - a.v[2]) * t,
+                               a.v[3] + (b.v[3] * sign - a.v[3]) * t);
+            result.normalize();
+            return result;
+        }
+
+        void sampleChannel(const SkinnedMeshData::Channel& channel, float time, SkinnedMeshData::BonePose& pose)
+        {
+            if (channel.times.empty() || channel.values.size() < channel.times.size()) return;
+
+            // first key after the time
+            const auto next = static_cast<std::size_t>(std::upper_bound(channel.times.begin(), channel.times.end(), time) - channel.times.begin());
+
+            std::size_t first;
+            std::size_t second;
+            float t = 0.0F;
+
+            if (next == 0)
+                first = second = 0;
+            else if (next == channel.times.size())
+                first = second = next - 1;
+            else
+            {
+                first = next - 1;
+                second = next;
+
+                if (channel.interpolation == SkinnedMeshData::Channel::Interpolation::linear)
+                {
+                    const float length = channel.times[second] - channel.times[first];
+                    t = length > 0.0F ? (time - channel.times[first]) / length : 0.0F;
+                }
+                else
+                    second = first;
+            }
+
+            const auto& a = channel.values[first];
+            const auto& b = channel.values[second];
+
+            switch (channel.path)
+            {
+                case SkinnedMeshData::Channel::Path::translation:
+                    pose.position = Vector3F(lerp(a.v[0], b.v[0], t), lerp(a.v[1], b.v[1], t), lerp(a.v[2], b.v[2], t));
+                    break;
+                case SkinnedMeshData::Channel::Path::rotation:
+                    pose.rotation = interpolateRotation(a, b, t);
+                    break;
+                case SkinnedMeshData::Channel::Path::scale:
+                    pose.scale = Vector3F(lerp(a.v[0], b.v[0], t), lerp(a.v[1], b.v[1], t), lerp(a.v[2], b.v[2], t));
+                    break;
+                default:
+                    throw std::runtime_error("Invalid channel path");
+            }
+        }
+
+        // Transforms the positions and the normals by the weighted sum of the bone matrices
+        void skin(const graphics::Vertex* source,
+                  const std::array<std::uint16_t, SkinnedMeshData::maxBoneInfluences>* boneIndices,
+                  const Vector4F* boneWeights,
+                  const Matrix4F* palette,
+                  graphics::Vertex* destination,
+                  std::size_t count) noexcept
+        {
+#if defined(__SSE__)
+            if (core::isSimdAvailable)
+            {
+                alignas(16) float position[4];
+                alignas(16) float normal[4];
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    __m128 column0 = _mm_setzero_ps();
+                    __m128 column1 = _mm_setzero_ps();
+                    __m128 column2 = _mm_setzero_ps();
+                    __m128 column3 = _mm_setzero_ps();
+
+                    for (std::size_t influence = 0; influence < SkinnedMeshData::maxBoneInfluences; ++influence)
+                    {
+                        const float weight = boneWeights[i].v[influence];
+                        if (weight == 0.0F) continue;
+
+                        const __m128 w = _mm_set1_ps(weight);
+                        const float* m = palette[boneIndices[i][influence]].m.data();
+
+                        column0 = _mm_add_ps(column0, _mm_mul_ps(_mm_load_ps(m + 0), w));
+                        column1 = _mm_add_ps(column1, _mm_mul_ps(_mm_load_ps(m + 4), w));
+                        column2 = _mm_add_ps(column2, _mm_mul_ps(_mm_load_ps(m + 8), w));
+                        column3 = _mm_add_ps(column3, _mm_mul_ps(_mm_load_ps(m + 12), w));
+                    }
+
+                    const auto& sourcePosition = source[i].position.v;
+                    const auto& sourceNormal = source[i].normal.v;
+
+                    __m128 result = _mm_add_ps(column3, _mm_mul_ps(column0, _mm_set1_ps(sourcePosition[0])));
+                    result = _mm_add_ps(result, _mm_mul_ps(column1, _mm_set1_ps(sourcePosition[1])));
+                    result = _mm_add_ps(result, _mm_mul_ps(column2, _mm_set1_ps(sourcePosition[2])));
+                    _mm_store_ps(position, result);
+
+                    result = _mm_mul_ps(column0, _mm_set1_ps(sourceNormal[0]));
+                    result = _mm_add_ps(result, _mm_mul_ps(column1, _mm_set1_ps(sourceNormal[1])));
+                    result = _mm_add_ps(result, _mm_mul_ps(column2, _mm_set1_ps(sourceNormal[2])));
+                    _mm_store_ps(normal, result);
+
+                    destination[i].position = Vector3F(position[0], position[1], position[2]);
+                    destination[i].normal = Vector3F(normal[0], normal[1], normal[2]);
+                }
+
+                return;
+            }
+#endif
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                float m[16] = {};
+
+                for (std::size_t influence = 0; influence < SkinnedMeshData::maxBoneInfluences; ++influence)
+                {
+                    const float weight = boneWeights[i].v[influence];
+                    if (weight == 0.0F) continue;
+
+                    const auto& boneMatrix = palette[boneIndices[i][influence]];
+                    for (std::size_t c = 0; c < 16; ++c)
+                        m[c] += boneMatrix.m[c] * weight;
+                }
+
+                const auto& p = source[i].position.v;
+                const auto& n = source[i].normal.v;
+
+                destination[i].position = Vector3F(m[0] * p[0] + m[4] * p[1] + m[8] * p[2] + m[12],
+                                                   m[1] * p[0] + m[5] * p[1] + m[9] * p[2] + m[13],
+                                                   m[2] * p[0] + m[6] * p[1] + m[10] * p[2] + m[14]);
+                destination[i].normal = Vector3F(m[0] * n[0] + m[4] * n[1] + m[8] * n[2],
+                                                 m[1] * n[0] + m[5] * n[1] + m[9] * n[2],
+                                                 m[2] * n[0] + m[6] * n[1] + m[10] * n[2]);
+            }
+        }
+    }
+
+    void SkinnedMeshData::initBuffers()
+    {
+        // order the bones so that every parent is transformed before its children
+        boneOrder.clear();
+        boneOrder.reserve(bones.size());
+
+        std::vector<bool> ordered(bones.size(), false);
+
+        while (boneOrder.size() < bones.size())
+        {
+            const auto previousSize = boneOrder.size();
+
+            for (std::size_t i = 0; i < bones.size(); ++i)
+                if (!ordered[i] && (bones[i].parent == noParent || ordered[bones[i].parent]))
+                {
+                    ordered[i] = true;
+                    boneOrder.push_back(i);
+                }
+
+            if (boneOrder.size() == previousSize)
+                throw std::runtime_error("Invalid bone hierarchy");
+        }
+
+        // the bone influences go to a separate stream, so that the meshes that are not skinned on the GPU don't carry them
+        std::vector<graphics::SkinVertex> skinVertices(bones.empty() ? 0 : vertices.size());
+
+        if (!bones.empty() && boneIndices.size() == vertices.size())
+            for (std::size_t i = 0; i < vertices.size(); ++i)
+            {
+                auto& skinVertex = skinVertices[i];
+                std::uint32_t weightSum = 0;
+                std::size_t heaviest = 0;
+
+                for (std::size_t influence = 0; influence < maxBoneInfluences; ++influence)
+                {
+                    if (boneIndices[i][influence] >= bones.size())
+                        throw std::runtime_error("Invalid bone index");
+
+                    // only the meshes that fit into the bone array of the shaders are skinned on the GPU
+                    skinVertex.blendIndices[influence] = static_cast<std::uint8_t>(std::min(boneIndices[i][influence], std::uint16_t{255}));
+                    skinVertex.blendWeights[influence] = static_cast<std::uint8_t>(std::clamp(boneWeights[i].v[influence], 0.0F, 1.0F) * 255.0F + 0.5F);
+                    weightSum += skinVertex.blendWeights[influence];
+
+                    if (skinVertex.blendWeights[influence] > skinVertex.blendWeights[heaviest])
+                        heaviest = influence;
+                }
+
+                // the rounding error goes to the heaviest influence
+                if (weightSum != 0)
+                    skinVertex.blendWeights[heaviest] = static_cast<std::uint8_t>(static_cast<std::int32_t>(skinVertex.blendWeights[heaviest]) + 255 - static_cast<std::int32_t>(weightSum));
+            }
+
+        indexSize = vertices.size() > std::numeric_limits<std::uint16_t>::max() + 1U ?
+            sizeof(std::uint32_t) : sizeof(std::uint16_t);
+
+        if (indexSize == sizeof(std::uint16_t))
+        {
+            std::vector<std::uint16_t> convertedIndices;
+            convertedIndices.reserve(indices.size());
+
+            for (const auto index : indices)
+                convertedIndices.push_back(static_cast<std::uint16_t>(index));
+
+            indexBuffer = graphics::Buffer(*engine->getGraphics(),
+                                           graphics::BufferType::index,
+                                           graphics::Flags::none,
+                                           convertedIndices.data(),
+                                           static_cast<std::uint32_t>(getVectorSize(convertedIndices)));
+        }
+        else
+            indexBuffer = graphics::Buffer(*engine->getGraphics(),
+                                           graphics::BufferType::index,
+                                           graphics::Flags::none,
+                                           indices.data(),
+                                           static_cast<std::uint32_t>(getVectorSize(indices)));
+
+        vertexBuffer = graphics::Buffer(*engine->getGraphics(),
+                                        graphics::BufferType::vertex,
+                                        graphics::Flags::none,
+                                        vertices.data(),
+                                        static_cast<std::uint32_t>(getVectorSize(vertices)));
+
+        if (!skinVertices.empty())
+            skinBuffer = graphics::Buffer(*engine->getGraphics(),
+                                          graphics::BufferType::vertex,
+                                          graphics::Flags::none,
+                                          skinVertices.data(),
+                                          static_cast<std::uint32_t>(getVectorSize(skinVertices)));
+    }
+
+    const SkinnedMeshData::Animation* SkinnedMeshData::getAnimation(const std::string& name) const noexcept
+    {
+        for (const auto& animation : animations)
+            if (animation.name == name)
+                return &animation;
+
+        return nullptr;
+    }
+
+    void SkinnedMeshData::calculateBonePalette(const Animation* animation,
+                                               float time,
+                                               std::vector<BonePose>& poses,
+                                               std::vector<Matrix4F>& globalTransforms,
+                                               std::vector<Matrix4F>& palette) const
+    {
+        poses.resize(bones.size());
+        globalTransforms.resize(bones.size());
+        palette.resize(bones.size());
+
+        for (std::size_t i = 0; i < bones.size(); ++i)
+        {
+            poses[i].position = bones[i].position;
+            poses[i].rotation = bones[i].rotation;
+            poses[i].scale = bones[i].scale;
+        }
+
+        if (animation)
+            for (const auto& channel : animation->channels)
+                if (channel.bone < poses.size())
+                    sampleChannel(channel, time, poses[channel.bone]);
+
+        Matrix4F localTransform;
+
+        for (const auto bone : boneOrder)
+        {
+            composeTransform(poses[bone], localTransform);
+
+            const auto parent = bones[bone].parent;
+            globalTransforms[bone] = (parent == noParent) ? localTransform : globalTransforms[parent] * localTransform;
+            palette[bone] = globalTransforms[bone] * bones[bone].inverseBindMatrix;
+        }
+    }
+
     SkinnedMeshRenderer::SkinnedMeshRenderer()
     {
         whitePixelTexture = engine->getCache().getTexture(textureWhitePixel);
     }
 
-    SkinnedMeshRenderer::SkinnedMeshRenderer(const SkinnedMeshData& meshData)
+    SkinnedMeshRenderer::SkinnedMeshRenderer(const SkinnedMeshData& initMeshData)
     {
-        init(meshData);
+        init(initMeshData);
     }
 
-    void SkinnedMeshRenderer::init(const SkinnedMeshData& meshData)
+    SkinnedMeshRenderer::~SkinnedMeshRenderer()
     {
-        boundingBox = meshData.boundingBox;
-        material = meshData.material;
+        if (skinningSystem) skinningSystem->removeRenderer(*this);
+    }
+
+    void SkinnedMeshRenderer::init(const SkinnedMeshData& initMeshData)
+    {
+        meshData = &initMeshData;
+        boundingBox = meshData->boundingBox;
+        material = meshData->material;
+        whitePixelTexture = engine->getCache().getTexture(textureWhitePixel);
+
+        animation = nullptr;
+        animationTime = 0.0F;
+        playing = false;
+        poseDirty = true;
+
+        updateSkinningMode();
+
+        engine->getSceneManager().getSkinningSystem().addRenderer(*this);
+    }
+
+    void SkinnedMeshRenderer::setMaterial(const std::shared_ptr<graphics::Material>& newMaterial)
+    {
+        material = newMaterial;
+
+        updateSkinningMode();
+    }
+
+    bool SkinnedMeshRenderer::playAnimation(const std::string& name, bool loop)
+    {
+        if (!meshData) return false;
+
+        const auto newAnimation = meshData->getAnimation(name);
+        if (!newAnimation) return false;
+
+        animation = newAnimation;
+        animationTime = 0.0F;
+        looping = loop;
+        playing = true;
+        poseDirty = true;
+
+        return true;
+    }
+
+    void SkinnedMeshRenderer::stopAnimation()
+    {
+        playing = false;
+    }
+
+    void SkinnedMeshRenderer::setAnimationTime(float newAnimationTime)
+    {
+        animationTime = newAnimationTime;
+        poseDirty = true;
+    }
+
+    void SkinnedMeshRenderer::updatePose(float delta)
+    {
+        if (!meshData || meshData->bones.empty()) return;
+
+        if (playing && animation)
+        {
+            animationTime += delta * animationSpeed;
+
+            if (animation->duration <= 0.0F)
+                animationTime = 0.0F;
+            else if (looping)
+            {
+                animationTime = std::fmod(animationTime, animation->duration);
+                if (animationTime < 0.0F) animationTime += animation->duration;
+            }
+            else if (animationTime >= animation->duration)
+            {
+                animationTime = animation->duration;
+                playing = false;
+            }
+
+            poseDirty = true;
+        }
+
+        if (!poseDirty) return;
+
+        meshData->calculateBonePalette(animation, animationTime, bonePoses, globalTransforms, bonePalette);
+
+        // the vertices of the meshes that are not visible are skinned when they are drawn
+        if (!gpuSkinning)
+        {
+            if (actor && !hidden && !actor->isHidden())
+                skinVertices();
+            else
+                skinningPending = true;
+        }
+
+        poseDirty = false;
+    }
+
+    void SkinnedMeshRenderer::skinVertices()
+    {
+        if (meshData->boneIndices.size() != meshData->vertices.size() ||
+            bonePalette.size() != meshData->bones.size())
+            return;
+
+        if (skinnedVertices.size() != meshData->vertices.size())
+            skinnedVertices = meshData->vertices;
+
+        skin(meshData->vertices.data(),
+             meshData->boneIndices.data(),
+             meshData->boneWeights.data(),
+             bonePalette.data(),
+             skinnedVertices.data(),
+             skinnedVertices.size());
+
+        skinningPending = false;
+        verticesDirty = true;
+    }
+
+    void SkinnedMeshRenderer::updateSkinningMode()
+    {
+        if (!meshData) return;
+
+        const auto skinnedShader = engine->getCache().getShader(shaderSkinnedTexture);
+        const auto textureShader = engine->getCache().getShader(shaderTexture);
+        const auto colorShader = engine->getCache().getShader(shaderColor);
+
+        const auto hasBuiltinShader = [textureShader, colorShader](const graphics::Material* primitiveMaterial) noexcept {
+            return !primitiveMaterial ||
+                primitiveMaterial->shader == textureShader ||
+                primitiveMaterial->shader == colorShader;
+        };
+
+        // materials with custom shaders get vertices that are skinned on the CPU
+        gpuSkinning = skinnedShader &&
+            meshData->bones.size() <= SkinnedMeshData::maxShaderBones &&
+            hasBuiltinShader(material.get()) &&
+            std::all_of(meshData->primitives.begin(), meshData->primitives.end(), [&hasBuiltinShader](const auto& primitive) {
+                return hasBuiltinShader(primitive.material);
+            });
+
+        if (gpuSkinning || meshData->bones.empty())
+        {
+            skinnedVertices.clear();
+            skinnedVertexBuffer = graphics::Buffer();
+        }
+        else if (skinnedVertexBuffer.getSize() != getVectorSize(meshData->vertices))
+        {
+            skinnedVertices = meshData->vertices;
+            skinnedVertexBuffer = graphics::Buffer(*engine->getGraphics(),
+                                                   graphics::BufferType::vertex,
+                                                   graphics::Flags::dynamic,
+                                                   skinnedVertices.data(),
+                                                   static_cast<std::uint32_t>(getVectorSize(skinnedVertices)));
+        }
+
+        poseDirty = true;
     }
 
     void SkinnedMeshRenderer::draw(const Matrix4F& transformMatrix,
@@ -30,5 +507,101 @@ namespace ouzel::scene
                         opacity,
                         renderViewProjection,
                         wireframe);
+
+        if (!meshData) return;
+
+        const bool skinned = !meshData->bones.empty() && !bonePalette.empty();
+        const bool cpuSkinned = skinned && !gpuSkinning;
+
+        if (cpuSkinned)
+        {
+            // the mesh was hidden when the pose was updated
+            if (skinningPending) skinVertices();
+
+            if (verticesDirty)
+            {
+                skinnedVertexBuffer.setData(skinnedVertices.data(),
+                                            static_cast<std::uint32_t>(getVectorSize(skinnedVertices)));
+                verticesDirty = false;
+            }
+        }
+
+        const auto modelViewProj = renderViewProjection * transformMatrix;
+
+        std::vector<std::vector<float>> vertexShaderConstants(skinned && gpuSkinning ? 2 : 1);
+        vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
+
+        if (skinned && gpuSkinning)
+        {
+            auto& bones = vertexShaderConstants[1];
+            bones.reserve(bonePalette.size() * 16);
+            for (const auto& boneMatrix : bonePalette)
+                bones.insert(bones.end(), std::begin(boneMatrix.m), std::end(boneMatrix.m));
+        }
+
+        const std::size_t vertexBuffer = cpuSkinned ? skinnedVertexBuffer.getResource() : meshData->vertexBuffer.getResource();
+        const auto skinnedShader = engine->getCache().getShader(shaderSkinnedTexture);
+
+        const auto drawPrimitive = [&](const graphics::Material* primitiveMaterial,
+                                       std::uint32_t startIndex,
+                                       std::uint32_t indexCount) {
+            if (!primitiveMaterial || indexCount == 0) return;
+
+            const float colorVector[] = {
+                primitiveMaterial->diffuseColor.normR(),
+                primitiveMaterial->diffuseColor.normG(),
+                primitiveMaterial->diffuseColor.normB(),
+                primitiveMaterial->diffuseColor.normA() * opacity * primitiveMaterial->opacity
+            };
+
+            std::vector<std::vector<float>> fragmentShaderConstants(1);
+            fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+
+            std::vector<std::size_t> textures;
+            for (const std::shared_ptr<graphics::Texture>& texture : primitiveMaterial->textures)
+                textures.push_back(texture ? texture->getResource() : 0);
+
+            const graphics::Shader* shader = primitiveMaterial->shader;
+
+            if (skinned && gpuSkinning)
+            {
+                // the skinning shader samples a texture, so the color materials use a white pixel
+                shader = skinnedShader;
+                if (!textures.empty() && !textures[0] && whitePixelTexture)
+                    textures[0] = whitePixelTexture->getResource();
+            }
+
+            engine->getGraphics()->setPipelineState(primitiveMaterial->blendState->getResource(),
+                                                    shader->getResource(),
+                                                    primitiveMaterial->cullMode,
+                                                    wireframe ? graphics::FillMode::wireframe : graphics::FillMode::solid);
+            engine->getGraphics()->setShaderConstants(fragmentShaderConstants,
+                                                      vertexShaderConstants);
+            engine->getGraphics()->setTextures(textures);
+
+            if (skinned && gpuSkinning)
+                engine->getGraphics()->drawSkinned(meshData->indexBuffer.getResource(),
+                                                   indexCount,
+                                                   meshData->indexSize,
+                                                   vertexBuffer,
+                                                   meshData->skinBuffer.getResource(),
+                                                   graphics::DrawMode::triangleList,
+                                                   startIndex);
+            else
+                engine->getGraphics()->draw(meshData->indexBuffer.getResource(),
+                                            indexCount,
+                                            meshData->indexSize,
+                                            vertexBuffer,
+                                            graphics::DrawMode::triangleList,
+                                            startIndex);
+        };
+
+        if (meshData->primitives.empty())
+            drawPrimitive(material.get(), 0, static_cast<std::uint32_t>(meshData->indices.size()));
+        else
+            for (const auto& primitive : meshData->primitives)
+                drawPrimitive(material ? material.get() : primitive.material,
+                              primitive.startIndex,
+                              primitive.indexCount);
     }
 }
@@ -3,20 +3,79 @@
 #ifndef OUZEL_SCENE_SKINNEDMESHRENDERER_HPP
 #define OUZEL_SCENE_SKINNEDMESHRENDERER_HPP
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 #include "../scene/Component.hpp"
+#include "../graphics/Buffer.hpp"
 #include "../graphics/Material.hpp"
+#include "../graphics/Vertex.hpp"
+#include "../math/Matrix.hpp"
+#include "../math/Quaternion.hpp"
 
 namespace ouzel::scene
 {
     class SkinnedMeshData final
     {
     public:
+        static constexpr std::size_t noParent = static_cast<std::size_t>(-1);
+        static constexpr std::size_t maxBoneInfluences = 4;
+        static constexpr std::size_t maxShaderBones = 60; // the size of the bone array in the skinning shaders
+
         struct Bone final
         {
-            Bone* parent = nullptr;
+            std::string name;
+            std::size_t parent = noParent;
             Vector3F position;
-            QuaternionF rotation;
+            QuaternionF rotation = QuaternionF::identity();
+            Vector3F scale{1.0F, 1.0F, 1.0F};
+            Matrix4F inverseBindMatrix = Matrix4F::identity();
+        };
+
+        struct Channel final
+        {
+            enum class Path
+            {
+                translation,
+                rotation,
+                scale
+            };
+
+            enum class Interpolation
+            {
+                step,
+                linear
+            };
+
+            std::size_t bone = 0;
+            Path path = Path::translation;
+            Interpolation interpolation = Interpolation::linear;
+            std::vector<float> times;
+            std::vector<Vector4F> values; // translation and scale use the first three components
+        };
+
+        struct Animation final
+        {
+            std::string name;
+            float duration = 0.0F;
+            std::vector<Channel> channels;
+        };
+
+        struct BonePose final
+        {
+            Vector3F position;
+            QuaternionF rotation = QuaternionF::identity();
+            Vector3F scale{1.0F, 1.0F, 1.0F};
+        };
+
+        struct Primitive final
+        {
+            std::uint32_t startIndex = 0;
+            std::uint32_t indexCount = 0;
+            const graphics::Material* material = nullptr;
         };
 
         SkinnedMeshData() = default;
@@ -27,17 +86,49 @@ namespace ouzel::scene
         {
         }
 
+        // Sorts the bones, packs the bone influences into the skin stream and uploads
+        // the bind pose vertices, the skin stream and the indices to the GPU
+        void initBuffers();
+
+        const Animation* getAnimation(const std::string& name) const noexcept;
+
+        // Samples the animation (the bind pose if it is null) and calculates the skinning matrix of every bone
+        // The poses and the global transforms are scratch space, so that they can be reused between calls
+        void calculateBonePalette(const Animation* animation,
+                                  float time,
+                                  std::vector<BonePose>& poses,
+                                  std::vector<Matrix4F>& globalTransforms,
+                                  std::vector<Matrix4F>& palette) const;
+
         Box3F boundingBox;
         std::shared_ptr<graphics::Material> material;
+
+        std::vector<graphics::Vertex> vertices; // bind pose
+        std::vector<std::uint32_t> indices;
+        std::vector<std::array<std::uint16_t, maxBoneInfluences>> boneIndices;
+        std::vector<Vector4F> boneWeights;
+        std::vector<Bone> bones;
+        std::vector<std::size_t> boneOrder; // parents come before their children
+        std::vector<Animation> animations;
+        std::vector<Primitive> primitives;
+
+        std::uint32_t indexSize = 0;
+        graphics::Buffer indexBuffer;
+        graphics::Buffer vertexBuffer;
+        graphics::Buffer skinBuffer; // SkinVertex stream, only used by the GPU skinning
     };
 
+    class SkinningSystem;
+
     class SkinnedMeshRenderer: public Component
     {
+        friend SkinningSystem;
     public:
         SkinnedMeshRenderer();
-        explicit SkinnedMeshRenderer(const SkinnedMeshData& meshData);
+        explicit SkinnedMeshRenderer(const SkinnedMeshData& initMeshData);
+        ~SkinnedMeshRenderer() override;
 
-        void init(const SkinnedMeshData& meshData);
+        void init(const SkinnedMeshData& initMeshData);
 
         void draw(const Matrix4F& transformMatrix,
                   float opacity,
@@ -45,11 +136,54 @@ namespace ouzel::scene
                   bool wireframe) override;
 
         auto& getMaterial() const noexcept { return material; }
-        void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
+        void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial);
+
+        // Returns false if the mesh has no animation with the name
+        bool playAnimation(const std::string& name, bool loop = true);
+        void stopAnimation();
+        auto isPlaying() const noexcept { return playing; }
+
+        auto getAnimationTime() const noexcept { return animationTime; }
+        void setAnimationTime(float newAnimationTime);
+
+        auto getAnimationSpeed() const noexcept { return animationSpeed; }
+        void setAnimationSpeed(float newAnimationSpeed) { animationSpeed = newAnimationSpeed; }
+
+        // Returns true if the vertices are skinned in the vertex shader
+        auto isGpuSkinned() const noexcept { return gpuSkinning; }
+
+        auto& getBonePalette() const noexcept { return bonePalette; }
 
     private:
+        // Called by the skinning system, possibly on a worker thread
+        void updatePose(float delta);
+        void skinVertices();
+
+        void updateSkinningMode();
+
+        SkinningSystem* skinningSystem = nullptr;
+        std::size_t skinningIndex = 0;
+
+        const SkinnedMeshData* meshData = nullptr;
         std::shared_ptr<graphics::Material> material;
         std::shared_ptr<graphics::Texture> whitePixelTexture;
+
+        const SkinnedMeshData::Animation* animation = nullptr;
+        float animationTime = 0.0F;
+        float animationSpeed = 1.0F;
+        bool looping = false;
+        bool playing = false;
+        bool poseDirty = true;
+
+        std::vector<SkinnedMeshData::BonePose> bonePoses;
+        std::vector<Matrix4F> globalTransforms;
+        std::vector<Matrix4F> bonePalette;
+
+        bool gpuSkinning = false;
+        bool skinningPending = false;
+        bool verticesDirty = false;
+        std::vector<graphics::Vertex> skinnedVertices;
+        graphics::Buffer skinnedVertexBuffer;
     };
 }
 
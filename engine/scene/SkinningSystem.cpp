@@ -0,0 +1,75 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include "SkinningSystem.hpp"
+#include "SkinnedMeshRenderer.hpp"
+#include "../core/Engine.hpp"
+
+namespace ouzel::scene
+{
+    namespace
+    {
+        // skinning a single mesh is too little work for a job
+        constexpr std::size_t batchSize = 4;
+
+        // skinning a few meshes is cheaper than waking up the workers
+        constexpr std::size_t minParallelRenderers = batchSize * 2;
+    }
+
+    SkinningSystem::SkinningSystem()
+    {
+        updateHandler.updateHandler = [this](const UpdateEvent& event) {
+            update(event.delta);
+            return false;
+        };
+    }
+
+    SkinningSystem::~SkinningSystem()
+    {
+        for (SkinnedMeshRenderer* renderer : renderers)
+            renderer->skinningSystem = nullptr;
+    }
+
+    void SkinningSystem::addRenderer(SkinnedMeshRenderer& renderer)
+    {
+        if (renderer.skinningSystem == this) return;
+        if (renderer.skinningSystem) renderer.skinningSystem->removeRenderer(renderer);
+
+        // does nothing if the handler is already added
+        engine->getEventDispatcher().addEventHandler(updateHandler);
+
+        renderer.skinningSystem = this;
+        renderer.skinningIndex = renderers.size();
+        renderers.push_back(&renderer);
+    }
+
+    void SkinningSystem::removeRenderer(SkinnedMeshRenderer& renderer)
+    {
+        if (renderer.skinningSystem != this) return;
+
+        SkinnedMeshRenderer* last = renderers.back();
+        last->skinningIndex = renderer.skinningIndex;
+        renderers[renderer.skinningIndex] = last;
+        renderers.pop_back();
+
+        renderer.skinningSystem = nullptr;
+    }
+
+    void SkinningSystem::update(float delta)
+    {
+        if (renderers.empty()) return;
+
+        auto& jobSystem = engine->getJobSystem();
+
+        if (jobSystem.getWorkerCount() == 0 || renderers.size() < minParallelRenderers)
+        {
+            for (SkinnedMeshRenderer* renderer : renderers)
+                renderer->updatePose(delta);
+            return;
+        }
+
+        jobSystem.parallelFor(0, renderers.size(), [this, delta](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i)
+                renderers[i]->updatePose(delta);
+        }, batchSize);
+    }
+}
@@ -0,0 +1,39 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_SKINNINGSYSTEM_HPP
+#define OUZEL_SCENE_SKINNINGSYSTEM_HPP
+
+#include <vector>
+#include "../events/EventHandler.hpp"
+
+namespace ouzel::scene
+{
+    class SkinnedMeshRenderer;
+
+    // Samples the animations and skins the vertices of all of the skinned mesh renderers once per update
+    // The renderers are independent of each other, so they are split between the job system's workers
+    class SkinningSystem final
+    {
+    public:
+        SkinningSystem();
+        ~SkinningSystem();
+
+        SkinningSystem(const SkinningSystem&) = delete;
+        SkinningSystem& operator=(const SkinningSystem&) = delete;
+
+        SkinningSystem(SkinningSystem&&) = delete;
+        SkinningSystem& operator=(SkinningSystem&&) = delete;
+
+        void addRenderer(SkinnedMeshRenderer& renderer);
+        void removeRenderer(SkinnedMeshRenderer& renderer);
+
+        void update(float delta);
+
+    private:
+        EventHandler updateHandler;
+
+        std::vector<SkinnedMeshRenderer*> renderers;
+    };
+}
+
+#endif // OUZEL_SCENE_SKINNINGSYSTEM_HPP
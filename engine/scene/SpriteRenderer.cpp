@@ -12,6 +12,19 @@
 
 namespace ouzel::scene
 {
+    namespace
+    {
+        constexpr std::uint16_t quadIndices[] = {0, 1, 2, 1, 3, 2};
+
+        const SpriteData::Animation emptyAnimation;
+
+        const std::shared_ptr<const SpriteData>& getEmptySpriteData()
+        {
+            static const auto emptySpriteData = std::make_shared<const SpriteData>();
+            return emptySpriteData;
+        }
+    }
+
     SpriteData::Frame::Frame(const std::string& frameName,
                              const Size2F& textureSize,
                              const RectF& frameRectangle,
@@ -21,8 +34,7 @@ namespace ouzel::scene
                              const Vector2F& pivot):
         name(frameName)
     {
-        const std::vector<std::uint16_t> indices = {0, 1, 2, 1, 3, 2};
-        indexCount = static_cast<std::uint32_t>(indices.size());
+        indexCount = static_cast<std::uint32_t>(std::size(quadIndices));
 
         Vector2F textCoords[4];
         const Vector2F finalOffset(-sourceSize.v[0] * pivot.v[0] + sourceOffset.v[0],
@@ -55,7 +67,7 @@ namespace ouzel::scene
             textCoords[3] = Vector2F(rightBottom.v[0], rightBottom.v[1]);
         }
 
-        const std::vector<graphics::Vertex> vertices{
+        vertices = {
             graphics::Vertex(Vector3F{finalOffset.v[0], finalOffset.v[1], 0.0F}, Color::white(),
                              textCoords[0], Vector3F{0.0F, 0.0F, -1.0F}),
             graphics::Vertex(Vector3F{finalOffset.v[0] + frameRectangle.size.v[0], finalOffset.v[1], 0.0F}, Color::white(),
@@ -68,60 +80,108 @@ namespace ouzel::scene
 
         boundingBox.min = finalOffset;
         boundingBox.max = finalOffset + Vector2F(frameRectangle.size.v[0], frameRectangle.size.v[1]);
-
-        indexBuffer = std::make_unique<graphics::Buffer>(*engine->getGraphics(),
-                                                         graphics::BufferType::index,
-                                                         graphics::Flags::none,
-                                                         indices.data(),
-                                                         static_cast<std::uint32_t>(getVectorSize(indices)));
-
-        vertexBuffer = std::make_unique<graphics::Buffer>(*engine->getGraphics(),
-                                                          graphics::BufferType::vertex,
-                                                          graphics::Flags::none,
-                                                          vertices.data(),
-                                                          static_cast<std::uint32_t>(getVectorSize(vertices)));
     }
 
     SpriteData::Frame::Frame(const std::string& frameName,
-                             const std::vector<std::uint16_t>& indices,
-                             const std::vector<graphics::Vertex>& vertices):
-        name(frameName)
+                             const std::vector<std::uint16_t>& initIndices,
+                             const std::vector<graphics::Vertex>& initVertices):
+        Frame(frameName,
+              initIndices.data(), static_cast<std::uint32_t>(initIndices.size()),
+              initVertices.data(), static_cast<std::uint32_t>(initVertices.size()))
     {
-        indexCount = static_cast<std::uint32_t>(indices.size());
+    }
 
+    SpriteData::Frame::Frame(const std::string& frameName,
+                             const std::uint16_t* initIndices,
+                             std::uint32_t initIndexCount,
+                             const graphics::Vertex* initVertices,
+                             std::uint32_t vertexCount):
+        name(frameName),
+        indexCount(initIndexCount),
+        indices(initIndices, initIndices + initIndexCount),
+        vertices(initVertices, initVertices + vertexCount)
+    {
         for (const graphics::Vertex& vertex : vertices)
             boundingBox.insertPoint(Vector2F(vertex.position));
-
-        indexBuffer = std::make_unique<graphics::Buffer>(*engine->getGraphics(),
-                                                         graphics::BufferType::index,
-                                                         graphics::Flags::none,
-                                                         indices.data(),
-                                                         static_cast<std::uint32_t>(getVectorSize(indices)));
-
-        vertexBuffer = std::make_unique<graphics::Buffer>(*engine->getGraphics(),
-                                                          graphics::BufferType::vertex,
-                                                          graphics::Flags::none,
-                                                          vertices.data(),
-                                                          static_cast<std::uint32_t>(getVectorSize(vertices)));
     }
 
     SpriteData::Frame::Frame(const std::string& frameName,
-                             const std::vector<std::uint16_t>& indices,
-                             const std::vector<graphics::Vertex>& vertices,
+                             const std::vector<std::uint16_t>& initIndices,
+                             const std::vector<graphics::Vertex>& initVertices,
                              const RectF& frameRectangle,
                              const Size2F& sourceSize,
                              const Vector2F& sourceOffset,
                              const Vector2F& pivot):
-        name(frameName)
+        name(frameName),
+        indexCount(static_cast<std::uint32_t>(initIndices.size())),
+        indices(initIndices),
+        vertices(initVertices)
     {
-        indexCount = static_cast<std::uint32_t>(indices.size());
-
         for (const graphics::Vertex& vertex : vertices)
             boundingBox.insertPoint(Vector2F(vertex.position));
 
         // TODO: fix
         const Vector2F finalOffset(-sourceSize.v[0] * pivot.v[0] + sourceOffset.v[0],
                                    -sourceSize.v[1] * pivot.v[1] + (sourceSize.v[1] - frameRectangle.size.v[1] - sourceOffset.v[1]));
+    }
+
+    SpriteData::SpriteData(const std::shared_ptr<graphics::Texture>& initTexture,
+                           std::uint32_t spritesX, std::uint32_t spritesY,
+                           const Vector2F& pivot,
+                           const std::string& frameName):
+        texture(initTexture)
+    {
+        if (spritesX == 0) spritesX = 1;
+        if (spritesY == 0) spritesY = 1;
+
+        const Size2F textureSize(static_cast<float>(texture->getSize().v[0]),
+                                 static_cast<float>(texture->getSize().v[1]));
+
+        const auto spriteSize = Size2F(textureSize.v[0] / spritesX,
+                                       textureSize.v[1] / spritesY);
+
+        Animation animation;
+        animation.frames.reserve(spritesX * spritesY);
+
+        for (std::uint32_t x = 0; x < spritesX; ++x)
+        {
+            for (std::uint32_t y = 0; y < spritesY; ++y)
+            {
+                const RectF rectangle(spriteSize.v[0] * x,
+                                      spriteSize.v[1] * y,
+                                      spriteSize.v[0],
+                                      spriteSize.v[1]);
+                animation.frames.emplace_back(frameName, textureSize, rectangle, false, spriteSize, Vector2F(), pivot);
+            }
+        }
+
+        animations[""] = std::move(animation);
+    }
+
+    void SpriteData::createBuffers()
+    {
+        if (vertexBuffer) return;
+
+        std::vector<std::uint16_t> indices(std::begin(quadIndices), std::end(quadIndices));
+        std::vector<graphics::Vertex> vertices;
+
+        for (auto& animation : animations)
+            for (Frame& frame : animation.second.frames)
+            {
+                frame.baseVertex = static_cast<std::uint32_t>(vertices.size());
+                vertices.insert(vertices.end(), frame.vertices.begin(), frame.vertices.end());
+
+                if (!frame.indices.empty())
+                {
+                    frame.startIndex = static_cast<std::uint32_t>(indices.size());
+                    indices.insert(indices.end(), frame.indices.begin(), frame.indices.end());
+                }
+
+                frame.indices = std::vector<std::uint16_t>();
+                frame.vertices = std::vector<graphics::Vertex>();
+            }
+
+        if (vertices.empty()) return;
 
         indexBuffer = std::make_shared<graphics::Buffer>(*engine->getGraphics(),
                                                          graphics::BufferType::index,
@@ -136,20 +196,35 @@ namespace ouzel::scene
                                                           static_cast<std::uint32_t>(getVectorSize(vertices)));
     }
 
-    SpriteRenderer::SpriteRenderer()
+    std::shared_ptr<const graphics::Material> SpriteData::createMaterial() const
+    {
+        auto result = std::make_shared<graphics::Material>();
+        result->cullMode = graphics::CullMode::none;
+        result->blendState = blendState ? blendState : engine->getCache().getBlendState(blendAlpha);
+        result->shader = shader ? shader : engine->getCache().getShader(shaderTexture);
+        result->textures[0] = texture;
+        return result;
+    }
+
+    SpriteRenderer::SpriteRenderer():
+        spriteData(getEmptySpriteData())
     {
         updateHandler.updateHandler = [this](const UpdateEvent& event) {
             update(event.delta);
             return false;
         };
+    }
 
-        currentAnimation = animationQueue.end();
+    SpriteRenderer::SpriteRenderer(const SpriteData& initSpriteData):
+        SpriteRenderer()
+    {
+        init(initSpriteData);
     }
 
-    SpriteRenderer::SpriteRenderer(const SpriteData& spriteData):
+    SpriteRenderer::SpriteRenderer(std::shared_ptr<const SpriteData> initSpriteData):
         SpriteRenderer()
     {
-        init(spriteData);
+        init(std::move(initSpriteData));
     }
 
     SpriteRenderer::SpriteRenderer(const std::string& filename):
@@ -166,97 +241,41 @@ namespace ouzel::scene
         init(texture, spritesX, spritesY, pivot);
     }
 
-    void SpriteRenderer::init(const SpriteData& spriteData)
+    void SpriteRenderer::init(const SpriteData& newSpriteData)
     {
-        material = std::make_shared<graphics::Material>();
-        material->cullMode = graphics::CullMode::none;
-        material->blendState = spriteData.blendState ? spriteData.blendState : engine->getCache().getBlendState(blendAlpha);
-        material->shader = spriteData.shader ? spriteData.shader : engine->getCache().getShader(shaderTexture);
-        material->textures[0] = spriteData.texture;
+        auto sharedSpriteData = std::make_shared<SpriteData>(newSpriteData);
+        sharedSpriteData->createBuffers();
+        init(std::move(sharedSpriteData));
+    }
 
-        animations = spriteData.animations;
+    void SpriteRenderer::init(std::shared_ptr<const SpriteData> newSpriteData)
+    {
+        spriteData = newSpriteData ? std::move(newSpriteData) : getEmptySpriteData();
+        material = spriteData->material ? spriteData->material : spriteData->createMaterial();
+        materialOverride.reset();
 
-        animationQueue.clear();
-        animationQueue.push_back({&animations[""], false});
-        currentAnimation = animationQueue.begin();
+        firstAnimation = {&findAnimation(""), false};
+        queuedAnimations.clear();
+        currentAnimation = 0;
 
         updateBoundingBox();
     }
 
     void SpriteRenderer::init(const std::string& filename)
     {
-        material = std::make_shared<graphics::Material>();
-        material->cullMode = graphics::CullMode::none;
-        material->shader = engine->getCache().getShader(shaderTexture);
-        material->blendState = engine->getCache().getBlendState(blendAlpha);
-
-        if (const auto spriteData = engine->getCache().getSpriteData(filename))
-        {
-            material->textures[0] = spriteData->texture;
-
-            animations = spriteData->animations;
-        }
+        if (auto newSpriteData = engine->getCache().getSpriteData(filename))
+            init(std::move(newSpriteData));
         else if (auto texture = engine->getCache().getTexture(filename))
-        {
-            material->textures[0] = texture;
-
-            SpriteData::Animation animation;
-
-            const Size2F size(static_cast<float>(texture->getSize().v[0]),
-                              static_cast<float>(texture->getSize().v[1]));
-
-            const RectF rectangle(0.0F, 0.0F, size.v[0], size.v[1]);
-            animation.frames.emplace_back("", size, rectangle, false, size, Vector2F(), Vector2F{0.5F, 0.5F});
-
-            animations[""] = std::move(animation);
-        }
-
-        animationQueue.clear();
-        animationQueue.push_back({&animations[""], false});
-        currentAnimation = animationQueue.begin();
-
-        updateBoundingBox();
+            init(texture);
+        else
+            init(getEmptySpriteData());
     }
 
     void SpriteRenderer::init(std::shared_ptr<graphics::Texture> newTexture,
                               std::uint32_t spritesX, std::uint32_t spritesY,
                               const Vector2F& pivot)
     {
-        material = std::make_shared<graphics::Material>();
-        material->cullMode = graphics::CullMode::none;
-        material->shader = engine->getCache().getShader(shaderTexture);
-        material->blendState = engine->getCache().getBlendState(blendAlpha);
-        material->textures[0] = newTexture;
-        animations.clear();
-
-        const Size2F size(static_cast<float>(newTexture->getSize().v[0]),
-                          static_cast<float>(newTexture->getSize().v[1]));
-
-        auto spriteSize = Size2F(size.v[0] / spritesX,
-                                 size.v[1] / spritesY);
-
-        SpriteData::Animation animation;
-        animation.frames.reserve(spritesX * spritesY);
-
-        for (std::uint32_t x = 0; x < spritesX; ++x)
-        {
-            for (std::uint32_t y = 0; y < spritesY; ++y)
-            {
-                const RectF rectangle(spriteSize.v[0] * x,
-                                      spriteSize.v[1] * y,
-                                      spriteSize.v[0],
-                                      spriteSize.v[1]);
-                animation.frames.emplace_back("", size, rectangle, false, spriteSize, Vector2F(), pivot);
-            }
-        }
-
-        animations[""] = std::move(animation);
-
-        animationQueue.clear();
-        animationQueue.push_back({&animations[""], false});
-        currentAnimation = animationQueue.begin();
-
-        updateBoundingBox();
+        init(engine->getCache().getSpriteData(newTexture, spritesX, spritesY, pivot));
     }
 
     void SpriteRenderer::update(float delta)
@@ -265,9 +284,10 @@ namespace ouzel::scene
         {
             currentTime += delta;
 
-            for (; currentAnimation != animationQueue.end(); ++currentAnimation)
+            for (; currentAnimation < getQueueSize(); ++currentAnimation)
             {
-                const float length = currentAnimation->animation->frames.size() * currentAnimation->animation->frameInterval;
+                const auto& queuedAnimation = getQueuedAnimation(currentAnimation);
+                const float length = queuedAnimation.animation->frames.size() * queuedAnimation.animation->frameInterval;
 
                 if (length > 0.0F)
                 {
@@ -275,30 +295,30 @@ namespace ouzel::scene
                         break;
                     else
                     {
-                        if (currentAnimation->repeat)
+                        if (queuedAnimation.repeat)
                         {
                             currentTime = std::fmod(currentTime, length);
 
-                            auto resetEvent = std::make_unique<AnimationEvent>();
-                            resetEvent->type = Event::Type::animationReset;
-                            resetEvent->component = this;
-                            resetEvent->name = currentAnimation->animation->name;
-                            engine->getEventDispatcher().dispatchEvent(std::move(resetEvent));
+                            AnimationEvent resetEvent;
+                            resetEvent.type = Event::Type::animationReset;
+                            resetEvent.component = this;
+                            resetEvent.name = queuedAnimation.animation->name;
+                            engine->getEventDispatcher().dispatchEvent(resetEvent);
                             break;
                         }
                         else
                         {
                             if (running)
                             {
-                                auto finishEvent = std::make_unique<AnimationEvent>();
-                                finishEvent->type = Event::Type::animationFinish;
-                                finishEvent->component = this;
-                                finishEvent->name = currentAnimation->animation->name;
-                                engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                                AnimationEvent finishEvent;
+                                finishEvent.type = Event::Type::animationFinish;
+                                finishEvent.component = this;
+                                finishEvent.name = queuedAnimation.animation->name;
+                                engine->getEventDispatcher().dispatchEvent(finishEvent);
                             }
 
-                            auto nextAnimation = std::next(currentAnimation);
-                            if (nextAnimation == animationQueue.end())
+                            const auto nextAnimation = currentAnimation + 1;
+                            if (nextAnimation == getQueueSize())
                             {
                                 currentTime = length;
                                 running = false;
@@ -308,11 +328,11 @@ namespace ouzel::scene
                             {
                                 currentTime -= length;
 
-                                auto startEvent = std::make_unique<AnimationEvent>();
-                                startEvent->type = Event::Type::animationStart;
-                                startEvent->component = this;
-                                startEvent->name = nextAnimation->animation->name;
-                                engine->getEventDispatcher().dispatchEvent(std::move(startEvent));
+                                AnimationEvent startEvent;
+                                startEvent.type = Event::Type::animationStart;
+                                startEvent.component = this;
+                                startEvent.name = getQueuedAnimation(nextAnimation).animation->name;
+                                engine->getEventDispatcher().dispatchEvent(startEvent);
                             }
                         }
                     }
@@ -333,14 +353,17 @@ namespace ouzel::scene
                         renderViewProjection,
                         wireframe);
 
-        if (currentAnimation != animationQueue.end() &&
-            currentAnimation->animation->frameInterval > 0.0F &&
-            !currentAnimation->animation->frames.empty() &&
+        const auto animation = getAnimation();
+
+        if (animation &&
+            animation->frameInterval > 0.0F &&
+            !animation->frames.empty() &&
+            spriteData->vertexBuffer &&
             material)
         {
-            auto currentFrame = static_cast<std::size_t>(currentTime / currentAnimation->animation->frameInterval);
-            if (currentFrame >= currentAnimation->animation->frames.size())
-                currentFrame = currentAnimation->animation->frames.size() - 1;
+            auto currentFrame = static_cast<std::size_t>(currentTime / animation->frameInterval);
+            if (currentFrame >= animation->frames.size())
+                currentFrame = animation->frames.size() - 1;
 
             const auto modelViewProj = renderViewProjection * transformMatrix * offsetMatrix;
             const float colorVector[] = {
@@ -369,15 +392,40 @@ namespace ouzel::scene
                                                       vertexShaderConstants);
             engine->getGraphics()->setTextures(textures);
 
-            const auto& frame = currentAnimation->animation->frames[currentFrame];
+            const auto& frame = animation->frames[currentFrame];
 
-            engine->getGraphics()->draw(frame.getIndexBuffer()->getResource(),
+            engine->getGraphics()->draw(spriteData->indexBuffer->getResource(),
                                         frame.getIndexCount(),
                                         sizeof(std::uint16_t),
-                                        frame.getVertexBuffer()->getResource(),
+                                        spriteData->vertexBuffer->getResource(),
                                         graphics::DrawMode::triangleList,
-                                        0);
+                                        frame.getStartIndex(),
+                                        frame.getBaseVertex());
+        }
+    }
+
+    graphics::Material& SpriteRenderer::overrideMaterial()
+    {
+        if (!materialOverride)
+        {
+            auto newMaterial = std::make_shared<graphics::Material>();
+
+            if (material)
+            {
+                newMaterial->blendState = material->blendState;
+                newMaterial->shader = material->shader;
+                for (std::uint32_t i = 0; i < graphics::Material::textureLayers; ++i)
+                    newMaterial->textures[i] = material->textures[i];
+                newMaterial->cullMode = material->cullMode;
+                newMaterial->diffuseColor = material->diffuseColor;
+                newMaterial->opacity = material->opacity;
+            }
+
+            material = newMaterial;
+            materialOverride = std::move(newMaterial);
         }
+
+        return *materialOverride;
     }
 
     void SpriteRenderer::setOffset(const Vector2F& newOffset)
@@ -417,20 +465,24 @@ namespace ouzel::scene
         updateBoundingBox();
     }
 
+    const std::string& SpriteRenderer::getAnimationName() const noexcept
+    {
+        const auto animation = getAnimation();
+        return animation ? animation->name : emptyAnimation.name;
+    }
+
     bool SpriteRenderer::hasAnimation(const std::string& animation) const
     {
-        const auto i = animations.find(animation);
+        const auto i = spriteData->animations.find(animation);
 
-        return i != animations.end();
+        return i != spriteData->animations.end();
     }
 
     void SpriteRenderer::setAnimation(const std::string& newAnimation, bool repeat)
     {
-        animationQueue.clear();
-
-        const auto& animation = animations[newAnimation];
-        animationQueue.push_back({&animation, repeat});
-        currentAnimation = animationQueue.begin();
+        firstAnimation = {&findAnimation(newAnimation), repeat};
+        queuedAnimations.clear();
+        currentAnimation = 0;
         running = true;
 
         updateBoundingBox();
@@ -438,8 +490,11 @@ namespace ouzel::scene
 
     void SpriteRenderer::addAnimation(const std::string& newAnimation, bool repeat)
     {
-        const auto& animation = animations[newAnimation];
-        animationQueue.push_back({&animation, repeat});
+        if (firstAnimation.animation)
+            queuedAnimations.push_back({&findAnimation(newAnimation), repeat});
+        else
+            firstAnimation = {&findAnimation(newAnimation), repeat};
+
         running = true;
     }
 
@@ -447,8 +502,9 @@ namespace ouzel::scene
     {
         float totalTime = 0.0F;
 
-        for (const auto& queuedAnimation : animationQueue)
+        for (std::size_t i = 0; i < getQueueSize(); ++i)
         {
+            const auto& queuedAnimation = getQueuedAnimation(i);
             totalTime += queuedAnimation.animation->frames.size() * queuedAnimation.animation->frameInterval;
 
             if (queuedAnimation.repeat) break;
@@ -461,9 +517,10 @@ namespace ouzel::scene
     {
         currentTime = time;
 
-        for (currentAnimation = animationQueue.begin(); currentAnimation != animationQueue.end(); ++currentAnimation)
+        for (currentAnimation = 0; currentAnimation < getQueueSize(); ++currentAnimation)
         {
-            const float length = currentAnimation->animation->frames.size() * currentAnimation->animation->frameInterval;
+            const auto& queuedAnimation = getQueuedAnimation(currentAnimation);
+            const float length = queuedAnimation.animation->frames.size() * queuedAnimation.animation->frameInterval;
 
             if (length > 0.0F)
             {
@@ -471,12 +528,12 @@ namespace ouzel::scene
                     break;
                 else
                 {
-                    if (currentAnimation->repeat)
+                    if (queuedAnimation.repeat)
                     {
                         currentTime = std::fmod(currentTime, length);
                         break;
                     }
-                    else if (std::next(currentAnimation) == animationQueue.end())
+                    else if (currentAnimation + 1 == getQueueSize())
                     {
                         currentTime = length;
                         break;
@@ -490,19 +547,26 @@ namespace ouzel::scene
         running = true;
     }
 
+    const SpriteData::Animation& SpriteRenderer::findAnimation(const std::string& name) const
+    {
+        const auto i = spriteData->animations.find(name);
+        return i != spriteData->animations.end() ? i->second : emptyAnimation;
+    }
+
     void SpriteRenderer::updateBoundingBox()
     {
-        if (currentAnimation != animationQueue.end() &&
-            !currentAnimation->animation->frames.empty())
+        const auto animation = getAnimation();
+
+        if (animation && !animation->frames.empty())
         {
             std::size_t currentFrame = 0;
 
-            if (currentAnimation->animation->frameInterval >= 0.0F)
-                currentFrame = static_cast<std::size_t>(currentTime / currentAnimation->animation->frameInterval);
+            if (animation->frameInterval >= 0.0F)
+                currentFrame = static_cast<std::size_t>(currentTime / animation->frameInterval);
 
-            if (currentFrame >= currentAnimation->animation->frames.size()) currentFrame = currentAnimation->animation->frames.size() - 1;
+            if (currentFrame >= animation->frames.size()) currentFrame = animation->frames.size() - 1;
 
-            const auto& frame = currentAnimation->animation->frames[currentFrame];
+            const auto& frame = animation->frames[currentFrame];
 
             boundingBox = Box3F(frame.getBoundingBox());
             boundingBox.min.v[0] += offset.v[0];
@@ -3,7 +3,6 @@
 #ifndef OUZEL_SCENE_SPRITE_HPP
 #define OUZEL_SCENE_SPRITE_HPP
 
-#include <list>
 #include <map>
 #include <memory>
 #include <vector>
@@ -27,6 +26,7 @@ namespace ouzel::scene
     public:
         class Frame final
         {
+            friend SpriteData;
         public:
             Frame(const std::string& frameName,
                   const Size2F& textureSize,
@@ -40,6 +40,12 @@ namespace ouzel::scene
                   const std::vector<std::uint16_t>& indices,
                   const std::vector<graphics::Vertex>& vertices);
 
+            Frame(const std::string& frameName,
+                  const std::uint16_t* indices,
+                  std::uint32_t initIndexCount,
+                  const graphics::Vertex* vertices,
+                  std::uint32_t vertexCount);
+
             Frame(const std::string& frameName,
                   const std::vector<std::uint16_t>& indices,
                   const std::vector<graphics::Vertex>& vertices,
@@ -52,15 +58,19 @@ namespace ouzel::scene
 
             auto& getBoundingBox() const noexcept { return boundingBox; }
             auto getIndexCount() const noexcept { return indexCount; }
-            auto& getIndexBuffer() const noexcept { return indexBuffer; }
-            auto& getVertexBuffer() const noexcept { return vertexBuffer; }
+            auto getStartIndex() const noexcept { return startIndex; }
+            auto getBaseVertex() const noexcept { return baseVertex; }
 
         private:
             std::string name;
             Box2F boundingBox;
             std::uint32_t indexCount = 0;
-            std::shared_ptr<graphics::Buffer> indexBuffer;
-            std::shared_ptr<graphics::Buffer> vertexBuffer;
+            std::uint32_t startIndex = 0;
+            std::uint32_t baseVertex = 0;
+
+            // released after they are copied to the buffers of the sprite data
+            std::vector<std::uint16_t> indices; // empty for quads
+            std::vector<graphics::Vertex> vertices;
         };
 
         struct Animation final
@@ -70,23 +80,44 @@ namespace ouzel::scene
             float frameInterval = 0.1F;
         };
 
+        SpriteData() = default;
+
+        // Splits the texture into a grid of equally sized frames of the default animation
+        SpriteData(const std::shared_ptr<graphics::Texture>& initTexture,
+                   std::uint32_t spritesX, std::uint32_t spritesY,
+                   const Vector2F& pivot,
+                   const std::string& frameName = "");
+
+        // Packs the vertices of all the frames into one vertex buffer and their indices into one index buffer,
+        // which starts with the indices of a quad that are shared by all the rectangular frames
+        void createBuffers();
+
+        // Material with the texture, blend state and shader of the sprite, the default ones are used if not set
+        std::shared_ptr<const graphics::Material> createMaterial() const;
+
         std::map<std::string, Animation> animations;
         std::shared_ptr<graphics::Texture> texture;
         const graphics::BlendState* blendState = nullptr;
         const graphics::Shader* shader = nullptr;
+        std::shared_ptr<const graphics::Material> material; // shared by the sprite renderers of this sprite
+        std::shared_ptr<graphics::Buffer> indexBuffer;
+        std::shared_ptr<graphics::Buffer> vertexBuffer;
     };
 
     class SpriteRenderer: public Component
     {
     public:
         SpriteRenderer();
-        explicit SpriteRenderer(const SpriteData& spriteData);
+        explicit SpriteRenderer(const SpriteData& initSpriteData);
+        explicit SpriteRenderer(std::shared_ptr<const SpriteData> initSpriteData);
         explicit SpriteRenderer(const std::string& filename);
         explicit SpriteRenderer(std::shared_ptr<graphics::Texture> texture,
                                 std::uint32_t spritesX = 1, std::uint32_t spritesY = 1,
                                 const Vector2F& pivot = Vector2F{0.5F, 0.5F});
 
-        void init(const SpriteData& spriteData);
+        void init(const SpriteData& newSpriteData);
+        // The buffers of the shared sprite data have to be created already
+        void init(std::shared_ptr<const SpriteData> newSpriteData);
         void init(const std::string& filename);
         void init(std::shared_ptr<graphics::Texture> newTexture,
                   std::uint32_t spritesX = 1, std::uint32_t spritesY = 1,
@@ -99,8 +130,17 @@ namespace ouzel::scene
                   const Matrix4F& renderViewProjection,
                   bool wireframe) override;
 
+        auto& getSpriteData() const noexcept { return spriteData; }
+
         auto& getMaterial() const noexcept { return material; }
-        void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
+        void setMaterial(const std::shared_ptr<const graphics::Material>& newMaterial)
+        {
+            material = newMaterial;
+            materialOverride.reset();
+        }
+
+        // Returns the material of this renderer only, the shared material is copied on the first call
+        graphics::Material& overrideMaterial();
 
         auto& getOffset() const noexcept { return offset; }
         void setOffset(const Vector2F& newOffset);
@@ -110,9 +150,12 @@ namespace ouzel::scene
         void reset();
         auto isPlaying() const noexcept { return playing; }
 
-        auto& getAnimations() const noexcept { return animations; }
-        auto getAnimation() const noexcept { return currentAnimation->animation; }
-        auto& getAnimationName() const noexcept { return currentAnimation->animation->name; }
+        auto& getAnimations() const noexcept { return spriteData->animations; }
+        auto getAnimation() const noexcept
+        {
+            return currentAnimation < getQueueSize() ? getQueuedAnimation(currentAnimation).animation : nullptr;
+        }
+        const std::string& getAnimationName() const noexcept;
         bool hasAnimation(const std::string& animation) const;
         void setAnimation(const std::string& newAnimation, bool repeat = true);
         void addAnimation(const std::string& newAnimation, bool repeat = true);
@@ -120,19 +163,33 @@ namespace ouzel::scene
         void setAnimationTime(float time);
 
     private:
-        void updateBoundingBox();
-
-        std::shared_ptr<graphics::Material> material;
-        std::map<std::string, SpriteData::Animation> animations;
-
         struct QueuedAnimation final
         {
-            const SpriteData::Animation* animation;
-            bool repeat;
+            const SpriteData::Animation* animation = nullptr;
+            bool repeat = false;
         };
 
-        std::list<QueuedAnimation> animationQueue;
-        std::list<QueuedAnimation>::const_iterator currentAnimation;
+        std::size_t getQueueSize() const noexcept
+        {
+            return firstAnimation.animation ? queuedAnimations.size() + 1 : 0;
+        }
+
+        const QueuedAnimation& getQueuedAnimation(std::size_t index) const noexcept
+        {
+            return index ? queuedAnimations[index - 1] : firstAnimation;
+        }
+
+        const SpriteData::Animation& findAnimation(const std::string& name) const;
+        void updateBoundingBox();
+
+        std::shared_ptr<const SpriteData> spriteData;
+        std::shared_ptr<const graphics::Material> material;
+        std::shared_ptr<graphics::Material> materialOverride;
+
+        // the first animation is stored inline, so that spawning a sprite doesn't allocate the queue
+        QueuedAnimation firstAnimation;
+        std::vector<QueuedAnimation> queuedAnimations;
+        std::size_t currentAnimation = 0;
 
         Vector2F offset;
         Matrix4F offsetMatrix = Matrix4F::identity();
@@ -1,14 +1,17 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
 #include <limits>
+#include <stdexcept>
 #include "StaticMeshRenderer.hpp"
+#include "InstanceBatcher.hpp"
+#include "Layer.hpp"
 #include "../core/Engine.hpp"
 #include "../utils/Utils.hpp"
 
 namespace ouzel::scene
 {
     StaticMeshData::StaticMeshData(const Box3F& initBoundingBox,
-                                   const std::vector<std::uint32_t> indices,
+                                   const std::vector<std::uint32_t>& indices,
                                    const std::vector<graphics::Vertex>& vertices,
                                    const graphics::Material* initMaterial):
         boundingBox(initBoundingBox),
@@ -16,14 +19,9 @@ namespace ouzel::scene
     {
         indexCount = static_cast<std::uint32_t>(indices.size());
 
-        indexSize = sizeof(std::uint16_t);
-
-        for (const auto index : indices)
-            if (index > std::numeric_limits<std::uint16_t>::max())
-            {
-                indexSize = sizeof(std::uint32_t);
-                break;
-            }
+        // indices can't exceed the vertex count, so there is no need to scan them
+        indexSize = vertices.size() > std::numeric_limits<std::uint16_t>::max() + 1U ?
+            sizeof(std::uint32_t) : sizeof(std::uint16_t);
 
         if (indexSize == sizeof(std::uint16_t))
         {
@@ -53,6 +51,34 @@ namespace ouzel::scene
                                         static_cast<std::uint32_t>(getVectorSize(vertices)));
     }
 
+    StaticMeshData::StaticMeshData(const Box3F& initBoundingBox,
+                                   const void* indexData,
+                                   std::uint32_t initIndexSize,
+                                   std::uint32_t initIndexCount,
+                                   const graphics::Vertex* vertices,
+                                   std::uint32_t vertexCount,
+                                   const graphics::Material* initMaterial):
+        boundingBox(initBoundingBox),
+        material(initMaterial),
+        indexCount(initIndexCount),
+        indexSize(initIndexSize)
+    {
+        if (indexSize != sizeof(std::uint16_t) && indexSize != sizeof(std::uint32_t))
+            throw std::runtime_error("Invalid index size");
+
+        indexBuffer = graphics::Buffer(*engine->getGraphics(),
+                                       graphics::BufferType::index,
+                                       graphics::Flags::none,
+                                       indexData,
+                                       indexSize * indexCount);
+
+        vertexBuffer = graphics::Buffer(*engine->getGraphics(),
+                                        graphics::BufferType::vertex,
+                                        graphics::Flags::none,
+                                        vertices,
+                                        static_cast<std::uint32_t>(sizeof(graphics::Vertex) * vertexCount));
+    }
+
     StaticMeshRenderer::StaticMeshRenderer(const StaticMeshData& meshData)
     {
         init(meshData);
@@ -73,41 +99,28 @@ namespace ouzel::scene
                                   const Matrix4F& renderViewProjection,
                                   bool wireframe)
     {
-        Component::draw(transformMatrix,
-                        opacity,
-                        renderViewProjection,
-                        wireframe);
-
-        const auto modelViewProj = renderViewProjection * transformMatrix;
-        const float colorVector[] = {
-            material->diffuseColor.normR(),
-            material->diffuseColor.normG(),
-            material->diffuseColor.normB(),
-            material->diffuseColor.normA() * opacity * material->opacity
-        };
-
-        std::vector<std::vector<float>> fragmentShaderConstants(1);
-        fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-        std::vector<std::vector<float>> vertexShaderConstants(1);
-        vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
-
-        std::vector<std::size_t> textures;
-        for (const std::shared_ptr<graphics::Texture>& texture : material->textures)
-            textures.push_back(texture ? texture->getResource() : 0);
-
-        engine->getGraphics()->setPipelineState(material->blendState->getResource(),
-                                                material->shader->getResource(),
-                                                material->cullMode,
-                                                wireframe ? graphics::FillMode::wireframe : graphics::FillMode::solid);
-        engine->getGraphics()->setShaderConstants(fragmentShaderConstants,
-                                                  vertexShaderConstants);
-        engine->getGraphics()->setTextures(textures);
-        engine->getGraphics()->draw(indexBuffer->getResource(),
-                                    indexCount,
-                                    indexSize,
-                                    vertexBuffer->getResource(),
-                                    graphics::DrawMode::triangleList,
-                                    0);
+        // the layer merges the consecutive draws of the same mesh into a single instanced draw
+        if (layer)
+            layer->getInstanceBatcher().draw(*material,
+                                             indexBuffer->getResource(),
+                                             indexCount,
+                                             indexSize,
+                                             vertexBuffer->getResource(),
+                                             renderViewProjection * transformMatrix,
+                                             opacity,
+                                             wireframe);
+        else
+        {
+            InstanceBatcher instanceBatcher;
+            instanceBatcher.draw(*material,
+                                 indexBuffer->getResource(),
+                                 indexCount,
+                                 indexSize,
+                                 vertexBuffer->getResource(),
+                                 renderViewProjection * transformMatrix,
+                                 opacity,
+                                 wireframe);
+            instanceBatcher.flush();
+        }
     }
 }
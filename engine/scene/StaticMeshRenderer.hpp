@@ -16,9 +16,17 @@ namespace ouzel::scene
     public:
         StaticMeshData() = default;
         StaticMeshData(const Box3F& initBoundingBox,
-                       const std::vector<std::uint32_t> indices,
+                       const std::vector<std::uint32_t>& indices,
                        const std::vector<graphics::Vertex>& vertices,
                        const graphics::Material* initMaterial);
+        // Creates the buffers straight from the index and vertex data (e.g. cooked assets)
+        StaticMeshData(const Box3F& initBoundingBox,
+                       const void* indexData,
+                       std::uint32_t initIndexSize,
+                       std::uint32_t initIndexCount,
+                       const graphics::Vertex* vertices,
+                       std::uint32_t vertexCount,
+                       const graphics::Material* initMaterial);
 
         Box3F boundingBox;
         const graphics::Material* material = nullptr;
@@ -5,7 +5,6 @@
 #include "../core/Engine.hpp"
 #include "../graphics/Graphics.hpp"
 #include "../assets/Cache.hpp"
-#include "../utils/Utils.hpp"
 
 namespace ouzel::scene
 {
@@ -16,12 +15,6 @@ namespace ouzel::scene
                                const Vector2F& initTextAnchor):
         shader(engine->getCache().getShader(shaderTexture)),
         blendState(engine->getCache().getBlendState(blendAlpha)),
-        indexBuffer(*engine->getGraphics(),
-                    graphics::BufferType::index,
-                    graphics::Flags::dynamic),
-        vertexBuffer(*engine->getGraphics(),
-                     graphics::BufferType::vertex,
-                     graphics::Flags::dynamic),
         text(initText),
         fontSize(initFontSize),
         textAnchor(initTextAnchor),
@@ -65,13 +58,11 @@ namespace ouzel::scene
                         renderViewProjection,
                         wireframe);
 
-        if (needsMeshUpdate)
-        {
-            indexBuffer.setData(indices.data(), static_cast<std::uint32_t>(getVectorSize(indices)));
-            vertexBuffer.setData(vertices.data(), static_cast<std::uint32_t>(getVectorSize(vertices)));
+        if (indices.empty()) return;
 
-            needsMeshUpdate = false;
-        }
+        auto& transientGeometry = engine->getGraphics()->getTransientGeometry();
+        const auto startIndex = transientGeometry.addIndices(indices.data(), static_cast<std::uint32_t>(indices.size()));
+        const auto baseVertex = transientGeometry.addVertices(vertices.data(), static_cast<std::uint32_t>(vertices.size()));
 
         const auto modelViewProj = renderViewProjection * transformMatrix;
         const float colorVector[] = {color.normR(), color.normG(), color.normB(), color.normA() * opacity};
@@ -89,12 +80,13 @@ namespace ouzel::scene
         engine->getGraphics()->setShaderConstants(fragmentShaderConstants,
                                                   vertexShaderConstants);
         engine->getGraphics()->setTextures({wireframe ? whitePixelTexture->getResource() : texture ? texture->getResource() : 0U});
-        engine->getGraphics()->draw(indexBuffer.getResource(),
+        engine->getGraphics()->draw(transientGeometry.getIndexBuffer().getResource(),
                                     static_cast<std::uint32_t>(indices.size()),
                                     sizeof(std::uint16_t),
-                                    vertexBuffer.getResource(),
+                                    transientGeometry.getVertexBuffer().getResource(),
                                     graphics::DrawMode::triangleList,
-                                    0);
+                                    startIndex,
+                                    baseVertex);
     }
 
     void TextRenderer::setText(const std::string& newText)
@@ -116,7 +108,6 @@ namespace ouzel::scene
         if (font)
         {
             std::tie(indices, vertices, texture) = font->getRenderData(text, Color::white(), fontSize, textAnchor);
-            needsMeshUpdate = true;
 
             for (const graphics::Vertex& vertex : vertices)
                 boundingBox.insertPoint(vertex.position);
@@ -8,7 +8,6 @@
 #include "../math/Color.hpp"
 #include "../gui/BMFont.hpp"
 #include "../graphics/BlendState.hpp"
-#include "../graphics/Buffer.hpp"
 #include "../graphics/Shader.hpp"
 #include "../graphics/Texture.hpp"
 
@@ -60,9 +59,6 @@ namespace ouzel::scene
         const graphics::Shader* shader = nullptr;
         const graphics::BlendState* blendState = nullptr;
 
-        graphics::Buffer indexBuffer;
-        graphics::Buffer vertexBuffer;
-
         std::shared_ptr<graphics::Texture> texture;
         std::shared_ptr<graphics::Texture> whitePixelTexture;
 
@@ -75,8 +71,6 @@ namespace ouzel::scene
         std::vector<graphics::Vertex> vertices;
 
         Color color = Color::white();
-
-        bool needsMeshUpdate = false;
     };
 }
 
@@ -0,0 +1,117 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include "TransformInterpolator.hpp"
+#include "Actor.hpp"
+
+namespace ouzel::scene
+{
+    namespace
+    {
+        // Returns false if the matrix has a zero scale and can't be decomposed
+        bool decompose(Matrix4F matrix, Vector3F& translation, QuaternionF& rotation, Vector3F& scale) noexcept
+        {
+            translation = matrix.getTranslation();
+            scale = matrix.getScale();
+
+            if (scale.v[0] == 0.0F || scale.v[1] == 0.0F || scale.v[2] == 0.0F)
+                return false;
+
+            const auto& m = matrix.m;
+            const auto determinant = m[0] * (m[5] * m[10] - m[6] * m[9]) -
+                m[4] * (m[1] * m[10] - m[2] * m[9]) +
+                m[8] * (m[1] * m[6] - m[2] * m[5]);
+
+            // a flipped transform is a rotation with a negative scale
+            if (determinant < 0.0F)
+            {
+                scale.v[0] = -scale.v[0];
+                matrix.m[0] = -matrix.m[0];
+                matrix.m[1] = -matrix.m[1];
+                matrix.m[2] = -matrix.m[2];
+            }
+
+            rotation = matrix.getRotation();
+            return true;
+        }
+    }
+
+    TransformInterpolator::~TransformInterpolator()
+    {
+        for (Actor* actor : actors)
+            actor->transformInterpolator = nullptr;
+    }
+
+    void TransformInterpolator::addActor(Actor& actor)
+    {
+        if (actor.transformInterpolator == this) return;
+        if (actor.transformInterpolator) actor.transformInterpolator->removeActor(actor);
+
+        actor.transformInterpolator = this;
+        actor.interpolatorIndex = actors.size();
+        actor.previousTransformStored = false;
+        actors.push_back(&actor);
+    }
+
+    void TransformInterpolator::removeActor(Actor& actor)
+    {
+        if (actor.transformInterpolator != this) return;
+
+        Actor* last = actors.back();
+        last->interpolatorIndex = actor.interpolatorIndex;
+        actors[actor.interpolatorIndex] = last;
+        actors.pop_back();
+
+        actor.transformInterpolator = nullptr;
+    }
+
+    void TransformInterpolator::storePreviousTransforms()
+    {
+        for (Actor* actor : actors)
+        {
+            actor->previousTransform = actor->getTransform();
+            actor->previousTransformStored = true;
+        }
+    }
+
+    const Matrix4F& TransformInterpolator::getTransform(const Actor& actor) const
+    {
+        const auto& transform = actor.getTransform();
+
+        if (!actor.previousTransformStored || interpolation >= 1.0F ||
+            actor.previousTransform == transform)
+            return transform;
+
+        Vector3F previousTranslation;
+        QuaternionF previousRotation;
+        Vector3F previousScale;
+        Vector3F translation;
+        QuaternionF rotation;
+        Vector3F scale;
+
+        if (!decompose(actor.previousTransform, previousTranslation, previousRotation, previousScale) ||
+            !decompose(transform, translation, rotation, scale))
+            return transform;
+
+        // take the shorter way around
+        const auto dot = previousRotation.v[0] * rotation.v[0] + previousRotation.v[1] * rotation.v[1] +
+            previousRotation.v[2] * rotation.v[2] + previousRotation.v[3] * rotation.v[3];
+        if (dot < 0.0F) rotation = -rotation;
+
+        QuaternionF interpolatedRotation;
+        interpolatedRotation.lerp(previousRotation, rotation, interpolation);
+        interpolatedRotation.normalize();
+
+        auto& result = actor.interpolatedTransform;
+        result.setTranslation(previousTranslation + (translation - previousTranslation) * interpolation);
+
+        Matrix4F rotationMatrix;
+        rotationMatrix.setRotation(interpolatedRotation);
+        result *= rotationMatrix;
+
+        Matrix4F scaleMatrix;
+        scaleMatrix.setScale(previousScale + (scale - previousScale) * interpolation);
+        result *= scaleMatrix;
+
+        return result;
+    }
+}
@@ -0,0 +1,44 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_TRANSFORMINTERPOLATOR_HPP
+#define OUZEL_SCENE_TRANSFORMINTERPOLATOR_HPP
+
+#include <cstddef>
+#include <vector>
+#include "../math/Matrix.hpp"
+
+namespace ouzel::scene
+{
+    class Actor;
+
+    // Draws the interpolated actors between their world transforms of the previous and the last fixed update
+    class TransformInterpolator final
+    {
+    public:
+        TransformInterpolator() = default;
+        ~TransformInterpolator();
+
+        TransformInterpolator(const TransformInterpolator&) = delete;
+        TransformInterpolator& operator=(const TransformInterpolator&) = delete;
+
+        TransformInterpolator(TransformInterpolator&&) = delete;
+        TransformInterpolator& operator=(TransformInterpolator&&) = delete;
+
+        void addActor(Actor& actor);
+        void removeActor(Actor& actor);
+
+        // Called before every fixed update
+        void storePreviousTransforms();
+
+        auto getInterpolation() const noexcept { return interpolation; }
+        void setInterpolation(float newInterpolation) noexcept { interpolation = newInterpolation; }
+
+        const Matrix4F& getTransform(const Actor& actor) const;
+
+    private:
+        std::vector<Actor*> actors;
+        float interpolation = 1.0F;
+    };
+}
+
+#endif // OUZEL_SCENE_TRANSFORMINTERPOLATOR_HPP
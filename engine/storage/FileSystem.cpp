@@ -62,7 +62,7 @@ namespace ouzel::storage
 
         const auto executablePath = Path{buffer.data(), Path::Format::native};
         appPath = executablePath.getDirectory();
-        logger.log(Log::Level::info) << "Application directory: " << appPath;
+        OUZEL_LOG(Log::Level::info) << "Application directory: " << appPath;
 
 #elif defined(__APPLE__)
         CFBundleRef bundle = CFBundleGetMainBundle();
@@ -83,7 +83,7 @@ namespace ouzel::storage
             throw std::runtime_error("Failed to get resource directory");
 
         appPath = Path{resourceDirectory.get(), Path::Format::native};
-        logger.log(Log::Level::info) << "Application directory: " << appPath;
+        OUZEL_LOG(Log::Level::info) << "Application directory: " << appPath;
 
 #elif defined(__ANDROID__)
         // not available for Android
@@ -98,7 +98,7 @@ namespace ouzel::storage
         executableDirectory[length] = '\0';
         const auto executablePath = Path{executableDirectory, Path::Format::native};
         appPath = executablePath.getDirectory();
-        logger.log(Log::Level::info) << "Application directory: " << appPath;
+        OUZEL_LOG(Log::Level::info) << "Application directory: " << appPath;
 #endif
     }
 
@@ -365,6 +365,28 @@ namespace ouzel::storage
         return data;
     }
 
+    MappedFile FileSystem::mapFile(const Path& filename, const bool searchResources)
+    {
+        if (searchResources)
+            for (auto& archive : archives)
+                if (archive.second.fileExists(filename))
+                    return MappedFile(archive.second.readFile(filename));
+
+#if defined(__ANDROID__)
+        // files in the APK can't be mapped
+        if (!filename.isAbsolute())
+            return MappedFile(readFile(filename, searchResources));
+#endif
+
+        const auto path = getPath(filename, searchResources);
+
+        // file does not exist
+        if (path.isEmpty())
+            throw std::runtime_error("Failed to find file " + std::string(filename));
+
+        return MappedFile(path);
+    }
+
     bool FileSystem::resourceFileExists(const Path& filename) const
     {
         if (filename.isAbsolute())
@@ -31,6 +31,7 @@
 #  include <unistd.h>
 #endif
 #include "Archive.hpp"
+#include "MappedFile.hpp"
 #include "Path.hpp"
 
 namespace ouzel::core
@@ -234,6 +235,7 @@ namespace ouzel::storage
         }
 
         std::vector<std::byte> readFile(const Path& filename, const bool searchResources = true);
+        MappedFile mapFile(const Path& filename, const bool searchResources = true);
 
         bool resourceFileExists(const Path& filename) const;
 
@@ -0,0 +1,199 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_STORAGE_MAPPEDFILE_HPP
+#define OUZEL_STORAGE_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+#if defined(_WIN32)
+#  pragma push_macro("WIN32_LEAN_AND_MEAN")
+#  pragma push_macro("NOMINMAX")
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <Windows.h>
+#  pragma pop_macro("WIN32_LEAN_AND_MEAN")
+#  pragma pop_macro("NOMINMAX")
+#elif defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+#include "Path.hpp"
+
+namespace ouzel::storage
+{
+    // Read-only view of a whole file, memory mapped when the platform supports it
+    // Files that can't be mapped (e.g. the ones inside of archives) keep their contents in memory
+    class MappedFile final
+    {
+    public:
+        MappedFile() noexcept = default;
+
+        explicit MappedFile(const Path& path)
+        {
+#if defined(_WIN32)
+            file = CreateFileW(path.getNative().c_str(), GENERIC_READ, FILE_SHARE_READ,
+                               nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                throw std::system_error(GetLastError(), std::system_category(), "Failed to open file");
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize))
+            {
+                const auto error = GetLastError();
+                close();
+                throw std::system_error(error, std::system_category(), "Failed to get file size");
+            }
+
+            size = static_cast<std::size_t>(fileSize.QuadPart);
+            if (size == 0) return;
+
+            mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping)
+            {
+                const auto error = GetLastError();
+                close();
+                throw std::system_error(error, std::system_category(), "Failed to create file mapping");
+            }
+
+            data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!data)
+            {
+                const auto error = GetLastError();
+                close();
+                throw std::system_error(error, std::system_category(), "Failed to map file");
+            }
+#elif defined(__unix__) || defined(__APPLE__)
+            const int fd = open(path.getNative().c_str(), O_RDONLY);
+            if (fd == -1)
+                throw std::system_error(errno, std::system_category(), "Failed to open file");
+
+            struct stat buf;
+            if (fstat(fd, &buf) == -1)
+            {
+                const auto error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::system_category(), "Failed to get file size");
+            }
+
+            size = static_cast<std::size_t>(buf.st_size);
+
+            if (size != 0)
+            {
+                void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address == MAP_FAILED)
+                {
+                    const auto error = errno;
+                    ::close(fd);
+                    throw std::system_error(error, std::system_category(), "Failed to map file");
+                }
+
+                data = static_cast<const std::byte*>(address);
+            }
+
+            // the mapping stays valid after the descriptor is closed
+            ::close(fd);
+#else
+            throw std::runtime_error("Memory mapped files not supported");
+#endif
+        }
+
+        explicit MappedFile(std::vector<std::byte>&& contents) noexcept:
+            buffer(std::move(contents))
+        {
+            data = buffer.data();
+            size = buffer.size();
+        }
+
+        ~MappedFile()
+        {
+            close();
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept:
+#if defined(_WIN32)
+            file(other.file),
+            mapping(other.mapping),
+#endif
+            buffer(std::move(other.buffer)),
+            data(other.data),
+            size(other.size)
+        {
+#if defined(_WIN32)
+            other.file = INVALID_HANDLE_VALUE;
+            other.mapping = nullptr;
+#endif
+            other.data = nullptr;
+            other.size = 0;
+        }
+
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            close();
+
+#if defined(_WIN32)
+            file = other.file;
+            mapping = other.mapping;
+            other.file = INVALID_HANDLE_VALUE;
+            other.mapping = nullptr;
+#endif
+            buffer = std::move(other.buffer);
+            data = other.data;
+            size = other.size;
+            other.data = nullptr;
+            other.size = 0;
+
+            return *this;
+        }
+
+        auto getData() const noexcept { return data; }
+        auto getSize() const noexcept { return size; }
+
+        // Returns true if the contents are mapped and not copied to memory
+        bool isMapped() const noexcept { return data && data != buffer.data(); }
+
+    private:
+        void close() noexcept
+        {
+            const bool mapped = isMapped();
+
+#if defined(_WIN32)
+            if (mapped) UnmapViewOfFile(data);
+            if (mapping) CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+            mapping = nullptr;
+            file = INVALID_HANDLE_VALUE;
+#elif defined(__unix__) || defined(__APPLE__)
+            if (mapped) munmap(const_cast<std::byte*>(data), size);
+#endif
+            static_cast<void>(mapped);
+
+            buffer.clear();
+            data = nullptr;
+            size = 0;
+        }
+
+#if defined(_WIN32)
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#endif
+        std::vector<std::byte> buffer;
+        const std::byte* data = nullptr;
+        std::size_t size = 0;
+    };
+}
+
+#endif // OUZEL_STORAGE_MAPPEDFILE_HPP
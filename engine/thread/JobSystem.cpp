@@ -0,0 +1,438 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <string>
+#include "JobSystem.hpp"
+
+namespace ouzel::thread
+{
+    namespace
+    {
+        thread_local const JobSystem* currentJobSystem = nullptr;
+        thread_local std::size_t currentWorkerIndex = 0;
+    }
+
+    JobSystem::JobSystem(std::size_t workerCount):
+        mainThreadId(std::this_thread::get_id()),
+        statisticsStart(std::chrono::steady_clock::now())
+    {
+        queues.reserve(workerCount + 1);
+        for (std::size_t i = 0; i < workerCount + 1; ++i)
+            queues.push_back(std::make_unique<Queue>());
+
+        workers.reserve(workerCount);
+        for (std::size_t i = 0; i < workerCount; ++i)
+            workers.push_back(std::make_unique<Worker>());
+
+        // the threads are started after all of the workers exist, because they steal from each other
+        for (std::size_t i = 0; i < workerCount; ++i)
+            workers[i]->thread = thread::Thread(&JobSystem::work, this, i);
+    }
+
+    JobSystem::~JobSystem()
+    {
+        std::unique_lock lock(sleepMutex);
+        stopping = true;
+        lock.unlock();
+        sleepCondition.notify_all();
+
+        for (const auto& worker : workers)
+            if (worker->thread.isJoinable()) worker->thread.join();
+    }
+
+    std::size_t JobSystem::getDefaultWorkerCount() noexcept
+    {
+#if defined(__EMSCRIPTEN__)
+        return 0;
+#else
+        // the thread that waits for the jobs runs them too
+        const auto cpuCount = std::thread::hardware_concurrency();
+        return cpuCount > 1 ? cpuCount - 1 : 0;
+#endif
+    }
+
+    JobHandle JobSystem::schedule(const std::function<void()>& function,
+                                  Affinity affinity)
+    {
+        auto job = std::make_shared<Job>(function, affinity);
+        release(job);
+        return JobHandle(std::move(job));
+    }
+
+    JobHandle JobSystem::schedule(const std::function<void()>& function,
+                                  const std::vector<JobHandle>& dependencies,
+                                  Affinity affinity)
+    {
+        auto job = std::make_shared<Job>(function, affinity);
+
+        for (const auto& dependency : dependencies)
+        {
+            if (!dependency.job) continue;
+
+            std::lock_guard lock(dependency.job->continuationMutex);
+            if (!dependency.job->finished)
+            {
+                job->pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+                dependency.job->continuations.push_back(job);
+            }
+            else if (dependency.job->exception)
+            {
+                // the other dependencies can be failing at the same time
+                std::lock_guard jobLock(job->continuationMutex);
+                if (!job->exception) job->exception = dependency.job->exception;
+            }
+        }
+
+        release(job);
+        return JobHandle(std::move(job));
+    }
+
+    void JobSystem::wait(const JobHandle& handle)
+    {
+        if (!handle.job) return;
+
+        const auto index = (currentJobSystem == this) ? currentWorkerIndex : workers.size();
+
+        while (!handle.job->isDone())
+            if (!runJob(index)) std::this_thread::yield();
+
+        if (handle.job->exception)
+            std::rethrow_exception(handle.job->exception);
+    }
+
+    void JobSystem::wait(const std::vector<JobHandle>& handles)
+    {
+        const auto index = (currentJobSystem == this) ? currentWorkerIndex : workers.size();
+
+        // all of the jobs are waited for before rethrowing, because they can reference the caller's stack
+        for (const auto& handle : handles)
+            if (handle.job)
+                while (!handle.job->isDone())
+                    if (!runJob(index)) std::this_thread::yield();
+
+        for (const auto& handle : handles)
+            if (handle.job && handle.job->exception)
+                std::rethrow_exception(handle.job->exception);
+    }
+
+    void JobSystem::parallelFor(std::size_t begin, std::size_t end,
+                                const std::function<void(std::size_t, std::size_t)>& function,
+                                std::size_t grainSize)
+    {
+        if (begin >= end) return;
+
+        const auto count = end - begin;
+        const auto threadCount = workers.size() + 1;
+
+        // about four chunks per thread, so that the threads that finish early can take over the rest
+        const auto chunkSize = std::max(std::max(grainSize, std::size_t(1)),
+                                        (count + threadCount * 4 - 1) / (threadCount * 4));
+        const auto chunkCount = (count + chunkSize - 1) / chunkSize;
+
+        if (chunkCount == 1 || workers.empty())
+        {
+            function(begin, end);
+            return;
+        }
+
+        std::atomic<std::size_t> nextChunk{0};
+
+        auto runChunks = [&nextChunk, chunkCount, chunkSize, begin, end, &function]() {
+            try
+            {
+                for (;;)
+                {
+                    const auto chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+                    if (chunk >= chunkCount) break;
+
+                    const auto chunkBegin = begin + chunk * chunkSize;
+                    function(chunkBegin, std::min(chunkBegin + chunkSize, end));
+                }
+            }
+            catch (...)
+            {
+                // skip the remaining chunks
+                nextChunk.store(chunkCount, std::memory_order_relaxed);
+                throw;
+            }
+        };
+
+        const auto helperCount = std::min(workers.size(), chunkCount - 1);
+        std::vector<JobHandle> helpers;
+        helpers.reserve(helperCount);
+        for (std::size_t i = 0; i < helperCount; ++i)
+            helpers.push_back(schedule(runChunks));
+
+        std::exception_ptr exception;
+
+        try
+        {
+            runChunks();
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+
+        if (exception)
+        {
+            // the helpers reference this stack frame, so they have to finish first
+            try
+            {
+                wait(helpers);
+            }
+            catch (...)
+            {
+            }
+
+            std::rethrow_exception(exception);
+        }
+
+        wait(helpers);
+    }
+
+    void JobSystem::runMainThreadJobs()
+    {
+        mainThreadId = std::this_thread::get_id();
+
+        // the jobs scheduled by the main thread jobs are run on the next call
+        std::unique_lock lock(mainThreadQueue.mutex);
+        auto count = mainThreadQueue.jobs.size();
+        lock.unlock();
+
+        for (; count > 0; --count)
+        {
+            lock.lock();
+            if (mainThreadQueue.jobs.empty()) break;
+            const auto job = std::move(mainThreadQueue.jobs.front());
+            mainThreadQueue.jobs.pop_front();
+            lock.unlock();
+
+            execute(job);
+        }
+
+        // without workers the jobs that nobody waits for are run here
+        if (workers.empty())
+            while (runJob(workers.size())) {}
+    }
+
+    std::vector<JobSystem::WorkerStatistics> JobSystem::getStatistics() const
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - statisticsStart;
+
+        std::vector<WorkerStatistics> result;
+        result.reserve(workers.size());
+
+        for (const auto& worker : workers)
+        {
+            WorkerStatistics statistics;
+            statistics.jobCount = worker->jobCount.load(std::memory_order_relaxed);
+            statistics.busyTime = std::chrono::nanoseconds(worker->busyTime.load(std::memory_order_relaxed));
+            if (elapsed.count() > 0)
+                statistics.utilization = static_cast<float>(static_cast<double>(statistics.busyTime.count()) /
+                                                            static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            result.push_back(statistics);
+        }
+
+        return result;
+    }
+
+    void JobSystem::resetStatistics()
+    {
+        for (const auto& worker : workers)
+        {
+            worker->jobCount.store(0, std::memory_order_relaxed);
+            worker->busyTime.store(0, std::memory_order_relaxed);
+        }
+
+        statisticsStart = std::chrono::steady_clock::now();
+    }
+
+    void JobSystem::work(std::size_t index)
+    {
+        currentJobSystem = this;
+        currentWorkerIndex = index;
+        setCurrentThreadName("Worker " + std::to_string(index));
+
+        Worker& worker = *workers[index];
+
+        for (;;)
+        {
+            if (const auto job = dequeue(index))
+            {
+                const auto startTime = std::chrono::steady_clock::now();
+                execute(job);
+                const auto busyTime = std::chrono::steady_clock::now() - startTime;
+
+                worker.busyTime.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(busyTime).count(),
+                                          std::memory_order_relaxed);
+                worker.jobCount.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            std::unique_lock lock(sleepMutex);
+            sleepCondition.wait(lock, [this]() noexcept {
+                return stopping || queuedJobs.load(std::memory_order_acquire) > 0;
+            });
+
+            if (stopping) return;
+        }
+    }
+
+    void JobSystem::enqueue(const std::shared_ptr<Job>& job)
+    {
+        if (job->affinity == Affinity::mainThread)
+        {
+            std::lock_guard lock(mainThreadQueue.mutex);
+            mainThreadQueue.jobs.push_back(job);
+            return;
+        }
+
+        // workers push to their own deque, other threads to the shared one
+        const auto index = (currentJobSystem == this) ? currentWorkerIndex : workers.size();
+
+        std::unique_lock queueLock(queues[index]->mutex);
+        queues[index]->jobs.push_back(job);
+        queueLock.unlock();
+
+        queuedJobs.fetch_add(1, std::memory_order_release);
+
+        // taking the lock makes sure that a worker can't miss the notification between checking and sleeping
+        std::unique_lock lock(sleepMutex);
+        lock.unlock();
+        sleepCondition.notify_one();
+    }
+
+    std::shared_ptr<Job> JobSystem::dequeue(std::size_t index)
+    {
+        // the newest job of the own deque is the most likely to be in the cache
+        if (index < workers.size())
+        {
+            Queue& queue = *queues[index];
+            std::lock_guard lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                auto job = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+                queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+
+        // take the oldest job of the shared deque or steal it from the other workers
+        const auto workerCount = workers.size();
+        for (std::size_t i = 0; i <= workerCount; ++i)
+        {
+            const auto victim = (i == 0) ? workerCount : (index + i) % workerCount;
+            if (victim == index && index < workerCount) continue;
+
+            Queue& queue = *queues[victim];
+            std::lock_guard lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                auto job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+
+        if (std::this_thread::get_id() == mainThreadId.load(std::memory_order_relaxed))
+        {
+            std::lock_guard lock(mainThreadQueue.mutex);
+            if (!mainThreadQueue.jobs.empty())
+            {
+                auto job = std::move(mainThreadQueue.jobs.front());
+                mainThreadQueue.jobs.pop_front();
+                return job;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool JobSystem::runJob(std::size_t index)
+    {
+        if (const auto job = dequeue(index))
+        {
+            execute(job);
+            return true;
+        }
+
+        return false;
+    }
+
+    void JobSystem::execute(const std::shared_ptr<Job>& job)
+    {
+        try
+        {
+            job->function();
+        }
+        catch (...)
+        {
+            job->exception = std::current_exception();
+        }
+
+        // release the captured values
+        job->function = nullptr;
+
+        finish(job);
+    }
+
+    void JobSystem::finish(const std::shared_ptr<Job>& job)
+    {
+        // the cancelled continuations are finished here too, without recursion for long chains
+        std::vector<std::shared_ptr<Job>> finishedJobs{job};
+
+        while (!finishedJobs.empty())
+        {
+            const auto finishedJob = std::move(finishedJobs.back());
+            finishedJobs.pop_back();
+
+            std::vector<std::shared_ptr<Job>> continuations;
+
+            std::unique_lock lock(finishedJob->continuationMutex);
+            finishedJob->finished = true;
+            continuations.swap(finishedJob->continuations);
+            lock.unlock();
+
+            finishedJob->done.store(true, std::memory_order_release);
+
+            for (const auto& continuation : continuations)
+            {
+                // the continuations of a failed job are not run, they get the exception of the first failed dependency
+                if (finishedJob->exception)
+                {
+                    std::lock_guard continuationLock(continuation->continuationMutex);
+                    if (!continuation->exception) continuation->exception = finishedJob->exception;
+                }
+
+                if (continuation->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    if (continuation->exception)
+                    {
+                        continuation->function = nullptr;
+                        finishedJobs.push_back(continuation);
+                    }
+                    else
+                        enqueue(continuation);
+                }
+            }
+        }
+    }
+
+    void JobSystem::release(const std::shared_ptr<Job>& job)
+    {
+        if (job->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            // one of the dependencies had already failed when the job was scheduled
+            if (job->exception)
+            {
+                job->function = nullptr;
+                finish(job);
+            }
+            else
+                enqueue(job);
+        }
+    }
+}
@@ -0,0 +1,170 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_THREAD_JOBSYSTEM_HPP
+#define OUZEL_THREAD_JOBSYSTEM_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Thread.hpp"
+
+namespace ouzel::thread
+{
+    class JobSystem;
+
+    class Job final
+    {
+        friend JobSystem;
+    public:
+        enum class Affinity
+        {
+            any,
+            mainThread // executed by JobSystem::runMainThreadJobs
+        };
+
+        Job(const std::function<void()>& initFunction, Affinity initAffinity):
+            function(initFunction), affinity(initAffinity)
+        {
+        }
+
+        auto isDone() const noexcept { return done.load(std::memory_order_acquire); }
+
+    private:
+        std::function<void()> function;
+        Affinity affinity;
+
+        // one extra dependency is held while the job is being scheduled
+        std::atomic<std::size_t> pendingDependencies{1};
+        std::atomic<bool> done{false};
+
+        std::mutex continuationMutex;
+        std::vector<std::shared_ptr<Job>> continuations;
+        bool finished = false;
+
+        std::exception_ptr exception; // thrown by the job or by the dependency that cancelled it
+    };
+
+    class JobHandle final
+    {
+        friend JobSystem;
+    public:
+        JobHandle() noexcept = default;
+
+        auto isValid() const noexcept { return job != nullptr; }
+        auto isDone() const noexcept { return !job || job->isDone(); }
+
+    private:
+        explicit JobHandle(std::shared_ptr<Job> initJob) noexcept: job(std::move(initJob)) {}
+
+        std::shared_ptr<Job> job;
+    };
+
+    // Runs jobs on a fixed set of worker threads
+    // Every worker has its own deque, it takes the newest jobs from its back and the idle workers steal
+    // the oldest jobs from the front of the others' deques, jobs from other threads go to a shared deque
+    // Waiting threads run jobs until the awaited job is done instead of blocking
+    class JobSystem final
+    {
+    public:
+        using Affinity = Job::Affinity;
+
+        struct WorkerStatistics final
+        {
+            std::uint64_t jobCount = 0;
+            std::chrono::nanoseconds busyTime{0};
+            float utilization = 0.0F; // busy time divided by the time since the statistics were reset
+        };
+
+        // zero workers runs all of the jobs on the waiting threads
+        explicit JobSystem(std::size_t workerCount = getDefaultWorkerCount());
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        JobSystem(JobSystem&&) = delete;
+        JobSystem& operator=(JobSystem&&) = delete;
+
+        static std::size_t getDefaultWorkerCount() noexcept;
+
+        auto getWorkerCount() const noexcept { return workers.size(); }
+
+        JobHandle schedule(const std::function<void()>& function,
+                           Affinity affinity = Affinity::any);
+
+        // The job starts after all of the dependencies are done
+        // If a dependency throws, the job and its continuations are cancelled and waiting for them
+        // rethrows the exception of the dependency
+        JobHandle schedule(const std::function<void()>& function,
+                           const std::vector<JobHandle>& dependencies,
+                           Affinity affinity = Affinity::any);
+
+        JobHandle then(const JobHandle& job,
+                       const std::function<void()>& function,
+                       Affinity affinity = Affinity::any)
+        {
+            return schedule(function, std::vector<JobHandle>{job}, affinity);
+        }
+
+        // Runs other jobs until the job is done, rethrows the exception thrown by the job
+        void wait(const JobHandle& handle);
+        void wait(const std::vector<JobHandle>& handles);
+
+        // Splits the range into chunks of at least grainSize elements and calls the function for each chunk
+        // on the workers and the calling thread, returns when all of the chunks are done
+        void parallelFor(std::size_t begin, std::size_t end,
+                         const std::function<void(std::size_t, std::size_t)>& function,
+                         std::size_t grainSize = 1);
+
+        // Runs the jobs with the main thread affinity, the calling thread becomes the main thread
+        void runMainThreadJobs();
+
+        std::vector<WorkerStatistics> getStatistics() const;
+        void resetStatistics();
+
+    private:
+        struct Queue final
+        {
+            std::mutex mutex;
+            std::deque<std::shared_ptr<Job>> jobs;
+        };
+
+        struct Worker final
+        {
+            thread::Thread thread;
+            std::atomic<std::uint64_t> jobCount{0};
+            std::atomic<std::int64_t> busyTime{0}; // nanoseconds
+        };
+
+        void work(std::size_t index);
+        void enqueue(const std::shared_ptr<Job>& job);
+        std::shared_ptr<Job> dequeue(std::size_t index);
+        bool runJob(std::size_t index);
+        void execute(const std::shared_ptr<Job>& job);
+        void finish(const std::shared_ptr<Job>& job);
+        void release(const std::shared_ptr<Job>& job);
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::unique_ptr<Queue>> queues; // one per worker and a shared one at the end
+        Queue mainThreadQueue;
+        std::atomic<std::thread::id> mainThreadId;
+
+        std::atomic<std::size_t> queuedJobs{0};
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+        bool stopping = false;
+
+        std::chrono::steady_clock::time_point statisticsStart;
+    };
+}
+
+#endif // OUZEL_THREAD_JOBSYSTEM_HPP
@@ -0,0 +1,133 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_THREAD_RINGQUEUE_HPP
+#define OUZEL_THREAD_RINGQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ouzel::thread
+{
+    // Bounded multiple producer, single consumer queue
+    // Producers don't lock or allocate unless the ring is full, in which case push
+    // stores the values in an overflow list, so that nothing is lost
+    template <class T>
+    class RingQueue final
+    {
+    public:
+        explicit RingQueue(std::size_t capacity):
+            cells(capacity), mask(capacity - 1)
+        {
+            if (capacity < 2 || (capacity & mask) != 0)
+                throw std::runtime_error("Ring queue capacity must be a power of two");
+
+            for (std::size_t i = 0; i < capacity; ++i)
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        RingQueue(const RingQueue&) = delete;
+        RingQueue& operator=(const RingQueue&) = delete;
+        RingQueue(RingQueue&&) = delete;
+        RingQueue& operator=(RingQueue&&) = delete;
+
+        // Returns false if the ring is full
+        bool tryPush(T&& value)
+        {
+            // keep the order of the values once they started to go to the overflow list
+            if (overflowing.load(std::memory_order_acquire)) return false;
+
+            auto position = pushPosition.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                Cell& cell = cells[position & mask];
+                const auto sequence = cell.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+                if (difference == 0)
+                {
+                    if (pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        cell.value = std::move(value);
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                    return false;
+                else
+                    position = pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        void push(T&& value)
+        {
+            if (tryPush(std::move(value))) return;
+
+            std::scoped_lock lock(overflowMutex);
+            overflow.push_back(std::move(value));
+            overflowing.store(true, std::memory_order_release);
+        }
+
+        // Must be called only from the consumer thread
+        bool tryPop(T& value)
+        {
+            Cell& cell = cells[popPosition & mask];
+            const auto sequence = cell.sequence.load(std::memory_order_acquire);
+
+            if (sequence != popPosition + 1) return false;
+
+            value = std::move(cell.value);
+            cell.sequence.store(popPosition + mask + 1, std::memory_order_release);
+            ++popPosition;
+            return true;
+        }
+
+        // Calls the function for every queued value in the order they were pushed
+        // Must be called only from the consumer thread
+        template <class F>
+        void drain(F f)
+        {
+            T value;
+            while (tryPop(value)) f(value);
+
+            if (overflowing.load(std::memory_order_acquire))
+            {
+                std::unique_lock lock(overflowMutex);
+
+                // the values that were pushed to the ring before the ones in the overflow list
+                while (tryPop(value)) f(value);
+
+                std::swap(overflow, drained);
+                overflowing.store(false, std::memory_order_release);
+                lock.unlock();
+
+                for (auto& drainedValue : drained) f(drainedValue);
+                drained.clear();
+            }
+        }
+
+    private:
+        struct Cell final
+        {
+            std::atomic<std::size_t> sequence{0};
+            T value;
+        };
+
+        std::vector<Cell> cells;
+        std::size_t mask;
+        alignas(64) std::atomic<std::size_t> pushPosition{0};
+        alignas(64) std::size_t popPosition = 0;
+
+        std::atomic<bool> overflowing{false};
+        std::mutex overflowMutex;
+        std::vector<T> overflow;
+        std::vector<T> drained;
+    };
+}
+
+#endif // OUZEL_THREAD_RINGQUEUE_HPP
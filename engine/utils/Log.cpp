@@ -27,12 +27,358 @@
 #  include <emscripten.h>
 #endif
 
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
 #include "Log.hpp"
+#include "../thread/Thread.hpp"
 
 namespace ouzel
 {
+    // Single producer, single consumer ring of log records
+    // The owning thread writes the records and the logger's background thread reads them
+    class LogRing final
+    {
+    public:
+        struct Record final
+        {
+            std::uint64_t sequence;
+            Log::Level level;
+            std::string str;
+        };
+
+        explicit LogRing(std::size_t size):
+            buffer(size)
+        {
+        }
+
+        bool push(std::uint64_t sequence, Log::Level level, const std::string& str) noexcept
+        {
+            const auto length = std::min(str.size(), buffer.size() - sizeof(Header));
+            const auto recordSize = (sizeof(Header) + length + alignment - 1) / alignment * alignment;
+
+            const auto writeIndex = head.load(std::memory_order_relaxed);
+            const auto readIndex = tail.load(std::memory_order_acquire);
+            if (buffer.size() - (writeIndex - readIndex) < recordSize)
+                return false;
+
+            const Header header{sequence, static_cast<std::uint32_t>(level), static_cast<std::uint32_t>(length)};
+            const auto offset = writeIndex % buffer.size();
+            std::memcpy(&buffer[offset], &header, sizeof(header));
+            copyIn(offset + sizeof(header), str.data(), length);
+
+            head.store(writeIndex + recordSize, std::memory_order_release);
+            return true;
+        }
+
+        void pop(std::vector<Record>& records)
+        {
+            const auto writeIndex = head.load(std::memory_order_acquire);
+            auto readIndex = tail.load(std::memory_order_relaxed);
+
+            while (readIndex != writeIndex)
+            {
+                const auto offset = readIndex % buffer.size();
+
+                Header header;
+                std::memcpy(&header, &buffer[offset], sizeof(header));
+
+                Record record{header.sequence, static_cast<Log::Level>(header.level), std::string(header.length, '\0')};
+                copyOut(record.str.data(), offset + sizeof(header), header.length);
+                records.push_back(std::move(record));
+
+                readIndex += (sizeof(Header) + header.length + alignment - 1) / alignment * alignment;
+            }
+
+            tail.store(readIndex, std::memory_order_release);
+        }
+
+        std::atomic<bool> owned{true};
+        std::atomic<std::uint64_t> dropped{0};
+
+    private:
+        // the headers never wrap, because the ring size and the records are aligned to the header size
+        struct Header final
+        {
+            std::uint64_t sequence;
+            std::uint32_t level;
+            std::uint32_t length;
+        };
+
+        static constexpr std::size_t alignment = sizeof(Header);
+
+        void copyIn(std::size_t offset, const char* data, std::size_t length) noexcept
+        {
+            offset %= buffer.size();
+            const auto first = std::min(length, buffer.size() - offset);
+            std::memcpy(&buffer[offset], data, first);
+            std::memcpy(&buffer[0], data + first, length - first);
+        }
+
+        void copyOut(char* data, std::size_t offset, std::size_t length) const noexcept
+        {
+            offset %= buffer.size();
+            const auto first = std::min(length, buffer.size() - offset);
+            std::memcpy(data, &buffer[offset], first);
+            std::memcpy(data + first, &buffer[0], length - first);
+        }
+
+        std::vector<char> buffer;
+        alignas(64) std::atomic<std::size_t> head{0};
+        alignas(64) std::atomic<std::size_t> tail{0};
+    };
+
+    namespace
+    {
+        // Ring of the current thread, given back to the logger when the thread exits
+        struct ThreadRing final
+        {
+            ~ThreadRing()
+            {
+                if (ring) ring->owned.store(false, std::memory_order_release);
+            }
+
+            std::uint64_t loggerId = 0;
+            std::shared_ptr<LogRing> ring;
+        };
+
+        thread_local ThreadRing threadRing;
+    }
+
+    class Logger::Sink final
+    {
+    public:
+#if !defined(__EMSCRIPTEN__)
+        std::mutex logMutex;
+#endif
+        std::ofstream file;
+
+        OverflowPolicy overflowPolicy = OverflowPolicy::count;
+        std::size_t ringSize = 65536;
+        std::mutex ringMutex;
+        std::vector<std::shared_ptr<LogRing>> rings;
+
+#if !defined(__EMSCRIPTEN__)
+        thread::Thread drainThread;
+        std::mutex drainMutex;
+        std::condition_variable drainCondition;
+        bool draining = false;
+#endif
+    };
+
     Logger logger;
 
+    Logger::Logger(Log::Level initThreshold):
+        threshold(initThreshold), id(generateId()), sink(std::make_unique<Sink>())
+    {
+    }
+
+    Logger::~Logger()
+    {
+        stopAsync();
+    }
+
+    std::uint64_t Logger::generateId() noexcept
+    {
+        static std::atomic<std::uint64_t> nextId{1};
+        return nextId.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Logger::setFile(const storage::Path& path)
+    {
+#if !defined(__EMSCRIPTEN__)
+        std::scoped_lock lock(sink->logMutex);
+#endif
+        if (sink->file.is_open()) sink->file.close();
+        sink->file.open(path, std::ios::binary | std::ios::trunc);
+        if (!sink->file)
+            throw std::runtime_error("Failed to open log file " + std::string(path));
+    }
+
+    void Logger::startAsync(OverflowPolicy policy, std::size_t size)
+    {
+#if defined(__EMSCRIPTEN__)
+        static_cast<void>(policy);
+        static_cast<void>(size);
+        throw std::runtime_error("Asynchronous logging not supported");
+#else
+        if (async) return;
+
+        sink->overflowPolicy = policy;
+        // at least a page and a multiple of the record header size
+        sink->ringSize = (std::max(size, std::size_t(4096)) + 15) / 16 * 16;
+
+        sink->draining = true;
+        sink->drainThread = thread::Thread(&Logger::drainMain, this);
+        async.store(true, std::memory_order_release);
+#endif
+    }
+
+    void Logger::stopAsync()
+    {
+#if !defined(__EMSCRIPTEN__)
+        if (!async.exchange(false)) return;
+
+        // wait for the threads that saw the logger as asynchronous to finish pushing their messages,
+        // the drain thread keeps running meanwhile, so the blocking pushes can complete
+        while (producers.load() != 0)
+            std::this_thread::yield();
+
+        std::unique_lock lock(sink->drainMutex);
+        sink->draining = false;
+        lock.unlock();
+        sink->drainCondition.notify_all();
+
+        sink->drainThread.join();
+        drain();
+#endif
+    }
+
+    void Logger::output(const std::string& str, const Log::Level level) const
+    {
+        // stopAsync waits for the producers, so either it sees this thread or this thread sees the logger stopped
+        producers.fetch_add(1);
+
+        if (async.load())
+            push(str, level);
+        else
+            writeSync(str, level);
+
+        producers.fetch_sub(1, std::memory_order_release);
+    }
+
+    void Logger::write(const std::string& str, const Log::Level level) const
+    {
+        if (sink->file.is_open())
+            sink->file << str << '\n';
+        else
+            logString(str, level);
+    }
+
+    void Logger::writeSync(const std::string& str, const Log::Level level) const
+    {
+#if !defined(__EMSCRIPTEN__)
+        std::scoped_lock lock(sink->logMutex);
+#endif
+        write(str, level);
+        if (sink->file.is_open()) sink->file.flush();
+    }
+
+    void Logger::push(const std::string& str, const Log::Level level) const
+    {
+        auto& ring = getRing();
+        const auto recordSequence = sequence.fetch_add(1, std::memory_order_relaxed);
+
+        while (!ring.push(recordSequence, level, str))
+        {
+            switch (sink->overflowPolicy)
+            {
+                case OverflowPolicy::drop:
+                    return;
+                case OverflowPolicy::count:
+                    ring.dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                case OverflowPolicy::block:
+                    // the logger is being stopped, don't wait for the ring any longer
+                    if (!async.load(std::memory_order_acquire))
+                    {
+                        writeSync(str, level);
+                        return;
+                    }
+#if !defined(__EMSCRIPTEN__)
+                    sink->drainCondition.notify_one();
+#endif
+                    std::this_thread::yield();
+                    break;
+            }
+        }
+    }
+
+    LogRing& Logger::getRing() const
+    {
+        if (threadRing.loggerId == id)
+            return *threadRing.ring;
+
+        if (threadRing.ring)
+            threadRing.ring->owned.store(false, std::memory_order_release);
+
+        std::scoped_lock lock(sink->ringMutex);
+
+        // reuse a ring left behind by a thread that has exited
+        auto i = std::find_if(sink->rings.begin(), sink->rings.end(), [](const auto& ring) noexcept {
+            return !ring->owned.load(std::memory_order_acquire);
+        });
+
+        if (i != sink->rings.end())
+        {
+            (*i)->owned.store(true, std::memory_order_relaxed);
+            threadRing.ring = *i;
+        }
+        else
+        {
+            threadRing.ring = std::make_shared<LogRing>(sink->ringSize);
+            sink->rings.push_back(threadRing.ring);
+        }
+
+        threadRing.loggerId = id;
+        return *threadRing.ring;
+    }
+
+    void Logger::drain() const
+    {
+        std::vector<std::shared_ptr<LogRing>> currentRings;
+        {
+            std::scoped_lock lock(sink->ringMutex);
+            currentRings = sink->rings;
+        }
+
+        std::vector<LogRing::Record> records;
+        std::uint64_t dropped = 0;
+
+        for (const auto& ring : currentRings)
+        {
+            ring->pop(records);
+            dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+        }
+
+        if (records.empty() && !dropped) return;
+
+        // restore the order in which the messages were logged on different threads
+        std::sort(records.begin(), records.end(), [](const auto& a, const auto& b) noexcept {
+            return a.sequence < b.sequence;
+        });
+
+#if !defined(__EMSCRIPTEN__)
+        std::scoped_lock lock(sink->logMutex);
+#endif
+        for (const auto& record : records)
+            write(record.str, record.level);
+
+        if (dropped)
+            write(std::to_string(dropped) + " log messages dropped", Log::Level::warning);
+
+        if (sink->file.is_open()) sink->file.flush();
+    }
+
+    void Logger::drainMain()
+    {
+#if !defined(__EMSCRIPTEN__)
+        thread::setCurrentThreadName("Log");
+
+        std::unique_lock lock(sink->drainMutex);
+        while (sink->draining)
+        {
+            lock.unlock();
+            drain();
+            lock.lock();
+
+            sink->drainCondition.wait_for(lock, std::chrono::milliseconds(10));
+        }
+#endif
+    }
+
     void Logger::logString(const std::string& str, Log::Level level)
     {
 #if defined(__ANDROID__)
@@ -78,9 +424,9 @@ namespace ouzel
         std::size_t offset = 0;
         while (offset < output.size())
         {
-            ssize_t written = write(fd, output.data() + offset, output.size() - offset);
+            ssize_t written = ::write(fd, output.data() + offset, output.size() - offset);
             while (written == -1 && errno == EINTR)
-                written = write(fd, output.data() + offset, output.size() - offset);
+                written = ::write(fd, output.data() + offset, output.size() - offset);
 
             if (written == -1)
                 return;
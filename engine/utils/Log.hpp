@@ -4,10 +4,13 @@
 #define OUZEL_UTILS_LOG_HPP
 
 #include <atomic>
+#include <charconv>
 #include <cstring>
-#include <mutex>
+#include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
+#include "../core/Setup.h"
 #include "../math/Matrix.hpp"
 #include "../math/Quaternion.hpp"
 #include "../math/Size.hpp"
@@ -18,6 +21,7 @@
 namespace ouzel
 {
     class Logger;
+    class LogRing;
 
     template<typename T, typename = void>
     struct isContainer: std::false_type {};
@@ -105,10 +109,19 @@ namespace ouzel
             return *this;
         }
 
-        template <typename T, std::enable_if_t<std::is_arithmetic_v<T> &&
+        template <typename T, std::enable_if_t<std::is_integral_v<T> &&
             !std::is_same_v<T, bool> &&
             !std::is_same_v<T, std::uint8_t>>* = nullptr>
         Log& operator<<(const T val)
+        {
+            char buffer[24];
+            const auto result = std::to_chars(std::begin(buffer), std::end(buffer), val);
+            s.append(buffer, result.ptr);
+            return *this;
+        }
+
+        template <typename T, std::enable_if_t<std::is_floating_point_v<T>>* = nullptr>
+        Log& operator<<(const T val)
         {
             s += std::to_string(val);
             return *this;
@@ -159,13 +172,31 @@ namespace ouzel
         std::string s;
     };
 
-    class Logger final
+    // Returned for the levels that are compiled out, all the output operators are no-ops
+    class NullLog final
     {
     public:
-        explicit Logger(Log::Level initThreshold = Log::Level::all):
-            threshold(initThreshold)
+        template <typename T>
+        constexpr NullLog& operator<<(const T&) noexcept
         {
+            return *this;
         }
+    };
+
+    constexpr auto maxLogLevel = static_cast<Log::Level>(OUZEL_LOG_LEVEL);
+
+    class Logger final
+    {
+    public:
+        enum class OverflowPolicy
+        {
+            drop, // discard the messages that don't fit in the ring
+            block, // wait until the background thread makes room
+            count // discard the messages and report how many were lost
+        };
+
+        explicit Logger(Log::Level initThreshold = Log::Level::all);
+        ~Logger();
 
         Logger(const Logger&) = delete;
         Logger& operator=(const Logger&) = delete;
@@ -177,29 +208,57 @@ namespace ouzel
             return Log(*this, level);
         }
 
+        template <Log::Level level>
+        auto log() const
+        {
+            if constexpr (level <= maxLogLevel)
+                return Log(*this, level);
+            else
+                return NullLog{};
+        }
+
         void log(const std::string& str, const Log::Level level = Log::Level::info) const
         {
-            if (level <= threshold)
-            {
-#if !defined(__EMSCRIPTEN__)
-                std::scoped_lock lock(logMutex);
-#endif
-                logString(str, level);
-            }
+            if (isEnabled(level)) output(str, level);
         }
 
+        bool isEnabled(const Log::Level level) const noexcept
+        {
+            return level <= threshold.load(std::memory_order_relaxed);
+        }
+
+        // Writes the log to the file instead of the platform's log output
+        void setFile(const storage::Path& path);
+
+        // Moves the formatting and writing of the log to a background thread
+        // Every thread that logs gets its own ring of ringSize bytes
+        void startAsync(OverflowPolicy policy = OverflowPolicy::count,
+                        std::size_t ringSize = 65536);
+
+        // Stops the background thread after writing out all the pending messages
+        void stopAsync();
+
     private:
-        static void logString(const std::string& str, const Log::Level level = Log::Level::info);
+        class Sink; // the file and the state of the asynchronous logging, defined in Log.cpp
 
-#ifdef DEBUG
-        std::atomic<Log::Level> threshold{Log::Level::all};
-#else
-        std::atomic<Log::Level> threshold{Log::Level::info};
-#endif
+        static std::uint64_t generateId() noexcept;
+        static void logString(const std::string& str, const Log::Level level = Log::Level::info);
 
-#if !defined(__EMSCRIPTEN__)
-        mutable std::mutex logMutex;
-#endif
+        void output(const std::string& str, const Log::Level level) const;
+        void write(const std::string& str, const Log::Level level) const;
+        void writeSync(const std::string& str, const Log::Level level) const;
+        void push(const std::string& str, const Log::Level level) const;
+        LogRing& getRing() const;
+        void drain() const;
+        void drainMain();
+
+        std::atomic<Log::Level> threshold;
+
+        const std::uint64_t id;
+        std::atomic<bool> async{false};
+        mutable std::atomic<std::size_t> producers{0}; // number of threads inside push
+        mutable std::atomic<std::uint64_t> sequence{0};
+        std::unique_ptr<Sink> sink;
     };
 
     inline Log::~Log()
@@ -264,6 +323,19 @@ namespace ouzel
     }
 
     extern Logger logger;
+
+    // Used by OUZEL_LOG to turn the output expression into void
+    struct LogVoidify final
+    {
+        void operator&(const Log&) const noexcept {}
+        void operator&(const NullLog&) const noexcept {}
+    };
 }
 
+// Logs at the given level, for example OUZEL_LOG(Log::Level::info) << "Value: " << value;
+// The operands are not evaluated if the level is compiled out or below the threshold of the logger
+#define OUZEL_LOG(level) \
+    !((level) <= ouzel::maxLogLevel && ouzel::logger.isEnabled(level)) ? static_cast<void>(0) : \
+        ouzel::LogVoidify{} & ouzel::logger.log<level>()
+
 #endif // OUZEL_UTILS_LOG_HPP
@@ -0,0 +1,93 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_UTILS_POOL_HPP
+#define OUZEL_UTILS_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ouzel
+{
+    // Stores the objects in chunks of contiguous memory, released objects stay constructed
+    // and are handed out again by acquire, the objects never move until the pool is destroyed
+    template <class T>
+    class Pool final
+    {
+    public:
+        explicit Pool(std::size_t initChunkSize = 64):
+            chunkSize(initChunkSize)
+        {
+            if (chunkSize == 0)
+                throw std::runtime_error("Invalid pool chunk size");
+        }
+
+        ~Pool()
+        {
+            // destroy in the reverse order of construction
+            for (auto chunk = chunks.rbegin(); chunk != chunks.rend(); ++chunk)
+            {
+                const auto count = (chunk == chunks.rbegin()) ? lastChunkSize : chunkSize;
+                for (std::size_t i = count; i > 0; --i)
+                    std::launder(reinterpret_cast<T*>(&(*chunk)[i - 1]))->~T();
+            }
+        }
+
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+
+        Pool(Pool&&) = delete;
+        Pool& operator=(Pool&&) = delete;
+
+        // Constructs a new object, allocates a chunk only when the last one is full
+        template <class... Args>
+        T& create(Args&&... args)
+        {
+            if (chunks.empty() || lastChunkSize == chunkSize)
+            {
+                chunks.push_back(std::make_unique<Storage[]>(chunkSize));
+                lastChunkSize = 0;
+            }
+
+            T* object = new (&chunks.back()[lastChunkSize]) T(std::forward<Args>(args)...);
+            ++lastChunkSize;
+            return *object;
+        }
+
+        // Returns a released object or nullptr if there is none
+        T* acquire() noexcept
+        {
+            if (freeObjects.empty()) return nullptr;
+
+            T* object = freeObjects.back();
+            freeObjects.pop_back();
+            return object;
+        }
+
+        void release(T& object)
+        {
+            freeObjects.push_back(&object);
+        }
+
+        std::size_t getSize() const noexcept
+        {
+            return chunks.empty() ? 0 : (chunks.size() - 1) * chunkSize + lastChunkSize;
+        }
+
+        auto getFreeCount() const noexcept { return freeObjects.size(); }
+
+    private:
+        using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+        std::size_t chunkSize;
+        std::size_t lastChunkSize = 0;
+        std::vector<std::unique_ptr<Storage[]>> chunks;
+        std::vector<T*> freeObjects;
+    };
+}
+
+#endif // OUZEL_UTILS_POOL_HPP
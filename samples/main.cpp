@@ -37,10 +37,10 @@ namespace samples
                     if (++arg != args.end())
                         sample = *arg;
                     else
-                        ouzel::logger.log(ouzel::Log::Level::warning) << "No sample specified";
+                        OUZEL_LOG(ouzel::Log::Level::warning) << "No sample specified";
                 }
                 else
-                    ouzel::logger.log(ouzel::Log::Level::warning) << "Invalid argument \"" << *arg << "\"";
+                    OUZEL_LOG(ouzel::Log::Level::warning) << "Invalid argument \"" << *arg << "\"";
             }
 
 #if !defined(__ANDROID__)
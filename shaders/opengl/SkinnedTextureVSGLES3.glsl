@@ -0,0 +1,21 @@
+#version 300 es
+precision highp float;
+in vec3 position0;
+in vec4 color0;
+in vec2 texCoord0;
+in vec4 blendIndices0;
+in vec4 blendWeight0;
+uniform mat4 modelViewProj;
+uniform mat4 bones[60];
+out lowp vec4 exColor;
+out vec2 exTexCoord;
+void main()
+{
+    mat4 skinTransform = bones[int(blendIndices0.x)] * blendWeight0.x +
+        bones[int(blendIndices0.y)] * blendWeight0.y +
+        bones[int(blendIndices0.z)] * blendWeight0.z +
+        bones[int(blendIndices0.w)] * blendWeight0.w;
+    gl_Position = modelViewProj * (skinTransform * vec4(position0, 1.0));
+    exColor = color0;
+    exTexCoord = texCoord0;
+}
@@ -9,12 +9,16 @@ xxd -i ColorPSGL3.glsl ColorPSGL3.h
 xxd -i ColorVSGL3.glsl ColorVSGL3.h
 xxd -i TexturePSGL3.glsl TexturePSGL3.h
 xxd -i TextureVSGL3.glsl TextureVSGL3.h
+xxd -i SkinnedTextureVSGL3.glsl SkinnedTextureVSGL3.h
+xxd -i InstancedTextureVSGL3.glsl InstancedTextureVSGL3.h
 
 # OpenGL 4
 xxd -i ColorPSGL4.glsl ColorPSGL4.h
 xxd -i ColorVSGL4.glsl ColorVSGL4.h
 xxd -i TexturePSGL4.glsl TexturePSGL4.h
 xxd -i TextureVSGL4.glsl TextureVSGL4.h
+xxd -i SkinnedTextureVSGL4.glsl SkinnedTextureVSGL4.h
+xxd -i InstancedTextureVSGL4.glsl InstancedTextureVSGL4.h
 
 # OpenGL ES 2
 xxd -i ColorPSGLES2.glsl ColorPSGLES2.h
@@ -26,4 +30,5 @@ xxd -i TextureVSGLES2.glsl TextureVSGLES2.h
 xxd -i ColorPSGLES3.glsl ColorPSGLES3.h
 xxd -i ColorVSGLES3.glsl ColorVSGLES3.h
 xxd -i TexturePSGLES3.glsl TexturePSGLES3.h
-xxd -i TextureVSGLES3.glsl TextureVSGLES3.h
\ No newline at end of file
+xxd -i TextureVSGLES3.glsl TextureVSGLES3.h
+xxd -i SkinnedTextureVSGLES3.glsl SkinnedTextureVSGLES3.h
\ No newline at end of file
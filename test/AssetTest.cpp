@@ -0,0 +1,78 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Test.hpp"
+#include "assets/Bundle.hpp"
+#include "assets/Cache.hpp"
+#include "core/Engine.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        // Writes an uncompressed 4x4 greyscale TGA image
+        void writeImage(const std::string& filename, std::uint8_t value)
+        {
+            const std::uint8_t header[18] = {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 4, 0, 8, 0};
+            const std::vector<std::uint8_t> pixels(4 * 4, value);
+
+            std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+            if (!file)
+                throw TestError("Failed to write " + filename);
+        }
+    }
+
+    void testAssetEviction()
+    {
+        auto& cache = engine->getCache();
+        const std::string filenames[] = {"AssetTestA.tga", "AssetTestB.tga", "AssetTestC.tga"};
+        for (const auto& filename : filenames)
+            writeImage(filename, 255);
+
+        // the textures of the other bundles are not evictable, but they count towards the budget
+        const auto baseSize = cache.getResidency(assets::AssetType::texture).size;
+
+        {
+            assets::Bundle bundle(cache, engine->getFileSystem());
+            bundle.loadAsset(assets::Loader::Type::image, "a", filenames[0], false);
+            const auto textureSize = cache.getResidency(assets::AssetType::texture).size - baseSize;
+            expect(textureSize > 0, "The texture was not tracked");
+
+            // only one of the textures fits in the budget, the least recently used one is evicted
+            cache.setBudget(assets::AssetType::texture, baseSize + textureSize);
+            bundle.loadAsset(assets::Loader::Type::image, "b", filenames[1], false);
+            expect(bundle.getEvictedCount() == 1 && !bundle.getTexture("a"), "The least recently used texture was not evicted");
+
+            // the held texture can't be evicted, so the new one is evicted right after it is loaded
+            const auto held = cache.getTexture("b");
+            bundle.loadAsset(assets::Loader::Type::image, "c", filenames[2], false);
+            expect(bundle.getEvictedCount() == 2 && !bundle.getTexture("c") && bundle.getTexture("b") == held,
+                   "The held texture was evicted");
+
+            // the lookup loads the evicted texture again, even if it exceeds the budget until the next load
+            const auto reloaded = cache.getTexture("a");
+            expect(reloaded && bundle.getTexture("a") == reloaded, "The evicted texture was not loaded again");
+            expect(bundle.getEvictedCount() == 1, "The reloaded texture is still evicted");
+
+            // a failed reload returns null and keeps the file, so that it can be retried
+            std::remove(filenames[2].c_str());
+            expect(!cache.getTexture("c"), "The texture was loaded from a missing file");
+            expect(bundle.getEvictedCount() == 1, "The source of the texture was lost");
+
+            writeImage(filenames[2], 128);
+            expect(cache.getTexture("c") != nullptr, "The texture was not loaded after the file was restored");
+            expect(bundle.getEvictedCount() == 0, "The reloaded texture is still evicted");
+
+            cache.setBudget(assets::AssetType::texture, 0);
+        }
+
+        for (const auto& filename : filenames)
+            std::remove(filename.c_str());
+    }
+}
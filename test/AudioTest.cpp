@@ -0,0 +1,103 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "Test.hpp"
+#include "audio/Audio.hpp"
+#include "audio/Oscillator.hpp"
+#include "audio/Voice.hpp"
+#include "audio/offline/OfflineAudioDevice.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        constexpr std::uint32_t sampleRate = 44100;
+        constexpr std::uint32_t frameCount = sampleRate / 4;
+        constexpr std::uint32_t cueFrame = 4410; // not a multiple of the buffer size
+
+        // Renders silence followed by a square wave that is started by a cue, to the memory or to the wave file
+        std::vector<std::uint8_t> renderTone(audio::SampleFormat sampleFormat, const std::string& filename = {})
+        {
+            audio::Settings settings;
+            settings.bufferSize = 512;
+            settings.sampleRate = sampleRate;
+            settings.channels = 1;
+            settings.sampleFormat = sampleFormat;
+
+            audio::Audio audio(audio::Driver::offline, settings);
+            auto& device = static_cast<audio::offline::AudioDevice&>(*audio.getDevice());
+
+            audio::Oscillator tone(audio, 441.0F, audio::Oscillator::Type::square, 0.5F);
+            audio::Voice voice(audio, &tone);
+            voice.setOutput(&audio.getMasterMix());
+
+            device.schedule(static_cast<double>(cueFrame) / sampleRate, [&voice]() { voice.play(); });
+
+            if (!filename.empty()) device.openOutputFile(filename);
+
+            const auto statistics = device.render(static_cast<double>(frameCount) / sampleRate);
+            expect(statistics.frames == frameCount && device.getFrame() == frameCount,
+                   "The clock must advance by the rendered frames");
+
+            if (!filename.empty()) device.closeOutputFile();
+
+            return device.getRenderedData();
+        }
+
+        std::uint32_t readUInt32(const std::vector<char>& data, std::size_t offset)
+        {
+            return static_cast<std::uint32_t>(static_cast<std::uint8_t>(data[offset])) |
+                (static_cast<std::uint32_t>(static_cast<std::uint8_t>(data[offset + 1])) << 8) |
+                (static_cast<std::uint32_t>(static_cast<std::uint8_t>(data[offset + 2])) << 16) |
+                (static_cast<std::uint32_t>(static_cast<std::uint8_t>(data[offset + 3])) << 24);
+        }
+    }
+
+    void testOfflineAudio()
+    {
+        const auto data = renderTone(audio::SampleFormat::float32);
+        expect(data == renderTone(audio::SampleFormat::float32), "The renders of the same input differ");
+        expect(data.size() == frameCount * sizeof(float), "Invalid size of the rendered data");
+
+        std::vector<float> samples(frameCount);
+        std::memcpy(samples.data(), data.data(), data.size());
+
+        // the block is split at the cue, so the tone starts at its exact frame
+        expect(std::all_of(samples.begin(), samples.begin() + cueFrame, [](float sample) { return sample == 0.0F; }),
+               "The tone started before the cue");
+        expect(samples[cueFrame] != 0.0F, "The tone did not start at the frame of the cue");
+
+        // the sizes in the header of the wave file match the data
+        const std::string filename = "OfflineAudioTest.wav";
+        const auto memoryData = renderTone(audio::SampleFormat::signedInt16, filename);
+        expect(memoryData.empty(), "The data was rendered to the memory instead of the file");
+
+        std::vector<char> file;
+        {
+            std::ifstream stream(filename, std::ios::binary);
+            file.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        }
+        std::remove(filename.c_str());
+
+        constexpr std::size_t headerSize = 44;
+        constexpr std::uint32_t dataSize = frameCount * sizeof(std::int16_t);
+
+        expect(file.size() == headerSize + dataSize, "Invalid size of the wave file");
+        expect(std::memcmp(file.data(), "RIFF", 4) == 0 && std::memcmp(file.data() + 8, "WAVE", 4) == 0 &&
+               std::memcmp(file.data() + 36, "data", 4) == 0, "Invalid wave header");
+        expect(readUInt32(file, 4) == file.size() - 8, "Invalid RIFF chunk size");
+        expect(readUInt32(file, 24) == sampleRate, "Invalid sample rate");
+        expect(readUInt32(file, 40) == dataSize, "Invalid data chunk size");
+
+        std::int16_t cueSample;
+        std::memcpy(&cueSample, file.data() + headerSize + cueFrame * sizeof(std::int16_t), sizeof(cueSample));
+        expect(cueSample != 0, "The tone did not start at the frame of the cue in the wave file");
+    }
+}
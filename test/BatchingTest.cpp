@@ -0,0 +1,123 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "Test.hpp"
+#include "assets/Bundle.hpp"
+#include "core/Engine.hpp"
+#include "graphics/BlendState.hpp"
+#include "graphics/Shader.hpp"
+#include "scene/Actor.hpp"
+#include "scene/Camera.hpp"
+#include "scene/Layer.hpp"
+#include "scene/Scene.hpp"
+#include "scene/StaticMeshRenderer.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        // The empty render device doesn't compile shaders, so the built-in shaders are only placeholders
+        std::unique_ptr<graphics::Shader> createShader(const std::set<graphics::Vertex::Attribute::Usage>& vertexAttributes)
+        {
+            return std::make_unique<graphics::Shader>(*engine->getGraphics(),
+                                                      std::vector<std::uint8_t>{},
+                                                      std::vector<std::uint8_t>{},
+                                                      vertexAttributes,
+                                                      std::vector<std::pair<std::string, graphics::DataType>>{},
+                                                      std::vector<std::pair<std::string, graphics::DataType>>{});
+        }
+
+        std::size_t probeResourceId()
+        {
+            const graphics::Buffer buffer(*engine->getGraphics(), graphics::BufferType::vertex, graphics::Flags::dynamic);
+            return buffer.getResource();
+        }
+    }
+
+    void benchmarkBatching()
+    {
+        constexpr std::size_t meshCount = 10000;
+        constexpr std::size_t materialCount = 4; // consecutive renderers with the same material are merged
+
+        assets::Bundle bundle(engine->getCache(), engine->getFileSystem());
+        bundle.setShader(shaderTexture, createShader({
+            graphics::Vertex::Attribute::Usage::position,
+            graphics::Vertex::Attribute::Usage::color,
+            graphics::Vertex::Attribute::Usage::textureCoordinates0
+        }));
+        bundle.setShader(shaderInstancedTexture, createShader({
+            graphics::Vertex::Attribute::Usage::position,
+            graphics::Vertex::Attribute::Usage::color,
+            graphics::Vertex::Attribute::Usage::textureCoordinates0,
+            graphics::Vertex::Attribute::Usage::instanceTransform,
+            graphics::Vertex::Attribute::Usage::instanceColor
+        }));
+
+        const graphics::BlendState blendState(*engine->getGraphics());
+
+        std::vector<std::unique_ptr<graphics::Material>> materials;
+        std::vector<std::unique_ptr<scene::StaticMeshData>> meshes;
+        for (std::size_t i = 0; i < materialCount; ++i)
+        {
+            auto& material = materials.emplace_back(std::make_unique<graphics::Material>());
+            material->blendState = &blendState;
+            material->shader = engine->getCache().getShader(shaderTexture);
+            material->textures[0] = engine->getCache().getTexture(textureWhitePixel);
+
+            const std::vector<graphics::Vertex> vertices = {
+                graphics::Vertex(Vector3F(-0.5F, -0.5F, 0.0F), Color::white(), Vector2F(0.0F, 1.0F), Vector3F(0.0F, 0.0F, -1.0F)),
+                graphics::Vertex(Vector3F(0.5F, -0.5F, 0.0F), Color::white(), Vector2F(1.0F, 1.0F), Vector3F(0.0F, 0.0F, -1.0F)),
+                graphics::Vertex(Vector3F(0.5F, 0.5F, 0.0F), Color::white(), Vector2F(1.0F, 0.0F), Vector3F(0.0F, 0.0F, -1.0F)),
+                graphics::Vertex(Vector3F(-0.5F, 0.5F, 0.0F), Color::white(), Vector2F(0.0F, 0.0F), Vector3F(0.0F, 0.0F, -1.0F))
+            };
+
+            meshes.push_back(std::make_unique<scene::StaticMeshData>(Box3F(Vector3F(-0.5F, -0.5F, 0.0F), Vector3F(0.5F, 0.5F, 0.0F)),
+                                                                     std::vector<std::uint32_t>{0, 1, 2, 0, 2, 3},
+                                                                     vertices,
+                                                                     material.get()));
+        }
+
+        scene::Scene scene;
+        scene::Layer layer;
+        scene.addLayer(layer);
+
+        scene::Actor cameraActor;
+        scene::Camera camera;
+        cameraActor.addComponent(camera);
+        layer.addChild(cameraActor);
+
+        std::vector<std::unique_ptr<scene::Actor>> actors;
+        std::vector<std::unique_ptr<scene::StaticMeshRenderer>> renderers;
+        for (std::size_t i = 0; i < meshCount; ++i)
+        {
+            auto& actor = actors.emplace_back(std::make_unique<scene::Actor>());
+            auto& renderer = renderers.emplace_back(std::make_unique<scene::StaticMeshRenderer>(*meshes[i * materialCount / meshCount]));
+            actor->addComponent(*renderer);
+            actor->setCullDisabled(true);
+            actor->setPosition(Vector2F(static_cast<float>(i % 100), static_cast<float>(i / 100)));
+            layer.addChild(*actor);
+        }
+
+        // the first frame finds how many instance buffers are needed and the second one creates them
+        scene.draw();
+        scene.draw();
+        const auto resourceId = probeResourceId();
+
+        const auto duration = measure(10, [&scene]() {
+            scene.draw();
+        });
+
+        // the device counts the draw calls of a frame when the next frame is submitted
+        const auto drawCallCount = engine->getGraphics()->getDevice()->getDrawCallCount();
+        expect(drawCallCount == materialCount, "Expected a draw call per material, got " + std::to_string(drawCallCount));
+        expect(probeResourceId() == resourceId, "Instance buffers are allocated every frame");
+
+        std::cout << "Batching (" << meshCount << " meshes, " << materialCount << " materials): " <<
+            drawCallCount << " draw calls, " << duration << " ms per frame\n";
+    }
+}
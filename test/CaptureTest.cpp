@@ -0,0 +1,73 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include "Test.hpp"
+#include "graphics/CommandCapture.hpp"
+#include "graphics/Commands.hpp"
+
+namespace ouzel::test
+{
+    void testCaptureRoundTrip()
+    {
+        const std::string filename = "test_capture.bin";
+
+        {
+            graphics::CaptureWriter writer(filename);
+
+            graphics::CommandBuffer commandBuffer;
+            commandBuffer.pushCommand(std::make_unique<graphics::DrawCommand>(1, 6, 2, 2,
+                                                                              graphics::DrawMode::triangleList,
+                                                                              3, 4, 5, 6, 7));
+            commandBuffer.pushCommand(std::make_unique<graphics::PresentCommand>());
+            writer.write(commandBuffer);
+        }
+
+        // the captures must not be mistaken for the cooked assets
+        {
+            std::ifstream file(filename, std::ios::binary);
+            char magic[4];
+            expect(file.read(magic, sizeof(magic)) && std::memcmp(magic, "OUZC", sizeof(magic)) != 0,
+                   "The capture has the magic of the cooked assets");
+        }
+
+        try
+        {
+            graphics::CaptureReader reader(filename);
+
+            graphics::CommandBuffer commandBuffer;
+            std::chrono::nanoseconds delay;
+            expect(reader.read(commandBuffer, delay), "Failed to read the command buffer");
+
+            const auto command = commandBuffer.popCommand();
+            expect(command->type == graphics::Command::Type::draw, "Expected a draw command");
+
+            const auto& drawCommand = static_cast<const graphics::DrawCommand&>(*command);
+            expect(drawCommand.indexBuffer == 1 &&
+                   drawCommand.indexCount == 6 &&
+                   drawCommand.indexSize == 2 &&
+                   drawCommand.vertexBuffer == 2 &&
+                   drawCommand.drawMode == graphics::DrawMode::triangleList &&
+                   drawCommand.startIndex == 3 &&
+                   drawCommand.baseVertex == 4 &&
+                   drawCommand.instanceBuffer == 5 &&
+                   drawCommand.instanceCount == 6 &&
+                   drawCommand.skinBuffer == 7, "Invalid draw command");
+
+            expect(commandBuffer.popCommand()->type == graphics::Command::Type::present, "Expected a present command");
+            expect(commandBuffer.isEmpty(), "Too many commands");
+            expect(!reader.read(commandBuffer, delay), "Expected the end of the capture");
+        }
+        catch (...)
+        {
+            std::remove(filename.c_str());
+            throw;
+        }
+
+        std::remove(filename.c_str());
+    }
+}
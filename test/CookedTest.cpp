@@ -0,0 +1,73 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Test.hpp"
+#include "formats/Cooked.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        template <class F>
+        bool throwsFormatError(F function)
+        {
+            try
+            {
+                function();
+            }
+            catch (const cooked::FormatError&)
+            {
+                return true;
+            }
+
+            return false;
+        }
+    }
+
+    void testProgramBinaryRoundTrip()
+    {
+        constexpr std::uint64_t key = 0x0123456789ABCDEFULL;
+        constexpr std::uint32_t binaryFormat = 0x8741;
+
+        std::vector<std::uint8_t> programData(1000);
+        for (std::size_t i = 0; i < programData.size(); ++i)
+            programData[i] = static_cast<std::uint8_t>(i * 7);
+
+        const std::vector<std::int32_t> uniformLocations{3, -1, 0, 12};
+
+        auto data = cooked::writeProgramBinary(key, binaryFormat, programData, uniformLocations);
+
+        const auto entry = cooked::readProgramBinary(data.data(), data.size(), key, uniformLocations.size());
+        expect(entry.binaryFormat == binaryFormat, "Invalid binary format");
+        expect(entry.programData.getSize() == programData.size() &&
+               std::equal(programData.begin(), programData.end(),
+                          reinterpret_cast<const std::uint8_t*>(entry.programData.getData())),
+               "Invalid program data");
+        expect(std::equal(uniformLocations.begin(), uniformLocations.end(), entry.uniformLocations),
+               "Invalid uniform locations");
+
+        // the entries of other programs are rejected
+        expect(throwsFormatError([&data, &uniformLocations]() {
+            cooked::readProgramBinary(data.data(), data.size(), key + 1, uniformLocations.size());
+        }), "Entry with a different key was accepted");
+
+        expect(throwsFormatError([&data, &uniformLocations]() {
+            cooked::readProgramBinary(data.data(), data.size(), key, uniformLocations.size() + 1);
+        }), "Entry with a different uniform count was accepted");
+
+        // truncated and corrupted entries are rejected
+        expect(throwsFormatError([&data, &uniformLocations]() {
+            cooked::readProgramBinary(data.data(), data.size() / 2, key, uniformLocations.size());
+        }), "Truncated entry was accepted");
+
+        const auto offset = static_cast<std::size_t>(entry.programData.getData() - data.data());
+        data[offset + programData.size() / 2] ^= std::byte{0x01};
+
+        expect(throwsFormatError([&data, &uniformLocations]() {
+            cooked::readProgramBinary(data.data(), data.size(), key, uniformLocations.size());
+        }), "Corrupted entry was accepted");
+    }
+}
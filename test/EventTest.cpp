@@ -0,0 +1,60 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "Test.hpp"
+#include "events/EventDispatcher.hpp"
+#include "events/EventHandler.hpp"
+
+namespace ouzel::test
+{
+    void benchmarkEventDispatch()
+    {
+        constexpr std::size_t idleHandlerCount = 10000;
+        constexpr std::size_t mouseHandlerCount = 16;
+        constexpr std::size_t eventCount = 100000;
+
+        EventDispatcher dispatcher;
+
+        // update handlers (like the ones of the animators) that are not interested in the mouse events
+        std::vector<std::unique_ptr<EventHandler>> handlers;
+        for (std::size_t i = 0; i < idleHandlerCount; ++i)
+        {
+            auto& handler = handlers.emplace_back(std::make_unique<EventHandler>());
+            handler->updateHandler = [](const UpdateEvent&) { return false; };
+            dispatcher.addEventHandler(*handler);
+        }
+
+        std::size_t handled = 0;
+        for (std::size_t i = 0; i < mouseHandlerCount; ++i)
+        {
+            auto& handler = handlers.emplace_back(std::make_unique<EventHandler>());
+            handler->mouseHandler = [&handled](const MouseEvent&) { ++handled; return false; };
+            dispatcher.addEventHandler(*handler);
+        }
+
+        dispatcher.dispatchEvents(); // registers the handlers
+
+        const auto mouseDuration = measure(10, [&dispatcher]() {
+            for (std::size_t i = 0; i < eventCount; ++i)
+            {
+                MouseEvent event;
+                event.type = Event::Type::mouseMove;
+                dispatcher.dispatchEvent(event);
+            }
+        });
+
+        expect(handled == 11 * eventCount * mouseHandlerCount, "Mouse handlers were not called");
+
+        const auto updateDuration = measure(10, [&dispatcher]() {
+            UpdateEvent event;
+            event.type = Event::Type::update;
+            dispatcher.dispatchEvent(event);
+        });
+
+        std::cout << "Event dispatch (" << idleHandlerCount << " idle handlers): " <<
+            mouseDuration * 1000000.0 / eventCount << " ns per mouse event, " <<
+            updateDuration * 1000.0 << " us per update event\n";
+    }
+}
@@ -0,0 +1,136 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include "Test.hpp"
+#include "core/FrameScheduler.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        using namespace std::chrono_literals;
+
+        bool isNear(float a, float b) noexcept
+        {
+            return std::fabs(a - b) < 0.00001F;
+        }
+
+        template <class F>
+        bool throwsRuntimeError(F function)
+        {
+            try
+            {
+                function();
+            }
+            catch (const std::runtime_error&)
+            {
+                return true;
+            }
+
+            return false;
+        }
+    }
+
+    void testFrameSchedulerVariableStep()
+    {
+        core::FrameScheduler scheduler;
+        const std::chrono::steady_clock::time_point start;
+
+        expect(scheduler.beginFrame(start).updateCount == 0, "The first frame has nothing to measure");
+
+        auto frame = scheduler.beginFrame(start + 16ms);
+        expect(frame.updateCount == 1 && isNear(frame.delta, 0.016F), "Invalid frame of 16 ms");
+
+        // the frames shorter than a millisecond are merged with the next one
+        frame = scheduler.beginFrame(start + 16500us);
+        expect(frame.updateCount == 0, "The short frame was not merged");
+
+        frame = scheduler.beginFrame(start + 20ms);
+        expect(frame.updateCount == 1 && isNear(frame.delta, 0.004F), "Invalid merged frame");
+
+        // the long frames are clamped, so a hitch doesn't make the simulation jump
+        frame = scheduler.beginFrame(start + 220ms);
+        expect(frame.updateCount == 1 && isNear(frame.delta, 0.05F), "The long frame was not clamped");
+        expect(scheduler.getDroppedTime() == 150ms, "Invalid dropped time");
+
+        // the measuring starts again after a reset
+        scheduler.reset();
+        expect(scheduler.beginFrame(start + 10s).updateCount == 0, "The pause was measured");
+        frame = scheduler.beginFrame(start + 10s + 10ms);
+        expect(frame.updateCount == 1 && isNear(frame.delta, 0.01F), "Invalid frame after the reset");
+        expect(scheduler.getFrameTimeHistogram().getCount() == 4, "Invalid frame count");
+    }
+
+    void testFrameSchedulerFixedStep()
+    {
+        core::FrameScheduler scheduler;
+        scheduler.setMode(core::FrameScheduler::Mode::fixedStep);
+        scheduler.setTickRate(100.0F); // 10 ms ticks
+        scheduler.setMaxTicksPerFrame(3);
+        scheduler.setMaxFrameTime(50ms);
+
+        const std::chrono::steady_clock::time_point start;
+        scheduler.beginFrame(start);
+
+        auto frame = scheduler.beginFrame(start + 25ms);
+        expect(frame.updateCount == 2 && isNear(frame.delta, 0.01F), "Invalid tick count");
+        expect(isNear(frame.interpolation, 0.5F), "Invalid interpolation");
+        expect(scheduler.getDroppedTime() == 0ms, "No time was expected to be dropped");
+
+        // 52 ms of simulation time, only 3 ticks are allowed and the 2 whole ticks that did not fit are skipped
+        frame = scheduler.beginFrame(start + 72ms);
+        expect(frame.updateCount == 3, "The catch-up limit was not applied");
+        expect(isNear(frame.interpolation, 0.2F), "The remainder was not kept");
+        expect(scheduler.getDroppedTime() == 20ms, "Invalid dropped time of the skipped ticks");
+
+        // 120 ms is clamped to 50 ms first, then the catch-up limit skips 2 ticks
+        frame = scheduler.beginFrame(start + 192ms);
+        expect(frame.updateCount == 3, "The catch-up limit was not applied after the clamp");
+        expect(isNear(frame.interpolation, 0.2F), "The remainder was not kept after the clamp");
+        expect(scheduler.getDroppedTime() == 110ms, "Invalid dropped time of the clamped frame");
+
+        // frames shorter than a tick only advance the interpolation
+        frame = scheduler.beginFrame(start + 197ms);
+        expect(frame.updateCount == 0 && isNear(frame.interpolation, 0.7F), "Invalid short frame");
+
+        // changing the mode discards the accumulated time
+        scheduler.setMode(core::FrameScheduler::Mode::fixedStep);
+        frame = scheduler.beginFrame(start + 206ms);
+        expect(frame.updateCount == 0 && isNear(frame.interpolation, 0.9F), "The accumulator was not reset");
+
+        expect(throwsRuntimeError([&scheduler]() { scheduler.setTickRate(0.0F); }), "Invalid tick rate was accepted");
+        expect(throwsRuntimeError([&scheduler]() { scheduler.setMaxTicksPerFrame(0); }), "Zero ticks per frame were accepted");
+        expect(throwsRuntimeError([&scheduler]() { scheduler.setMaxFrameTime(0ms); }), "Zero frame time was accepted");
+    }
+
+    void testFrameTimeHistogram()
+    {
+        core::FrameScheduler::Histogram histogram;
+        expect(histogram.getPercentile(50.0F) == 0us && histogram.getAverage() == 0us, "The empty histogram is not empty");
+
+        histogram.add(4500us);
+        histogram.add(4ms);
+        histogram.add(16ms);
+        histogram.add(250ms); // longer than the last bucket
+
+        expect(histogram.getCount() == 4, "Invalid frame count");
+        expect(histogram.getBuckets()[4] == 2 && histogram.getBuckets()[16] == 1 &&
+               histogram.getBuckets()[core::FrameScheduler::Histogram::bucketCount - 1] == 1, "Invalid buckets");
+        expect(histogram.getMinimum() == 4ms && histogram.getMaximum() == 250ms, "Invalid minimum or maximum");
+        expect(histogram.getAverage() == 68625us, "Invalid average");
+
+        // the percentiles are the upper bounds of the buckets, except for the last one that has no bound
+        expect(histogram.getPercentile(0.0F) == 5ms, "Invalid 0th percentile");
+        expect(histogram.getPercentile(50.0F) == 5ms, "Invalid median");
+        expect(histogram.getPercentile(75.0F) == 17ms, "Invalid 75th percentile");
+        expect(histogram.getPercentile(99.0F) == 17ms, "Invalid 99th percentile");
+        expect(histogram.getPercentile(100.0F) == 250ms, "The last bucket must report the maximum");
+        expect(histogram.getPercentile(1000.0F) == 250ms, "The percentile was not clamped");
+
+        histogram.reset();
+        expect(histogram.getCount() == 0 && histogram.getMinimum() == 0us && histogram.getMaximum() == 0us,
+               "The histogram was not reset");
+    }
+}
@@ -0,0 +1,101 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Test.hpp"
+#include "assets/GltfLoader.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        // reference files are in the data directory of the test target
+        std::vector<std::byte> readFile(const std::string& filename)
+        {
+            std::ifstream file("data/" + filename, std::ios::binary);
+            if (!file)
+                throw TestError("Failed to open " + filename);
+
+            std::vector<std::byte> result;
+            for (auto i = std::istreambuf_iterator<char>(file); i != std::istreambuf_iterator<char>(); ++i)
+                result.push_back(static_cast<std::byte>(*i));
+            return result;
+        }
+
+        void checkQuad(const std::vector<std::pair<std::string, scene::SkinnedMeshData>>& meshes)
+        {
+            expect(meshes.size() == 1, "Expected one mesh");
+            expect(meshes[0].first == "quad", "Invalid mesh name " + meshes[0].first);
+
+            const auto& meshData = meshes[0].second;
+
+            const Vector3F positions[] = {
+                Vector3F(-1.0F, -1.0F, 0.0F), Vector3F(1.0F, -1.0F, 0.0F),
+                Vector3F(1.0F, 1.0F, 0.0F), Vector3F(-1.0F, 1.0F, 0.0F)
+            };
+            const Vector2F texCoords[] = {
+                Vector2F(0.0F, 1.0F), Vector2F(1.0F, 1.0F),
+                Vector2F(1.0F, 0.0F), Vector2F(0.0F, 0.0F)
+            };
+
+            expect(meshData.vertices.size() == 4, "Expected 4 vertices, got " + std::to_string(meshData.vertices.size()));
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                const auto& vertex = meshData.vertices[i];
+                expect(vertex.position == positions[i], "Invalid position of vertex " + std::to_string(i));
+                expect(vertex.normal == Vector3F(0.0F, 0.0F, 1.0F), "Invalid normal of vertex " + std::to_string(i));
+                expect(vertex.texCoords[0] == texCoords[i], "Invalid texture coordinates of vertex " + std::to_string(i));
+                expect(vertex.color == Color::white(), "Vertex without a color attribute is not white");
+            }
+
+            expect(meshData.indices == std::vector<std::uint32_t>{0, 1, 2, 0, 2, 3}, "Invalid indices");
+            expect(meshData.primitives.size() == 1 &&
+                   meshData.primitives[0].startIndex == 0 &&
+                   meshData.primitives[0].indexCount == 6, "Invalid primitive");
+
+            expect(meshData.boundingBox.min == Vector3F(-1.0F, -1.0F, 0.0F) &&
+                   meshData.boundingBox.max == Vector3F(1.0F, 1.0F, 0.0F), "Invalid bounding box");
+        }
+    }
+
+    void testGltfText()
+    {
+        const gltf::Document document(readFile("quad.gltf"));
+        expect(!document.isBinary(), "Text glTF parsed as binary");
+
+        checkQuad(assets::GltfLoader::loadMeshes(document, {}));
+    }
+
+    void testGltfBinary()
+    {
+        const auto data = readFile("quad.glb");
+        const gltf::Document document(data);
+        expect(document.isBinary(), "Binary glTF parsed as text");
+
+        // the buffer views of the binary chunk reference the file data in place
+        const auto accessor = document.getAccessor(0);
+        expect(accessor.data >= data.data() && accessor.data < data.data() + data.size(),
+               "Binary chunk was copied");
+
+        checkQuad(assets::GltfLoader::loadMeshes(document, {}));
+    }
+
+    void testGltfInvalidIndices()
+    {
+        const gltf::Document document(readFile("quad_invalid_indices.gltf"));
+
+        try
+        {
+            assets::GltfLoader::loadMeshes(document, {});
+        }
+        catch (const std::runtime_error&)
+        {
+            return;
+        }
+
+        throw TestError("Out of range index was not rejected");
+    }
+}
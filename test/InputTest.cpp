@@ -0,0 +1,89 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Test.hpp"
+#include "core/Engine.hpp"
+#include "events/EventHandler.hpp"
+#include "input/Gamepad.hpp"
+#include "input/GamepadDevice.hpp"
+#include "input/InputManager.hpp"
+#include "input/Mouse.hpp"
+#include "input/MouseDevice.hpp"
+
+namespace ouzel::test
+{
+    void testInputQueueOverflow()
+    {
+        // the platform input system is replaced, so that the test doesn't depend on the devices of the machine
+        input::InputManager inputManager([](const input::InputSystem::EventCallback& callback) {
+            return std::make_unique<input::InputSystem>(callback);
+        });
+
+        auto& inputSystem = *inputManager.getInputSystem();
+        input::MouseDevice mouseDevice(inputSystem, input::DeviceId{1});
+        input::GamepadDevice gamepadDevice(inputSystem, input::DeviceId{2});
+        inputManager.update();
+
+        expect(inputManager.getMouse() && inputManager.getControllers().size() == 2, "The devices were not connected");
+        const auto gamepad = static_cast<input::Gamepad*>(inputManager.getControllers().back());
+
+        std::vector<bool> transitions;
+        EventHandler handler;
+        handler.gamepadHandler = [&transitions](const GamepadEvent& event) {
+            if (event.pressed != event.previousPressed) transitions.push_back(event.pressed);
+            return false;
+        };
+        engine->getEventDispatcher().addEventHandler(handler);
+        engine->getEventDispatcher().dispatchEvents(); // registers the handler
+
+        // many times more events than the queue can hold, the trigger is pressed above the half
+        constexpr std::size_t eventCount = 5000;
+        std::vector<bool> expectedTransitions;
+        bool pressed = false;
+        Vector2F position;
+
+        for (std::size_t i = 0; i < eventCount; ++i)
+        {
+            const auto value = static_cast<float>(i % 10) / 10.0F;
+            if ((value > 0.5F) != pressed)
+            {
+                pressed = !pressed;
+                expectedTransitions.push_back(pressed);
+            }
+
+            gamepadDevice.handleButtonValueChange(input::Gamepad::Button::rightTrigger, pressed, value);
+
+            position = Vector2F(static_cast<float>(i) / (eventCount * 2), 0.5F);
+            mouseDevice.handleMove(position);
+        }
+
+        inputManager.update();
+
+        expect(inputManager.getDeferredEventCount() > 0, "The event queue did not overflow");
+        expect(transitions == expectedTransitions, "Button presses or releases were lost, expected " +
+               std::to_string(expectedTransitions.size()) + " got " + std::to_string(transitions.size()));
+        expect(gamepad->getButtonState(input::Gamepad::Button::rightTrigger).value == 0.9F,
+               "The newest trigger value was lost");
+        expect(inputManager.getMouse()->getPosition() == position, "The newest mouse position was lost");
+
+        // the relative moves are summed up
+        const auto start = inputManager.getMouse()->getPosition();
+        const auto deferredEventCount = inputManager.getDeferredEventCount();
+
+        for (std::size_t i = 0; i < eventCount; ++i)
+            mouseDevice.handleRelativeMove(Vector2F(0.00005F, 0.00001F));
+
+        inputManager.update();
+
+        expect(inputManager.getDeferredEventCount() > deferredEventCount, "The event queue did not overflow");
+
+        const auto difference = inputManager.getMouse()->getPosition() - start;
+        expect(std::fabs(difference.v[0] - 0.25F) < 0.0001F && std::fabs(difference.v[1] - 0.05F) < 0.0001F,
+               "Relative moves were lost");
+
+        engine->getEventDispatcher().removeEventHandler(handler);
+    }
+}
@@ -0,0 +1,123 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Test.hpp"
+#include "thread/JobSystem.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        // About a microsecond of work that the compiler can't remove
+        std::uint32_t work(std::uint32_t seed) noexcept
+        {
+            for (std::uint32_t i = 0; i < 1000; ++i)
+                seed = seed * 1664525U + 1013904223U;
+            return seed;
+        }
+
+        std::uint32_t forkJoin(thread::JobSystem& jobSystem, std::uint32_t seed, std::size_t depth)
+        {
+            if (depth == 0) return work(seed);
+
+            std::uint32_t left = 0;
+            const auto leftJob = jobSystem.schedule([&jobSystem, &left, seed, depth]() {
+                left = forkJoin(jobSystem, seed * 2, depth - 1);
+            });
+
+            const auto right = forkJoin(jobSystem, seed * 2 + 1, depth - 1);
+            jobSystem.wait(leftJob);
+
+            return left ^ right;
+        }
+    }
+
+    void testJobCancellation()
+    {
+        thread::JobSystem jobSystem(2);
+
+        std::atomic<std::size_t> runCount{0};
+
+        const auto failed = jobSystem.schedule([]() { throw std::runtime_error("Job failed"); });
+        const auto independent = jobSystem.schedule([&runCount]() { ++runCount; });
+        const auto continuation = jobSystem.schedule([&runCount]() { ++runCount; }, {failed, independent});
+        const auto chained = jobSystem.then(continuation, [&runCount]() { ++runCount; });
+
+        try
+        {
+            jobSystem.wait(chained);
+            throw TestError("The exception of the dependency was not rethrown");
+        }
+        catch (const std::runtime_error& e)
+        {
+            expect(std::string(e.what()) == "Job failed", "Unexpected exception");
+        }
+
+        expect(runCount == 1, "The continuations of the failed job were run");
+
+        // a continuation of a job that has already failed is cancelled immediately
+        const auto late = jobSystem.then(failed, [&runCount]() { ++runCount; });
+        expect(late.isDone(), "The continuation of a failed job was scheduled");
+        expect(runCount == 1, "The continuation of a failed job was run");
+    }
+
+    void benchmarkJobSystem()
+    {
+        constexpr std::size_t jobCount = 4096;
+        constexpr std::size_t forkDepth = 12; // 4096 leaves
+
+        std::vector<std::size_t> workerCounts{0};
+        for (std::size_t workerCount = 1; workerCount < thread::JobSystem::getDefaultWorkerCount(); workerCount *= 2)
+            workerCounts.push_back(workerCount);
+        if (thread::JobSystem::getDefaultWorkerCount() > 0)
+            workerCounts.push_back(thread::JobSystem::getDefaultWorkerCount());
+
+        double serialParallelDuration = 0.0;
+        double serialForkJoinDuration = 0.0;
+        std::uint32_t serialForkJoinResult = 0;
+
+        for (const auto workerCount : workerCounts)
+        {
+            thread::JobSystem jobSystem(workerCount);
+
+            // independent jobs that are scheduled from the calling thread
+            std::vector<std::uint32_t> results(jobCount);
+            const auto parallelDuration = measure(10, [&jobSystem, &results]() {
+                std::vector<thread::JobHandle> jobs;
+                jobs.reserve(jobCount);
+                for (std::size_t i = 0; i < jobCount; ++i)
+                    jobs.push_back(jobSystem.schedule([&results, i]() {
+                        results[i] = work(static_cast<std::uint32_t>(i));
+                    }));
+                jobSystem.wait(jobs);
+            });
+
+            for (std::size_t i = 0; i < jobCount; ++i)
+                expect(results[i] == work(static_cast<std::uint32_t>(i)), "Job was not run");
+
+            // recursive splitting where every job waits for its children
+            std::uint32_t forkJoinResult = 0;
+            const auto forkJoinDuration = measure(10, [&jobSystem, &forkJoinResult]() {
+                forkJoinResult = forkJoin(jobSystem, 1, forkDepth);
+            });
+
+            if (workerCount == 0)
+            {
+                serialParallelDuration = parallelDuration;
+                serialForkJoinDuration = forkJoinDuration;
+                serialForkJoinResult = forkJoinResult;
+            }
+
+            expect(forkJoinResult == serialForkJoinResult, "Invalid fork-join result");
+
+            std::cout << "Job system (" << workerCount << " workers): " <<
+                "parallel " << parallelDuration << " ms (" << serialParallelDuration / parallelDuration << "x), " <<
+                "fork-join " << forkJoinDuration << " ms (" << serialForkJoinDuration / forkJoinDuration << "x)\n";
+        }
+    }
+}
@@ -0,0 +1,156 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "Test.hpp"
+#include "core/Engine.hpp"
+#include "formats/Cooked.hpp"
+#include "localization/Localization.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        std::vector<std::byte> readFile(const std::string& filename)
+        {
+            std::ifstream file("data/" + filename, std::ios::binary);
+            if (!file)
+                throw TestError("Failed to open " + filename);
+
+            std::vector<std::byte> result;
+            for (auto i = std::istreambuf_iterator<char>(file); i != std::istreambuf_iterator<char>(); ++i)
+                result.push_back(static_cast<std::byte>(*i));
+            return result;
+        }
+
+        void writeFile(const std::string& filename, const std::vector<std::byte>& data)
+        {
+            std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!file)
+                throw TestError("Failed to write " + filename);
+        }
+
+        std::vector<std::byte> writeStringTable(std::string_view original, std::string_view translation)
+        {
+            return cooked::writeStringTable({std::pair(stringKey(original), translation)});
+        }
+
+        template <class F>
+        bool throwsRuntimeError(F function)
+        {
+            try
+            {
+                function();
+            }
+            catch (const std::runtime_error&)
+            {
+                return true;
+            }
+
+            return false;
+        }
+    }
+
+    void testLanguageStringTable()
+    {
+        // lv.mo is a gettext file with a header entry and six translations
+        const Language language(readFile("lv.mo"));
+        expect(language.getStringCount() == 6, "The header entry must not be translated");
+
+        const std::pair<std::string_view, std::string_view> translations[] = {
+            {"Cancel", "Atcelt"},
+            {"Goodbye", "Uz redz\xC4\x93\xC5\xA1" "anos"},
+            {"Hello", "Sveiki"},
+            {"No", "N\xC4\x93"},
+            {"Settings", "Iestat\xC4\xAB" "jumi"},
+            {"Yes", "J\xC4\x81"}
+        };
+
+        // the keys are sorted by hash, so every entry must be found by the binary search
+        for (const auto& [original, translation] : translations)
+            expect(language.getString(original) == translation, "Invalid translation of " + std::string(original));
+
+        // the fallback itself is returned on a miss
+        const std::string_view missing = "Missing";
+        expect(language.getString(missing).data() == missing.data(), "The fallback was not returned");
+        expect(language.getString("").empty(), "The header entry was found");
+
+        // the entries that point outside of the string data are not trusted
+        auto data = writeStringTable("Hello", "Sveiki");
+        {
+            cooked::Reader reader(data.data(), data.size());
+            reader.next(cooked::ChunkType::stringKeys);
+            const auto entry = reader.next(cooked::ChunkType::stringEntries).getArray<cooked::StringEntry>(1);
+
+            const cooked::StringEntry corruptEntry{0, 1000};
+            std::memcpy(data.data() + (reinterpret_cast<const std::byte*>(entry) - data.data()), &corruptEntry, sizeof(corruptEntry));
+        }
+
+        const Language corruptLanguage(data);
+        expect(corruptLanguage.getString("Hello") == "Hello", "The corrupt entry was used");
+
+        // the strings with the same key can't be told apart, so the table is rejected
+        expect(throwsRuntimeError([]() { Language duplicateLanguage(readFile("duplicate.mo")); }),
+               "The duplicate keys were accepted");
+        expect(throwsRuntimeError([]() {
+            cooked::writeStringTable({std::pair(1, "a"), std::pair(2, "b"), std::pair(1, "c")});
+        }), "The colliding keys were accepted");
+
+        expect(throwsRuntimeError([]() { Language invalidLanguage(std::vector<std::byte>(8)); }),
+               "The invalid data was accepted");
+    }
+
+    void testLocalizationFiles()
+    {
+        const std::string filename = "LocalizationTest.ouzel";
+        writeFile(filename, writeStringTable("Hello", "Sveiki"));
+
+        Localization localization(engine->getFileSystem());
+        localization.addLanguage("lv", storage::Path(filename));
+        localization.addLanguage("de", writeStringTable("Hello", "Hallo"));
+
+        expect(localization.getString("Hello") == "Hello", "No language was set");
+
+        localization.setLanguage("lv");
+        expect(localization.getString("Hello") == "Sveiki", "The file was not mapped");
+
+        // the file is unmapped when switching away and mapped again when switching back, so the new contents are seen
+        localization.setLanguage("de");
+        expect(localization.getString("Hello") == "Hallo", "Invalid language from the memory");
+
+        const std::string replacement = filename + ".new";
+        writeFile(replacement, writeStringTable("Hello", "Labdien"));
+        std::rename(replacement.c_str(), filename.c_str());
+
+        localization.setLanguage("lv");
+        expect(localization.getString("Hello") == "Labdien", "The file was not mapped again");
+
+        // the languages that don't exist unset the current one
+        localization.setLanguage("fr");
+        expect(localization.getString("Hello") == "Hello", "The previous language was kept");
+
+        // removing the current language unmaps it
+        localization.setLanguage("lv");
+        localization.removeLanguage("lv");
+        expect(localization.getString("Hello") == "Hello", "The removed language is still used");
+
+        localization.setLanguage("lv");
+        expect(localization.getString("Hello") == "Hello", "The removed language was mapped");
+
+        std::remove(filename.c_str());
+
+        // the mapped files must be compiled string tables
+        localization.addLanguage("mo", storage::Path("data/lv.mo"));
+        expect(throwsRuntimeError([&localization]() { localization.setLanguage("mo"); }),
+               "The gettext file was mapped as a string table");
+        expect(localization.getString("Hello") == "Hello", "The language that failed to map was set");
+    }
+}
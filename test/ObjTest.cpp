@@ -0,0 +1,327 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "Test.hpp"
+#include "formats/Obj.hpp"
+#include "scene/StaticMeshRenderer.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        // Grid of quads with positions, texture coordinates and normals
+        std::string generateObj(std::size_t size)
+        {
+            std::string result = "# synthetic grid\no grid\n";
+
+            for (std::size_t y = 0; y <= size; ++y)
+                for (std::size_t x = 0; x <= size; ++x)
+                {
+                    result += "v " + std::to_string(x) + ".5 " + std::to_string(y) + ".25 -0.125\n";
+                    result += "vt " + std::to_string(static_cast<float>(x) / static_cast<float>(size)) + " " +
+                        std::to_string(static_cast<float>(y) / static_cast<float>(size)) + "\n";
+                    result += "vn 0 0 1\n";
+                }
+
+            const auto vertex = [size](std::size_t x, std::size_t y) {
+                const auto index = std::to_string(y * (size + 1) + x + 1);
+                return " " + index + "/" + index + "/" + index;
+            };
+
+            for (std::size_t y = 0; y < size; ++y)
+                for (std::size_t x = 0; x < size; ++x)
+                    result += "f" + vertex(x, y) + vertex(x + 1, y) + vertex(x + 1, y + 1) + vertex(x, y + 1) + "\n";
+
+            return result;
+        }
+
+        obj::Document parseObj(const std::string& data)
+        {
+            return obj::Document(reinterpret_cast<const std::byte*>(data.data()), data.size());
+        }
+
+        template <class F>
+        bool throwsParseError(F function)
+        {
+            try
+            {
+                function();
+            }
+            catch (const obj::ParseError&)
+            {
+                return true;
+            }
+
+            return false;
+        }
+
+        // The parser that the loader used before obj::Document: every token is copied into a std::string,
+        // the numbers are converted with std::stof and std::stoi and the vertices are deduplicated with std::map
+        namespace reference
+        {
+            std::string parseString(const char*& iterator, const char* end)
+            {
+                std::string result;
+
+                while (iterator != end && !text::isControlChar(*iterator) && !text::isWhitespace(*iterator))
+                    result.push_back(*iterator++);
+
+                return result;
+            }
+
+            std::string parseNumber(const char*& iterator, const char* end)
+            {
+                std::string result;
+
+                while (iterator != end && (*iterator == '-' || *iterator == '.' ||
+                                           (*iterator >= '0' && *iterator <= '9')))
+                    result.push_back(*iterator++);
+
+                return result;
+            }
+
+            void parseObj(const std::string& data,
+                          std::vector<graphics::Vertex>& vertices,
+                          std::vector<std::uint32_t>& indices)
+            {
+                std::vector<Vector3F> positions;
+                std::vector<Vector2F> texCoords;
+                std::vector<Vector3F> normals;
+                std::map<std::tuple<std::uint32_t, std::uint32_t, std::uint32_t>, std::uint32_t> vertexMap;
+
+                const char* iterator = data.data();
+                const char* end = iterator + data.size();
+
+                while (iterator != end)
+                {
+                    text::skipWhitespaces(iterator, end);
+                    const auto keyword = parseString(iterator, end);
+
+                    if (keyword == "v" || keyword == "vn")
+                    {
+                        Vector3F vector;
+                        for (float& component : vector.v)
+                        {
+                            text::skipWhitespaces(iterator, end);
+                            component = std::stof(parseNumber(iterator, end));
+                        }
+                        (keyword == "v" ? positions : normals).push_back(vector);
+                    }
+                    else if (keyword == "vt")
+                    {
+                        Vector2F texCoord;
+                        for (float& component : texCoord.v)
+                        {
+                            text::skipWhitespaces(iterator, end);
+                            component = std::stof(parseNumber(iterator, end));
+                        }
+                        texCoords.push_back(texCoord);
+                    }
+                    else if (keyword == "f")
+                    {
+                        std::vector<std::uint32_t> vertexIndices;
+
+                        while (iterator != end && !text::isNewline(*iterator))
+                        {
+                            text::skipWhitespaces(iterator, end);
+
+                            std::tuple<std::uint32_t, std::uint32_t, std::uint32_t> key;
+                            std::get<0>(key) = static_cast<std::uint32_t>(std::stoi(parseNumber(iterator, end)));
+                            if (text::parseToken(iterator, end, '/'))
+                            {
+                                std::get<1>(key) = static_cast<std::uint32_t>(std::stoi(parseNumber(iterator, end)));
+                                if (text::parseToken(iterator, end, '/'))
+                                    std::get<2>(key) = static_cast<std::uint32_t>(std::stoi(parseNumber(iterator, end)));
+                            }
+
+                            const auto vertexIterator = vertexMap.find(key);
+                            if (vertexIterator == vertexMap.end())
+                            {
+                                const auto index = static_cast<std::uint32_t>(vertices.size());
+                                vertexMap[key] = index;
+                                vertices.emplace_back(positions[std::get<0>(key) - 1], Color::white(),
+                                                      texCoords[std::get<1>(key) - 1],
+                                                      normals[std::get<2>(key) - 1]);
+                                vertexIndices.push_back(index);
+                            }
+                            else
+                                vertexIndices.push_back(vertexIterator->second);
+                        }
+
+                        for (std::size_t index = 0; index < vertexIndices.size() - 2; ++index)
+                        {
+                            indices.push_back(vertexIndices[0]);
+                            indices.push_back(vertexIndices[index + 1]);
+                            indices.push_back(vertexIndices[index + 2]);
+                        }
+                    }
+
+                    text::skipLine(iterator, end);
+                }
+            }
+        }
+    }
+
+    void testObjIndices()
+    {
+        const auto document = parseObj("v 0 0 0\n"
+                                       "v 1 0 0\n"
+                                       "v 1 1 0\n"
+                                       "v 0 1 0\n"
+                                       "vt 0 0\n"
+                                       "vt 1 1\n"
+                                       "vn 0 0 1\n"
+                                       "f -4/1/1 -3/2/1 -2/1/1 -1/2/1\n" // relative indices
+                                       "f 1/1/1 3/1/1 4/2/1\n" // the same vertices as the quad
+                                       "o pentagon\n"
+                                       "v 2 0 0\n"
+                                       "f 1//1 2//1 3//1 4//1 -1//1\n");
+
+        expect(document.objects.size() == 2, "Expected two objects");
+
+        const auto& quad = document.objects[0];
+        expect(quad.name.empty(), "The geometry before the first object must not have a name");
+        expect(quad.vertices.size() == 4, "The vertices were not deduplicated");
+        expect(quad.indices == std::vector<std::uint32_t>{0, 1, 2, 0, 2, 3, 0, 2, 3}, "Invalid quad indices");
+        expect(quad.vertices[1].position == Vector3F(1.0F, 0.0F, 0.0F) &&
+               quad.vertices[1].texCoords[0] == Vector2F(1.0F, 1.0F) &&
+               quad.vertices[1].normal == Vector3F(0.0F, 0.0F, 1.0F), "Invalid vertex");
+
+        // the vertices are deduplicated per object and polygons are split into a triangle fan
+        const auto& pentagon = document.objects[1];
+        expect(pentagon.name == "pentagon", "Invalid object name");
+        expect(pentagon.vertices.size() == 5, "Invalid pentagon vertex count");
+        expect(pentagon.indices == std::vector<std::uint32_t>{0, 1, 2, 0, 2, 3, 0, 3, 4}, "Invalid pentagon indices");
+        expect(pentagon.vertices[4].position == Vector3F(2.0F, 0.0F, 0.0F), "Invalid relative position");
+        expect(pentagon.vertices[4].texCoords[0] == Vector2F(), "The vertex without texture coordinates got one");
+    }
+
+    void testObjChunks()
+    {
+        // enough lines for every thread to get more than the minimum chunk
+        constexpr std::size_t threadCount = 4;
+        constexpr std::size_t lineCount = threadCount * obj::detail::minChunkSize / 16;
+
+        // the lines have different lengths, so the chunk boundaries fall in the middle of the records
+        std::string data = "# attributes\n";
+        for (std::size_t i = 0; i < lineCount; ++i)
+            switch (i % 3)
+            {
+                case 0: data += "v " + std::to_string(i) + " 1 2\n"; break;
+                case 1: data += "vt " + std::to_string(i) + " 0.5\n"; break;
+                case 2: data += "  vn 0 " + std::to_string(i) + " -1\n# comment\n"; break;
+            }
+
+        const auto attributes = obj::detail::parseAllAttributes(data.data(), data.data() + data.size(), threadCount);
+
+        expect(attributes.positions.size() + attributes.texCoords.size() + attributes.normals.size() == lineCount,
+               "Records were lost or duplicated at the chunk boundaries");
+
+        // the records keep the order of the file
+        for (std::size_t i = 0; i < lineCount; ++i)
+        {
+            const auto value = static_cast<float>(i);
+
+            switch (i % 3)
+            {
+                case 0: expect(attributes.positions[i / 3] == Vector3F(value, 1.0F, 2.0F), "Invalid position " + std::to_string(i)); break;
+                case 1: expect(attributes.texCoords[i / 3] == Vector2F(value, 0.5F), "Invalid texture coordinate " + std::to_string(i)); break;
+                case 2: expect(attributes.normals[i / 3] == Vector3F(0.0F, value, -1.0F), "Invalid normal " + std::to_string(i)); break;
+            }
+        }
+
+        // faces after a multi-chunk attribute block see all of the attributes
+        const auto document = parseObj(data + "f 1/1/1 -1/-1/-1 4/4/4\n");
+        expect(document.objects.front().vertices[1].position == attributes.positions.back(), "Invalid last position");
+    }
+
+    void testObjLargeIndices()
+    {
+        // a grid with more vertices than 16-bit indices can address
+        const auto document = parseObj(generateObj(256));
+        const auto& object = document.objects.front();
+
+        std::uint32_t maxIndex = 0;
+        for (const auto index : object.indices)
+            maxIndex = std::max(maxIndex, index);
+
+        expect(object.vertices.size() == 257 * 257, "Invalid vertex count");
+        expect(maxIndex == object.vertices.size() - 1, "The indices were truncated");
+
+        const scene::StaticMeshData meshData(object.boundingBox, object.indices, object.vertices, nullptr);
+        expect(meshData.indexSize == sizeof(std::uint32_t), "Expected 32-bit indices");
+
+        const auto smallDocument = parseObj(generateObj(16));
+        const auto& smallObject = smallDocument.objects.front();
+        const scene::StaticMeshData smallMeshData(smallObject.boundingBox, smallObject.indices, smallObject.vertices, nullptr);
+        expect(smallMeshData.indexSize == sizeof(std::uint16_t), "Expected 16-bit indices");
+    }
+
+    void testObjMalformed()
+    {
+        const char* malformed[] = {
+            "v 1.0 abc 2.0\n", // not a number
+            "v 1.0 2.0\n", // missing component
+            "vt 0.5 .\n",
+            "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 x\n",
+            "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n", // out of range
+            "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 -4\n",
+            "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3 99999999999\n", // out of the int32 range
+            "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1/1 2 3\n", // no texture coordinates
+            "v 0 0 0\nv 1 0 0\nf 1 2\n" // not a polygon
+        };
+
+        for (const auto data : malformed)
+            expect(throwsParseError([data]() { parseObj(data); }), std::string("Malformed OBJ was accepted: ") + data);
+
+        // the plus sign and the exponent are valid
+        const auto document = parseObj("v +1.5 -2e1 3E-1\n");
+        expect(document.objects.size() == 1, "Expected an object");
+    }
+
+    void benchmarkObjParse()
+    {
+        constexpr std::size_t size = 512;
+        const auto data = generateObj(size);
+
+        std::size_t vertexCount = 0;
+        const auto duration = measure(10, [&data, &vertexCount]() {
+            const auto document = parseObj(data);
+            vertexCount = document.objects.front().vertices.size();
+        });
+
+        expect(vertexCount == (size + 1) * (size + 1), "Invalid vertex count " + std::to_string(vertexCount));
+
+        std::vector<graphics::Vertex> referenceVertices;
+        std::vector<std::uint32_t> referenceIndices;
+        const auto referenceDuration = measure(2, [&data, &referenceVertices, &referenceIndices]() {
+            referenceVertices.clear();
+            referenceIndices.clear();
+            reference::parseObj(data, referenceVertices, referenceIndices);
+        });
+
+        // both parsers must produce the same mesh
+        const auto document = parseObj(data);
+        const auto& object = document.objects.front();
+        expect(object.indices == referenceIndices, "The indices differ from the reference parser");
+        expect(object.vertices.size() == referenceVertices.size(), "The vertices differ from the reference parser");
+        for (std::size_t i = 0; i < referenceVertices.size(); ++i)
+            expect(object.vertices[i].position == referenceVertices[i].position &&
+                   object.vertices[i].texCoords[0] == referenceVertices[i].texCoords[0] &&
+                   object.vertices[i].normal == referenceVertices[i].normal,
+                   "Vertex " + std::to_string(i) + " differs from the reference parser");
+
+        const auto megabytes = static_cast<double>(data.size()) / (1024.0 * 1024.0);
+
+        std::cout << "OBJ parse (" << data.size() / (1024 * 1024) << " MiB, " << vertexCount << " vertices): " <<
+            duration << " ms, " << megabytes / (duration / 1000.0) << " MiB/s, " <<
+            "std::stof and std::map " << referenceDuration << " ms, " <<
+            megabytes / (referenceDuration / 1000.0) << " MiB/s (" << referenceDuration / duration << "x)\n";
+    }
+}
@@ -0,0 +1,189 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Test.hpp"
+#include "core/Engine.hpp"
+#include "scene/Actor.hpp"
+#include "scene/Animators.hpp"
+#include "scene/Camera.hpp"
+#include "scene/Layer.hpp"
+#include "scene/Prefab.hpp"
+#include "scene/SpriteRenderer.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        void updateAnimations(float delta)
+        {
+            engine->getEventDispatcher().dispatchEvents(); // registers the update handler of the animation system
+
+            UpdateEvent event;
+            event.type = Event::Type::update;
+            event.delta = delta;
+            engine->getEventDispatcher().dispatchEvent(event);
+        }
+
+        bool isNear(const Vector3F& a, const Vector3F& b) noexcept
+        {
+            return (a - b).length() < 0.001F;
+        }
+    }
+
+    void testPrefabAnimators()
+    {
+        const auto texture = std::make_shared<graphics::Texture>(*engine->getGraphics(), Size2U(16, 16));
+
+        scene::Layer layer;
+
+        // the root is moved by the game after spawning, the child moves on its own
+        scene::Actor root;
+        scene::SpriteRenderer sprite(texture, 1, 1);
+        root.addComponent(sprite);
+        scene::Move rootMove(1.0F, Vector3F(10.0F, 0.0F, 0.0F), true);
+        root.addComponent(rootMove);
+
+        scene::Actor child;
+        root.addChild(child);
+        scene::Move childMove(1.0F, Vector3F(0.0F, 4.0F, 0.0F));
+        scene::Sequence childSequence(std::vector<scene::Animator*>{&childMove});
+        child.addComponent(childSequence);
+        childSequence.start();
+
+        scene::Prefab prefab(root);
+        childSequence.stop();
+
+        for (std::size_t round = 0; round < 2; ++round)
+        {
+            scene::Actor& instance = prefab.spawn(layer);
+            expect(prefab.getInstanceCount() == 1, "The instance was not recycled");
+            expect(isNear(instance.getPosition(), Vector3F()), "The root was not reset");
+
+            const auto& components = instance.getComponents();
+            expect(components.size() == 2, "Expected a sprite renderer and an animator");
+
+            const auto instanceMove = dynamic_cast<scene::Animator*>(components[1]);
+            expect(instanceMove && instanceMove != &rootMove, "The animator was not cloned");
+            expect(!instanceMove->isRunning(), "The animator that was stopped was started");
+
+            scene::Actor& instanceChild = *instance.getChildren().front();
+            expect(isNear(instanceChild.getPosition(), Vector3F()), "The child was not reset");
+
+            const auto instanceSequence = dynamic_cast<scene::Animator*>(instanceChild.getComponents().front());
+            expect(instanceSequence && instanceSequence->isRunning(), "The running animator was not started");
+
+            // the recycled tween must start from the new position and not from the one of the previous round
+            const Vector3F start(100.0F * static_cast<float>(round + 1), 0.0F, 0.0F);
+            instance.setPosition(start);
+            instanceMove->start();
+
+            updateAnimations(0.5F);
+
+            expect(isNear(instance.getPosition(), start + Vector3F(5.0F, 0.0F, 0.0F)), "Invalid position of the root");
+            expect(isNear(instanceChild.getPosition(), Vector3F(0.0F, 2.0F, 0.0F)), "Invalid position of the child");
+
+            prefab.despawn(instance);
+            expect(!instanceMove->isRunning() && !instanceSequence->isRunning(), "The animators were not stopped");
+            expect(prefab.getSpawnedCount() == 0, "The instance was not released");
+        }
+
+        // the components that can't be reset are rejected when capturing
+        scene::Actor cameraActor;
+        scene::Camera camera;
+        cameraActor.addComponent(camera);
+
+        try
+        {
+            scene::Prefab cameraPrefab(cameraActor);
+            throw TestError("The camera was captured");
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+    }
+
+    void benchmarkPrefab()
+    {
+        constexpr std::size_t bulletCount = 500;
+        constexpr std::size_t roundCount = 200;
+
+        const auto texture = std::make_shared<graphics::Texture>(*engine->getGraphics(), Size2U(16, 16));
+        scene::Layer layer;
+
+        // a bullet with a trail, both of them are sprites and the bullet is moved by an animator
+        scene::Actor bullet;
+        scene::SpriteRenderer bulletSprite(texture, 1, 1);
+        bullet.addComponent(bulletSprite);
+        scene::Move bulletMove(1.0F, Vector3F(100.0F, 0.0F, 0.0F), true);
+        bullet.addComponent(bulletMove);
+        bulletMove.start();
+
+        scene::Actor trail;
+        scene::SpriteRenderer trailSprite(texture, 1, 1);
+        trail.addComponent(trailSprite);
+        bullet.addChild(trail);
+
+        scene::Prefab prefab(bullet, bulletCount);
+        bulletMove.stop();
+
+        std::vector<scene::Actor*> instances(bulletCount);
+
+        const auto prefabDuration = measure(10, [&prefab, &layer, &instances]() {
+            for (std::size_t round = 0; round < roundCount; ++round)
+            {
+                for (auto& instance : instances)
+                    instance = &prefab.spawn(layer);
+
+                for (const auto instance : instances)
+                    prefab.despawn(*instance);
+            }
+        });
+
+        expect(prefab.getInstanceCount() == bulletCount, "The instances were not recycled");
+
+        const auto allocationDuration = measure(10, [&layer, &texture]() {
+            for (std::size_t round = 0; round < roundCount; ++round)
+            {
+                std::vector<std::unique_ptr<scene::Actor>> actors;
+                std::vector<std::unique_ptr<scene::Component>> components;
+
+                for (std::size_t i = 0; i < bulletCount; ++i)
+                {
+                    auto actor = std::make_unique<scene::Actor>();
+                    auto sprite = std::make_unique<scene::SpriteRenderer>(texture, 1, 1);
+                    actor->addComponent(*sprite);
+                    auto move = std::make_unique<scene::Move>(1.0F, Vector3F(100.0F, 0.0F, 0.0F), true);
+                    actor->addComponent(*move);
+                    move->start();
+
+                    auto child = std::make_unique<scene::Actor>();
+                    auto childSprite = std::make_unique<scene::SpriteRenderer>(texture, 1, 1);
+                    child->addComponent(*childSprite);
+                    actor->addChild(*child);
+
+                    layer.addChild(*actor);
+
+                    actors.push_back(std::move(actor));
+                    actors.push_back(std::move(child));
+                    components.push_back(std::move(sprite));
+                    components.push_back(std::move(move));
+                    components.push_back(std::move(childSprite));
+                }
+
+                // the components are destroyed before the actors that they belong to
+                components.clear();
+            }
+        });
+
+        const auto spawnCount = static_cast<double>(bulletCount * roundCount);
+
+        std::cout << "Prefab (" << bulletCount << " bullets): " <<
+            spawnCount / (prefabDuration * 1000.0) << " M spawn+despawn/s, " <<
+            "make_unique " << spawnCount / (allocationDuration * 1000.0) << " M spawn+destroy/s (" <<
+            allocationDuration / prefabDuration << "x)\n";
+    }
+}
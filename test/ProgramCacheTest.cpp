@@ -0,0 +1,343 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "Test.hpp"
+#include "core/Engine.hpp"
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_OPENGL
+#  include "graphics/opengl/OGL.h"
+#endif
+
+#if OUZEL_COMPILE_OPENGL && OUZEL_OPENGL_INTERFACE_EGL && !OUZEL_OPENGLES
+#  include "EGL/egl.h"
+#  include "EGL/eglext.h"
+#  include "formats/Cooked.hpp"
+#  include "graphics/opengl/OGLProgramCache.hpp"
+#  include "graphics/opengl/OGLRenderDevice.hpp"
+#  include "storage/FileSystem.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        // Off-screen EGL context, it is a base of the render device, so that it is created before it and destroyed after it
+        class Context
+        {
+        public:
+            Context()
+            {
+                display = eglGetPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+                if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+                    throw TestSkipped("Failed to initialize a surfaceless EGL display");
+
+                const EGLint attributeList[] = {
+                    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                    EGL_NONE
+                };
+
+                EGLConfig config;
+                EGLint configCount = 0;
+                if (!eglChooseConfig(display, attributeList, &config, 1, &configCount) || configCount == 0 ||
+                    !eglBindAPI(EGL_OPENGL_API))
+                {
+                    eglTerminate(display);
+                    throw TestSkipped("No EGL config for OpenGL");
+                }
+
+                const EGLint surfaceAttributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+                surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+                for (version = 4; version >= 3 && context == EGL_NO_CONTEXT; --version)
+                {
+                    const EGLint contextAttributes[] = {EGL_CONTEXT_CLIENT_VERSION, version, EGL_NONE};
+                    context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+                }
+                ++version;
+
+                if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT ||
+                    !eglMakeCurrent(display, surface, surface, context))
+                {
+                    destroy();
+                    throw TestSkipped("Failed to create an OpenGL context");
+                }
+            }
+
+            ~Context()
+            {
+                destroy();
+            }
+
+            Context(const Context&) = delete;
+            Context& operator=(const Context&) = delete;
+
+        protected:
+            EGLint version = 0;
+
+        private:
+            void destroy()
+            {
+                eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+                if (context != EGL_NO_CONTEXT) eglDestroyContext(display, context);
+                if (surface != EGL_NO_SURFACE) eglDestroySurface(display, surface);
+                eglTerminate(display);
+            }
+
+            EGLDisplay display = EGL_NO_DISPLAY;
+            EGLSurface surface = EGL_NO_SURFACE;
+            EGLContext context = EGL_NO_CONTEXT;
+        };
+
+        class TestRenderDevice final: private Context, public graphics::opengl::RenderDevice
+        {
+        public:
+            explicit TestRenderDevice(const graphics::Settings& settings):
+                graphics::opengl::RenderDevice(settings, *engine->getWindow(), [](const Event&) {})
+            {
+                apiVersion = graphics::ApiVersion(version, 0);
+                init(1, 1);
+            }
+
+            std::string getString(GLenum name)
+            {
+                return reinterpret_cast<const char*>(glGetStringProc(name));
+            }
+        };
+
+        constexpr const char* vertexShader =
+            "#version 330\n"
+            "uniform mat4 modelViewProj;\n"
+            "in vec3 position0;\n"
+            "void main() { gl_Position = modelViewProj * vec4(position0, 1.0); }\n";
+
+        constexpr const char* fragmentShader =
+            "#version 330\n"
+            "uniform sampler2D texture0;\n"
+            "uniform sampler2D texture1;\n"
+            "uniform vec4 color;\n"
+            "out vec4 fragmentColor;\n"
+            "void main() { fragmentColor = color * texture(texture0, vec2(0.5)) * texture(texture1, vec2(0.5)); }\n";
+
+        // the samplers followed by the fragment and vertex shader constants, like the shaders of the engine
+        const char* const uniformNames[] = {"texture0", "texture1", "color", "modelViewProj"};
+        constexpr std::size_t uniformCount = std::size(uniformNames);
+
+        std::vector<std::uint8_t> toData(const char* source)
+        {
+            return std::vector<std::uint8_t>(source, source + std::strlen(source));
+        }
+
+        std::uint64_t getKey(const graphics::opengl::ProgramCache& programCache, const char* fragmentShaderSource)
+        {
+            return programCache.getKey(toData(fragmentShaderSource), toData(vertexShader),
+                                       {graphics::Vertex::Attribute::Usage::position},
+                                       {{"color", graphics::DataType::float32Vector4}},
+                                       {{"modelViewProj", graphics::DataType::float32Matrix4}});
+        }
+
+        GLuint compileShader(TestRenderDevice& renderDevice, GLenum type, const char* source)
+        {
+            const auto shaderId = renderDevice.glCreateShaderProc(type);
+            renderDevice.glShaderSourceProc(shaderId, 1, &source, nullptr);
+            renderDevice.glCompileShaderProc(shaderId);
+
+            GLint status = GL_FALSE;
+            renderDevice.glGetShaderivProc(shaderId, GL_COMPILE_STATUS, &status);
+            if (status == GL_FALSE)
+                throw TestError("Failed to compile shader");
+
+            return shaderId;
+        }
+
+        std::vector<GLint> getUniformLocations(TestRenderDevice& renderDevice, GLuint programId)
+        {
+            std::vector<GLint> result;
+            for (const auto name : uniformNames)
+                result.push_back(renderDevice.glGetUniformLocationProc(programId, name));
+            return result;
+        }
+
+        // Links the program from the sources and returns its uniform locations, as the shaders do on a cache miss
+        std::vector<GLint> linkProgram(TestRenderDevice& renderDevice, GLuint programId, const char* fragmentShaderSource)
+        {
+            const auto vertexShaderId = compileShader(renderDevice, GL_VERTEX_SHADER, vertexShader);
+            const auto fragmentShaderId = compileShader(renderDevice, GL_FRAGMENT_SHADER, fragmentShaderSource);
+
+            renderDevice.glAttachShaderProc(programId, vertexShaderId);
+            renderDevice.glAttachShaderProc(programId, fragmentShaderId);
+            renderDevice.glBindAttribLocationProc(programId, 0, "position0");
+            if (renderDevice.glProgramParameteriProc)
+                renderDevice.glProgramParameteriProc(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            renderDevice.glLinkProgramProc(programId);
+
+            renderDevice.glDetachShaderProc(programId, vertexShaderId);
+            renderDevice.glDetachShaderProc(programId, fragmentShaderId);
+            renderDevice.glDeleteShaderProc(vertexShaderId);
+            renderDevice.glDeleteShaderProc(fragmentShaderId);
+
+            GLint status = GL_FALSE;
+            renderDevice.glGetProgramivProc(programId, GL_LINK_STATUS, &status);
+            if (status == GL_FALSE)
+                throw TestError("Failed to link program");
+
+            return getUniformLocations(renderDevice, programId);
+        }
+
+        std::string getEntryPath(const std::string& directory, std::uint64_t key)
+        {
+            char filename[17];
+            std::snprintf(filename, sizeof(filename), "%016llx", static_cast<unsigned long long>(key));
+            return directory + '/' + filename + '.' + cooked::fileExtension;
+        }
+
+        std::vector<std::uint8_t> readFile(const std::string& filename)
+        {
+            std::ifstream file(filename, std::ios::binary);
+            return std::vector<std::uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+
+        void writeFile(const std::string& filename, const std::vector<std::uint8_t>& data)
+        {
+            std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        }
+
+        bool hasStatistics(const graphics::opengl::ProgramCache& programCache,
+                           std::uint32_t hits, std::uint32_t misses, std::uint32_t rejections)
+        {
+            const auto statistics = programCache.getStatistics();
+            return statistics.hits == hits && statistics.misses == misses && statistics.rejections == rejections;
+        }
+    }
+
+    void testProgramCache()
+    {
+        // the results of the hardware drivers differ, so the test runs only on the software rasterizer
+        const auto software = std::getenv("LIBGL_ALWAYS_SOFTWARE");
+        if (!software || std::string(software) != "1")
+            throw TestSkipped("Run with LIBGL_ALWAYS_SOFTWARE=1 to test on the software rasterizer");
+
+        // removes the entries and the directory also if the test fails
+        struct Directory final
+        {
+            explicit Directory(const std::string& initPath): path(initPath)
+            {
+                storage::FileSystem::createDirectory(path);
+            }
+
+            ~Directory()
+            {
+                for (const auto& entry : entries) std::remove(entry.c_str());
+                std::remove(path.c_str());
+            }
+
+            Directory(const Directory&) = delete;
+            Directory& operator=(const Directory&) = delete;
+
+            std::string path;
+            std::vector<std::string> entries;
+        };
+
+        Directory cacheDirectory("ProgramCacheTest");
+        const auto& directory = cacheDirectory.path;
+        auto& entries = cacheDirectory.entries;
+
+        graphics::Settings settings;
+        settings.programCacheDirectory = directory;
+        TestRenderDevice renderDevice(settings);
+
+        if (!renderDevice.getProgramCache().isEnabled())
+            throw TestSkipped("The driver does not support program binaries");
+
+        const auto vendorName = renderDevice.getString(GL_VENDOR);
+        const auto rendererName = renderDevice.getString(GL_RENDERER);
+        const auto versionName = renderDevice.getString(GL_VERSION);
+
+        // the program is compiled and stored by the first cache and loaded by the second one
+        graphics::opengl::ProgramCache firstCache(renderDevice, directory);
+        firstCache.init(vendorName, rendererName, versionName);
+        const auto key = getKey(firstCache, fragmentShader);
+        entries.push_back(getEntryPath(directory, key));
+
+        const auto firstProgramId = renderDevice.glCreateProgramProc();
+        std::vector<GLint> firstLocations;
+        expect(!firstCache.load(key, firstProgramId, uniformCount, firstLocations), "The empty cache had an entry");
+        firstLocations = linkProgram(renderDevice, firstProgramId, fragmentShader);
+        firstCache.store(key, firstProgramId, firstLocations);
+        expect(hasStatistics(firstCache, 0, 1, 0), "Invalid statistics of the first cache");
+
+        graphics::opengl::ProgramCache secondCache(renderDevice, directory);
+        secondCache.init(vendorName, rendererName, versionName);
+        expect(getKey(secondCache, fragmentShader) == key, "The key of the same program differs");
+
+        const auto secondProgramId = renderDevice.glCreateProgramProc();
+        std::vector<GLint> secondLocations;
+        expect(secondCache.load(key, secondProgramId, uniformCount, secondLocations), "The stored program was not loaded");
+        expect(secondLocations == firstLocations, "The uniform locations differ");
+        expect(getUniformLocations(renderDevice, secondProgramId) == firstLocations,
+               "The loaded program has different uniform locations");
+        expect(hasStatistics(secondCache, 1, 0, 0), "Invalid statistics of the second cache");
+
+        // a new driver or new sources change the key, the stale entry is left at the path of the new key
+        const auto entry = readFile(entries.front());
+
+        graphics::opengl::ProgramCache driverCache(renderDevice, directory);
+        driverCache.init(vendorName, rendererName, versionName + " (updated)");
+        const auto driverKey = getKey(driverCache, fragmentShader);
+        expect(driverKey != key, "The driver is not a part of the key");
+
+        const auto sourceKey = getKey(secondCache, "// changed\n");
+        expect(sourceKey != key, "The sources are not a part of the key");
+
+        for (const auto& [cache, newKey] : {std::pair(&driverCache, driverKey), std::pair(&secondCache, sourceKey)})
+        {
+            const auto programId = renderDevice.glCreateProgramProc();
+            std::vector<GLint> locations;
+            expect(!cache->load(newKey, programId, uniformCount, locations), "A program was loaded without an entry");
+
+            entries.push_back(getEntryPath(directory, newKey));
+            writeFile(entries.back(), entry);
+            expect(!cache->load(newKey, programId, uniformCount, locations), "The entry of another key was loaded");
+            renderDevice.glDeleteProgramProc(programId);
+        }
+
+        expect(hasStatistics(driverCache, 0, 1, 1), "Invalid statistics after the driver changed");
+        expect(hasStatistics(secondCache, 1, 1, 1), "Invalid statistics after the sources changed");
+
+        // the binaries that the driver does not accept are rejected, the program can still be linked
+        const auto programData = std::vector<std::uint8_t>(1024, 0xCD);
+        const auto binaryFormat = static_cast<std::uint32_t>(cooked::readProgramBinary(
+            reinterpret_cast<const std::byte*>(entry.data()), entry.size(), key, uniformCount).binaryFormat);
+        const auto invalidEntry = cooked::writeProgramBinary(key, binaryFormat, programData, firstLocations);
+        writeFile(entries.front(), std::vector<std::uint8_t>(reinterpret_cast<const std::uint8_t*>(invalidEntry.data()),
+                                                             reinterpret_cast<const std::uint8_t*>(invalidEntry.data()) + invalidEntry.size()));
+
+        const auto thirdProgramId = renderDevice.glCreateProgramProc();
+        std::vector<GLint> thirdLocations;
+        expect(!secondCache.load(key, thirdProgramId, uniformCount, thirdLocations), "The invalid binary was loaded");
+        expect(hasStatistics(secondCache, 1, 1, 2), "The invalid binary was not counted as rejected");
+        expect(linkProgram(renderDevice, thirdProgramId, fragmentShader) == firstLocations,
+               "The program was not linked after the rejected binary");
+
+        renderDevice.glDeleteProgramProc(firstProgramId);
+        renderDevice.glDeleteProgramProc(secondProgramId);
+        renderDevice.glDeleteProgramProc(thirdProgramId);
+    }
+}
+#else
+namespace ouzel::test
+{
+    void testProgramCache()
+    {
+        throw TestSkipped("The program cache needs OpenGL with EGL");
+    }
+}
+#endif
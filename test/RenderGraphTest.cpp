@@ -0,0 +1,262 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Test.hpp"
+#include "core/Engine.hpp"
+#include "graphics/CommandCapture.hpp"
+#include "graphics/RenderGraph.hpp"
+#include "thread/JobSystem.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        const graphics::RenderGraph::TargetDescription targetDescription{Size2U(256, 256)};
+
+        // Adds a chain of passes, each reading the output of the previous one, and a final pass writing the back buffer
+        void addChain(graphics::RenderGraph& graph, std::size_t length, std::vector<std::string>& executed)
+        {
+            auto previous = graphics::RenderGraph::invalidHandle;
+
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                const auto target = graph.createRenderTarget(targetDescription);
+                const auto name = "chain" + std::to_string(i);
+                graph.addPass(name,
+                              previous == graphics::RenderGraph::invalidHandle ? std::vector<graphics::RenderGraph::Handle>{} :
+                                  std::vector<graphics::RenderGraph::Handle>{previous},
+                              target, {}, [&executed, name]() { executed.push_back(name); });
+                previous = target;
+            }
+
+            graph.addPass("final", {previous}, graph.importRenderTarget(nullptr), {},
+                          [&executed]() { executed.push_back("final"); });
+        }
+
+
+        // Three groups that draw transient geometry to their own targets and a pass that combines them
+        void recordFrame(graphics::RenderGraph& graph, thread::JobSystem* jobSystem)
+        {
+            auto& graphics = *engine->getGraphics();
+
+            graph.reset();
+
+            graphics::RenderGraph::Clear clear;
+            clear.colorBuffer = true;
+
+            std::vector<graphics::RenderGraph::Handle> targets;
+
+            for (std::size_t group = 0; group < 3; ++group)
+            {
+                const auto target = targets.emplace_back(graph.createRenderTarget(targetDescription));
+
+                for (std::size_t i = 0; i < 2; ++i)
+                {
+                    const auto value = static_cast<float>(group * 2 + i);
+                    const auto pass = graph.addPass("draw", {}, target, i == 0 ? clear : graphics::RenderGraph::Clear{},
+                                                    [&graphics, value]() {
+                        auto& geometry = graphics.getTransientGeometry();
+
+                        const std::vector<graphics::Vertex> vertices(3, graphics::Vertex(Vector3F(value, 0.0F, 0.0F), Color::white(),
+                                                                                          Vector2F(), Vector3F(0.0F, 0.0F, -1.0F)));
+                        const std::uint16_t indices[] = {0, 1, 2};
+
+                        const auto baseVertex = geometry.addVertices(vertices.data(), 3);
+                        const auto startIndex = geometry.addIndices(indices, 3);
+
+                        graphics.draw(geometry.getIndexBuffer().getResource(), 3, sizeof(std::uint16_t),
+                                      geometry.getVertexBuffer().getResource(),
+                                      graphics::DrawMode::triangleList, startIndex, baseVertex);
+                    });
+                    graph.setRecordingGroup(pass, group);
+                }
+            }
+
+            const auto finalPass = graph.addPass("final", targets, graph.importRenderTarget(nullptr), clear, nullptr);
+            graph.setRecordingGroup(finalPass, 3);
+
+            graph.compile();
+            graph.execute(graphics, jobSystem);
+            graphics.present();
+        }
+
+        // The commands of the capture with the fields that depend on the recording
+        std::vector<std::string> readCommands(const std::string& filename)
+        {
+            std::vector<std::string> result;
+
+            graphics::CaptureReader reader(filename);
+            graphics::CommandBuffer commandBuffer;
+            std::chrono::nanoseconds delay;
+
+            while (reader.read(commandBuffer, delay))
+                while (!commandBuffer.isEmpty())
+                {
+                    const auto command = commandBuffer.popCommand();
+                    auto description = std::to_string(static_cast<int>(command->type));
+
+                    switch (command->type)
+                    {
+                        case graphics::Command::Type::draw:
+                        {
+                            const auto& drawCommand = static_cast<const graphics::DrawCommand&>(*command);
+                            description += ' ' + std::to_string(drawCommand.indexBuffer) +
+                                ' ' + std::to_string(drawCommand.vertexBuffer) +
+                                ' ' + std::to_string(drawCommand.startIndex) +
+                                ' ' + std::to_string(drawCommand.baseVertex);
+                            break;
+                        }
+                        case graphics::Command::Type::setRenderTarget:
+                            description += ' ' + std::to_string(static_cast<const graphics::SetRenderTargetCommand&>(*command).renderTarget);
+                            break;
+                        case graphics::Command::Type::initBuffer:
+                            description += ' ' + std::to_string(static_cast<const graphics::InitBufferCommand&>(*command).buffer);
+                            break;
+                        case graphics::Command::Type::setBufferData:
+                        {
+                            const auto& setBufferDataCommand = static_cast<const graphics::SetBufferDataCommand&>(*command);
+                            description += ' ' + std::to_string(setBufferDataCommand.buffer) + ' ' +
+                                std::string(setBufferDataCommand.data.begin(), setBufferDataCommand.data.end());
+                            break;
+                        }
+                        default:
+                            break;
+                    }
+
+                    result.push_back(description);
+                }
+
+            return result;
+        }
+    }
+
+    void testRenderGraphOrder()
+    {
+        graphics::RenderGraph graph;
+        std::vector<std::string> executed;
+
+        const auto backBuffer = graph.importRenderTarget(nullptr);
+        const auto sceneTarget = graph.createRenderTarget(targetDescription);
+        const auto unusedTarget = graph.createRenderTarget(targetDescription);
+
+        graph.addPass("scene", {}, sceneTarget, {}, [&executed]() { executed.push_back("scene"); });
+        graph.addPass("unused", {sceneTarget}, unusedTarget, {}, [&executed]() { executed.push_back("unused"); });
+        graph.addPass("post", {sceneTarget}, backBuffer, {}, [&executed]() { executed.push_back("post"); });
+        const auto debugPass = graph.addPass("debug", {}, graphics::RenderGraph::invalidHandle, {},
+                                             [&executed]() { executed.push_back("debug"); });
+        graph.setSideEffects(debugPass);
+
+        graph.compile();
+
+        expect(graph.getExecutionOrder() == std::vector<graphics::RenderGraph::PassId>{0, 2, 3}, "Invalid execution order");
+        expect(graph.isPassCulled(1), "Pass without readers was not culled");
+        expect(!graph.isPassCulled(3), "Pass with side effects was culled");
+
+        graph.execute(*engine->getGraphics());
+        engine->getGraphics()->present();
+
+        expect(executed == std::vector<std::string>{"scene", "post", "debug"}, "Passes executed in an invalid order");
+    }
+
+    void testRenderGraphAliasing()
+    {
+        graphics::RenderGraph graph;
+        std::vector<std::string> executed;
+
+        // the lifetimes of the first and the third target don't overlap
+        addChain(graph, 3, executed);
+
+        // a target with a different description can't share the memory
+        const auto otherTarget = graph.createRenderTarget({Size2U(128, 128)});
+        graph.addPass("other", {}, otherTarget, {}, nullptr);
+        graph.addPass("otherFinal", {otherTarget}, graph.importRenderTarget(nullptr), {}, nullptr);
+
+        graph.compile();
+
+        expect(graph.getPhysicalTargetCount() == 3, "Expected 3 physical targets, got " + std::to_string(graph.getPhysicalTargetCount()));
+        expect(graph.getAllocationCount() == 3, "Expected 3 allocations, got " + std::to_string(graph.getAllocationCount()));
+    }
+
+    void testRenderGraphClears()
+    {
+        graphics::RenderGraph graph;
+
+        graphics::RenderGraph::Clear clear;
+        clear.colorBuffer = true;
+
+        const auto backBuffer = graph.importRenderTarget(nullptr);
+        const auto first = graph.addPass("first", {}, backBuffer, clear, nullptr);
+        const auto second = graph.addPass("second", {}, backBuffer, clear, nullptr);
+        const auto third = graph.addPass("third", {}, backBuffer, {}, nullptr);
+
+        graph.compile();
+
+        expect(graph.isPassClearing(first), "The first clear of the target was not merged into the pass");
+        expect(!graph.isPassClearing(second), "The target was cleared twice");
+        expect(!graph.isPassClearing(third), "Pass without a clear clears the target");
+    }
+
+    void testRenderGraphAllocations()
+    {
+        graphics::RenderGraph graph;
+        std::vector<std::string> executed;
+
+        for (std::size_t frame = 0; frame < 10; ++frame)
+        {
+            graph.reset();
+            addChain(graph, 4, executed);
+            graph.compile();
+            graph.execute(*engine->getGraphics());
+            engine->getGraphics()->present();
+
+            expect(graph.getPhysicalTargetCount() == 2, "Expected 2 physical targets, got " + std::to_string(graph.getPhysicalTargetCount()));
+            expect(graph.getAllocationCount() == 2, "Render targets allocated in frame " + std::to_string(frame));
+        }
+
+        expect(executed.size() == 50, "Invalid number of executed passes");
+    }
+
+    void testRenderGraphParallelRecording()
+    {
+        const std::string serialFilename = "test_serial.bin";
+        const std::string parallelFilename = "test_parallel.bin";
+
+        auto& device = *engine->getGraphics()->getDevice();
+        graphics::RenderGraph graph;
+        thread::JobSystem jobSystem(2);
+
+        // the first frame creates the render targets and the command lists
+        recordFrame(graph, nullptr);
+
+        try
+        {
+            device.startCapture(serialFilename);
+            recordFrame(graph, nullptr);
+            device.stopCapture();
+
+            device.startCapture(parallelFilename);
+            recordFrame(graph, &jobSystem);
+            device.stopCapture();
+
+            const auto serialCommands = readCommands(serialFilename);
+            const auto parallelCommands = readCommands(parallelFilename);
+
+            expect(serialCommands.size() > 6, "The passes were not recorded");
+            expect(parallelCommands == serialCommands, "The passes recorded in parallel issued different commands");
+        }
+        catch (...)
+        {
+            device.stopCapture();
+            std::remove(serialFilename.c_str());
+            std::remove(parallelFilename.c_str());
+            throw;
+        }
+
+        std::remove(serialFilename.c_str());
+        std::remove(parallelFilename.c_str());
+    }
+}
@@ -0,0 +1,137 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Test.hpp"
+#include "core/Engine.hpp"
+#include "scene/Actor.hpp"
+#include "scene/Camera.hpp"
+#include "scene/Layer.hpp"
+#include "scene/Scene.hpp"
+#include "scene/SpriteRenderer.hpp"
+
+namespace ouzel::test
+{
+    void testScenePassOrder()
+    {
+        scene::Scene scene;
+
+        scene::Layer backgroundLayer;
+        scene::Actor backgroundCameraActor;
+        scene::Camera backgroundCamera;
+        backgroundCamera.setClearColorBuffer(true);
+        backgroundCameraActor.addComponent(backgroundCamera);
+        backgroundLayer.addChild(backgroundCameraActor);
+
+        scene::Layer foregroundLayer;
+        scene::Actor foregroundCameraActor;
+        scene::Camera foregroundCamera;
+        foregroundCameraActor.addComponent(foregroundCamera);
+        foregroundLayer.addChild(foregroundCameraActor);
+
+        // the layer added last is drawn first because of its higher order
+        scene.addLayer(foregroundLayer);
+        scene.addLayer(backgroundLayer);
+        backgroundLayer.setOrder(1);
+
+        for (std::size_t frame = 0; frame < 3; ++frame)
+        {
+            scene.draw();
+
+            const auto& graph = scene.getRenderGraph();
+            expect(graph.getPassCount() == 2, "Expected a pass for every camera");
+            expect(graph.getExecutionOrder() == std::vector<graphics::RenderGraph::PassId>{0, 1}, "Invalid execution order");
+            expect(graph.isPassClearing(0) && !graph.isPassClearing(1), "Layers are not drawn in the order of their order");
+            expect(graph.getAllocationCount() == 0, "Render targets allocated for the back buffer");
+        }
+
+        backgroundLayer.setOrder(-1);
+        scene.draw();
+
+        expect(!scene.getRenderGraph().isPassClearing(0) && scene.getRenderGraph().isPassClearing(1),
+               "The layers were not reordered");
+    }
+
+    void testSpriteDataSharing()
+    {
+        const auto texture = std::make_shared<graphics::Texture>(*engine->getGraphics(), Size2U(64, 32));
+
+        // the renderers that split the texture the same way share the sprite data and its buffers
+        const scene::SpriteRenderer first(texture, 2, 1);
+        const scene::SpriteRenderer second(texture, 2, 1);
+        expect(first.getSpriteData() == second.getSpriteData(), "The sprite data is not shared");
+        expect(first.getMaterial() == second.getMaterial(), "The material is not shared");
+        expect(first.getSpriteData()->vertexBuffer != nullptr, "The buffers were not created");
+
+        const auto& frames = first.getSpriteData()->animations.at("").frames;
+        expect(frames.size() == 2, "Expected two frames");
+        expect(frames[1].getBaseVertex() == 4, "The frames don't share the vertex buffer");
+
+        const scene::SpriteRenderer other(texture, 1, 2);
+        expect(first.getSpriteData() != other.getSpriteData(), "Different grids share the sprite data");
+    }
+
+    void testSpriteRendererAllocations()
+    {
+        constexpr std::size_t spriteCount = 1000;
+
+        const auto texture = std::make_shared<graphics::Texture>(*engine->getGraphics(), Size2U(64, 32));
+        const scene::SpriteRenderer prototype(texture, 2, 1);
+        const auto spriteData = prototype.getSpriteData();
+
+        // the storage is allocated up front, so only the allocations of the renderers are counted
+        std::vector<std::optional<scene::SpriteRenderer>> sprites(spriteCount);
+
+        const auto before = getAllocationStatistics();
+        for (auto& sprite : sprites) sprite.emplace(spriteData);
+        const auto after = getAllocationStatistics();
+
+        expect(after.count == before.count,
+               "Spawning from the shared sprite data allocated " + std::to_string(after.count - before.count) +
+               " times for " + std::to_string(spriteCount) + " sprites");
+
+        // the lookup in the cache finds the sprite data of the same grid without allocating it again
+        for (auto& sprite : sprites) sprite.reset();
+
+        const auto cachedBefore = getAllocationStatistics();
+        for (auto& sprite : sprites) sprite.emplace(texture, 2, 1);
+        const auto cachedAfter = getAllocationStatistics();
+
+        expect(cachedAfter.count == cachedBefore.count, "Spawning from the texture grid allocated " +
+               std::to_string(cachedAfter.count - cachedBefore.count) + " times");
+        expect(sprites.back()->getSpriteData() == spriteData, "The sprite data is not shared");
+    }
+
+    void benchmarkSpriteMemory()
+    {
+        constexpr std::size_t spriteCount = 1000;
+
+        const auto texture = std::make_shared<graphics::Texture>(*engine->getGraphics(), Size2U(64, 32));
+        const scene::SpriteRenderer prototype(texture, 2, 1);
+
+        std::vector<std::optional<scene::SpriteRenderer>> sprites(spriteCount);
+
+        const auto sharedBefore = getAllocationStatistics();
+        for (auto& sprite : sprites) sprite.emplace(prototype.getSpriteData());
+        const auto sharedAfter = getAllocationStatistics();
+
+        for (auto& sprite : sprites) sprite.reset();
+
+        // every renderer gets its own copy of the sprite data and its own buffers
+        const auto copiedBefore = getAllocationStatistics();
+        for (auto& sprite : sprites) sprite.emplace(*prototype.getSpriteData());
+        const auto copiedAfter = getAllocationStatistics();
+
+        const auto perSprite = [](std::size_t value) {
+            return static_cast<double>(value) / static_cast<double>(spriteCount);
+        };
+
+        std::cout << "Sprite memory (" << spriteCount << " sprites, " << sizeof(scene::SpriteRenderer) << " B renderer): " <<
+            "shared " << perSprite(sharedAfter.size - sharedBefore.size) << " B and " <<
+            perSprite(sharedAfter.count - sharedBefore.count) << " allocations per sprite, " <<
+            "copied " << perSprite(copiedAfter.size - copiedBefore.size) << " B and " <<
+            perSprite(copiedAfter.count - copiedBefore.count) << " allocations per sprite\n";
+    }
+}
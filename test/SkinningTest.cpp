@@ -0,0 +1,121 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Test.hpp"
+#include "core/Engine.hpp"
+#include "scene/Actor.hpp"
+#include "scene/SkinnedMeshRenderer.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        // Strip of vertices along a chain of bones that bends back and forth
+        scene::SkinnedMeshData generateCharacter(std::size_t vertexCount, std::size_t boneCount)
+        {
+            scene::SkinnedMeshData meshData;
+
+            for (std::size_t i = 0; i < boneCount; ++i)
+            {
+                scene::SkinnedMeshData::Bone bone;
+                bone.name = "bone" + std::to_string(i);
+                bone.parent = i == 0 ? scene::SkinnedMeshData::noParent : i - 1;
+                bone.position = Vector3F(0.0F, i == 0 ? 0.0F : 1.0F, 0.0F);
+                bone.inverseBindMatrix.setTranslation(Vector3F(0.0F, -static_cast<float>(i), 0.0F));
+                meshData.bones.push_back(bone);
+            }
+
+            scene::SkinnedMeshData::Animation animation;
+            animation.name = "bend";
+            animation.duration = 1.0F;
+
+            for (std::size_t i = 1; i < boneCount; ++i)
+            {
+                scene::SkinnedMeshData::Channel channel;
+                channel.bone = i;
+                channel.path = scene::SkinnedMeshData::Channel::Path::rotation;
+                channel.times = {0.0F, 0.5F, 1.0F};
+
+                QuaternionF left = QuaternionF::identity();
+                left.rotate(0.1F, Vector3F(0.0F, 0.0F, 1.0F));
+                QuaternionF right = QuaternionF::identity();
+                right.rotate(-0.1F, Vector3F(0.0F, 0.0F, 1.0F));
+
+                channel.values = {
+                    Vector4F(left.v[0], left.v[1], left.v[2], left.v[3]),
+                    Vector4F(right.v[0], right.v[1], right.v[2], right.v[3]),
+                    Vector4F(left.v[0], left.v[1], left.v[2], left.v[3])
+                };
+                animation.channels.push_back(channel);
+            }
+
+            meshData.animations.push_back(animation);
+
+            for (std::size_t i = 0; i < vertexCount; ++i)
+            {
+                const auto height = static_cast<float>(i) * static_cast<float>(boneCount - 1) / static_cast<float>(vertexCount);
+                const auto bone = static_cast<std::uint16_t>(height);
+
+                meshData.vertices.emplace_back(Vector3F((i % 2) ? 0.5F : -0.5F, height, 0.0F), Color::white(),
+                                               Vector2F(), Vector3F(0.0F, 0.0F, 1.0F));
+                meshData.boneIndices.push_back({
+                    bone,
+                    static_cast<std::uint16_t>(bone + 1),
+                    static_cast<std::uint16_t>(bone > 0 ? bone - 1 : 0),
+                    0
+                });
+                meshData.boneWeights.emplace_back(0.6F, 0.3F, 0.1F, 0.0F);
+            }
+
+            for (std::uint32_t i = 2; i < vertexCount; ++i)
+                meshData.indices.insert(meshData.indices.end(), {i - 2, i - 1, i});
+
+            meshData.initBuffers();
+
+            return meshData;
+        }
+    }
+
+    void benchmarkSkinning()
+    {
+        constexpr std::size_t characterCount = 200;
+        constexpr std::size_t vertexCount = 5000;
+        constexpr std::size_t boneCount = 32;
+
+        const auto meshData = generateCharacter(vertexCount, boneCount);
+
+        // the renderers are not attached to a scene, so the skinning system is updated manually
+        std::vector<std::unique_ptr<scene::Actor>> actors;
+        std::vector<std::unique_ptr<scene::SkinnedMeshRenderer>> renderers;
+
+        for (std::size_t i = 0; i < characterCount; ++i)
+        {
+            auto& actor = actors.emplace_back(std::make_unique<scene::Actor>());
+            auto& renderer = renderers.emplace_back(std::make_unique<scene::SkinnedMeshRenderer>(meshData));
+            actor->addComponent(*renderer);
+
+            expect(renderer->playAnimation("bend"), "Animation not found");
+            renderer->setAnimationTime(static_cast<float>(i) / static_cast<float>(characterCount));
+        }
+
+        auto& skinningSystem = engine->getSceneManager().getSkinningSystem();
+
+        const auto duration = measure(10, [&skinningSystem]() {
+            skinningSystem.update(1.0F / 60.0F);
+        });
+
+        for (const auto& renderer : renderers)
+        {
+            expect(!renderer->isGpuSkinned(), "The empty render device has no skinning shader");
+            expect(renderer->getBonePalette().size() == boneCount, "Bone palette was not calculated");
+        }
+
+        std::cout << "Skinning (" << characterCount << " characters, " << vertexCount << " vertices, " <<
+            boneCount << " bones, " << engine->getJobSystem().getWorkerCount() << " workers): " <<
+            duration << " ms per update, " <<
+            static_cast<double>(characterCount * vertexCount) / (duration * 1000.0) << " Mvertices/s\n";
+    }
+}
@@ -0,0 +1,63 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_TEST_TEST_HPP
+#define OUZEL_TEST_TEST_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace ouzel::test
+{
+    class TestError final: public std::logic_error
+    {
+    public:
+        explicit TestError(const std::string& str): std::logic_error(str) {}
+        explicit TestError(const char* str): std::logic_error(str) {}
+    };
+
+    // Thrown by the tests that can't run on the machine, they are reported but don't fail the run
+    class TestSkipped final: public std::logic_error
+    {
+    public:
+        explicit TestSkipped(const std::string& str): std::logic_error(str) {}
+        explicit TestSkipped(const char* str): std::logic_error(str) {}
+    };
+
+    struct Test final
+    {
+        const char* name;
+        void (*function)();
+    };
+
+    struct AllocationStatistics final
+    {
+        std::size_t count = 0;
+        std::size_t size = 0;
+    };
+
+    // Allocations made with the global operator new since the start of the program, counted by the test runner
+    AllocationStatistics getAllocationStatistics() noexcept;
+
+    inline void expect(bool condition, const std::string& message)
+    {
+        if (!condition) throw TestError(message);
+    }
+
+    // Returns the average duration of one run of the function in milliseconds
+    template <class Function>
+    double measure(std::size_t runs, Function function)
+    {
+        function(); // warm up the caches and the allocations
+
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t run = 0; run < runs; ++run)
+            function();
+        const auto end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::milli>(end - start).count() / static_cast<double>(runs);
+    }
+}
+
+#endif // OUZEL_TEST_TEST_HPP
@@ -0,0 +1,32 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_TEST_TESTENGINE_HPP
+#define OUZEL_TEST_TESTENGINE_HPP
+
+#include <memory>
+#include "core/Engine.hpp"
+#include "core/Window.hpp"
+#include "graphics/Graphics.hpp"
+
+namespace ouzel::test
+{
+    // Engine without a platform window, the commands are recorded for the empty render device
+    class TestEngine final: public core::Engine
+    {
+    public:
+        TestEngine():
+            core::Engine({})
+        {
+            window = std::make_unique<core::Window>(*this, Size2U(1280, 720));
+            graphics = std::make_unique<graphics::Graphics>(graphics::Driver::empty, *window, graphics::Settings{});
+        }
+
+    private:
+        void runOnMainThread(const std::function<void()>& func) final
+        {
+            func();
+        }
+    };
+}
+
+#endif // OUZEL_TEST_TESTENGINE_HPP
@@ -1,8 +1,176 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
-#include "cstdlib"
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include "Test.hpp"
+#include "TestEngine.hpp"
+#include "core/Application.hpp"
 
-int main()
+namespace
 {
-    return EXIT_SUCCESS;
+    std::atomic<std::size_t> allocationCount{0};
+    std::atomic<std::size_t> allocationSize{0};
+}
+
+// the global allocation functions are replaced to count the allocations of the tests
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationSize.fetch_add(size, std::memory_order_relaxed);
+
+    if (void* result = std::malloc(size ? size : 1))
+        return result;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace ouzel::test
+{
+    AllocationStatistics getAllocationStatistics() noexcept
+    {
+        AllocationStatistics result;
+        result.count = allocationCount.load(std::memory_order_relaxed);
+        result.size = allocationSize.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    void testAssetEviction();
+    void testCaptureRoundTrip();
+    void testProgramBinaryRoundTrip();
+    void testProgramCache();
+    void testOfflineAudio();
+    void testFrameSchedulerVariableStep();
+    void testFrameSchedulerFixedStep();
+    void testFrameTimeHistogram();
+    void testGltfText();
+    void testGltfBinary();
+    void testGltfInvalidIndices();
+    void testInputQueueOverflow();
+    void testLanguageStringTable();
+    void testLocalizationFiles();
+    void testObjIndices();
+    void testObjChunks();
+    void testObjLargeIndices();
+    void testObjMalformed();
+    void testRenderGraphOrder();
+    void testRenderGraphAliasing();
+    void testRenderGraphClears();
+    void testRenderGraphAllocations();
+    void testRenderGraphParallelRecording();
+    void testScenePassOrder();
+    void testSpriteDataSharing();
+    void testSpriteRendererAllocations();
+    void testJobCancellation();
+    void testPrefabAnimators();
+
+    void benchmarkBatching();
+    void benchmarkEventDispatch();
+    void benchmarkJobSystem();
+    void benchmarkObjParse();
+    void benchmarkPrefab();
+    void benchmarkSkinning();
+    void benchmarkSpriteMemory();
+}
+
+// the engine's main loop is not run by the tests
+std::unique_ptr<ouzel::Application> ouzel::main(const std::vector<std::string>&)
+{
+    return nullptr;
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace ouzel::test;
+
+    const std::vector<Test> tests = {
+        {"AssetEviction", testAssetEviction},
+        {"CaptureRoundTrip", testCaptureRoundTrip},
+        {"ProgramBinaryRoundTrip", testProgramBinaryRoundTrip},
+        {"ProgramCache", testProgramCache},
+        {"OfflineAudio", testOfflineAudio},
+        {"FrameSchedulerVariableStep", testFrameSchedulerVariableStep},
+        {"FrameSchedulerFixedStep", testFrameSchedulerFixedStep},
+        {"FrameTimeHistogram", testFrameTimeHistogram},
+        {"GltfText", testGltfText},
+        {"GltfBinary", testGltfBinary},
+        {"GltfInvalidIndices", testGltfInvalidIndices},
+        {"InputQueueOverflow", testInputQueueOverflow},
+        {"LanguageStringTable", testLanguageStringTable},
+        {"LocalizationFiles", testLocalizationFiles},
+        {"ObjIndices", testObjIndices},
+        {"ObjChunks", testObjChunks},
+        {"ObjLargeIndices", testObjLargeIndices},
+        {"ObjMalformed", testObjMalformed},
+        {"RenderGraphOrder", testRenderGraphOrder},
+        {"RenderGraphAliasing", testRenderGraphAliasing},
+        {"RenderGraphClears", testRenderGraphClears},
+        {"RenderGraphAllocations", testRenderGraphAllocations},
+        {"RenderGraphParallelRecording", testRenderGraphParallelRecording},
+        {"ScenePassOrder", testScenePassOrder},
+        {"SpriteDataSharing", testSpriteDataSharing},
+        {"SpriteRendererAllocations", testSpriteRendererAllocations},
+        {"JobCancellation", testJobCancellation},
+        {"PrefabAnimators", testPrefabAnimators}
+    };
+
+    const std::vector<Test> benchmarks = {
+        {"Batching", benchmarkBatching},
+        {"EventDispatch", benchmarkEventDispatch},
+        {"JobSystem", benchmarkJobSystem},
+        {"ObjParse", benchmarkObjParse},
+        {"Prefab", benchmarkPrefab},
+        {"Skinning", benchmarkSkinning},
+        {"SpriteMemory", benchmarkSpriteMemory}
+    };
+
+    // the benchmarks are run instead of the tests if the first argument is "benchmark"
+    const bool benchmark = argc > 1 && std::string(argv[1]) == "benchmark";
+
+    try
+    {
+        TestEngine engine;
+
+        std::size_t failed = 0;
+
+        for (const auto& test : benchmark ? benchmarks : tests)
+        {
+            try
+            {
+                test.function();
+                if (!benchmark) std::cout << "[PASS] " << test.name << '\n';
+            }
+            catch (const TestSkipped& e)
+            {
+                std::cout << "[SKIP] " << test.name << ": " << e.what() << '\n';
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "[FAIL] " << test.name << ": " << e.what() << '\n';
+                ++failed;
+            }
+        }
+
+        return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
 }
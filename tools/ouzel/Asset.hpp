@@ -21,22 +21,26 @@ namespace ouzel
             sprite,
             sound,
             cue,
-            shader
+            shader,
+            localization
         };
 
         Asset(const storage::Path& initPath,
               const std::string& initName,
               Type initType,
-              bool initMipmaps):
+              bool initMipmaps,
+              const std::string& initAtlas):
             path(initPath),
             name(initName),
             type(initType),
-            mipmaps(initMipmaps) {}
+            mipmaps(initMipmaps),
+            atlas(initAtlas) {}
 
         const storage::Path path;
         const std::string name;
         const Type type = Type::empty;
         const bool mipmaps = false;
+        const std::string atlas; // name of the atlas that the texture is packed into
     };
 
     inline Asset::Type stringToAssetType(const std::string& s)
@@ -61,6 +65,8 @@ namespace ouzel
             return Asset::Type::cue;
         else if (s == "shader")
             return Asset::Type::shader;
+        else if (s == "localization")
+            return Asset::Type::localization;
         else
             throw std::runtime_error("Invalid asset type");
     }
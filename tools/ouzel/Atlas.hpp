@@ -0,0 +1,135 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_ATLAS_HPP
+#define OUZEL_ATLAS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "stb_image.h"
+#include "stb_image_write.h"
+#include "formats/Json.hpp"
+#include "graphics/AtlasPacker.hpp"
+#include "storage/Path.hpp"
+
+namespace ouzel
+{
+    class AtlasError final: public std::runtime_error
+    {
+    public:
+        explicit AtlasError(const std::string& str): std::runtime_error(str) {}
+        explicit AtlasError(const char* str): std::runtime_error(str) {}
+    };
+
+    // Packs the images into the pages (<name>_<page>.png) and writes a frame table (<name>.json) that
+    // the SpriteLoader of the engine turns into a sprite for every image, named after the image's filename
+    class Atlas final
+    {
+    public:
+        static constexpr std::uint32_t pageSize = 2048;
+        static constexpr std::uint32_t padding = 2;
+        static constexpr std::uint32_t extrusion = 2;
+
+        explicit Atlas(const std::string& initName):
+            name(initName)
+        {
+        }
+
+        void addImage(const std::string& filename, const storage::Path& path)
+        {
+            int width;
+            int height;
+            int comp;
+            std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> data(stbi_load(std::string(path).c_str(),
+                                                                                 &width, &height,
+                                                                                 &comp, STBI_rgb_alpha),
+                                                                      &stbi_image_free);
+            if (!data)
+                throw AtlasError("Failed to load " + std::string(path) + ", reason: " + stbi_failure_reason());
+
+            const Size2U size(static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height));
+            images.push_back(Image{filename, size, std::vector<std::uint8_t>(data.get(), data.get() + width * height * 4)});
+        }
+
+        void write(const storage::Path& directory) const
+        {
+            graphics::AtlasPacker packer(Size2U(pageSize, pageSize), padding, extrusion);
+            std::vector<std::vector<std::uint8_t>> pages;
+
+            // packing the largest images first leaves less unused space
+            std::vector<const Image*> sortedImages;
+            for (const auto& image : images) sortedImages.push_back(&image);
+            std::stable_sort(sortedImages.begin(), sortedImages.end(), [](const auto a, const auto b) noexcept {
+                return std::max(a->size.v[0], a->size.v[1]) > std::max(b->size.v[0], b->size.v[1]);
+            });
+
+            json::Value framesArray = json::Value::Array{};
+
+            for (const auto image : sortedImages)
+            {
+                const auto region = packer.pack(image->size);
+
+                if (region.page == pages.size())
+                    pages.emplace_back(static_cast<std::size_t>(pageSize) * pageSize * 4);
+
+                graphics::copyToAtlasPage(pages[region.page].data(), packer.getPageSize(),
+                                          image->data.data(), image->size,
+                                          region.rectangle, extrusion);
+
+                json::Value frameObject = json::Value::Object{};
+                frameObject["filename"] = image->filename;
+                frameObject["page"] = region.page;
+                frameObject["frame"]["x"] = region.rectangle.position.v[0];
+                frameObject["frame"]["y"] = region.rectangle.position.v[1];
+                frameObject["frame"]["w"] = region.rectangle.size.v[0];
+                frameObject["frame"]["h"] = region.rectangle.size.v[1];
+                frameObject["pivot"]["x"] = 0.5F;
+                frameObject["pivot"]["y"] = 0.5F;
+                framesArray.pushBack(frameObject);
+            }
+
+            json::Value d = json::Value::Object{};
+            d["meta"]["atlas"] = true;
+            d["meta"]["pages"] = json::Value::Array{};
+
+            for (std::size_t page = 0; page < pages.size(); ++page)
+            {
+                const auto pageFilename = name + '_' + std::to_string(page) + ".png";
+                const auto pagePath = directory / pageFilename;
+
+                if (!stbi_write_png(std::string(pagePath).c_str(),
+                                    static_cast<int>(pageSize), static_cast<int>(pageSize), 4,
+                                    pages[page].data(), static_cast<int>(pageSize * 4)))
+                    throw AtlasError("Failed to write " + std::string(pagePath));
+
+                d["meta"]["pages"].pushBack(pageFilename);
+            }
+
+            d["frames"] = framesArray;
+
+            const auto tablePath = directory / (name + ".json");
+            std::ofstream file(tablePath, std::ios::binary | std::ios::trunc);
+            const auto table = json::encode(d, true);
+            file.write(table.data(), static_cast<std::streamsize>(table.size()));
+            if (!file)
+                throw AtlasError("Failed to write " + std::string(tablePath));
+        }
+
+    private:
+        struct Image final
+        {
+            std::string filename;
+            Size2U size;
+            std::vector<std::uint8_t> data;
+        };
+
+        std::string name;
+        std::vector<Image> images;
+    };
+}
+
+#endif // OUZEL_ATLAS_HPP
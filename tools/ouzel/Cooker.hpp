@@ -0,0 +1,382 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_COOKER_HPP
+#define OUZEL_COOKER_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "formats/Cooked.hpp"
+#include "formats/Json.hpp"
+#include "formats/Mo.hpp"
+#include "formats/Obj.hpp"
+#include "graphics/Vertex.hpp"
+#include "hash/Fnv1.hpp"
+
+namespace ouzel
+{
+    class CookError final: public std::runtime_error
+    {
+    public:
+        explicit CookError(const std::string& str): std::runtime_error(str) {}
+        explicit CookError(const char* str): std::runtime_error(str) {}
+    };
+
+    inline std::vector<std::byte> cookStaticMesh(const std::vector<std::byte>& data)
+    {
+        const obj::Document document(data.data(), data.size());
+
+        cooked::Writer writer(cooked::AssetType::staticMesh);
+
+        for (const auto& materialLibrary : document.materialLibraries)
+            writer.addString(cooked::ChunkType::materialLibrary, materialLibrary);
+
+        for (const auto& object : document.objects)
+        {
+            cooked::Mesh mesh{};
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                mesh.boundingBoxMin[i] = object.boundingBox.min.v[i];
+                mesh.boundingBoxMax[i] = object.boundingBox.max.v[i];
+            }
+            mesh.indexCount = static_cast<std::uint32_t>(object.indices.size());
+            mesh.vertexCount = static_cast<std::uint32_t>(object.vertices.size());
+            mesh.indexSize = object.vertices.size() > std::numeric_limits<std::uint16_t>::max() + 1U ?
+                sizeof(std::uint32_t) : sizeof(std::uint16_t);
+
+            writer.addString(cooked::ChunkType::name, object.name);
+            writer.addValue(cooked::ChunkType::mesh, mesh);
+            if (!object.material.empty())
+                writer.addString(cooked::ChunkType::material, object.material);
+            writer.addArray(cooked::ChunkType::vertices, object.vertices);
+
+            if (mesh.indexSize == sizeof(std::uint16_t))
+            {
+                std::vector<std::uint16_t> indices(object.indices.begin(), object.indices.end());
+                writer.addArray(cooked::ChunkType::indices, indices);
+            }
+            else
+                writer.addArray(cooked::ChunkType::indices, object.indices);
+        }
+
+        return writer.getData();
+    }
+
+    inline std::vector<std::byte> cookSprite(const std::vector<std::byte>& data)
+    {
+        const auto d = json::parse(data);
+
+        if (!d.hasMember("meta") || !d.hasMember("frames"))
+            throw CookError("Invalid sprite sheet");
+
+        const auto& metaObject = d["meta"];
+        const auto& framesArray = d["frames"];
+
+        cooked::Sprite sprite{};
+        sprite.frameInterval = 0.1F;
+        sprite.frameCount = static_cast<std::uint32_t>(framesArray.getSize());
+
+        if (metaObject.hasMember("size"))
+        {
+            sprite.textureWidth = static_cast<float>(metaObject["size"]["w"].as<std::int32_t>());
+            sprite.textureHeight = static_cast<float>(metaObject["size"]["h"].as<std::int32_t>());
+        }
+
+        cooked::Writer writer(cooked::AssetType::sprite);
+        writer.addValue(cooked::ChunkType::sprite, sprite);
+        writer.addString(cooked::ChunkType::texture, metaObject["image"].as<std::string>());
+
+        for (const json::Value& frameObject : framesArray)
+        {
+            const auto& frameRectangleObject = frameObject["frame"];
+            const auto& sourceSizeObject = frameObject["sourceSize"];
+            const auto& spriteSourceSizeObject = frameObject["spriteSourceSize"];
+            const auto& pivotObject = frameObject["pivot"];
+
+            cooked::Frame frame{};
+            frame.x = static_cast<float>(frameRectangleObject["x"].as<std::int32_t>());
+            frame.y = static_cast<float>(frameRectangleObject["y"].as<std::int32_t>());
+            frame.width = static_cast<float>(frameRectangleObject["w"].as<std::int32_t>());
+            frame.height = static_cast<float>(frameRectangleObject["h"].as<std::int32_t>());
+            frame.sourceWidth = static_cast<float>(sourceSizeObject["w"].as<std::int32_t>());
+            frame.sourceHeight = static_cast<float>(sourceSizeObject["h"].as<std::int32_t>());
+            frame.offsetX = static_cast<float>(spriteSourceSizeObject["x"].as<std::int32_t>());
+            frame.offsetY = static_cast<float>(spriteSourceSizeObject["y"].as<std::int32_t>());
+            frame.pivotX = pivotObject["x"].as<float>();
+            frame.pivotY = pivotObject["y"].as<float>();
+            frame.rotated = frameObject.hasMember("rotated") && frameObject["rotated"].as<bool>() ? 1 : 0;
+            frame.polygon = frameObject.hasMember("vertices") &&
+                frameObject.hasMember("verticesUV") &&
+                frameObject.hasMember("triangles") ? 1 : 0;
+
+            writer.addString(cooked::ChunkType::name, frameObject["filename"].as<std::string>());
+            writer.addValue(cooked::ChunkType::frame, frame);
+
+            if (frame.polygon)
+            {
+                // same conversion as the one done by the sprite loader
+                if (sprite.textureWidth <= 0.0F || sprite.textureHeight <= 0.0F)
+                    throw CookError("Polygon sprites need the texture size in the meta object");
+
+                std::vector<std::uint16_t> indices;
+                for (const json::Value& triangleObject : frameObject["triangles"])
+                    for (const json::Value& indexObject : triangleObject)
+                        indices.push_back(static_cast<std::uint16_t>(indexObject.as<std::uint32_t>()));
+
+                // reverse the vertices, so that they are counterclockwise
+                std::reverse(indices.begin(), indices.end());
+
+                const float finalOffsetX = -frame.sourceWidth * frame.pivotX + frame.offsetX;
+                const float finalOffsetY = -frame.sourceHeight * frame.pivotY + (frame.sourceHeight - frame.height - frame.offsetY);
+
+                const auto& verticesObject = frameObject["vertices"];
+                const auto& verticesUVObject = frameObject["verticesUV"];
+
+                std::vector<graphics::Vertex> vertices;
+                vertices.reserve(verticesObject.getSize());
+
+                for (std::size_t vertexIndex = 0; vertexIndex < verticesObject.getSize(); ++vertexIndex)
+                {
+                    const auto& vertexObject = verticesObject[vertexIndex];
+                    const auto& vertexUVObject = verticesUVObject[vertexIndex];
+
+                    vertices.emplace_back(Vector3F{static_cast<float>(vertexObject[0].as<std::int32_t>()) + finalOffsetX,
+                                                   -static_cast<float>(vertexObject[1].as<std::int32_t>()) - finalOffsetY, 0.0F},
+                                          Color::white(),
+                                          Vector2F{static_cast<float>(vertexUVObject[0].as<std::int32_t>()) / sprite.textureWidth,
+                                                   static_cast<float>(vertexUVObject[1].as<std::int32_t>()) / sprite.textureHeight},
+                                          Vector3F{0.0F, 0.0F, -1.0F});
+                }
+
+                writer.addArray(cooked::ChunkType::vertices, vertices);
+                writer.addArray(cooked::ChunkType::indices, indices);
+            }
+        }
+
+        return writer.getData();
+    }
+
+    inline std::vector<std::byte> cookParticleSystem(const std::vector<std::byte>& data)
+    {
+        const auto d = json::parse(data);
+
+        if (!d.hasMember("textureFileName") || !d.hasMember("configName"))
+            throw CookError("Invalid particle system");
+
+        const auto getFloat = [&d](const char* key) {
+            return d.hasMember(key) ? d[key].as<float>() : 0.0F;
+        };
+
+        const auto getUInt = [&d](const char* key) {
+            return d.hasMember(key) ? d[key].as<std::uint32_t>() : 0U;
+        };
+
+        const auto getBool = [&d](const char* key) -> std::uint32_t {
+            return d.hasMember(key) && d[key].as<bool>() ? 1 : 0;
+        };
+
+        // keys match the ones read by the particle system loader
+        cooked::ParticleSystem p{};
+        p.blendFuncSource = getUInt("blendFuncSource");
+        p.blendFuncDestination = getUInt("blendFuncDestination");
+        p.emitterType = getUInt("emitterType");
+        p.maxParticles = getUInt("maxParticles");
+        p.duration = getFloat("duration");
+        p.particleLifespan = getFloat("particleLifespan");
+        p.particleLifespanVariance = getFloat("particleLifespanVariance");
+        p.speed = getFloat("speed");
+        p.speedVariance = getFloat("speedVariance");
+        p.absolutePosition = getBool("absolutePosition");
+        p.yCoordFlipped = getUInt("yCoordFlipped") == 1 ? 1 : 0;
+        p.sourcePosition[0] = getFloat("sourcePositionx");
+        p.sourcePosition[1] = getFloat("sourcePositiony");
+        p.sourcePositionVariance[0] = getFloat("sourcePositionVariancex");
+        p.sourcePositionVariance[1] = getFloat("sourcePositionVariancey");
+        p.startParticleSize = getFloat("startParticleSize");
+        p.startParticleSizeVariance = getFloat("startParticleSizeVariance");
+        p.finishParticleSize = getFloat("finishParticleSize");
+        p.finishParticleSizeVariance = getFloat("finishParticleSizeVariance");
+        p.angle = getFloat("angle");
+        p.angleVariance = getFloat("angleVariance");
+        p.startRotation = getFloat("rotationStart");
+        p.startRotationVariance = getFloat("rotationStartVariance");
+        p.finishRotation = getFloat("rotationEnd");
+        p.finishRotationVariance = getFloat("rotationEndVariance");
+        p.rotatePerSecond = getFloat("rotatePerSecond");
+        p.rotatePerSecondVariance = getFloat("rotatePerSecondVariance");
+        p.minRadius = getFloat("minRadius");
+        p.minRadiusVariance = getFloat("minRadiusVariance");
+        p.maxRadius = getFloat("maxRadius");
+        p.maxRadiusVariance = getFloat("maxRadiusVariance");
+        p.radialAcceleration = getFloat("radialAcceleration");
+        p.radialAccelVariance = getFloat("radialAccelVariance");
+        p.tangentialAcceleration = getFloat("tangentialAcceleration");
+        p.tangentialAccelVariance = getFloat("tangentialAccelVariance");
+        p.rotationIsDir = getBool("rotationIsDir");
+        p.gravity[0] = getFloat("gravityx");
+        p.gravity[1] = getFloat("gravityy");
+
+        const char* colorComponents[] = {"Red", "Green", "Blue", "Alpha"};
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            p.startColor[i] = getFloat(("startColor" + std::string(colorComponents[i])).c_str());
+            p.startColorVariance[i] = getFloat(("startColorVariance" + std::string(colorComponents[i])).c_str());
+            p.finishColor[i] = getFloat(("finishColor" + std::string(colorComponents[i])).c_str());
+            p.finishColorVariance[i] = getFloat(("finishColorVariance" + std::string(colorComponents[i])).c_str());
+        }
+
+        cooked::Writer writer(cooked::AssetType::particleSystem);
+        writer.addString(cooked::ChunkType::name, d["configName"].as<std::string>());
+        writer.addValue(cooked::ChunkType::particleSystem, p);
+        writer.addString(cooked::ChunkType::texture, d["textureFileName"].as<std::string>());
+
+        return writer.getData();
+    }
+
+    // Converts a text BMFont descriptor
+    inline std::vector<std::byte> cookFont(const std::vector<std::byte>& data)
+    {
+        cooked::Font font{};
+        std::string texture;
+        std::vector<cooked::Glyph> glyphs;
+        std::vector<cooked::Kerning> kernings;
+
+        const char* iterator = reinterpret_cast<const char*>(data.data());
+        const char* end = iterator + data.size();
+
+        while (iterator != end)
+        {
+            const char* lineEnd = std::find_if(iterator, end, [](char c) noexcept { return c == '\r' || c == '\n'; });
+
+            // split the line into the keyword and key=value pairs (values can be quoted)
+            std::string_view keyword;
+            std::map<std::string_view, std::string_view> values;
+
+            while (iterator != lineEnd)
+            {
+                if (*iterator == ' ' || *iterator == '\t')
+                {
+                    ++iterator;
+                    continue;
+                }
+
+                const char* start = iterator;
+                while (iterator != lineEnd && *iterator != ' ' && *iterator != '\t' && *iterator != '=')
+                    ++iterator;
+
+                const std::string_view key(start, static_cast<std::size_t>(iterator - start));
+
+                if (iterator == lineEnd || *iterator != '=')
+                {
+                    if (keyword.empty()) keyword = key;
+                    continue;
+                }
+
+                ++iterator; // skip the equal sign
+
+                if (iterator != lineEnd && *iterator == '"')
+                {
+                    start = ++iterator;
+                    while (iterator != lineEnd && *iterator != '"') ++iterator;
+                    values[key] = std::string_view(start, static_cast<std::size_t>(iterator - start));
+                    if (iterator != lineEnd) ++iterator;
+                }
+                else
+                {
+                    start = iterator;
+                    while (iterator != lineEnd && *iterator != ' ' && *iterator != '\t') ++iterator;
+                    values[key] = std::string_view(start, static_cast<std::size_t>(iterator - start));
+                }
+            }
+
+            if (iterator != end) ++iterator; // skip the newline
+
+            const auto getInt = [&values](std::string_view key) {
+                std::int32_t result = 0;
+                const auto i = values.find(key);
+                if (i != values.end() &&
+                    std::from_chars(i->second.data(), i->second.data() + i->second.size(), result).ec != std::errc())
+                    throw CookError("Invalid integer");
+                return result;
+            };
+
+            if (keyword == "page")
+            {
+                const auto i = values.find("file");
+                if (i != values.end()) texture = std::string(i->second);
+            }
+            else if (keyword == "common")
+            {
+                font.lineHeight = static_cast<std::uint16_t>(getInt("lineHeight"));
+                font.base = static_cast<std::uint16_t>(getInt("base"));
+                font.width = static_cast<std::uint16_t>(getInt("scaleW"));
+                font.height = static_cast<std::uint16_t>(getInt("scaleH"));
+                font.pages = static_cast<std::uint16_t>(getInt("pages"));
+                font.outline = static_cast<std::uint16_t>(getInt("outline"));
+            }
+            else if (keyword == "char")
+            {
+                cooked::Glyph glyph{};
+                glyph.id = static_cast<std::uint32_t>(getInt("id"));
+                glyph.x = static_cast<std::int16_t>(getInt("x"));
+                glyph.y = static_cast<std::int16_t>(getInt("y"));
+                glyph.width = static_cast<std::int16_t>(getInt("width"));
+                glyph.height = static_cast<std::int16_t>(getInt("height"));
+                glyph.xOffset = static_cast<std::int16_t>(getInt("xoffset"));
+                glyph.yOffset = static_cast<std::int16_t>(getInt("yoffset"));
+                glyph.xAdvance = static_cast<std::int16_t>(getInt("xadvance"));
+                glyph.page = static_cast<std::int16_t>(getInt("page"));
+                glyphs.push_back(glyph);
+            }
+            else if (keyword == "kerning")
+            {
+                cooked::Kerning kerning{};
+                kerning.first = static_cast<std::uint32_t>(getInt("first"));
+                kerning.second = static_cast<std::uint32_t>(getInt("second"));
+                kerning.amount = static_cast<std::int16_t>(getInt("amount"));
+                kernings.push_back(kerning);
+            }
+        }
+
+        if (texture.empty())
+            throw CookError("Font has no pages");
+
+        cooked::Writer writer(cooked::AssetType::font);
+        writer.addValue(cooked::ChunkType::font, font);
+        writer.addString(cooked::ChunkType::texture, texture);
+        writer.addArray(cooked::ChunkType::glyphs, glyphs);
+        writer.addArray(cooked::ChunkType::kernings, kernings);
+
+        return writer.getData();
+    }
+
+    // Compiles a gettext .mo file to a string table keyed by the 64-bit FNV-1 hashes of the original strings
+    inline std::vector<std::byte> cookLocalization(const std::vector<std::byte>& data)
+    {
+        const mo::Document document(data.data(), data.size());
+
+        std::vector<std::pair<std::uint64_t, std::string_view>> strings;
+        for (const auto& translation : document.getTranslations())
+            if (!translation.original.empty()) // skip the header entry
+                strings.emplace_back(hash::fnv1::hash<std::uint64_t>(translation.original), translation.translation);
+
+        try
+        {
+            return cooked::writeStringTable(std::move(strings));
+        }
+        catch (const cooked::FormatError& e)
+        {
+            throw CookError(e.what());
+        }
+    }
+}
+
+#endif // OUZEL_COOKER_HPP
@@ -3,8 +3,12 @@
 #ifndef OUZEL_OUZELPROJECT_HPP
 #define OUZEL_OUZELPROJECT_HPP
 
+#include <algorithm>
 #include <fstream>
+#include <map>
 #include "Asset.hpp"
+#include "Atlas.hpp"
+#include "Cooker.hpp"
 #include "Target.hpp"
 #include "storage/FileSystem.hpp"
 #include "formats/Json.hpp"
@@ -67,7 +71,11 @@ namespace ouzel
                 assets.emplace_back(assetPath,
                                     assetName,
                                     assetType,
-                                    assetObject.hasMember("mipmaps") ? assetObject["mipmaps"].as<bool>() : false);
+                                    assetObject.hasMember("mipmaps") ? assetObject["mipmaps"].as<bool>() : false,
+                                    assetObject.hasMember("atlas") ? assetObject["atlas"].as<std::string>() : std::string());
+
+                if (!assets.back().atlas.empty() && assetType != Asset::Type::texture)
+                    throw ProjectError("Only textures can be packed into atlases");
             }
         }
 
@@ -84,29 +92,117 @@ namespace ouzel
 
         void exportAssets(const std::string& targetName) const
         {
+            const auto targetIterator = std::find_if(targets.begin(), targets.end(),
+                                                     [&targetName](const auto& target) noexcept {
+                return target.name == targetName;
+            });
+
+            if (targetIterator == targets.end())
+                throw std::runtime_error("Target not found");
+
+            const storage::Path projectDirectory = path.getDirectory();
+            const storage::Path outputDirectory = projectDirectory / "build" / targetName;
+
+            std::map<std::string, std::vector<const Asset*>> atlases;
+
             for (const auto& asset : assets)
             {
-                const storage::Path assetPath = assetsPath / asset.path;
+                const storage::Path inputPath = projectDirectory / asset.path;
+
+                if (storage::FileSystem::getFileType(inputPath) != storage::FileType::regular)
+                    throw std::runtime_error("Asset " + std::string(asset.path) + " not found");
+
+                if (!asset.atlas.empty())
+                {
+                    atlases[asset.atlas].push_back(&asset);
+                    continue;
+                }
+
+                const bool cook = asset.type == Asset::Type::mesh ||
+                    asset.type == Asset::Type::sprite ||
+                    asset.type == Asset::Type::particleSystem ||
+                    asset.type == Asset::Type::font ||
+                    asset.type == Asset::Type::localization;
+
+                storage::Path outputPath = outputDirectory / asset.path;
+                if (cook) outputPath.replaceExtension(cooked::fileExtension);
+
+                // skip the assets that have not changed since the last export
+                if (storage::FileSystem::getFileType(outputPath) == storage::FileType::regular &&
+                    !(storage::FileSystem::getModifyTime(inputPath) > storage::FileSystem::getModifyTime(outputPath)))
+                    continue;
 
-                storage::Path resourceName = asset.path;
-                resourceName.replaceExtension("otexture");
-                const storage::Path resourcePath = assetPath / resourceName;
+                createDirectories(outputPath.getDirectory());
 
-                const auto targetIterator = std::find_if(targets.begin(), targets.end(),
-                                                         [targetName](const auto& target) noexcept {
-                    return target.name == targetName;
-                });
+                if (cook)
+                {
+                    std::ifstream inputFile(inputPath, std::ios::binary);
+                    std::vector<std::byte> data;
+                    for (std::istreambuf_iterator<char> i(inputFile), end; i != end; ++i)
+                        data.push_back(static_cast<std::byte>(*i));
+
+                    std::vector<std::byte> result;
+                    switch (asset.type)
+                    {
+                        case Asset::Type::mesh: result = cookStaticMesh(data); break;
+                        case Asset::Type::sprite: result = cookSprite(data); break;
+                        case Asset::Type::particleSystem: result = cookParticleSystem(data); break;
+                        case Asset::Type::font: result = cookFont(data); break;
+                        case Asset::Type::localization: result = cookLocalization(data); break;
+                        default: break;
+                    }
+
+                    std::ofstream outputFile(outputPath, std::ios::binary | std::ios::trunc);
+                    outputFile.write(reinterpret_cast<const char*>(result.data()),
+                                     static_cast<std::streamsize>(result.size()));
+                    if (!outputFile)
+                        throw std::runtime_error("Failed to write " + std::string(outputPath));
+                }
+                else
+                    storage::FileSystem::copyFile(inputPath, outputPath, true);
+            }
+
+            const auto assetsOutputDirectory = outputDirectory / assetsPath;
+            const auto assetsPrefix = assetsPath.getGeneric() + '/';
+
+            for (const auto& [atlasName, atlasAssets] : atlases)
+            {
+                // skip the atlases whose images have not changed since the last export
+                const auto tablePath = assetsOutputDirectory / (atlasName + ".json");
+                if (storage::FileSystem::getFileType(tablePath) == storage::FileType::regular &&
+                    std::none_of(atlasAssets.begin(), atlasAssets.end(), [&projectDirectory, &tablePath](const auto asset) {
+                        return storage::FileSystem::getModifyTime(projectDirectory / asset->path) > storage::FileSystem::getModifyTime(tablePath);
+                    }))
+                    continue;
+
+                createDirectories(assetsOutputDirectory);
+
+                Atlas atlas(atlasName);
+                for (const auto asset : atlasAssets)
+                {
+                    // the images are looked up by their filenames relative to the assets directory
+                    auto filename = asset->path.getGeneric();
+                    if (filename.compare(0, assetsPrefix.size(), assetsPrefix) == 0)
+                        filename.erase(0, assetsPrefix.size());
 
-                if (targetIterator == targets.end())
-                    throw std::runtime_error("Target not found");
+                    atlas.addImage(filename, projectDirectory / asset->path);
+                }
 
-                // TODO: check if input file exists
-                // TODO: check if output file exists and is older than the input file
-                // TODO: export input file to output file
+                atlas.write(assetsOutputDirectory);
             }
         }
 
     private:
+        static void createDirectories(const storage::Path& directory)
+        {
+            if (directory.isEmpty() ||
+                storage::FileSystem::getFileType(directory) == storage::FileType::directory)
+                return;
+
+            createDirectories(directory.getDirectory());
+            storage::FileSystem::createDirectory(directory);
+        }
+
         const storage::Path path;
         std::string name;
         std::string identifier;